@@ -0,0 +1,357 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Micro-benchmark suite for the MEOS library.
+ *
+ * Each benchmark exercises one MEOS operation on synthetic trajectory data
+ * at several cardinalities and is repeated until a minimum wall-clock time
+ * has elapsed, so that short operations are measured over many iterations.
+ * The results are written as a JSON array so that successive runs can be
+ * compared release to release, e.g., with `jq`.
+ *
+ * The program can be built with the `meos_bench` CMake target, which is
+ * enabled with `-DMEOS_BENCH=ON`, or by hand as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o meos_bench meos_bench.c -L/usr/local/lib -lmeos
+ * @endcode
+ * Run it without arguments to write the results to the standard output or
+ * with a file name to write them there.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* Include the MEOS API header */
+#include <meos.h>
+
+/* Minimum wall-clock time measured for a benchmark, in seconds */
+#define BENCH_MIN_TIME 0.2
+/* Maximum number of iterations of a benchmark */
+#define BENCH_MAX_ITERS 100000
+/* Maximum length in characters of an input instant in WKT format */
+#define MAX_LEN_INST 128
+
+/* Cardinalities at which every benchmark is run */
+static const int BENCH_CARDS[] = { 10, 100, 1000, 10000 };
+#define BENCH_NO_CARDS ((int) (sizeof(BENCH_CARDS) / sizeof(BENCH_CARDS[0])))
+
+/* Output file and number of records written, for the JSON separators */
+static FILE *bench_out = NULL;
+static int bench_nrecords = 0;
+
+/**
+ * @brief Return the value of a monotonic clock in seconds
+ */
+static double
+bench_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Write one benchmark result as a JSON record
+ */
+static void
+bench_report(const char *name, int card, long iters, double secs)
+{
+  fprintf(bench_out, "%s\n  {\"name\": \"%s\", \"cardinality\": %d, "
+    "\"iterations\": %ld, \"ns_per_op\": %.1f, \"ops_per_sec\": %.1f}",
+    bench_nrecords++ ? "," : "", name, card, iters,
+    secs / (double) iters * 1e9, (double) iters / secs);
+}
+
+/**
+ * @brief Create an array of temporal float instants with values following
+ * a sawtooth pattern, one instant per second
+ */
+static TInstant **
+bench_make_tfloat_instants(int count)
+{
+  TimestampTz t = pg_timestamptz_in("2020-01-01 00:00:00+00", -1);
+  TInstant **instants = malloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = tfloatinst_make((double) (i % 100), t + (int64) i * 1000000);
+  return instants;
+}
+
+/**
+ * @brief Create a temporal point sequence following a straight line with a
+ * small per-instant perturbation, one instant per second
+ */
+static TSequence *
+bench_make_tpoint_seq(int count, double xorigin)
+{
+  TimestampTz t = pg_timestamptz_in("2020-01-01 00:00:00+00", -1);
+  TInstant **instants = malloc(sizeof(TInstant *) * count);
+  char inst_buffer[MAX_LEN_INST];
+  for (int i = 0; i < count; i++)
+  {
+    char *time_str = pg_timestamptz_out(t + (int64) i * 1000000);
+    snprintf(inst_buffer, MAX_LEN_INST, "POINT(%lf %lf)@%s",
+      xorigin + i * 0.001, (i % 10) * 0.0001, time_str);
+    instants[i] = (TInstant *) tgeompoint_in(inst_buffer);
+    free(time_str);
+  }
+  TSequence *result = tsequence_make((const TInstant **) instants, count,
+    true, true, LINEAR, false);
+  for (int i = 0; i < count; i++)
+    free(instants[i]);
+  free(instants);
+  return result;
+}
+
+/**
+ * @brief Create a span set with `count` disjoint unit float spans starting
+ * at `origin` and spaced two units apart
+ */
+static SpanSet *
+bench_make_floatspanset(int count, double origin)
+{
+  Span *spans = malloc(sizeof(Span) * count);
+  for (int i = 0; i < count; i++)
+  {
+    Span *s = floatspan_make(origin + i * 2.0, origin + i * 2.0 + 1.0,
+      true, false);
+    spans[i] = *s;
+    free(s);
+  }
+  SpanSet *result = spanset_make(spans, count, false);
+  free(spans);
+  return result;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Benchmark the assembly of a temporal sequence from its instants
+ */
+static void
+bench_tsequence_make(int card)
+{
+  TInstant **instants = bench_make_tfloat_instants(card);
+  long iters = 0;
+  double start = bench_now(), elapsed;
+  do
+  {
+    TSequence *seq = tsequence_make((const TInstant **) instants, card,
+      true, true, LINEAR, false);
+    free(seq);
+    elapsed = bench_now() - start;
+  } while (++iters < BENCH_MAX_ITERS && elapsed < BENCH_MIN_TIME);
+  bench_report("tsequence_make", card, iters, elapsed);
+  for (int i = 0; i < card; i++)
+    free(instants[i]);
+  free(instants);
+}
+
+/**
+ * @brief Benchmark the restriction of a temporal sequence to the period
+ * spanning its middle half
+ */
+static void
+bench_temporal_at_period(int card)
+{
+  TInstant **instants = bench_make_tfloat_instants(card);
+  TSequence *seq = tsequence_make((const TInstant **) instants, card,
+    true, true, LINEAR, false);
+  TimestampTz t = pg_timestamptz_in("2020-01-01 00:00:00+00", -1);
+  Span *p = period_make(t + (int64) card * 250000, t + (int64) card * 750000,
+    true, true);
+  long iters = 0;
+  double start = bench_now(), elapsed;
+  do
+  {
+    Temporal *atperiod = temporal_at_period((Temporal *) seq, p);
+    free(atperiod);
+    elapsed = bench_now() - start;
+  } while (++iters < BENCH_MAX_ITERS && elapsed < BENCH_MIN_TIME);
+  bench_report("temporal_at_period", card, iters, elapsed);
+  free(p);
+  free(seq);
+  for (int i = 0; i < card; i++)
+    free(instants[i]);
+  free(instants);
+}
+
+/**
+ * @brief Benchmark the temporal distance between two synchronized temporal
+ * point sequences
+ */
+static void
+bench_distance_tpoint_tpoint(int card)
+{
+  TSequence *seq1 = bench_make_tpoint_seq(card, 0.0);
+  TSequence *seq2 = bench_make_tpoint_seq(card, 0.5);
+  long iters = 0;
+  double start = bench_now(), elapsed;
+  do
+  {
+    Temporal *dist = distance_tpoint_tpoint((Temporal *) seq1,
+      (Temporal *) seq2);
+    free(dist);
+    elapsed = bench_now() - start;
+  } while (++iters < BENCH_MAX_ITERS && elapsed < BENCH_MIN_TIME);
+  bench_report("distance_tpoint_tpoint", card, iters, elapsed);
+  free(seq1);
+  free(seq2);
+}
+
+/**
+ * @brief Benchmark the union of two interleaved float span sets
+ */
+static void
+bench_union_spanset_spanset(int card)
+{
+  SpanSet *ss1 = bench_make_floatspanset(card, 0.0);
+  SpanSet *ss2 = bench_make_floatspanset(card, 0.5);
+  long iters = 0;
+  double start = bench_now(), elapsed;
+  do
+  {
+    SpanSet *u = union_spanset_spanset(ss1, ss2);
+    free(u);
+    elapsed = bench_now() - start;
+  } while (++iters < BENCH_MAX_ITERS && elapsed < BENCH_MIN_TIME);
+  bench_report("union_spanset_spanset", card, iters, elapsed);
+  free(ss1);
+  free(ss2);
+}
+
+/**
+ * @brief Benchmark the intersection of two interleaved float span sets
+ */
+static void
+bench_intersection_spanset_spanset(int card)
+{
+  SpanSet *ss1 = bench_make_floatspanset(card, 0.0);
+  SpanSet *ss2 = bench_make_floatspanset(card, 0.5);
+  long iters = 0;
+  double start = bench_now(), elapsed;
+  do
+  {
+    SpanSet *inter = intersection_spanset_spanset(ss1, ss2);
+    free(inter);
+    elapsed = bench_now() - start;
+  } while (++iters < BENCH_MAX_ITERS && elapsed < BENCH_MIN_TIME);
+  bench_report("intersection_spanset_spanset", card, iters, elapsed);
+  free(ss1);
+  free(ss2);
+}
+
+/**
+ * @brief Benchmark a WKB round-trip of a temporal point sequence
+ */
+static void
+bench_tpoint_wkb_roundtrip(int card)
+{
+  TSequence *seq = bench_make_tpoint_seq(card, 0.0);
+  long iters = 0;
+  double start = bench_now(), elapsed;
+  do
+  {
+    size_t size;
+    uint8_t *wkb = temporal_as_wkb((Temporal *) seq, WKB_EXTENDED, &size);
+    Temporal *temp = temporal_from_wkb(wkb, size);
+    free(temp);
+    free(wkb);
+    elapsed = bench_now() - start;
+  } while (++iters < BENCH_MAX_ITERS && elapsed < BENCH_MIN_TIME);
+  bench_report("tpoint_wkb_roundtrip", card, iters, elapsed);
+  free(seq);
+}
+
+/**
+ * @brief Benchmark the temporal sum aggregation of single-instant temporal
+ * floats; the cardinality is the number of aggregated values
+ */
+static void
+bench_tfloat_tsum(int card)
+{
+  TInstant **instants = bench_make_tfloat_instants(card);
+  long iters = 0;
+  double start = bench_now(), elapsed;
+  do
+  {
+    SkipList *state = NULL;
+    for (int i = 0; i < card; i++)
+      state = tfloat_tsum_transfn(state, (Temporal *) instants[i]);
+    Temporal *tsum = temporal_tagg_finalfn(state);
+    free(tsum);
+    elapsed = bench_now() - start;
+  } while (++iters < BENCH_MAX_ITERS && elapsed < BENCH_MIN_TIME);
+  bench_report("tfloat_tsum", card, iters, elapsed);
+  for (int i = 0; i < card; i++)
+    free(instants[i]);
+  free(instants);
+}
+
+/*****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    bench_out = fopen(argv[1], "w");
+    if (! bench_out)
+    {
+      printf("Error creating the output file '%s'\n", argv[1]);
+      return EXIT_FAILURE;
+    }
+  }
+  else
+    bench_out = stdout;
+
+  /* Initialize MEOS */
+  meos_initialize(NULL, NULL);
+
+  fprintf(bench_out, "[");
+  for (int i = 0; i < BENCH_NO_CARDS; i++)
+  {
+    int card = BENCH_CARDS[i];
+    bench_tsequence_make(card);
+    bench_temporal_at_period(card);
+    bench_distance_tpoint_tpoint(card);
+    bench_union_spanset_spanset(card);
+    bench_intersection_spanset_spanset(card);
+    bench_tpoint_wkb_roundtrip(card);
+    bench_tfloat_tsum(card);
+  }
+  fprintf(bench_out, "\n]\n");
+
+  /* Finalize MEOS */
+  meos_finalize();
+
+  if (bench_out != stdout)
+    fclose(bench_out);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,270 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief End-to-end ingestion benchmark for the MEOS library.
+ *
+ * The program generates a parameterized fleet of BerlinMOD-style vehicle
+ * trips as timestamped point observations, drives them through the full
+ * ingestion path — parsing every observation in WKT format and assembling
+ * the observations of each vehicle into a trip sequence, as done by the
+ * `03_meos_assemble_berlinmod.c` example program — and reports the parse and
+ * assembly throughput together with the per-trip latency percentiles as a
+ * JSON record, in the same format as the micro-benchmark suite.
+ *
+ * The fleet is generated with a fixed seed, so that two runs over the same
+ * parameters measure the ingestion of the very same observations. With the
+ * `-o` option the observations are also written to a CSV file, from where
+ * the same fleet can be loaded into the MobilityDB extension to measure the
+ * server-side ingestion path, e.g., with
+ * @code
+ * CREATE TABLE trip_input(vehicle int, t timestamptz, geom geometry(Point));
+ * \copy trip_input FROM 'fleet.csv' CSV HEADER
+ * \timing on
+ * SELECT vehicle, tgeompointseq(array_agg(tgeompoint(geom, t) ORDER BY t))
+ * FROM trip_input GROUP BY vehicle;
+ * @endcode
+ *
+ * The program can be built with the `meos_bench_ingest` CMake target, which
+ * is enabled with `-DMEOS_BENCH=ON`, or by hand as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o meos_bench_ingest meos_bench_ingest.c
+ *   -L/usr/local/lib -lmeos
+ * @endcode
+ * and run as follows
+ * @code
+ * meos_bench_ingest [-v vehicles] [-i instants] [-o fleet.csv] [result.json]
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* Include the MEOS API header */
+#include <meos.h>
+
+/* Default number of vehicles in the generated fleet */
+#define INGEST_DEFAULT_VEHICLES 100
+/* Default number of observations generated per vehicle */
+#define INGEST_DEFAULT_INSTANTS 1000
+/* Seed of the generator, fixed for reproducible fleets */
+#define INGEST_SEED 87
+/* Maximum length in characters of an observation in WKT format */
+#define MAX_LEN_INST 128
+/* Extent of the generated fleet, roughly the Brussels region */
+#define INGEST_XORIGIN 4.35
+#define INGEST_YORIGIN 50.85
+#define INGEST_STEP 0.0001
+
+/**
+ * @brief Return the value of a monotonic clock in seconds
+ */
+static double
+bench_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Comparator of two doubles for the latency percentiles
+ */
+static int
+double_cmp(const void *a, const void *b)
+{
+  double d1 = *(const double *) a, d2 = *(const double *) b;
+  if (d1 < d2)
+    return -1;
+  return d1 > d2 ? 1 : 0;
+}
+
+/**
+ * @brief Return a percentile of a sorted array of latencies in seconds
+ */
+static double
+latency_percentile(const double *sorted, int count, double pct)
+{
+  int idx = (int) (pct * (count - 1) + 0.5);
+  return sorted[idx];
+}
+
+/**
+ * @brief Generate the observations of a fleet as WKT instant strings
+ *
+ * Every vehicle performs a random walk starting from a point of the extent
+ * with one observation per second, which mimics the shape, although not the
+ * road-network realism, of the BerlinMOD trips in `datagen`.
+ */
+static char **
+ingest_generate_fleet(int vehicles, int instants)
+{
+  srand(INGEST_SEED);
+  TimestampTz torigin = pg_timestamptz_in("2020-06-01 08:00:00+00", -1);
+  char **observations = malloc(sizeof(char *) * vehicles * instants);
+  int nobs = 0;
+  for (int v = 0; v < vehicles; v++)
+  {
+    double x = INGEST_XORIGIN + (rand() % 1000) * INGEST_STEP;
+    double y = INGEST_YORIGIN + (rand() % 1000) * INGEST_STEP;
+    for (int i = 0; i < instants; i++)
+    {
+      x += (rand() % 3 - 1) * INGEST_STEP;
+      y += (rand() % 3 - 1) * INGEST_STEP;
+      char *time_str = pg_timestamptz_out(torigin + (int64) i * 1000000);
+      observations[nobs] = malloc(MAX_LEN_INST);
+      snprintf(observations[nobs++], MAX_LEN_INST, "POINT(%lf %lf)@%s",
+        x, y, time_str);
+      free(time_str);
+    }
+  }
+  return observations;
+}
+
+/**
+ * @brief Write the observations of the fleet to a CSV file suitable for
+ * loading into the MobilityDB extension with the `COPY` command
+ */
+static int
+ingest_write_csv(const char *filename, char **observations, int vehicles,
+  int instants)
+{
+  FILE *file = fopen(filename, "w");
+  if (! file)
+  {
+    printf("Error creating the CSV file '%s'\n", filename);
+    return EXIT_FAILURE;
+  }
+  fprintf(file, "vehicle,t,geom\n");
+  for (int v = 0; v < vehicles; v++)
+    for (int i = 0; i < instants; i++)
+    {
+      /* Split the WKT instant 'POINT(x y)@t' into its point and timestamp */
+      const char *obs = observations[v * instants + i];
+      const char *at = strchr(obs, '@');
+      fprintf(file, "%d,%s,\"%.*s\"\n", v + 1, at + 1, (int) (at - obs), obs);
+    }
+  fclose(file);
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+  int vehicles = INGEST_DEFAULT_VEHICLES;
+  int instants = INGEST_DEFAULT_INSTANTS;
+  const char *csvfile = NULL;
+  FILE *bench_out = stdout;
+
+  /* Process the program arguments */
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-v") == 0 && i + 1 < argc)
+      vehicles = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+      instants = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      csvfile = argv[++i];
+    else
+    {
+      bench_out = fopen(argv[i], "w");
+      if (! bench_out)
+      {
+        printf("Error creating the output file '%s'\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  if (vehicles < 1 || instants < 2)
+  {
+    printf("The fleet must have at least one vehicle with two instants\n");
+    return EXIT_FAILURE;
+  }
+
+  /* Initialize MEOS */
+  meos_initialize(NULL, NULL);
+
+  /* Generate the fleet, outside of the measured ingestion path */
+  char **observations = ingest_generate_fleet(vehicles, instants);
+  if (csvfile && ingest_write_csv(csvfile, observations, vehicles,
+        instants) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  /* Ingest the fleet, measuring the latency of every trip */
+  TInstant **trip_instants = malloc(sizeof(TInstant *) * instants);
+  double *latencies = malloc(sizeof(double) * vehicles);
+  double parse_secs = 0.0, assemble_secs = 0.0;
+  double start = bench_now();
+  for (int v = 0; v < vehicles; v++)
+  {
+    double trip_start = bench_now();
+    for (int i = 0; i < instants; i++)
+      trip_instants[i] = (TInstant *)
+        tgeompoint_in(observations[v * instants + i]);
+    double trip_parsed = bench_now();
+    TSequence *trip = tsequence_make((const TInstant **) trip_instants,
+      instants, true, true, LINEAR, true);
+    double trip_end = bench_now();
+    parse_secs += trip_parsed - trip_start;
+    assemble_secs += trip_end - trip_parsed;
+    latencies[v] = trip_end - trip_start;
+    free(trip);
+    for (int i = 0; i < instants; i++)
+      free(trip_instants[i]);
+  }
+  double total_secs = bench_now() - start;
+
+  /* Report the throughput and the per-trip latency percentiles */
+  qsort(latencies, vehicles, sizeof(double), &double_cmp);
+  long nobs = (long) vehicles * instants;
+  fprintf(bench_out, "{\"name\": \"ingest_berlinmod\", \"vehicles\": %d, "
+    "\"instants\": %d,\n  \"parse_obs_per_sec\": %.1f, "
+    "\"assemble_obs_per_sec\": %.1f, \"obs_per_sec\": %.1f,\n"
+    "  \"trip_latency_ms\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, "
+    "\"max\": %.3f}}\n",
+    vehicles, instants, (double) nobs / parse_secs,
+    (double) nobs / assemble_secs, (double) nobs / total_secs,
+    latency_percentile(latencies, vehicles, 0.50) * 1e3,
+    latency_percentile(latencies, vehicles, 0.90) * 1e3,
+    latency_percentile(latencies, vehicles, 0.99) * 1e3,
+    latencies[vehicles - 1] * 1e3);
+
+  for (long i = 0; i < nobs; i++)
+    free(observations[i]);
+  free(observations);
+  free(trip_instants);
+  free(latencies);
+
+  /* Finalize MEOS */
+  meos_finalize();
+
+  if (bench_out != stdout)
+    fclose(bench_out);
+  return EXIT_SUCCESS;
+}
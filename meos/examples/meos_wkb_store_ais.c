@@ -0,0 +1,291 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief A simple program that reads AIS data from a CSV file, constructs
+ * trips from these records, and stores the trips in a binary stream file in
+ * Well-Known Binary (WKB) format instead of text literals. The file is then
+ * read back with the trusted binary input function and the round trip is
+ * verified.
+ *
+ * Bulk loading through text literals pays the full cost of parsing on every
+ * row. The binary stream written by this program can be loaded with
+ * #temporal_from_wkb after validating the records once with
+ * #temporal_wkb_valid, or directly with #temporal_from_wkb_trusted when the
+ * file is known to come from this converter, which skips the per-instant
+ * validation altogether. The records of the stream are a binary COPY style
+ * framing: the MMSI as an 8-byte integer, the size of the WKB buffer as an
+ * 8-byte integer, and the WKB buffer itself.
+ *
+ * Please read the assumptions made about the input file `aisinput.csv` in
+ * the file `02_meos_read_ais.c` in the same directory, as well as the
+ * assumptions on the number of ships and observations made in the file
+ * `03_meos_assemble_ais.c`. The database loading counterpart of this flow is
+ * shown in the file `04_meos_store_ais.c`.
+ *
+ * The program can be build as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o meos_wkb_store_ais meos_wkb_store_ais.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <meos.h>
+
+/* Maximum number of instants in an input trip */
+#define MAX_INSTANTS 50000
+/* Number of instants in a batch for printing a marker */
+#define NO_INSTANTS_BATCH 1000
+/* Maximum length in characters of a header record in the input CSV file */
+#define MAX_LENGTH_HEADER 1024
+/* Maximum length in characters of a point in the input data */
+#define MAX_LENGTH_POINT 64
+/* Maximum length in characters of a timestamp in the input data */
+#define MAX_LENGTH_TIMESTAMP 32
+/* Maximum number of trips */
+#define MAX_TRIPS 5
+
+typedef struct
+{
+  Timestamp T;
+  long int MMSI;
+  double Latitude;
+  double Longitude;
+  double SOG;
+} AIS_record;
+
+typedef struct
+{
+  long int MMSI;   /* Identifier of the trip */
+  int numinstants; /* Number of input instants */
+  TInstant *trip_instants[MAX_INSTANTS]; /* Array of instants for the trip */
+  Temporal *trip;  /* Trip constructed from the input instants */
+} trip_record;
+
+/* Main program */
+int main(void)
+{
+  /* Initialize MEOS */
+  meos_initialize("UTC", NULL);
+
+  /* Get start time */
+  clock_t t;
+  t = clock();
+
+  /* Allocate space to build the trips */
+  trip_record trips[MAX_TRIPS] = {0};
+  /* Number of ships */
+  int numships = 0;
+  /* Iterator variables */
+  int i, j;
+  /* Return value */
+  int return_value = 0;
+
+  /* Substitute the full file path in the first argument of fopen */
+  FILE *file = fopen("aisinput.csv", "r");
+
+  if (! file)
+  {
+    printf("Error opening file\n");
+    meos_finalize();
+    return 1;
+  }
+
+  AIS_record rec;
+  int no_records = 0;
+  int no_nulls = 0;
+  char header_buffer[MAX_LENGTH_HEADER];
+  char point_buffer[MAX_LENGTH_POINT];
+  char timestamp_buffer[MAX_LENGTH_TIMESTAMP];
+
+  /* Read the first line of the file with the headers */
+  fscanf(file, "%1023s\n", header_buffer);
+
+  printf("Reading the instants (one marker every %d instants)\n",
+    NO_INSTANTS_BATCH);
+
+  /* Continue reading the file */
+  do
+  {
+    int read = fscanf(file, "%31[^,],%ld,%lf,%lf,%lf\n",
+      timestamp_buffer, &rec.MMSI, &rec.Latitude, &rec.Longitude, &rec.SOG);
+    /* Transform the string representing the timestamp into a timestamp value */
+    rec.T = pg_timestamp_in(timestamp_buffer, -1);
+
+    if (read == 5)
+    {
+      no_records++;
+      if (no_records % NO_INSTANTS_BATCH == 0)
+      {
+        printf("*");
+        fflush(stdout);
+      }
+    }
+
+    if (read != 5 && !feof(file))
+    {
+      printf("Record with missing values ignored\n");
+      no_nulls++;
+    }
+
+    if (ferror(file))
+    {
+      printf("Error reading the input file");
+      return_value = 1;
+      goto cleanup;
+    }
+
+    /* Find the place to store the new instant */
+    int ship = -1;
+    for (i = 0; i < MAX_TRIPS; i++)
+    {
+      if (trips[i].MMSI == rec.MMSI)
+      {
+        ship = i;
+        break;
+      }
+    }
+    if (ship < 0)
+    {
+      ship = numships++;
+      if (ship == MAX_TRIPS)
+      {
+        printf("The maximum number of ships in the input file is bigger than %d",
+          MAX_TRIPS);
+        return_value = 1;
+        goto cleanup;
+      }
+      trips[ship].MMSI = rec.MMSI;
+    }
+
+    /*
+     * Create the instant and store it in the array of the corresponding ship.
+     * In the input file it is assumed that
+     * - The coordinates are given in the WGS84 geographic coordinate system
+     * - The timestamps are given in GMT time zone
+     */
+    char *t_out = pg_timestamp_out(rec.T);
+    sprintf(point_buffer, "SRID=4326;Point(%lf %lf)@%s+00", rec.Longitude,
+      rec.Latitude, t_out);
+    TInstant *inst = (TInstant *) tgeogpoint_in(point_buffer);
+    trips[ship].trip_instants[trips[ship].numinstants++] = inst;
+  } while (!feof(file));
+
+  /* Close the input file */
+  fclose(file);
+
+  printf("\n%d records read.\n%d incomplete records ignored.\n",
+    no_records, no_nulls);
+  printf("%d trips read.\n", numships);
+
+  /* Construct the trips */
+  for (i = 0; i < numships; i++)
+  {
+    trips[i].trip = (Temporal *) tsequence_make(
+      (const TInstant **) trips[i].trip_instants,
+      trips[i].numinstants, true, true, LINEAR, true);
+    printf("MMSI: %ld, Number of input instants: %d\n", trips[i].MMSI,
+      trips[i].numinstants);
+  }
+
+  /* Write the trips into the binary stream file */
+  file = fopen("aistrips.wkb", "w+b");
+  for (i = 0; i < numships; i++)
+  {
+    size_t wkb_size;
+    uint8_t *wkb = temporal_as_wkb(trips[i].trip, 0, &wkb_size);
+    int64_t mmsi = (int64_t) trips[i].MMSI;
+    uint64_t size = (uint64_t) wkb_size;
+    fwrite(&mmsi, sizeof(int64_t), 1, file);
+    fwrite(&size, sizeof(uint64_t), 1, file);
+    fwrite(wkb, 1, wkb_size, file);
+    free(wkb);
+  }
+  fclose(file);
+  printf("%d trips written to file 'aistrips.wkb'\n", numships);
+
+  /* Read the trips back with the trusted binary input function. The stream
+   * was produced by temporal_as_wkb just above, so skipping the validation
+   * is safe; a stream of unknown provenance should instead be checked once
+   * with temporal_wkb_valid or read with temporal_from_wkb */
+  file = fopen("aistrips.wkb", "rb");
+  int no_trips = 0;
+  while (true)
+  {
+    int64_t mmsi;
+    uint64_t size;
+    if (fread(&mmsi, sizeof(int64_t), 1, file) != 1)
+      break;
+    if (fread(&size, sizeof(uint64_t), 1, file) != 1)
+      break;
+    uint8_t *wkb = malloc(size);
+    if (fread(wkb, 1, size, file) != size)
+    {
+      free(wkb);
+      break;
+    }
+    Temporal *trip = temporal_from_wkb_trusted(wkb, size);
+    free(wkb);
+    printf("MMSI: %ld, Number of instants read back: %d\n", (long int) mmsi,
+      temporal_num_instants(trip));
+    free(trip);
+    no_trips++;
+  }
+  fclose(file);
+  if (no_trips != numships)
+  {
+    printf("Error: %d trips written but %d trips read back\n", numships,
+      no_trips);
+    return_value = 1;
+  }
+
+  /* Calculate the elapsed time */
+  t = clock() - t;
+  double time_taken = ((double) t) / CLOCKS_PER_SEC;
+  printf("The program took %f seconds to execute\n", time_taken);
+
+/* Clean up */
+cleanup:
+
+ /* Free memory */
+  for (i = 0; i < numships; i++)
+  {
+    free(trips[i].trip);
+    for (j = 0; j < trips[i].numinstants; j++)
+      free(trips[i].trip_instants[j]);
+  }
+
+  /* Finalize MEOS */
+  meos_finalize();
+
+  return return_value;
+}
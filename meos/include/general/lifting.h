@@ -66,10 +66,16 @@ typedef struct
   bool (*tpfunc)(const TInstant *, const TInstant *, const TInstant *,
     const TInstant *,
     Datum *, TimestampTz *); /**< Turning point function for two temporal types */
+  void *scratch;             /**< Caller-owned scratch buffer reused across the
+                                  calls of a batch; see #lfinfo_scratch_init */
+  size_t scratchsize;        /**< Allocated size of the scratch buffer */
 } LiftedFunctionInfo;
 
 /*****************************************************************************/
 
+extern void lfinfo_scratch_init(LiftedFunctionInfo *lfinfo);
+extern void lfinfo_scratch_free(LiftedFunctionInfo *lfinfo);
+
 extern TInstant *tfunc_tinstant(const TInstant *inst,
   LiftedFunctionInfo *lfinfo);
 extern TSequence *tfunc_tdiscseq(const TSequence *is,
@@ -89,6 +95,8 @@ extern TSequenceSet *tfunc_tsequenceset_base(const TSequenceSet *ss, Datum value
   LiftedFunctionInfo *lfinfo);
 extern Temporal *tfunc_temporal_base(const Temporal *temp, Datum value,
   LiftedFunctionInfo *lfinfo);
+extern Temporal **tfunc_temporal_base_batch(const Temporal **temparr,
+  int count, Datum value, LiftedFunctionInfo *lfinfo);
 
 extern TInstant *tfunc_tinstant_tinstant(const TInstant *inst1,
   const TInstant *inst2, LiftedFunctionInfo *lfinfo);
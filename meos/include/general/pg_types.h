@@ -44,22 +44,26 @@
 
 extern bool bool_in(const char *in_str);
 extern char *bool_out(bool b);
+extern int bool_out_buf(bool b, char *buf);
 
 /* Functions adapted from int.c */
 
 extern int32 int4_in(const char *str);
 extern char *int4_out(int32 val);
+extern int int4_out_buf(int32 val, char *buf);
 
 /* Functions adapted from int8.c */
 
 extern int64 int8_in(const char *str);
 extern char *int8_out(int64 val);
+extern int int8_out_buf(int64 val, char *buf);
 
 /* Functions adapted from float.c */
 
 extern float8 float8_in(const char *num, const char *type_name,
   const char *orig_string);
 extern char *float8_out(double num, int maxdd);
+extern int float8_out_buf(double num, int maxdd, char *buf);
 extern float8 pg_dsin(float8 arg1);
 extern float8 pg_dcos(float8 arg1);
 extern float8 pg_datan(float8 arg1);
@@ -69,6 +73,10 @@ extern float8 pg_datan2(float8 arg1, float8 arg2);
 
 extern TimestampTz pg_timestamptz_in(const char *str, int32 typmod);
 extern char *pg_timestamptz_out(TimestampTz dt);
+extern int pg_timestamptz_out_buf(TimestampTz dt, char *buf);
+extern char **pg_timestamptz_out_batch(const TimestampTz *times, int count);
+extern int pg_timestamptz_out_batch_buf(const TimestampTz *times, int count,
+  char *buf);
 
 extern Interval *pg_interval_pl(const Interval *span1, const Interval *span2);
 extern TimestampTz pg_timestamp_pl_interval(TimestampTz timestamp,
@@ -50,6 +50,8 @@ extern SkipList *skiplist_make(void **values, int count);
 extern void *skiplist_headval(SkipList *list);
 extern void skiplist_splice(SkipList *list, void **values, int count,
   datum_func2 func, bool crossings);
+extern void skiplist_splice_buffered(SkipList *list, void *value,
+  datum_func2 func, bool crossings);
 extern void **skiplist_values(SkipList *list);
 extern Temporal **skiplist_temporal_values(SkipList *list);
 extern void skiplist_free(SkipList *list);
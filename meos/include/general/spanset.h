@@ -48,6 +48,8 @@ extern bool ensure_same_spanset_type(const SpanSet *ss1, const SpanSet *ss2);
 extern bool ensure_same_spanset_span_type(const SpanSet *ss, const Span *s);
 extern bool ensure_same_spanset_basetype(const SpanSet *ss, meosType basetype);
 extern bool spanset_find_value(const SpanSet *ss, Datum v, int *loc);
+extern bool spanset_index_find_value(const SpanSet *ss, const SpanIndex *idx,
+  Datum v, int *loc);
 extern const Span *spanset_sp_n(const SpanSet *ss, int index);
 
 /*****************************************************************************/
@@ -0,0 +1,68 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Lightweight performance counters for key entry points of MEOS
+ */
+
+#ifndef __STATS_H__
+#define __STATS_H__
+
+/* MEOS */
+#include <meos.h>
+
+/*****************************************************************************/
+
+/* Counter state, to be accessed only through the macros below */
+
+extern bool _meos_stats_enabled;
+extern MeosStats _meos_stats;
+
+/**
+ * @brief Add a count to a performance counter
+ *
+ * When the counters are disabled the cost is a single load and a
+ * well-predicted branch. When they are enabled a relaxed atomic addition is
+ * used so that loops running under the thread pool do not lose counts.
+ */
+#define MEOS_STATS_ADD(field, n) \
+  do { \
+    if (_meos_stats_enabled) \
+      __atomic_fetch_add(&_meos_stats.field, (int64_t) (n), \
+        __ATOMIC_RELAXED); \
+  } while (0)
+
+/**
+ * @brief Increment a performance counter by one
+ */
+#define MEOS_STATS_INC(field) MEOS_STATS_ADD(field, 1)
+
+/*****************************************************************************/
+
+#endif /* __STATS_H__ */
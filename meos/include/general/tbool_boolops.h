@@ -41,11 +41,15 @@
 
 extern Datum datum_and(Datum l, Datum r);
 extern Datum datum_or(Datum l, Datum r);
+extern Datum datum_nand(Datum l, Datum r);
+extern Datum datum_nor(Datum l, Datum r);
 
 extern Temporal *boolop_tbool_bool(const Temporal *temp, Datum b,
   datum_func2 func, bool invert);
 extern Temporal *boolop_tbool_tbool(const Temporal *temp1,
   const Temporal *temp2, datum_func2 func);
+extern int eboolop_tbool_tbool(const Temporal *temp1,
+  const Temporal *temp2, datum_func2 func);
 extern Temporal *tnot_tbool(const Temporal *temp);
 
 /*****************************************************************************/
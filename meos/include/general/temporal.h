@@ -209,6 +209,13 @@ enum MEOS_WKB_TSUBTYPE
 #define MEOS_WKB_ZFLAG            0x10  // 16
 #define MEOS_WKB_GEODETICFLAG     0x20  // 32
 #define MEOS_WKB_SRIDFLAG         0x40  // 64
+#define MEOS_WKB_COMPRESSEDFLAG   0x80  // 128
+
+/* Number of instants per block of a compressed instant array. Each block is
+ * an independent delta/XOR stream preceded by a directory entry with its
+ * time and value extrema, so readers can locate and decompress only the
+ * blocks covering a search interval */
+#define MEOS_WKB_COMPRESS_BLOCKSIZE 64
 
 #define MEOS_WKB_GET_INTERP(flags) (((flags) & MEOS_WKB_INTERPFLAGS) >> 2)
 #define MEOS_WKB_SET_INTERP(flags, value) ((flags) = (((flags) & ~MEOS_WKB_INTERPFLAGS) | ((value & 0x0003) << 2)))
@@ -388,6 +395,10 @@ extern bool ensure_valid_duration(const Interval *duration);
 
 extern void *temporal_bbox_ptr(const Temporal *temp);
 extern void temporal_bbox_slice(Datum tempdatum, void *box);
+extern void temporal_period_slice(Datum tempdatum, Span *p);
+extern void tnumber_span_slice(Datum tempdatum, Span *s);
+extern int temporal_count_slice(Datum tempdatum);
+extern TInstant *temporal_instant_slice(Datum tempdatum, bool last);
 
 extern bool intersection_temporal_temporal(const Temporal *temp1,
   const Temporal *temp2, SyncMode mode, Temporal **inter1, Temporal **inter2);
@@ -401,8 +412,8 @@ extern char *mobilitydb_full_version(void);
 
 extern bool temporal_bbox_ev_al_eq(const Temporal *temp, Datum value,
   bool ever);
-extern bool temporal_bbox_ev_al_lt_le(const Temporal *temp, Datum value,
-  bool ever);
+extern bool tnumber_bbox_ev_al_lt_le(const Temporal *temp, Datum value,
+  bool ever, bool strict, bool *result);
 
 /* Restriction functions */
 
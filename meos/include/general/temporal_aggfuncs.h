@@ -85,9 +85,19 @@ extern SkipList *temporal_tagg_transfn(SkipList *state, const Temporal *temp,
 extern SkipList *temporal_tagg_combinefn(SkipList *state1, SkipList *state2,
   datum_func2 func, bool crossings);
 extern Temporal *temporal_tagg_finalfn(SkipList *state);
+extern Temporal *temporal_tagg_readfn(SkipList *state);
 extern SkipList *temporal_tagg_transform_transfn(SkipList *state, const Temporal *temp,
   datum_func2 func, bool crossings, TInstant *(*transform)(const TInstant *));
 
+extern BucketAggState *temporal_tagg_bucket_transfn(BucketAggState *state,
+  const Temporal *temp, const Interval *duration, TimestampTz torigin,
+  datum_func2 func, bool crossings, TInstant *(*transform)(const TInstant *));
+#if MEOS
+extern SkipList *temporal_tagg_array_transfn(SkipList *state,
+  const Temporal **temparr, int count, datum_func2 func, bool crossings,
+  TInstant *(*transform)(const TInstant *));
+#endif /* MEOS */
+
 /*****************************************************************************/
 
 #endif
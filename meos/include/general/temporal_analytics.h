@@ -58,6 +58,8 @@ typedef struct
 
 extern double temporal_similarity(const Temporal *temp1, const Temporal *temp2,
   SimFunc simfunc);
+extern double *temporal_similarity_matrix(const Temporal **temparr, int count,
+  SimFunc simfunc);
 extern Match *temporal_similarity_path(const Temporal *temp1,
   const Temporal *temp2, int *count, SimFunc simfunc);
 
@@ -86,6 +86,33 @@ typedef struct ValueTimeSplitState
   int count;
 } ValueTimeSplitState;
 
+/**
+ * Struct for storing the state of the streaming time split, which produces
+ * the fragments one time bucket at a time
+ */
+typedef struct TimeSplitState
+{
+  bool done;               /**< True when all fragments have been produced */
+  int64 tunits;            /**< Size of the time buckets in PostgreSQL time units */
+  TimestampTz torigin;     /**< Time origin of the buckets */
+  TimestampTz end;         /**< End timestamp of the buckets */
+  const Temporal *temp;    /**< Temporal value being split */
+  int seqno;               /**< Number of the next sequence of a sequence set */
+  const TSequence *seq;    /**< Sequence being scanned, NULL when finished */
+  int i;                   /**< Number of the next instant of the sequence */
+  TimestampTz lower;       /**< Lower bound of the current time bucket */
+  TimestampTz upper;       /**< Upper bound of the current time bucket */
+  int nfrags;              /**< Fragments produced for the current sequence */
+  TInstant *carry;         /**< Boundary instant carried to the next bucket */
+  const TInstant **instants; /**< Scratch array for the instants of a bucket */
+  int maxinsts;            /**< Allocated size of the scratch array */
+  TSequence **fragments;   /**< Fragments accumulated for the current bucket */
+  int nfragments;          /**< Number of accumulated fragments */
+  TimestampTz acctime;     /**< Bucket of the accumulated fragments */
+  TSequence *pending;      /**< Fragment of the next bucket produced ahead */
+  TimestampTz pendingtime; /**< Bucket of the pending fragment */
+} TimeSplitState;
+
 /*****************************************************************************/
 
 extern void span_bucket_set(Datum lower, Datum size, meosType basetype,
@@ -104,6 +131,7 @@ extern void tbox_tile_state_next(TboxGridState *state);
 /*****************************************************************************/
 
 extern int64 interval_units(const Interval *interval);
+extern int64 interval_units_checked(const Interval *duration);
 extern TimestampTz timestamptz_bucket1(TimestampTz timestamp, int64 tunits,
   TimestampTz torigin);
 extern Datum datum_bucket(Datum value, Datum size, Datum offset,
@@ -111,6 +139,11 @@ extern Datum datum_bucket(Datum value, Datum size, Datum offset,
 
 extern Temporal **temporal_time_split(Temporal *temp, Interval *duration,
   TimestampTz torigin, TimestampTz **time_buckets, int *count);
+extern TimeSplitState *time_split_state_make(const Temporal *temp,
+  const Interval *duration, TimestampTz torigin);
+extern Temporal *time_split_state_next(TimeSplitState *state,
+  TimestampTz *time);
+extern void time_split_state_free(TimeSplitState *state);
 extern Temporal **tnumber_value_time_split(Temporal *temp, Datum size,
   Interval *duration, Datum vorigin, TimestampTz torigin,
   Datum **value_buckets, TimestampTz **time_buckets, int *count);
@@ -50,6 +50,9 @@ extern double tnumberinst_double(const TInstant *inst);
 
 /* Input/output functions */
 
+extern size_t tinstant_to_string_size(const TInstant *inst, int maxdd);
+extern size_t tinstant_to_string_buf(char *output, const TInstant *inst,
+  int maxdd);
 extern char *tinstant_to_string(const TInstant *inst, int maxdd,
   outfunc value_out);
 
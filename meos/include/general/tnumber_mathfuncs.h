@@ -38,6 +38,7 @@
 /* PostgreSQL */
 #include <postgres.h>
 /* PostgreSQL */
+#include "general/lifting.h"
 #include "general/temporal.h"
 
 /*****************************************************************************/
@@ -71,6 +72,31 @@ extern Temporal *arithop_tnumber_tnumber(const Temporal *temp1,
   bool (*tpfunc)(const TInstant *, const TInstant *, const TInstant *,
     const TInstant *, Datum *, TimestampTz *));
 
+/**
+ * Structure to represent a prepared arithmetic operation on a temporal
+ * number and a number
+ *
+ * The structure caches the dispatch decisions and the lifted function
+ * descriptor that `arithop_tnumber_number` rebuilds on every call so that
+ * the operation can be constructed once and applied to many temporal values
+ */
+typedef struct
+{
+  TArithmetic oper;          /**< Arithmetic operator */
+  meosType temptype;         /**< Temporal type of the temporal argument */
+  meosType basetype;         /**< Base type of the number argument */
+  bool invert;               /**< True if the number is the first argument */
+  bool specialized;          /**< True if the by-value fast path applies */
+  LiftedFunctionInfo lfinfo; /**< Prepared lifted function descriptor */
+} TNumberArithOp;
+
+extern TNumberArithOp *tnumber_arithop_make(meosType temptype,
+  meosType basetype, TArithmetic oper, bool invert);
+extern Temporal *tnumber_arithop_apply(const TNumberArithOp *op,
+  const Temporal *temp, Datum value);
+extern Temporal **tnumber_arithop_apply_batch(const TNumberArithOp *op,
+  const Temporal **temparr, int count, Datum value);
+
 extern Datum datum_round_float(Datum value, Datum size);
 
 extern TSequence *tfloatseq_derivative(const TSequence *seq);
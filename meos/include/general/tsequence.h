@@ -46,6 +46,8 @@
 
 extern int tcontseq_find_timestamp(const TSequence *seq, TimestampTz t);
 extern int tdiscseq_find_timestamp(const TSequence *seq, TimestampTz t);
+extern void tcontseq_find_timestamp_batch(const TSequence *seq,
+  const TimestampTz *times, int count, int *locs);
 extern bool tsequence_make_valid1(const TInstant **instants, int count,
   bool lower_inc, bool upper_inc, interpType interp);
 extern TSequence *tsequence_make1_exp(const TInstant **instants, int count,
@@ -65,7 +67,7 @@ extern TSequence *tsequence_join(const TSequence *seq1, const TSequence *seq2,
 extern TSequence **tseqarr_normalize(const TSequence **sequences, int count,
   int *newcount);
 extern TSequence **tsequence_merge_array1(const TSequence **sequences,
-  int count, int *totalcount);
+  int count, bool sorted, int *totalcount);
 
 /* Synchronization functions */
 
@@ -73,6 +75,48 @@ extern bool synchronize_tsequence_tsequence(const TSequence *seq1,
   const TSequence *seq2, TSequence **sync1, TSequence **sync2,
   bool interpoint);
 
+/**
+ * Structure to represent an aligned pair of base values produced by the
+ * synchronized iteration over two temporal sequences
+ */
+typedef struct
+{
+  TimestampTz t;                 /**< Timestamp of the pair */
+  Datum value1, value2;          /**< Values of the sequences at the time */
+} TSyncPair;
+
+/**
+ * Structure to represent the state of the synchronized iteration over two
+ * temporal sequences
+ */
+typedef struct
+{
+  const TSequence *seq1, *seq2;  /**< Sequences iterated over */
+  interpType interp1, interp2;   /**< Interpolation of the sequences */
+  Span inter;                    /**< Intersection of the time spans */
+  bool crossings;                /**< True if crossings are yielded */
+  bool done;                     /**< True if there are no more pairs */
+  int i, j;                      /**< Current position in each sequence */
+  int npairs;                    /**< Number of pairs already yielded */
+  const TInstant *inst1, *inst2; /**< Next instants to be synchronized */
+  const TInstant *prev1, *prev2; /**< Last synchronized instants */
+  TSyncPair pending[2];          /**< Pairs computed and not yet yielded */
+  int npending;                  /**< Number of pending pairs */
+  int curpending;                /**< Next pending pair to yield */
+  TInstant *tofree[4];           /**< Scratch instants of the current step */
+  int nfree;                     /**< Number of scratch instants */
+  TInstant *tofree_prev[4];      /**< Scratch instants of the previous step */
+  int nfree_prev;                /**< Number of previous scratch instants */
+} TSeqSyncIter;
+
+extern bool tsequence_sync_iter_start(const TSequence *seq1,
+  const TSequence *seq2, bool crossings, TSeqSyncIter *iter);
+extern bool tsequence_sync_iter_next(TSeqSyncIter *iter, TimestampTz *t,
+  Datum *value1, Datum *value2);
+extern void tsequence_sync_iter_close(TSeqSyncIter *iter);
+extern int tsequence_sync_pairs(const TSequence *seq1, const TSequence *seq2,
+  bool crossings, TSyncPair **pairs, int *maxcount);
+
 /* Intersection functions */
 
 extern bool tlinearsegm_intersection_value(const TInstant *inst1,
@@ -97,6 +141,10 @@ extern bool intersection_tinstant_tsequence(const TInstant *inst,
 
 /* Input/output functions */
 
+extern size_t tsequence_to_string_size(const TSequence *seq, int maxdd,
+  bool component);
+extern size_t tsequence_to_string_buf(char *output, const TSequence *seq,
+  int maxdd, bool component);
 extern char *tsequence_to_string(const TSequence *seq, int maxdd,
   bool component, outfunc value_out);
 
@@ -70,6 +70,7 @@ extern uint8_t *datum_as_wkb(Datum value, meosType type, uint8_t variant,
   size_t *size_out);
 extern char *datum_as_hexwkb(Datum value, meosType type, uint8_t variant,
   size_t *size);
+extern uint64 datum_hash_wkb_extended(Datum value, meosType type, uint64 seed);
 
 /*****************************************************************************/
 
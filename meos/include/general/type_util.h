@@ -53,13 +53,39 @@ extern bytea *bstring2bytea(const uint8_t *wkb, size_t size);
 
 extern bool basetype_in(const char *str, meosType type, bool end, Datum *result);
 extern char *basetype_out(Datum value, meosType type, int maxdd);
+extern size_t basetype_out_size(Datum value, meosType type, int maxdd);
+extern size_t basetype_out_buf(char *output, Datum value, meosType type,
+  int maxdd);
 
 /* Array functions */
 
 extern void pfree_array(void **array, int count);
 extern void pfree_datumarr(Datum *array, int count);
-extern char *stringarr_to_string(char **strings, int count, size_t outlen,
-  char *prefix, char open, char close, bool quotes, bool spaces);
+extern char *stringarr_to_string(char **strings, const size_t *lengths,
+  int count, size_t outlen, char *prefix, char open, char close, bool quotes,
+  bool spaces);
+
+#if MEOS
+/**
+ * @brief State for producing textual output in chunks that are handed to a
+ * caller-supplied callback, instead of materializing the whole result
+ */
+typedef struct StringWriter
+{
+  char *buf;     /**< Chunk buffer */
+  size_t size;   /**< Size of the chunk buffer */
+  size_t len;    /**< Number of bytes pending in the buffer */
+  size_t (*writefn)(const char *, size_t, void *); /**< Output callback */
+  void *state;   /**< Opaque state passed to the callback */
+  bool failed;   /**< True when the callback did not accept the bytes */
+} StringWriter;
+
+extern void string_writer_init(StringWriter *writer, size_t chunksize,
+  size_t (*writefn)(const char *, size_t, void *), void *state);
+extern void string_writer_append(StringWriter *writer, const char *str,
+  size_t length);
+extern bool string_writer_finish(StringWriter *writer);
+#endif /* MEOS */
 
 /* Sort functions */
 
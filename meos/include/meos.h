@@ -37,6 +37,7 @@
 /* C */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 /* PostgreSQL */
 #include "postgres_int_defs.h"
 /* PostGIS */
@@ -149,6 +150,20 @@ typedef enum
   LINEAR =         3,
 } interpType;
 
+/**
+ * @brief Enumeration that defines the validation level applied by the
+ * trusted constructors to their input arrays. Machine-generated input, for
+ * example, position reports received in ascending timestamp order, is
+ * typically known to be valid and the full validation pass can be reduced
+ * to an ordering test or skipped altogether.
+ */
+typedef enum
+{
+  VALIDATE_NONE =  0,  /**< The input is fully trusted, skip all tests */
+  VALIDATE_ORDER = 1,  /**< Only verify the ordering of the elements */
+  VALIDATE_FULL =  2,  /**< Perform all the validity tests */
+} validateLevel;
+
 /**
  * @brief Enumeration that defines the spatial relationships for which a call
  * to GEOS is made.
@@ -160,6 +175,17 @@ typedef enum
   TOUCHES =        2,
 } spatialRel;
 
+/**
+ * @brief Enumeration that defines the per-bucket reductions applied when
+ * resampling a temporal value, see temporal_tresample().
+ */
+typedef enum
+{
+  TRESAMPLE_TWAVG = 0,
+  TRESAMPLE_MIN =   1,
+  TRESAMPLE_MAX =   2,
+} reductionType;
+
 /**
  * Structure to represent the common structure of temporal values of
  * any temporal subtype
@@ -202,7 +228,10 @@ typedef struct
   int32 count;          /**< Number of TInstant elements */
   int32 maxcount;       /**< Maximum number of TInstant elements */
   int16 bboxsize;       /**< Size of the bounding box */
-  char padding[6];      /**< Not used */
+  uint16 generation;    /**< Generation counter bumped by every in-place
+                             modification, used by attached caches to
+                             revalidate in O(1), see #temporal_generation */
+  char padding[4];      /**< Not used */
   Span period;          /**< Time span (24 bytes). All bounding boxes start
                              with a period so actually it is also the begining
                              of the bounding box. The extra bytes needed for
@@ -226,7 +255,9 @@ typedef struct
                              composing TSequence elements */
   int32 maxcount;       /**< Maximum number of TSequence elements */
   int16 bboxsize;       /**< Size of the bounding box */
-  int16 padding;        /**< Not used */
+  uint16 generation;    /**< Generation counter bumped by every in-place
+                             modification, used by attached caches to
+                             revalidate in O(1), see #temporal_generation */
   Span period;          /**< Time span (24 bytes). All bounding boxes start
                              with a period so actually it is also the begining
                              of the bounding box. The extra bytes needed for
@@ -236,6 +267,55 @@ typedef struct
 
 #define TSEQUENCESET_BBOX_PTR(ss)      ((void *)(&(ss)->period))
 
+/**
+ * Opaque structure to represent a temporal input stream to which the text of
+ * a temporal literal is fed in chunks
+ */
+typedef struct TemporalStream TemporalStream;
+
+/**
+ * Opaque structure to represent a memory-mapped read-only file of temporal
+ * values
+ */
+typedef struct TemporalStore TemporalStore;
+
+/**
+ * Opaque structure to represent an asynchronous prefetching reader of
+ * temporal values from a text file
+ */
+typedef struct TemporalReader TemporalReader;
+
+/**
+ * Function converting one line of a text file into a temporal value; it may
+ * return @p NULL to skip the line
+ */
+typedef Temporal *(*TemporalLineParseFn)(const char *line, void *context);
+
+/**
+ * Opaque structure to represent a batch reader of fixed-schema CSV files
+ * into typed column arrays
+ */
+typedef struct CsvReader CsvReader;
+
+/**
+ * Opaque structure to represent the state of an online bounded-memory
+ * simplification of a growing sequence of observations
+ */
+typedef struct SimplifyStream SimplifyStream;
+
+/**
+ * Opaque structure to represent the precomputed nested simplification levels
+ * of a temporal value
+ */
+typedef struct TemporalPyramid TemporalPyramid;
+
+/**
+ * Opaque structure to represent the precomputed cumulative lengths of the
+ * instants of a temporal point sequence, which turns repeated
+ * distance-parameterized queries from linear to logarithmic
+ */
+typedef struct TPointLengthIndex TPointLengthIndex;
+
 /**
  * Struct for storing a similarity match
  */
@@ -245,6 +325,75 @@ typedef struct
   int j;
 } Match;
 
+/**
+ * Structure to represent a piecewise aggregate approximation (PAA) synopsis
+ * of a temporal value, which stores for every time bucket the minimum and
+ * maximum of each value dimension. The structure is contiguous in memory
+ * and thus can be stored and copied as a sequence of bytes.
+ */
+typedef struct
+{
+  int32 count;          /**< Number of time buckets */
+  int16 dims;           /**< Number of value dimensions */
+  int16 padding;        /**< Not used */
+  Span period;          /**< Time span covered by the buckets */
+  double values[1];     /**< Beginning of variable-length data */
+} TSynopsis;
+
+/**
+ * Structure to represent a cursor for repeated value-at-timestamp lookups
+ * over the same temporal value. The cursor remembers the position of the
+ * last lookup; when the probed timestamps are non-decreasing, as in replay
+ * workloads, the position is advanced linearly instead of searching from
+ * scratch, which makes the lookups amortized constant time. A lookup with
+ * an earlier timestamp falls back to the regular search. The cursor is
+ * invalidated when the temporal value is modified.
+ */
+typedef struct
+{
+  const Temporal *temp; /**< Temporal value probed by the cursor */
+  uint16 generation;    /**< Generation of the temporal value at the last
+                             lookup, see #temporal_generation */
+  TimestampTz t;        /**< Timestamp of the last lookup */
+  int i;                /**< Last accessed sequence of a sequence set */
+  int j;                /**< Last accessed segment of a sequence */
+  bool valid;           /**< True when the position of a lookup is cached */
+} TemporalCursor;
+
+/**
+ * Structure to represent an Eytzinger-layout search index over the lower
+ * bounds of a span set. Since the spans of a span set are disjoint and
+ * ordered, locating the span that may contain a value reduces to finding the
+ * last lower bound that is not greater than the value, which the
+ * breadth-first (Eytzinger) layout answers with a branch-free, cache-friendly
+ * descent. The structure is contiguous in memory and must be rebuilt after
+ * the span set is modified.
+ */
+typedef struct
+{
+  int32 count;          /**< Number of spans indexed */
+  uint8 basetype;       /**< Span basetype */
+  char padding[3];      /**< Not used */
+  Datum lowers[1];      /**< Lower bounds in Eytzinger order (slot 0 is
+                             unused), followed by the array mapping every
+                             slot to its span position */
+} SpanIndex;
+
+/**
+ * Opaque structure for storing a periodic timestamptz span set, that is, a
+ * pattern span set repeated a number of times at a fixed recurrence period.
+ * The structure is defined in file spanset.c
+ */
+typedef struct PeriodicSpanSet PeriodicSpanSet;
+
+/**
+ * Opaque structure to represent a composable restriction, that is, a
+ * collection of restriction predicates accumulated incrementally and applied
+ * to a temporal value in a single fused materialization step. The structure
+ * is defined in file temporal.c
+ */
+typedef struct Restriction Restriction;
+
 /*****************************************************************************/
 
 /**
@@ -275,8 +424,111 @@ typedef struct
   void *extra;
   size_t extrasize;
   SkipListElem *elems;
+  size_t valmem;  /**< Memory held by the values of the elements */
+  void *spill;    /**< Values spilled to disk when a memory limit is set,
+                       see meos_aggregate_set_mem_limit() */
+  void **buffer;  /**< Insertion buffer absorbing bounded disorder of the
+                       input instants, see skiplist_splice_buffered() */
+  int buffercount;    /**< Number of values in the insertion buffer */
+  bool buffersorted;  /**< True when the buffered values are in time order */
+  bool buffercross;   /**< Crossings flag passed at the buffered insertions */
+  Datum (*bufferfunc)(Datum, Datum); /**< Aggregate function passed at the
+                       buffered insertions */
 } SkipList;
 
+/**
+ * Structure to represent the state of a time-bucketed aggregation, that is,
+ * one aggregation state per time bucket
+ */
+typedef struct
+{
+  int64 tunits;         /**< Size of the time buckets in PostgreSQL time units */
+  TimestampTz torigin;  /**< Time origin of the buckets */
+  int count;            /**< Number of buckets in the state */
+  int maxcount;         /**< Maximum number of buckets in the arrays */
+  TimestampTz *buckets; /**< Start timestamp of each bucket, in ascending order */
+  SkipList **states;    /**< Aggregation state of each bucket */
+} BucketAggState;
+
+/*****************************************************************************/
+
+/**
+ * Statistics computed by tnumber_summary(), selected with a bitwise OR of
+ * the MEOS_SUMMARY_* flags
+ */
+
+#define MEOS_SUMMARY_COUNT    0x01  /**< Number of instants */
+#define MEOS_SUMMARY_MIN      0x02  /**< Minimum value */
+#define MEOS_SUMMARY_MAX      0x04  /**< Maximum value */
+#define MEOS_SUMMARY_SUM      0x08  /**< Sum of the instant values */
+#define MEOS_SUMMARY_DURATION 0x10  /**< Duration in seconds */
+#define MEOS_SUMMARY_INTEGRAL 0x20  /**< Area under the curve */
+#define MEOS_SUMMARY_TWAVG    0x40  /**< Time-weighted average */
+#define MEOS_SUMMARY_ALL      0x7F  /**< All of the above */
+
+typedef struct
+{
+  int count;        /**< Number of instants */
+  double min;       /**< Minimum value */
+  double max;       /**< Maximum value */
+  double sum;       /**< Sum of the instant values */
+  double duration;  /**< Duration in seconds, 0 for discrete values */
+  double integral;  /**< Area under the curve in value * seconds */
+  double twavg;     /**< Time-weighted average */
+} TNumberSummary;
+
+/*****************************************************************************
+ * Arrow C Data Interface
+ * The struct definitions below are mandated verbatim by the interface
+ * specification, https://arrow.apache.org/docs/format/CDataInterface.html,
+ * including the guard macro that avoids redefinition when an Arrow header
+ * is also included
+ *****************************************************************************/
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+  /* Array type description */
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+
+  /* Release callback */
+  void (*release)(struct ArrowSchema *);
+  /* Opaque producer-specific data */
+  void *private_data;
+};
+
+struct ArrowArray
+{
+  /* Array data description */
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+
+  /* Release callback */
+  void (*release)(struct ArrowArray *);
+  /* Opaque producer-specific data */
+  void *private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
 /*****************************************************************************
  * Error codes
  *****************************************************************************/
@@ -293,6 +545,7 @@ typedef enum
   MEOS_ERR_AGGREGATION_ERROR    = 6,  // Internal aggregation error
   MEOS_ERR_DIRECTORY_ERROR      = 7,  // Internal directory error
   MEOS_ERR_FILE_ERROR           = 8,  // Internal file error
+  MEOS_ERR_INTERRUPT            = 9,  // Operation canceled
 
   MEOS_ERR_INVALID_ARG          = 10, // Invalid argument
   MEOS_ERR_INVALID_ARG_TYPE     = 11, // Invalid argument type
@@ -325,6 +578,13 @@ extern int meos_errno_reset(void);
 /* Definition of error handler function */
 typedef void (*error_handler_fn)(int, int, char *);
 
+/* Cooperative interruption and progress reporting for long operations */
+typedef bool (*interrupt_callback_fn)(void *arg);
+typedef void (*progress_callback_fn)(double progress, void *arg);
+
+extern void meos_initialize_interrupt_callback(interrupt_callback_fn callback, void *arg);
+extern void meos_initialize_progress_callback(progress_callback_fn callback, void *arg);
+
 extern void meos_initialize_timezone(const char *name);
 extern void meos_initialize_error_handler(error_handler_fn err_handler);
 extern void meos_finalize_timezone(void);
@@ -332,6 +592,130 @@ extern void meos_finalize_timezone(void);
 extern void meos_initialize(const char *tz_str, error_handler_fn err_handler);
 extern void meos_finalize(void);
 
+/* Arena allocation for construction pipelines */
+
+extern bool meos_arena_start(size_t chunksize);
+extern void meos_arena_drop(void);
+extern bool meos_arena_active(void);
+
+/* Custom allocator and per-subsystem allocation statistics */
+
+/**
+ * @brief Subsystem tags of the allocation statistics, see #meos_alloc_stats
+ */
+typedef enum
+{
+  MEOS_ALLOC_GENERIC = 0,  /**< Allocations without a specific tag */
+  MEOS_ALLOC_TSEQUENCE,    /**< Temporal sequence construction */
+  MEOS_ALLOC_TSEQUENCESET, /**< Temporal sequence set construction */
+  MEOS_ALLOC_SKIPLIST,     /**< Aggregation skiplists */
+  MEOS_ALLOC_NTAGS         /**< Number of tags, must be last */
+} MeosAllocTag;
+
+/**
+ * @brief Allocation statistics of a subsystem tag, see #meos_alloc_stats
+ */
+typedef struct MeosAllocStats
+{
+  int64_t count;      /**< Number of allocations made */
+  int64_t bytes;      /**< Total number of bytes requested */
+  int64_t live;       /**< Number of bytes currently allocated */
+  int64_t highwater;  /**< Maximum value reached by live */
+} MeosAllocStats;
+
+/**
+ * @brief Allocator vtable serving the allocations of the library, see
+ * #meos_initialize_allocator
+ */
+typedef struct MeosAllocator
+{
+  void *(*malloc_fn)(size_t size);  /**< Replacement for malloc, may be NULL
+                                         to keep the C library function */
+  void *(*realloc_fn)(void *ptr, size_t size); /**< Replacement for realloc,
+                                         may be NULL */
+  void (*free_fn)(void *ptr);       /**< Replacement for free, may be NULL */
+  bool track_stats;                 /**< Maintain the per-tag allocation
+                                         statistics */
+} MeosAllocator;
+
+extern void meos_initialize_allocator(const MeosAllocator *alloc);
+extern void meos_alloc_set_tag(MeosAllocTag tag);
+extern MeosAllocStats meos_alloc_stats(MeosAllocTag tag);
+extern void meos_alloc_stats_reset(void);
+
+/* Thread pool for library-level parallelism */
+
+extern bool meos_initialize_pool(int nthreads);
+extern void meos_finalize_pool(void);
+
+/* Lock-free multi-producer ingestion stage */
+
+/**
+ * @brief Opaque structure to represent an ingestion assembling one temporal
+ * sequence per moving object from concurrently produced observations
+ */
+typedef struct MeosIngest MeosIngest;
+
+/**
+ * @brief Opaque structure to represent the handle through which one producer
+ * thread pushes observations into an ingestion
+ */
+typedef struct MeosIngestProducer MeosIngestProducer;
+
+extern MeosIngest *meos_ingest_start(int nshards, interpType interp);
+extern MeosIngestProducer *meos_ingest_producer_start(MeosIngest *ingest);
+extern bool meos_ingest_produce(MeosIngestProducer *producer, int64_t id,
+  const TInstant *inst);
+extern void meos_ingest_producer_flush(MeosIngestProducer *producer);
+extern void meos_ingest_producer_finish(MeosIngestProducer *producer);
+extern Temporal **meos_ingest_finish(MeosIngest *ingest, int64_t **ids,
+  int *count);
+
+/* Concurrent snapshot store of the latest state per moving object */
+
+/**
+ * @brief Opaque structure to represent a concurrent store keeping the latest
+ * observed instant of every moving object
+ */
+typedef struct MeosStateStore MeosStateStore;
+
+extern MeosStateStore *meos_state_store_start(int maxobjects);
+extern bool meos_state_publish(MeosStateStore *store, int64_t id,
+  const TInstant *inst);
+extern TInstant *meos_state_latest(const MeosStateStore *store, int64_t id);
+extern TInstant **meos_state_snapshot(const MeosStateStore *store,
+  int64_t **ids, int *count, uint64_t *epoch);
+extern void meos_state_store_stop(MeosStateStore *store);
+
+/* Performance counters */
+
+/**
+ * @brief Counters of the key entry points of the library, see #meos_stats
+ */
+typedef struct MeosStats
+{
+  int64_t lifting_calls;   /**< Calls to the lifted function dispatch */
+  int64_t restrict_calls;  /**< Calls to the restriction dispatch */
+  int64_t sync_calls;      /**< Sequence synchronizations */
+  int64_t wkb_in_calls;    /**< Values read from WKB */
+  int64_t wkb_in_bytes;    /**< WKB bytes read */
+  int64_t wkb_out_calls;   /**< Values written to WKB */
+  int64_t wkb_out_bytes;   /**< WKB bytes written */
+  int64_t cache_hits;      /**< Hits of the internal caches */
+  int64_t cache_misses;    /**< Misses of the internal caches */
+} MeosStats;
+
+extern void meos_reduced_precision_enable(bool enable);
+extern bool meos_reduced_precision_enabled(void);
+extern void meos_stats_enable(bool enable);
+extern bool meos_stats_enabled(void);
+extern void meos_stats_reset(void);
+extern MeosStats meos_stats(void);
+
+/* Memory budget for temporal aggregate state */
+
+extern void meos_aggregate_set_mem_limit(size_t bytes);
+
 /*****************************************************************************
  * Functions for PostgreSQL types
  *****************************************************************************/
@@ -358,6 +742,9 @@ extern TimestampTz pg_timestamp_pl_interval(TimestampTz timestamp, const Interva
 extern text *pg_timestamp_to_char(Timestamp dt, text *fmt);
 extern TimestampTz pg_timestamptz_in(const char *str, int32 typmod);
 extern char *pg_timestamptz_out(TimestampTz dt);
+extern char **pg_timestamptz_out_batch(const TimestampTz *times, int count);
+extern int pg_timestamptz_out_batch_buf(const TimestampTz *times, int count,
+  char *buf);
 extern text *pg_timestamptz_to_char(TimestampTz dt, text *fmt);
 extern DateADT pg_to_date(text *date_txt, text *fmt);
 extern TimestampTz pg_to_timestamp(text *date_txt, text *fmt);
@@ -420,6 +807,7 @@ extern char *set_as_hexwkb(const Set *s, uint8_t variant, size_t *size_out);
 extern uint8_t *set_as_wkb(const Set *s, uint8_t variant, size_t *size_out);
 extern Set *set_from_hexwkb(const char *hexwkb);
 extern Set *set_from_wkb(const uint8_t *wkb, size_t size);
+extern bool set_out_stream(const Set *s, int maxdd, size_t chunksize, size_t (*writefn)(const char *, size_t, void *), void *state);
 extern char *span_as_hexwkb(const Span *s, uint8_t variant, size_t *size_out);
 extern uint8_t *span_as_wkb(const Span *s, uint8_t variant, size_t *size_out);
 extern Span *span_from_hexwkb(const char *hexwkb);
@@ -428,6 +816,7 @@ extern char *spanset_as_hexwkb(const SpanSet *ss, uint8_t variant, size_t *size_
 extern uint8_t *spanset_as_wkb(const SpanSet *ss, uint8_t variant, size_t *size_out);
 extern SpanSet *spanset_from_hexwkb(const char *hexwkb);
 extern SpanSet *spanset_from_wkb(const uint8_t *wkb, size_t size);
+extern bool spanset_out_stream(const SpanSet *ss, int maxdd, size_t chunksize, size_t (*writefn)(const char *, size_t, void *), void *state);
 extern Set *textset_in(const char *str);
 extern char *textset_out(const Set *set);
 extern Set *timestampset_in(const char *str);
@@ -439,11 +828,13 @@ extern char *timestampset_out(const Set *set);
 
 extern Set *bigintset_make(const int64 *values, int count);
 extern Span *bigintspan_make(int64 lower, int64 upper, bool lower_inc, bool upper_inc);
+extern Span *bigintspanarr_make(const int64 *lowers, const int64 *uppers, int count);
 extern Set *floatset_make(const double *values, int count);
 extern Span *floatspan_make(double lower, double upper, bool lower_inc, bool upper_inc);
 extern Set *geoset_make(const GSERIALIZED **values, int count);
 extern Set *intset_make(const int *values, int count);
 extern Span *intspan_make(int lower, int upper, bool lower_inc, bool upper_inc);
+extern Span *intspanarr_make(const int *lowers, const int *uppers, int count);
 extern Span *period_make(TimestampTz lower, TimestampTz upper, bool lower_inc, bool upper_inc);
 extern Set *set_copy(const Set *s);
 extern Span *span_copy(const Span *s);
@@ -467,6 +858,7 @@ extern Set *int_to_intset(int i);
 extern Span *int_to_intspan(int i);
 extern SpanSet *int_to_intspanset(int i);
 extern SpanSet *set_to_spanset(const Set *s);
+extern SpanSet *set_to_spanset_free(Set *s);
 extern SpanSet *span_to_spanset(const Span *s);
 extern Set *text_to_textset(text *txt);
 extern Span *timestamp_to_period(TimestampTz t);
@@ -529,6 +921,10 @@ extern double span_width(const Span *s);
 extern Span *spanset_end_span(const SpanSet *ss);
 extern uint32 spanset_hash(const SpanSet *ps);
 extern uint64 spanset_hash_extended(const SpanSet *ps, uint64 seed);
+extern SpanIndex *spanset_index_make(const SpanSet *ss);
+extern PeriodicSpanSet *periodic_tstzspanset_make(const SpanSet *pattern, const Interval *period, int count);
+extern SpanSet *periodic_tstzspanset_expand(const PeriodicSpanSet *pss);
+extern void periodic_tstzspanset_free(PeriodicSpanSet *pss);
 extern bool spanset_lower_inc(const SpanSet *ss);
 extern int spanset_num_spans(const SpanSet *ss);
 extern Span *spanset_span(const SpanSet *ss);
@@ -595,6 +991,7 @@ extern bool intersection_period_timestamp(const Span *s, TimestampTz t, Timestam
 extern bool intersection_periodset_timestamp(const SpanSet *ss, TimestampTz t, TimestampTz *result);
 extern Set *intersection_set_set(const Set *s1, const Set *s2);
 extern Span *intersection_span_span(const Span *s1, const Span *s2);
+extern bool intersection_span_span_buf(const Span *s1, const Span *s2, Span *result);
 extern SpanSet *intersection_spanset_span(const SpanSet *ss, const Span *s);
 extern SpanSet *intersection_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2);
 extern bool intersection_textset_text(const Set *s, const text *txt, text **result);
@@ -697,6 +1094,8 @@ extern bool contains_intspan_int(const Span *s, int i);
 extern bool contains_intspanset_int(const SpanSet *ss, int i);
 extern bool contains_period_timestamp(const Span *p, TimestampTz t);
 extern bool contains_periodset_timestamp(const SpanSet *ps, TimestampTz t);
+extern bool contains_periodset_timestamp_idx(const SpanSet *ps, const SpanIndex *idx, TimestampTz t);
+extern bool periodic_tstzspanset_contains_timestamp(const PeriodicSpanSet *pss, TimestampTz t);
 extern bool contains_set_set(const Set *s1, const Set *s2);
 extern bool contains_span_span(const Span *s1, const Span *s2);
 extern bool contains_span_spanset(const Span *s, const SpanSet *ss);
@@ -708,6 +1107,7 @@ extern bool overlaps_set_set(const Set *s1, const Set *s2);
 extern bool overlaps_span_span(const Span *s1, const Span *s2);
 extern bool overlaps_spanset_span(const SpanSet *ss, const Span *s);
 extern bool overlaps_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2);
+extern bool periodic_tstzspanset_overlaps_period(const PeriodicSpanSet *pss, const Span *s);
 
 /*****************************************************************************/
 
@@ -971,7 +1371,9 @@ extern TBox *timestamp_to_tbox(TimestampTz t);
 extern STBox *timestampset_to_stbox(const Set *ts);
 extern TBox *timestampset_to_tbox(const Set *ss);
 extern TBox *tnumber_to_tbox(const Temporal *temp);
+extern bool tnumber_to_tbox_buf(const Temporal *temp, TBox *result);
 extern STBox *tpoint_to_stbox(const Temporal *temp);
+extern bool tpoint_to_stbox_buf(const Temporal *temp, STBox *result);
 
 /*****************************************************************************/
 
@@ -1025,11 +1427,15 @@ extern TBox *tbox_shift_scale_time(const TBox *box, const Interval *shift, const
 /* Set functions for box types */
 
 extern TBox *union_tbox_tbox(const TBox *box1, const TBox *box2, bool strict);
+extern bool union_tbox_tbox_buf(const TBox *box1, const TBox *box2, bool strict, TBox *result);
 extern bool inter_tbox_tbox(const TBox *box1, const TBox *box2, TBox *result);
 extern TBox *intersection_tbox_tbox(const TBox *box1, const TBox *box2);
+extern bool intersection_tbox_tbox_buf(const TBox *box1, const TBox *box2, TBox *result);
 extern STBox *union_stbox_stbox(const STBox *box1, const STBox *box2, bool strict);
+extern bool union_stbox_stbox_buf(const STBox *box1, const STBox *box2, bool strict, STBox *result);
 extern bool inter_stbox_stbox(const STBox *box1, const STBox *box2, STBox *result);
 extern STBox *intersection_stbox_stbox(const STBox *box1, const STBox *box2);
+extern bool intersection_stbox_stbox_buf(const STBox *box1, const STBox *box2, STBox *result);
 
 /*****************************************************************************
  * Bounding box functions for box types
@@ -1108,14 +1514,49 @@ extern bool stbox_gt(const STBox *box1, const STBox *box2);
 
 /* Input/output functions for temporal types */
 
+/**
+ * WKB variant requesting the compressed output of the instant arrays of
+ * temporal floats and temporal points, where the timestamps are stored as
+ * delta-of-delta varints and the values as XORs with the previous value.
+ * The value aliases a liblwgeom variant that is used internally for
+ * geometry output only and is thus never set for temporal values.
+ */
+#define WKB_COMPRESSED 0x40
+
 extern Temporal *tbool_in(const char *str);
 extern char *tbool_out(const Temporal *temp);
 extern char *temporal_as_hexwkb(const Temporal *temp, uint8_t variant, size_t *size_out);
 extern char *temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags, int precision, char *srs);
+extern bool temporal_as_mfjson_stream(const Temporal *temp, bool with_bbox, int precision, char *srs, size_t chunksize, size_t (*writefn)(const char *, size_t, void *), void *state);
+extern bool temporal_as_mfjson_file(const Temporal *temp, bool with_bbox, int precision, char *srs, size_t chunksize, FILE *file);
 extern uint8_t *temporal_as_wkb(const Temporal *temp, uint8_t variant, size_t *size_out);
+extern size_t temporalarr_as_wkb_buf(const Temporal **temparr, int count, uint8_t variant, uint8_t *buf, size_t buf_size, size_t *sizes);
 extern Temporal *temporal_from_hexwkb(const char *hexwkb);
 extern Temporal *temporal_from_mfjson(const char *mfjson);
 extern Temporal *temporal_from_wkb(const uint8_t *wkb, size_t size);
+extern Temporal *temporal_from_wkb_period(const uint8_t *wkb, size_t size, const Span *p);
+extern Temporal *temporal_from_wkb_trusted(const uint8_t *wkb, size_t size);
+extern bool temporal_wkb_valid(const uint8_t *wkb, size_t size);
+extern bool temporal_as_arrow(const Temporal *temp, struct ArrowSchema *schema, struct ArrowArray *array);
+extern Temporal *tint_from_arrow(const struct ArrowSchema *schema, const struct ArrowArray *array);
+extern Temporal *tfloat_from_arrow(const struct ArrowSchema *schema, const struct ArrowArray *array);
+extern Temporal *tgeompoint_from_arrow(const struct ArrowSchema *schema, const struct ArrowArray *array);
+extern TemporalStream *temporal_stream_make(void);
+extern void temporal_stream_feed(TemporalStream *stream, const char *chunk, size_t size);
+extern Temporal *temporal_stream_finish(TemporalStream *stream, Temporal *(*infunc)(const char *));
+extern void temporal_stream_free(TemporalStream *stream);
+extern TemporalReader *temporal_reader_open(const char *path, TemporalLineParseFn parse, void *context, int batchsize);
+extern int temporal_reader_next(TemporalReader *reader, Temporal ***temparr);
+extern void temporal_reader_close(TemporalReader *reader);
+extern CsvReader *csv_reader_open(const char *path, const char *schema, char delim, bool header);
+extern int csv_reader_next(CsvReader *reader, int maxrows, void **columns);
+extern int64 csv_reader_skipped(const CsvReader *reader);
+extern void csv_reader_close(CsvReader *reader);
+extern bool temporal_store_write(const char *path, const Temporal **temparr, int count);
+extern TemporalStore *temporal_store_open(const char *path);
+extern int temporal_store_count(const TemporalStore *store);
+extern const Temporal *temporal_store_read(const TemporalStore *store, int index);
+extern void temporal_store_close(TemporalStore *store);
 extern Temporal *tfloat_in(const char *str);
 extern char *tfloat_out(const Temporal *temp, int maxdd);
 extern Temporal *tgeogpoint_in(const char *str);
@@ -1136,17 +1577,20 @@ extern Temporal *tbool_from_base_temp(bool b, const Temporal *temp);
 extern TInstant *tboolinst_make(bool b, TimestampTz t);
 extern TSequence *tboolseq_from_base_period(bool b, const Span *p);
 extern TSequence *tboolseq_from_base_timestampset(bool b, const Set *ts);
+extern TSequence *tboolseq_make_from_arrays(const bool *values, const TimestampTz *times, int count, bool lower_inc, bool upper_inc);
 extern TSequenceSet *tboolseqset_from_base_periodset(bool b, const SpanSet *ps);
 extern Temporal *temporal_copy(const Temporal *temp);
 extern Temporal *tfloat_from_base_temp(double d, const Temporal *temp);
 extern TInstant *tfloatinst_make(double d, TimestampTz t);
 extern TSequence *tfloatseq_from_base_period(double d, const Span *p, interpType interp);
 extern TSequence *tfloatseq_from_base_timestampset(double d, const Set *ts);
+extern TSequence *tfloatseq_make_from_arrays(const double *values, const TimestampTz *times, int count, bool lower_inc, bool upper_inc, interpType interp);
 extern TSequenceSet *tfloatseqset_from_base_periodset(double d, const SpanSet *ps, interpType interp);
 extern Temporal *tint_from_base_temp(int i, const Temporal *temp);
 extern TInstant *tintinst_make(int i, TimestampTz t);
 extern TSequence *tintseq_from_base_period(int i, const Span *p);
 extern TSequence *tintseq_from_base_timestampset(int i, const Set *ts);
+extern TSequence *tintseq_make_from_arrays(const int *values, const TimestampTz *times, int count, bool lower_inc, bool upper_inc);
 extern TSequenceSet *tintseqset_from_base_periodset(int i, const SpanSet *ps);
 extern Temporal *tpoint_from_base_temp(const GSERIALIZED *gs, const Temporal *temp);
 extern TInstant *tpointinst_make(const GSERIALIZED *gs, TimestampTz t);
@@ -1167,9 +1611,11 @@ extern TSequenceSet *ttextseqset_from_base_periodset(const text *txt, const Span
 /* Conversion functions for temporal types */
 
 extern Span *temporal_to_period(const Temporal *temp);
+extern bool temporal_to_period_buf(const Temporal *temp, Span *result);
 extern Temporal *tfloat_to_tint(const Temporal *temp);
 extern Temporal *tint_to_tfloat(const Temporal *temp);
 extern Span *tnumber_to_span(const Temporal *temp);
+extern bool tnumber_to_span_buf(const Temporal *temp, Span *result);
 
 /*****************************************************************************/
 
@@ -1181,8 +1627,11 @@ extern bool *tbool_values(const Temporal *temp, int *count);
 extern Interval *temporal_duration(const Temporal *temp, bool boundspan);
 extern const TInstant *temporal_end_instant(const Temporal *temp);
 extern TSequence *temporal_end_sequence(const Temporal *temp);
+extern const TSequence *temporal_end_sequence_ptr(const Temporal *temp);
 extern TimestampTz temporal_end_timestamp(const Temporal *temp);
 extern uint32 temporal_hash(const Temporal *temp);
+extern uint64 temporal_hash_extended(const Temporal *temp, uint64 seed);
+extern const TInstant *temporal_inst_at_timestamp(const Temporal *temp, TimestampTz t);
 extern const TInstant *temporal_instant_n(const Temporal *temp, int n);
 extern const TInstant **temporal_instants(const Temporal *temp, int *count);
 extern char *temporal_interp(const Temporal *temp);
@@ -1193,11 +1642,14 @@ extern int temporal_num_sequences(const Temporal *temp);
 extern int temporal_num_timestamps(const Temporal *temp);
 extern TSequence **temporal_segments(const Temporal *temp, int *count);
 extern TSequence *temporal_sequence_n(const Temporal *temp, int i);
+extern const TSequence *temporal_sequence_n_ptr(const Temporal *temp, int i);
 extern TSequence **temporal_sequences(const Temporal *temp, int *count);
 extern const TInstant *temporal_start_instant(const Temporal *temp);
 extern TSequence *temporal_start_sequence(const Temporal *temp);
+extern const TSequence *temporal_start_sequence_ptr(const Temporal *temp);
 extern TimestampTz temporal_start_timestamp(const Temporal *temp);
 extern TSequenceSet *temporal_stops(const Temporal *temp, double maxdist, const Interval *minduration);
+extern Temporal *temporal_moves(const Temporal *temp, double maxdist, const Interval *minduration);
 extern char *temporal_subtype(const Temporal *temp);
 extern SpanSet *temporal_time(const Temporal *temp);
 extern bool temporal_timestamp_n(const Temporal *temp, int n, TimestampTz *result);
@@ -1244,14 +1696,17 @@ extern Temporal *tint_shift_value(const Temporal *temp, int shift);
 
 /* Modification functions for temporal types */
 
-extern Temporal *temporal_append_tinstant(Temporal *temp, const TInstant *inst, double maxdist, Interval *maxt, bool expand);
+extern Temporal *temporal_append_tinstant(Temporal *temp, const TInstant *inst, double maxdist, Interval *maxt, double tolerance, bool expand);
 extern Temporal *temporal_append_tsequence(Temporal *temp, const TSequence *seq, bool expand);
+extern Temporal *temporal_delta_merge(const Temporal *base, const Temporal *delta);
+extern uint16 temporal_generation(const Temporal *temp);
 extern Temporal *temporal_delete_period(const Temporal *temp, const Span *p, bool connect);
 extern Temporal *temporal_delete_periodset(const Temporal *temp, const SpanSet *ps, bool connect);
 extern Temporal *temporal_delete_timestamp(const Temporal *temp, TimestampTz t, bool connect);
 extern Temporal *temporal_delete_timestampset(const Temporal *temp, const Set *ts, bool connect);
 extern Temporal *temporal_insert(const Temporal *temp1, const Temporal *temp2, bool connect);
 extern Temporal *temporal_merge(const Temporal *temp1, const Temporal *temp2);
+extern Temporal *temporal_merge_free(Temporal *temp1, Temporal *temp2);
 extern Temporal *temporal_merge_array(Temporal **temparr, int count);
 extern Temporal *temporal_update(const Temporal *temp1, const Temporal *temp2, bool connect);
 
@@ -1259,9 +1714,18 @@ extern Temporal *temporal_update(const Temporal *temp1, const Temporal *temp2, b
 
 /* Restriction functions for temporal types */
 
+extern Restriction *restriction_make(void);
+extern bool restriction_add_period(Restriction *rest, const Span *s);
+extern bool restriction_add_span(Restriction *rest, const Span *s);
+extern bool restriction_add_tbox(Restriction *rest, const TBox *box);
+extern bool restriction_add_stbox(Restriction *rest, const STBox *box);
+extern bool restriction_add_minus_values(Restriction *rest, const Set *s);
+extern void restriction_free(Restriction *rest);
 extern Temporal *tbool_at_value(const Temporal *temp, bool b);
 extern Temporal *tbool_minus_value(const Temporal *temp, bool b);
+extern bool tbool_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t, bool strict, bool *value);
 extern bool tbool_value_at_timestamp(const Temporal *temp, TimestampTz t, bool strict, bool *value);
+extern bool temporal_cursor_init(TemporalCursor *cursor, const Temporal *temp);
 extern Temporal *temporal_at_max(const Temporal *temp);
 extern Temporal *temporal_at_min(const Temporal *temp);
 extern Temporal *temporal_at_period(const Temporal *temp, const Span *p);
@@ -1276,11 +1740,14 @@ extern Temporal *temporal_minus_periodset(const Temporal *temp, const SpanSet *p
 extern Temporal *temporal_minus_timestamp(const Temporal *temp, TimestampTz t);
 extern Temporal *temporal_minus_timestampset(const Temporal *temp, const Set *ts);
 extern Temporal *temporal_minus_values(const Temporal *temp, const Set *set);
+extern Temporal *temporal_restrict_fused(const Temporal *temp, const Restriction *rest);
 extern Temporal *tfloat_at_value(const Temporal *temp, double d);
 extern Temporal *tfloat_minus_value(const Temporal *temp, double d);
+extern bool tfloat_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t, bool strict, double *value);
 extern bool tfloat_value_at_timestamp(const Temporal *temp, TimestampTz t, bool strict, double *value);
 extern Temporal *tint_at_value(const Temporal *temp, int i);
 extern Temporal *tint_minus_value(const Temporal *temp, int i);
+extern bool tint_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t, bool strict, int *value);
 extern bool tint_value_at_timestamp(const Temporal *temp, TimestampTz t, bool strict, int *value);
 extern Temporal *tnumber_at_span(const Temporal *temp, const Span *span);
 extern Temporal *tnumber_at_spanset(const Temporal *temp, const SpanSet *ss);
@@ -1290,13 +1757,16 @@ extern Temporal *tnumber_minus_spanset(const Temporal *temp, const SpanSet *ss);
 extern Temporal *tnumber_minus_tbox(const Temporal *temp, const TBox *box);
 extern Temporal *tpoint_at_geom_time(const Temporal *temp, const GSERIALIZED *gs, const Span *zspan, const Span *period);
 extern Temporal *tpoint_at_stbox(const Temporal *temp, const STBox *box, bool border_inc);
+extern Temporal **tpointarr_at_stbox(const Temporal **temparr, int count, const STBox *box, bool border_inc);
 extern Temporal *tpoint_at_value(const Temporal *temp, GSERIALIZED *gs);
 extern Temporal *tpoint_minus_geom_time(const Temporal *temp, const GSERIALIZED *gs, const Span *zspan, const Span *period);
 extern Temporal *tpoint_minus_stbox(const Temporal *temp, const STBox *box, bool border_inc);
 extern Temporal *tpoint_minus_value(const Temporal *temp, GSERIALIZED *gs);
+extern bool tpoint_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t, bool strict, GSERIALIZED **value);
 extern bool tpoint_value_at_timestamp(const Temporal *temp, TimestampTz t, bool strict, GSERIALIZED **value);
 extern Temporal *ttext_at_value(const Temporal *temp, text *txt);
 extern Temporal *ttext_minus_value(const Temporal *temp, text *txt);
+extern bool ttext_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t, bool strict, text **value);
 extern bool ttext_value_at_timestamp(const Temporal *temp, TimestampTz t, bool strict, text **value);
 
 /*****************************************************************************
@@ -1399,6 +1869,10 @@ extern Temporal *tne_ttext_text(const Temporal *temp, const text *txt);
 
 /* Boolean functions for temporal types */
 
+extern int aand_tbool_tbool(const Temporal *temp1, const Temporal *temp2);
+extern int aor_tbool_tbool(const Temporal *temp1, const Temporal *temp2);
+extern int eand_tbool_tbool(const Temporal *temp1, const Temporal *temp2);
+extern int eor_tbool_tbool(const Temporal *temp1, const Temporal *temp2);
 extern Temporal *tand_bool_tbool(bool b, const Temporal *temp);
 extern Temporal *tand_tbool_bool(const Temporal *temp, bool b);
 extern Temporal *tand_tbool_tbool(const Temporal *temp1, const Temporal *temp2);
@@ -1496,8 +1970,15 @@ extern Temporal *tpoint_get_y(const Temporal *temp);
 extern Temporal *tpoint_get_z(const Temporal *temp);
 extern bool tpoint_is_simple(const Temporal *temp);
 extern double tpoint_length(const Temporal *temp);
+extern TPointLengthIndex *tpointseq_length_index_make(const TSequence *seq);
+extern double tpointseq_length_index_length(const TPointLengthIndex *idx);
+extern bool tpointseq_length_index_timestamp_at_length(const TPointLengthIndex *idx, double length, TimestampTz *t);
+extern GSERIALIZED *tpointseq_length_index_value_at_length(const TPointLengthIndex *idx, double length);
+extern void tpointseq_length_index_free(TPointLengthIndex *idx);
 extern Temporal *tpoint_speed(const Temporal *temp);
+extern void meos_derived_channel_cache_clear(void);
 extern int tpoint_srid(const Temporal *temp);
+extern STBox *tpoint_moving_extent(const Temporal *temp, const Interval *duration, int *count);
 extern STBox *tpoint_stboxes(const Temporal *temp, int *count);
 extern GSERIALIZED *tpoint_trajectory(const Temporal *temp);
 
@@ -1510,11 +1991,13 @@ Temporal *geo_to_tpoint(const GSERIALIZED *gs);
 extern Temporal *tgeogpoint_to_tgeompoint(const Temporal *temp);
 extern Temporal *tgeompoint_to_tgeogpoint(const Temporal *temp);
 bool tpoint_AsMVTGeom(const Temporal *temp, const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom, GSERIALIZED **gsarr, int64 **timesarr, int *count);
+extern uint8_t *tpoint_as_mvt(const Temporal *temp, const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom, const char *name, size_t *size);
 extern STBox *tpoint_expand_space(const Temporal *temp, double d);
 extern Temporal **tpoint_make_simple(const Temporal *temp, int *count);
 extern Temporal *tpoint_round(const Temporal *temp, int maxdd);
 extern Temporal **tpointarr_round(const Temporal **temp, int count, int maxdd);
 extern Temporal *tpoint_set_srid(const Temporal *temp, int32 srid);
+extern Temporal *tpoint_transform(const Temporal *temp, int32 srid);
 bool tpoint_to_geo_meas(const Temporal *tpoint, const Temporal *measure, bool segmentize, GSERIALIZED **result);
 
 /*****************************************************************************/
@@ -1529,6 +2012,7 @@ extern int edwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2,
 extern int eintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
 extern int eintersects_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
 extern int etouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
+extern Match *tpointarr_dwithin_join(const Temporal **temparr1, int count1, const Temporal **temparr2, int count2, double dist, double xsize, double ysize, const Interval *duration, int *count);
 
 /*****************************************************************************/
 
@@ -1548,23 +2032,45 @@ extern Temporal *ttouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs
 extern SkipList *tbool_tand_transfn(SkipList *state, const Temporal *temp);
 extern SkipList *tbool_tor_transfn(SkipList *state, const Temporal *temp);
 extern Span *temporal_extent_transfn(Span *p, const Temporal *temp);
+extern Temporal **temporal_tagg_bucket_finalfn(BucketAggState *state, TimestampTz **buckets, int *count);
 extern Temporal *temporal_tagg_finalfn(SkipList *state);
+extern Temporal *temporal_tagg_readfn(SkipList *state);
 extern SkipList *temporal_tcount_transfn(SkipList *state, const Temporal *temp);
+extern SkipList *tfloat_tmax_array_transfn(SkipList *state, const Temporal **temparr, int count);
+extern BucketAggState *tfloat_tmax_bucket_transfn(BucketAggState *state, const Temporal *temp, const Interval *duration, TimestampTz torigin);
 extern SkipList *tfloat_tmax_transfn(SkipList *state, const Temporal *temp);
+extern SkipList *tfloat_tmin_array_transfn(SkipList *state, const Temporal **temparr, int count);
+extern BucketAggState *tfloat_tmin_bucket_transfn(BucketAggState *state, const Temporal *temp, const Interval *duration, TimestampTz torigin);
 extern SkipList *tfloat_tmin_transfn(SkipList *state, const Temporal *temp);
+extern SkipList *tfloat_tsum_array_transfn(SkipList *state, const Temporal **temparr, int count);
+extern BucketAggState *tfloat_tsum_bucket_transfn(BucketAggState *state, const Temporal *temp, const Interval *duration, TimestampTz torigin);
 extern SkipList *tfloat_tsum_transfn(SkipList *state, const Temporal *temp);
+extern SkipList *tint_tmax_array_transfn(SkipList *state, const Temporal **temparr, int count);
+extern BucketAggState *tint_tmax_bucket_transfn(BucketAggState *state, const Temporal *temp, const Interval *duration, TimestampTz torigin);
 extern SkipList *tint_tmax_transfn(SkipList *state, const Temporal *temp);
+extern SkipList *tint_tmin_array_transfn(SkipList *state, const Temporal **temparr, int count);
+extern BucketAggState *tint_tmin_bucket_transfn(BucketAggState *state, const Temporal *temp, const Interval *duration, TimestampTz torigin);
 extern SkipList *tint_tmin_transfn(SkipList *state, const Temporal *temp);
+extern SkipList *tint_tsum_array_transfn(SkipList *state, const Temporal **temparr, int count);
+extern BucketAggState *tint_tsum_bucket_transfn(BucketAggState *state, const Temporal *temp, const Interval *duration, TimestampTz torigin);
 extern SkipList *tint_tsum_transfn(SkipList *state, const Temporal *temp);
 extern TBox *tnumber_extent_transfn(TBox *box, const Temporal *temp);
 extern double tnumber_integral(const Temporal *temp);
+extern SkipList *tnumber_tavg_array_transfn(SkipList *state, const Temporal **temparr, int count);
+extern Temporal **tnumber_tavg_bucket_finalfn(BucketAggState *state, TimestampTz **buckets, int *count);
+extern BucketAggState *tnumber_tavg_bucket_transfn(BucketAggState *state, const Temporal *temp, const Interval *duration, TimestampTz torigin);
 extern Temporal *tnumber_tavg_finalfn(SkipList *state);
+extern Temporal *tnumber_tavg_readfn(SkipList *state);
 extern SkipList *tnumber_tavg_transfn(SkipList *state, const Temporal *temp);
 extern double tnumber_twavg(const Temporal *temp);
+extern double tnumber_twavg_approx(const Temporal *temp, double fraction, double *error);
+extern bool tnumber_summary(const Temporal *temp, int mask, TNumberSummary *summary);
 extern STBox *tpoint_extent_transfn(STBox *box, const Temporal *temp);
 extern Temporal *tpoint_tcentroid_finalfn(SkipList *state);
+extern Temporal *tpoint_tcentroid_readfn(SkipList *state);
 extern SkipList *tpoint_tcentroid_transfn(SkipList *state, Temporal *temp);
 extern GSERIALIZED *tpoint_twcentroid(const Temporal *temp);
+extern GSERIALIZED *tpoint_twcentroid_approx(const Temporal *temp, double fraction, double *error);
 extern SkipList *ttext_tmax_transfn(SkipList *state, const Temporal *temp);
 extern SkipList *ttext_tmin_transfn(SkipList *state, const Temporal *temp);
 
@@ -1576,14 +2082,29 @@ extern SkipList *ttext_tmin_transfn(SkipList *state, const Temporal *temp);
 
 Temporal *temporal_simplify_min_dist(const Temporal *temp, double dist);
 Temporal *temporal_simplify_min_tdelta(const Temporal *temp, const Interval *mint);
+Temporal *temporal_simplify_count(const Temporal *temp, int count, bool synchronized);
 Temporal *temporal_simplify_dp(const Temporal *temp, double eps_dist, bool synchronized);
 Temporal *temporal_simplify_max_dist(const Temporal *temp, double eps_dist, bool synchronized);
 
+SimplifyStream *simplify_stream_make(double eps_dist, bool synchronized, int maxcount);
+bool simplify_stream_add(SimplifyStream *stream, const TInstant *inst);
+TSequence *simplify_stream_sequence(const SimplifyStream *stream);
+void simplify_stream_free(SimplifyStream *stream);
+
+TemporalPyramid *temporal_pyramid_make(const Temporal *temp, double eps_dist, double factor, int maxlevels, bool synchronized);
+const Temporal *temporal_pyramid_at_dist(const TemporalPyramid *pyramid, double eps_dist);
+uint8_t **temporal_pyramid_as_layers_wkb(const TemporalPyramid *pyramid, uint8_t variant, int *count, size_t **sizes);
+const Temporal *temporal_pyramid_level(const TemporalPyramid *pyramid, int level);
+int temporal_pyramid_num_levels(const TemporalPyramid *pyramid);
+void temporal_pyramid_free(TemporalPyramid *pyramid);
+
 /*****************************************************************************/
 
 /* Reduction functions for temporal types */
 
 extern Temporal *temporal_tprecision(const Temporal *temp, const Interval *duration, TimestampTz origin);
+extern Temporal *temporal_tresample(const Temporal *temp, const Interval *duration, TimestampTz origin, reductionType reduction);
+extern Temporal **temporalarr_tresample(const Temporal **temparr, int count, const Interval *duration, TimestampTz origin, reductionType reduction);
 extern Temporal *temporal_tsample(const Temporal *temp, const Interval *duration, TimestampTz origin);
 
 /*****************************************************************************/
@@ -1591,10 +2112,16 @@ extern Temporal *temporal_tsample(const Temporal *temp, const Interval *duration
 /* Similarity functions for temporal types */
 
 extern double temporal_dyntimewarp_distance(const Temporal *temp1, const Temporal *temp2);
+extern double temporal_dyntimewarp_distance_banded(const Temporal *temp1, const Temporal *temp2, int radius);
+extern double *temporal_dyntimewarp_distance_matrix(const Temporal **temparr, int count);
 extern Match *temporal_dyntimewarp_path(const Temporal *temp1, const Temporal *temp2, int *count);
 extern double temporal_frechet_distance(const Temporal *temp1, const Temporal *temp2);
+extern double *temporal_frechet_distance_matrix(const Temporal **temparr, int count);
 extern Match *temporal_frechet_path(const Temporal *temp1, const Temporal *temp2, int *count);
 extern double temporal_hausdorff_distance(const Temporal *temp1, const Temporal *temp2);
+extern bool temporal_hausdorff_distance_within(const Temporal *temp1, const Temporal *temp2, double dist);
+extern TSynopsis *temporal_synopsis(const Temporal *temp, int count);
+extern double synopsis_lower_bound_distance(const TSynopsis *syn1, const TSynopsis *syn2, int radius);
 
 /*****************************************************************************/
 
@@ -1616,6 +2143,8 @@ extern Temporal **tint_value_split(Temporal *temp, int size, int origin, int **v
 extern Temporal **tint_value_time_split(Temporal *temp, int size, Interval *duration, int vorigin, TimestampTz torigin, int **value_buckets, TimestampTz **time_buckets, int *count);
 extern Temporal **tpoint_space_split(Temporal *temp, float xsize, float ysize, float zsize, GSERIALIZED *sorigin, bool bitmatrix, GSERIALIZED ***space_buckets, int *count);
 extern Temporal **tpoint_space_time_split(Temporal *temp, float xsize, float ysize, float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, bool bitmatrix, GSERIALIZED ***space_buckets, TimestampTz **time_buckets, int *count);
+extern Temporal **tpoint_space_time_split_pyramid(Temporal *temp, float xsize, float ysize, float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, bool bitmatrix, int levels, GSERIALIZED ***space_buckets, TimestampTz **time_buckets, int **level_counts, int *count);
+extern STBox *tpoint_space_time_topk(Temporal *temp, float xsize, float ysize, float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, int k, uint64 **tile_counts, int *count);
 
 
 /*****************************************************************************/
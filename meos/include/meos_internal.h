@@ -130,6 +130,23 @@
 #define MEOS_FLAG_Z          0x0020  // 32
 #define MEOS_FLAG_T          0x0040  // 64
 #define MEOS_FLAG_GEODETIC   0x0080  // 128
+#define MEOS_FLAG_PERIODS    0x0100  // 256
+/* The following flag is only used for TSequence */
+#define MEOS_FLAG_MONOTONE   0x0200  // 512
+/* The following flag is only used for TSequenceSet */
+#define MEOS_FLAG_DISTINCT   0x0400  // 1024
+/* The following flag is only used for TSequence */
+#define MEOS_FLAG_TIMES      0x0800  // 2048
+
+/* The following flags record how a value was constructed or modified in
+ * place, e.g., whether it carries a skip index or a periods summary, and
+ * not what it contains: in-place operations clear them without recomputing
+ * the associated structures. They MUST be masked out when the flags of two
+ * values are compared, otherwise content-equal values built through
+ * different histories compare unequal */
+#define MEOS_FLAGS_REPRESENTATION \
+  (MEOS_FLAG_PERIODS | MEOS_FLAG_MONOTONE | MEOS_FLAG_DISTINCT | \
+   MEOS_FLAG_TIMES)
 
 #define MEOS_FLAGS_GET_BYVAL(flags)      ((bool) (((flags) & MEOS_FLAG_BYVAL)))
 #define MEOS_FLAGS_GET_ORDERED(flags)    ((bool) (((flags) & MEOS_FLAG_ORDERED)>>1))
@@ -138,6 +155,10 @@
 #define MEOS_FLAGS_GET_Z(flags)          ((bool) (((flags) & MEOS_FLAG_Z)>>5))
 #define MEOS_FLAGS_GET_T(flags)          ((bool) (((flags) & MEOS_FLAG_T)>>6))
 #define MEOS_FLAGS_GET_GEODETIC(flags)   ((bool) (((flags) & MEOS_FLAG_GEODETIC)>>7))
+#define MEOS_FLAGS_GET_PERIODS(flags)    ((bool) (((flags) & MEOS_FLAG_PERIODS)>>8))
+#define MEOS_FLAGS_GET_MONOTONE(flags)   ((bool) (((flags) & MEOS_FLAG_MONOTONE)>>9))
+#define MEOS_FLAGS_GET_DISTINCT(flags)   ((bool) (((flags) & MEOS_FLAG_DISTINCT)>>10))
+#define MEOS_FLAGS_GET_TIMES(flags)      ((bool) (((flags) & MEOS_FLAG_TIMES)>>11))
 
 #define MEOS_FLAGS_SET_BYVAL(flags, value) \
   ((flags) = (value) ? ((flags) | MEOS_FLAG_BYVAL) : ((flags) & ~MEOS_FLAG_BYVAL))
@@ -153,6 +174,14 @@
   ((flags) = (value) ? ((flags) | MEOS_FLAG_T) : ((flags) & ~MEOS_FLAG_T))
 #define MEOS_FLAGS_SET_GEODETIC(flags, value) \
   ((flags) = (value) ? ((flags) | MEOS_FLAG_GEODETIC) : ((flags) & ~MEOS_FLAG_GEODETIC))
+#define MEOS_FLAGS_SET_PERIODS(flags, value) \
+  ((flags) = (value) ? ((flags) | MEOS_FLAG_PERIODS) : ((flags) & ~MEOS_FLAG_PERIODS))
+#define MEOS_FLAGS_SET_MONOTONE(flags, value) \
+  ((flags) = (value) ? ((flags) | MEOS_FLAG_MONOTONE) : ((flags) & ~MEOS_FLAG_MONOTONE))
+#define MEOS_FLAGS_SET_DISTINCT(flags, value) \
+  ((flags) = (value) ? ((flags) | MEOS_FLAG_DISTINCT) : ((flags) & ~MEOS_FLAG_DISTINCT))
+#define MEOS_FLAGS_SET_TIMES(flags, value) \
+  ((flags) = (value) ? ((flags) | MEOS_FLAG_TIMES) : ((flags) & ~MEOS_FLAG_TIMES))
 
 #define MEOS_FLAGS_GET_INTERP(flags) (((flags) & MEOS_FLAGS_INTERP) >> 2)
 #define MEOS_FLAGS_SET_INTERP(flags, value) ((flags) = (((flags) & ~MEOS_FLAGS_INTERP) | ((value & 0x0003) << 2)))
@@ -172,6 +201,16 @@
 #define DatumGetTimestampTz(X)((TimestampTz) DatumGetInt64(X))
 #endif /* MEOS */
 
+/**
+ * @brief Tag the subsequent allocations of the calling thread for the
+ * allocation statistics, a no-op when the library is run inside PostgreSQL
+ */
+#if MEOS
+  #define MEOS_ALLOC_TAG(tag) meos_alloc_set_tag(tag)
+#else
+  #define MEOS_ALLOC_TAG(tag) ((void) 0)
+#endif /* MEOS */
+
 /*****************************************************************************
  * Functions for set and span types
  *****************************************************************************/
@@ -232,6 +271,7 @@ extern Set *set_compact(const Set *s);
 extern Set *set_make(const Datum *values, int count, meosType basetype, bool ordered);
 extern Set *set_make_exp(const Datum *values, int count, int maxcount, meosType basetype, bool ordered);
 extern Set *set_make_free(Datum *values, int count, meosType basetype, bool ordered);
+extern Set *set_make_trusted(const Datum *values, int count, meosType basetype, validateLevel validate);
 extern char *set_out(const Set *s, int maxdd);
 extern Span *span_make(Datum lower, Datum upper, bool lower_inc, bool upper_inc, meosType basetype);
 extern char *span_out(const Span *s, int maxdd);
@@ -408,6 +448,7 @@ extern void periodset_set_stbox(const SpanSet *ps, STBox *box);
 extern void periodset_set_tbox(const SpanSet *ps, TBox *box);
 extern void stbox_set_box3d(const STBox *box, BOX3D *box3d);
 extern void stbox_set_gbox(const STBox *box, GBOX *gbox);
+extern void stbox_set_geocentric(const STBox *box, STBox *result);
 extern void timestamp_set_stbox(TimestampTz t, STBox *box);
 extern void timestamp_set_tbox(TimestampTz t, TBox *box);
 extern void timestampset_set_stbox(const Set *ts, STBox *box);
@@ -435,9 +476,19 @@ extern bool inter_tbox_tbox(const TBox *box1, const TBox *box2, TBox *result);
 
 /* Macros for speeding up access to components of temporal sequences (sets)*/
 
+/* A skip index storing the timestamp of every MEOS_SKIP_INDEX_STEP-th instant
+ * is appended to non-expandable sequences with at least
+ * MEOS_SKIP_INDEX_MINCOUNT instants */
+#define MEOS_SKIP_INDEX_STEP 32
+#define MEOS_SKIP_INDEX_MINCOUNT 128
+#define MEOS_SKIP_INDEX_COUNT(count) \
+  (((count) + MEOS_SKIP_INDEX_STEP - 1) / MEOS_SKIP_INDEX_STEP)
+
 #ifdef DEBUG_BUILD
 extern const TInstant *TSEQUENCE_INST_N(const TSequence *seq, int index);
+extern const TimestampTz *TSEQUENCE_TIMES_PTR(const TSequence *seq);
 extern const TSequence *TSEQUENCESET_SEQ_N(const TSequenceSet *ss, int index);
+extern const Span *TSEQUENCESET_PERIODS_PTR(const TSequenceSet *ss);
 #else
 /**
  * @brief Return a pointer to the offsets array of a temporal sequence
@@ -456,6 +507,15 @@ extern const TSequence *TSEQUENCESET_SEQ_N(const TSequenceSet *ss, int index);
   ((char *) &((seq)->period)) + (seq)->bboxsize + \
   (sizeof(size_t) * (seq)->maxcount) + (TSEQUENCE_OFFSETS_PTR(seq))[index] ) )
 
+/**
+ * @brief Return a pointer to the skip index of instant timestamps stored at
+ * the end of a temporal sequence
+ * @pre The times flag of the sequence is set
+ */
+#define TSEQUENCE_TIMES_PTR(seq) ( (const TimestampTz *)( \
+  ((char *) (seq)) + VARSIZE(seq) - \
+  (sizeof(TimestampTz) * MEOS_SKIP_INDEX_COUNT((seq)->count)) ) )
+
 /**
  * @brief Return a pointer to the offsets array of a temporal sequence set
  * @note The period component of the bbox is already declared in the struct
@@ -472,6 +532,14 @@ extern const TSequence *TSEQUENCESET_SEQ_N(const TSequenceSet *ss, int index);
 #define TSEQUENCESET_SEQ_N(ss, index) ( (const TSequence *)( \
   ((char *) &((ss)->period)) + (ss)->bboxsize + \
   (sizeof(size_t) * (ss)->maxcount) + (TSEQUENCESET_OFFSETS_PTR(ss))[index] ) )
+
+/**
+ * @brief Return a pointer to the packed summary array of sequence periods
+ * stored at the end of a temporal sequence set
+ * @pre The periods flag of the sequence set is set
+ */
+#define TSEQUENCESET_PERIODS_PTR(ss) ( (const Span *)( \
+  ((char *) (ss)) + VARSIZE(ss) - (sizeof(Span) * (ss)->count) ) )
 #endif /* DEBUG_BUILD */
 
 /*****************************************************************************/
@@ -558,6 +626,8 @@ extern TInstant *tinstant_make(Datum value, meosType temptype, TimestampTz t);
 extern TSequence *tpointseq_make_coords(const double *xcoords, const double *ycoords, const double *zcoords, const TimestampTz *times, int count, int32 srid, bool geodetic, bool lower_inc, bool upper_inc, interpType interp, bool normalize);
 extern TSequence *tsequence_from_base_timestampset(Datum value, meosType temptype, const Set *ss);
 extern TSequence *tsequence_make_exp(const TInstant **instants, int count, int maxcount, bool lower_inc, bool upper_inc, interpType interp, bool normalize);
+extern TSequence *tsequence_make_from_arrays(const Datum *values, meosType temptype, const TimestampTz *times, int count, bool lower_inc, bool upper_inc, interpType interp);
+extern TSequence *tsequence_make_trusted(const TInstant **instants, int count, bool lower_inc, bool upper_inc, interpType interp, bool normalize, validateLevel validate);
 extern TSequence *tsequence_compact(const TSequence *seq);
 extern void tsequence_restart(TSequence *seq, int last);
 extern TSequence *tsequence_subseq(const TSequence *seq, int from, int to, bool lower_inc, bool upper_inc);
@@ -567,6 +637,7 @@ extern TSequence *tsequence_make_free(TInstant **instants, int count, bool lower
 extern TSequenceSet *tsequenceset_make_exp(const TSequence **sequences, int count, int maxcount, bool normalize);
 extern TSequenceSet *tsequenceset_compact(const TSequenceSet *ss);
 extern TSequenceSet *tsequenceset_make_free(TSequence **sequences, int count, bool normalize);
+extern TSequenceSet *tsequenceset_make_trusted(const TSequence **sequences, int count, bool normalize, validateLevel validate);
 extern void tsequenceset_restart(TSequenceSet *ss, int last);
 extern TSequenceSet *tsequenceset_copy(const TSequenceSet *ss);
 extern TSequenceSet *tseqsetarr_to_tseqset(TSequenceSet **seqsets, int count, int totalseqs);
@@ -667,11 +738,12 @@ extern Temporal *tinstant_merge(const TInstant *inst1, const TInstant *inst2);
 extern Temporal *tinstant_merge_array(const TInstant **instants, int count);
 extern TInstant *tinstant_shift_time(const TInstant *inst, const Interval *interval);
 extern TSequence *tinstant_to_tsequence(const TInstant *inst, interpType interp);
+extern TSequence *tinstant_to_tsequence_free(TInstant *inst, interpType interp);
 extern TSequenceSet *tinstant_to_tsequenceset(const TInstant *inst, interpType interp);
 extern Temporal *tnumber_shift_scale_value(const Temporal *temp, Datum shift, Datum width, bool hasshift, bool haswidth);
 extern TInstant *tnuminst_shift_value(const TInstant *inst, Datum shift);
 extern TSequence *tnumberseq_shift_scale_value(const TSequence *seq, Datum shift, Datum width, bool hasshift, bool haswidth);
-extern Temporal *tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist, const Interval *maxt, bool expand);
+extern Temporal *tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist, const Interval *maxt, double tolerance, bool expand);
 extern Temporal *tsequence_append_tsequence(TSequence *seq1, const TSequence *seq2, bool expand);
 extern Temporal *tsequence_merge(const TSequence *seq1, const TSequence *seq2);
 extern Temporal *tsequence_merge_array(const TSequence **sequences, int count);
@@ -681,8 +753,9 @@ extern TInstant *tsequence_to_tinstant(const TSequence *seq);
 extern TSequence *tsequence_to_tdiscseq(const TSequence *seq);
 extern TSequence *tsequence_to_tcontseq(const TSequence *seq, interpType interp);
 extern TSequenceSet *tsequence_to_tsequenceset(const TSequence *seq);
+extern TSequenceSet *tsequence_to_tsequenceset_free(TSequence *seq);
 extern TSequenceSet *tsequence_to_tsequenceset_interp(const TSequence *seq, interpType interp);
-extern TSequenceSet *tsequenceset_append_tinstant(TSequenceSet *ss, const TInstant *inst, double maxdist, const Interval *maxt, bool expand);
+extern TSequenceSet *tsequenceset_append_tinstant(TSequenceSet *ss, const TInstant *inst, double maxdist, const Interval *maxt, double tolerance, bool expand);
 extern TSequenceSet *tsequenceset_append_tsequence(TSequenceSet *ss, const TSequence *seq, bool expand);
 extern TSequenceSet *tsequenceset_merge(const TSequenceSet *ss1, const TSequenceSet *ss2);
 extern TSequenceSet *tsequenceset_merge_array(const TSequenceSet **seqsets, int count);
@@ -707,6 +780,7 @@ extern Temporal *temporal_restrict_timestamp(const Temporal *temp, TimestampTz t
 extern Temporal *temporal_restrict_timestampset(const Temporal *temp, const Set *ts, bool atfunc);
 extern Temporal *temporal_restrict_value(const Temporal *temp, Datum value, bool atfunc);
 extern Temporal *temporal_restrict_values(const Temporal *temp, const Set *set, bool atfunc);
+extern bool temporal_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t, bool strict, Datum *result);
 extern bool temporal_value_at_timestamp(const Temporal *temp, TimestampTz t, bool strict, Datum *result);
 extern TInstant *tinstant_restrict_period(const TInstant *inst, const Span *period, bool atfunc);
 extern TInstant *tinstant_restrict_periodset(const TInstant *inst, const SpanSet *ps, bool atfunc);
@@ -730,6 +804,8 @@ extern TSequenceSet *tpointseqset_restrict_geom_time(const TSequenceSet *ss, con
 extern TSequenceSet *tpointseqset_restrict_stbox(const TSequenceSet *ss, const STBox *box, bool border_inc, bool atfunc);
 extern TSequence *tsequence_at_period(const TSequence *seq, const Span *p);
 extern TInstant *tsequence_at_timestamp(const TSequence *seq, TimestampTz t);
+extern const TInstant *tsequence_inst_at_timestamp(const TSequence *seq, TimestampTz t);
+extern const TInstant *tsequenceset_inst_at_timestamp(const TSequenceSet *ss, TimestampTz t);
 extern TSequenceSet *tsequence_restrict_minmax(const TSequence *seq, bool min, bool atfunc);
 extern Temporal *tsequence_restrict_period(const TSequence *seq, const Span *p, bool atfunc);
 extern Temporal *tsequence_restrict_periodset(const TSequence *seq, const SpanSet *ps, bool atfunc);
@@ -829,6 +905,7 @@ extern int tpointseqset_srid(const TSequenceSet *ss);
 extern STBox *tpointseqset_stboxes(const TSequenceSet *ss, int *count);
 extern GSERIALIZED *tpointseqset_trajectory(const TSequenceSet *ss);
 extern Temporal *tpoint_get_coord(const Temporal *temp, int coord);
+extern void tpoint_set_geocentric_stbox(const Temporal *temp, STBox *box);
 
 /*****************************************************************************/
 
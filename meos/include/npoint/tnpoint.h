@@ -91,6 +91,8 @@ extern TSequence *tnpointdiscseq_tgeompointdiscseq(const TSequence *is);
 extern TSequence *tnpointcontseq_tgeompointcontseq(const TSequence *seq);
 extern TSequenceSet *tnpointseqset_tgeompointseqset(const TSequenceSet *ss);
 extern Temporal *tnpoint_tgeompoint(const Temporal *temp);
+extern Temporal **tnpoint_tgeompoint_batch(const Temporal **temparr,
+  int count);
 
 extern TInstant *tgeompointinst_tnpointinst(const TInstant *inst);
 extern TSequence *tgeompointdiscseq_tnpointdiscseq(const TSequence *is);
@@ -116,6 +118,25 @@ extern Set *tnpoint_routes(const Temporal *temp);
 
 extern Nsegment *tnpointseq_linear_positions(const TSequence *seq);
 
+/* Restriction functions */
+
+extern TSequence *tnpointdiscseq_restrict_route(const TSequence *seq,
+  int64 rid, bool atfunc);
+extern TSequence *tnpointdiscseq_restrict_routes(const TSequence *seq,
+  const Set *s, bool atfunc);
+extern TSequence *tnpointcontseq_restrict_route(const TSequence *seq,
+  int64 rid, bool atfunc);
+extern TSequence *tnpointcontseq_restrict_routes(const TSequence *seq,
+  const Set *s, bool atfunc);
+extern TSequenceSet *tnpointseqset_restrict_route(const TSequenceSet *ss,
+  int64 rid, bool atfunc);
+extern TSequenceSet *tnpointseqset_restrict_routes(const TSequenceSet *ss,
+  const Set *s, bool atfunc);
+extern Temporal *tnpoint_restrict_route(const Temporal *temp, int64 rid,
+  bool atfunc);
+extern Temporal *tnpoint_restrict_routes(const Temporal *temp, const Set *s,
+  bool atfunc);
+
 /*****************************************************************************/
 
 #endif /* __TNPOINT_H__ */
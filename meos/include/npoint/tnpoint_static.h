@@ -41,6 +41,24 @@
 
 /*****************************************************************************/
 
+/**
+ * Structure keeping the geometries of the distinct routes of a batch of
+ * temporal network points, fetched with one query per chunk of routes
+ */
+typedef struct RouteBatch
+{
+  int count;          /**< Number of distinct routes */
+  int64 *rids;        /**< Sorted array of route identifiers */
+  GSERIALIZED **geoms; /**< Route geometries, parallel to the identifiers */
+} RouteBatch;
+
+/* Route batches */
+
+extern RouteBatch *route_batch_make(int64 *rids, int count);
+extern void route_batch_set(RouteBatch *batch, int64 rid, GSERIALIZED *geom);
+extern const GSERIALIZED *route_batch_geom(const RouteBatch *batch, int64 rid);
+extern void route_batch_free(RouteBatch *batch);
+
 /* General functions */
 
 extern int32_t get_srid_ways(void);
@@ -82,6 +100,7 @@ extern double nsegment_end_position(const Nsegment *ns);
 extern bool route_exists(int64 rid);
 extern double route_length(int64 rid);
 extern GSERIALIZED *route_geom(int64 rid);
+extern GSERIALIZED *route_interpolate_point(int64 rid, double pos);
 extern GSERIALIZED *npoint_geom(const Npoint *np);
 extern Npoint *geom_npoint(const GSERIALIZED *gs);
 extern GSERIALIZED *nsegment_geom(const Nsegment *ns);
@@ -0,0 +1,273 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Header-inlinable versions of the hottest liblwgeom primitives
+ * consumed by the temporal point functions.
+ *
+ * Trajectory loops call a handful of trivial geometric primitives once or
+ * twice per segment. When those primitives live in liblwgeom translation
+ * units every call crosses a compilation unit boundary and cannot be
+ * inlined unless the whole library is built with link-time optimization.
+ * This header repeats them as static inline functions under a meos_ prefix,
+ * with the bodies taken verbatim from liblwgeom, so the per-segment call
+ * overhead disappears regardless of the toolchain. The segment-ratio
+ * functions derived from PostGIS to increase floating-point precision,
+ * which MEOS owns, live here for the same reason and keep their names.
+ */
+
+#ifndef __LWGEOM_INLINE_H__
+#define __LWGEOM_INLINE_H__
+
+/* C */
+#include <math.h>
+/* PostGIS */
+#include <liblwgeom.h>
+#include <liblwgeom_internal.h>
+
+/*****************************************************************************
+ * Functions repeated from liblwgeom
+ *****************************************************************************/
+
+/**
+ * @brief Return the distance between two 2D points
+ * @note Function repeated from the PostGIS function distance2d_pt_pt
+ */
+static inline double
+meos_distance2d_pt_pt(const POINT2D *p1, const POINT2D *p2)
+{
+  double hside = p2->x - p1->x;
+  double vside = p2->y - p1->y;
+  return hypot(hside, vside);
+}
+
+/**
+ * @brief Return the distance between two 3D points
+ * @note Function repeated from the PostGIS function distance3d_pt_pt
+ */
+static inline double
+meos_distance3d_pt_pt(const POINT3D *p1, const POINT3D *p2)
+{
+  double dx = p2->x - p1->x;
+  double dy = p2->y - p1->y;
+  double dz = p2->z - p1->z;
+  return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * @brief Compute the azimuth of segment AB in radians
+ * @return LW_FALSE on exception (same point), LW_TRUE otherwise
+ * @note Function repeated from the PostGIS function azimuth_pt_pt
+ */
+static inline int
+meos_azimuth_pt_pt(const POINT2D *A, const POINT2D *B, double *d)
+{
+  if (A->x == B->x && A->y == B->y)
+    return LW_FALSE;
+  *d = fmod(2 * M_PI + M_PI / 2 - atan2(B->y - A->y, B->x - A->x), 2 * M_PI);
+  return LW_TRUE;
+}
+
+/**
+ * @brief Interpolate a point along segment AB at fraction F
+ * @note Function repeated from the PostGIS function interpolate_point4d
+ */
+static inline void
+meos_interpolate_point4d(const POINT4D *A, const POINT4D *B, POINT4D *I,
+  double F)
+{
+  I->x = A->x + ((B->x - A->x) * F);
+  I->y = A->y + ((B->y - A->y) * F);
+  I->z = A->z + ((B->z - A->z) * F);
+  I->m = A->m + ((B->m - A->m) * F);
+}
+
+/**
+ * @brief Return true if two 2D points are equal up to the PostGIS tolerance
+ * @note Function repeated from the PostGIS function p2d_same
+ */
+static inline int
+meos_p2d_same(const POINT2D *p1, const POINT2D *p2)
+{
+  return FP_EQUALS(p1->x, p2->x) && FP_EQUALS(p1->y, p2->y);
+}
+
+/**
+ * @brief Return true if two 3D points are equal up to the PostGIS tolerance
+ * @note Function repeated from the PostGIS function p3d_same
+ */
+static inline int
+meos_p3d_same(const POINT3D *p1, const POINT3D *p2)
+{
+  return FP_EQUALS(p1->x, p2->x) && FP_EQUALS(p1->y, p2->y) &&
+    FP_EQUALS(p1->z, p2->z);
+}
+
+/**
+ * @brief Return true if two 4D points are equal up to the PostGIS tolerance
+ * @note Function repeated from the PostGIS function p4d_same
+ */
+static inline int
+meos_p4d_same(const POINT4D *p1, const POINT4D *p2)
+{
+  return FP_EQUALS(p1->x, p2->x) && FP_EQUALS(p1->y, p2->y) &&
+    FP_EQUALS(p1->z, p2->z) && FP_EQUALS(p1->m, p2->m);
+}
+
+/**
+ * @brief Return true if the bounding boxes of two segments interact
+ * @note Function repeated from the PostGIS function lw_seg_interact, which
+ * is declared static in lwalgorithm.c
+ */
+static inline bool
+meos_lw_seg_interact(const POINT2D *p1, const POINT2D *p2, const POINT2D *q1,
+  const POINT2D *q2)
+{
+  double minq = FP_MIN(q1->x, q2->x);
+  double maxq = FP_MAX(q1->x, q2->x);
+  double minp = FP_MIN(p1->x, p2->x);
+  double maxp = FP_MAX(p1->x, p2->x);
+
+  if (FP_GT(minp, maxq) || FP_LT(maxp, minq))
+    return false;
+
+  minq = FP_MIN(q1->y, q2->y);
+  maxq = FP_MAX(q1->y, q2->y);
+  minp = FP_MIN(p1->y, p2->y);
+  maxp = FP_MAX(p1->y, p2->y);
+
+  if (FP_GT(minp, maxq) || FP_LT(maxp, minq))
+    return false;
+
+  return true;
+}
+
+/*****************************************************************************
+ * Functions derived from PostGIS to increase floating-point precision
+ *****************************************************************************/
+
+/**
+ * @brief Return a long double between 0 and 1 representing the location of the
+ * closest point on the segment to the given point, as a fraction of total
+ * segment length (2D version)
+ * @note Function derived from the PostGIS function closest_point_on_segment
+ */
+static inline long double
+closest_point2d_on_segment_ratio(const POINT2D *p, const POINT2D *A,
+  const POINT2D *B, POINT2D *closest)
+{
+  if (FP_EQUALS(A->x, B->x) && FP_EQUALS(A->y, B->y))
+  {
+    if (closest)
+      *closest = *A;
+    return 0.0;
+  }
+
+  /*
+   * We use comp.graphics.algorithms Frequently Asked Questions method
+   *
+   * (1)          AC dot AB
+   *         r = ----------
+   *              ||AB||^2
+   *  r has the following meaning:
+   *  r=0 P = A
+   *  r=1 P = B
+   *  r<0 P is on the backward extension of AB
+   *  r>1 P is on the forward extension of AB
+   *  0<r<1 P is interior to AB
+   *
+   */
+  long double r = ( (p->x-A->x) * (B->x-A->x) + (p->y-A->y) * (B->y-A->y) ) /
+    ( (B->x-A->x) * (B->x-A->x) + (B->y-A->y) * (B->y-A->y) );
+
+  if (r < 0)
+  {
+    if (closest)
+      *closest = *A;
+    return 0.0;
+  }
+  if (r > 1)
+  {
+    if (closest)
+      *closest = *B;
+    return 1.0;
+  }
+
+  if (closest)
+  {
+    closest->x = (double) (A->x + ( (B->x - A->x) * r ));
+    closest->y = (double) (A->y + ( (B->y - A->y) * r ));
+  }
+  return r;
+}
+
+/**
+ * @brief Return a float between 0 and 1 representing the location of the
+ * closest point on the segment to the given point, as a fraction of total
+ * segment length (3D version)
+ * @note Function derived from the PostGIS function closest_point_on_segment
+ */
+static inline long double
+closest_point3dz_on_segment_ratio(const POINT3DZ *p, const POINT3DZ *A,
+  const POINT3DZ *B, POINT3DZ *closest)
+{
+  if (FP_EQUALS(A->x, B->x) && FP_EQUALS(A->y, B->y) && FP_EQUALS(A->z, B->z))
+  {
+    *closest = *A;
+    return 0.0;
+  }
+
+  /*
+   * Function #closest_point2d_on_segment_ratio explains how r is computed
+   */
+  long double r = ( (p->x-A->x) * (B->x-A->x) + (p->y-A->y) * (B->y-A->y) +
+      (p->z-A->z) * (B->z-A->z) ) /
+    ( (B->x-A->x) * (B->x-A->x) + (B->y-A->y) * (B->y-A->y) +
+      (B->z-A->z) * (B->z-A->z) );
+
+  if (r < 0)
+  {
+    *closest = *A;
+    return 0.0;
+  }
+  if (r > 1)
+  {
+    *closest = *B;
+    return 1.0;
+  }
+
+  closest->x = (double) (A->x + ( (B->x - A->x) * r ));
+  closest->y = (double) (A->y + ( (B->y - A->y) * r ));
+  closest->z = (double) (A->z + ( (B->z - A->z) * r ));
+  return r;
+}
+
+/*****************************************************************************/
+
+#endif /* __LWGEOM_INLINE_H__ */
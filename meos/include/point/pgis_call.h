@@ -87,6 +87,7 @@ extern bool gserialized_azimuth(GSERIALIZED *gs1, GSERIALIZED *gs2,
 extern GEOSGeometry *POSTGIS2GEOS(const GSERIALIZED *pglwgeom);
 extern GSERIALIZED *GEOS2POSTGIS(GEOSGeom geom, char want3d);
 
+extern void meos_geos_prepared_cache_clear(void);
 extern bool gserialized_spatialrel(const GSERIALIZED *gs1,
   const GSERIALIZED *gs2, spatialRel rel);
 extern GSERIALIZED *gserialized_intersection(const GSERIALIZED *gs1,
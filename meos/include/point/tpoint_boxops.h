@@ -59,6 +59,8 @@ extern void tpointseqarr_set_stbox(const TSequence **sequences, int count,
 extern STBox *tpointseq_stboxes(const TSequence *seq, int *count);
 extern STBox *tpointseqset_stboxes(const TSequenceSet *ss, int *count);
 extern STBox * tpoint_stboxes(const Temporal *temp, int *count);
+extern STBox *tpoint_moving_extent(const Temporal *temp,
+  const Interval *duration, int *count);
 
 /* Generic box functions */
 
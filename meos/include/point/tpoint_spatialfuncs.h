@@ -117,16 +117,21 @@ extern bool ensure_valid_tpoint_box(const Temporal *temp, const STBox *box);
 extern bool ensure_valid_tpoint_tpoint(const Temporal *temp1,
   const Temporal *temp2);
 
+/* Functions for the Mapbox Vector Tile transformation */
+
+extern Temporal *tpoint_mvt(const Temporal *tpoint, const STBox *box,
+  uint32_t extent, uint32_t buffer, bool clip_geom);
+
 /* Functions for extracting coordinates */
 
 extern Temporal *tpoint_get_coord(const Temporal *temp, int coord);
+extern void tpointseq_extract_coords(const TSequence *seq, double *x,
+  double *y, double *z, TimestampTz *times);
+extern POINT4D *tpointseq_points(const TSequence *seq);
 
-/* Functions derived from PostGIS to increase floating-point precision */
+/* Functions derived from PostGIS to increase floating-point precision.
+ * The Cartesian segment-ratio functions are in lwgeom_inline.h */
 
-extern long double closest_point2d_on_segment_ratio(const POINT2D *p,
-  const POINT2D *A, const POINT2D *B, POINT2D *closest);
-extern long double closest_point3dz_on_segment_ratio(const POINT3DZ *p,
-  const POINT3DZ *A, const POINT3DZ *B, POINT3DZ *closest);
 extern long double closest_point_on_segment_sphere(const POINT4D *p,
   const POINT4D *A, const POINT4D *B, POINT4D *closest, double *dist);
 extern void interpolate_point4d_spheroid(const POINT4D *p1, const POINT4D *p2,
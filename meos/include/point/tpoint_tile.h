@@ -39,16 +39,23 @@
 
 #define MAXDIMS 4
 
+/* Number of bits per chunk of a bit matrix, that is, 4KB per chunk */
+#define BITMATRIX_CHUNK_BITS 32768
+
 /*****************************************************************************/
 
 /**
- * Structure for storing a bit matrix
+ * Structure for storing a bit matrix as a sparse array of fixed-size chunks.
+ * The chunks covering the multidimensional grid are allocated lazily when a
+ * bit in them is first set, so that tiling a temporal point over a fine grid
+ * only materializes the chunks traversed by the trajectory
  */
 typedef struct
 {
   int ndims;             /**< Number of dimensions */
   int count[MAXDIMS];    /**< Number of elements in each dimension */
-  uint8_t byte[1];       /**< beginning of variable-length data */
+  uint64 nchunks;        /**< Number of chunks covering the full grid */
+  uint8_t **chunks;      /**< Array of lazily allocated bitmap chunks */
 } BitMatrix;
 
 /**
@@ -79,6 +86,7 @@ typedef struct STboxGridState
 /*****************************************************************************/
 
 extern BitMatrix *bitmatrix_make(int *count, int ndims);
+extern void bitmatrix_free(BitMatrix *bm);
 extern int tpoint_set_tiles(const Temporal *temp, const STboxGridState *state,
   BitMatrix *bm);
 extern Temporal *tpoint_at_tile(const Temporal *temp, const STBox *box);
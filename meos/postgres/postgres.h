@@ -63,13 +63,20 @@
 #endif
 #define EXIT_FAILURE 1
 
-/* MEOS: redefining palloc0, palloc, and pfree */
+/* MEOS: redefining palloc0, palloc, and pfree
+ * The functions route the allocations through the arena started with
+ * meos_arena_start, if any, and fall back to malloc/free otherwise */
 #if MEOS
-#define palloc0(X) (calloc(1, X))
-#define palloc malloc
-#define repalloc realloc
-#define pfree free
-#define pstrdup strdup
+extern void *meos_malloc(size_t size);
+extern void *meos_calloc(size_t size);
+extern void *meos_realloc(void *ptr, size_t size);
+extern void meos_free(void *ptr);
+extern char *meos_strdup(const char *str);
+#define palloc0 meos_calloc
+#define palloc meos_malloc
+#define repalloc meos_realloc
+#define pfree meos_free
+#define pstrdup meos_strdup
 #endif /* MEOS */
 
 /* ----------------------------------------------------------------
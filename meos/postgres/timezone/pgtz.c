@@ -16,6 +16,7 @@
 #include <fcntl.h>
 #include <time.h>
 #include <dirent.h> /* MEOS */
+#include <pthread.h> /* MEOS */
 #include <common/hashfn.h> /* MEOS */
 #include <sys/stat.h> /* MEOS */
 // #include "datatype/timestamp.h" /* MEOS */
@@ -57,6 +58,9 @@ static uint32 hash_string_pointer(const char *s);
 extern const char *select_default_timezone(const char *share_path);
 
 /* Current session timezone (controlled by TimeZone GUC) */
+/* MEOS: The variable is written once by meos_initialize_timezone, which
+ * must be called before any worker thread uses the library, and is only
+ * read afterwards */
 pg_tz *session_timezone = NULL;
 
 /* Current log timezone (controlled by log_timezone GUC) */
@@ -272,6 +276,11 @@ scan_directory_ci(const char *dirname, const char *fname, int fnamelen,
 
 static tzcache_hash *timezone_cache = NULL;
 
+/* MEOS: The hash table is created lazily and may be filled by any thread
+ * parsing a timestamp with an unseen timezone, and thus its accesses are
+ * serialized with a mutex */
+static pthread_mutex_t timezone_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static bool
 init_timezone_hashtable(void)
 {
@@ -298,8 +307,8 @@ init_timezone_hashtable(void)
  * 3. It's quick enough that we don't waste much time when the bootstrap
  * default timezone setting is later overridden from postgresql.conf.
  */
-pg_tz *
-pg_tzset(const char *name)
+static pg_tz *
+pg_tzset_internal(const char *name)
 {
   // pg_tz_cache *tzp; /* MEOS */
   struct state tzstate;
@@ -375,6 +384,16 @@ pg_tzset(const char *name)
   return NULL;
 }
 
+/* MEOS: Serialize the accesses to the timezone cache */
+pg_tz *
+pg_tzset(const char *name)
+{
+  pthread_mutex_lock(&timezone_cache_mutex);
+  pg_tz *tz = pg_tzset_internal(name);
+  pthread_mutex_unlock(&timezone_cache_mutex);
+  return tz;
+}
+
 /*
  * Load a fixed-GMT-offset timezone.
  * This is used for SQL-spec SET TIME ZONE INTERVAL 'foo' cases.
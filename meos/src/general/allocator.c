@@ -0,0 +1,517 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Arena (region) allocation for MEOS construction pipelines
+ *
+ * In library mode every palloc/pfree is forwarded to malloc/free. Assembly
+ * workloads that build and discard millions of small temporal values (e.g.
+ * trip assembly from AIS records) spend a significant share of their CPU
+ * time in the allocator. An arena groups these allocations into large
+ * chunks that are carved out by pointer bumping and released wholesale
+ * when the arena is dropped.
+ *
+ * While an arena is active, every allocation made through palloc and
+ * friends is served from the arena and pfree on an arena pointer is a
+ * no-op; pointers obtained before the arena was started are still freed
+ * normally. Arenas do not nest.
+ *
+ * In addition, #meos_initialize_allocator installs an allocator vtable that
+ * replaces the C library functions behind palloc and friends, and may enable
+ * per-subsystem allocation statistics (count, bytes, live bytes, and
+ * high-water mark per tag) so that long-running processes can monitor
+ * allocation growth and leaks online.
+ */
+
+/* C */
+#include <stdlib.h>
+#include <string.h>
+/* Postgres */
+#include <postgres.h>
+/* PostGIS */
+#include <liblwgeom.h>
+/* MEOS */
+#include <meos.h>
+
+/*****************************************************************************/
+
+/** Default size of an arena chunk, also the minimum */
+#define MEOS_ARENA_CHUNK_MINSIZE (64 * 1024)
+
+/** Alignment of the allocations carved from a chunk */
+#define MEOS_ARENA_ALIGN 16
+
+/**
+ * @brief Chunk of arena memory carved out by pointer bumping
+ */
+typedef struct MeosArenaChunk
+{
+  struct MeosArenaChunk *next; /**< Previously filled chunk */
+  size_t size;                 /**< Usable size of the data area */
+  size_t used;                 /**< Bytes already carved out */
+  char data[];                 /**< Data area */
+} MeosArenaChunk;
+
+/**
+ * @brief Global variable that keeps the current arena, NULL when inactive
+ */
+static MeosArenaChunk *_meos_arena = NULL;
+
+/** Chunk size requested when the arena was started */
+static size_t _meos_arena_chunksize = 0;
+
+/*****************************************************************************
+ * Custom allocator and per-subsystem allocation statistics
+ *****************************************************************************/
+
+/** Size of the header prefixed to the tracked allocations, keeping the
+ * maximal alignment of the blocks returned */
+#define MEOS_ALLOC_HDRSIZE 16
+
+/**
+ * @brief Global variable that keeps the allocator vtable, NULL members fall
+ * back to the C library functions
+ */
+static MeosAllocator _meos_allocator = { NULL, NULL, NULL, false };
+
+/**
+ * @brief Global variable that enables the per-tag allocation statistics
+ */
+static bool _meos_alloc_track = false;
+
+/**
+ * @brief Global variable that accumulates the per-tag allocation statistics
+ */
+static MeosAllocStats _meos_alloc_statistics[MEOS_ALLOC_NTAGS] = { 0 };
+
+/**
+ * @brief Bytes carved from the current arena per tag, subtracted from the
+ * live counters when the arena is dropped
+ */
+static int64_t _meos_arena_live[MEOS_ALLOC_NTAGS] = { 0 };
+
+/**
+ * @brief Subsystem tag applied to the subsequent allocations of this thread
+ */
+static __thread MeosAllocTag _meos_alloc_tag = MEOS_ALLOC_GENERIC;
+
+/**
+ * @brief Allocate memory through the vtable or the C library
+ */
+static void *
+raw_malloc(size_t size)
+{
+  return _meos_allocator.malloc_fn ?
+    _meos_allocator.malloc_fn(size) : malloc(size);
+}
+
+/**
+ * @brief Grow memory through the vtable or the C library
+ */
+static void *
+raw_realloc(void *ptr, size_t size)
+{
+  return _meos_allocator.realloc_fn ?
+    _meos_allocator.realloc_fn(ptr, size) : realloc(ptr, size);
+}
+
+/**
+ * @brief Free memory through the vtable or the C library
+ */
+static void
+raw_free(void *ptr)
+{
+  if (_meos_allocator.free_fn)
+    _meos_allocator.free_fn(ptr);
+  else
+    free(ptr);
+  return;
+}
+
+/**
+ * @brief Record an allocation of the given size in the statistics of a tag
+ *
+ * The counters are updated with relaxed atomic operations so that loops
+ * running under the thread pool do not lose counts; the high-water mark is
+ * raised with a compare-and-swap loop.
+ */
+static void
+alloc_stats_grow(MeosAllocTag tag, size_t size, bool newalloc)
+{
+  MeosAllocStats *s = &_meos_alloc_statistics[tag];
+  if (newalloc)
+    __atomic_fetch_add(&s->count, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&s->bytes, (int64_t) size, __ATOMIC_RELAXED);
+  int64_t live = __atomic_add_fetch(&s->live, (int64_t) size,
+    __ATOMIC_RELAXED);
+  int64_t hw = __atomic_load_n(&s->highwater, __ATOMIC_RELAXED);
+  while (live > hw)
+    if (__atomic_compare_exchange_n(&s->highwater, &hw, live, false,
+        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      break;
+  return;
+}
+
+/**
+ * @brief Record a deallocation of the given size in the statistics of a tag
+ */
+static void
+alloc_stats_shrink(MeosAllocTag tag, size_t size)
+{
+  __atomic_fetch_sub(&_meos_alloc_statistics[tag].live, (int64_t) size,
+    __ATOMIC_RELAXED);
+  return;
+}
+
+/*****************************************************************************
+ * Arena allocation
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the pointer was carved from the current arena
+ */
+static bool
+meos_arena_contains(const void *ptr)
+{
+  for (MeosArenaChunk *chunk = _meos_arena; chunk; chunk = chunk->next)
+    if ((const char *) ptr >= chunk->data &&
+        (const char *) ptr < chunk->data + chunk->size)
+      return true;
+  return false;
+}
+
+/**
+ * @brief Carve a block from the current arena, growing it when needed
+ *
+ * Every block is prefixed with its size so that #meos_realloc can copy the
+ * data when a block is grown.
+ */
+static void *
+meos_arena_alloc(size_t size)
+{
+  size_t total = MEOS_ARENA_ALIGN +
+    ((size + MEOS_ARENA_ALIGN - 1) & ~((size_t) MEOS_ARENA_ALIGN - 1));
+  MeosArenaChunk *chunk = _meos_arena;
+  if (chunk->size - chunk->used < total)
+  {
+    size_t chunksize = _meos_arena_chunksize;
+    if (chunksize < total)
+      chunksize = total;
+    MeosArenaChunk *newchunk = raw_malloc(sizeof(MeosArenaChunk) + chunksize);
+    if (! newchunk)
+    {
+      meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+        "Unable to allocate an arena chunk of %zu bytes", chunksize);
+      return NULL;
+    }
+    newchunk->next = chunk;
+    newchunk->size = chunksize;
+    newchunk->used = 0;
+    _meos_arena = chunk = newchunk;
+  }
+  char *block = chunk->data + chunk->used;
+  chunk->used += total;
+  *(size_t *) block = size;
+  return block + MEOS_ARENA_ALIGN;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Start an arena serving all subsequent MEOS allocations
+ * @param[in] chunksize Size of the chunks the arena grows by, pass 0 for
+ * the default
+ * @return True on success
+ */
+bool
+meos_arena_start(size_t chunksize)
+{
+  if (_meos_arena)
+  {
+    meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+      "An arena is already active: arenas do not nest");
+    return false;
+  }
+  if (chunksize < MEOS_ARENA_CHUNK_MINSIZE)
+    chunksize = MEOS_ARENA_CHUNK_MINSIZE;
+  MeosArenaChunk *chunk = raw_malloc(sizeof(MeosArenaChunk) + chunksize);
+  if (! chunk)
+  {
+    meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+      "Unable to allocate an arena chunk of %zu bytes", chunksize);
+    return false;
+  }
+  chunk->next = NULL;
+  chunk->size = chunksize;
+  chunk->used = 0;
+  _meos_arena = chunk;
+  _meos_arena_chunksize = chunksize;
+  return true;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Drop the current arena releasing all memory allocated from it
+ */
+void
+meos_arena_drop(void)
+{
+  MeosArenaChunk *chunk = _meos_arena;
+  _meos_arena = NULL;
+  _meos_arena_chunksize = 0;
+  while (chunk)
+  {
+    MeosArenaChunk *next = chunk->next;
+    raw_free(chunk);
+    chunk = next;
+  }
+  if (_meos_alloc_track)
+  {
+    /* The memory carved from the arena is no longer live */
+    for (int tag = 0; tag < MEOS_ALLOC_NTAGS; tag++)
+    {
+      int64_t live = __atomic_exchange_n(&_meos_arena_live[tag], 0,
+        __ATOMIC_RELAXED);
+      if (live)
+        alloc_stats_shrink((MeosAllocTag) tag, (size_t) live);
+    }
+  }
+  return;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Return true if an arena is currently active
+ */
+bool
+meos_arena_active(void)
+{
+  return _meos_arena != NULL;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Install an allocator vtable serving all subsequent MEOS allocations
+ * @param[in] alloc Allocator, pass NULL to restore the C library functions
+ * @note The function must be called right after #meos_initialize, before the
+ * library makes its first allocation, and is not thread-safe. When the
+ * statistics are enabled every allocation is prefixed with a small header
+ * holding its size and tag, so the setting cannot be changed while
+ * allocations made under the previous setting are still live. The PostGIS
+ * allocation handlers are redirected through the library so that geometries
+ * freed with pfree carry the header as well.
+ */
+void
+meos_initialize_allocator(const MeosAllocator *alloc)
+{
+  if (alloc)
+    memcpy(&_meos_allocator, alloc, sizeof(MeosAllocator));
+  else
+    memset(&_meos_allocator, 0, sizeof(MeosAllocator));
+  _meos_alloc_track = _meos_allocator.track_stats;
+  /* Route the PostGIS allocations through the library so that all pointers
+   * freed with pfree have a consistent layout */
+  lwgeom_set_handlers(meos_malloc, meos_realloc, meos_free, NULL, NULL);
+  return;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Set the subsystem tag applied to the subsequent allocations of the
+ * calling thread
+ */
+void
+meos_alloc_set_tag(MeosAllocTag tag)
+{
+  _meos_alloc_tag = tag;
+  return;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Return a snapshot of the allocation statistics of a subsystem tag
+ */
+MeosAllocStats
+meos_alloc_stats(MeosAllocTag tag)
+{
+  if ((int) tag < 0 || (int) tag >= MEOS_ALLOC_NTAGS)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Unknown allocation tag: %d", (int) tag);
+    MeosAllocStats empty = { 0 };
+    return empty;
+  }
+  return _meos_alloc_statistics[tag];
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Reset the allocation statistics to zero
+ */
+void
+meos_alloc_stats_reset(void)
+{
+  memset(_meos_alloc_statistics, 0, sizeof(_meos_alloc_statistics));
+  memset(_meos_arena_live, 0, sizeof(_meos_arena_live));
+  return;
+}
+
+/*****************************************************************************
+ * Allocation entry points behind palloc and friends in library mode
+ *****************************************************************************/
+
+/**
+ * @brief Allocate memory from the current arena or from the allocator
+ */
+void *
+meos_malloc(size_t size)
+{
+  if (_meos_arena)
+  {
+    void *result = meos_arena_alloc(size);
+    if (result && _meos_alloc_track)
+    {
+      alloc_stats_grow(_meos_alloc_tag, size, true);
+      __atomic_fetch_add(&_meos_arena_live[_meos_alloc_tag], (int64_t) size,
+        __ATOMIC_RELAXED);
+    }
+    return result;
+  }
+  if (_meos_alloc_track)
+  {
+    char *block = raw_malloc(size + MEOS_ALLOC_HDRSIZE);
+    if (! block)
+      return NULL;
+    *(size_t *) block = size;
+    *(int32_t *) (block + sizeof(size_t)) = (int32_t) _meos_alloc_tag;
+    alloc_stats_grow(_meos_alloc_tag, size, true);
+    return block + MEOS_ALLOC_HDRSIZE;
+  }
+  return raw_malloc(size);
+}
+
+/**
+ * @brief Allocate zero-initialized memory from the current arena or the
+ * allocator
+ */
+void *
+meos_calloc(size_t size)
+{
+  if (_meos_arena || _meos_alloc_track || _meos_allocator.malloc_fn)
+  {
+    void *result = meos_malloc(size);
+    if (result)
+      memset(result, 0, size);
+    return result;
+  }
+  return calloc(1, size);
+}
+
+/**
+ * @brief Grow memory allocated with #meos_malloc
+ */
+void *
+meos_realloc(void *ptr, size_t size)
+{
+  if (! ptr)
+    return meos_malloc(size);
+  if (_meos_arena && meos_arena_contains(ptr))
+  {
+    size_t oldsize = *(size_t *) ((char *) ptr - MEOS_ARENA_ALIGN);
+    if (size <= oldsize)
+      return ptr;
+    void *result = meos_arena_alloc(size);
+    if (result)
+    {
+      memcpy(result, ptr, oldsize);
+      if (_meos_alloc_track)
+      {
+        /* The old block stays carved from the arena until it is dropped */
+        alloc_stats_grow(_meos_alloc_tag, size, false);
+        __atomic_fetch_add(&_meos_arena_live[_meos_alloc_tag],
+          (int64_t) size, __ATOMIC_RELAXED);
+      }
+    }
+    return result;
+  }
+  if (_meos_alloc_track)
+  {
+    char *block = (char *) ptr - MEOS_ALLOC_HDRSIZE;
+    size_t oldsize = *(size_t *) block;
+    MeosAllocTag tag = (MeosAllocTag)
+      *(int32_t *) (block + sizeof(size_t));
+    char *newblock = raw_realloc(block, size + MEOS_ALLOC_HDRSIZE);
+    if (! newblock)
+      return NULL;
+    *(size_t *) newblock = size;
+    if (size > oldsize)
+      alloc_stats_grow(tag, size - oldsize, false);
+    else
+      alloc_stats_shrink(tag, oldsize - size);
+    return newblock + MEOS_ALLOC_HDRSIZE;
+  }
+  return raw_realloc(ptr, size);
+}
+
+/**
+ * @brief Free memory allocated with #meos_malloc, a no-op for arena memory
+ */
+void
+meos_free(void *ptr)
+{
+  if (! ptr)
+    return;
+  if (_meos_arena && meos_arena_contains(ptr))
+    return;
+  if (_meos_alloc_track)
+  {
+    char *block = (char *) ptr - MEOS_ALLOC_HDRSIZE;
+    alloc_stats_shrink((MeosAllocTag)
+      *(int32_t *) (block + sizeof(size_t)), *(size_t *) block);
+    raw_free(block);
+    return;
+  }
+  raw_free(ptr);
+  return;
+}
+
+/**
+ * @brief Duplicate a string through #meos_malloc
+ */
+char *
+meos_strdup(const char *str)
+{
+  size_t size = strlen(str) + 1;
+  char *result = meos_malloc(size);
+  if (result)
+    memcpy(result, str, size);
+  return result;
+}
+
+/*****************************************************************************/
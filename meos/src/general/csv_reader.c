@@ -0,0 +1,744 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Batch reader of fixed-schema CSV files into typed column arrays.
+ *
+ * Loaders such as the AIS examples parse every record with @p sscanf and the
+ * general input functions of PostgreSQL, which tokenize each value from
+ * scratch and consult the timezone state per timestamp. For machine-generated
+ * telemetry the schema of every row is identical, so this work can be
+ * compiled once: a CSV reader is opened with a schema string that fixes the
+ * type of every column, and each call to #csv_reader_next fills
+ * caller-provided column arrays with up to a batch of typed values, ready to
+ * be assembled with the array constructors such as
+ * #tfloatseq_make_from_arrays.
+ *
+ * The reader splits fields with @p memchr, which the C library vectorizes,
+ * and decodes long, double, and timestamp values with specialized loops that
+ * avoid the general tokenizer. Timestamps in the usual
+ * <tt>YYYY-MM-DD HH:MM:SS[.ffffff][{Z|+HH[:MM]}]</tt> layout are converted
+ * directly to Julian-day arithmetic; when the timezone is implicit, the
+ * offset of the session timezone is cached per local minute, so the
+ * timezone rules are consulted once per minute of data instead of once per
+ * value. Values in any other layout accepted by PostgreSQL fall back to
+ * #pg_timestamptz_in, so the fast path never changes the accepted input.
+ *
+ * Rows whose fields cannot be decoded with the declared types are skipped
+ * and counted, as in #temporal_reader_open, so that occasional malformed
+ * records do not abort a bulk load.
+ */
+
+#include "general/temporal.h"
+
+/* C */
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* PostgreSQL */
+#include <utils/datetime.h>
+#include <pgtime.h>
+/* MEOS */
+#include <meos.h>
+
+/*****************************************************************************/
+
+/** Size of the raw input chunks read from the file */
+#define MEOS_CSV_CHUNK (1 << 20)
+
+/** Compiled type of a CSV column */
+typedef enum
+{
+  CSV_COLUMN_SKIP,         /**< Column is ignored */
+  CSV_COLUMN_LONG,         /**< 64-bit integer column */
+  CSV_COLUMN_DOUBLE,       /**< Double-precision float column */
+  CSV_COLUMN_TIMESTAMPTZ,  /**< Timestamp with timezone column */
+  CSV_COLUMN_TEXT,         /**< Text column */
+} CsvColumnType;
+
+/**
+ * Structure to represent an open CSV reader. The raw buffer always holds the
+ * unread tail of the file starting at @p pos; it is compacted and refilled
+ * when it no longer contains a complete line.
+ */
+struct CsvReader
+{
+  FILE *file;           /**< File being read */
+  char delim;           /**< Field delimiter */
+  bool header;          /**< True when the first line must be skipped */
+  int ncols;            /**< Number of columns in the schema */
+  CsvColumnType *coltypes; /**< Compiled column types */
+  char *buf;            /**< Raw text buffer */
+  size_t len;           /**< Number of bytes used in the buffer */
+  size_t size;          /**< Allocated size of the buffer */
+  size_t pos;           /**< Start of the unread tail of the buffer */
+  bool eof;             /**< The whole file has been read into the buffer */
+  bool failed;          /**< A read error occurred */
+  int64 skipped;        /**< Number of malformed rows skipped */
+  /* Cached offset of the session timezone for the fast timestamp path,
+   * keyed by the local minute it was computed for */
+  bool tzvalid;         /**< True when the cached offset below is valid */
+  int tzkey[5];         /**< Local year, month, day, hour, minute */
+  int tzoffset;         /**< Offset in seconds, positive west of Greenwich */
+};
+
+/** Powers of ten up to the 15 significant digits decoded by the fast path */
+static const double CSV_POW10[] =
+{
+  1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+  1e14, 1e15
+};
+
+/*****************************************************************************
+ * Field decoding
+ *****************************************************************************/
+
+/**
+ * @brief Trim the spaces surrounding a field
+ */
+static inline void
+csv_field_trim(const char **s, const char **end)
+{
+  while (*s < *end && **s == ' ')
+    (*s)++;
+  while (*end > *s && (*end)[-1] == ' ')
+    (*end)--;
+  return;
+}
+
+/**
+ * @brief Decode a 64-bit integer field
+ * @return False when the field is not a plain decimal integer
+ */
+static bool
+csv_decode_long(const char *s, const char *end, int64 *result)
+{
+  csv_field_trim(&s, &end);
+  if (s == end)
+    return false;
+  bool negative = (*s == '-');
+  if (*s == '-' || *s == '+')
+    s++;
+  if (s == end)
+    return false;
+  int64 value = 0;
+  while (s < end)
+  {
+    uint8 digit = (uint8) (*s++ - '0');
+    if (digit > 9)
+      return false;
+    value = value * 10 + digit;
+  }
+  *result = negative ? -value : value;
+  return true;
+}
+
+/**
+ * @brief Decode a double field.
+ *
+ * Plain decimal values of at most 15 significant digits, which covers the
+ * coordinates and measurements of telemetry feeds, are decoded with integer
+ * arithmetic; anything else, such as exponents or long decimals, is handed
+ * to @p strtod.
+ * @return False when the field is not a number
+ */
+static bool
+csv_decode_double(const char *s, const char *end, double *result)
+{
+  csv_field_trim(&s, &end);
+  if (s == end)
+    return false;
+  const char *cur = s;
+  bool negative = (*cur == '-');
+  if (*cur == '-' || *cur == '+')
+    cur++;
+  int64 mantissa = 0;
+  int ndigits = 0, nfrac = 0;
+  while (cur < end && (uint8) (*cur - '0') <= 9)
+  {
+    mantissa = mantissa * 10 + (*cur++ - '0');
+    ndigits++;
+  }
+  if (cur < end && *cur == '.')
+  {
+    cur++;
+    while (cur < end && (uint8) (*cur - '0') <= 9)
+    {
+      mantissa = mantissa * 10 + (*cur++ - '0');
+      ndigits++;
+      nfrac++;
+    }
+  }
+  if (cur == end && ndigits > 0 && ndigits <= 15)
+  {
+    double value = (double) mantissa / CSV_POW10[nfrac];
+    *result = negative ? -value : value;
+    return true;
+  }
+
+  /* Fall back to strtod on a null-terminated copy of the field */
+  char work[64];
+  size_t fieldlen = (size_t) (end - s);
+  if (fieldlen >= sizeof(work))
+    return false;
+  memcpy(work, s, fieldlen);
+  work[fieldlen] = '\0';
+  char *endptr;
+  errno = 0;
+  *result = strtod(work, &endptr);
+  return errno == 0 && endptr == work + fieldlen;
+}
+
+/**
+ * @brief Return the offset of the session timezone for a local time,
+ * caching the result per local minute
+ */
+static int
+csv_session_offset(CsvReader *reader, int year, int mon, int mday, int hour,
+  int min, int sec)
+{
+  if (reader->tzvalid && reader->tzkey[0] == year &&
+      reader->tzkey[1] == mon && reader->tzkey[2] == mday &&
+      reader->tzkey[3] == hour && reader->tzkey[4] == min)
+    return reader->tzoffset;
+  struct pg_tm tm;
+  memset(&tm, 0, sizeof(tm));
+  tm.tm_year = year;
+  tm.tm_mon = mon;
+  tm.tm_mday = mday;
+  tm.tm_hour = hour;
+  tm.tm_min = min;
+  tm.tm_sec = sec;
+  tm.tm_isdst = -1;
+  reader->tzoffset = DetermineTimeZoneOffset(&tm, session_timezone);
+  reader->tzkey[0] = year;
+  reader->tzkey[1] = mon;
+  reader->tzkey[2] = mday;
+  reader->tzkey[3] = hour;
+  reader->tzkey[4] = min;
+  reader->tzvalid = true;
+  return reader->tzoffset;
+}
+
+/**
+ * @brief Decode a run of digits of a fixed width
+ * @return False when the field does not contain the digits
+ */
+static inline bool
+csv_decode_digits(const char **s, const char *end, int width, int *result)
+{
+  if (end - *s < width)
+    return false;
+  int value = 0;
+  for (int i = 0; i < width; i++)
+  {
+    uint8 digit = (uint8) ((*s)[i] - '0');
+    if (digit > 9)
+      return false;
+    value = value * 10 + digit;
+  }
+  *s += width;
+  *result = value;
+  return true;
+}
+
+/**
+ * @brief Decode a timestamp with timezone field.
+ *
+ * The fast path accepts <tt>YYYY-MM-DD HH:MM:SS</tt> with an optional
+ * <tt>T</tt> date-time separator, up to six fractional second digits, and an
+ * optional <tt>Z</tt> or <tt>+HH[:MM]</tt> timezone suffix; without a suffix
+ * the session timezone applies, as in PostgreSQL. Any other layout is handed
+ * to #pg_timestamptz_in.
+ * @return False when the field is not a valid timestamp
+ */
+static bool
+csv_decode_timestamptz(CsvReader *reader, const char *s, const char *end,
+  TimestampTz *result)
+{
+  csv_field_trim(&s, &end);
+  const char *start = s;
+  int year, mon, mday, hour, min, sec;
+  if (! csv_decode_digits(&s, end, 4, &year) || s == end || *s++ != '-' ||
+      ! csv_decode_digits(&s, end, 2, &mon) || s == end || *s++ != '-' ||
+      ! csv_decode_digits(&s, end, 2, &mday) || s == end ||
+      (*s != ' ' && *s != 'T'))
+    goto fallback;
+  s++;
+  if (! csv_decode_digits(&s, end, 2, &hour) || s == end || *s++ != ':' ||
+      ! csv_decode_digits(&s, end, 2, &min) || s == end || *s++ != ':' ||
+      ! csv_decode_digits(&s, end, 2, &sec))
+    goto fallback;
+  if (mon < 1 || mon > 12 || mday < 1 || mday > 31 || hour > 23 || min > 59 ||
+      sec > 59 || ! IS_VALID_JULIAN(year, mon, mday))
+    goto fallback;
+
+  /* Fractional seconds */
+  int64 fsec = 0;
+  if (s < end && *s == '.')
+  {
+    s++;
+    int nfrac = 0;
+    while (s < end && (uint8) (*s - '0') <= 9)
+    {
+      if (nfrac == 6)
+        goto fallback;
+      fsec = fsec * 10 + (*s++ - '0');
+      nfrac++;
+    }
+    if (nfrac == 0)
+      goto fallback;
+    for (; nfrac < 6; nfrac++)
+      fsec *= 10;
+  }
+
+  /* Timezone suffix; the offset is positive west of Greenwich as in the
+   * PostgreSQL datetime code */
+  int tz;
+  if (s == end)
+  {
+    if (! session_timezone)
+      goto fallback;
+    tz = csv_session_offset(reader, year, mon, mday, hour, min, sec);
+  }
+  else if ((*s == 'Z' || *s == 'z') && s + 1 == end)
+    tz = 0;
+  else if (*s == '+' || *s == '-')
+  {
+    bool east = (*s == '+');
+    s++;
+    int tzhour, tzmin = 0;
+    if (! csv_decode_digits(&s, end, 2, &tzhour))
+      goto fallback;
+    if (s < end && *s == ':')
+      s++;
+    if (s < end && ! csv_decode_digits(&s, end, 2, &tzmin))
+      goto fallback;
+    if (s != end || tzhour > MAX_TZDISP_HOUR || tzmin > 59)
+      goto fallback;
+    tz = tzhour * 3600 + tzmin * 60;
+    if (east)
+      tz = -tz;
+  }
+  else
+    goto fallback;
+
+  int64 date = date2j(year, mon, mday) - POSTGRES_EPOCH_JDATE;
+  *result = date * USECS_PER_DAY +
+    ((int64) hour * 3600 + min * 60 + sec + tz) * USECS_PER_SEC + fsec;
+  if (! IS_VALID_TIMESTAMP(*result))
+    goto fallback;
+  return true;
+
+fallback:
+  {
+    char work[MAXDATELEN + 1];
+    size_t fieldlen = (size_t) (end - start);
+    if (fieldlen > MAXDATELEN)
+      return false;
+    memcpy(work, start, fieldlen);
+    work[fieldlen] = '\0';
+    *result = pg_timestamptz_in(work, -1);
+    return *result != DT_NOEND;
+  }
+}
+
+/**
+ * @brief Return a copy of a text field, removing the enclosing quotes and
+ * collapsing doubled quotes when the field is quoted
+ */
+static char *
+csv_decode_text(const char *s, const char *end, bool quoted)
+{
+  if (! quoted)
+  {
+    size_t fieldlen = (size_t) (end - s);
+    char *result = palloc(fieldlen + 1);
+    memcpy(result, s, fieldlen);
+    result[fieldlen] = '\0';
+    return result;
+  }
+  /* Skip the enclosing quotes and collapse the doubled ones */
+  s++;
+  end--;
+  char *result = palloc((size_t) (end - s) + 1);
+  char *out = result;
+  while (s < end)
+  {
+    if (*s == '"')
+      s++;
+    *out++ = *s++;
+  }
+  *out = '\0';
+  return result;
+}
+
+/*****************************************************************************
+ * Line and field scanning
+ *****************************************************************************/
+
+/**
+ * @brief Refill the raw buffer so that it contains at least one complete
+ * line, compacting the unread tail to its start
+ * @return False when the file is exhausted or a read error occurred
+ */
+static bool
+csv_reader_fill(CsvReader *reader)
+{
+  if (reader->pos > 0)
+  {
+    reader->len -= reader->pos;
+    memmove(reader->buf, reader->buf + reader->pos, reader->len);
+    reader->pos = 0;
+  }
+  while (! reader->eof)
+  {
+    if (reader->size < reader->len + MEOS_CSV_CHUNK)
+    {
+      size_t newsize = Max(reader->len + MEOS_CSV_CHUNK, reader->size * 2);
+      reader->buf = reader->buf ?
+        repalloc(reader->buf, newsize) : palloc(newsize);
+      reader->size = newsize;
+    }
+    size_t nread = fread(reader->buf + reader->len, 1, MEOS_CSV_CHUNK,
+      reader->file);
+    reader->len += nread;
+    if (nread < MEOS_CSV_CHUNK)
+    {
+      if (ferror(reader->file))
+      {
+        meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+          "Error while reading file: %s", strerror(errno));
+        reader->failed = true;
+        return false;
+      }
+      reader->eof = true;
+    }
+    if (memchr(reader->buf, '\n', reader->len) != NULL)
+      return true;
+  }
+  return reader->len > 0;
+}
+
+/**
+ * @brief Return in the output parameters the next line of the file, without
+ * its line terminator
+ * @return False when the file is exhausted or a read error occurred
+ */
+static bool
+csv_reader_line(CsvReader *reader, const char **line, const char **eol)
+{
+  while (true)
+  {
+    char *start = reader->buf + reader->pos;
+    char *nl = reader->len > reader->pos ?
+      memchr(start, '\n', reader->len - reader->pos) : NULL;
+    if (! nl && ! reader->eof)
+    {
+      if (! csv_reader_fill(reader))
+        return false;
+      continue;
+    }
+    char *end;
+    if (nl)
+    {
+      end = nl;
+      reader->pos = (size_t) (nl - reader->buf) + 1;
+    }
+    else
+    {
+      /* Last line of a file without a final newline */
+      if (reader->len == reader->pos)
+        return false;
+      end = reader->buf + reader->len;
+      reader->pos = reader->len;
+    }
+    if (end > start && end[-1] == '\r')
+      end--;
+    /* Silently skip empty lines */
+    if (end == start)
+      continue;
+    if (reader->header)
+    {
+      reader->header = false;
+      continue;
+    }
+    *line = start;
+    *eol = end;
+    return true;
+  }
+}
+
+/**
+ * @brief Return in the output parameters the bounds of the next field of a
+ * line and advance the cursor past its delimiter
+ * @param[out] more True when the field was followed by a delimiter, so that
+ * another field follows on the line
+ */
+static bool
+csv_reader_field(const CsvReader *reader, const char **cur, const char *eol,
+  const char **fstart, const char **fend, bool *quoted, bool *more)
+{
+  const char *s = *cur;
+  *fstart = s;
+  *quoted = (s < eol && *s == '"');
+  if (*quoted)
+  {
+    /* Scan to the closing quote, stepping over doubled quotes */
+    s++;
+    while (true)
+    {
+      s = memchr(s, '"', (size_t) (eol - s));
+      if (! s)
+        return false;
+      s++;
+      if (s == eol || *s != '"')
+        break;
+      s++;
+    }
+    *fend = s;
+    if (s < eol && *s != reader->delim)
+      return false;
+    *more = (s < eol);
+    *cur = *more ? s + 1 : eol;
+  }
+  else
+  {
+    const char *delim = memchr(s, reader->delim, (size_t) (eol - s));
+    *fend = delim ? delim : eol;
+    *more = (delim != NULL);
+    *cur = delim ? delim + 1 : eol;
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * Reader interface
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Open a CSV file for batch reading with a fixed column schema.
+ *
+ * The schema string fixes the type of every column of the file: @p 'l' for a
+ * 64-bit integer, @p 'd' for a double, @p 't' for a timestamp with timezone,
+ * @p 's' for text, and @p 'x' for a column to ignore.
+ * @param[in] path Name of the file to read
+ * @param[in] schema Type characters of the columns, one per column
+ * @param[in] delim Field delimiter, @p '\\0' for the default comma
+ * @param[in] header True when the first line of the file holds column names
+ * and must be skipped
+ * @return On error return @p NULL
+ */
+CsvReader *
+csv_reader_open(const char *path, const char *schema, char delim, bool header)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) path) || ! ensure_not_null((void *) schema))
+    return NULL;
+  int ncols = (int) strlen(schema);
+  if (ncols == 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The schema must have at least one column");
+    return NULL;
+  }
+  CsvColumnType *coltypes = palloc(sizeof(CsvColumnType) * ncols);
+  for (int i = 0; i < ncols; i++)
+  {
+    switch (schema[i])
+    {
+      case 'l':
+        coltypes[i] = CSV_COLUMN_LONG;
+        break;
+      case 'd':
+        coltypes[i] = CSV_COLUMN_DOUBLE;
+        break;
+      case 't':
+        coltypes[i] = CSV_COLUMN_TIMESTAMPTZ;
+        break;
+      case 's':
+        coltypes[i] = CSV_COLUMN_TEXT;
+        break;
+      case 'x':
+        coltypes[i] = CSV_COLUMN_SKIP;
+        break;
+      default:
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "Unknown schema character '%c'", schema[i]);
+        pfree(coltypes);
+        return NULL;
+    }
+  }
+
+  FILE *file = fopen(path, "r");
+  if (! file)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot open file '%s': %s", path, strerror(errno));
+    pfree(coltypes);
+    return NULL;
+  }
+
+  CsvReader *reader = palloc0(sizeof(CsvReader));
+  reader->file = file;
+  reader->delim = delim ? delim : ',';
+  reader->header = header;
+  reader->ncols = ncols;
+  reader->coltypes = coltypes;
+  return reader;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Fill the column arrays with the next batch of rows of a CSV reader.
+ *
+ * The columns array holds one pointer per column of the schema: an @p int64
+ * array for a long column, a @p double array for a double column, a
+ * @p TimestampTz array for a timestamp column, and a <tt>char *</tt> array
+ * for a text column, each with room for the requested number of rows; the
+ * entries of skipped columns are not accessed. The caller becomes the owner
+ * of the text values and must free them. Rows whose fields cannot be decoded
+ * with the declared types are skipped and counted (see #csv_reader_skipped).
+ * @param[in] reader CSV reader
+ * @param[in] maxrows Maximum number of rows to read
+ * @param[out] columns Array of column arrays to fill
+ * @return Number of rows read, 0 when the file is exhausted, and -1 on error
+ */
+int
+csv_reader_next(CsvReader *reader, int maxrows, void **columns)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) reader) ||
+      ! ensure_not_null((void *) columns) || ! ensure_positive(maxrows))
+    return -1;
+
+  int nrows = 0;
+  const char *line, *eol;
+  while (nrows < maxrows && csv_reader_line(reader, &line, &eol))
+  {
+    const char *cur = line;
+    bool valid = true, more = true;
+    int col;
+    for (col = 0; col < reader->ncols; col++)
+    {
+      const char *fstart, *fend;
+      bool quoted;
+      /* A row with fewer fields than the schema is malformed */
+      if (! more ||
+          ! csv_reader_field(reader, &cur, eol, &fstart, &fend, &quoted, &more))
+      {
+        valid = false;
+        break;
+      }
+      if (quoted && reader->coltypes[col] != CSV_COLUMN_TEXT &&
+          reader->coltypes[col] != CSV_COLUMN_SKIP)
+      {
+        /* Decode the content of a quoted numeric field */
+        fstart++;
+        fend--;
+      }
+      switch (reader->coltypes[col])
+      {
+        case CSV_COLUMN_LONG:
+          valid = csv_decode_long(fstart, fend,
+            &((int64 *) columns[col])[nrows]);
+          break;
+        case CSV_COLUMN_DOUBLE:
+          valid = csv_decode_double(fstart, fend,
+            &((double *) columns[col])[nrows]);
+          break;
+        case CSV_COLUMN_TIMESTAMPTZ:
+          valid = csv_decode_timestamptz(reader, fstart, fend,
+            &((TimestampTz *) columns[col])[nrows]);
+          break;
+        case CSV_COLUMN_TEXT:
+          ((char **) columns[col])[nrows] = csv_decode_text(fstart, fend,
+            quoted);
+          break;
+        default: /* CSV_COLUMN_SKIP */
+          break;
+      }
+      if (! valid)
+        break;
+    }
+    /* A row with more fields than the schema is malformed */
+    if (valid && more)
+      valid = false;
+    if (! valid)
+    {
+      /* Free the text values already produced for the skipped row */
+      for (int i = 0; i < col; i++)
+        if (reader->coltypes[i] == CSV_COLUMN_TEXT)
+          pfree(((char **) columns[i])[nrows]);
+      reader->skipped++;
+      continue;
+    }
+    nrows++;
+  }
+  if (reader->failed)
+    return -1;
+  return nrows;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Return the number of malformed rows skipped by a CSV reader
+ */
+int64
+csv_reader_skipped(const CsvReader *reader)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) reader))
+    return -1;
+  return reader->skipped;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Close a CSV reader
+ */
+void
+csv_reader_close(CsvReader *reader)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) reader))
+    return;
+  fclose(reader->file);
+  if (reader->buf)
+    pfree(reader->buf);
+  pfree(reader->coltypes);
+  pfree(reader);
+  return;
+}
+
+/*****************************************************************************/
@@ -45,9 +45,13 @@
 /*****************************************************************************/
 
 /**
- * @brief Global variable that keeps the last error number.
+ * @brief Thread-local variable that keeps the last error number.
+ *
+ * Each thread has its own error number so that concurrent calls to the
+ * library do not clobber each other's error status. The error functions
+ * below therefore operate on the state of the calling thread only.
  */
-int _meos_errno = 0;
+static __thread int _meos_errno = 0;
 
 /**
  * @brief Read an error number
@@ -130,8 +134,13 @@ int meos_errno_reset(void)
 
 /**
  * @brief Global variable that keeps the error handler function
+ *
+ * The handler is shared by all threads and is installed once by
+ * #meos_initialize before any worker thread calls into the library.
+ * It is accessed with atomic loads/stores so that a late installation
+ * is safely published to threads already running.
  */
-void (*_error_handler)(int, int, char *) = NULL;
+static void (*_error_handler)(int, int, char *) = NULL;
 
 #if MEOS
 /**
@@ -167,9 +176,10 @@ void
 meos_initialize_error_handler(error_handler_fn err_handler)
 {
   if (err_handler)
-    _error_handler = err_handler;
+    __atomic_store_n(&_error_handler, err_handler, __ATOMIC_RELEASE);
   else
-    _error_handler = &default_error_handler;
+    __atomic_store_n(&_error_handler, &default_error_handler,
+      __ATOMIC_RELEASE);
   return;
 }
 #endif /* MEOS */
@@ -182,14 +192,17 @@ meos_initialize_error_handler(error_handler_fn err_handler)
 void
 meos_error(int errlevel, int errcode, char *format, ...)
 {
+  /* The buffer is on the stack and thus private to the calling thread */
   char buffer[1024];
   va_list args;
   va_start(args, format);
-  vsprintf(buffer, format, args);
+  vsnprintf(buffer, sizeof(buffer), format, args);
   va_end(args);
   /* Execute the error handler function */
-  if (_error_handler)
-    _error_handler(errlevel, errcode, buffer);
+  void (*handler)(int, int, char *) =
+    __atomic_load_n(&_error_handler, __ATOMIC_ACQUIRE);
+  if (handler)
+    handler(errlevel, errcode, buffer);
   else
 #if ! MEOS
     elog(errlevel, "%s", buffer);
@@ -208,6 +221,13 @@ meos_error(int errlevel, int errcode, char *format, ...)
 #if MEOS
 /*
  * Initialize MEOS library
+ *
+ * This function must be called once, before any worker thread calls into
+ * the library. It installs the error handler, which is shared by all
+ * threads, and fills the timezone cache entry of the session timezone.
+ * After initialization the library entry points may be called from
+ * several threads concurrently: the error number is thread-local and the
+ * timezone cache serializes its updates internally.
  */
 void
 meos_initialize(const char *tz_str, error_handler_fn err_handler)
@@ -218,11 +238,12 @@ meos_initialize(const char *tz_str, error_handler_fn err_handler)
 }
 
 /*
- * Free the timezone cache
+ * Free the timezone cache and stop the thread pool if one was started
  */
 void
 meos_finalize(void)
 {
+  meos_finalize_pool();
   meos_finalize_timezone();
   return;
 }
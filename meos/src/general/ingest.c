@@ -0,0 +1,661 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Lock-free multi-producer ingestion stage assembling temporal values
+ *
+ * Stream gateways typically have several network threads receiving
+ * observations of many moving objects and must assemble one temporal value
+ * per object. MEOS values are not concurrent, so without library support
+ * every gateway ends up building the same machinery: shard the objects,
+ * route the observations of a shard to a single owner thread, and let the
+ * owners append them. This module provides that stage.
+ *
+ * An ingestion started with #meos_ingest_start owns a number of shards.
+ * Each shard has a lock-free multi-producer single-consumer queue and an
+ * assembler thread that drains it, appending every instant to the sequence
+ * of its object with #temporal_append_tinstant on expandable sequences.
+ * Any number of producer threads push observations through per-producer
+ * handles; observations are routed to the shard of their object, so all
+ * instants of an object are appended by one thread in arrival order, and
+ * are handed off in batches to amortize the queue traffic. Producers never
+ * take a lock: a push is one atomic exchange and one release store, plus a
+ * wakeup only when the assembler has run out of work and parked itself.
+ *
+ * Instants with a timestamp at or before the last appended timestamp of
+ * their object are dropped, as late arrivals are expected on a network.
+ * As for the thread pool, the assemblers allocate with the default
+ * allocator, hence an ingestion must not run while an arena is active.
+ */
+
+/* C */
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+/* Postgres */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+
+/*****************************************************************************/
+
+/** Maximum number of shards, that is, of assembler threads */
+#define MEOS_INGEST_MAXSHARDS 64
+/** Number of observations handed off to a shard at once */
+#define MEOS_INGEST_BATCHSIZE 64
+/** Initial number of instants reserved by the sequence of an object */
+#define MEOS_INGEST_SEQCAPACITY 64
+/** Initial number of slots of the object table of a shard */
+#define MEOS_INGEST_TABLESIZE 1024
+
+/** One observation handed off to an assembler */
+typedef struct MeosIngestRecord
+{
+  int64 id;               /**< Identifier of the moving object */
+  TInstant *inst;         /**< Copy of the instant, owned by the record */
+} MeosIngestRecord;
+
+/**
+ * @brief Batch node of the queue of a shard
+ *
+ * The queue is an intrusive multi-producer single-consumer linked list in
+ * the style of Vyukov: producers exchange the head pointer and link the
+ * previous head to the new node, the assembler follows the tail. The node
+ * most recently consumed remains in the queue as a stub.
+ */
+typedef struct MeosIngestNode
+{
+  _Atomic(struct MeosIngestNode *) next; /**< Next node towards the head */
+  int count;              /**< Number of records, 0 for the stub */
+  bool stop;              /**< True for the node ending the ingestion */
+  MeosIngestRecord records[MEOS_INGEST_BATCHSIZE]; /**< The observations */
+} MeosIngestNode;
+
+/** Assembled state of one moving object, empty when temp is NULL */
+typedef struct MeosIngestEntry
+{
+  int64 id;               /**< Identifier of the moving object */
+  TimestampTz last;       /**< Timestamp of the last appended instant */
+  Temporal *temp;         /**< Sequence under assembly */
+} MeosIngestEntry;
+
+/**
+ * @brief Shard owning the objects routed to it
+ *
+ * Only head, tail and the parking protocol are shared; the table and the
+ * statistics are owned by the assembler thread until it exits.
+ */
+typedef struct MeosIngestShard
+{
+  _Atomic(MeosIngestNode *) head; /**< Producers push here */
+  MeosIngestNode *tail;   /**< Followed by the assembler */
+  atomic_bool parked;     /**< True while the assembler waits for work */
+  pthread_mutex_t lock;   /**< Protects the condition variable only */
+  pthread_cond_t nonempty; /**< Signaled when a parked assembler gets work */
+  pthread_t thread;       /**< The assembler thread */
+  struct MeosIngest *ingest; /**< Owning ingestion */
+  MeosIngestEntry *entries; /**< Object table, open addressing */
+  int size;               /**< Number of slots of the table, a power of 2 */
+  int nobjects;           /**< Number of objects in the table */
+  int64 ndropped;         /**< Late observations dropped */
+} MeosIngestShard;
+
+/**
+ * @brief Multi-producer ingestion assembling one temporal value per object
+ */
+struct MeosIngest
+{
+  int nshards;            /**< Number of shards */
+  interpType interp;      /**< Interpolation of the assembled sequences */
+  MeosIngestShard *shards; /**< The shards */
+};
+
+/**
+ * @brief Producer handle holding one open batch per shard
+ *
+ * The handle is owned by a single producer thread and therefore needs no
+ * synchronization of its own.
+ */
+struct MeosIngestProducer
+{
+  MeosIngest *ingest;     /**< Owning ingestion */
+  MeosIngestNode **open;  /**< Open batch per shard, NULL when none */
+};
+
+/*****************************************************************************
+ * Queue
+ *****************************************************************************/
+
+/**
+ * @brief Push a node on the queue of a shard, lock-free
+ */
+static void
+meos_ingest_push(MeosIngestShard *shard, MeosIngestNode *node)
+{
+  atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+  MeosIngestNode *prev = atomic_exchange_explicit(&shard->head, node,
+    memory_order_acq_rel);
+  /* Publish the node contents; pairs with the acquire load of next in the
+   * assembler */
+  atomic_store_explicit(&prev->next, node, memory_order_release);
+  /* The store of next must be ordered before the load of parked and, in
+   * the assembler, the store of parked before the re-check of next;
+   * otherwise both sides could miss each other and the wakeup be lost */
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&shard->parked, memory_order_relaxed))
+  {
+    pthread_mutex_lock(&shard->lock);
+    pthread_cond_signal(&shard->nonempty);
+    pthread_mutex_unlock(&shard->lock);
+  }
+  return;
+}
+
+/**
+ * @brief Pop the next node of the queue of a shard, assembler thread only
+ * @return NULL when the queue is empty
+ *
+ * The node consumed previously is the stub in front of the returned one
+ * and is released here; the returned node becomes the new stub once its
+ * records have been processed.
+ */
+static MeosIngestNode *
+meos_ingest_pop(MeosIngestShard *shard)
+{
+  MeosIngestNode *stub = shard->tail;
+  MeosIngestNode *next = atomic_load_explicit(&stub->next,
+    memory_order_acquire);
+  if (! next)
+    return NULL;
+  shard->tail = next;
+  free(stub);
+  return next;
+}
+
+/**
+ * @brief Pop the next node of the queue of a shard, parking the assembler
+ * until one is available
+ */
+static MeosIngestNode *
+meos_ingest_pop_wait(MeosIngestShard *shard)
+{
+  MeosIngestNode *node = meos_ingest_pop(shard);
+  if (node)
+    return node;
+  pthread_mutex_lock(&shard->lock);
+  atomic_store_explicit(&shard->parked, true, memory_order_relaxed);
+  /* See the matching fence in #meos_ingest_push */
+  atomic_thread_fence(memory_order_seq_cst);
+  while (atomic_load_explicit(&shard->tail->next, memory_order_acquire) ==
+    NULL)
+    pthread_cond_wait(&shard->nonempty, &shard->lock);
+  atomic_store_explicit(&shard->parked, false, memory_order_relaxed);
+  pthread_mutex_unlock(&shard->lock);
+  return meos_ingest_pop(shard);
+}
+
+/*****************************************************************************
+ * Object table
+ *****************************************************************************/
+
+/**
+ * @brief Mix the identifier of an object into a well-distributed hash
+ */
+static uint64
+meos_ingest_hash(int64 id)
+{
+  uint64 h = (uint64) id;
+  h ^= h >> 33;
+  h *= UINT64CONST(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * @brief Return the entry of an object, inserting an empty one when absent
+ * @return NULL when the table cannot grow
+ */
+static MeosIngestEntry *
+meos_ingest_entry(MeosIngestShard *shard, int64 id)
+{
+  /* Grow at 70% fill to keep the probe sequences short */
+  if (shard->nobjects * 10 >= shard->size * 7)
+  {
+    int newsize = shard->size * 2;
+    MeosIngestEntry *newentries = calloc(newsize, sizeof(MeosIngestEntry));
+    if (! newentries)
+      return NULL;
+    for (int i = 0; i < shard->size; i++)
+    {
+      MeosIngestEntry *entry = &shard->entries[i];
+      if (! entry->temp)
+        continue;
+      uint64 pos = meos_ingest_hash(entry->id) & (newsize - 1);
+      while (newentries[pos].temp)
+        pos = (pos + 1) & (newsize - 1);
+      newentries[pos] = *entry;
+    }
+    free(shard->entries);
+    shard->entries = newentries;
+    shard->size = newsize;
+  }
+  uint64 pos = meos_ingest_hash(id) & (shard->size - 1);
+  while (shard->entries[pos].temp && shard->entries[pos].id != id)
+    pos = (pos + 1) & (shard->size - 1);
+  shard->entries[pos].id = id;
+  return &shard->entries[pos];
+}
+
+/*****************************************************************************
+ * Assembler
+ *****************************************************************************/
+
+/**
+ * @brief Append one observation to the sequence of its object
+ */
+static void
+meos_ingest_append(MeosIngestShard *shard, MeosIngestRecord *rec)
+{
+  MeosIngestEntry *entry = meos_ingest_entry(shard, rec->id);
+  if (! entry || (entry->temp && rec->inst->t <= entry->last))
+  {
+    /* Late observations are expected on a network and silently dropped */
+    shard->ndropped++;
+    free(rec->inst);
+    return;
+  }
+  if (! entry->temp)
+  {
+    const TInstant *inst = rec->inst;
+    entry->temp = (Temporal *) tsequence_make_exp(&inst, 1,
+      MEOS_INGEST_SEQCAPACITY, true, true, shard->ingest->interp,
+      NORMALIZE_NO);
+    shard->nobjects++;
+  }
+  else
+  {
+    Temporal *result = temporal_append_tinstant(entry->temp, rec->inst,
+      0.0, NULL, 0.0, true);
+    if (result)
+      entry->temp = result;
+    else
+      shard->ndropped++;
+  }
+  entry->last = rec->inst->t;
+  free(rec->inst);
+  return;
+}
+
+/**
+ * @brief Main function of an assembler thread
+ */
+static void *
+meos_ingest_assembler(void *arg)
+{
+  MeosIngestShard *shard = (MeosIngestShard *) arg;
+  while (true)
+  {
+    MeosIngestNode *node = meos_ingest_pop_wait(shard);
+    if (node->stop)
+      break;
+    for (int i = 0; i < node->count; i++)
+      meos_ingest_append(shard, &node->records[i]);
+    /* The node stays in the queue as the stub */
+  }
+  return NULL;
+}
+
+/*****************************************************************************
+ * Producers
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Start a producer handle for the current thread
+ * @param[in] ingest The ingestion
+ * @return On error return @p NULL
+ *
+ * The handle batches observations per shard and must only be used by the
+ * thread that pushes through it; every producer thread needs its own.
+ */
+MeosIngestProducer *
+meos_ingest_producer_start(MeosIngest *ingest)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) ingest))
+    return NULL;
+
+  MeosIngestProducer *producer = calloc(1, sizeof(MeosIngestProducer));
+  MeosIngestNode **open = calloc(ingest->nshards, sizeof(MeosIngestNode *));
+  if (! producer || ! open)
+  {
+    meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+      "Unable to allocate the producer handle");
+    free(producer); free(open);
+    return NULL;
+  }
+  producer->ingest = ingest;
+  producer->open = open;
+  return producer;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Push one observation of a moving object into the ingestion
+ * @param[in] producer Producer handle of the calling thread
+ * @param[in] id Identifier of the moving object
+ * @param[in] inst Observed instant, copied and not kept
+ * @return True on success
+ *
+ * The observation is routed to the shard owning the object and handed off
+ * together with the other observations batched on the handle; call
+ * #meos_ingest_producer_flush to bound the latency of a slow producer.
+ */
+bool
+meos_ingest_produce(MeosIngestProducer *producer, int64 id,
+  const TInstant *inst)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) producer) ||
+      ! ensure_not_null((void *) inst))
+    return false;
+
+  MeosIngest *ingest = producer->ingest;
+  int shardno = (int) (meos_ingest_hash(id) % (uint64) ingest->nshards);
+  MeosIngestNode *node = producer->open[shardno];
+  if (! node)
+  {
+    node = calloc(1, sizeof(MeosIngestNode));
+    if (! node)
+    {
+      meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+        "Unable to allocate an ingestion batch");
+      return false;
+    }
+    producer->open[shardno] = node;
+  }
+  size_t size = VARSIZE(inst);
+  TInstant *copy = malloc(size);
+  if (! copy)
+  {
+    meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+      "Unable to copy an observation");
+    return false;
+  }
+  memcpy(copy, inst, size);
+  node->records[node->count].id = id;
+  node->records[node->count].inst = copy;
+  if (++node->count == MEOS_INGEST_BATCHSIZE)
+  {
+    producer->open[shardno] = NULL;
+    meos_ingest_push(&ingest->shards[shardno], node);
+  }
+  return true;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Hand off the observations still batched on a producer handle
+ * @param[in] producer Producer handle of the calling thread
+ */
+void
+meos_ingest_producer_flush(MeosIngestProducer *producer)
+{
+  if (! producer)
+    return;
+  for (int i = 0; i < producer->ingest->nshards; i++)
+  {
+    MeosIngestNode *node = producer->open[i];
+    if (! node || node->count == 0)
+      continue;
+    producer->open[i] = NULL;
+    meos_ingest_push(&producer->ingest->shards[i], node);
+  }
+  return;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Flush and release a producer handle
+ * @param[in] producer Producer handle of the calling thread
+ */
+void
+meos_ingest_producer_finish(MeosIngestProducer *producer)
+{
+  if (! producer)
+    return;
+  meos_ingest_producer_flush(producer);
+  for (int i = 0; i < producer->ingest->nshards; i++)
+    free(producer->open[i]);
+  free(producer->open);
+  free(producer);
+  return;
+}
+
+/*****************************************************************************
+ * Lifetime
+ *****************************************************************************/
+
+/**
+ * @brief Release the resources of the first nshards shards
+ */
+static void
+meos_ingest_free(MeosIngest *ingest, int nshards)
+{
+  for (int i = 0; i < nshards; i++)
+  {
+    MeosIngestShard *shard = &ingest->shards[i];
+    /* Drain the nodes still queued, including the stub */
+    MeosIngestNode *node = shard->tail;
+    while (node)
+    {
+      MeosIngestNode *next = atomic_load_explicit(&node->next,
+        memory_order_relaxed);
+      for (int j = 0; j < node->count; j++)
+        free(node->records[j].inst);
+      free(node);
+      node = next;
+    }
+    pthread_mutex_destroy(&shard->lock);
+    pthread_cond_destroy(&shard->nonempty);
+    free(shard->entries);
+  }
+  free(ingest->shards);
+  free(ingest);
+  return;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Start an ingestion assembling one temporal sequence per object
+ * @param[in] nshards Number of shards, that is, of assembler threads;
+ * when 0, one per available core
+ * @param[in] interp Interpolation of the assembled sequences
+ * @return On error return @p NULL
+ */
+MeosIngest *
+meos_ingest_start(int nshards, interpType interp)
+{
+  if (nshards < 0 || nshards > MEOS_INGEST_MAXSHARDS)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of shards must be between 0 and %d",
+      MEOS_INGEST_MAXSHARDS);
+    return NULL;
+  }
+  if (nshards == 0)
+  {
+    long ncores = sysconf(_SC_NPROCESSORS_ONLN);
+    nshards = (ncores > MEOS_INGEST_MAXSHARDS) ?
+      MEOS_INGEST_MAXSHARDS : (ncores > 1) ? (int) ncores : 1;
+  }
+  MeosIngest *ingest = calloc(1, sizeof(MeosIngest));
+  if (ingest)
+    ingest->shards = calloc(nshards, sizeof(MeosIngestShard));
+  if (! ingest || ! ingest->shards)
+  {
+    meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+      "Unable to allocate the ingestion");
+    if (ingest)
+      free(ingest->shards);
+    free(ingest);
+    return NULL;
+  }
+  ingest->nshards = nshards;
+  ingest->interp = interp;
+  for (int i = 0; i < nshards; i++)
+  {
+    MeosIngestShard *shard = &ingest->shards[i];
+    MeosIngestNode *stub = calloc(1, sizeof(MeosIngestNode));
+    shard->entries = calloc(MEOS_INGEST_TABLESIZE, sizeof(MeosIngestEntry));
+    if (! stub || ! shard->entries)
+    {
+      meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+        "Unable to allocate the ingestion shards");
+      free(stub);
+      free(shard->entries);
+      shard->entries = NULL;
+      /* The shards already started must be stopped before freeing */
+      for (int j = 0; j < i; j++)
+      {
+        MeosIngestNode *stop = calloc(1, sizeof(MeosIngestNode));
+        if (stop)
+        {
+          stop->stop = true;
+          meos_ingest_push(&ingest->shards[j], stop);
+          pthread_join(ingest->shards[j].thread, NULL);
+        }
+      }
+      meos_ingest_free(ingest, i);
+      return NULL;
+    }
+    atomic_init(&shard->head, stub);
+    shard->tail = stub;
+    atomic_init(&shard->parked, false);
+    pthread_mutex_init(&shard->lock, NULL);
+    pthread_cond_init(&shard->nonempty, NULL);
+    shard->ingest = ingest;
+    shard->size = MEOS_INGEST_TABLESIZE;
+    if (pthread_create(&shard->thread, NULL, &meos_ingest_assembler, shard))
+    {
+      meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+        "Unable to start the assembler threads");
+      free(shard->tail);
+      shard->tail = NULL;
+      free(shard->entries);
+      shard->entries = NULL;
+      pthread_mutex_destroy(&shard->lock);
+      pthread_cond_destroy(&shard->nonempty);
+      for (int j = 0; j < i; j++)
+      {
+        MeosIngestNode *stop = calloc(1, sizeof(MeosIngestNode));
+        if (stop)
+        {
+          stop->stop = true;
+          meos_ingest_push(&ingest->shards[j], stop);
+          pthread_join(ingest->shards[j].thread, NULL);
+        }
+      }
+      meos_ingest_free(ingest, i);
+      return NULL;
+    }
+  }
+  return ingest;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Stop an ingestion and return the assembled temporal values
+ * @param[in] ingest The ingestion, released by the call
+ * @param[out] ids Identifiers of the assembled objects
+ * @param[out] count Number of assembled objects
+ * @return Array of assembled temporal values, in no particular order;
+ * on error return @p NULL
+ * @note All producer handles must have been finished before this call;
+ * observations pushed afterwards would be lost
+ */
+Temporal **
+meos_ingest_finish(MeosIngest *ingest, int64 **ids, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) ingest) || ! ensure_not_null((void *) ids)
+      || ! ensure_not_null((void *) count))
+    return NULL;
+
+  /* Stop the assemblers; the stop node is pushed after every batch still
+   * queued and thus processed last */
+  for (int i = 0; i < ingest->nshards; i++)
+  {
+    MeosIngestNode *stop = calloc(1, sizeof(MeosIngestNode));
+    if (! stop)
+    {
+      meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+        "Unable to stop the ingestion");
+      return NULL;
+    }
+    stop->stop = true;
+    meos_ingest_push(&ingest->shards[i], stop);
+  }
+  int nobjects = 0;
+  for (int i = 0; i < ingest->nshards; i++)
+  {
+    pthread_join(ingest->shards[i].thread, NULL);
+    nobjects += ingest->shards[i].nobjects;
+  }
+
+  /* Gather the assembled values, trimming the expansion slack */
+  Temporal **result = palloc(sizeof(Temporal *) * Max(nobjects, 1));
+  int64 *resultids = palloc(sizeof(int64) * Max(nobjects, 1));
+  int k = 0;
+  for (int i = 0; i < ingest->nshards; i++)
+  {
+    MeosIngestShard *shard = &ingest->shards[i];
+    for (int j = 0; j < shard->size; j++)
+    {
+      if (! shard->entries[j].temp)
+        continue;
+      result[k] = temporal_compact(shard->entries[j].temp);
+      pfree(shard->entries[j].temp);
+      resultids[k++] = shard->entries[j].id;
+    }
+  }
+  assert(k == nobjects);
+  meos_ingest_free(ingest, ingest->nshards);
+  *ids = resultids;
+  *count = nobjects;
+  return result;
+}
+
+/*****************************************************************************/
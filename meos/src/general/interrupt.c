@@ -0,0 +1,153 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Cooperative interruption and progress reporting for long operations
+ *
+ * Long computations such as the similarity distances and the tile sweeps
+ * poll #meos_interrupt_check from their outer loops so that a host
+ * application can abandon a superseded computation quickly instead of
+ * letting it run to completion, and call #meos_progress_report so that the
+ * application can display or log the progress of the operation. Both
+ * callbacks are optional: when none is installed the checks reduce to a
+ * counter decrement or an atomic load.
+ */
+
+#include "general/interrupt.h"
+
+/* C */
+#include <stddef.h>
+/* Postgres */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+
+/*****************************************************************************/
+
+/**
+ * @brief Global variables that keep the interrupt and progress callbacks
+ *
+ * Like the error handler, the callbacks are shared by all threads and are
+ * installed once before any worker thread calls into the library. They are
+ * accessed with atomic loads/stores so that a late installation is safely
+ * published to threads already running.
+ */
+static interrupt_callback_fn _interrupt_callback = NULL;
+static void *_interrupt_arg = NULL;
+static progress_callback_fn _progress_callback = NULL;
+static void *_progress_arg = NULL;
+
+/**
+ * Number of calls to #meos_interrupt_check between two polls of the
+ * interrupt callback, so that tight loops only pay a counter decrement
+ */
+#define MEOS_INTERRUPT_INTERVAL 1024
+
+/**
+ * @brief Thread-local countdown to the next poll of the interrupt callback
+ */
+static __thread uint32 _interrupt_countdown = MEOS_INTERRUPT_INTERVAL;
+
+/**
+ * @brief Install the callback polled by long operations to detect a
+ * cancellation request
+ * @param[in] callback Function returning true when the current operation
+ * must be abandoned, NULL to remove the current callback
+ * @param[in] arg Opaque argument passed to the callback
+ */
+void
+meos_initialize_interrupt_callback(interrupt_callback_fn callback, void *arg)
+{
+  __atomic_store_n(&_interrupt_arg, arg, __ATOMIC_RELEASE);
+  __atomic_store_n(&_interrupt_callback, callback, __ATOMIC_RELEASE);
+  return;
+}
+
+/**
+ * @brief Install the callback notified by long operations about their
+ * progress
+ * @param[in] callback Function receiving the progress as a fraction in
+ * [0, 1], NULL to remove the current callback
+ * @param[in] arg Opaque argument passed to the callback
+ */
+void
+meos_initialize_progress_callback(progress_callback_fn callback, void *arg)
+{
+  __atomic_store_n(&_progress_arg, arg, __ATOMIC_RELEASE);
+  __atomic_store_n(&_progress_callback, callback, __ATOMIC_RELEASE);
+  return;
+}
+
+/**
+ * @brief Return true if the current operation must be abandoned
+ *
+ * The function is meant to be called from the outer loops of long
+ * computations. The interrupt callback is polled once every
+ * #MEOS_INTERRUPT_INTERVAL calls; when it requests an interruption an
+ * error is raised and the caller must release its intermediate allocations
+ * and return its error result.
+ */
+bool
+meos_interrupt_check(void)
+{
+  if (--_interrupt_countdown > 0)
+    return false;
+  _interrupt_countdown = MEOS_INTERRUPT_INTERVAL;
+  interrupt_callback_fn callback =
+    __atomic_load_n(&_interrupt_callback, __ATOMIC_ACQUIRE);
+  if (! callback ||
+      ! callback(__atomic_load_n(&_interrupt_arg, __ATOMIC_ACQUIRE)))
+    return false;
+  meos_error(ERROR, MEOS_ERR_INTERRUPT,
+    "Operation canceled by the interrupt callback");
+  return true;
+}
+
+/**
+ * @brief Report the progress of the current operation to the progress
+ * callback, if any
+ * @param[in] progress Fraction of the operation completed, clamped to [0, 1]
+ */
+void
+meos_progress_report(double progress)
+{
+  progress_callback_fn callback =
+    __atomic_load_n(&_progress_callback, __ATOMIC_ACQUIRE);
+  if (! callback)
+    return;
+  if (progress < 0.0)
+    progress = 0.0;
+  else if (progress > 1.0)
+    progress = 1.0;
+  callback(progress, __atomic_load_n(&_progress_arg, __ATOMIC_ACQUIRE));
+  return;
+}
+
+/*****************************************************************************/
@@ -154,6 +154,7 @@
  */
 
 #include "general/lifting.h"
+#include "general/stats.h"
 
 /* C */
 #include <assert.h>
@@ -166,6 +167,85 @@
 #include "general/temporaltypes.h"
 #include "general/type_util.h"
 
+/* Thread-local scratch buffer storing the interleaved synchronized pairs of
+ * two sequences, reused across the pairs of sequences of an operation */
+static __thread TSyncPair *sync_pairs_buf = NULL;
+static __thread int sync_pairs_maxcount = 0;
+
+/*****************************************************************************
+ * Reusable scratch-buffer protocol
+ *****************************************************************************/
+
+/**
+ * @brief Opt the lifted function into the reusable scratch-buffer protocol
+ *
+ * The functions of this file build temporary instant arrays on every call.
+ * A caller evaluating the same lifted function over a batch of temporal
+ * values initializes the scratch buffer once, so the arrays are carved from
+ * a buffer reused across the calls and grown to its high-water size, and
+ * steady-state evaluation performs no allocations. The buffer must be
+ * released with #lfinfo_scratch_free after the batch; a zero-initialized
+ * #LiftedFunctionInfo keeps the previous allocate-per-call behavior.
+ */
+void
+lfinfo_scratch_init(LiftedFunctionInfo *lfinfo)
+{
+  lfinfo->scratchsize = 1024;
+  lfinfo->scratch = palloc(lfinfo->scratchsize);
+  return;
+}
+
+/**
+ * @brief Release the scratch buffer of a lifted function
+ */
+void
+lfinfo_scratch_free(LiftedFunctionInfo *lfinfo)
+{
+  if (lfinfo->scratch)
+    pfree(lfinfo->scratch);
+  lfinfo->scratch = NULL;
+  lfinfo->scratchsize = 0;
+  return;
+}
+
+/**
+ * @brief Return a temporary buffer of at least the given size
+ *
+ * When the scratch buffer is initialized it is returned, grown if too
+ * small; otherwise a fresh buffer is allocated and the paired
+ * #lfinfo_scratch_release frees it. At most one scratch buffer may be live
+ * at a time: functions needing several arrays carve them out of a single
+ * request.
+ */
+static void *
+lfinfo_scratch(LiftedFunctionInfo *lfinfo, size_t size)
+{
+  if (! lfinfo->scratch)
+    return palloc(size);
+  if (lfinfo->scratchsize < size)
+  {
+    size_t newsize = lfinfo->scratchsize;
+    while (newsize < size)
+      newsize *= 2;
+    /* The buffer holds no live data between requests */
+    pfree(lfinfo->scratch);
+    lfinfo->scratch = palloc(newsize);
+    lfinfo->scratchsize = newsize;
+  }
+  return lfinfo->scratch;
+}
+
+/**
+ * @brief Release a buffer returned by #lfinfo_scratch
+ */
+static void
+lfinfo_scratch_release(LiftedFunctionInfo *lfinfo, void *buf)
+{
+  if (buf != lfinfo->scratch)
+    pfree(buf);
+  return;
+}
+
 /*****************************************************************************
  * Functions where the argument is a temporal type.
  * The function is applied to the composing instants.
@@ -248,6 +328,7 @@ Temporal *
 tfunc_temporal(const Temporal *temp, LiftedFunctionInfo *lfinfo)
 {
   Temporal *result;
+  MEOS_STATS_INC(lifting_calls);
   assert(temptype_subtype(temp->subtype));
   if (temp->subtype == TINSTANT)
     result = (Temporal *) tfunc_tinstant((TInstant *) temp, lfinfo);
@@ -323,14 +404,20 @@ TSequence *
 tfunc_tsequence_base(const TSequence *seq, Datum value,
   LiftedFunctionInfo *lfinfo)
 {
-  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  TInstant **instants = lfinfo_scratch(lfinfo,
+    sizeof(TInstant *) * seq->count);
   for (int i = 0; i < seq->count; i++)
   {
     const TInstant *inst = TSEQUENCE_INST_N(seq, i);
     instants[i] = tfunc_tinstant_base(inst, value, lfinfo);
   }
-  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
-    seq->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
+  TSequence *result = tsequence_make((const TInstant **) instants,
+    seq->count, seq->period.lower_inc, seq->period.upper_inc,
+    MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
+  for (int i = 0; i < seq->count; i++)
+    pfree(instants[i]);
+  lfinfo_scratch_release(lfinfo, instants);
+  return result;
 }
 
 /**
@@ -347,7 +434,8 @@ tfunc_tlinearseq_base_turnpt(const TSequence *seq, Datum value,
   LiftedFunctionInfo *lfinfo, TSequence **result)
 {
   int ninsts = 0;
-  TInstant **instants = palloc(sizeof(TInstant *) * seq->count * 2);
+  TInstant **instants = lfinfo_scratch(lfinfo,
+    sizeof(TInstant *) * seq->count * 2);
   const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
   Datum value1 = tinstant_value(inst1);
   interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
@@ -374,8 +462,11 @@ tfunc_tlinearseq_base_turnpt(const TSequence *seq, Datum value,
     value1 = value2;
   }
   instants[ninsts++] = tfunc_tinstant_base(inst1, value, lfinfo);
-  result[0] = tsequence_make_free(instants, ninsts, seq->period.lower_inc,
-    seq->period.upper_inc, interp, NORMALIZE);
+  result[0] = tsequence_make((const TInstant **) instants, ninsts,
+    seq->period.lower_inc, seq->period.upper_inc, interp, NORMALIZE);
+  for (int i = 0; i < ninsts; i++)
+    pfree(instants[i]);
+  lfinfo_scratch_release(lfinfo, instants);
   return 1;
 }
 
@@ -402,7 +493,8 @@ tfunc_tlinearseq_base_discfn(const TSequence *seq, Datum value,
   const TInstant *start = TSEQUENCE_INST_N(seq, 0);
   Datum startvalue = tinstant_value(start);
   Datum startresult = tfunc_base_base(startvalue, value, lfinfo);
-  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  TInstant **instants = lfinfo_scratch(lfinfo,
+    sizeof(TInstant *) * seq->count);
 
   /* Instantaneous sequence */
   if (seq->count == 1)
@@ -410,6 +502,7 @@ tfunc_tlinearseq_base_discfn(const TSequence *seq, Datum value,
     instants[0] = tinstant_make(startresult, lfinfo->restype, start->t);
     result[0] = tinstant_to_tsequence(instants[0], STEP);
     pfree(instants[0]);
+    lfinfo_scratch_release(lfinfo, instants);
     return 1;
   }
 
@@ -538,10 +631,14 @@ tfunc_tlinearseq_base_discfn(const TSequence *seq, Datum value,
     startresult = endresult;
   }
   if (ninsts > 0)
+  {
     result[nseqs++] = tsequence_make((const TInstant **) instants, ninsts,
       (ninsts == 1) ? true : lower_inc,
       (ninsts == 1) ? true : seq->period.upper_inc, STEP, NORMALIZE);
-  pfree(instants);
+    for (int j = 0; j < ninsts; j++)
+      pfree(instants[j]);
+  }
+  lfinfo_scratch_release(lfinfo, instants);
   return nseqs;
 }
 
@@ -623,6 +720,7 @@ tfunc_temporal_base(const Temporal *temp, Datum value,
   LiftedFunctionInfo *lfinfo)
 {
   Temporal *result;
+  MEOS_STATS_INC(lifting_calls);
   assert(temptype_subtype(temp->subtype));
   if (temp->subtype == TINSTANT)
     result = (Temporal *) tfunc_tinstant_base((TInstant *) temp, value, lfinfo);
@@ -636,6 +734,77 @@ tfunc_temporal_base(const Temporal *temp, Datum value,
   return result;
 }
 
+/**
+ * @brief Apply a lifted function to an array of temporal values and a base
+ * value
+ *
+ * Evaluating the same lifted function over many temporal values one call at
+ * a time redoes the subtype dispatch and the result array allocation per
+ * value. This function shares that setup across the whole batch: the
+ * dispatch is hoisted out of the loop for arrays where all elements have
+ * the same subtype and interpolation, which is the common case when the
+ * values come from one column.
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[in] value Base value
+ * @param[in] lfinfo Information about the lifted function
+ * @return Array of temporal values, with a NULL element where the function
+ * had an empty result
+ */
+Temporal **
+tfunc_temporal_base_batch(const Temporal **temparr, int count, Datum value,
+  LiftedFunctionInfo *lfinfo)
+{
+  assert(temparr); assert(count > 0);
+  Temporal **result = palloc(sizeof(Temporal *) * count);
+  /* Reuse one scratch buffer across the calls of the batch unless the
+   * caller already provided one */
+  bool ownscratch = (lfinfo->scratch == NULL);
+  if (ownscratch)
+    lfinfo_scratch_init(lfinfo);
+  /* Determine whether all elements share the subtype and interpolation */
+  uint8 subtype = temparr[0]->subtype;
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(temparr[0]->flags);
+  bool homogeneous = true;
+  for (int i = 1; i < count; i++)
+  {
+    if (temparr[i]->subtype != subtype ||
+        MEOS_FLAGS_LINEAR_INTERP(temparr[i]->flags) != linear)
+    {
+      homogeneous = false;
+      break;
+    }
+  }
+  if (! homogeneous)
+  {
+    /* Mixed input: dispatch per element */
+    for (int i = 0; i < count; i++)
+      result[i] = tfunc_temporal_base(temparr[i], value, lfinfo);
+    if (ownscratch)
+      lfinfo_scratch_free(lfinfo);
+    return result;
+  }
+  if (subtype == TINSTANT)
+    for (int i = 0; i < count; i++)
+      result[i] = (Temporal *) tfunc_tinstant_base((TInstant *) temparr[i],
+        value, lfinfo);
+  else if (subtype == TSEQUENCE && ! linear)
+    for (int i = 0; i < count; i++)
+      result[i] = (Temporal *) tfunc_tsequence_base((TSequence *) temparr[i],
+        value, lfinfo);
+  else if (subtype == TSEQUENCE)
+    for (int i = 0; i < count; i++)
+      result[i] = (Temporal *) tfunc_tlinearseq_base((TSequence *) temparr[i],
+        value, lfinfo);
+  else /* subtype == TSEQUENCESET */
+    for (int i = 0; i < count; i++)
+      result[i] = (Temporal *) tfunc_tsequenceset_base(
+        (TSequenceSet *) temparr[i], value, lfinfo);
+  if (ownscratch)
+    lfinfo_scratch_free(lfinfo);
+  return result;
+}
+
 /*****************************************************************************
  * Functions that synchronize two temporal values and apply a function in
  * a single pass.
@@ -955,6 +1124,42 @@ tfunc_tcontseq_tcontseq_single(const TSequence *seq1, const TSequence *seq2,
    * where S, T, and * are values computed, respectively, at the
    * Synchronization points, optional Turning points, and common points
    */
+  /* When the lifted function has no turning points and the base values are
+   * passed by value, stream the synchronized pairs from a single interleaved
+   * scratch buffer instead of alternating between the two instant arrays */
+  if (lfinfo->tpfunc == NULL &&
+      basetype_byvalue(temptype_basetype(seq1->temptype)) &&
+      basetype_byvalue(temptype_basetype(seq2->temptype)))
+  {
+    int npairs = tsequence_sync_pairs(seq1, seq2, false, &sync_pairs_buf,
+      &sync_pairs_maxcount);
+    /* We are sure that npairs != 0 due to the period intersection test */
+    TInstant **instants1 = palloc(sizeof(TInstant *) * npairs);
+    meosType restype = temptype_basetype(lfinfo->restype);
+    for (int k = 0; k < npairs; k++)
+    {
+      Datum resvalue = tfunc_base_base(sync_pairs_buf[k].value1,
+        sync_pairs_buf[k].value2, lfinfo);
+      instants1[k] = tinstant_make(resvalue, lfinfo->restype,
+        sync_pairs_buf[k].t);
+      DATUM_FREE(resvalue, restype);
+    }
+    /* The last two values of sequences with step interpolation and
+       exclusive upper bound must be equal */
+    if (! lfinfo->reslinear && ! inter->upper_inc && npairs > 1)
+    {
+      TInstant *last = instants1[npairs - 1];
+      instants1[npairs - 1] = tinstant_make(
+        tinstant_value(instants1[npairs - 2]), lfinfo->restype, last->t);
+      pfree(last);
+    }
+    interpType interp1 = Min(MEOS_FLAGS_GET_INTERP(seq1->flags),
+      MEOS_FLAGS_GET_INTERP(seq2->flags));
+    result[0] = tsequence_make_free(instants1, npairs, inter->lower_inc,
+      inter->upper_inc, interp1, NORMALIZE);
+    return 1;
+  }
+
   TInstant *inst1 = (TInstant *) TSEQUENCE_INST_N(seq1, 0);
   TInstant *inst2 = (TInstant *) TSEQUENCE_INST_N(seq2, 0);
   TInstant *prev1 = NULL, *prev2 = NULL; /* make compiler quiet */
@@ -972,8 +1177,11 @@ tfunc_tcontseq_tcontseq_single(const TSequence *seq1, const TSequence *seq2,
     inst2 = (TInstant *) TSEQUENCE_INST_N(seq2, j);
   }
   int count = (seq1->count - i + seq2->count - j) * 2;
-  TInstant **instants = palloc(sizeof(TInstant *) * count);
-  TInstant **tofree = palloc(sizeof(TInstant *) * count);
+  /* The new instants and the instants added for the synchronization are
+   * carved out of a single scratch request */
+  TInstant **instants = lfinfo_scratch(lfinfo,
+    sizeof(TInstant *) * count * 2);
+  TInstant **tofree = instants + count;
   Datum value;
   meosType resbasetype = temptype_basetype(lfinfo->restype);
   while (i < seq1->count && j < seq2->count &&
@@ -1033,11 +1241,15 @@ tfunc_tcontseq_tcontseq_single(const TSequence *seq1, const TSequence *seq2,
       instants[ninsts - 1]->t);
     /* We cannot DATUM_FREE(value, lfinfo->restype); */
   }
-  pfree_array((void **) tofree, nfree);
+  for (int k = 0; k < nfree; k++)
+    pfree(tofree[k]);
   interpType interp = Min(MEOS_FLAGS_GET_INTERP(seq1->flags),
     MEOS_FLAGS_GET_INTERP(seq2->flags));
-  result[0] = tsequence_make_free(instants, ninsts, inter->lower_inc,
-    inter->upper_inc, interp, NORMALIZE);
+  result[0] = tsequence_make((const TInstant **) instants, ninsts,
+    inter->lower_inc, inter->upper_inc, interp, NORMALIZE);
+  for (int k = 0; k < ninsts; k++)
+    pfree(instants[k]);
+  lfinfo_scratch_release(lfinfo, instants);
   return 1;
 }
 
@@ -1061,10 +1273,11 @@ tfunc_tcontseq_tcontseq_discfn(const TSequence *seq1, const TSequence *seq2,
 {
   assert(seq1->temptype == seq2->temptype);
   int count = seq1->count + seq2->count;
-  /* Array that keeps the new instants to be accumulated */
-  TInstant **instants = palloc(sizeof(TInstant *) * count);
-  /* Array that keeps the new instants added for the synchronization */
-  TInstant **tofree = palloc(sizeof(TInstant *) * count);
+  /* The new instants to be accumulated and the instants added for the
+   * synchronization are carved out of a single scratch request */
+  TInstant **instants = lfinfo_scratch(lfinfo,
+    sizeof(TInstant *) * count * 2);
+  TInstant **tofree = instants + count;
   interpType interp1 = MEOS_FLAGS_GET_INTERP(seq1->flags);
   interpType interp2 = MEOS_FLAGS_GET_INTERP(seq2->flags);
   meosType basetype = temptype_basetype(seq1->temptype);
@@ -1236,7 +1449,11 @@ tfunc_tcontseq_tcontseq_discfn(const TSequence *seq1, const TSequence *seq2,
     (ninsts == 1) ? true : lower_inc,
     (ninsts == 1) ? true : inter->upper_inc, interp, NORMALIZE);
   DATUM_FREE(startresult, resbasetype);
-  pfree(instants);
+  for (int k = 0; k < ninsts; k++)
+    pfree(instants[k]);
+  for (int k = 0; k < nfree; k++)
+    pfree(tofree[k]);
+  lfinfo_scratch_release(lfinfo, instants);
   return nseqs;
 }
 
@@ -1252,11 +1469,11 @@ tfunc_tlinearseq_tstepseq(const TSequence *seq1, const TSequence *seq2,
   interpType interp1 = MEOS_FLAGS_GET_INTERP(seq1->flags);
   interpType interp2 = MEOS_FLAGS_GET_INTERP(seq2->flags);
   assert(interp1 != interp2);
-  /* Array that keeps the new instants to be accumulated */
-  TInstant **instants = palloc(sizeof(TInstant *) * seq1->count);
-  /* Array that keeps the new instants added for synchronization */
-  TInstant **tofree = palloc(sizeof(TInstant *) *
-    (seq1->count + seq2->count) * 2);
+  /* The new instants to be accumulated and the instants added for the
+   * synchronization are carved out of a single scratch request */
+  TInstant **instants = lfinfo_scratch(lfinfo, sizeof(TInstant *) *
+    (seq1->count + (seq1->count + seq2->count) * 2));
+  TInstant **tofree = instants + seq1->count;
   TInstant *start1 = (TInstant *) TSEQUENCE_INST_N(seq1, 0);
   TInstant *start2 = (TInstant *) TSEQUENCE_INST_N(seq2, 0);
   int i = 1, j = 1, nfree = 0, ninsts = 0, nseqs = 0;
@@ -1336,11 +1553,16 @@ tfunc_tlinearseq_tstepseq(const TSequence *seq1, const TSequence *seq2,
     instants[ninsts++] = tinstant_make(startresult, restype, start1->t);
   DATUM_FREE(startresult, resbasetype);
   if (ninsts > 0)
+  {
     result[nseqs++] = tsequence_make((const TInstant **) instants, ninsts,
       (ninsts == 1) ? true : lower_inc, (ninsts == 1) ? true : inter->upper_inc,
       LINEAR, NORMALIZE);
-  pfree_array((void **) tofree, nfree);
-  pfree(instants);
+    for (int k = 0; k < ninsts; k++)
+      pfree(instants[k]);
+  }
+  for (int k = 0; k < nfree; k++)
+    pfree(tofree[k]);
+  lfinfo_scratch_release(lfinfo, instants);
   return nseqs;
 }
 
@@ -1543,6 +1765,8 @@ Temporal *
 tfunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
   LiftedFunctionInfo *lfinfo)
 {
+  MEOS_STATS_INC(lifting_calls);
+
   /* Bounding box test */
   Span p1, p2;
   temporal_set_period(temp1, &p1);
@@ -112,61 +112,100 @@ const char *_meosType_names[] =
 };
 
 /**
- * @brief Global array that keeps type information for the temporal types
- */
-temptype_catalog_struct _temptype_catalog[] =
-{
-  /* temptype    basetype */
-  {T_TDOUBLE2,   T_DOUBLE2},
-  {T_TDOUBLE3,   T_DOUBLE3},
-  {T_TDOUBLE4,   T_DOUBLE4},
-  {T_TBOOL,      T_BOOL},
-  {T_TINT,       T_INT4},
-  {T_TFLOAT,     T_FLOAT8},
-  {T_TTEXT,      T_TEXT},
-  {T_TGEOMPOINT, T_GEOMETRY},
-  {T_TGEOGPOINT, T_GEOGRAPHY},
-  {T_TNPOINT,    T_NPOINT},
+ * @brief Global array that maps a temporal type to its base type
+ *
+ * The arrays below are direct-index lookup tables: since meosType is a small
+ * dense enumeration, the answer for a type is stored at the slot of its enum
+ * value and a lookup is a single array load. Slots that are not filled by a
+ * designated initializer default to 0, that is, to T_UNKNOWN, which signals
+ * that the argument is not of the expected type class.
+ */
+static const meosType _temptype_basetype[NO_MEOS_TYPES] =
+{
+  [T_TDOUBLE2]   = T_DOUBLE2,
+  [T_TDOUBLE3]   = T_DOUBLE3,
+  [T_TDOUBLE4]   = T_DOUBLE4,
+  [T_TBOOL]      = T_BOOL,
+  [T_TINT]       = T_INT4,
+  [T_TFLOAT]     = T_FLOAT8,
+  [T_TTEXT]      = T_TEXT,
+  [T_TGEOMPOINT] = T_GEOMETRY,
+  [T_TGEOGPOINT] = T_GEOGRAPHY,
+  [T_TNPOINT]    = T_NPOINT,
+};
+
+/**
+ * @brief Global array that maps a set type to its base type
+ */
+static const meosType _settype_basetype[NO_MEOS_TYPES] =
+{
+  [T_INTSET]    = T_INT4,
+  [T_BIGINTSET] = T_INT8,
+  [T_FLOATSET]  = T_FLOAT8,
+  [T_TSTZSET]   = T_TIMESTAMPTZ,
+  [T_TEXTSET]   = T_TEXT,
+  [T_GEOMSET]   = T_GEOMETRY,
+  [T_GEOGSET]   = T_GEOGRAPHY,
+  [T_NPOINTSET] = T_NPOINT,
 };
 
 /**
- * @brief Global array that keeps type information for the set types defined
+ * @brief Global array that maps a base type to its set type
  */
-settype_catalog_struct _settype_catalog[] =
+static const meosType _basetype_settype[NO_MEOS_TYPES] =
 {
-  /* settype        basetype */
-  {T_INTSET,        T_INT4},
-  {T_BIGINTSET,     T_INT8},
-  {T_FLOATSET,      T_FLOAT8},
-  {T_TSTZSET,       T_TIMESTAMPTZ},
-  {T_TEXTSET,       T_TEXT},
-  {T_GEOMSET,       T_GEOMETRY},
-  {T_GEOGSET,       T_GEOGRAPHY},
-  {T_NPOINTSET,     T_NPOINT},
+  [T_INT4]        = T_INTSET,
+  [T_INT8]        = T_BIGINTSET,
+  [T_FLOAT8]      = T_FLOATSET,
+  [T_TIMESTAMPTZ] = T_TSTZSET,
+  [T_TEXT]        = T_TEXTSET,
+  [T_GEOMETRY]    = T_GEOMSET,
+  [T_GEOGRAPHY]   = T_GEOGSET,
+  [T_NPOINT]      = T_NPOINTSET,
 };
 
 /**
- * @brief Global array that keeps type information for the span types defined
+ * @brief Global array that maps a span type to its base type
  */
-spantype_catalog_struct _spantype_catalog[] =
+static const meosType _spantype_basetype[NO_MEOS_TYPES] =
 {
-  /* spantype       basetype */
-  {T_INTSPAN,       T_INT4},
-  {T_BIGINTSPAN,    T_INT8},
-  {T_FLOATSPAN,     T_FLOAT8},
-  {T_TSTZSPAN,      T_TIMESTAMPTZ},
+  [T_INTSPAN]    = T_INT4,
+  [T_BIGINTSPAN] = T_INT8,
+  [T_FLOATSPAN]  = T_FLOAT8,
+  [T_TSTZSPAN]   = T_TIMESTAMPTZ,
 };
 
 /**
- * @brief Global array that keeps type information for the span set types defined
+ * @brief Global array that maps a base type to its span type
  */
-spansettype_catalog_struct _spansettype_catalog[] =
+static const meosType _basetype_spantype[NO_MEOS_TYPES] =
 {
-  /* spansettype    spantype */
-  {T_INTSPANSET,    T_INTSPAN},
-  {T_BIGINTSPANSET, T_BIGINTSPAN},
-  {T_FLOATSPANSET,  T_FLOATSPAN},
-  {T_TSTZSPANSET,   T_TSTZSPAN},
+  [T_INT4]        = T_INTSPAN,
+  [T_INT8]        = T_BIGINTSPAN,
+  [T_FLOAT8]      = T_FLOATSPAN,
+  [T_TIMESTAMPTZ] = T_TSTZSPAN,
+};
+
+/**
+ * @brief Global array that maps a span set type to its span type
+ */
+static const meosType _spansettype_spantype[NO_MEOS_TYPES] =
+{
+  [T_INTSPANSET]    = T_INTSPAN,
+  [T_BIGINTSPANSET] = T_BIGINTSPAN,
+  [T_FLOATSPANSET]  = T_FLOATSPAN,
+  [T_TSTZSPANSET]   = T_TSTZSPAN,
+};
+
+/**
+ * @brief Global array that maps a span type to its span set type
+ */
+static const meosType _spantype_spansettype[NO_MEOS_TYPES] =
+{
+  [T_INTSPAN]    = T_INTSPANSET,
+  [T_BIGINTSPAN] = T_BIGINTSPANSET,
+  [T_FLOATSPAN]  = T_FLOATSPANSET,
+  [T_TSTZSPAN]   = T_TSTZSPANSET,
 };
 
 /*****************************************************************************
@@ -188,16 +227,13 @@ meostype_name(meosType type)
 meosType
 temptype_basetype(meosType temptype)
 {
-  int n = sizeof(_temptype_catalog) / sizeof(temptype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (_temptype_catalog[i].temptype == temptype)
-      return _temptype_catalog[i].basetype;
-  }
-  /* We only arrive here on error */
-  meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-    "type %u is not a temporal type", temptype);
-  return T_UNKNOWN;
+  meosType result = T_UNKNOWN;
+  if (temptype >= 0 && temptype < NO_MEOS_TYPES)
+    result = _temptype_basetype[temptype];
+  if (result == T_UNKNOWN)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "type %u is not a temporal type", temptype);
+  return result;
 }
 
 /**
@@ -206,16 +242,13 @@ temptype_basetype(meosType temptype)
 meosType
 spantype_basetype(meosType spantype)
 {
-  int n = sizeof(_spantype_catalog) / sizeof(spantype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (_spantype_catalog[i].spantype == spantype)
-      return _spantype_catalog[i].basetype;
-  }
-  /* We only arrive here on error */
-  meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-    "type %u is not a span type", spantype);
-  return T_UNKNOWN;
+  meosType result = T_UNKNOWN;
+  if (spantype >= 0 && spantype < NO_MEOS_TYPES)
+    result = _spantype_basetype[spantype];
+  if (result == T_UNKNOWN)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "type %u is not a span type", spantype);
+  return result;
 }
 
 /**
@@ -224,16 +257,13 @@ spantype_basetype(meosType spantype)
 meosType
 spansettype_spantype(meosType spansettype)
 {
-  int n = sizeof(_spansettype_catalog) / sizeof(spansettype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (_spansettype_catalog[i].spansettype == spansettype)
-      return _spansettype_catalog[i].spantype;
-  }
-  /* We only arrive here on error */
-  meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-    "type %u is not a span set type", spansettype);
-  return T_UNKNOWN;
+  meosType result = T_UNKNOWN;
+  if (spansettype >= 0 && spansettype < NO_MEOS_TYPES)
+    result = _spansettype_spantype[spansettype];
+  if (result == T_UNKNOWN)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "type %u is not a span set type", spansettype);
+  return result;
 }
 
 /**
@@ -242,16 +272,13 @@ spansettype_spantype(meosType spansettype)
 meosType
 basetype_spantype(meosType basetype)
 {
-  int n = sizeof(_spantype_catalog) / sizeof(spantype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (_spantype_catalog[i].basetype == basetype)
-      return _spantype_catalog[i].spantype;
-  }
-  /* We only arrive here on error */
-  meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-    "type %u is not a span type", basetype);
-  return T_UNKNOWN;
+  meosType result = T_UNKNOWN;
+  if (basetype >= 0 && basetype < NO_MEOS_TYPES)
+    result = _basetype_spantype[basetype];
+  if (result == T_UNKNOWN)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "type %u is not a span type", basetype);
+  return result;
 }
 
 /**
@@ -260,16 +287,13 @@ basetype_spantype(meosType basetype)
 meosType
 spantype_spansettype(meosType spantype)
 {
-  int n = sizeof(_spansettype_catalog) / sizeof(spansettype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (_spansettype_catalog[i].spantype == spantype)
-      return _spansettype_catalog[i].spansettype;
-  }
-  /* We only arrive here on error */
-  meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-    "type %u is not a span type", spantype);
-  return T_UNKNOWN;
+  meosType result = T_UNKNOWN;
+  if (spantype >= 0 && spantype < NO_MEOS_TYPES)
+    result = _spantype_spansettype[spantype];
+  if (result == T_UNKNOWN)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "type %u is not a span type", spantype);
+  return result;
 }
 
 /**
@@ -278,16 +302,13 @@ spantype_spansettype(meosType spantype)
 meosType
 settype_basetype(meosType settype)
 {
-  int n = sizeof(_settype_catalog) / sizeof(settype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (_settype_catalog[i].settype == settype)
-      return _settype_catalog[i].basetype;
-  }
-  /* We only arrive here on error */
-  meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-    "type %u is not a set type", settype);
-  return T_UNKNOWN;
+  meosType result = T_UNKNOWN;
+  if (settype >= 0 && settype < NO_MEOS_TYPES)
+    result = _settype_basetype[settype];
+  if (result == T_UNKNOWN)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "type %u is not a set type", settype);
+  return result;
 }
 
 /**
@@ -296,16 +317,13 @@ settype_basetype(meosType settype)
 meosType
 basetype_settype(meosType basetype)
 {
-  int n = sizeof(_settype_catalog) / sizeof(settype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (_settype_catalog[i].basetype == basetype)
-      return _settype_catalog[i].settype;
-  }
-  /* We only arrive here on error */
-  meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-    "type %u is not a set type", basetype);
-  return T_UNKNOWN;
+  meosType result = T_UNKNOWN;
+  if (basetype >= 0 && basetype < NO_MEOS_TYPES)
+    result = _basetype_settype[basetype];
+  if (result == T_UNKNOWN)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "type %u is not a set type", basetype);
+  return result;
 }
 
 /*****************************************************************************
@@ -257,11 +257,24 @@ char *
 bool_out(bool b)
 {
   char *result = palloc(2);
-  result[0] = (b) ? 't' : 'f';
-  result[1] = '\0';
+  bool_out_buf(b, result);
   return result;
 }
 
+/**
+ * @ingroup libmeos_pg_types
+ * @brief Write "t" or "f" into the buffer
+ * @return Number of characters written, not including the terminating NUL
+ * @note The buffer must be at least 2 bytes long
+ */
+int
+bool_out_buf(bool b, char *buf)
+{
+  buf[0] = (b) ? 't' : 'f';
+  buf[1] = '\0';
+  return 1;
+}
+
 /*****************************************************************************
  * Functions adapted from int.c
  *****************************************************************************/
@@ -313,12 +326,23 @@ char *
 int4_out(int32 val)
 {
   char *result = palloc(12);  /* sign, 10 digits, '\0' */
+  int4_out_buf(val, result);
+  return result;
+}
+
+/**
+ * @brief Write the string representation of an int4 into the buffer
+ * @return Number of characters written, not including the terminating NUL
+ * @note The buffer must be at least 12 bytes long: sign, 10 digits, '\0'
+ */
+int
+int4_out_buf(int32 val, char *buf)
+{
 #if POSTGRESQL_VERSION_NUMBER >= 130000
-  mobdb_ltoa(val, result);
+  return mobdb_ltoa(val, buf);
 #else
-  sprintf(result, "%d", val);
+  return sprintf(buf, "%d", val);
 #endif
-  return result;
 }
 
 /*****************************************************************************
@@ -381,21 +405,30 @@ mobdb_lltoa(int64 value, char *a)
 char *
 int8_out(int64 val)
 {
-  char *result;
-#if POSTGRESQL_VERSION_NUMBER >= 130000
   char buf[MAXINT8LEN + 1];
-  int len = mobdb_lltoa(val, buf) + 1;
+  int len = int8_out_buf(val, buf) + 1;
   /*
    * Since the length is already known, we do a manual palloc() and memcpy()
    * to avoid the strlen() call that would otherwise be done in pstrdup().
    */
-  result = palloc(len);
+  char *result = palloc(len);
   memcpy(result, buf, len);
+  return result;
+}
+
+/**
+ * @brief Write the string representation of an int8 into the buffer
+ * @return Number of characters written, not including the terminating NUL
+ * @note The buffer must be at least MAXINT8LEN + 1 bytes long
+ */
+int
+int8_out_buf(int64 val, char *buf)
+{
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  return mobdb_lltoa(val, buf);
 #else
-  result = palloc(MAXINT8LEN + 1);
-  sprintf(result, "%ld", val);
+  return sprintf(buf, "%ld", val);
 #endif
-  return result;
 }
 
 /*****************************************************************************
@@ -561,6 +594,19 @@ float8_out(double num, int maxdd)
   return ascii;
 }
 
+/**
+ * @brief Write the string representation of a float8 into the buffer using at
+ * most **maxdd** decimal digits
+ * @return Number of characters written, not including the terminating NUL
+ * @note The buffer must be at least OUT_DOUBLE_BUFFER_SIZE bytes long
+ */
+int
+float8_out_buf(double num, int maxdd, char *buf)
+{
+  assert(maxdd >= 0);
+  return lwprint_double(num, maxdd, buf);
+}
+
 /**
  * @brief Return the sine of arg1 (radians)
  * @return On error return DBL_MAX
@@ -1121,20 +1167,39 @@ pg_timestamptz_out(TimestampTz dt)
   char *result = DatumGetCString(call_function1(timestamptz_out, d));
   return result;
 }
+
+/**
+ * @brief Write the string representation of a timestamp with timezone into
+ * the buffer
+ * @return Number of characters written, not including the terminating NUL,
+ * or -1 on error
+ * @note The buffer must be at least MAXDATELEN + 1 bytes long
+ */
+int
+pg_timestamptz_out_buf(TimestampTz dt, char *buf)
+{
+  char *str = pg_timestamptz_out(dt);
+  int len = (int) strlen(str);
+  memcpy(buf, str, len + 1);
+  pfree(str);
+  return len;
+}
 #else
 /**
- * @brief Convert either a timestamp or a timestamp to a string.
+ * @brief Write the string representation of either a timestamp or a
+ * timestamptz into the buffer
+ * @return Number of characters written, not including the terminating NUL,
+ * or -1 on error
+ * @note The buffer must be at least MAXDATELEN + 1 bytes long
  */
-char *
-timestamp_out_common(TimestampTz dt, bool withtz)
+static int
+timestamp_out_common_buf(TimestampTz dt, bool withtz, char *buf)
 {
-  char *result;
   int tz;
   struct pg_tm tt,
          *tm = &tt;
   fsec_t fsec;
   const char *tzn;
-  char buf[MAXDATELEN + 1];
 
   if (TIMESTAMP_NOT_FINITE(dt))
     EncodeSpecialTimestamp(dt, buf);
@@ -1145,11 +1210,35 @@ timestamp_out_common(TimestampTz dt, bool withtz)
   else
   {
     meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE, "timestamp out of range");
-    return NULL;
+    return -1;
   }
+  return (int) strlen(buf);
+}
 
-  result = pstrdup(buf);
-  return result;
+/**
+ * @brief Convert either a timestamp or a timestamp to a string.
+ */
+char *
+timestamp_out_common(TimestampTz dt, bool withtz)
+{
+  char buf[MAXDATELEN + 1];
+  if (timestamp_out_common_buf(dt, withtz, buf) < 0)
+    return NULL;
+  return pstrdup(buf);
+}
+
+/**
+ * @ingroup libmeos_pg_types
+ * @brief Write the string representation of a timestamp with timezone into
+ * the buffer
+ * @return Number of characters written, not including the terminating NUL,
+ * or -1 on error
+ * @note The buffer must be at least MAXDATELEN + 1 bytes long
+ */
+int
+pg_timestamptz_out_buf(TimestampTz dt, char *buf)
+{
+  return timestamp_out_common_buf(dt, true, buf);
 }
 
 /**
@@ -1173,6 +1262,155 @@ pg_timestamp_out(Timestamp dt)
 {
   return timestamp_out_common((Timestamp) dt, false);
 }
+
+/*****************************************************************************/
+
+/**
+ * @brief Timezone window used for batch timestamp output
+ *
+ * The GMT offset, the DST flag, and the zone abbreviation of the session
+ * timezone are constant between two DST transitions. The window caches them
+ * together with the transition boundaries so that a batch of timestamps pays
+ * the timezone lookup once per transition crossed instead of once per value.
+ */
+typedef struct
+{
+  bool valid;       /**< True when the fields below are set */
+  pg_time_t lower;  /**< First Unix second covered by the window */
+  pg_time_t upper;  /**< First Unix second past the window */
+  bool has_upper;   /**< False when the zone has no further transitions */
+  long int gmtoff;  /**< GMT offset of the window, positive east */
+  int isdst;        /**< DST flag of the window */
+  const char *tzn;  /**< Zone abbreviation of the window */
+} TzOutWindow;
+
+/**
+ * @brief Write the string representation of a timestamp with timezone into
+ * the buffer, resolving the timezone through the window
+ * @return Number of characters written, not including the terminating NUL,
+ * or -1 on error
+ */
+static int
+timestamptz_out_window_buf(TimestampTz dt, TzOutWindow *win, char *buf)
+{
+  if (TIMESTAMP_NOT_FINITE(dt))
+  {
+    EncodeSpecialTimestamp(dt, buf);
+    return (int) strlen(buf);
+  }
+
+  /* Unix second containing the timestamp, rounding towards minus infinity */
+  Timestamp sec = dt / USECS_PER_SEC;
+  if (dt % USECS_PER_SEC < 0)
+    sec -= 1;
+  pg_time_t utime = (pg_time_t)
+    (sec + (POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE) * SECS_PER_DAY);
+
+  if (! win->valid || utime < win->lower ||
+      (win->has_upper && utime >= win->upper))
+  {
+    /* (Re)compute the window containing the timestamp */
+    long int after_gmtoff;
+    int after_isdst;
+    pg_time_t boundary;
+    int res = pg_next_dst_boundary(&utime, &win->gmtoff, &win->isdst,
+      &boundary, &after_gmtoff, &after_isdst, session_timezone);
+    struct pg_tm *tx = (res >= 0) ?
+      pg_localtime(&utime, session_timezone) : NULL;
+    if (tx == NULL)
+      /* Out of range of the timezone data, let timestamp2tm sort it out */
+      return timestamp_out_common_buf(dt, true, buf);
+    win->lower = utime;
+    win->upper = boundary;
+    win->has_upper = (res > 0);
+    win->tzn = tx->tm_zone;
+    win->valid = true;
+  }
+
+  /* Rotate to local time and run the cheap timezone-less conversion */
+  struct pg_tm tt, *tm = &tt;
+  fsec_t fsec;
+  Timestamp shift = (Timestamp) win->gmtoff * USECS_PER_SEC;
+  if ((shift > 0 && dt > PG_INT64_MAX - shift) ||
+      (shift < 0 && dt < PG_INT64_MIN - shift) ||
+      timestamp2tm(dt + shift, NULL, tm, &fsec, NULL, NULL) != 0)
+  {
+    meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE, "timestamp out of range");
+    return -1;
+  }
+  tm->tm_isdst = win->isdst;
+  tm->tm_gmtoff = win->gmtoff;
+  tm->tm_zone = win->tzn;
+  EncodeDateTime(tm, fsec, true, (int) -win->gmtoff, win->tzn, DateStyle,
+    buf);
+  return (int) strlen(buf);
+}
+
+/**
+ * @ingroup libmeos_pg_types
+ * @brief Write the string representations of an array of timestamps with
+ * timezone into the buffer
+ *
+ * The session timezone is resolved once per DST window crossed by the batch
+ * instead of once per value, which removes the dominant cost of the text
+ * export of long timestamp sequences.
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the array
+ * @param[out] buf Buffer of at least @p count * (MAXDATELEN + 1) bytes; the
+ * string of the i-th timestamp starts at offset i * (MAXDATELEN + 1)
+ * @return Number of timestamps written, or -1 on error
+ */
+int
+pg_timestamptz_out_batch_buf(const TimestampTz *times, int count, char *buf)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) times) || ! ensure_not_null((void *) buf) ||
+      ! ensure_positive(count))
+    return -1;
+
+  TzOutWindow win;
+  win.valid = false;
+  for (int i = 0; i < count; i++)
+  {
+    if (timestamptz_out_window_buf(times[i], &win,
+        buf + (size_t) i * (MAXDATELEN + 1)) < 0)
+      return -1;
+  }
+  return count;
+}
+
+/**
+ * @ingroup libmeos_pg_types
+ * @brief Convert an array of timestamps with timezone to strings
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the array
+ * @return Array of strings, one per timestamp; on error return @p NULL
+ * @see #pg_timestamptz_out_batch_buf
+ */
+char **
+pg_timestamptz_out_batch(const TimestampTz *times, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) times) || ! ensure_positive(count))
+    return NULL;
+
+  char buf[MAXDATELEN + 1];
+  TzOutWindow win;
+  win.valid = false;
+  char **result = palloc(sizeof(char *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    if (timestamptz_out_window_buf(times[i], &win, buf) < 0)
+    {
+      for (int j = 0; j < i; j++)
+        pfree(result[j]);
+      pfree(result);
+      return NULL;
+    }
+    result[i] = pstrdup(buf);
+  }
+  return result;
+}
 #endif /* MEOS */
 
 /*****************************************************************************/
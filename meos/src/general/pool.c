@@ -0,0 +1,389 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Internal thread pool for library-level parallelism in MEOS
+ *
+ * In library mode MEOS is single-threaded and standalone analytics programs
+ * must shard their data by process to exploit several cores. The pool
+ * started with #meos_initialize_pool keeps a set of worker threads that
+ * parallel-capable entry points hand loops to with #meos_pool_parallel_for.
+ *
+ * The iteration space of a loop is split into one contiguous slice per
+ * participant (the workers plus the calling thread). A participant that
+ * exhausts its slice steals the upper half of the largest remaining slice,
+ * so unbalanced loops — e.g., restricting sequences of very different
+ * lengths — still finish together without a shared counter on the fast
+ * path.
+ *
+ * Tasks run on worker threads and therefore must not rely on thread-local
+ * or global mutable state. In particular, #meos_pool_parallel_for falls
+ * back to serial execution while an arena is active, since arena
+ * allocation is not thread-safe, as well as for nested parallel loops.
+ */
+
+/* C */
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+/* Postgres */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include "general/pool.h"
+
+/*****************************************************************************/
+
+/** Maximum number of worker threads of the pool */
+#define MEOS_POOL_MAXTHREADS 64
+
+/**
+ * @brief Slice of the iteration space owned by one participant
+ *
+ * The slice is protected by its own lock so that idle participants can
+ * steal from it; the owner only holds the lock long enough to take the
+ * next index.
+ */
+typedef struct MeosPoolSlice
+{
+  pthread_mutex_t lock;   /**< Protects the two bounds below */
+  int next;               /**< Next index to execute */
+  int end;                /**< One past the last index of the slice */
+} MeosPoolSlice;
+
+/**
+ * @brief Thread pool executing parallel loops
+ */
+typedef struct MeosPool
+{
+  int nworkers;           /**< Number of worker threads, excluding callers */
+  pthread_t *threads;     /**< Worker threads */
+  pthread_mutex_t lock;   /**< Protects the fields below */
+  pthread_cond_t newloop; /**< Signaled when a new loop is submitted */
+  pthread_cond_t alldone; /**< Signaled when the last worker finishes */
+  bool shutdown;          /**< True when the workers must exit */
+  bool busy;              /**< True while a loop is being executed */
+  uint64 loopid;          /**< Identifier of the current loop */
+  int nrunning;           /**< Workers still executing the current loop */
+  MeosPoolTaskFn fn;      /**< Task function of the current loop */
+  void *arg;              /**< Argument passed through to the task function */
+  MeosPoolSlice *slices;  /**< One slice per worker plus one for the caller */
+} MeosPool;
+
+/** Argument of a worker thread */
+typedef struct MeosPoolWorkerArg
+{
+  MeosPool *pool;         /**< The pool the worker belongs to */
+  int self;               /**< Index of the worker's own slice */
+} MeosPoolWorkerArg;
+
+/** Global thread pool, NULL when no pool has been started */
+static MeosPool *_meos_pool = NULL;
+/** Arguments of the worker threads */
+static MeosPoolWorkerArg *_meos_pool_args = NULL;
+
+/*****************************************************************************/
+
+/**
+ * @brief Steal the upper half of the largest remaining slice
+ * @return True if some work was stolen into the participant's own slice
+ */
+static bool
+meos_pool_steal(MeosPool *pool, int self)
+{
+  int nslices = pool->nworkers + 1;
+  int victim = -1, remaining = 1;
+  for (int i = 0; i < nslices; i++)
+  {
+    if (i == self)
+      continue;
+    MeosPoolSlice *slice = &pool->slices[i];
+    pthread_mutex_lock(&slice->lock);
+    /* Leave at least one index to the victim, it is already working on it */
+    if (slice->end - slice->next > remaining)
+    {
+      victim = i;
+      remaining = slice->end - slice->next;
+    }
+    pthread_mutex_unlock(&slice->lock);
+  }
+  if (victim < 0)
+    return false;
+  MeosPoolSlice *slice = &pool->slices[victim];
+  pthread_mutex_lock(&slice->lock);
+  /* The slice may have shrunk since it was inspected above */
+  if (slice->end - slice->next <= 1)
+  {
+    pthread_mutex_unlock(&slice->lock);
+    return false;
+  }
+  int mid = slice->next + (slice->end - slice->next) / 2;
+  int end = slice->end;
+  slice->end = mid;
+  pthread_mutex_unlock(&slice->lock);
+  /* The stolen range is exclusively ours, publish it in our own slice */
+  MeosPoolSlice *own = &pool->slices[self];
+  pthread_mutex_lock(&own->lock);
+  own->next = mid;
+  own->end = end;
+  pthread_mutex_unlock(&own->lock);
+  return true;
+}
+
+/**
+ * @brief Execute the current loop draining the participant's own slice and
+ * stealing from the others when it is empty
+ */
+static void
+meos_pool_work(MeosPool *pool, int self)
+{
+  MeosPoolSlice *own = &pool->slices[self];
+  while (true)
+  {
+    int idx = -1;
+    pthread_mutex_lock(&own->lock);
+    if (own->next < own->end)
+      idx = own->next++;
+    pthread_mutex_unlock(&own->lock);
+    if (idx < 0)
+    {
+      if (! meos_pool_steal(pool, self))
+        break;
+      continue;
+    }
+    pool->fn(pool->arg, idx);
+  }
+  return;
+}
+
+/**
+ * @brief Main function of a worker thread
+ */
+static void *
+meos_pool_worker(void *arg)
+{
+  MeosPoolWorkerArg *warg = (MeosPoolWorkerArg *) arg;
+  MeosPool *pool = warg->pool;
+  uint64 seen = 0;
+  pthread_mutex_lock(&pool->lock);
+  while (true)
+  {
+    while (! pool->shutdown && pool->loopid == seen)
+      pthread_cond_wait(&pool->newloop, &pool->lock);
+    if (pool->shutdown)
+      break;
+    seen = pool->loopid;
+    pthread_mutex_unlock(&pool->lock);
+    meos_pool_work(pool, warg->self);
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->nrunning == 0)
+      pthread_cond_signal(&pool->alldone);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Start the thread pool used for library-level parallelism
+ * @param[in] nthreads Number of threads exploited by parallel loops,
+ * including the calling thread; when 0, one thread per available core
+ * @return True on success
+ */
+bool
+meos_initialize_pool(int nthreads)
+{
+  if (_meos_pool)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "The thread pool has already been initialized");
+    return false;
+  }
+  if (nthreads < 0 || nthreads > MEOS_POOL_MAXTHREADS)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of threads must be between 0 and %d", MEOS_POOL_MAXTHREADS);
+    return false;
+  }
+  if (nthreads == 0)
+  {
+    long ncores = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = (ncores > MEOS_POOL_MAXTHREADS) ?
+      MEOS_POOL_MAXTHREADS : (ncores > 1) ? (int) ncores : 1;
+  }
+  /* The calling thread participates in every loop; with a single thread
+   * there is nothing to start and parallel loops run serially */
+  int nworkers = nthreads - 1;
+  MeosPool *pool = calloc(1, sizeof(MeosPool));
+  MeosPoolWorkerArg *args = NULL;
+  if (pool)
+  {
+    pool->threads = calloc(nworkers ? nworkers : 1, sizeof(pthread_t));
+    pool->slices = calloc(nworkers + 1, sizeof(MeosPoolSlice));
+    args = calloc(nworkers ? nworkers : 1, sizeof(MeosPoolWorkerArg));
+  }
+  if (! pool || ! pool->threads || ! pool->slices || ! args)
+  {
+    meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+      "Unable to allocate the thread pool");
+    if (pool)
+    {
+      free(pool->threads); free(pool->slices); free(pool);
+    }
+    free(args);
+    return false;
+  }
+  pool->nworkers = nworkers;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->newloop, NULL);
+  pthread_cond_init(&pool->alldone, NULL);
+  for (int i = 0; i <= nworkers; i++)
+    pthread_mutex_init(&pool->slices[i].lock, NULL);
+  for (int i = 0; i < nworkers; i++)
+  {
+    args[i].pool = pool;
+    args[i].self = i;
+    if (pthread_create(&pool->threads[i], NULL, &meos_pool_worker, &args[i]))
+    {
+      /* Keep the workers already started, the pool is still functional */
+      pool->nworkers = i;
+      break;
+    }
+  }
+  _meos_pool = pool;
+  _meos_pool_args = args;
+  return true;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Stop the thread pool and release its resources
+ */
+void
+meos_finalize_pool(void)
+{
+  MeosPool *pool = _meos_pool;
+  if (! pool)
+    return;
+  pthread_mutex_lock(&pool->lock);
+  pool->shutdown = true;
+  pthread_cond_broadcast(&pool->newloop);
+  pthread_mutex_unlock(&pool->lock);
+  for (int i = 0; i < pool->nworkers; i++)
+    pthread_join(pool->threads[i], NULL);
+  _meos_pool = NULL;
+  free(pool->threads);
+  free(pool->slices);
+  free(pool);
+  free(_meos_pool_args);
+  _meos_pool_args = NULL;
+  return;
+}
+
+/**
+ * @brief Return true if a thread pool with at least one worker is active
+ */
+bool
+meos_pool_active(void)
+{
+  return _meos_pool != NULL && _meos_pool->nworkers > 0;
+}
+
+/**
+ * @brief Return the number of threads participating in a parallel loop,
+ * that is, the workers plus the calling thread, 1 when there is no pool
+ */
+int
+meos_pool_num_threads(void)
+{
+  return meos_pool_active() ? _meos_pool->nworkers + 1 : 1;
+}
+
+/**
+ * @brief Execute a loop of independent iterations on the thread pool
+ * @param[in] count Number of iterations
+ * @param[in] fn Task function called for every index in [0, count)
+ * @param[in] arg Argument passed through to the task function
+ *
+ * The function returns when all iterations have been executed. The loop
+ * runs serially when there is no pool, when it is too small to offset the
+ * synchronization cost, when an arena is active, or when it is nested
+ * inside another parallel loop.
+ */
+void
+meos_pool_parallel_for(int count, MeosPoolTaskFn fn, void *arg)
+{
+  MeosPool *pool = _meos_pool;
+  bool serial = ! pool || pool->nworkers == 0 ||
+    count <= pool->nworkers + 1 || meos_arena_active();
+  if (! serial)
+  {
+    pthread_mutex_lock(&pool->lock);
+    if (pool->busy)
+      /* Nested loop, the caller is a task of the outer one */
+      serial = true;
+    else
+      pool->busy = true;
+    pthread_mutex_unlock(&pool->lock);
+  }
+  if (serial)
+  {
+    for (int i = 0; i < count; i++)
+      fn(arg, i);
+    return;
+  }
+
+  /* Give each participant a contiguous slice, idle ones will steal */
+  int nslices = pool->nworkers + 1;
+  pthread_mutex_lock(&pool->lock);
+  for (int i = 0; i < nslices; i++)
+  {
+    pool->slices[i].next = (int) (((int64) count * i) / nslices);
+    pool->slices[i].end = (int) (((int64) count * (i + 1)) / nslices);
+  }
+  pool->fn = fn;
+  pool->arg = arg;
+  pool->nrunning = pool->nworkers;
+  pool->loopid++;
+  pthread_cond_broadcast(&pool->newloop);
+  pthread_mutex_unlock(&pool->lock);
+  /* The calling thread works on the last slice */
+  meos_pool_work(pool, pool->nworkers);
+  pthread_mutex_lock(&pool->lock);
+  while (pool->nrunning > 0)
+    pthread_cond_wait(&pool->alldone, &pool->lock);
+  pool->busy = false;
+  pthread_mutex_unlock(&pool->lock);
+  return;
+}
+
+/*****************************************************************************/
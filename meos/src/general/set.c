@@ -324,16 +324,20 @@ set_out_fn(const Set *s, int maxdd, outfunc value_out)
   assert(maxdd >= 0);
 
   char **strings = palloc(sizeof(char *) * s->count);
+  size_t *lengths = palloc(sizeof(size_t) * s->count);
   size_t outlen = 0;
   for (int i = 0; i < s->count; i++)
   {
     Datum d = SET_VAL_N(s, i);
     strings[i] = value_out(d, s->basetype, maxdd);
-    outlen += strlen(strings[i]) + 1;
+    lengths[i] = strlen(strings[i]);
+    outlen += lengths[i] + 1;
   }
   bool quotes = set_basetype_quotes(s->basetype);
-  return stringarr_to_string(strings, s->count, outlen, "", '{', '}', quotes,
-    SPACES);
+  char *result = stringarr_to_string(strings, lengths, s->count, outlen, "",
+    '{', '}', quotes, SPACES);
+  pfree(lengths);
+  return result;
 }
 
 /**
@@ -351,6 +355,49 @@ set_out(const Set *s, int maxdd)
 }
 
 #if MEOS
+/**
+ * @ingroup libmeos_setspan_inout
+ * @brief Write the Well-Known Text (WKT) representation of a set to an
+ * output callback in chunks.
+ *
+ * Streaming counterpart of the output functions, which produces the result
+ * with constant memory instead of materializing the whole string.
+ * @param[in] s Set
+ * @param[in] maxdd Maximum number of decimal digits
+ * @param[in] chunksize Size in bytes of the output buffer, at least 1024
+ * @param[in] writefn Callback receiving the successive chunks
+ * @param[in] state Opaque state passed to the callback
+ * @return True on success
+ */
+bool
+set_out_stream(const Set *s, int maxdd, size_t chunksize,
+  size_t (*writefn)(const char *, size_t, void *), void *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) s) || ! ensure_not_null((void *) writefn) ||
+      ! ensure_not_negative(maxdd))
+    return false;
+
+  StringWriter writer;
+  string_writer_init(&writer, chunksize, writefn, state);
+  bool quotes = set_basetype_quotes(s->basetype);
+  string_writer_append(&writer, "{", 1);
+  for (int i = 0; i < s->count; i++)
+  {
+    if (i > 0)
+      string_writer_append(&writer, ", ", 2);
+    if (quotes)
+      string_writer_append(&writer, "\"", 1);
+    char *str = basetype_out(SET_VAL_N(s, i), s->basetype, maxdd);
+    string_writer_append(&writer, str, strlen(str));
+    pfree(str);
+    if (quotes)
+      string_writer_append(&writer, "\"", 1);
+  }
+  string_writer_append(&writer, "}", 1);
+  return string_writer_finish(&writer);
+}
+
 /**
  * @ingroup libmeos_setspan_inout
  * @brief Output a set of integers.
@@ -558,9 +605,12 @@ SET_VAL_N(const Set *s, int index)
 #endif /* DEBUG_BUILD */
 
 /**
- * @ingroup libmeos_internal_setspan_constructor
- * @brief Construct a set from an array of values enabling the data structure
- * to expand.
+ * @brief Construct a set from an array of values, the main function of
+ * #set_make_exp and #set_make_trusted.
+ *
+ * For ordered sets the array of values is assumed to be sorted and without
+ * duplicates; #set_make_exp ensures this by sorting the array, while
+ * #set_make_trusted trusts the caller.
  *
  * The memory structure depends on whether the value is passed by value or
  * by reference. For example, the memory structure of a set with 2 values
@@ -593,54 +643,19 @@ SET_VAL_N(const Set *s, int index)
  * @param[in] maxcount Maximum number of elements in the array
  * @param[in] basetype Base type
  * @param[in] ordered True for ordered sets
- * @sqlfunc intset(), bigintset(), floatset(), textset(), tstzset()
  */
-Set *
-set_make_exp(const Datum *values, int count, int maxcount, meosType basetype,
+static Set *
+set_make1_exp(const Datum *values, int count, int maxcount, meosType basetype,
   bool ordered)
 {
-  /* Ensure validity of the arguments */
-  if (! ensure_not_null((void *) values) || ! ensure_positive(count) ||
-      ! ensure_less_equal(count, maxcount))
-    return NULL;
-
+  assert(values); assert(count > 0); assert(count <= maxcount);
   bool hasz = false;
   bool geodetic = false;
   if (geo_basetype(basetype))
   {
-    /* Ensure the spatial validity of the elements */
-    GSERIALIZED *gs1 = DatumGetGserializedP(values[0]);
-    int srid = gserialized_get_srid(gs1);
-    hasz = (bool) FLAGS_GET_Z(gs1->gflags);
-    geodetic = FLAGS_GET_GEODETIC(gs1->gflags);
-    /* Test the validity of the values */
-    for (int i = 0; i < count; i++)
-    {
-      /* Test that the geometry is not empty */
-      GSERIALIZED *gs2 = DatumGetGserializedP(values[i]);
-      if (! ensure_point_type(gs2) ||
-          ! ensure_same_srid(srid, gserialized_get_srid(gs2)) ||
-          ! ensure_same_dimensionality_gs(gs1, gs2) ||
-          ! ensure_not_empty(gs2))
-        return NULL;
-    }
-  }
-
-  /* Sort the values and remove duplicates */
-  Datum *newvalues;
-  int newcount;
-  if (ordered && count > 1)
-  {
-  /* Sort the values and remove duplicates */
-    newvalues = palloc(sizeof(Datum) * count);
-    memcpy(newvalues, values, sizeof(Datum) * count);
-    datumarr_sort(newvalues, count, basetype);
-    newcount = datumarr_remove_duplicates(newvalues, count, basetype);
-  }
-  else
-  {
-    newvalues = (Datum *) values;
-    newcount = count;
+    GSERIALIZED *gs = DatumGetGserializedP(values[0]);
+    hasz = (bool) FLAGS_GET_Z(gs->gflags);
+    geodetic = FLAGS_GET_GEODETIC(gs->gflags);
   }
 
   /* Get the bounding box size */
@@ -663,12 +678,12 @@ set_make_exp(const Datum *values, int count, int maxcount, meosType basetype,
   {
     if (typlen == -1)
     {
-      for (int i = 0; i < newcount; i++)
+      for (int i = 0; i < count; i++)
         /* VARSIZE_ANY is used for oblivious data alignment, see postgres.h */
-        values_size += DOUBLE_PAD(VARSIZE_ANY(DatumGetPointer(newvalues[i])));
+        values_size += DOUBLE_PAD(VARSIZE_ANY(DatumGetPointer(values[i])));
     }
     else
-      values_size = DOUBLE_PAD(typlen) * newcount;
+      values_size = DOUBLE_PAD(typlen) * count;
   }
 
 #if MEOS
@@ -696,7 +711,7 @@ set_make_exp(const Datum *values, int count, int maxcount, meosType basetype,
     MEOS_FLAGS_SET_Z(result->flags, hasz);
     MEOS_FLAGS_SET_GEODETIC(result->flags, geodetic);
   }
-  result->count = newcount;
+  result->count = count;
   result->maxcount = maxcount;
   result->settype = settype;
   result->basetype = basetype;
@@ -704,8 +719,8 @@ set_make_exp(const Datum *values, int count, int maxcount, meosType basetype,
   /* Copy the array of values */
   if (typbyval)
   {
-    for (int i = 0; i < newcount; i++)
-      (SET_OFFSETS_PTR(result))[i] = newvalues[i];
+    for (int i = 0; i < count; i++)
+      (SET_OFFSETS_PTR(result))[i] = values[i];
   }
   else
   {
@@ -713,12 +728,12 @@ set_make_exp(const Datum *values, int count, int maxcount, meosType basetype,
     size_t pdata = DOUBLE_PAD(sizeof(Set)) + DOUBLE_PAD(bboxsize) +
       sizeof(size_t) * maxcount;
     size_t pos = 0;
-    for (int i = 0; i < newcount; i++)
+    for (int i = 0; i < count; i++)
     {
       /* VARSIZE_ANY is used for oblivious data alignment, see postgres.h */
       size_t size_elem = (typlen == -1) ?
-        VARSIZE_ANY(newvalues[i]) : (uint32) typlen;
-      memcpy(((char *) result) + pdata + pos, DatumGetPointer(newvalues[i]),
+        VARSIZE_ANY(values[i]) : (uint32) typlen;
+      memcpy(((char *) result) + pdata + pos, DatumGetPointer(values[i]),
         size_elem);
       (SET_OFFSETS_PTR(result))[i] = pos;
       pos += DOUBLE_PAD(size_elem);
@@ -727,13 +742,117 @@ set_make_exp(const Datum *values, int count, int maxcount, meosType basetype,
 
   /* Compute the bounding box */
   if (bboxsize != 0)
-    valuearr_compute_bbox(newvalues, basetype, newcount, SET_BBOX_PTR(result));
+    valuearr_compute_bbox(values, basetype, count, SET_BBOX_PTR(result));
+  return result;
+}
 
+/**
+ * @brief Ensure that the values of a geo set are non-empty points with the
+ * same srid and the same dimensionality
+ */
+static bool
+ensure_valid_geoset(const Datum *values, int count)
+{
+  GSERIALIZED *gs1 = DatumGetGserializedP(values[0]);
+  int srid = gserialized_get_srid(gs1);
+  for (int i = 0; i < count; i++)
+  {
+    /* Test that the geometry is not empty */
+    GSERIALIZED *gs2 = DatumGetGserializedP(values[i]);
+    if (! ensure_point_type(gs2) ||
+        ! ensure_same_srid(srid, gserialized_get_srid(gs2)) ||
+        ! ensure_same_dimensionality_gs(gs1, gs2) ||
+        ! ensure_not_empty(gs2))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @ingroup libmeos_internal_setspan_constructor
+ * @brief Construct a set from an array of values enabling the data structure
+ * to expand.
+ * @param[in] values Array of values
+ * @param[in] count Number of elements in the array
+ * @param[in] maxcount Maximum number of elements in the array
+ * @param[in] basetype Base type
+ * @param[in] ordered True for ordered sets
+ * @sqlfunc intset(), bigintset(), floatset(), textset(), tstzset()
+ */
+Set *
+set_make_exp(const Datum *values, int count, int maxcount, meosType basetype,
+  bool ordered)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) values) || ! ensure_positive(count) ||
+      ! ensure_less_equal(count, maxcount))
+    return NULL;
+  /* Ensure the spatial validity of the elements */
+  if (geo_basetype(basetype) && ! ensure_valid_geoset(values, count))
+    return NULL;
+
+  /* Sort the values and remove duplicates */
+  Datum *newvalues;
+  int newcount;
+  if (ordered && count > 1)
+  {
+  /* Sort the values and remove duplicates */
+    newvalues = palloc(sizeof(Datum) * count);
+    memcpy(newvalues, values, sizeof(Datum) * count);
+    datumarr_sort(newvalues, count, basetype);
+    newcount = datumarr_remove_duplicates(newvalues, count, basetype);
+  }
+  else
+  {
+    newvalues = (Datum *) values;
+    newcount = count;
+  }
+
+  Set *result = set_make1_exp(newvalues, newcount, maxcount, basetype,
+    ordered);
   if (ordered && count > 1)
     pfree(newvalues);
   return result;
 }
 
+/**
+ * @ingroup libmeos_internal_setspan_constructor
+ * @brief Construct a set from an array of values known by the caller to be
+ * sorted and without duplicates, applying the requested validation level.
+ *
+ * This constructor is intended for machine-generated input, for example,
+ * values collected in ascending order from a device, where the sorting and
+ * the duplicate removal performed by #set_make are unnecessary and the
+ * validation can be reduced to an ordering test or skipped altogether.
+ * @param[in] values Array of values
+ * @param[in] count Number of elements in the array
+ * @param[in] basetype Base type
+ * @param[in] validate Validation level applied to the array
+ */
+Set *
+set_make_trusted(const Datum *values, int count, meosType basetype,
+  validateLevel validate)
+{
+  assert(values); assert(count > 0);
+  if (validate == VALIDATE_FULL && geo_basetype(basetype) &&
+      ! ensure_valid_geoset(values, count))
+    return NULL;
+  if (validate != VALIDATE_NONE)
+  {
+    /* Verify that the values are in strictly increasing order */
+    for (int i = 1; i < count; i++)
+    {
+      if (! datum_lt(values[i - 1], values[i], basetype))
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "Values for a set must be in strictly increasing order");
+        return NULL;
+      }
+    }
+  }
+  return set_make1_exp(values, count, count, basetype, ORDERED);
+}
+
 /**
  * @ingroup libmeos_internal_setspan_constructor
  * @brief Construct a set from an array of values.
@@ -98,6 +98,123 @@ bbox_contains_set_value(const Set *s, Datum d, meosType basetype)
 
 /*****************************************************************************/
 
+/**
+ * @brief Return the first position after a given position in the values
+ * array of a by-value set whose value is not less than a value (galloping
+ * search)
+ *
+ * The position is located with an exponential search followed by a binary
+ * search of the last doubled interval, so that skipping over k values costs
+ * O(log k) comparisons instead of k.
+ * @pre The value at position @p lo is less than @p d
+ */
+static int
+set_gallop_search(const Datum *vals, int lo, int hi, Datum d,
+  meosType basetype)
+{
+  int step = 1;
+  while (lo + step < hi && datum_cmp(vals[lo + step], d, basetype) < 0)
+  {
+    lo += step;
+    step *= 2;
+  }
+  int right = (lo + step < hi) ? lo + step : hi;
+  /* The value at lo is less than d and the one at right, if any, is not:
+   * binary search between the two */
+  while (lo + 1 < right)
+  {
+    int middle = (lo + right) / 2;
+    if (datum_cmp(vals[middle], d, basetype) < 0)
+      lo = middle;
+    else
+      right = middle;
+  }
+  return right;
+}
+
+/**
+ * @brief Return the union, intersection, or difference of two sets whose
+ * values are passed by value (fast path)
+ *
+ * The values of such sets are stored in a contiguous sorted Datum array,
+ * which allows the merge to gallop over the stretches where one set runs
+ * ahead of the other and to copy them in bulk with memcpy, instead of
+ * advancing one comparison at a time. Stretches where the two sets are
+ * identical are detected with a bitwise equality scan over the two arrays
+ * that the compiler can vectorize; bitwise-distinct values fall back to
+ * datum_cmp.
+ */
+static Set *
+setop_byval_set_set(const Set *s1, const Set *s2, SetOper setop)
+{
+  int count;
+  if (setop == UNION)
+    count = s1->count + s2->count;
+  else if (setop == INTER)
+    count = Min(s1->count, s2->count);
+  else /* setop == MINUS */
+    count = s1->count;
+  Datum *values = palloc(sizeof(Datum) * count);
+  /* For by-value sets the offsets array holds the values themselves */
+  const Datum *vals1 = (const Datum *) SET_OFFSETS_PTR(s1);
+  const Datum *vals2 = (const Datum *) SET_OFFSETS_PTR(s2);
+  meosType basetype = s1->basetype;
+  int i = 0, j = 0, nvals = 0;
+  while (i < s1->count && j < s2->count)
+  {
+    int cmp = datum_cmp(vals1[i], vals2[j], basetype);
+    if (cmp == 0)
+    {
+      /* Scan forward the stretch where the two sets are bitwise identical */
+      int run = 1;
+      while (i + run < s1->count && j + run < s2->count &&
+             vals1[i + run] == vals2[j + run])
+        run++;
+      if (setop == UNION || setop == INTER)
+      {
+        memcpy(&values[nvals], &vals1[i], sizeof(Datum) * run);
+        nvals += run;
+      }
+      i += run;
+      j += run;
+    }
+    else if (cmp < 0)
+    {
+      /* Gallop to the first value of s1 not less than the one of s2; the
+       * skipped values do not appear in s2 */
+      int next = set_gallop_search(vals1, i, s1->count, vals2[j], basetype);
+      if (setop == UNION || setop == MINUS)
+      {
+        memcpy(&values[nvals], &vals1[i], sizeof(Datum) * (next - i));
+        nvals += next - i;
+      }
+      i = next;
+    }
+    else
+    {
+      /* Gallop to the first value of s2 not less than the one of s1 */
+      int next = set_gallop_search(vals2, j, s2->count, vals1[i], basetype);
+      if (setop == UNION)
+      {
+        memcpy(&values[nvals], &vals2[j], sizeof(Datum) * (next - j));
+        nvals += next - j;
+      }
+      j = next;
+    }
+  }
+  if ((setop == UNION || setop == MINUS) && i < s1->count)
+  {
+    memcpy(&values[nvals], &vals1[i], sizeof(Datum) * (s1->count - i));
+    nvals += s1->count - i;
+  }
+  if (setop == UNION && j < s2->count)
+  {
+    memcpy(&values[nvals], &vals2[j], sizeof(Datum) * (s2->count - j));
+    nvals += s2->count - j;
+  }
+  return set_make_free(values, nvals, basetype, ORDERED);
+}
+
 /**
  * @brief Return the union, intersection, or difference of two sets
  */
@@ -112,6 +229,10 @@ setop_set_set(const Set *s1, const Set *s2, SetOper setop)
       return setop == INTER ? NULL : set_copy(s1);
   }
 
+  /* Merge over the contiguous value arrays of by-value sets */
+  if (MEOS_FLAGS_GET_BYVAL(s1->flags))
+    return setop_byval_set_set(s1, s2, setop);
+
   int count;
   if (setop == UNION)
     count = s1->count + s2->count;
@@ -43,6 +43,7 @@
 #include <assert.h>
 #include <limits.h>
 #include <math.h>
+#include <stdio.h>
 /* PostgreSQL */
 #include <postgres.h>
 #if MEOS
@@ -74,6 +75,59 @@
 #define SKIPLIST_INITIAL_CAPACITY 1024
 #define SKIPLIST_GROW 1       /**< double the capacity to expand the skiplist */
 #define SKIPLIST_INITIAL_FREELIST 32
+#define SKIPLIST_BUFFER_SIZE 32 /**< size of the insertion buffer absorbing
+                                     out-of-order instants */
+
+/**
+ * Software prefetch of the skiplist element at the given position. The
+ * elements are stored in an array but the traversal order is given by the
+ * next indices, so after many merges consecutive elements may live on cold
+ * cache lines; issuing the fetch of the element that will be examined next
+ * while the current one is being compared hides part of that latency.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define SKIPLIST_PREFETCH(list, idx) \
+  do { \
+    if ((idx) != -1) \
+      __builtin_prefetch(&(list)->elems[(idx)], 0, 1); \
+  } while (0)
+#else
+#define SKIPLIST_PREFETCH(list, idx) ((void) 0)
+#endif
+
+/**
+ * Limit on the memory used by a skiplist aggregate state, including both the
+ * element array and the temporal values it points to; 0 means no limit. When
+ * the limit is exceeded, the elements strictly before the values being
+ * spliced in are serialized into a temporary file, since with time-ordered
+ * input they will not be touched again. They are read back when the final
+ * value is requested or when a splice reaches into the spilled time range.
+ */
+static size_t _skiplist_mem_limit = 0;
+
+#if MEOS
+/**
+ * @brief Structure keeping the values of a skiplist spilled to disk
+ */
+typedef struct SkipListSpill
+{
+  FILE *file;        /**< Temporary file with the serialized values */
+  int count;         /**< Number of values in the file */
+  TimestampTz maxt;  /**< End instant of the last value spilled */
+} SkipListSpill;
+#endif /* MEOS */
+
+/**
+ * @ingroup libmeos_setspan_agg
+ * @brief Set a limit in bytes on the memory used by each temporal aggregate
+ * state, 0 for no limit.
+ */
+void
+meos_aggregate_set_mem_limit(size_t bytes)
+{
+  _skiplist_mem_limit = bytes;
+  return;
+}
 
 /**
  * @brief Enumeration for the relative position of a given element into a skiplist
@@ -177,7 +231,9 @@ skiplist_alloc(SkipList *list)
       list->capacity = (int) floor(MaxAllocSize / sizeof(SkipListElem));
     else
       list->capacity <<= SKIPLIST_GROW;
+    MEOS_ALLOC_TAG(MEOS_ALLOC_SKIPLIST);
     list->elems = repalloc(list->elems, sizeof(SkipListElem) * list->capacity);
+    MEOS_ALLOC_TAG(MEOS_ALLOC_GENERIC);
   }
 
   /* Return the first available entry */
@@ -218,6 +274,61 @@ skiplist_delete(SkipList *list, int cur)
   return;
 }
 
+/**
+ * @brief Rebuild the element pool of the skiplist in time order
+ *
+ * Merges allocate and free elements in an order unrelated to time, so after
+ * many splices the level-0 successor of an element may live anywhere in the
+ * pool and a traversal chases pointers through cold memory. This function
+ * rewrites the pool so that the array order coincides with the time order
+ * and relinks the levels in the same balanced fashion as #skiplist_make,
+ * after which traversals are sequential scans again. The values themselves
+ * are not copied, only the element slots holding their pointers.
+ */
+static void
+skiplist_compact(SkipList *list)
+{
+  int count = list->length + 2; /* Account for head and tail */
+#if ! MEOS
+  MemoryContext ctx = set_aggregation_context(fetch_fcinfo());
+#endif /* ! MEOS */
+  MEOS_ALLOC_TAG(MEOS_ALLOC_SKIPLIST);
+  SkipListElem *elems = palloc0(sizeof(SkipListElem) * list->capacity);
+  MEOS_ALLOC_TAG(MEOS_ALLOC_GENERIC);
+#if ! MEOS
+  unset_aggregation_context(ctx);
+#endif /* ! MEOS */
+  /* Move the value pointers in time order, head and tail keep NULL */
+  int cur = list->elems[0].next[0];
+  int nelems = 0;
+  while (cur != list->tail)
+  {
+    elems[++nelems].value = list->elems[cur].value;
+    cur = list->elems[cur].next[0];
+  }
+  assert(nelems == list->length);
+  /* Link the list in a balanced fashion as in skiplist_make */
+  int height = (int) ceil(log2(count - 1));
+  for (int level = 0; level < height; level++)
+  {
+    int step = 1 << level;
+    for (int i = 0; i < count - 1; i += step)
+    {
+      int next = i + step < count ? i + step : count - 1;
+      elems[i].next[level] = next;
+      elems[i].height = level + 1;
+    }
+    elems[count - 1].next[level] = - 1;
+    elems[count - 1].height = height;
+  }
+  pfree(list->elems);
+  list->elems = elems;
+  list->next = count;
+  list->tail = count - 1;
+  list->freecount = 0;
+  return;
+}
+
 /**
  * @ingroup libmeos_setspan_agg
  * @brief Free the skiplist
@@ -227,10 +338,23 @@ skiplist_free(SkipList *list)
 {
   if (! list)
     return;
+#if MEOS
+  if (list->spill)
+  {
+    fclose(((SkipListSpill *) list->spill)->file);
+    pfree(list->spill);
+  }
+#endif /* MEOS */
   if (list->extra)
     pfree(list->extra);
   if (list->freed)
     pfree(list->freed);
+  if (list->buffer)
+  {
+    for (int i = 0; i < list->buffercount; i++)
+      pfree(list->buffer[i]);
+    pfree(list->buffer);
+  }
   if (list->elems)
   {
     /* Free the element values of the skiplist if they are not NULL */
@@ -365,8 +489,10 @@ skiplist_make(void **values, int count)
   count += 2; /* Account for head and tail */
   while (capacity <= count)
     capacity <<= 1;
+  MEOS_ALLOC_TAG(MEOS_ALLOC_SKIPLIST);
   SkipList *result = palloc0(sizeof(SkipList));
   result->elems = palloc0(sizeof(SkipListElem) * capacity);
+  MEOS_ALLOC_TAG(MEOS_ALLOC_GENERIC);
   int height = (int) ceil(log2(count - 1));
   result->capacity = capacity;
   result->next = count;
@@ -377,7 +503,10 @@ skiplist_make(void **values, int count)
   /* Fill values first */
   result->elems[0].value = NULL; /* set head value to NULL */
   for (int i = 0; i < count - 2; i++)
+  {
     result->elems[i + 1].value = temporal_copy((Temporal *) values[i]);
+    result->valmem += VARSIZE(result->elems[i + 1].value);
+  }
   result->elems[count - 1].value = NULL; /* set tail value to NULL */
   result->tail = count - 1;
 #if ! MEOS
@@ -445,6 +574,314 @@ skiplist_elempos(const SkipList *list, Span *p, int cur)
     return pos_period_period(p, &((TSequence *) temp)->period);
 }
 
+#if MEOS
+/**
+ * @brief Spill the elements strictly before the span to a temporary file
+ *
+ * The first element is kept in memory so that the head value of the list
+ * stays addressable without reading the file back. Each value is written as
+ * its size followed by its bytes; the file is read back by the same process,
+ * so no portable serialization is needed.
+ */
+static void
+skiplist_spill(SkipList *list, Span *p)
+{
+  int first = list->elems[0].next[0];
+  if (first == -1 || first == list->tail)
+    return;
+  int cur = list->elems[first].next[0];
+  if (cur == -1 || cur == list->tail ||
+      skiplist_elempos(list, p, cur) != AFTER)
+    return;
+
+  SkipListSpill *spill = (SkipListSpill *) list->spill;
+  if (! spill)
+  {
+    FILE *file = tmpfile();
+    if (! file)
+    {
+      meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+        "Cannot create the temporary file for spilling the aggregation");
+      return;
+    }
+    spill = palloc0(sizeof(SkipListSpill));
+    spill->file = file;
+    list->spill = spill;
+  }
+
+  /* Write the values of the cold elements and set their pointers to NULL,
+   * which marks the elements during the unlinking below */
+  int nspilled = 0;
+  int *spilled = palloc(sizeof(int) * list->length);
+  Span s;
+  while (cur != -1 && cur != list->tail &&
+         skiplist_elempos(list, p, cur) == AFTER)
+  {
+    Temporal *value = (Temporal *) list->elems[cur].value;
+    size_t size = VARSIZE(value);
+    if (fwrite(&size, sizeof(size_t), 1, spill->file) != 1 ||
+        fwrite(value, 1, size, spill->file) != size)
+    {
+      meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+        "Cannot write to the temporary file for spilling the aggregation");
+      pfree(spilled);
+      return;
+    }
+    temporal_set_period(value, &s);
+    spill->maxt = DatumGetTimestampTz(s.upper);
+    spill->count++;
+    list->valmem -= size;
+    pfree(value);
+    list->elems[cur].value = NULL;
+    spilled[nspilled++] = cur;
+    cur = list->elems[cur].next[0];
+  }
+
+  /* Unlink the spilled run: since it starts at the second element, only the
+   * head and the kept first element can point into it */
+  int height = list->elems[0].height;
+  int before[2] = {0, first};
+  for (int level = 0; level < height; level++)
+  {
+    for (int k = 0; k < 2; k++)
+    {
+      SkipListElem *e = &list->elems[before[k]];
+      if (level >= e->height)
+        continue;
+      int next = e->next[level];
+      while (next != -1 && next != list->tail &&
+             list->elems[next].value == NULL)
+        next = list->elems[next].next[level];
+      e->next[level] = next;
+    }
+  }
+
+  /* Mark the elements as free */
+  for (int i = 0; i < nspilled; i++)
+    skiplist_delete(list, spilled[i]);
+  pfree(spilled);
+
+  /* Level down head & tail if necessary */
+  SkipListElem *head = &list->elems[0];
+  SkipListElem *tail = &list->elems[list->tail];
+  while (head->height > 1 && head->next[head->height - 1] == list->tail)
+  {
+    head->height--;
+    tail->height--;
+  }
+  return;
+}
+
+/**
+ * @brief Read the spilled values back and rebuild the skiplist with them
+ */
+static void
+skiplist_unspill(SkipList *list)
+{
+  SkipListSpill *spill = (SkipListSpill *) list->spill;
+  assert(spill);
+  /* Read the spilled values, which are strictly before the in-memory ones */
+  rewind(spill->file);
+  int count = spill->count + list->length;
+  void **values = palloc(sizeof(void *) * count);
+  for (int i = 0; i < spill->count; i++)
+  {
+    size_t size;
+    Temporal *value = NULL;
+    if (fread(&size, sizeof(size_t), 1, spill->file) == 1)
+    {
+      value = palloc(size);
+      if (fread(value, 1, size, spill->file) != size)
+      {
+        pfree(value);
+        value = NULL;
+      }
+    }
+    if (! value)
+    {
+      meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+        "Cannot read from the temporary file of a spilled aggregation");
+      for (int j = 0; j < i; j++)
+        pfree(values[j]);
+      pfree(values);
+      return;
+    }
+    values[i] = value;
+  }
+  int nvalues = spill->count;
+  int cur = list->elems[0].next[0];
+  while (cur != list->tail)
+  {
+    values[nvalues++] = list->elems[cur].value;
+    cur = list->elems[cur].next[0];
+  }
+  assert(nvalues == count);
+
+  /* Rebuild the list with the full set of values, preserving the extra
+   * state and the list pointer held by the caller */
+  SkipList *new = skiplist_make(values, count);
+  for (int i = 0; i < spill->count; i++)
+    pfree(values[i]);
+  pfree(values);
+  cur = 0;
+  while (cur != -1)
+  {
+    SkipListElem *e = &list->elems[cur];
+    if (e->value)
+      pfree(e->value);
+    cur = e->next[0];
+  }
+  pfree(list->elems);
+  if (list->freed)
+    pfree(list->freed);
+  list->capacity = new->capacity;
+  list->next = new->next;
+  list->length = new->length;
+  list->freed = NULL;
+  list->freecount = 0;
+  list->freecap = 0;
+  list->tail = new->tail;
+  list->elems = new->elems;
+  list->valmem = new->valmem;
+  pfree(new);
+  fclose(spill->file);
+  pfree(spill);
+  list->spill = NULL;
+  return;
+}
+
+/**
+ * @brief Enforce the memory limit before splicing new values into the list
+ */
+static void
+skiplist_spill_check(SkipList *list, Span *p)
+{
+  SkipListSpill *spill = (SkipListSpill *) list->spill;
+  /* If the new values reach back into the spilled time range, read the
+   * spilled values back before splicing */
+  if (spill && DatumGetTimestampTz(p->lower) <= spill->maxt)
+    skiplist_unspill(list);
+  if (sizeof(SkipListElem) * list->capacity + list->valmem >
+      _skiplist_mem_limit)
+    skiplist_spill(list, p);
+  return;
+}
+#endif /* MEOS */
+
+/*****************************************************************************/
+
+/**
+ * @brief Comparator function for sorting the insertion buffer on the
+ * timestamps of the instants
+ */
+static int
+tinstant_cmp_timestamp(const void *a, const void *b)
+{
+  const TInstant *inst1 = *(const TInstant **) a;
+  const TInstant *inst2 = *(const TInstant **) b;
+  return timestamptz_cmp_internal(inst1->t, inst2->t);
+}
+
+/**
+ * @brief Splice the values held in the insertion buffer into the skiplist
+ *
+ * The buffered values are sorted when some of them arrived out of order and
+ * the values falling on the same timestamp are aggregated beforehand, so
+ * that a single splice with distinct increasing timestamps remains.
+ */
+static void
+skiplist_flush_buffer(SkipList *list)
+{
+  int count = list->buffercount;
+  if (count == 0)
+    return;
+  list->buffercount = 0;
+  if (! list->buffersorted)
+    qsort(list->buffer, count, sizeof(void *), &tinstant_cmp_timestamp);
+  list->buffersorted = true;
+
+  /* Aggregate the values falling on the same timestamp */
+  datum_func2 func = list->bufferfunc;
+  int newcount = 0;
+  for (int i = 1; i < count; i++)
+  {
+    TInstant *prev = (TInstant *) list->buffer[newcount];
+    TInstant *inst = (TInstant *) list->buffer[i];
+    if (prev->t != inst->t)
+    {
+      list->buffer[++newcount] = inst;
+      continue;
+    }
+    if (func == NULL)
+    {
+      if (! tinstant_eq(prev, inst))
+      {
+        meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "Unable to merge values");
+        return;
+      }
+    }
+    else
+    {
+      list->buffer[newcount] = tinstant_make(func(tinstant_value(prev),
+        tinstant_value(inst)), prev->temptype, prev->t);
+      pfree(prev);
+    }
+    pfree(inst);
+  }
+  newcount++;
+
+  skiplist_splice(list, list->buffer, newcount, func, list->buffercross);
+  /* The values were copied into the skiplist by the splice */
+  for (int i = 0; i < newcount; i++)
+    pfree(list->buffer[i]);
+  return;
+}
+
+/**
+ * @brief Splice a single instant into the skiplist through the insertion
+ * buffer, which absorbs bounded disorder of the input
+ *
+ * Instants are accumulated in a small buffer that is spliced in one batch
+ * when it fills up or when the state is read. Stragglers arriving out of
+ * their time order only mark the buffer as unsorted and are sorted at the
+ * next flush, so that input with bounded disorder does not require an
+ * external sort in front of the aggregation.
+ */
+void
+skiplist_splice_buffered(SkipList *list, void *value, datum_func2 func,
+  bool crossings)
+{
+  /* The buffer can only absorb instant values */
+  Temporal *temp = (Temporal *) value;
+  if (temp->subtype != TINSTANT ||
+      ((Temporal *) skiplist_headval(list))->subtype != TINSTANT)
+  {
+    skiplist_splice(list, &value, 1, func, crossings);
+    return;
+  }
+
+#if ! MEOS
+  MemoryContext oldctx = set_aggregation_context(fetch_fcinfo());
+#endif /* ! MEOS */
+  if (list->buffer == NULL)
+    list->buffer = palloc(sizeof(void *) * SKIPLIST_BUFFER_SIZE);
+  TInstant *inst = tinstant_copy((TInstant *) value);
+#if ! MEOS
+  unset_aggregation_context(oldctx);
+#endif /* ! MEOS */
+  if (list->buffercount == 0)
+    list->buffersorted = true;
+  else if (list->buffersorted &&
+      ((TInstant *) list->buffer[list->buffercount - 1])->t > inst->t)
+    list->buffersorted = false;
+  list->buffer[list->buffercount++] = inst;
+  list->bufferfunc = func;
+  list->buffercross = crossings;
+  if (list->buffercount == SKIPLIST_BUFFER_SIZE)
+    skiplist_flush_buffer(list);
+  return;
+}
+
 /**
  * @brief Splice the skiplist with the array of values using the aggregation
  * function
@@ -468,6 +905,10 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
   MemoryContext oldctx;
 #endif /* ! MEOS */
 
+  /* Splice the pending buffered instants first, if any */
+  if (list->buffercount > 0)
+    skiplist_flush_buffer(list);
+
   assert(list->length > 0);
 
   /* Temporal aggregation cannot mix instants and sequences */
@@ -506,6 +947,20 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
       first->period.lower_inc, last->period.upper_inc, T_TIMESTAMPTZ, &p);
   }
 
+#if MEOS
+  /* If a memory limit is set, spill the elements strictly before the new
+   * values to a temporary file: with time-ordered input they will not be
+   * touched again until the final value is requested */
+  if (_skiplist_mem_limit != 0)
+    skiplist_spill_check(list, &p);
+#endif /* MEOS */
+
+  /* Rebuild the element pool in time order when previous merges have
+   * scattered it; the free list holding a large fraction of the pool is the
+   * sign that allocation order and time order have diverged */
+  if (list->freecount * 2 > list->next)
+    skiplist_compact(list);
+
   /* Find the list values that are strictly before the span of new values */
   int update[SKIPLIST_MAXLEVEL];
   memset(update, 0, sizeof(update));
@@ -519,6 +974,9 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
     {
       cur = e->next[level];
       e = &list->elems[cur];
+      /* Overlap the fetch of the element after the one compared next with
+       * the comparison itself */
+      SKIPLIST_PREFETCH(list, e->next[level]);
     }
     update[level] = cur;
   }
@@ -532,6 +990,7 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
   {
     cur = e->next[0];
     e = &list->elems[cur];
+    SKIPLIST_PREFETCH(list, e->next[0]);
     spliced_count++;
   }
   upper = cur;
@@ -553,6 +1012,7 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
         prev->next[level] = list->elems[cur].next[level];
       }
       spliced[spliced_count++] = list->elems[cur].value;
+      list->valmem -= VARSIZE(list->elems[cur].value);
       skiplist_delete(list, cur);
       cur = list->elems[cur].next[0];
     }
@@ -613,6 +1073,7 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
     oldctx = set_aggregation_context(fetch_fcinfo());
 #endif /* ! MEOS */
     newelm->value = temporal_copy(values[i]);
+    list->valmem += VARSIZE(newelm->value);
 #if ! MEOS
     unset_aggregation_context(oldctx);
 #endif /* ! MEOS */
@@ -642,6 +1103,14 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
 void **
 skiplist_values(SkipList *list)
 {
+  /* Splice the pending buffered instants first, if any */
+  if (list->buffercount > 0)
+    skiplist_flush_buffer(list);
+#if MEOS
+  /* Read the spilled values back since the result must contain them */
+  if (list->spill)
+    skiplist_unspill(list);
+#endif /* MEOS */
 #if ! MEOS
   MemoryContext ctx = set_aggregation_context(fetch_fcinfo());
 #endif /* ! MEOS */
@@ -665,6 +1134,14 @@ skiplist_values(SkipList *list)
 Temporal **
 skiplist_temporal_values(SkipList *list)
 {
+  /* Splice the pending buffered instants first, if any */
+  if (list->buffercount > 0)
+    skiplist_flush_buffer(list);
+#if MEOS
+  /* Read the spilled values back since the result must contain them */
+  if (list->spill)
+    skiplist_unspill(list);
+#endif /* MEOS */
   Temporal **result = palloc(sizeof(Temporal *) * list->length);
   int cur = list->elems[0].next[0];
   int count = 0;
@@ -562,6 +562,90 @@ period_make(TimestampTz lower, TimestampTz upper, bool lower_inc,
     upper_inc, T_TIMESTAMPTZ, s);
   return s;
 }
+
+/**
+ * @ingroup libmeos_setspan_constructor
+ * @brief Construct an array of integer spans from arrays of bounds
+ *
+ * The bounds are given in the canonical form for discrete types, that is,
+ * inclusive lower and exclusive upper, so the spans are filled in a single
+ * allocation without per-span normalization.
+ *
+ * @param[in] lowers Array of inclusive lower bounds
+ * @param[in] uppers Array of exclusive upper bounds
+ * @param[in] count Number of elements in the input arrays
+ * @sqlfunc intspan()
+ */
+Span *
+intspanarr_make(const int *lowers, const int *uppers, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) lowers) ||
+      ! ensure_not_null((void *) uppers) || ! ensure_positive(count))
+    return NULL;
+  /* Note: zero-fill is required here, just as in heap tuples */
+  Span *result = palloc0(sizeof(Span) * count);
+  for (int i = 0; i < count; i++)
+  {
+    if (lowers[i] >= uppers[i])
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Span lower bound must be less than the exclusive upper bound");
+      pfree(result);
+      return NULL;
+    }
+    Span *s = &result[i];
+    s->lower = Int32GetDatum(lowers[i]);
+    s->upper = Int32GetDatum(uppers[i]);
+    s->lower_inc = true;
+    s->upper_inc = false;
+    s->spantype = T_INTSPAN;
+    s->basetype = T_INT4;
+  }
+  return result;
+}
+
+/**
+ * @ingroup libmeos_setspan_constructor
+ * @brief Construct an array of big integer spans from arrays of bounds
+ *
+ * The bounds are given in the canonical form for discrete types, that is,
+ * inclusive lower and exclusive upper, so the spans are filled in a single
+ * allocation without per-span normalization.
+ *
+ * @param[in] lowers Array of inclusive lower bounds
+ * @param[in] uppers Array of exclusive upper bounds
+ * @param[in] count Number of elements in the input arrays
+ * @sqlfunc bigintspan()
+ */
+Span *
+bigintspanarr_make(const int64 *lowers, const int64 *uppers, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) lowers) ||
+      ! ensure_not_null((void *) uppers) || ! ensure_positive(count))
+    return NULL;
+  /* Note: zero-fill is required here, just as in heap tuples */
+  Span *result = palloc0(sizeof(Span) * count);
+  for (int i = 0; i < count; i++)
+  {
+    if (lowers[i] >= uppers[i])
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Span lower bound must be less than the exclusive upper bound");
+      pfree(result);
+      return NULL;
+    }
+    Span *s = &result[i];
+    s->lower = Int64GetDatum(lowers[i]);
+    s->upper = Int64GetDatum(uppers[i]);
+    s->lower_inc = true;
+    s->upper_inc = false;
+    s->spantype = T_BIGINTSPAN;
+    s->basetype = T_INT8;
+  }
+  return result;
+}
 #endif /* MEOS */
 
 /**
@@ -574,35 +658,22 @@ span_set(Datum lower, Datum upper, bool lower_inc, bool upper_inc,
   meosType basetype, Span *s)
 {
   assert(s);
-  /* Canonicalize */
+  /* Canonicalize to inclusive lower and exclusive upper bounds. The bound
+   * adjustments are branchless: the excluded flags are added as 0 or 1 */
   if (span_canon_basetype(basetype))
   {
     if (basetype == T_INT4)
     {
-      if (! lower_inc)
-      {
-        lower = Int32GetDatum(DatumGetInt32(lower) + 1);
-        lower_inc = true;
-      }
-      if (upper_inc)
-      {
-        upper = Int32GetDatum(DatumGetInt32(upper) + 1);
-        upper_inc = false;
-      }
+      lower = Int32GetDatum(DatumGetInt32(lower) + (int32) ! lower_inc);
+      upper = Int32GetDatum(DatumGetInt32(upper) + (int32) upper_inc);
     }
     else /* basetype == T_INT8 */
     {
-      if (! lower_inc)
-      {
-        lower = Int64GetDatum(DatumGetInt64(lower) + 1);
-        lower_inc = true;
-      }
-      if (upper_inc)
-      {
-        upper = Int64GetDatum(DatumGetInt64(upper) + 1);
-        upper_inc = false;
-      }
+      lower = Int64GetDatum(DatumGetInt64(lower) + (int64) ! lower_inc);
+      upper = Int64GetDatum(DatumGetInt64(upper) + (int64) upper_inc);
     }
+    lower_inc = true;
+    upper_inc = false;
   }
 
   meosType spantype = basetype_spantype(basetype);
@@ -39,6 +39,7 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/span.h"
 #include "general/spanset.h"
 #include "general/type_util.h"
 
@@ -46,6 +47,28 @@
  * Aggregate functions for span set types
  *****************************************************************************/
 
+/**
+ * @brief Merge in place the accumulated spans of an unordered span set.
+ *
+ * The aggregated spans are accumulated unnormalized and thus, when they
+ * overlap heavily, the state grows with the number of aggregated spans
+ * rather than with the number of distinct spans of the result. Merging the
+ * accumulated spans every time the state fills up bounds the state and the
+ * cost of the final function by the size of the merged result, while the
+ * periodic merges process every slot of the state at most once per doubling.
+ */
+static void
+spanset_merge_elems(SpanSet *ss)
+{
+  if (ss->count < 2)
+    return;
+  int newcount;
+  Span *newspans = spanarr_normalize(ss->elems, ss->count, true, &newcount);
+  memcpy(ss->elems, newspans, sizeof(Span) * newcount);
+  ss->count = newcount;
+  pfree(newspans);
+}
+
 /**
  * @brief Append a span to an unordered span set.
  * @param[in,out] ss Span set
@@ -68,6 +91,19 @@ spanset_append_span(SpanSet *ss, const Span *span, bool expand)
     return ss;
   }
 
+  /* Merge the accumulated spans and append into the freed space when the
+   * merge recovered at least a quarter of the slots */
+  if (expand)
+  {
+    spanset_merge_elems(ss);
+    if (ss->count <= ss->maxcount - ss->maxcount / 4)
+    {
+      ss->elems[ss->count++] = *span;
+      span_expand(span, &ss->span);
+      return ss;
+    }
+  }
+
   /* This is the first time we use an expandable structure or there is no more
    * free space */
   Span *spans = palloc(sizeof(Span) * (ss->count + 1));
@@ -111,6 +147,22 @@ spanset_append_spanset(SpanSet *ss1, const SpanSet *ss2, bool expand)
     return ss1;
   }
 
+  /* Merge the accumulated spans and append into the freed space when the
+   * merge recovered enough slots for the new span set */
+  if (expand)
+  {
+    spanset_merge_elems(ss1);
+    if (ss1->count + ss2->count <= ss1->maxcount - ss1->maxcount / 4)
+    {
+      for (int i = 0; i < ss2->count; i++)
+      {
+        ss1->elems[ss1->count++] = ss2->elems[i];
+        span_expand(&ss2->elems[i], &ss1->span);
+      }
+      return ss1;
+    }
+  }
+
   /* This is the first time we use an expandable structure or there is no more
    * free space */
   int count = ss1->count + ss2->count;
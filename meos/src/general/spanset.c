@@ -49,6 +49,7 @@
 #include <meos_internal.h>
 #include "general/pg_types.h"
 #include "general/span.h"
+#include "general/temporal_tile.h"
 #include "general/type_parser.h"
 #include "general/type_util.h"
 
@@ -186,6 +187,126 @@ spanset_sp_n(const SpanSet *ss, int index)
   return &ss->elems[index];
 }
 
+/*****************************************************************************
+ * Span set index
+ *****************************************************************************/
+
+/**
+ * @brief Return a pointer to the array mapping every Eytzinger slot of a span
+ * set index to the position of its span in the span set
+ */
+#define SPANSET_INDEX_POS(idx) ((int32 *) ((idx)->lowers + (idx)->count + 1))
+
+/**
+ * @brief Recursively fill the Eytzinger slots of a span set index with the
+ * lower bounds of the spans, which are visited in order
+ * @param[in] ss Span set
+ * @param[in,out] idx Span set index
+ * @param[in] i Position of the next span to place
+ * @param[in] k Eytzinger slot to fill
+ * @result Position of the next span to place after the subtree rooted at @p k
+ */
+static int
+spanset_index_fill(const SpanSet *ss, SpanIndex *idx, int i, int k)
+{
+  if (k <= idx->count)
+  {
+    i = spanset_index_fill(ss, idx, i, 2 * k);
+    idx->lowers[k] = ss->elems[i].lower;
+    SPANSET_INDEX_POS(idx)[k] = i++;
+    i = spanset_index_fill(ss, idx, i, 2 * k + 1);
+  }
+  return i;
+}
+
+/**
+ * @ingroup libmeos_setspan_constructor
+ * @brief Construct a search index over the lower bounds of a span set.
+ *
+ * The index stores the lower bounds of the spans in Eytzinger (breadth-first)
+ * order, so that repeated point probes on large span sets descend a
+ * branch-free, cache-friendly implicit tree instead of binary searching the
+ * span array. The index references the span set by position and thus must be
+ * rebuilt after the span set is modified.
+ * @param[in] ss Span set
+ * @see spanset_index_find_value
+ */
+SpanIndex *
+spanset_index_make(const SpanSet *ss)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) ss))
+    return NULL;
+  /* The first Eytzinger slot is already declared in the struct and is left
+   * unused so that the slot numbering can start at 1 */
+  size_t memsize = sizeof(SpanIndex) + sizeof(Datum) * ss->count +
+    sizeof(int32) * (ss->count + 1);
+  SpanIndex *result = palloc0(memsize);
+  result->count = ss->count;
+  result->basetype = ss->basetype;
+  spanset_index_fill(ss, result, 0, 1);
+  return result;
+}
+
+/**
+ * @brief Return the location of a value in a span set using an Eytzinger
+ * descent over a span set index.
+ *
+ * The function has the same semantics as #spanset_find_value for both the
+ * result and the output parameter but performs the lookup with a branch-free
+ * loop over the Eytzinger-ordered lower bounds. Since the spans are disjoint
+ * and ordered, the only span that may contain the value is the one with the
+ * last lower bound not greater than the value or, when the value coincides
+ * with an exclusive lower bound, the previous one.
+ * @param[in] ss Span set
+ * @param[in] idx Span set index built from the span set
+ * @param[in] v Value
+ * @param[out] loc Location
+ * @result Return true if the value is contained in the span set
+ */
+bool
+spanset_index_find_value(const SpanSet *ss, const SpanIndex *idx, Datum v,
+  int *loc)
+{
+  assert(ss); assert(idx);
+  assert(ss->count == idx->count && ss->basetype == idx->basetype);
+  int k = 1, best = 0;
+  while (k <= idx->count)
+  {
+    /* Go right when the slot's lower bound is not greater than the value,
+     * remembering the last such slot, which holds the predecessor */
+    int right = datum_le(idx->lowers[k], v, idx->basetype) ? 1 : 0;
+    best = right ? k : best;
+    k = 2 * k + right;
+  }
+  if (best == 0)
+  {
+    /* The value is before the lower bound of the first span */
+    *loc = 0;
+    return false;
+  }
+  int i = SPANSET_INDEX_POS(idx)[best];
+  const Span *s = &ss->elems[i];
+  if (contains_span_value(s, v, s->basetype))
+  {
+    *loc = i;
+    return true;
+  }
+  /* When the value is equal to an exclusive lower bound it may still be the
+   * inclusive upper bound of the previous span */
+  if (i > 0)
+  {
+    s = &ss->elems[i - 1];
+    if (contains_span_value(s, v, s->basetype))
+    {
+      *loc = i - 1;
+      return true;
+    }
+  }
+  *loc = datum_ge(v, ss->elems[i].upper, ss->basetype) ? i + 1 : i;
+  return false;
+}
+
 /*****************************************************************************
  * Input/output functions
  *****************************************************************************/
@@ -268,18 +389,60 @@ spanset_out(const SpanSet *ss, int maxdd)
     return NULL;
 
   char **strings = palloc(sizeof(char *) * ss->count);
+  size_t *lengths = palloc(sizeof(size_t) * ss->count);
   size_t outlen = 0;
   for (int i = 0; i < ss->count; i++)
   {
     const Span *s = spanset_sp_n(ss, i);
     strings[i] = span_out(s, maxdd);
-    outlen += strlen(strings[i]) + 1;
+    lengths[i] = strlen(strings[i]);
+    outlen += lengths[i] + 1;
   }
-  return stringarr_to_string(strings, ss->count, outlen, "", '{', '}',
-    QUOTES_NO, SPACES);
+  char *result = stringarr_to_string(strings, lengths, ss->count, outlen, "",
+    '{', '}', QUOTES_NO, SPACES);
+  pfree(lengths);
+  return result;
 }
 
 #if MEOS
+/**
+ * @ingroup libmeos_setspan_inout
+ * @brief Write the Well-Known Text (WKT) representation of a span set to an
+ * output callback in chunks.
+ *
+ * Streaming counterpart of the output functions, which produces the result
+ * with constant memory instead of materializing the whole string.
+ * @param[in] ss Span set
+ * @param[in] maxdd Maximum number of decimal digits
+ * @param[in] chunksize Size in bytes of the output buffer, at least 1024
+ * @param[in] writefn Callback receiving the successive chunks
+ * @param[in] state Opaque state passed to the callback
+ * @return True on success
+ */
+bool
+spanset_out_stream(const SpanSet *ss, int maxdd, size_t chunksize,
+  size_t (*writefn)(const char *, size_t, void *), void *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) ss) || ! ensure_not_null((void *) writefn) ||
+      ! ensure_not_negative(maxdd))
+    return false;
+
+  StringWriter writer;
+  string_writer_init(&writer, chunksize, writefn, state);
+  string_writer_append(&writer, "{", 1);
+  for (int i = 0; i < ss->count; i++)
+  {
+    if (i > 0)
+      string_writer_append(&writer, ", ", 2);
+    char *str = span_out(spanset_sp_n(ss, i), maxdd);
+    string_writer_append(&writer, str, strlen(str));
+    pfree(str);
+  }
+  string_writer_append(&writer, "}", 1);
+  return string_writer_finish(&writer);
+}
+
 /**
  * @ingroup libmeos_setspan_inout
  * @brief Return the Well-Known Text (WKT) representation of a span set.
@@ -556,6 +719,20 @@ set_to_spanset(const Set *s)
   return spanset_make_free(spans, s->count, NORMALIZE_NO);
 }
 
+/**
+ * @ingroup libmeos_setspan_conversion
+ * @brief Convert a set as a span set and free the set after the conversion.
+ * @sqlop @p ::
+ */
+SpanSet *
+set_to_spanset_free(Set *s)
+{
+  SpanSet *result = set_to_spanset(s);
+  if (s)
+    pfree(s);
+  return result;
+}
+
 /**
  * @ingroup libmeos_setspan_conversion
  * @brief Convert a period as a period set.
@@ -1474,3 +1651,184 @@ spanset_hash_extended(const SpanSet *ss, uint64 seed)
 }
 
 /*****************************************************************************/
+
+#if MEOS
+/*****************************************************************************
+ * Periodic span set
+ *****************************************************************************/
+
+/**
+ * Structure for storing a periodic timestamptz span set, that is, a pattern
+ * span set repeated a number of times at a fixed recurrence period. Periodic
+ * values such as weekly schedules are stored as the pattern of a single
+ * cycle, and the predicate functions evaluate directly on the compressed
+ * form by translating their argument into the cycle it falls in
+ */
+struct PeriodicSpanSet
+{
+  SpanSet *pattern;  /**< Span set of the first cycle */
+  int64 period;      /**< Length of a cycle in microseconds */
+  int count;         /**< Number of cycles */
+};
+
+/**
+ * @ingroup libmeos_setspan_constructor
+ * @brief Construct a periodic span set from the span set of its first cycle,
+ * the recurrence period, and the number of cycles.
+ *
+ * The i-th cycle of the result is the pattern shifted forward by i periods.
+ * The pattern must fit within one period, that is, the duration of its
+ * bounding span cannot exceed the period.
+ * @param[in] pattern Span set of the first cycle
+ * @param[in] period Length of a cycle
+ * @param[in] count Number of cycles
+ * @see periodic_tstzspanset_expand
+ */
+PeriodicSpanSet *
+periodic_tstzspanset_make(const SpanSet *pattern, const Interval *period,
+  int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pattern) ||
+      ! ensure_not_null((void *) period) || ! ensure_positive(count) ||
+      ! ensure_spanset_has_type(pattern, T_TSTZSPANSET))
+    return NULL;
+  int64 units = interval_units(period);
+  if (units <= 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The period must be strictly positive");
+    return NULL;
+  }
+  if (DatumGetTimestampTz(pattern->span.upper) -
+      DatumGetTimestampTz(pattern->span.lower) > units)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The pattern must fit within one period of the recurrence");
+    return NULL;
+  }
+  PeriodicSpanSet *result = palloc(sizeof(PeriodicSpanSet));
+  result->pattern = spanset_copy(pattern);
+  result->period = units;
+  result->count = count;
+  return result;
+}
+
+/**
+ * @ingroup libmeos_setspan_transf
+ * @brief Expand a periodic span set into an ordinary span set containing
+ * every cycle of the recurrence.
+ * @param[in] pss Periodic span set
+ */
+SpanSet *
+periodic_tstzspanset_expand(const PeriodicSpanSet *pss)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pss))
+    return NULL;
+  const SpanSet *pattern = pss->pattern;
+  Span *spans = palloc(sizeof(Span) * pattern->count * pss->count);
+  int nspans = 0;
+  for (int i = 0; i < pss->count; i++)
+  {
+    int64 shift = (int64) i * pss->period;
+    for (int j = 0; j < pattern->count; j++)
+    {
+      const Span *s = spanset_sp_n(pattern, j);
+      Span *s1 = &spans[nspans++];
+      memcpy(s1, s, sizeof(Span));
+      s1->lower = TimestampTzGetDatum(DatumGetTimestampTz(s->lower) + shift);
+      s1->upper = TimestampTzGetDatum(DatumGetTimestampTz(s->upper) + shift);
+    }
+  }
+  return spanset_make_free(spans, nspans, NORMALIZE);
+}
+
+/**
+ * @ingroup libmeos_setspan_topo
+ * @brief Return true if a periodic span set contains a timestamp.
+ *
+ * The timestamp is translated into the cycle it falls in and tested against
+ * the pattern, so the predicate is evaluated on the compressed form without
+ * expanding the recurrence.
+ * @param[in] pss Periodic span set
+ * @param[in] t Timestamp
+ */
+bool
+periodic_tstzspanset_contains_timestamp(const PeriodicSpanSet *pss,
+  TimestampTz t)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pss))
+    return false;
+  TimestampTz base = DatumGetTimestampTz(pss->pattern->span.lower);
+  if (t < base)
+    return false;
+  int64 cycle = (t - base) / pss->period;
+  if (cycle >= pss->count)
+    return false;
+  return contains_periodset_timestamp(pss->pattern,
+    t - cycle * pss->period);
+}
+
+/**
+ * @ingroup libmeos_setspan_topo
+ * @brief Return true if a periodic span set and a period overlap.
+ *
+ * Only the cycles intersecting the period are tested, each by translating
+ * the period back onto the pattern, so the predicate is evaluated on the
+ * compressed form without expanding the recurrence.
+ * @param[in] pss Periodic span set
+ * @param[in] s Period
+ */
+bool
+periodic_tstzspanset_overlaps_period(const PeriodicSpanSet *pss,
+  const Span *s)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pss) || ! ensure_not_null((void *) s))
+    return false;
+  TimestampTz base = DatumGetTimestampTz(pss->pattern->span.lower);
+  TimestampTz lower = DatumGetTimestampTz(s->lower);
+  TimestampTz upper = DatumGetTimestampTz(s->upper);
+  if (upper < base)
+    return false;
+  /* Compute the range of cycles the period intersects */
+  int64 first = (lower <= base) ? 0 : (lower - base) / pss->period;
+  if (first >= pss->count)
+    return false;
+  int64 last = (upper - base) / pss->period;
+  if (last >= pss->count)
+    last = pss->count - 1;
+  for (int64 i = first; i <= last; i++)
+  {
+    /* Translate the period back onto the pattern */
+    int64 shift = i * pss->period;
+    Span s1;
+    memcpy(&s1, s, sizeof(Span));
+    s1.lower = TimestampTzGetDatum(lower - shift);
+    s1.upper = TimestampTzGetDatum(upper - shift);
+    if (overlaps_spanset_span(pss->pattern, &s1))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @ingroup libmeos_setspan_constructor
+ * @brief Free a periodic span set
+ * @param[in] pss Periodic span set
+ */
+void
+periodic_tstzspanset_free(PeriodicSpanSet *pss)
+{
+  if (! pss)
+    return;
+  pfree(pss->pattern);
+  pfree(pss);
+  return;
+}
+
+#endif /* MEOS */
+
+/*****************************************************************************/
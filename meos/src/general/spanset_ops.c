@@ -228,6 +228,35 @@ contains_periodset_timestamp(const SpanSet *ss, TimestampTz t)
   return contains_spanset_value(ss, TimestampTzGetDatum(t), T_TIMESTAMPTZ);
 }
 
+#if MEOS
+/**
+ * @ingroup libmeos_setspan_topo
+ * @brief Return true if a period set contains a timestamp performing the
+ * lookup with a span set index.
+ *
+ * This function answers repeated probes on the same large period set faster
+ * than #contains_periodset_timestamp by descending the Eytzinger-ordered
+ * lower bounds of the index instead of binary searching the span array.
+ * @sqlop @p \@>
+ * @see spanset_index_make
+ */
+bool
+contains_periodset_timestamp_idx(const SpanSet *ss, const SpanIndex *idx,
+  TimestampTz t)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) ss) || ! ensure_not_null((void *) idx) ||
+      ! ensure_same_spanset_basetype(ss, T_TIMESTAMPTZ))
+    return false;
+  /* Bounding box test */
+  Datum d = TimestampTzGetDatum(t);
+  if (! contains_span_value(&ss->span, d, T_TIMESTAMPTZ))
+    return false;
+  int loc;
+  return spanset_index_find_value(ss, idx, d, &loc);
+}
+#endif /* MEOS */
+
 /**
  * @ingroup libmeos_setspan_topo
  * @brief Return true if a span set contains a span.
@@ -1402,6 +1431,51 @@ overright_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2)
   return overright_span_span(s1, s2);
 }
 
+/*****************************************************************************
+ * Galloping search
+ *****************************************************************************/
+
+/**
+ * @brief Return the first position greater than or equal to @p idx of a span
+ * in a span set whose upper bound is greater than or equal to a value
+ *
+ * The function uses galloping (exponential) search over the contiguous array
+ * of spans: the probe distance doubles until a candidate is found and a
+ * binary search narrows down the remaining range. This advances the merge
+ * loops of the set operations below in logarithmic instead of linear time
+ * over stretches of a span set that cannot contribute to the result, which
+ * matters when the two operands have very different extents.
+ */
+static int
+spanset_gallop_left(const SpanSet *ss, int idx, Datum value)
+{
+  meosType basetype = ss->basetype;
+  if (idx >= ss->count || ! datum_lt(ss->elems[idx].upper, value, basetype))
+    return idx;
+  int step = 1;
+  int last = idx;
+  /* Double the probe distance while the probed span is strictly left of the
+   * value */
+  while (idx + step < ss->count &&
+    datum_lt(ss->elems[idx + step].upper, value, basetype))
+  {
+    last = idx + step;
+    step <<= 1;
+  }
+  /* Binary search in the remaining range (last, upper] */
+  int first = last + 1;
+  last = Min(idx + step, ss->count - 1);
+  while (first <= last)
+  {
+    int middle = (first + last) / 2;
+    if (datum_lt(ss->elems[middle].upper, value, basetype))
+      first = middle + 1;
+    else
+      last = middle - 1;
+  }
+  return first;
+}
+
 /*****************************************************************************
  * Set union
  *****************************************************************************/
@@ -1522,18 +1596,29 @@ union_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2)
   {
     const Span *s1 = spanset_sp_n(ss1, i);
     const Span *s2 = spanset_sp_n(ss2, j);
-    /* The spans do not overlap, copy the earliest span */
+    /* The spans do not overlap, copy in one step the whole run of spans of
+     * the earliest span set that end strictly before the other span starts */
     if (! overlaps_span_span(s1, s2))
     {
       if (left_span_span(s1, s2))
       {
-        spans[nspans++] = *s1;
-        i++;
+        int k = spanset_gallop_left(ss1, i, s2->lower);
+        if (k == i)
+          /* s1 is left of s2 only due to the exclusive bounds */
+          k = i + 1;
+        memcpy(&spans[nspans], &ss1->elems[i], sizeof(Span) * (k - i));
+        nspans += k - i;
+        i = k;
       }
       else
       {
-        spans[nspans++] = *s2;
-        j++;
+        int k = spanset_gallop_left(ss2, j, s1->lower);
+        if (k == j)
+          /* s2 is left of s1 only due to the exclusive bounds */
+          k = j + 1;
+        memcpy(&spans[nspans], &ss2->elems[j], sizeof(Span) * (k - j));
+        nspans += k - j;
+        j = k;
       }
     }
     else
@@ -1773,6 +1858,18 @@ intersection_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2)
   {
     const Span *s1 = spanset_sp_n(ss1, i);
     const Span *s2 = spanset_sp_n(ss2, j);
+    /* Skip in logarithmic time the run of spans that end strictly before the
+     * other span starts and thus cannot contribute to the result */
+    if (datum_lt(s1->upper, s2->lower, ss1->basetype))
+    {
+      i = spanset_gallop_left(ss1, i, s2->lower);
+      continue;
+    }
+    if (datum_lt(s2->upper, s1->lower, ss2->basetype))
+    {
+      j = spanset_gallop_left(ss2, j, s1->lower);
+      continue;
+    }
     Span inter;
     if (inter_span_span(s1, s2, &inter))
       spans[nspans++] = inter;
@@ -2112,11 +2209,29 @@ minus_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2)
   {
     const Span *s1 = spanset_sp_n(ss1, i);
     const Span *s2 = spanset_sp_n(ss2, j);
-    /* The spans do not overlap, copy the first span */
+    /* The spans do not overlap, copy in one step the whole run of spans of
+     * ss1 that end strictly before s2 starts, or skip the run of spans of
+     * ss2 that cannot remove anything from the current span of ss1 */
     if (! overlaps_span_span(s1, s2))
     {
-      spans[nspans++] = *s1;
-      i++;
+      if (left_span_span(s1, s2))
+      {
+        int k = spanset_gallop_left(ss1, i, s2->lower);
+        if (k == i)
+          /* s1 is left of s2 only due to the exclusive bounds */
+          k = i + 1;
+        memcpy(&spans[nspans], &ss1->elems[i], sizeof(Span) * (k - i));
+        nspans += k - i;
+        i = k;
+      }
+      else
+      {
+        int k = spanset_gallop_left(ss2, j, s1->lower);
+        if (k == j)
+          /* s2 is left of s1 only due to the exclusive bounds */
+          k = j + 1;
+        j = k;
+      }
     }
     else
     {
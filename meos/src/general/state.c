@@ -0,0 +1,374 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Concurrent snapshot store of the latest state per moving object
+ *
+ * Fleet applications keep the current state of every vehicle, updated by
+ * the ingestion threads at a rate far beyond what a database table absorbs
+ * comfortably, and read by dashboards that want a consistent picture of the
+ * whole fleet. The store below keeps one fixed-size slot per object holding
+ * the latest observed instant. Writers never block: a publish claims the
+ * slot of its object with a per-slot sequence lock, copies the instant in
+ * place, and releases the lock, so concurrent readers at most retry the
+ * copy of that single slot. Readers take either the latest instant of one
+ * object or a snapshot of the whole fleet.
+ *
+ * Every publish is stamped with a value drawn from a global epoch counter.
+ * A snapshot observes the counter before visiting the slots, so it is
+ * epoch consistent: it contains every publish stamped up to the returned
+ * epoch and no torn value; publishes racing with the snapshot may or may
+ * not appear, as they would had the snapshot been taken an instant later.
+ *
+ * The slots are sized to one cache line so that publishes of distinct
+ * objects do not interfere; instants larger than the inline buffer, which
+ * does not happen for the usual point and number state, are rejected.
+ */
+
+/* C */
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+/* Postgres */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+
+/*****************************************************************************/
+
+/** Size of the inline instant buffer of a slot; the slot then fills two
+ * cache lines together with its identifier, lock, and epoch */
+#define MEOS_STATE_MAXSIZE 104
+/** Maximum fill fraction of the slot table, in tenths */
+#define MEOS_STATE_MAXFILL 8
+
+/**
+ * @brief Slot keeping the latest instant of one moving object
+ *
+ * The version counter is a sequence lock: it is odd while a writer copies
+ * into the buffer and even otherwise, and a reader retries when the counter
+ * is odd or changed during its copy. The identifier is claimed once with a
+ * compare-and-swap and never changes afterwards.
+ */
+typedef struct MeosStateSlot
+{
+  _Atomic(int64) id;          /**< Object identifier, 0 for an empty slot */
+  _Atomic(uint64) version;    /**< Sequence lock of the slot */
+  uint64 epoch;               /**< Epoch of the last publish */
+  char data[MEOS_STATE_MAXSIZE]; /**< Latest instant of the object */
+} MeosStateSlot;
+
+/**
+ * @brief Concurrent store keeping the latest instant of every moving object
+ */
+struct MeosStateStore
+{
+  int size;                   /**< Number of slots, a power of two */
+  _Atomic(int) count;         /**< Number of objects inserted */
+  _Atomic(uint64) epoch;      /**< Counter stamping the publishes */
+  MeosStateSlot *slots;       /**< The slots, open addressing */
+};
+
+/**
+ * @brief Mix the identifier of an object into a well-distributed hash
+ */
+static uint64
+meos_state_hash(int64 id)
+{
+  uint64 h = (uint64) id;
+  h ^= h >> 33;
+  h *= UINT64CONST(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * @brief Return the slot of an object, claiming an empty one when absent
+ * @param[in] store The store
+ * @param[in] id Identifier of the object
+ * @param[in] insert True when an absent object must be inserted
+ * @return NULL when the object is absent and not inserted, or the table is
+ * full
+ */
+static MeosStateSlot *
+meos_state_slot(const MeosStateStore *store, int64 id, bool insert)
+{
+  uint64 pos = meos_state_hash(id) & (store->size - 1);
+  for (int probe = 0; probe < store->size; probe++)
+  {
+    MeosStateSlot *slot = &store->slots[pos];
+    int64 cur = atomic_load_explicit(&slot->id, memory_order_acquire);
+    if (cur == id)
+      return slot;
+    if (cur == 0)
+    {
+      if (! insert)
+        return NULL;
+      /* Cap the fill so that the probe sequences stay short */
+      MeosStateStore *mstore = (MeosStateStore *) store;
+      if (atomic_load_explicit(&mstore->count, memory_order_relaxed) * 10 >=
+          store->size * MEOS_STATE_MAXFILL)
+        return NULL;
+      int64 expected = 0;
+      if (atomic_compare_exchange_strong(&slot->id, &expected, id))
+      {
+        atomic_fetch_add_explicit(&mstore->count, 1, memory_order_relaxed);
+        return slot;
+      }
+      /* Another writer claimed the slot first; it may be for the same id */
+      if (expected == id)
+        return slot;
+    }
+    pos = (pos + 1) & (store->size - 1);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Copy the instant of a slot into a buffer without tearing
+ * @param[in] slot The slot
+ * @param[out] buf Buffer of MEOS_STATE_MAXSIZE bytes
+ * @param[out] epoch Epoch of the copied publish, may be @p NULL
+ * @return False when the slot has never been published
+ */
+static bool
+meos_state_slot_read(const MeosStateSlot *slot, char *buf, uint64 *epoch)
+{
+  MeosStateSlot *mslot = (MeosStateSlot *) slot;
+  while (true)
+  {
+    uint64 v1 = atomic_load_explicit(&mslot->version, memory_order_acquire);
+    if (v1 == 0)
+      /* The slot is claimed but its first publish has not completed */
+      return false;
+    if (v1 & 1)
+      continue;
+    memcpy(buf, slot->data, MEOS_STATE_MAXSIZE);
+    uint64 e = slot->epoch;
+    /* The loads above must complete before the version is re-checked */
+    atomic_thread_fence(memory_order_acquire);
+    uint64 v2 = atomic_load_explicit(&mslot->version, memory_order_relaxed);
+    if (v1 == v2)
+    {
+      if (epoch)
+        *epoch = e;
+      return true;
+    }
+  }
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Start a concurrent store of the latest state per moving object
+ * @param[in] maxobjects Maximum number of distinct objects
+ * @return On error return @p NULL
+ */
+MeosStateStore *
+meos_state_store_start(int maxobjects)
+{
+  if (maxobjects < 1)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The store requires a positive maximum number of objects");
+    return NULL;
+  }
+  /* Size the table to the next power of two above the capped fill */
+  int size = 2;
+  while (size * MEOS_STATE_MAXFILL < maxobjects * 10)
+    size *= 2;
+  MeosStateStore *store = calloc(1, sizeof(MeosStateStore));
+  MeosStateSlot *slots = calloc(size, sizeof(MeosStateSlot));
+  if (! store || ! slots)
+  {
+    meos_error(ERROR, MEOS_ERR_MEMORY_ALLOC_ERROR,
+      "Unable to allocate the state store");
+    free(store); free(slots);
+    return NULL;
+  }
+  store->size = size;
+  store->slots = slots;
+  atomic_init(&store->count, 0);
+  atomic_init(&store->epoch, 0);
+  return store;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Publish the latest observed instant of a moving object
+ * @param[in] store The store
+ * @param[in] id Identifier of the moving object, not 0
+ * @param[in] inst Observed instant, copied and not kept
+ * @return True on success
+ *
+ * The publish is lock-free with respect to the readers; concurrent
+ * publishes of the same object are serialized on the slot of the object
+ * and the one ordered last by its sequence lock wins.
+ */
+bool
+meos_state_publish(MeosStateStore *store, int64 id, const TInstant *inst)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store) || ! ensure_not_null((void *) inst))
+    return false;
+  if (id == 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The object identifier 0 is reserved for empty slots");
+    return false;
+  }
+  size_t size = VARSIZE(inst);
+  if (size > MEOS_STATE_MAXSIZE)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The instant exceeds the %d bytes of a state slot",
+      MEOS_STATE_MAXSIZE);
+    return false;
+  }
+  MeosStateSlot *slot = meos_state_slot(store, id, true);
+  if (! slot)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The state store is full");
+    return false;
+  }
+  /* Claim the sequence lock of the slot by making the version odd */
+  uint64 v = atomic_load_explicit(&slot->version, memory_order_relaxed);
+  do
+  {
+    while (v & 1)
+      v = atomic_load_explicit(&slot->version, memory_order_relaxed);
+  }
+  while (! atomic_compare_exchange_weak_explicit(&slot->version, &v, v + 1,
+    memory_order_acquire, memory_order_relaxed));
+  slot->epoch = atomic_fetch_add_explicit(&store->epoch, 1,
+    memory_order_relaxed) + 1;
+  memcpy(slot->data, inst, size);
+  /* Release the lock, publishing the copy */
+  atomic_store_explicit(&slot->version, v + 2, memory_order_release);
+  return true;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Return a copy of the latest published instant of a moving object
+ * @param[in] store The store
+ * @param[in] id Identifier of the moving object
+ * @return NULL when nothing has been published for the object
+ */
+TInstant *
+meos_state_latest(const MeosStateStore *store, int64 id)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store))
+    return NULL;
+  const MeosStateSlot *slot = meos_state_slot(store, id, false);
+  if (! slot)
+    return NULL;
+  char buf[MEOS_STATE_MAXSIZE];
+  if (! meos_state_slot_read(slot, buf, NULL))
+    return NULL;
+  TInstant *result = palloc(VARSIZE(buf));
+  memcpy(result, buf, VARSIZE(buf));
+  return result;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Return a snapshot of the latest published instant of every object
+ * @param[in] store The store
+ * @param[out] ids Identifiers of the objects
+ * @param[out] count Number of objects
+ * @param[out] epoch Epoch of the snapshot, may be @p NULL
+ * @return Array of instants, in no particular order; on error return
+ * @p NULL
+ *
+ * The snapshot contains every publish stamped with an epoch up to the
+ * returned one and no torn value. Publishes racing with the snapshot may
+ * or may not be included.
+ */
+TInstant **
+meos_state_snapshot(const MeosStateStore *store, int64 **ids, int *count,
+  uint64 *epoch)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store) || ! ensure_not_null((void *) ids) ||
+      ! ensure_not_null((void *) count))
+    return NULL;
+
+  MeosStateStore *mstore = (MeosStateStore *) store;
+  /* Every publish stamped before this point is already in its slot or is
+   * caught by the per-slot retry below */
+  uint64 e = atomic_load_explicit(&mstore->epoch, memory_order_acquire);
+  int nobjects = atomic_load_explicit(&mstore->count, memory_order_relaxed);
+  TInstant **result = palloc(sizeof(TInstant *) * Max(nobjects, 1));
+  int64 *resultids = palloc(sizeof(int64) * Max(nobjects, 1));
+  int k = 0;
+  char buf[MEOS_STATE_MAXSIZE];
+  for (int i = 0; i < store->size && k < nobjects; i++)
+  {
+    const MeosStateSlot *slot = &store->slots[i];
+    int64 id = atomic_load_explicit(&((MeosStateSlot *) slot)->id,
+      memory_order_acquire);
+    if (id == 0 || ! meos_state_slot_read(slot, buf, NULL))
+      continue;
+    result[k] = palloc(VARSIZE(buf));
+    memcpy(result[k], buf, VARSIZE(buf));
+    resultids[k++] = id;
+  }
+  *ids = resultids;
+  *count = k;
+  if (epoch)
+    *epoch = e;
+  return result;
+}
+
+/**
+ * @ingroup libmeos_setup
+ * @brief Stop a state store and release its slots
+ * @param[in] store The store
+ * @note The callers must have stopped publishing and reading before this
+ * call
+ */
+void
+meos_state_store_stop(MeosStateStore *store)
+{
+  if (! store)
+    return;
+  free(store->slots);
+  free(store);
+  return;
+}
+
+/*****************************************************************************/
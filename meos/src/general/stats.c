@@ -0,0 +1,102 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Lightweight performance counters for key entry points of MEOS
+ *
+ * The counters record how many times the main dispatch points of the
+ * library are entered — lifted function evaluation, restriction,
+ * sequence synchronization, WKB input/output — together with the number
+ * of WKB bytes moved and the hit ratio of the internal caches. They make
+ * it possible to see where the time of a workload goes in production
+ * without attaching a profiler.
+ *
+ * The instrumentation is always compiled in but is disabled by default:
+ * each instrumented point then only pays a load and a well-predicted
+ * branch. When enabled with #meos_stats_enable the counters are updated
+ * with relaxed atomic additions so that loops running under the thread
+ * pool do not lose counts.
+ */
+
+/* C */
+#include <string.h>
+/* MEOS */
+#include <meos.h>
+#include "general/stats.h"
+
+/*****************************************************************************/
+
+/**
+ * @brief Global variable that enables the performance counters
+ */
+bool _meos_stats_enabled = false;
+
+/**
+ * @brief Global variable that accumulates the performance counters
+ */
+MeosStats _meos_stats = { 0 };
+
+/**
+ * @brief Enable or disable the performance counters
+ */
+void
+meos_stats_enable(bool enable)
+{
+  _meos_stats_enabled = enable;
+}
+
+/**
+ * @brief Return true if the performance counters are enabled
+ */
+bool
+meos_stats_enabled(void)
+{
+  return _meos_stats_enabled;
+}
+
+/**
+ * @brief Reset the performance counters to zero
+ */
+void
+meos_stats_reset(void)
+{
+  memset(&_meos_stats, 0, sizeof(MeosStats));
+}
+
+/**
+ * @brief Return a snapshot of the performance counters
+ */
+MeosStats
+meos_stats(void)
+{
+  return _meos_stats;
+}
+
+/*****************************************************************************/
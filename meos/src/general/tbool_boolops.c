@@ -73,6 +73,24 @@ datum_not(Datum d)
   return BoolGetDatum(! DatumGetBool(d));
 }
 
+/**
+ * @brief Return the negated Boolean and of two values
+ */
+Datum
+datum_nand(Datum l, Datum r)
+{
+  return BoolGetDatum(! (DatumGetBool(l) && DatumGetBool(r)));
+}
+
+/**
+ * @brief Return the negated Boolean or of two values
+ */
+Datum
+datum_nor(Datum l, Datum r)
+{
+  return BoolGetDatum(! (DatumGetBool(l) || DatumGetBool(r)));
+}
+
 /*****************************************************************************
  * Generic functions
  *****************************************************************************/
@@ -142,6 +160,36 @@ boolop_tbool_tbool(const Temporal *temp1, const Temporal *temp2,
   return tfunc_temporal_temporal(temp1, temp2, &lfinfo);
 }
 
+/**
+ * @brief Return 1 if the boolean operator of two temporal booleans is ever
+ * true, 0 if not, and -1 if the temporal values do not overlap on time.
+ *
+ * The operator is evaluated with the ever semantics of the lifting
+ * framework, which stops at the first interval where the operator is true
+ * instead of materializing the full temporal result, so existence checks
+ * such as alert predicates do not depend on the length of the common
+ * timespan.
+ */
+int
+eboolop_tbool_tbool(const Temporal *temp1, const Temporal *temp2,
+  datum_func2 func)
+{
+  assert(temp1); assert(temp2);
+  assert(temp1->temptype == temp2->temptype);
+  assert(temp1->temptype == T_TBOOL);
+  LiftedFunctionInfo lfinfo;
+  memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
+  lfinfo.func = (varfunc) func;
+  lfinfo.numparam = 0;
+  lfinfo.restype = T_TBOOL;
+  lfinfo.reslinear = false;
+  lfinfo.invert = INVERT_NO;
+  /* The ever functions of the lifting framework are always discontinuous */
+  lfinfo.discont = DISCONTINUOUS;
+  lfinfo.tpfunc = NULL;
+  return efunc_temporal_temporal(temp1, temp2, &lfinfo);
+}
+
 /*****************************************************************************/
 
 /**
@@ -137,5 +137,79 @@ tor_tbool_tbool(const Temporal *temp1, const Temporal *temp2)
   return boolop_tbool_tbool(temp1, temp2, &datum_or);
 }
 
+/*****************************************************************************
+ * Ever and always operators
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_bool
+ * @brief Return 1 if the and of two temporal booleans is ever true, 0 if
+ * not, and -1 on error or if the temporal values do not overlap on time.
+ *
+ * The function stops at the first interval where both values are true
+ * instead of computing the full temporal and, so existence checks do not
+ * pay for the length of the common timespan.
+ */
+int
+eand_tbool_tbool(const Temporal *temp1, const Temporal *temp2)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_temporal_has_type(temp1, T_TBOOL) ||
+      ! ensure_same_temporal_type(temp1, temp2))
+    return -1;
+  return eboolop_tbool_tbool(temp1, temp2, &datum_and);
+}
+
+/**
+ * @ingroup libmeos_temporal_bool
+ * @brief Return 1 if the and of two temporal booleans is always true, 0 if
+ * not, and -1 on error or if the temporal values do not overlap on time
+ */
+int
+aand_tbool_tbool(const Temporal *temp1, const Temporal *temp2)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_temporal_has_type(temp1, T_TBOOL) ||
+      ! ensure_same_temporal_type(temp1, temp2))
+    return -1;
+  int result = eboolop_tbool_tbool(temp1, temp2, &datum_nand);
+  return (result < 0) ? result : ! result;
+}
+
+/**
+ * @ingroup libmeos_temporal_bool
+ * @brief Return 1 if the or of two temporal booleans is ever true, 0 if
+ * not, and -1 on error or if the temporal values do not overlap on time
+ */
+int
+eor_tbool_tbool(const Temporal *temp1, const Temporal *temp2)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_temporal_has_type(temp1, T_TBOOL) ||
+      ! ensure_same_temporal_type(temp1, temp2))
+    return -1;
+  return eboolop_tbool_tbool(temp1, temp2, &datum_or);
+}
+
+/**
+ * @ingroup libmeos_temporal_bool
+ * @brief Return 1 if the or of two temporal booleans is always true, 0 if
+ * not, and -1 on error or if the temporal values do not overlap on time
+ */
+int
+aor_tbool_tbool(const Temporal *temp1, const Temporal *temp2)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_temporal_has_type(temp1, T_TBOOL) ||
+      ! ensure_same_temporal_type(temp1, temp2))
+    return -1;
+  int result = eboolop_tbool_tbool(temp1, temp2, &datum_nor);
+  return (result < 0) ? result : ! result;
+}
+
 /*****************************************************************************/
 
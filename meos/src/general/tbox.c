@@ -1374,6 +1374,38 @@ union_tbox_tbox(const TBox *box1, const TBox *box2, bool strict)
   return result;
 }
 
+/**
+ * @ingroup libmeos_box_set
+ * @brief Set a caller-provided box with the union of two temporal boxes.
+ * @return Return false if the union of the boxes cannot be computed
+ * @note This function is equivalent to @ref union_tbox_tbox without memory
+ * allocation
+ */
+bool
+union_tbox_tbox_buf(const TBox *box1, const TBox *box2, bool strict,
+  TBox *result)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) box1) || ! ensure_not_null((void *) box2) ||
+      ! ensure_not_null((void *) result) ||
+      ! ensure_same_dimensionality_tbox(box1, box2) ||
+      (MEOS_FLAGS_GET_X(box1->flags) && MEOS_FLAGS_GET_X(box2->flags) &&
+        ! ensure_same_span_type(&box1->span, &box2->span)))
+    return false;
+
+  /* The union of boxes that do not intersect cannot be represented by a box */
+  if (strict && ! overlaps_tbox_tbox(box1, box2))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Result of box union would not be contiguous");
+    return false;
+  }
+
+  memcpy(result, box1, sizeof(TBox));
+  tbox_expand(box2, result);
+  return true;
+}
+
 /**
  * @ingroup libmeos_internal_box_set
  * @brief Set a temporal box with the result of the intersection of the first
@@ -1426,6 +1458,27 @@ intersection_tbox_tbox(const TBox *box1, const TBox *box2)
   return result;
 }
 
+/**
+ * @ingroup libmeos_box_set
+ * @brief Set a caller-provided box with the intersection of two temporal
+ * boxes.
+ * @return Return false if the boxes do not intersect
+ * @note This function is equivalent to @ref intersection_tbox_tbox without
+ * memory allocation
+ */
+bool
+intersection_tbox_tbox_buf(const TBox *box1, const TBox *box2, TBox *result)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) box1) || ! ensure_not_null((void *) box2) ||
+      ! ensure_not_null((void *) result) ||
+      (MEOS_FLAGS_GET_X(box1->flags) && MEOS_FLAGS_GET_X(box2->flags) &&
+        ! ensure_same_span_type(&box1->span, &box2->span)))
+    return false;
+
+  return inter_tbox_tbox(box1, box2, result);
+}
+
 /*****************************************************************************
  * Comparison functions
  *****************************************************************************/
@@ -38,6 +38,7 @@
 #include <assert.h>
 #include <float.h>
 #include <limits.h>
+#include <math.h>
 /* POSTGRESQL */
 #if POSTGRESQL_VERSION_NUMBER >= 160000
   #include "varatt.h"
@@ -48,10 +49,15 @@
 #include "general/doxygen_libmeos.h"
 #include "general/lifting.h"
 #include "general/pg_types.h"
+#include "general/stats.h"
+#if MEOS
+  #include "general/pool.h"
+#endif
 #include "general/temporaltypes.h"
 #include "general/temporal_boxops.h"
 #include "general/tnumber_distance.h"
 #include "general/temporal_tile.h"
+#include "general/type_out.h"
 #include "general/type_parser.h"
 #include "general/type_util.h"
 #include "point/pgis_call.h"
@@ -1100,6 +1106,37 @@ tpoint_from_base_temp(const GSERIALIZED *gs, const Temporal *temp)
  * Append and merge functions
  ****************************************************************************/
 
+/**
+ * @ingroup libmeos_temporal_modif
+ * @brief Return the generation of a temporal value, which is bumped by every
+ * in-place modification.
+ *
+ * A cache attached to a temporal value, for example a cursor position or a
+ * derived measure, stays valid only as long as the value is not modified.
+ * The modification functions of the expandable structures (append, restart)
+ * mutate the value in place, so the address of the value does not change and
+ * cannot serve as a validity test. Caches should instead remember the
+ * generation of the value when they are filled and compare it on every use,
+ * which is O(1) and does not touch the variable-length data. When a
+ * modification reallocates the value, the generation of the old value plus
+ * one is carried over to the new one, so the test also detects a reallocation
+ * landing at a recycled address. Temporal instants are immutable and their
+ * generation is always zero.
+ */
+uint16
+temporal_generation(const Temporal *temp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp))
+    return 0;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TSEQUENCE)
+    return ((TSequence *) temp)->generation;
+  if (temp->subtype == TSEQUENCESET)
+    return ((TSequenceSet *) temp)->generation;
+  return 0;
+}
+
 /**
  * @ingroup libmeos_temporal_modif
  * @brief Append an instant to a temporal value.
@@ -1107,12 +1144,16 @@ tpoint_from_base_temp(const GSERIALIZED *gs, const Temporal *temp)
  * @param[in] inst Temporal instant
  * @param[in] maxdist Maximum distance for defining a gap
  * @param[in] maxt Maximum time interval for defining a gap
+ * @param[in] tolerance Tolerance of the dead-reckoning filter: when greater
+ * than zero, instants whose value is predictable within the tolerance from
+ * their neighbouring instants are dropped on append, compressing
+ * near-linear streams online with a bounded error
  * @param[in] expand True when reserving space for additional instants
  * @sqlfunc appendInstantGaps
  */
 Temporal *
 temporal_append_tinstant(Temporal *temp, const TInstant *inst, double maxdist,
-  Interval *maxt, bool expand)
+  Interval *maxt, double tolerance, bool expand)
 {
   /* Validity tests */
   if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) inst) ||
@@ -1131,10 +1172,10 @@ temporal_append_tinstant(Temporal *temp, const TInstant *inst, double maxdist,
     result = (Temporal *) tinstant_merge((const TInstant *) temp, inst);
   else if (temp->subtype == TSEQUENCE)
     result = (Temporal *) tsequence_append_tinstant((TSequence *) temp,
-      inst, maxdist, maxt, expand);
+      inst, maxdist, maxt, tolerance, expand);
   else /* temp->subtype == TSEQUENCESET */
     result = (Temporal *) tsequenceset_append_tinstant((TSequenceSet *) temp,
-      inst, maxdist, maxt, expand);
+      inst, maxdist, maxt, tolerance, expand);
   return result;
 }
 
@@ -1298,6 +1339,157 @@ temporal_merge(const Temporal *temp1, const Temporal *temp2)
   return result;
 }
 
+/**
+ * @ingroup libmeos_temporal_modif
+ * @brief Merge two temporal values and free the inputs after the merge.
+ *
+ * The consuming variant allows transformation pipelines to hand over their
+ * intermediate values instead of freeing them at every step, e.g.,
+ * `temporal_merge_free(temporal_at_period(temp, p), temp2)`.
+ * @sqlfunc merge()
+ */
+Temporal *
+temporal_merge_free(Temporal *temp1, Temporal *temp2)
+{
+  Temporal *result = temporal_merge(temp1, temp2);
+  if (temp1)
+    pfree(temp1);
+  if (temp2)
+    pfree(temp2);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_modif
+ * @brief Merge a base temporal value with a delta log holding the updates
+ * that follow it in time.
+ *
+ * This function supports a snapshot + delta access pattern for values that
+ * grow at their end, for example, the current trip of a vehicle: a stable
+ * base value holds the history up to the last compaction and a small delta
+ * value accumulates the recent position reports, so that the hot write path
+ * only touches the delta. Since the delta is required to start after the end
+ * of the base value, the composing sequences of the two values are
+ * concatenated with the trusted constructors, skipping the subtype
+ * conversion, the sort, and the normalization of #temporal_merge.
+ * @param[in] base Base value, may be NULL
+ * @param[in] delta Delta value starting after the end of the base value,
+ * may be NULL
+ * @result Merged value. Return NULL if both arguments are NULL.
+ * If one argument is null the other argument is output.
+ * @sqlfunc deltaMerge()
+ */
+Temporal *
+temporal_delta_merge(const Temporal *base, const Temporal *delta)
+{
+  /* Cannot do anything with null inputs */
+  if (! base && ! delta)
+    return NULL;
+  /* One argument is null, return a copy of the other temporal */
+  if (! base)
+    return temporal_copy(delta);
+  if (! delta)
+    return temporal_copy(base);
+
+  /* Ensure validity of the arguments */
+  if (! ensure_same_temporal_type(base, delta) ||
+      ! ensure_same_continuous_interpolation(base->flags, delta->flags) ||
+      ! ensure_spatial_validity(base, delta))
+    return NULL;
+  Span s1, s2;
+  temporal_set_period(base, &s1);
+  temporal_set_period(delta, &s2);
+  if (DatumGetTimestampTz(s1.upper) > DatumGetTimestampTz(s2.lower) ||
+      (DatumGetTimestampTz(s1.upper) == DatumGetTimestampTz(s2.lower) &&
+       s1.upper_inc && s2.lower_inc))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The delta value must start after the end of the base value");
+    return NULL;
+  }
+
+  /* Instant and discrete values do not need normalization and mixed
+   * interpolations need a subtype conversion, delegate them to the general
+   * merge function */
+  interpType interp1 = MEOS_FLAGS_GET_INTERP(base->flags);
+  interpType interp2 = MEOS_FLAGS_GET_INTERP(delta->flags);
+  if (base->subtype == TINSTANT || delta->subtype == TINSTANT ||
+      interp1 == DISCRETE || interp2 == DISCRETE || interp1 != interp2)
+    return temporal_merge(base, delta);
+
+  /* Both values are continuous (sets of) sequences with disjoint periods:
+   * concatenate their composing sequences as they are */
+  int count1 = (base->subtype == TSEQUENCE) ? 1 :
+    ((TSequenceSet *) base)->count;
+  int count2 = (delta->subtype == TSEQUENCE) ? 1 :
+    ((TSequenceSet *) delta)->count;
+  const TSequence **sequences = palloc(sizeof(TSequence *) *
+    (count1 + count2));
+  int nseqs = 0;
+  if (base->subtype == TSEQUENCE)
+    sequences[nseqs++] = (TSequence *) base;
+  else
+    for (int i = 0; i < count1; i++)
+      sequences[nseqs++] = TSEQUENCESET_SEQ_N((TSequenceSet *) base, i);
+  if (delta->subtype == TSEQUENCE)
+    sequences[nseqs++] = (TSequence *) delta;
+  else
+    for (int i = 0; i < count2; i++)
+      sequences[nseqs++] = TSEQUENCESET_SEQ_N((TSequenceSet *) delta, i);
+  TSequenceSet *result = tsequenceset_make_trusted(sequences, nseqs,
+    NORMALIZE_NO, VALIDATE_NONE);
+  pfree(sequences);
+  return (Temporal *) result;
+}
+
+/**
+ * @brief Convert a temporal value into a subtype
+ * @param[in] temp Value
+ * @param[in] subtype Target subtype
+ * @param[in] interp Interpolation
+ */
+static Temporal *
+temporal_convert_subtype(Temporal *temp, uint8 subtype, interpType interp)
+{
+  uint8 subtype1 = temp->subtype;
+  assert(subtype >= subtype1);
+  if (subtype == subtype1)
+    return temporal_copy(temp);
+  else if (subtype1 == TINSTANT)
+  {
+    if (subtype == TSEQUENCE)
+      return (Temporal *) tinstant_to_tsequence((TInstant *) temp, interp);
+    else /* subtype == TSEQUENCESET */
+      return (Temporal *) tinstant_to_tsequenceset((TInstant *) temp, interp);
+  }
+  else /* subtype1 == TSEQUENCE && subtype == TSEQUENCESET */
+    return (Temporal *) tsequence_to_tsequenceset((TSequence *) temp);
+}
+
+#if MEOS
+/** Arguments of the subtype conversion tasks submitted to the thread pool */
+typedef struct TemporalarrConvertTask
+{
+  Temporal **temparr;     /**< Array of input values */
+  Temporal **result;      /**< Array of output values */
+  uint8 subtype;          /**< Target subtype */
+  interpType interp;      /**< Interpolation */
+} TemporalarrConvertTask;
+
+/**
+ * @brief Convert one temporal value of an array into a subtype, task
+ * function executed on the thread pool
+ */
+static void
+temporalarr_convert_subtype_task(void *arg, int idx)
+{
+  TemporalarrConvertTask *task = (TemporalarrConvertTask *) arg;
+  task->result[idx] = temporal_convert_subtype(task->temparr[idx],
+    task->subtype, task->interp);
+  return;
+}
+#endif /* MEOS */
+
 /**
  * @brief Convert the array of temporal values into a common subtype
  * @param[in] temparr Array of values
@@ -1313,27 +1505,152 @@ temporalarr_convert_subtype(Temporal **temparr, int count, uint8 subtype,
   assert(temparr);
   assert(temptype_subtype(subtype));
   Temporal **result = palloc(sizeof(Temporal *) * count);
+#if MEOS
+  if (meos_pool_active())
+  {
+    TemporalarrConvertTask task = { temparr, result, subtype, interp };
+    meos_pool_parallel_for(count, &temporalarr_convert_subtype_task, &task);
+    return result;
+  }
+#endif /* MEOS */
   for (int i = 0; i < count; i++)
+    result[i] = temporal_convert_subtype(temparr[i], subtype, interp);
+  return result;
+}
+
+/**
+ * @brief Return true if the values of an array of the same subtype are in
+ * increasing time order and strictly disjoint
+ *
+ * The verification is a linear pass over the bounding periods of the values,
+ * without touching their composing instants.
+ */
+static bool
+temporalarr_sorted_disjoint(Temporal **temparr, int count, uint8 subtype)
+{
+  if (subtype == TINSTANT)
   {
-    uint8 subtype1 = temparr[i]->subtype;
-    assert(subtype >= subtype1);
-    if (subtype == subtype1)
-      result[i] = temporal_copy(temparr[i]);
-    else if (subtype1 == TINSTANT)
+    for (int i = 1; i < count; i++)
+      if (((TInstant *) temparr[i - 1])->t >= ((TInstant *) temparr[i])->t)
+        return false;
+    return true;
+  }
+  for (int i = 1; i < count; i++)
+  {
+    const Span *per1 = (subtype == TSEQUENCE) ?
+      &((TSequence *) temparr[i - 1])->period :
+      &((TSequenceSet *) temparr[i - 1])->period;
+    const Span *per2 = (subtype == TSEQUENCE) ?
+      &((TSequence *) temparr[i])->period :
+      &((TSequenceSet *) temparr[i])->period;
+    if (DatumGetTimestampTz(per1->upper) >= DatumGetTimestampTz(per2->lower))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Merge an array of temporal values of the same subtype that are in
+ * increasing time order and strictly disjoint
+ *
+ * Since no pair of values can overlap or be joined by normalization, the
+ * values are concatenated as they are, skipping the sort and the
+ * normalization of the general case.
+ */
+static Temporal *
+temporal_merge_array_sorted(Temporal **temparr, int count, uint8 subtype)
+{
+  if (subtype == TINSTANT)
+    return (Temporal *) tsequence_make((const TInstant **) temparr, count,
+      true, true, DISCRETE, NORMALIZE_NO);
+  else if (subtype == TSEQUENCE)
+    return (Temporal *) tsequenceset_make((const TSequence **) temparr,
+      count, NORMALIZE_NO);
+  else /* subtype == TSEQUENCESET */
+  {
+    /* Collect the composing sequences, which keep their relative order */
+    int totalcount = 0;
+    for (int i = 0; i < count; i++)
+      totalcount += ((TSequenceSet *) temparr[i])->count;
+    const TSequence **sequences = palloc(sizeof(TSequence *) * totalcount);
+    int nseqs = 0;
+    for (int i = 0; i < count; i++)
     {
-      if (subtype == TSEQUENCE)
-        result[i] = (Temporal *) tinstant_to_tsequence((TInstant *) temparr[i],
-          interp);
-      else /* subtype == TSEQUENCESET */
-        result[i] = (Temporal *) tinstant_to_tsequenceset((TInstant *) temparr[i],
-          interp);
+      const TSequenceSet *ss = (TSequenceSet *) temparr[i];
+      for (int j = 0; j < ss->count; j++)
+        sequences[nseqs++] = TSEQUENCESET_SEQ_N(ss, j);
     }
-    else /* subtype1 == TSEQUENCE && subtype == TSEQUENCESET */
-      result[i] = (Temporal *) tsequence_to_tsequenceset((TSequence *) temparr[i]);
+    TSequenceSet *result = tsequenceset_make(sequences, totalcount,
+      NORMALIZE_NO);
+    pfree(sequences);
+    return (Temporal *) result;
   }
-  return result;
 }
 
+/**
+ * @brief Merge an array of temporal values of the same subtype
+ * @param[in] temparr Array of values
+ * @param[in] count Number of values
+ * @param[in] subtype Common subtype of the values
+ */
+static Temporal *
+temporal_merge_array1(Temporal **temparr, int count, uint8 subtype)
+{
+  assert(temptype_subtype(subtype));
+  /* Fast path for values that are already in increasing time order and
+   * strictly disjoint, as produced for example when reassembling trips from
+   * time partitions. Discrete sequences are left to the general case since
+   * their merge yields a single discrete sequence instead of a sequence
+   * set. */
+  if (count > 1 &&
+      (subtype == TINSTANT ||
+       ! MEOS_FLAGS_DISCRETE_INTERP(temparr[0]->flags)) &&
+      temporalarr_sorted_disjoint(temparr, count, subtype))
+    return temporal_merge_array_sorted(temparr, count, subtype);
+  if (subtype == TINSTANT)
+    return (Temporal *) tinstant_merge_array(
+      (const TInstant **) temparr, count);
+  else if (subtype == TSEQUENCE)
+    return (Temporal *) tsequence_merge_array(
+      (const TSequence **) temparr, count);
+  else /* subtype == TSEQUENCESET */
+    return (Temporal *) tsequenceset_merge_array(
+      (const TSequenceSet **) temparr, count);
+}
+
+#if MEOS
+/**
+ * @brief Argument of a partitioned merge executed on the thread pool
+ */
+typedef struct TemporalarrMergeTask
+{
+  Temporal **temparr;  /**< Array of input values */
+  int count;           /**< Number of input values */
+  int nparts;          /**< Number of partitions */
+  uint8 subtype;       /**< Common subtype of the values */
+  Temporal **partials; /**< Partial merge of every partition */
+} TemporalarrMergeTask;
+
+/**
+ * @brief Merge one partition of an array of temporal values, task function
+ * executed on the thread pool
+ *
+ * Every partition is merged entirely by a single participant, so the
+ * intermediate memory of a partial merge is allocated by the thread that
+ * reads it and stays local to its NUMA node under first-touch placement.
+ */
+static void
+temporal_merge_array_task(void *arg, int idx)
+{
+  TemporalarrMergeTask *task = (TemporalarrMergeTask *) arg;
+  int lower = (int) (((int64) task->count * idx) / task->nparts);
+  int upper = (int) (((int64) task->count * (idx + 1)) / task->nparts);
+  task->partials[idx] = temporal_merge_array1(&task->temparr[lower],
+    upper - lower, task->subtype);
+  return;
+}
+#endif /* MEOS */
+
 /**
  * @ingroup libmeos_temporal_modif
  * @brief Merge an array of temporal values.
@@ -1384,15 +1701,25 @@ temporal_merge_array(Temporal **temparr, int count)
 
   Temporal *result;
   assert(temptype_subtype(subtype));
-  if (subtype == TINSTANT)
-    result = (Temporal *) tinstant_merge_array(
-      (const TInstant **) newtemps, count);
-  else if (subtype == TSEQUENCE)
-    result = (Temporal *) tsequence_merge_array(
-      (const TSequence **) newtemps, count);
-  else /* subtype == TSEQUENCESET */
-    result = (Temporal *) tsequenceset_merge_array(
-      (const TSequenceSet **) newtemps, count);
+#if MEOS
+  int nparts = meos_pool_num_threads();
+  if (meos_pool_active() && count >= nparts * 2)
+  {
+    /* Merge the partitions in parallel and then merge the partial results.
+     * The partial merges may have different subtypes, e.g., merging several
+     * instants yields a discrete sequence, so the partial results are merged
+     * with the generic function, which runs serially given their number */
+    Temporal **partials = palloc(sizeof(Temporal *) * nparts);
+    TemporalarrMergeTask task = { newtemps, count, nparts, subtype, partials };
+    meos_pool_parallel_for(nparts, &temporal_merge_array_task, &task);
+    result = temporal_merge_array(partials, nparts);
+    pfree_array((void **) partials, nparts);
+  }
+  else
+    result = temporal_merge_array1(newtemps, count, subtype);
+#else
+  result = temporal_merge_array1(newtemps, count, subtype);
+#endif /* MEOS */
   if (subtype != origsubtype)
     pfree_array((void **) newtemps, count);
   return result;
@@ -1508,6 +1835,24 @@ temporal_to_period(const Temporal *temp)
   temporal_set_period(temp, result);
   return result;
 }
+
+/**
+ * @ingroup libmeos_temporal_conversion
+ * @brief Set a caller-provided span with the bounding period of a temporal
+ * value.
+ * @note This function is equivalent to @ref temporal_to_period without
+ * memory allocation
+ */
+bool
+temporal_to_period_buf(const Temporal *temp, Span *result)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) result))
+    return false;
+
+  temporal_set_period(temp, result);
+  return true;
+}
 #endif /* MEOS */
 
 /**
@@ -1552,6 +1897,24 @@ tnumber_to_span(const Temporal *temp)
   return result;
 }
 
+/**
+ * @ingroup libmeos_temporal_conversion
+ * @brief Set a caller-provided span with the value span of a temporal number.
+ * @note This function is equivalent to @ref tnumber_to_span without memory
+ * allocation
+ */
+bool
+tnumber_to_span_buf(const Temporal *temp, Span *result)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) result) ||
+      ! ensure_tnumber_type(temp->temptype))
+    return false;
+
+  tnumber_set_span(temp, result);
+  return true;
+}
+
 #if MEOS
 /**
  * @ingroup libmeos_box_conversion
@@ -1570,6 +1933,25 @@ tnumber_to_tbox(const Temporal *temp)
   temporal_set_bbox(temp, result);
   return result;
 }
+
+/**
+ * @ingroup libmeos_box_conversion
+ * @brief Set a caller-provided box with the bounding box of a temporal
+ * number.
+ * @note This function is equivalent to @ref tnumber_to_tbox without memory
+ * allocation
+ */
+bool
+tnumber_to_tbox_buf(const Temporal *temp, TBox *result)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) result) ||
+      ! ensure_tnumber_type(temp->temptype))
+    return false;
+
+  temporal_set_bbox(temp, result);
+  return true;
+}
 #endif
 
 /*****************************************************************************
@@ -2683,6 +3065,82 @@ temporal_sequence_n(const Temporal *temp, int i)
   return result;
 }
 
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return a pointer to the start sequence of a temporal sequence (set).
+ * @return On error return NULL
+ * @note Zero-allocation variant of #temporal_start_sequence: the result must
+ * not be freed and is valid as long as the temporal value is.
+ * @sqlfunc startSequence
+ */
+const TSequence *
+temporal_start_sequence_ptr(const Temporal *temp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_continuous(temp))
+    return NULL;
+
+  if (temp->subtype == TSEQUENCE)
+    return (const TSequence *) temp;
+  else /* temp->subtype == TSEQUENCESET */
+    return TSEQUENCESET_SEQ_N((TSequenceSet *) temp, 0);
+}
+
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return a pointer to the end sequence of a temporal sequence (set).
+ * @return On error return NULL
+ * @note Zero-allocation variant of #temporal_end_sequence: the result must
+ * not be freed and is valid as long as the temporal value is.
+ * @sqlfunc endSequence
+ */
+const TSequence *
+temporal_end_sequence_ptr(const Temporal *temp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_continuous(temp))
+    return NULL;
+
+  if (temp->subtype == TSEQUENCE)
+    return (const TSequence *) temp;
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    return TSEQUENCESET_SEQ_N(ss, ss->count - 1);
+  }
+}
+
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return a pointer to the n-th sequence of a temporal sequence (set).
+ * @return On error return NULL
+ * @note n is assumed to be 1-based.
+ * @note Zero-allocation variant of #temporal_sequence_n: the result must
+ * not be freed and is valid as long as the temporal value is.
+ * @sqlfunc sequenceN
+ */
+const TSequence *
+temporal_sequence_n_ptr(const Temporal *temp, int i)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_continuous(temp))
+    return NULL;
+
+  const TSequence *result = NULL;
+  if (temp->subtype == TSEQUENCE)
+  {
+    if (i == 1)
+      result = (const TSequence *) temp;
+  }
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    if (i >= 1 && i <= ss->count)
+      result = TSEQUENCESET_SEQ_N(ss, i - 1);
+  }
+  return result;
+}
+
 /**
  * @ingroup libmeos_temporal_accessor
  * @brief Return the array of sequences of a temporal sequence (set).
@@ -2854,6 +3312,36 @@ temporal_instant_n(const Temporal *temp, int n)
   return result;
 }
 
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return a pointer to the instant of a temporal value at a timestamp,
+ * if any.
+ * @return On error or when the timestamp does not coincide with one of the
+ * composing instants return NULL
+ * @note Zero-allocation variant of the restriction to a timestamp for
+ * read-only inspection: the result must not be freed and is valid as long as
+ * the temporal value is. Since no interpolation can take place, a NULL result
+ * does not imply that the temporal value is undefined at the timestamp.
+ */
+const TInstant *
+temporal_inst_at_timestamp(const Temporal *temp, TimestampTz t)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp))
+    return NULL;
+
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+  {
+    const TInstant *inst = (const TInstant *) temp;
+    return (inst->t == t) ? inst : NULL;
+  }
+  else if (temp->subtype == TSEQUENCE)
+    return tsequence_inst_at_timestamp((TSequence *) temp, t);
+  else /* temp->subtype == TSEQUENCESET */
+    return tsequenceset_inst_at_timestamp((TSequenceSet *) temp, t);
+}
+
 /**
  * @ingroup libmeos_temporal_accessor
  * @brief Return the array of instants of a temporal value.
@@ -3069,31 +3557,59 @@ temporal_bbox_ev_al_eq(const Temporal *temp, Datum value, bool ever)
 }
 
 /**
- * @brief Return true if the bounding box of a temporal value is ever/always
- * less than or equal to the base value.
+ * @brief Return true if an ever/always less than (or equal to) comparison of
+ * a temporal number and a base value is decided by the bounding box, and set
+ * the result of the comparison.
  *
- * The same test is used for both since the bounding box does not
- * distinguish between inclusive/exclusive bounds.
+ * The comparison is decided by the minimum (for ever) or the maximum (for
+ * always) of the value span, so in particular the common negative case
+ * returns without touching the composing instants. The only undecided case
+ * arises with linear interpolation when the base value is equal to the
+ * extreme value, which may be attained at an instant or only approached at
+ * an exclusive bound of a composing sequence: the non-strict ever and the
+ * strict always comparisons then depend on the instants, while ever < is
+ * false and always <= is true whether or not the extreme value is attained.
  *
  * @param[in] temp Temporal value
  * @param[in] value Base value
  * @param[in] ever True when testing ever, false when testing always
+ * @param[in] strict True when testing <, false when testing <=
+ * @param[out] result Result of the comparison when it is decided
  */
 bool
-temporal_bbox_ev_al_lt_le(const Temporal *temp, Datum value, bool ever)
+tnumber_bbox_ev_al_lt_le(const Temporal *temp, Datum value, bool ever,
+  bool strict, bool *result)
 {
   assert(temp);
+  assert(tnumber_type(temp->temptype));
 
-  if (tnumber_type(temp->temptype))
-  {
-    TBox box;
-    temporal_set_bbox(temp, &box);
-    Datum upper = box.span.basetype == T_INT4 ?
+  TBox box;
+  temporal_set_bbox(temp, &box);
+  Datum bound;
+  if (ever)
+    bound = box.span.lower;
+  else
+    bound = box.span.basetype == T_INT4 ?
       Int32GetDatum(DatumGetInt32(box.span.upper) - 1) : box.span.upper;
-    if ((ever && datum_lt(value, box.span.lower, box.span.basetype)) ||
-      (! ever && datum_lt(value, upper, box.span.basetype)))
-      return false;
+  int cmp = datum_cmp(bound, value, box.span.basetype);
+  if (cmp != 0)
+  {
+    *result = (cmp < 0);
+    return true;
+  }
+  /* The base value is equal to the extreme value */
+  if (strict == ever)
+  {
+    /* Ever < is false and always <= is true also in the limit */
+    *result = ! ever;
+    return true;
   }
+  if (MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+    /* The extreme value may only be approached at an exclusive bound */
+    return false;
+  /* Ever <= is true and always < is false since the extreme value is
+   * attained at an instant */
+  *result = ever;
   return true;
 }
 
@@ -3591,6 +4107,7 @@ Temporal *
 temporal_restrict_value(const Temporal *temp, Datum value, bool atfunc)
 {
   assert(temp);
+  MEOS_STATS_INC(restrict_calls);
   /* Ensure validity of the arguments */
   if (tgeo_type(temp->temptype))
   {
@@ -3667,6 +4184,7 @@ Temporal *
 temporal_restrict_values(const Temporal *temp, const Set *s, bool atfunc)
 {
   assert(temp); assert(s);
+  MEOS_STATS_INC(restrict_calls);
   if (tgeo_type(temp->temptype))
   {
     assert(tpoint_srid(temp) == geoset_srid(s));
@@ -3798,6 +4316,7 @@ Temporal *
 temporal_restrict_minmax(const Temporal *temp, bool min, bool atfunc)
 {
   assert(temp);
+  MEOS_STATS_INC(restrict_calls);
   Temporal *result;
   assert(temptype_subtype(temp->subtype));
   if (temp->subtype == TINSTANT)
@@ -3823,6 +4342,7 @@ Temporal *
 temporal_restrict_timestamp(const Temporal *temp, TimestampTz t, bool atfunc)
 {
   assert(temp);
+  MEOS_STATS_INC(restrict_calls);
   Temporal *result;
   assert(temptype_subtype(temp->subtype));
   if (temp->subtype == TINSTANT)
@@ -3870,6 +4390,223 @@ temporal_value_at_timestamp(const Temporal *temp, TimestampTz t, bool strict,
   return found;
 }
 
+/*****************************************************************************
+ * Cursor-based version of value at timestamp
+ *
+ * Replay workloads probe the same temporal value with non-decreasing
+ * timestamps; each probe of #temporal_value_at_timestamp then repeats a
+ * binary search from scratch. The cursor below remembers the position of
+ * the last probe and advances it linearly, falling back to the search only
+ * when a probe jumps backwards in time.
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Initialize a cursor for repeated value-at-timestamp lookups
+ * @param[out] cursor Cursor
+ * @param[in] temp Temporal value, which must outlive the cursor
+ * @return On error return false
+ * @see #temporal_value_at_timestamp
+ */
+bool
+temporal_cursor_init(TemporalCursor *cursor, const Temporal *temp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) cursor) || ! ensure_not_null((void *) temp))
+    return false;
+  memset(cursor, 0, sizeof(TemporalCursor));
+  cursor->temp = temp;
+  cursor->generation = temporal_generation(temp);
+  return true;
+}
+
+/**
+ * @brief Cursor-based version of #tsequence_value_at_timestamp for a
+ * continuous sequence
+ */
+static bool
+tsequence_cursor_value(TemporalCursor *cursor, const TSequence *seq,
+  TimestampTz t, bool strict, Datum *result)
+{
+  /* Return the value even when the timestamp is at an exclusive bound */
+  if (! strict)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, 0);
+    /* Instantaneous sequence or t is at lower bound */
+    if (inst->t == t)
+    {
+      *result = tinstant_value_copy(inst);
+      return true;
+    }
+    inst = TSEQUENCE_INST_N(seq, seq->count - 1);
+    if (inst->t == t)
+    {
+      *result = tinstant_value_copy(inst);
+      return true;
+    }
+  }
+
+  /* Bounding box test */
+  if (! contains_period_timestamp(&seq->period, t))
+    return false;
+
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+  {
+    *result = tinstant_value_copy(TSEQUENCE_INST_N(seq, 0));
+    return true;
+  }
+
+  /* General case: locate the segment containing the timestamp, advancing
+   * linearly from the cached position when the probes are monotone */
+  int n;
+  if (cursor->valid && t >= cursor->t)
+  {
+    n = cursor->j;
+    while (n < seq->count - 1 && TSEQUENCE_INST_N(seq, n + 1)->t <= t)
+      n++;
+  }
+  else
+    n = tcontseq_find_timestamp(seq, t);
+  cursor->j = n;
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, n);
+  if (t == inst1->t)
+    *result = tinstant_value_copy(inst1);
+  else
+  {
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, n + 1);
+    interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+    *result = tsegment_value_at_timestamp(inst1, inst2, interp, t);
+  }
+  return true;
+}
+
+/**
+ * @brief Cursor-based version of #tdiscseq_value_at_timestamp
+ */
+static bool
+tdiscseq_cursor_value(TemporalCursor *cursor, const TSequence *seq,
+  TimestampTz t, Datum *result)
+{
+  if (! (cursor->valid && t >= cursor->t))
+  {
+    /* Restart the scan from the beginning of the sequence */
+    cursor->j = 0;
+  }
+  int n = cursor->j;
+  while (n < seq->count - 1 && TSEQUENCE_INST_N(seq, n + 1)->t <= t)
+    n++;
+  cursor->j = n;
+  const TInstant *inst = TSEQUENCE_INST_N(seq, n);
+  if (inst->t != t)
+    return false;
+  *result = tinstant_value_copy(inst);
+  return true;
+}
+
+/**
+ * @brief Cursor-based version of #tsequenceset_value_at_timestamp
+ */
+static bool
+tsequenceset_cursor_value(TemporalCursor *cursor, const TSequenceSet *ss,
+  TimestampTz t, bool strict, Datum *result)
+{
+  int i;
+  if (cursor->valid && t >= cursor->t)
+    /* Sequences before the cached one end before the last probe */
+    i = cursor->i;
+  else if (strict)
+  {
+    /* Jump backwards: locate the sequence with a binary search; on a miss
+     * the output is the insertion point, which restores the invariant that
+     * all the sequences before the cached one end before the last probe */
+    bool found = tsequenceset_find_timestamp(ss, t, &i);
+    cursor->i = i;
+    cursor->j = 0;
+    if (! found)
+      return false;
+  }
+  else
+  {
+    /* Jump backwards: restart the scan from the first sequence */
+    i = 0;
+    cursor->i = 0;
+    cursor->j = 0;
+  }
+  while (i < ss->count)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    /* Test whether the timestamp is at one of the exclusive bounds */
+    if (! strict)
+    {
+      const TInstant *inst = TSEQUENCE_INST_N(seq, 0);
+      if (inst->t == t)
+        return tinstant_value_at_timestamp(inst, t, result);
+      inst = TSEQUENCE_INST_N(seq, seq->count - 1);
+      if (inst->t == t)
+        return tinstant_value_at_timestamp(inst, t, result);
+    }
+    if (contains_period_timestamp(&seq->period, t))
+    {
+      if (cursor->i != i)
+      {
+        /* The cached segment belongs to another sequence */
+        cursor->i = i;
+        cursor->j = 0;
+      }
+      return tsequence_cursor_value(cursor, seq, t, true, result);
+    }
+    if (t <= DatumGetTimestampTz(seq->period.upper))
+      /* The timestamp is in the gap before the sequence */
+      return false;
+    /* The timestamp is after the sequence */
+    i++;
+    cursor->i = i;
+    cursor->j = 0;
+  }
+  return false;
+}
+
+/**
+ * @ingroup libmeos_internal_temporal_restrict
+ * @brief Return the base value of a temporal value at the timestamp,
+ * resuming the search from the position of the previous lookup
+ * @param[in,out] cursor Cursor initialized with #temporal_cursor_init
+ * @param[in] t Timestamp
+ * @param[in] strict True if inclusive/exclusive bounds are taken into account
+ * @param[out] result Base value
+ * @sqlfunc valueAtTimestamp
+ */
+bool
+temporal_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t,
+  bool strict, Datum *result)
+{
+  assert(cursor); assert(cursor->temp); assert(result);
+  const Temporal *temp = cursor->temp;
+  /* Invalidate the cached position when the value was modified in place,
+   * detected in O(1) through the generation counter */
+  if (cursor->valid && temporal_generation(temp) != cursor->generation)
+  {
+    cursor->generation = temporal_generation(temp);
+    cursor->i = cursor->j = 0;
+    cursor->valid = false;
+  }
+  bool found;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    found = tinstant_value_at_timestamp((TInstant *) temp, t, result);
+  else if (temp->subtype == TSEQUENCE)
+    found = MEOS_FLAGS_DISCRETE_INTERP(temp->flags) ?
+      tdiscseq_cursor_value(cursor, (TSequence *) temp, t, result) :
+      tsequence_cursor_value(cursor, (TSequence *) temp, t, strict, result);
+  else /* subtype == TSEQUENCESET */
+    found = tsequenceset_cursor_value(cursor, (TSequenceSet *) temp, t,
+      strict, result);
+  cursor->t = t;
+  cursor->valid = true;
+  return found;
+}
+
 /*****************************************************************************/
 
 /**
@@ -3881,6 +4618,7 @@ Temporal *
 temporal_restrict_timestampset(const Temporal *temp, const Set *s, bool atfunc)
 {
   assert(temp); assert(s);
+  MEOS_STATS_INC(restrict_calls);
   Temporal *result;
   assert(temptype_subtype(temp->subtype));
   if (temp->subtype == TINSTANT)
@@ -3913,6 +4651,7 @@ Temporal *
 temporal_restrict_period(const Temporal *temp, const Span *s, bool atfunc)
 {
   assert(temp); assert(s);
+  MEOS_STATS_INC(restrict_calls);
   Temporal *result;
   assert(temptype_subtype(temp->subtype));
   if (temp->subtype == TINSTANT)
@@ -3937,6 +4676,7 @@ temporal_restrict_periodset(const Temporal *temp, const SpanSet *ss,
   bool atfunc)
 {
   assert(temp); assert(ss);
+  MEOS_STATS_INC(restrict_calls);
   Temporal *result;
   assert(temptype_subtype(temp->subtype));
   if (temp->subtype == TINSTANT)
@@ -4031,6 +4771,277 @@ tnumber_minus_tbox(const Temporal *temp, const TBox *box)
   return result;
 }
 
+/*****************************************************************************
+ * Fused restriction functions
+ *****************************************************************************/
+
+#if MEOS
+/**
+ * Structure to represent a composable restriction. Predicates of the same
+ * kind are intersected (respectively, unioned for the excluded values) as
+ * they are accumulated, so that materializing the restriction performs at
+ * most one scan per predicate kind instead of one scan per predicate added.
+ */
+struct Restriction
+{
+  bool hasperiod;     /**< True when a time period has been accumulated */
+  bool hasspan;       /**< True when a value span has been accumulated */
+  bool hasbox;        /**< True when a spatiotemporal box has been
+                           accumulated */
+  bool empty;         /**< True when the accumulated predicates are
+                           unsatisfiable */
+  Span period;        /**< Intersection of the accumulated time periods */
+  Span span;          /**< Intersection of the accumulated value spans */
+  STBox box;          /**< Intersection of the accumulated spatiotemporal
+                           boxes */
+  Set *minusvalues;   /**< Union of the accumulated excluded value sets */
+};
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Construct an empty composable restriction.
+ * @note An empty restriction does not restrict anything: materializing it
+ * returns a copy of the temporal value
+ */
+Restriction *
+restriction_make(void)
+{
+  return palloc0(sizeof(Restriction));
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Free a composable restriction.
+ */
+void
+restriction_free(Restriction *rest)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) rest))
+    return;
+  if (rest->minusvalues)
+    pfree(rest->minusvalues);
+  pfree(rest);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Add a time period predicate to a composable restriction.
+ * @return On error, or when the accumulated predicates became unsatisfiable,
+ * return false
+ */
+bool
+restriction_add_period(Restriction *rest, const Span *s)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) rest) || ! ensure_not_null((void *) s) ||
+      ! ensure_span_has_type(s, T_TSTZSPAN))
+    return false;
+  if (rest->empty)
+    return false;
+  if (! rest->hasperiod)
+  {
+    memcpy(&rest->period, s, sizeof(Span));
+    rest->hasperiod = true;
+    return true;
+  }
+  Span inter;
+  if (! inter_span_span(&rest->period, s, &inter))
+  {
+    rest->empty = true;
+    return false;
+  }
+  memcpy(&rest->period, &inter, sizeof(Span));
+  return true;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Add a value span predicate to a composable restriction.
+ * @return On error, or when the accumulated predicates became unsatisfiable,
+ * return false
+ */
+bool
+restriction_add_span(Restriction *rest, const Span *s)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) rest) || ! ensure_not_null((void *) s) ||
+      ! ensure_numspan_type(s->spantype))
+    return false;
+  if (rest->empty)
+    return false;
+  if (! rest->hasspan)
+  {
+    memcpy(&rest->span, s, sizeof(Span));
+    rest->hasspan = true;
+    return true;
+  }
+  if (! ensure_same_span_type(&rest->span, s))
+    return false;
+  Span inter;
+  if (! inter_span_span(&rest->span, s, &inter))
+  {
+    rest->empty = true;
+    return false;
+  }
+  memcpy(&rest->span, &inter, sizeof(Span));
+  return true;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Add a temporal box predicate to a composable restriction.
+ *
+ * The box is decomposed into its value span and time period, which are
+ * accumulated independently.
+ * @return On error, or when the accumulated predicates became unsatisfiable,
+ * return false
+ */
+bool
+restriction_add_tbox(Restriction *rest, const TBox *box)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) rest) || ! ensure_not_null((void *) box))
+    return false;
+  if (MEOS_FLAGS_GET_T(box->flags) &&
+      ! restriction_add_period(rest, &box->period))
+    return false;
+  if (MEOS_FLAGS_GET_X(box->flags) &&
+      ! restriction_add_span(rest, &box->span))
+    return false;
+  return true;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Add a spatiotemporal box predicate to a composable restriction.
+ * @return On error, or when the accumulated predicates became unsatisfiable,
+ * return false
+ */
+bool
+restriction_add_stbox(Restriction *rest, const STBox *box)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) rest) || ! ensure_not_null((void *) box))
+    return false;
+  if (rest->empty)
+    return false;
+  if (! rest->hasbox)
+  {
+    memcpy(&rest->box, box, sizeof(STBox));
+    rest->hasbox = true;
+    return true;
+  }
+  if (! ensure_same_srid_stbox(&rest->box, box))
+    return false;
+  STBox inter;
+  if (! inter_stbox_stbox(&rest->box, box, &inter))
+  {
+    rest->empty = true;
+    return false;
+  }
+  memcpy(&rest->box, &inter, sizeof(STBox));
+  return true;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Add an excluded value set predicate to a composable restriction.
+ * @return On error, return false
+ */
+bool
+restriction_add_minus_values(Restriction *rest, const Set *s)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) rest) || ! ensure_not_null((void *) s))
+    return false;
+  if (! rest->minusvalues)
+    rest->minusvalues = set_copy(s);
+  else
+  {
+    Set *merged = union_set_set(rest->minusvalues, s);
+    if (! merged)
+      return false;
+    pfree(rest->minusvalues);
+    rest->minusvalues = merged;
+  }
+  return true;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Materialize a composable restriction on a temporal value.
+ *
+ * The time period accumulated in the restriction is folded into the period
+ * dimension of the spatiotemporal box (if any), so that the temporal value is
+ * scanned at most once per predicate kind however many predicates were
+ * accumulated.
+ * @return On error, or when the restriction is unsatisfiable or selects
+ * nothing, return NULL
+ * @note An empty restriction returns a copy of the temporal value
+ */
+Temporal *
+temporal_restrict_fused(const Temporal *temp, const Restriction *rest)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) rest))
+    return NULL;
+  if (rest->hasspan &&
+      ! ensure_valid_tnumber_span(temp, &rest->span))
+    return NULL;
+  if (rest->hasbox && ! ensure_tgeo_type(temp->temptype))
+    return NULL;
+  if (rest->empty)
+    return NULL;
+
+  const Temporal *curr = temp;
+  Temporal *next;
+  if (rest->hasbox)
+  {
+    /* Fold the accumulated period into the period dimension of the box so
+     * that the box and time restrictions are answered by a single scan */
+    STBox box;
+    memcpy(&box, &rest->box, sizeof(STBox));
+    if (rest->hasperiod)
+    {
+      if (MEOS_FLAGS_GET_T(box.flags))
+      {
+        Span inter;
+        if (! inter_span_span(&box.period, &rest->period, &inter))
+          return NULL;
+        memcpy(&box.period, &inter, sizeof(Span));
+      }
+      else
+      {
+        memcpy(&box.period, &rest->period, sizeof(Span));
+        MEOS_FLAGS_SET_T(box.flags, true);
+      }
+    }
+    curr = tpoint_restrict_stbox(curr, &box, BORDER_INC, REST_AT);
+  }
+  else if (rest->hasperiod)
+    curr = temporal_restrict_period(curr, &rest->period, REST_AT);
+  if (curr && rest->hasspan)
+  {
+    next = tnumber_restrict_span(curr, &rest->span, REST_AT);
+    if (curr != temp)
+      pfree((void *) curr);
+    curr = next;
+  }
+  if (curr && rest->minusvalues)
+  {
+    next = temporal_restrict_values(curr, rest->minusvalues, REST_MINUS);
+    if (curr != temp)
+      pfree((void *) curr);
+    curr = next;
+  }
+  if (curr == temp)
+    return temporal_copy(temp);
+  return (Temporal *) curr;
+}
+#endif /* MEOS */
+
 /*****************************************************************************
  * Modification functions
  *****************************************************************************/
@@ -4410,6 +5421,39 @@ temporal_stops(const Temporal *temp, double maxdist,
   return result;
 }
 
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return the restriction of the temporal value to the periods where
+ * it does not stay within an area with a given maximum size for at least
+ * the specified duration.
+ * @param[in] temp Temporal value
+ * @param[in] maxdist Maximum distance
+ * @param[in] minduration Minimum duration
+ * @see temporal_stops
+ */
+Temporal *
+temporal_moves(const Temporal *temp, double maxdist,
+  const Interval *minduration)
+{
+  /* The validity of the arguments is ensured by temporal_stops, which
+   * returns NULL both on error and when there are no stops */
+  int last_errno = meos_errno_reset();
+  TSequenceSet *stops = temporal_stops(temp, maxdist, minduration);
+  if (! stops)
+  {
+    if (meos_errno())
+      return NULL;
+    meos_errno_restore(last_errno);
+    return temporal_copy(temp);
+  }
+  meos_errno_restore(last_errno);
+  SpanSet *ss = tsequenceset_time(stops);
+  pfree(stops);
+  Temporal *result = temporal_restrict_periodset(temp, ss, REST_MINUS);
+  pfree(ss);
+  return result;
+}
+
 /*****************************************************************************
  * Local aggregate functions
  *****************************************************************************/
@@ -4461,6 +5505,84 @@ tnumber_twavg(const Temporal *temp)
   return result;
 }
 
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Return the approximate time-weighted average of a temporal number
+ * computed from a stratified sample of its composing sequences.
+ *
+ * The composing sequences are partitioned in time order into as many strata
+ * as requested by the sample fraction and one sequence per stratum is
+ * averaged exactly, so all parts of the time extent contribute to the
+ * estimate. The reported error is the half-width of the 95% confidence
+ * interval of the estimate under the normal approximation, which assumes
+ * that the sampled sequences are representative of their strata. Values
+ * that are not sequence sets, or for which the fraction does not reduce the
+ * work, are computed exactly with a zero error.
+ * @param[in] temp Temporal value
+ * @param[in] fraction Fraction of the composing sequences sampled, in (0, 1]
+ * @param[out] error Half-width of the 95% confidence interval, may be NULL
+ * @return On error return DBL_MAX
+ * @sqlfunc twAvgApprox
+ */
+double
+tnumber_twavg_approx(const Temporal *temp, double fraction, double *error)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_tnumber_type(temp->temptype))
+    return DBL_MAX;
+  if (fraction <= 0.0 || fraction > 1.0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The sample fraction must be in (0, 1]");
+    return DBL_MAX;
+  }
+
+  if (error)
+    *error = 0.0;
+  /* The sampling strata are the composing sequences */
+  if (temp->subtype != TSEQUENCESET)
+    return tnumber_twavg(temp);
+  const TSequenceSet *ss = (TSequenceSet *) temp;
+  int n = (int) ceil(ss->count * fraction);
+  if (n < 2)
+    n = 2;
+  if (n >= ss->count)
+    return tnumber_twavg(temp);
+
+  /* Average one sequence in the middle of each stratum of consecutive
+   * sequences, weighted by its duration */
+  double *means = palloc(sizeof(double) * n);
+  double *weights = palloc(sizeof(double) * n);
+  double sumw = 0.0, sumwx = 0.0;
+  for (int k = 0; k < n; k++)
+  {
+    int idx = (int) (((int64) (2 * k + 1) * ss->count) / (2 * n));
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, idx);
+    double w = (double) (DatumGetTimestampTz(seq->period.upper) -
+      DatumGetTimestampTz(seq->period.lower));
+    /* Instantaneous sequences count with a nominal weight */
+    if (w <= 0.0)
+      w = 1.0;
+    means[k] = tnumbercontseq_twavg(seq);
+    weights[k] = w;
+    sumw += w;
+    sumwx += w * means[k];
+  }
+  double result = sumwx / sumw;
+  if (error)
+  {
+    /* Weighted variance of the per-sequence averages around the estimate,
+     * scaled by the sample size */
+    double var = 0.0;
+    for (int k = 0; k < n; k++)
+      var += weights[k] * (means[k] - result) * (means[k] - result);
+    var /= sumw;
+    *error = 1.96 * sqrt(var / n);
+  }
+  pfree(means); pfree(weights);
+  return result;
+}
+
 /*****************************************************************************
  * Compact function for final append aggregate
  *****************************************************************************/
@@ -4721,6 +5843,10 @@ temporal_gt(const Temporal *temp1, const Temporal *temp2)
 /**
  * @ingroup libmeos_temporal_accessor
  * @brief Return the 32-bit hash value of a temporal value.
+ *
+ * The hash opclass contract requires that this function agrees with the low
+ * 32 bits of the extended hash computed with seed 0, hence both functions are
+ * derived from the same hash of the WKB representation of the value.
  * @result On error return INT_MAX
  */
 uint32
@@ -4730,15 +5856,26 @@ temporal_hash(const Temporal *temp)
   if (! ensure_not_null((void *) temp))
     return INT_MAX;
 
-  uint32 result;
-  assert(temptype_subtype(temp->subtype));
-  if (temp->subtype == TINSTANT)
-    result = tinstant_hash((TInstant *) temp);
-  else if (temp->subtype == TSEQUENCE)
-    result = tsequence_hash((TSequence *) temp);
-  else /* temp->subtype == TSEQUENCESET */
-    result = tsequenceset_hash((TSequenceSet *) temp);
-  return result;
+  return (uint32) temporal_hash_extended(temp, 0);
+}
+
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return the 64-bit hash value of a temporal value using a seed.
+ *
+ * The hash is computed over the WKB representation of the value, which the
+ * WKB writer streams into the hash state without materializing the buffer.
+ * @result On error return INT_MAX
+ * @sqlfunc hash_extended()
+ */
+uint64
+temporal_hash_extended(const Temporal *temp, uint64 seed)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp))
+    return INT_MAX;
+
+  return datum_hash_wkb_extended(PointerGetDatum(temp), temp->temptype, seed);
 }
 
 /*****************************************************************************/
@@ -36,6 +36,7 @@
 
 /* C */
 #include <assert.h>
+#include <float.h>
 #include <math.h>
 #include <string.h>
 /* PostgreSQL */
@@ -44,12 +45,16 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#if MEOS
+  #include "general/pool.h"
+#endif
 #include "general/skiplist.h"
 #include "general/spanset.h"
 #include "general/temporaltypes.h"
 #include "general/temporal_tile.h"
 #include "general/tbool_boolops.h"
 #include "general/doublen.h"
+#include "general/type_util.h"
 
 /*****************************************************************************
  * Aggregate functions on datums
@@ -308,31 +313,35 @@ tsequence_tagg_iter(const TSequence *seq1, const TSequence *seq2,
   /*
    * Compute the aggregation on the intersection of intervals
    */
-  TSequence *syncseq1, *syncseq2;
-  synchronize_tsequence_tsequence(seq1, seq2, &syncseq1, &syncseq2, crossings);
-  TInstant **instants = palloc(sizeof(TInstant *) * syncseq1->count);
-  for (int i = 0; i < syncseq1->count; i++)
+  TSeqSyncIter iter;
+  /* The call is ensured to succeed due to the period intersection test above */
+  tsequence_sync_iter_start(seq1, seq2, crossings, &iter);
+  TInstant **instants = palloc(sizeof(TInstant *) *
+    (seq1->count + seq2->count) * 2);
+  int ninsts = 0;
+  TimestampTz t;
+  Datum value1, value2;
+  meosType basetype = temptype_basetype(seq1->temptype);
+  while (tsequence_sync_iter_next(&iter, &t, &value1, &value2))
   {
-    const TInstant *inst1 = TSEQUENCE_INST_N(syncseq1, i);
-    const TInstant *inst2 = TSEQUENCE_INST_N(syncseq2, i);
     if (func != NULL)
-      instants[i] = tinstant_make(
-        func(tinstant_value(inst1), tinstant_value(inst2)), seq1->temptype,
-        inst1->t);
+      instants[ninsts++] = tinstant_make(func(value1, value2), seq1->temptype,
+        t);
     else
     {
-      if (tinstant_eq(inst1, inst2))
-        instants[i] = tinstant_copy(inst1);
+      if (datum_eq(value1, value2, basetype))
+        instants[ninsts++] = tinstant_make(value1, seq1->temptype, t);
       else
       {
+        tsequence_sync_iter_close(&iter);
         meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "Unable to merge values");
         return -1;
       }
     }
   }
-  sequences[nseqs++] = tsequence_make_free(instants, syncseq1->count,
+  tsequence_sync_iter_close(&iter);
+  sequences[nseqs++] = tsequence_make_free(instants, ninsts,
     lower_inc, upper_inc, MEOS_FLAGS_GET_INTERP(seq1->flags), NORMALIZE);
-  pfree(syncseq1); pfree(syncseq2);
 
   /* Compute the aggregation on the period after the intersection of the
    * intervals */
@@ -475,7 +484,7 @@ tinstant_tagg_transfn(SkipList *state, const TInstant *inst, datum_func2 func)
     result = skiplist_make((void **) instants, 1);
   else
   {
-    skiplist_splice(state, (void **) instants, 1, func, false);
+    skiplist_splice_buffered(state, (void *) instants[0], func, false);
     result = state;
   }
   pfree(instants);
@@ -605,8 +614,10 @@ temporal_tagg_combinefn(SkipList *state1, SkipList *state2, datum_func2 func,
   if (state2->length == 0)
     return state1;
 
-  int count2 = state2->length;
+  /* Read the values before the length since the former splices the pending
+   * buffered instants of the state, if any */
   void **values2 = skiplist_values(state2);
+  int count2 = state2->length;
   skiplist_splice(state1, values2, count2, func, crossings);
   pfree(values2);
   return state1;
@@ -614,15 +625,23 @@ temporal_tagg_combinefn(SkipList *state1, SkipList *state2, datum_func2 func,
 
 /**
  * @ingroup libmeos_temporal_agg
- * @brief Generic final function for aggregating temporal values
+ * @brief Read the current value of a temporal aggregation without modifying
+ * the state
+ *
+ * This function enables incremental aggregation: the skip list state can be
+ * kept resident, extended with the transition functions as new fragments
+ * arrive, and read at any time, so that a refresh costs the size of the
+ * delta instead of the whole history.
+ *
  * @param[in] state State values
  */
 Temporal *
-temporal_tagg_finalfn(SkipList *state)
+temporal_tagg_readfn(SkipList *state)
 {
   if (! state || state->length == 0)
     return NULL;
-  /* A copy of the values is needed for switching from aggregate context */
+  /* A copy of the values is needed since the result does not share memory
+   * with the state */
   Temporal **values = skiplist_temporal_values(state);
   Temporal *result = NULL;
   assert(values[0]->subtype == TINSTANT || values[0]->subtype == TSEQUENCE);
@@ -632,10 +651,197 @@ temporal_tagg_finalfn(SkipList *state)
   else /* values[0]->subtype == TSEQUENCE */
     result = (Temporal *) tsequenceset_make_free((TSequence **) values,
       state->length, NORMALIZE);
-  skiplist_free(state);
   return result;
 }
 
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Generic final function for aggregating temporal values
+ * @param[in] state State values
+ */
+Temporal *
+temporal_tagg_finalfn(SkipList *state)
+{
+  Temporal *result = temporal_tagg_readfn(state);
+  if (result)
+    skiplist_free(state);
+  return result;
+}
+
+/*****************************************************************************
+ * Time-bucketed aggregation
+ *
+ * Rollup queries that group by time bucket first materialize the bucketed
+ * temporal value of every group and then aggregate it away. The functions
+ * below fuse the two steps: a single scan splits the incoming temporal value
+ * into its bucket fragments and splices each fragment directly into the
+ * aggregation state of its bucket, so that no intermediate bucketed value is
+ * ever assembled. The state keeps one skiplist per bucket, with the buckets
+ * stored in ascending order of their start timestamp.
+ *****************************************************************************/
+
+/**
+ * @brief Return the location of the aggregation state of the bucket starting
+ * at the given timestamp, creating the bucket if it does not exist
+ */
+static int
+bucket_tagg_state_get(BucketAggState *state, TimestampTz bucket)
+{
+  int lo = 0, hi = state->count - 1;
+  while (lo <= hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (state->buckets[mid] == bucket)
+      return mid;
+    if (state->buckets[mid] < bucket)
+      lo = mid + 1;
+    else
+      hi = mid - 1;
+  }
+  /* The bucket does not exist: insert it at location lo */
+  if (state->count == state->maxcount)
+  {
+    state->maxcount *= 2;
+    state->buckets = repalloc(state->buckets,
+      sizeof(TimestampTz) * state->maxcount);
+    state->states = repalloc(state->states,
+      sizeof(SkipList *) * state->maxcount);
+  }
+  memmove(&state->buckets[lo + 1], &state->buckets[lo],
+    sizeof(TimestampTz) * (state->count - lo));
+  memmove(&state->states[lo + 1], &state->states[lo],
+    sizeof(SkipList *) * (state->count - lo));
+  state->buckets[lo] = bucket;
+  state->states[lo] = NULL;
+  state->count++;
+  return lo;
+}
+
+/**
+ * @brief Generic transition function for the time-bucketed aggregation of
+ * temporal values
+ * @param[in,out] state Current aggregate state, may be NULL on the first call
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[in] func Aggregate function
+ * @param[in] crossings True if turning points are added in the segments
+ * @param[in] transform Transform function applied to the instants before
+ * aggregating, may be NULL
+ */
+BucketAggState *
+temporal_tagg_bucket_transfn(BucketAggState *state, const Temporal *temp,
+  const Interval *duration, TimestampTz torigin, datum_func2 func,
+  bool crossings, TInstant *(*transform)(const TInstant *))
+{
+  assert(temp);
+  /* Null state: create a new state for the given bucket grid */
+  if (! state)
+  {
+    if (! ensure_valid_duration(duration))
+      return NULL;
+    state = palloc0(sizeof(BucketAggState));
+    state->tunits = interval_units(duration);
+    state->torigin = torigin;
+    /* Arbitrary initialization to 64 buckets */
+    state->maxcount = 64;
+    state->buckets = palloc(sizeof(TimestampTz) * state->maxcount);
+    state->states = palloc(sizeof(SkipList *) * state->maxcount);
+  }
+  else if (state->tunits != interval_units(duration) ||
+    state->torigin != torigin)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The duration and origin of the buckets must not change during the aggregation");
+    return NULL;
+  }
+  /* Split the value into its bucket fragments and splice each fragment
+   * directly into the state of its bucket */
+  int count;
+  TimestampTz *buckets;
+  Temporal **fragments = temporal_time_split((Temporal *) temp,
+    (Interval *) duration, torigin, &buckets, &count);
+  if (! fragments)
+    return NULL;
+  for (int i = 0; i < count; i++)
+  {
+    int loc = bucket_tagg_state_get(state, buckets[i]);
+    state->states[loc] = transform ?
+      temporal_tagg_transform_transfn(state->states[loc], fragments[i], func,
+        crossings, transform) :
+      temporal_tagg_transfn(state->states[loc], fragments[i], func,
+        crossings);
+    pfree(fragments[i]);
+  }
+  pfree(fragments); pfree(buckets);
+  return state;
+}
+
+/**
+ * @brief Generic final function for the time-bucketed aggregation of
+ * temporal values
+ * @param[in] state Current aggregate state
+ * @param[in] finalfn Final function applied to the state of every bucket
+ * @param[out] buckets Start timestamp of the buckets
+ * @param[out] count Number of values in the output arrays
+ */
+static Temporal **
+temporal_tagg_bucket_finalfn1(BucketAggState *state,
+  Temporal *(*finalfn)(SkipList *), TimestampTz **buckets, int *count)
+{
+  assert(buckets); assert(count);
+  if (! state || state->count == 0)
+    return NULL;
+  Temporal **result = palloc(sizeof(Temporal *) * state->count);
+  for (int i = 0; i < state->count; i++)
+    result[i] = finalfn(state->states[i]);
+  /* Transfer the ownership of the bucket array to the caller */
+  *buckets = state->buckets;
+  *count = state->count;
+  pfree(state->states); pfree(state);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Final function for the time-bucketed aggregation of temporal values
+ * @param[in] state Current aggregate state
+ * @param[out] buckets Start timestamp of the buckets
+ * @param[out] count Number of values in the output arrays
+ * @return Array with the aggregated value of every bucket. On error return
+ * NULL
+ */
+Temporal **
+temporal_tagg_bucket_finalfn(BucketAggState *state, TimestampTz **buckets,
+  int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) buckets) || ! ensure_not_null((void *) count))
+    return NULL;
+  return temporal_tagg_bucket_finalfn1(state, &temporal_tagg_finalfn, buckets,
+    count);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Final function for the time-bucketed average of temporal numbers
+ * @param[in] state Current aggregate state
+ * @param[out] buckets Start timestamp of the buckets
+ * @param[out] count Number of values in the output arrays
+ * @return Array with the aggregated value of every bucket. On error return
+ * NULL
+ */
+Temporal **
+tnumber_tavg_bucket_finalfn(BucketAggState *state, TimestampTz **buckets,
+  int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) buckets) || ! ensure_not_null((void *) count))
+    return NULL;
+  return temporal_tagg_bucket_finalfn1(state, &tnumber_tavg_finalfn, buckets,
+    count);
+}
+
 #if MEOS
 /**
  * @ingroup libmeos_temporal_agg
@@ -791,6 +997,146 @@ tnumber_tavg_transfn(SkipList *state, const Temporal *temp)
     CROSSINGS_NO, &tnumberinst_transform_tavg);
 }
 
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for the time-bucketed temporal minimum of
+ * temporal values.
+ * @sqlfunc tmin()
+ */
+BucketAggState *
+tint_tmin_bucket_transfn(BucketAggState *state, const Temporal *temp,
+  const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_temporal_has_type(temp, T_TINT))
+    return NULL;
+  return temporal_tagg_bucket_transfn(state, temp, duration, torigin,
+    &datum_min_int32, CROSSINGS_NO, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for the time-bucketed temporal minimum of
+ * temporal values.
+ * @sqlfunc tmin()
+ */
+BucketAggState *
+tfloat_tmin_bucket_transfn(BucketAggState *state, const Temporal *temp,
+  const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_temporal_has_type(temp, T_TFLOAT))
+    return NULL;
+  return temporal_tagg_bucket_transfn(state, temp, duration, torigin,
+    &datum_min_float8, CROSSINGS, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for the time-bucketed temporal maximum of
+ * temporal values.
+ * @sqlfunc tmax()
+ */
+BucketAggState *
+tint_tmax_bucket_transfn(BucketAggState *state, const Temporal *temp,
+  const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_temporal_has_type(temp, T_TINT))
+    return NULL;
+  return temporal_tagg_bucket_transfn(state, temp, duration, torigin,
+    &datum_max_int32, CROSSINGS_NO, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for the time-bucketed temporal maximum of
+ * temporal values.
+ * @sqlfunc tmax()
+ */
+BucketAggState *
+tfloat_tmax_bucket_transfn(BucketAggState *state, const Temporal *temp,
+  const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_temporal_has_type(temp, T_TFLOAT))
+    return NULL;
+  return temporal_tagg_bucket_transfn(state, temp, duration, torigin,
+    &datum_max_float8, CROSSINGS, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for the time-bucketed temporal sum of temporal
+ * values.
+ * @sqlfunc tsum()
+ */
+BucketAggState *
+tint_tsum_bucket_transfn(BucketAggState *state, const Temporal *temp,
+  const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_temporal_has_type(temp, T_TINT))
+    return NULL;
+  return temporal_tagg_bucket_transfn(state, temp, duration, torigin,
+    &datum_sum_int32, CROSSINGS_NO, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for the time-bucketed temporal sum of temporal
+ * values.
+ * @sqlfunc tsum()
+ */
+BucketAggState *
+tfloat_tsum_bucket_transfn(BucketAggState *state, const Temporal *temp,
+  const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_temporal_has_type(temp, T_TFLOAT))
+    return NULL;
+  return temporal_tagg_bucket_transfn(state, temp, duration, torigin,
+    &datum_sum_float8, CROSSINGS_NO, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for the time-bucketed temporal average of
+ * temporal numbers.
+ * @sqlfunc tavg()
+ */
+BucketAggState *
+tnumber_tavg_bucket_transfn(BucketAggState *state, const Temporal *temp,
+  const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_tnumber_type(temp->temptype))
+    return NULL;
+  return temporal_tagg_bucket_transfn(state, temp, duration, torigin,
+    &datum_sum_double2, CROSSINGS_NO, &tnumberinst_transform_tavg);
+}
+
 /**
  * @ingroup libmeos_temporal_agg
  * @brief Transition function for temporal minimum of temporal text values.
@@ -825,6 +1171,236 @@ ttext_tmax_transfn(SkipList *state, const Temporal *temp)
   return temporal_tagg_transfn(state, temp, &datum_max_text, CROSSINGS_NO);
 }
 
+/*****************************************************************************
+ * Partitioned aggregation of arrays of temporal values
+ *
+ * Aggregating a large array one value at a time builds a single skiplist on
+ * the calling thread and, on multi-socket hosts, funnels all memory traffic
+ * through the node of that thread. The functions below partition the array
+ * on the thread pool: every partition is aggregated into its own partial
+ * skiplist by a single participant, so the partial states are allocated and
+ * read by the same thread and stay local to its NUMA node under first-touch
+ * placement, and the partials are combined into the state at the end.
+ *****************************************************************************/
+
+/**
+ * @brief Argument of a partitioned aggregation executed on the thread pool
+ */
+typedef struct TaggPartitionTask
+{
+  const Temporal **temparr; /**< Array of input values */
+  int count;                /**< Number of input values */
+  int nparts;               /**< Number of partitions */
+  datum_func2 func;         /**< Aggregate function */
+  bool crossings;           /**< True if turning points are added */
+  TInstant *(*transform)(const TInstant *); /**< Transform function applied
+                                to the instants, may be NULL */
+  SkipList **partials;      /**< Partial state of every partition */
+} TaggPartitionTask;
+
+/**
+ * @brief Aggregate one partition of an array of temporal values, task
+ * function executed on the thread pool
+ */
+static void
+temporal_tagg_partition_task(void *arg, int idx)
+{
+  TaggPartitionTask *task = (TaggPartitionTask *) arg;
+  int lower = (int) (((int64) task->count * idx) / task->nparts);
+  int upper = (int) (((int64) task->count * (idx + 1)) / task->nparts);
+  SkipList *state = NULL;
+  for (int i = lower; i < upper; i++)
+    state = task->transform ?
+      temporal_tagg_transform_transfn(state, task->temparr[i], task->func,
+        task->crossings, task->transform) :
+      temporal_tagg_transfn(state, task->temparr[i], task->func,
+        task->crossings);
+  task->partials[idx] = state;
+  return;
+}
+
+/**
+ * @brief Generic transition function for aggregating an array of temporal
+ * values with partition-wise parallelism
+ * @param[in,out] state Skiplist containing the state
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[in] func Aggregate function
+ * @param[in] crossings True if turning points are added in the segments
+ * @param[in] transform Transform function applied to the instants, may be
+ * NULL
+ */
+SkipList *
+temporal_tagg_array_transfn(SkipList *state, const Temporal **temparr,
+  int count, datum_func2 func, bool crossings,
+  TInstant *(*transform)(const TInstant *))
+{
+  assert(temparr);
+  int nparts = meos_pool_num_threads();
+  /* Aggregate serially when there is no pool or too few values to offset
+   * the cost of combining the partial states */
+  if (! meos_pool_active() || count < nparts * 2)
+  {
+    for (int i = 0; i < count; i++)
+      state = transform ?
+        temporal_tagg_transform_transfn(state, temparr[i], func, crossings,
+          transform) :
+        temporal_tagg_transfn(state, temparr[i], func, crossings);
+    return state;
+  }
+
+  SkipList **partials = palloc(sizeof(SkipList *) * nparts);
+  TaggPartitionTask task =
+    { temparr, count, nparts, func, crossings, transform, partials };
+  meos_pool_parallel_for(nparts, &temporal_tagg_partition_task, &task);
+  /* Combine the partial states into the state */
+  for (int i = 0; i < nparts; i++)
+  {
+    state = temporal_tagg_combinefn(state, partials[i], func, crossings);
+    if (state != partials[i])
+      skiplist_free(partials[i]);
+  }
+  pfree(partials);
+  return state;
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for temporal minimum of an array of temporal
+ * values.
+ * @sqlfunc tmin()
+ */
+SkipList *
+tint_tmin_array_transfn(SkipList *state, const Temporal **temparr, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  for (int i = 0; i < count; i++)
+    if (! ensure_temporal_has_type(temparr[i], T_TINT))
+      return NULL;
+  return temporal_tagg_array_transfn(state, temparr, count, &datum_min_int32,
+    CROSSINGS_NO, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for temporal minimum of an array of temporal
+ * values.
+ * @sqlfunc tmin()
+ */
+SkipList *
+tfloat_tmin_array_transfn(SkipList *state, const Temporal **temparr,
+  int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  for (int i = 0; i < count; i++)
+    if (! ensure_temporal_has_type(temparr[i], T_TFLOAT))
+      return NULL;
+  return temporal_tagg_array_transfn(state, temparr, count,
+    &datum_min_float8, CROSSINGS, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for temporal maximum of an array of temporal
+ * values.
+ * @sqlfunc tmax()
+ */
+SkipList *
+tint_tmax_array_transfn(SkipList *state, const Temporal **temparr, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  for (int i = 0; i < count; i++)
+    if (! ensure_temporal_has_type(temparr[i], T_TINT))
+      return NULL;
+  return temporal_tagg_array_transfn(state, temparr, count, &datum_max_int32,
+    CROSSINGS_NO, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for temporal maximum of an array of temporal
+ * values.
+ * @sqlfunc tmax()
+ */
+SkipList *
+tfloat_tmax_array_transfn(SkipList *state, const Temporal **temparr,
+  int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  for (int i = 0; i < count; i++)
+    if (! ensure_temporal_has_type(temparr[i], T_TFLOAT))
+      return NULL;
+  return temporal_tagg_array_transfn(state, temparr, count,
+    &datum_max_float8, CROSSINGS, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for temporal sum of an array of temporal
+ * values.
+ * @sqlfunc tsum()
+ */
+SkipList *
+tint_tsum_array_transfn(SkipList *state, const Temporal **temparr, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  for (int i = 0; i < count; i++)
+    if (! ensure_temporal_has_type(temparr[i], T_TINT))
+      return NULL;
+  return temporal_tagg_array_transfn(state, temparr, count, &datum_sum_int32,
+    CROSSINGS_NO, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for temporal sum of an array of temporal
+ * values.
+ * @sqlfunc tsum()
+ */
+SkipList *
+tfloat_tsum_array_transfn(SkipList *state, const Temporal **temparr,
+  int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  for (int i = 0; i < count; i++)
+    if (! ensure_temporal_has_type(temparr[i], T_TFLOAT))
+      return NULL;
+  return temporal_tagg_array_transfn(state, temparr, count,
+    &datum_sum_float8, CROSSINGS_NO, NULL);
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Transition function for temporal average of an array of temporal
+ * numbers.
+ * @sqlfunc tavg()
+ */
+SkipList *
+tnumber_tavg_array_transfn(SkipList *state, const Temporal **temparr,
+  int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  for (int i = 0; i < count; i++)
+    if (! ensure_tnumber_type(temparr[i]->temptype))
+      return NULL;
+  return temporal_tagg_array_transfn(state, temparr, count,
+    &datum_sum_double2, CROSSINGS_NO, &tnumberinst_transform_tavg);
+}
+
 #endif /* MEOS */
 
 /*****************************************************************************
@@ -1068,8 +1644,7 @@ tcontseq_transform_tcount(const TSequence *seq)
   if (seq->count == 1)
   {
     TInstant *inst = tinstant_make(datum_one, T_TINT, t);
-    result = tinstant_to_tsequence(inst, STEP);
-    pfree(inst);
+    result = tinstant_to_tsequence_free(inst, STEP);
     return result;
   }
 
@@ -1152,7 +1727,7 @@ timestamp_tcount_transfn(SkipList *state, TimestampTz t)
   {
     if (! ensure_same_skiplist_subtype(state, TINSTANT))
       return NULL;
-    skiplist_splice(state, (void **) instants, 1, &datum_sum_int32,
+    skiplist_splice_buffered(state, (void *) instants[0], &datum_sum_int32,
       CROSSINGS_NO);
   }
 
@@ -1342,10 +1917,11 @@ tsequence_tavg_finalfn(TSequence **sequences, int count)
 
 /**
  * @ingroup libmeos_temporal_agg
- * @brief Final function for temporal average aggregation
+ * @brief Read the current value of a temporal average aggregation without
+ * modifying the state
  */
 Temporal *
-tnumber_tavg_finalfn(SkipList *state)
+tnumber_tavg_readfn(SkipList *state)
 {
   if (! state || state->length == 0)
     return NULL;
@@ -1360,7 +1936,19 @@ tnumber_tavg_finalfn(SkipList *state)
     result = (Temporal *) tsequence_tavg_finalfn((TSequence **) values,
       state->length);
   pfree(values);
-  skiplist_free(state);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Final function for temporal average aggregation
+ */
+Temporal *
+tnumber_tavg_finalfn(SkipList *state)
+{
+  Temporal *result = tnumber_tavg_readfn(state);
+  if (result)
+    skiplist_free(state);
   return result;
 }
 
@@ -1425,4 +2013,106 @@ tnumber_extent_transfn(TBox *state, const Temporal *temp)
   return state;
 }
 
+/*****************************************************************************
+ * Single-pass summary statistics
+ *****************************************************************************/
+
+/**
+ * @brief Accumulate the summary statistics of a temporal sequence number
+ * walking its instants once
+ */
+static void
+tnumberseq_summary_iter(const TSequence *seq, int mask,
+  TNumberSummary *summary)
+{
+  meosType basetype = temptype_basetype(seq->temptype);
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags);
+  bool discrete = MEOS_FLAGS_DISCRETE_INTERP(seq->flags);
+  double prev = 0.0;
+  TimestampTz prevt = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    double value = datum_double(tinstant_value(inst), basetype);
+    if ((mask & MEOS_SUMMARY_MIN) && value < summary->min)
+      summary->min = value;
+    if ((mask & MEOS_SUMMARY_MAX) && value > summary->max)
+      summary->max = value;
+    if (mask & MEOS_SUMMARY_SUM)
+      summary->sum += value;
+    if ((mask & MEOS_SUMMARY_INTEGRAL) && i > 0 && ! discrete)
+      summary->integral += linear ?
+        (value + prev) * (double) (inst->t - prevt) / 2.0 :
+        prev * (double) (inst->t - prevt);
+    prev = value;
+    prevt = inst->t;
+  }
+  summary->count += seq->count;
+  if ((mask & MEOS_SUMMARY_DURATION) && ! discrete)
+    summary->duration += (double) (DatumGetTimestampTz(seq->period.upper) -
+      DatumGetTimestampTz(seq->period.lower));
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Compute several statistics of a temporal number in a single pass
+ * @param[in] temp Temporal value
+ * @param[in] mask Statistics to compute, a bitwise OR of the MEOS_SUMMARY_*
+ * flags; the fields that were not requested are undefined
+ * @param[out] summary Resulting statistics
+ * @return True on success
+ *
+ * Feature extraction pipelines computing several statistics per value are
+ * bound by the traversals of the instants rather than by the arithmetic;
+ * this function walks the instants once and derives all requested
+ * statistics from that single pass. The duration and the integral are
+ * expressed in seconds, hence the integral of a sequence differs from
+ * tnumber_integral() by a factor of one million.
+ */
+bool
+tnumber_summary(const Temporal *temp, int mask, TNumberSummary *summary)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_not_null((void *) summary) ||
+      ! ensure_tnumber_type(temp->temptype))
+    return false;
+
+  /* The time-weighted average is derived from the other statistics */
+  if (mask & MEOS_SUMMARY_TWAVG)
+    mask |= MEOS_SUMMARY_COUNT | MEOS_SUMMARY_SUM | MEOS_SUMMARY_DURATION |
+      MEOS_SUMMARY_INTEGRAL;
+  memset(summary, 0, sizeof(TNumberSummary));
+  summary->min = DBL_MAX;
+  summary->max = -DBL_MAX;
+
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+  {
+    double value = tnumberinst_double((TInstant *) temp);
+    summary->count = 1;
+    summary->min = summary->max = summary->sum = summary->twavg = value;
+    return true;
+  }
+  else if (temp->subtype == TSEQUENCE)
+    tnumberseq_summary_iter((TSequence *) temp, mask, summary);
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    TSequenceSet *ss = (TSequenceSet *) temp;
+    for (int i = 0; i < ss->count; i++)
+      tnumberseq_summary_iter(TSEQUENCESET_SEQ_N(ss, i), mask, summary);
+  }
+
+  if (mask & MEOS_SUMMARY_TWAVG)
+    summary->twavg = (summary->duration > 0.0) ?
+      summary->integral / summary->duration :
+      /* Instantaneous or discrete value, traditional average */
+      summary->sum / summary->count;
+  /* Convert from the internal microseconds to seconds */
+  summary->duration /= USECS_PER_SEC;
+  summary->integral /= USECS_PER_SEC;
+  return true;
+}
+
 /*****************************************************************************/
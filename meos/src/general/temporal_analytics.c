@@ -45,7 +45,9 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/interrupt.h"
 #include "general/pg_types.h"
+#include "general/pool.h"
 #include "general/temporaltypes.h"
 #include "general/temporal_tile.h"
 #include "general/type_util.h"
@@ -75,15 +77,48 @@ tinstant_tprecision(const TInstant *inst, const Interval *duration,
   return result;
 }
 
+/**
+ * @brief Reduce a bucket of a temporal value to a single value
+ * @note Temporal points have no meaningful value ordering, so the reduction
+ * for them is always the time-weighted centroid
+ */
+static Datum
+temporal_bucket_reduce(const Temporal *temp, reductionType reduction)
+{
+  if (tnumber_type(temp->temptype))
+  {
+    if (reduction == TRESAMPLE_MIN)
+      return temporal_min_value(temp);
+    if (reduction == TRESAMPLE_MAX)
+      return temporal_max_value(temp);
+    return Float8GetDatum(tnumber_twavg(temp));
+  }
+  return PointerGetDatum(tpoint_twcentroid(temp));
+}
+
+/**
+ * @brief Return the temporal type of the result of reducing a temporal value
+ * according to time buckets
+ */
+static meosType
+temporal_bucket_temptype(meosType temptype, reductionType reduction)
+{
+  /* The time-weighted average of integers is a float; the minimum and the
+   * maximum are observed values and thus keep the type */
+  return (temptype == T_TINT && reduction == TRESAMPLE_TWAVG) ?
+    T_TFLOAT : temptype;
+}
+
 /**
  * @brief Set the precision of a temporal value according to period buckets.
  * @param[in] seq Temporal value
  * @param[in] duration Size of the time buckets
  * @param[in] torigin Time origin of the buckets
+ * @param[in] reduction Reduction applied to the values of every bucket
  */
-TSequence *
-tsequence_tprecision(const TSequence *seq, const Interval *duration,
-  TimestampTz torigin)
+static TSequence *
+tsequence_tprecision_reduce(const TSequence *seq, const Interval *duration,
+  TimestampTz torigin, reductionType reduction)
 {
   assert(seq); assert(duration);
   assert(seq->temptype == T_TINT || seq->temptype == T_TFLOAT ||
@@ -104,9 +139,9 @@ tsequence_tprecision(const TSequence *seq, const Interval *duration,
   lower = lower_bucket;
   upper = lower_bucket + tunits;
   interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
-  meosType temptype_out = (seq->temptype == T_TINT) ? T_TFLOAT : seq->temptype;
-  /* Determine whether we are computing the twAvg or the twCentroid */
-  bool twavg = tnumber_type(seq->temptype);
+  meosType temptype_out = temporal_bucket_temptype(seq->temptype, reduction);
+  /* Determine whether the reduced value is passed by value or must be freed */
+  bool isnumber = tnumber_type(seq->temptype);
   /* New instants computing the value at the beginning/end of the bucket */
   TInstant *start = NULL, *end = NULL;
   /* Sequence for computing the twAvg/twCentroid of each bucket */
@@ -140,12 +175,11 @@ tsequence_tprecision(const TSequence *seq, const Interval *duration,
       }
       seq1 = tsequence_make((const TInstant **) ininsts, k, true, true, interp,
         NORMALIZE);
-      /* Compute the twAvg/twCentroid for the bucket */
-      value = twavg ? Float8GetDatum(tnumberseq_twavg(seq1)) :
-        PointerGetDatum(tpointseq_twcentroid(seq1));
+      /* Reduce the bucket to a single value */
+      value = temporal_bucket_reduce((Temporal *) seq1, reduction);
       outinsts[l++] = tinstant_make(value, temptype_out, lower);
       pfree(seq1);
-      if (! twavg)
+      if (! isnumber)
         pfree(DatumGetPointer(value));
       /* Free the instant at the beginning of the bucket if it was generated */
       if (start)
@@ -177,10 +211,10 @@ tsequence_tprecision(const TSequence *seq, const Interval *duration,
   {
     seq1 = tsequence_make((const TInstant **) ininsts, k, true, true, interp,
       NORMALIZE);
-    value = twavg ? Float8GetDatum(tnumberseq_twavg(seq1)) :
-      PointerGetDatum(tpointseq_twcentroid(seq1));
+    value = temporal_bucket_reduce((Temporal *) seq1, reduction);
     outinsts[l++] = tinstant_make(value, temptype_out, lower);
-    if (! twavg)
+    pfree(seq1);
+    if (! isnumber)
       pfree(DatumGetPointer(value));
   }
   /* The lower and upper bounds are both true since the tprecision operation 
@@ -195,13 +229,27 @@ tsequence_tprecision(const TSequence *seq, const Interval *duration,
 
 /**
  * @brief Set the precision of a temporal value according to period buckets.
- * @param[in] ss Temporal value
+ * @param[in] seq Temporal value
  * @param[in] duration Size of the time buckets
  * @param[in] torigin Time origin of the buckets
  */
-TSequenceSet *
-tsequenceset_tprecision(const TSequenceSet *ss, const Interval *duration,
+TSequence *
+tsequence_tprecision(const TSequence *seq, const Interval *duration,
   TimestampTz torigin)
+{
+  return tsequence_tprecision_reduce(seq, duration, torigin, TRESAMPLE_TWAVG);
+}
+
+/**
+ * @brief Set the precision of a temporal value according to period buckets.
+ * @param[in] ss Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[in] reduction Reduction applied to the values of every bucket
+ */
+static TSequenceSet *
+tsequenceset_tprecision_reduce(const TSequenceSet *ss, const Interval *duration,
+  TimestampTz torigin, reductionType reduction)
 {
   assert(ss); assert(duration);
   assert(ss->temptype == T_TINT || ss->temptype == T_TFLOAT ||
@@ -222,9 +270,9 @@ tsequenceset_tprecision(const TSequenceSet *ss, const Interval *duration,
   lower = lower_bucket;
   upper = lower_bucket + tunits;
   interpType interp = MEOS_FLAGS_GET_INTERP(ss->flags);
-  meosType temptype_out = (ss->temptype == T_TINT) ? T_TFLOAT : ss->temptype;
-  /* Determine whether we are computing the twAvg or the twCentroid */
-  bool twavg = tnumber_type(ss->temptype);
+  meosType temptype_out = temporal_bucket_temptype(ss->temptype, reduction);
+  /* Determine whether the reduced value is passed by value or must be freed */
+  bool isnumber = tnumber_type(ss->temptype);
   int ninsts = 0;
   int nseqs = 0;
   /* Loop for each bucket */
@@ -236,12 +284,13 @@ tsequenceset_tprecision(const TSequenceSet *ss, const Interval *duration,
     TSequenceSet *proj = tsequenceset_restrict_period(ss, &p, REST_AT);
     if (proj)
     {
-      Datum value = twavg ? Float8GetDatum(tnumber_twavg((Temporal *) proj)) :
-        PointerGetDatum(tpoint_twcentroid((Temporal *) proj));
+      Datum value = temporal_bucket_reduce((Temporal *) proj, reduction);
       /* We keep only the first instant since the tprecision operation amounts
        * to a granularity change */
       instants[ninsts++] = tinstant_make(value, temptype_out, lower);
       pfree(proj);
+      if (! isnumber)
+        pfree(DatumGetPointer(value));
     }
     else
     {
@@ -273,6 +322,20 @@ tsequenceset_tprecision(const TSequenceSet *ss, const Interval *duration,
   return tsequenceset_make_free(sequences, nseqs, NORMALIZE);
 }
 
+/**
+ * @brief Set the precision of a temporal value according to period buckets.
+ * @param[in] ss Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ */
+TSequenceSet *
+tsequenceset_tprecision(const TSequenceSet *ss, const Interval *duration,
+  TimestampTz torigin)
+{
+  return tsequenceset_tprecision_reduce(ss, duration, torigin,
+    TRESAMPLE_TWAVG);
+}
+
 /**
  * @ingroup libmeos_temporal_analytics_reduction
  * @brief Set the precision of a temporal value according to period buckets.
@@ -284,7 +347,7 @@ temporal_tprecision(const Temporal *temp, const Interval *duration,
 {
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) duration) ||
-      ! ensure_valid_duration(duration))
+      ! interval_units_checked(duration))
     return NULL;
 
   Temporal *result;
@@ -301,6 +364,118 @@ temporal_tprecision(const Temporal *temp, const Interval *duration,
   return result;
 }
 
+/*****************************************************************************
+ * Temporal resampling with per-bucket reduction
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_analytics_reduction
+ * @brief Resample a temporal value according to period buckets, reducing all
+ * the values of a bucket to a single one.
+ *
+ * Resampling generalizes #temporal_tprecision, which reduces every bucket to
+ * its time-weighted average (respectively, centroid for temporal points).
+ * Unlike #temporal_tsample, which keeps only the value at each sample tick,
+ * the information between the ticks contributes to the result. Temporal
+ * points have no meaningful value ordering, so the reduction for them is
+ * always the time-weighted centroid.
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[in] reduction Reduction applied to the values of every bucket
+ * @return On error return NULL
+ */
+Temporal *
+temporal_tresample(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin, reductionType reduction)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_not_null((void *) duration) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+  if (temp->temptype != T_TINT && temp->temptype != T_TFLOAT &&
+      ! tgeo_type(temp->temptype))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The temporal value must be of a number or a point type");
+    return NULL;
+  }
+
+  Temporal *result;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    result = (Temporal *) tinstant_tprecision((TInstant *) temp, duration,
+      torigin);
+  else if (temp->subtype == TSEQUENCE)
+    result = (Temporal *) tsequence_tprecision_reduce((TSequence *) temp,
+      duration, torigin, reduction);
+  else /* temp->subtype == TSEQUENCESET */
+    result = (Temporal *) tsequenceset_tprecision_reduce((TSequenceSet *) temp,
+      duration, torigin, reduction);
+  return result;
+}
+
+#if MEOS
+/**
+ * @brief Task resampling one element of an array of temporal values, see
+ * #temporalarr_tresample
+ */
+typedef struct TemporalArrResampleTask
+{
+  const Temporal **temparr;   /**< Array of temporal values */
+  const Interval *duration;   /**< Size of the time buckets */
+  TimestampTz torigin;        /**< Time origin of the buckets */
+  reductionType reduction;    /**< Reduction applied to every bucket */
+  Temporal **result;          /**< Array of resampled values */
+} TemporalArrResampleTask;
+
+/**
+ * @brief Resample one element of an array of temporal values
+ */
+static void
+temporalarr_tresample_task(void *arg, int idx)
+{
+  TemporalArrResampleTask *task = (TemporalArrResampleTask *) arg;
+  task->result[idx] = temporal_tresample(task->temparr[idx], task->duration,
+    task->torigin, task->reduction);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_reduction
+ * @brief Resample an array of temporal values according to period buckets,
+ * distributing the elements over the thread pool when it is active.
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[in] reduction Reduction applied to the values of every bucket
+ * @return On error return NULL
+ * @see temporal_tresample
+ */
+Temporal **
+temporalarr_tresample(const Temporal **temparr, int count,
+  const Interval *duration, TimestampTz torigin, reductionType reduction)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) ||
+      ! ensure_not_null((void *) duration) || ! ensure_positive(count) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+
+  Temporal **result = palloc(sizeof(Temporal *) * count);
+  TemporalArrResampleTask task;
+  task.temparr = temparr;
+  task.duration = duration;
+  task.torigin = torigin;
+  task.reduction = reduction;
+  task.result = result;
+  meos_pool_parallel_for(count, &temporalarr_tresample_task, &task);
+  return result;
+}
+#endif /* MEOS */
+
 /*****************************************************************************
  * Temporal sample
  *****************************************************************************/
@@ -480,7 +655,7 @@ temporal_tsample(const Temporal *temp, const Interval *duration,
 {
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) duration) ||
-      ! ensure_valid_duration(duration))
+      ! interval_units_checked(duration))
     return NULL;
 
   Temporal *result;
@@ -497,6 +672,242 @@ temporal_tsample(const Temporal *temp, const Interval *duration,
   return result;
 }
 
+/*****************************************************************************
+ * Reduced-precision computation mode
+ *****************************************************************************/
+
+/**
+ * @brief Global variable that enables the reduced-precision computation mode
+ */
+static bool MEOS_REDUCED_PRECISION = false;
+
+/**
+ * @ingroup libmeos_temporal_analytics_similarity
+ * @brief Enable or disable the reduced-precision computation mode.
+ *
+ * When enabled, the quadratic similarity kernels (Frechet, dynamic time
+ * warping, and Hausdorff distances) extract the values of the input
+ * instants into compact single-precision buffers and run the distance
+ * recurrences in single precision, which halves the memory traffic of the
+ * kernels and doubles the number of lanes available to the compiler for
+ * vectorization. Doubles are used at the boundaries: the inputs and the
+ * returned distance keep their double-precision interface. Geodetic points
+ * always use the double-precision path since their distance is not a
+ * coordinate formula.
+ */
+void
+meos_reduced_precision_enable(bool enable)
+{
+  MEOS_REDUCED_PRECISION = enable;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_similarity
+ * @brief Return true if the reduced-precision computation mode is enabled
+ */
+bool
+meos_reduced_precision_enabled(void)
+{
+  return MEOS_REDUCED_PRECISION;
+}
+
+/**
+ * @brief Extract the values of an array of temporal number or point
+ * instants into a compact single-precision buffer
+ * @param[in] instants Array of temporal instants
+ * @param[in] count Number of instants in the array
+ * @param[out] dim Number of values per instant: 1 for temporal numbers,
+ * 2 or 3 for temporal points
+ * @return On unsupported types, e.g., geodetic points, return @p NULL so
+ * that the caller falls back to the double-precision path
+ */
+static float *
+tinstarr_to_float(const TInstant **instants, int count, int *dim)
+{
+  float *values;
+  if (tnumber_type(instants[0]->temptype))
+  {
+    *dim = 1;
+    values = palloc(sizeof(float) * count);
+    for (int i = 0; i < count; i++)
+      values[i] = (float) tnumberinst_double(instants[i]);
+  }
+  else if (tgeo_type(instants[0]->temptype) &&
+    ! MEOS_FLAGS_GET_GEODETIC(instants[0]->flags))
+  {
+    bool hasz = MEOS_FLAGS_GET_Z(instants[0]->flags);
+    *dim = hasz ? 3 : 2;
+    values = palloc(sizeof(float) * count * *dim);
+    for (int i = 0; i < count; i++)
+    {
+      if (hasz)
+      {
+        const POINT3DZ *p = DATUM_POINT3DZ_P(tinstant_value(instants[i]));
+        values[i * 3] = (float) p->x;
+        values[i * 3 + 1] = (float) p->y;
+        values[i * 3 + 2] = (float) p->z;
+      }
+      else
+      {
+        const POINT2D *p = DATUM_POINT2D_P(tinstant_value(instants[i]));
+        values[i * 2] = (float) p->x;
+        values[i * 2 + 1] = (float) p->y;
+      }
+    }
+  }
+  else
+    return NULL;
+  return values;
+}
+
+/**
+ * @brief Return the single-precision distance between two values of a
+ * compact buffer
+ */
+static inline float
+flt_distance(const float *v1, const float *v2, int dim)
+{
+  if (dim == 1)
+    return fabsf(v1[0] - v2[0]);
+  float dx = v1[0] - v2[0];
+  float dy = v1[1] - v2[1];
+  if (dim == 2)
+    return sqrtf(dx * dx + dy * dy);
+  float dz = v1[2] - v2[2];
+  return sqrtf(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * @brief Single-precision version of the linear space computation of the
+ * similarity distance (see #tinstarr_similarity1)
+ * @param[in] values1,values2 Compact buffers of instant values
+ * @param[in] count1,count2 Number of instants in the buffers
+ * @param[in] dim Number of values per instant
+ * @param[in] simfunc Similarity function, i.e., Frechet or DTW
+ */
+static double
+tinstarr_similarity_flt(const float *values1, int count1,
+  const float *values2, int count2, int dim, SimFunc simfunc)
+{
+  /* Two rows of the distance matrix in single precision */
+  float *dist = palloc(sizeof(float) * 2 * count2);
+  for (int i = 0; i < count1; i++)
+  {
+    float *curr = &dist[i % 2 * count2];
+    float *prev = &dist[(i - 1) % 2 * count2];
+    for (int j = 0; j < count2; j++)
+    {
+      float d = flt_distance(&values1[i * dim], &values2[j * dim], dim);
+      if (i > 0 && j > 0)
+      {
+        float m = Min(prev[j - 1], Min(prev[j], curr[j - 1]));
+        curr[j] = (simfunc == FRECHET) ? Max(d, m) : d + m;
+      }
+      else if (i > 0 && j == 0)
+        curr[0] = (simfunc == FRECHET) ? Max(d, prev[0]) : d + prev[0];
+      else if (i == 0 && j > 0)
+        curr[j] = (simfunc == FRECHET) ? Max(d, curr[j - 1]) : d + curr[j - 1];
+      else /* i == 0 && j == 0 */
+        curr[0] = d;
+    }
+  }
+  double result = (double) dist[(count1 - 1) % 2 * count2 + count2 - 1];
+  pfree(dist);
+  return result;
+}
+
+/**
+ * @brief Single-precision version of the banded dynamic time warping
+ * distance (see #tinstarr_dyntimewarp_banded)
+ * @param[in] values1,values2 Compact buffers of instant values
+ * @param[in] count1,count2 Number of instants in the buffers
+ * @param[in] dim Number of values per instant
+ * @param[in] radius Half width of the warping band, in instants
+ */
+static double
+tinstarr_dyntimewarp_banded_flt(const float *values1, int count1,
+  const float *values2, int count2, int dim, int radius)
+{
+  float *dist = palloc(sizeof(float) * 2 * count2);
+  for (int i = 0; i < 2 * count2; i++)
+    dist[i] = FLT_MAX;
+  for (int i = 0; i < count1; i++)
+  {
+    float *curr = &dist[i % 2 * count2];
+    float *prev = &dist[(i - 1) % 2 * count2];
+    int center = (count1 == 1) ? 0 :
+      (int) ((int64) i * (count2 - 1) / (count1 - 1));
+    int jlo = Max(0, center - radius);
+    int jhi = Min(count2 - 1, center + radius);
+    for (int j = 0; j < count2; j++)
+      curr[j] = FLT_MAX;
+    for (int j = jlo; j <= jhi; j++)
+    {
+      float d = flt_distance(&values1[i * dim], &values2[j * dim], dim);
+      if (i == 0 && j == 0)
+        curr[j] = d;
+      else
+      {
+        float m = FLT_MAX;
+        if (i > 0 && j > 0 && prev[j - 1] < m)
+          m = prev[j - 1];
+        if (i > 0 && prev[j] < m)
+          m = prev[j];
+        if (j > 0 && curr[j - 1] < m)
+          m = curr[j - 1];
+        curr[j] = (m == FLT_MAX) ? FLT_MAX : d + m;
+      }
+    }
+  }
+  double result = dist[(count1 - 1) % 2 * count2 + count2 - 1];
+  pfree(dist);
+  return (result == (double) FLT_MAX) ? DBL_MAX : result;
+}
+
+/**
+ * @brief Single-precision version of the discrete Hausdorff distance
+ * (see #tinstarr_hausdorff_distance)
+ * @param[in] values1,values2 Compact buffers of instant values
+ * @param[in] count1,count2 Number of instants in the buffers
+ * @param[in] dim Number of values per instant
+ */
+static double
+tinstarr_hausdorff_distance_flt(const float *values1, int count1,
+  const float *values2, int count2, int dim)
+{
+  float cmax = 0.0f, cmin, d;
+  int i, j;
+  for (i = 0; i < count1; i++)
+  {
+    cmin = FLT_MAX;
+    for (j = 0; j < count2; j++)
+    {
+      d = flt_distance(&values1[i * dim], &values2[j * dim], dim);
+      if (d < cmin)
+        cmin = d;
+      if (cmin < cmax)
+        break;
+    }
+    if (cmax < cmin && cmin < FLT_MAX)
+      cmax = cmin;
+  }
+  for (j = 0; j < count2; j++)
+  {
+    cmin = FLT_MAX;
+    for (i = 0; i < count1; i++)
+    {
+      d = flt_distance(&values1[i * dim], &values2[j * dim], dim);
+      if (d < cmin)
+        cmin = d;
+      if (cmin < cmax)
+        break;
+    }
+    if (cmax < cmin && cmin < FLT_MAX)
+      cmax = cmin;
+  }
+  return (double) cmax;
+}
+
 /*****************************************************************************
  * Linear space computation of the similarity distance
  *****************************************************************************/
@@ -516,6 +927,9 @@ tinstarr_similarity1(double *dist, const TInstant **instants1, int count1,
   datum_func2 func = pt_distance_fn(instants1[0]->flags);
   for (int i = 0; i < count1; i++)
   {
+    if (meos_interrupt_check())
+      return -1.0;
+    meos_progress_report((double) i / count1);
     for (int j = 0; j < count2; j++)
     {
       const TInstant *inst1 = instants1[i];
@@ -578,6 +992,20 @@ static double
 tinstarr_similarity(const TInstant **instants1, int count1,
   const TInstant **instants2, int count2, SimFunc simfunc)
 {
+  /* Use the reduced-precision mode when enabled and the type supports it */
+  if (MEOS_REDUCED_PRECISION)
+  {
+    int dim;
+    float *values1 = tinstarr_to_float(instants1, count1, &dim);
+    if (values1)
+    {
+      float *values2 = tinstarr_to_float(instants2, count2, &dim);
+      double result = tinstarr_similarity_flt(values1, count1, values2,
+        count2, dim, simfunc);
+      pfree(values1); pfree(values2);
+      return result;
+    }
+  }
   /* Allocate memory for two rows of the distance matrix */
   double *dist = palloc(sizeof(double) * 2 * count2);
   /* Initialise it with -1.0 */
@@ -591,6 +1019,81 @@ tinstarr_similarity(const TInstant **instants1, int count1,
   return result;
 }
 
+/**
+ * @brief Linear space computation of the Dynamic Time Warp distance between
+ * two temporal values restricted to a Sakoe-Chiba band
+ *
+ * Only the cells of the count1 x count2 matrix within @p radius of the
+ * diagonal are computed, so the cost is O(count1 * radius) time and two
+ * rows of memory. Cells outside the band are treated as unreachable.
+ * @param[in] instants1,instants2 Arrays of temporal instants
+ * @param[in] count1,count2 Number of instants in the arrays
+ * @param[in] radius Half width of the warping band, in instants
+ */
+static double
+tinstarr_dyntimewarp_banded(const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2, int radius)
+{
+  /* Use the reduced-precision mode when enabled and the type supports it */
+  if (MEOS_REDUCED_PRECISION)
+  {
+    int dim;
+    float *values1 = tinstarr_to_float(instants1, count1, &dim);
+    if (values1)
+    {
+      float *values2 = tinstarr_to_float(instants2, count2, &dim);
+      double result = tinstarr_dyntimewarp_banded_flt(values1, count1,
+        values2, count2, dim, radius);
+      pfree(values1); pfree(values2);
+      return result;
+    }
+  }
+  datum_func2 func = pt_distance_fn(instants1[0]->flags);
+  /* Two rows of the distance matrix, cells outside the band keep DBL_MAX */
+  double *dist = palloc(sizeof(double) * 2 * count2);
+  for (int i = 0; i < 2 * count2; i++)
+    dist[i] = DBL_MAX;
+  for (int i = 0; i < count1; i++)
+  {
+    if (meos_interrupt_check())
+    {
+      pfree(dist);
+      return -1.0;
+    }
+    meos_progress_report((double) i / count1);
+    double *curr = &dist[i % 2 * count2];
+    double *prev = &dist[(i - 1) % 2 * count2];
+    /* Center the band on the diagonal to support unequal lengths */
+    int center = (count1 == 1) ? 0 :
+      (int) ((int64) i * (count2 - 1) / (count1 - 1));
+    int jlo = Max(0, center - radius);
+    int jhi = Min(count2 - 1, center + radius);
+    /* Reset the row so cells of the previous band do not leak through */
+    for (int j = 0; j < count2; j++)
+      curr[j] = DBL_MAX;
+    for (int j = jlo; j <= jhi; j++)
+    {
+      double d = tinstant_distance(instants1[i], instants2[j], func);
+      if (i == 0 && j == 0)
+        curr[j] = d;
+      else
+      {
+        double m = DBL_MAX;
+        if (i > 0 && j > 0 && prev[j - 1] < m)
+          m = prev[j - 1];
+        if (i > 0 && prev[j] < m)
+          m = prev[j];
+        if (j > 0 && curr[j - 1] < m)
+          m = curr[j - 1];
+        curr[j] = (m == DBL_MAX) ? DBL_MAX : d + m;
+      }
+    }
+  }
+  double result = dist[(count1 - 1) % 2 * count2 + count2 - 1];
+  pfree(dist);
+  return result;
+}
+
 /**
  * @brief Compute the similarity distance between two temporal values.
  * @param[in] temp1,temp2 Temporal values
@@ -648,15 +1151,368 @@ temporal_dyntimewarp_distance(const Temporal *temp1, const Temporal *temp2)
     return DBL_MAX;
   return temporal_similarity(temp1, temp2, DYNTIMEWARP);
 }
-#endif
-
-/*****************************************************************************
- * Iterative implementation of the similarity distance with a full matrix
- *****************************************************************************/
 
-#ifdef DEBUG_BUILD
 /**
- * @brief Print a distance matrix in tabular form
+ * @ingroup libmeos_temporal_analytics_similarity
+ * @brief Compute the Dynamic Time Warp distance between two temporal values
+ * restricted to a Sakoe-Chiba warping band.
+ *
+ * Alignments may only deviate from the diagonal by at most @p radius
+ * instants, which bounds the computation to O(n * radius) time and linear
+ * memory. The result equals #temporal_dyntimewarp_distance when the band
+ * covers the whole matrix and is an upper bound of it otherwise.
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] radius Half width of the warping band, in instants
+ * @result On error return DBL_MAX
+ */
+double
+temporal_dyntimewarp_distance_banded(const Temporal *temp1,
+  const Temporal *temp2, int radius)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_same_temporal_type(temp1, temp2) || ! ensure_positive(radius))
+    return DBL_MAX;
+
+  int count1, count2;
+  const TInstant **instants1 = temporal_instants(temp1, &count1);
+  const TInstant **instants2 = temporal_instants(temp2, &count2);
+  double result = count1 > count2 ?
+    tinstarr_dyntimewarp_banded(instants1, count1, instants2, count2,
+      radius) :
+    tinstarr_dyntimewarp_banded(instants2, count2, instants1, count1,
+      radius);
+  /* Free memory */
+  pfree(instants1); pfree(instants2);
+  return result;
+}
+
+/*****************************************************************************
+ * Similarity matrix
+ *****************************************************************************/
+
+/**
+ * Structure for the task computing one cell of a similarity matrix
+ */
+typedef struct
+{
+  const TInstant ***instants; /**< Decoded instant arrays, one per value */
+  int *counts;                /**< Number of instants of each value */
+  int *pairi;                 /**< First element of each pair */
+  int *pairj;                 /**< Second element of each pair */
+  SimFunc simfunc;            /**< Similarity function, i.e., Frechet or DTW */
+  int count;                  /**< Number of temporal values */
+  double *result;             /**< Similarity matrix, row-major order */
+} SimilarityMatrixTask;
+
+/**
+ * @brief Compute one pair of a similarity matrix
+ */
+static void
+temporal_similarity_matrix_task(void *arg, int idx)
+{
+  SimilarityMatrixTask *task = (SimilarityMatrixTask *) arg;
+  int i = task->pairi[idx];
+  int j = task->pairj[idx];
+  double d = task->counts[i] > task->counts[j] ?
+    tinstarr_similarity(task->instants[i], task->counts[i],
+      task->instants[j], task->counts[j], task->simfunc) :
+    tinstarr_similarity(task->instants[j], task->counts[j],
+      task->instants[i], task->counts[i], task->simfunc);
+  task->result[i * task->count + j] = d;
+  task->result[j * task->count + i] = d;
+}
+
+/**
+ * @brief Compute the similarity distance between all pairs of values in an
+ * array of temporal values
+ *
+ * Computing an all-pairs matrix through the pairwise functions decodes
+ * every temporal value into its instant array once per pair, that is,
+ * count - 1 times. This function decodes each value exactly once, shares
+ * the decoded arrays across all pairs, and distributes the pairs over the
+ * thread pool when one is active since the cells of the matrix are
+ * independent. Only the upper triangle is computed and mirrored.
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[in] simfunc Similarity function, i.e., Frechet or DTW
+ * @return Similarity matrix of count x count doubles in row-major order
+ * with zeroes on the diagonal
+ */
+double *
+temporal_similarity_matrix(const Temporal **temparr, int count,
+  SimFunc simfunc)
+{
+  assert(temparr); assert(count > 0);
+  /* Decode each temporal value into its instant array exactly once */
+  const TInstant ***instants = palloc(sizeof(TInstant **) * count);
+  int *counts = palloc(sizeof(int) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = temporal_instants(temparr[i], &counts[i]);
+  double *result = palloc(sizeof(double) * count * count);
+  for (int i = 0; i < count; i++)
+    result[i * count + i] = 0.0;
+  /* Enumerate the pairs of the upper triangle */
+  int npairs = count * (count - 1) / 2;
+  if (npairs > 0)
+  {
+    int *pairi = palloc(sizeof(int) * npairs);
+    int *pairj = palloc(sizeof(int) * npairs);
+    int k = 0;
+    for (int i = 0; i < count; i++)
+      for (int j = i + 1; j < count; j++)
+      {
+        pairi[k] = i;
+        pairj[k++] = j;
+      }
+    SimilarityMatrixTask task;
+    task.instants = instants;
+    task.counts = counts;
+    task.pairi = pairi;
+    task.pairj = pairj;
+    task.simfunc = simfunc;
+    task.count = count;
+    task.result = result;
+    meos_pool_parallel_for(npairs, &temporal_similarity_matrix_task, &task);
+    pfree(pairi); pfree(pairj);
+  }
+  /* Free memory */
+  for (int i = 0; i < count; i++)
+    pfree(instants[i]);
+  pfree(instants); pfree(counts);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_similarity
+ * @brief Compute the Frechet distance between all pairs of values in an
+ * array of temporal values.
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @return Symmetric matrix of count x count doubles in row-major order.
+ * On error return NULL
+ * @sqlfunc frechetDistance()
+ */
+double *
+temporal_frechet_distance_matrix(const Temporal **temparr, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  for (int i = 1; i < count; i++)
+    if (! ensure_same_temporal_type(temparr[0], temparr[i]))
+      return NULL;
+  return temporal_similarity_matrix(temparr, count, FRECHET);
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_similarity
+ * @brief Compute the Dynamic Time Warp distance between all pairs of values
+ * in an array of temporal values.
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @return Symmetric matrix of count x count doubles in row-major order.
+ * On error return NULL
+ * @sqlfunc dynamicTimeWarp()
+ */
+double *
+temporal_dyntimewarp_distance_matrix(const Temporal **temparr, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  for (int i = 1; i < count; i++)
+    if (! ensure_same_temporal_type(temparr[0], temparr[i]))
+      return NULL;
+  return temporal_similarity_matrix(temparr, count, DYNTIMEWARP);
+}
+
+/*****************************************************************************
+ * Piecewise aggregate approximation (PAA) synopsis for similarity search
+ *
+ * The synopsis keeps for every time bucket the minimum and the maximum of
+ * each value dimension of the instants falling into the bucket. Comparing
+ * two synopses yields a cheap lower bound of the similarity distances above,
+ * which allows a similarity search to prune most candidate pairs without
+ * touching the full temporal values.
+ *****************************************************************************/
+
+/* Total size in bytes of a synopsis */
+#define SYNOPSIS_SIZE(dims, count) \
+  (sizeof(TSynopsis) + sizeof(double) * (2 * (dims) * (count) - 1))
+/* Minimum/maximum of dimension d of the i-th bucket of a synopsis */
+#define SYNOPSIS_LO(syn, i, d) \
+  ((syn)->values[2 * ((syn)->dims * (i) + (d))])
+#define SYNOPSIS_HI(syn, i, d) \
+  ((syn)->values[2 * ((syn)->dims * (i) + (d)) + 1])
+
+/**
+ * @ingroup libmeos_temporal_analytics_similarity
+ * @brief Compute a piecewise aggregate approximation synopsis of a temporal
+ * value.
+ *
+ * The time span of the value is divided into @p count buckets of equal
+ * duration and every bucket stores the minimum and maximum of each value
+ * dimension of the instants falling into it. Buckets without instants are
+ * left empty. The synopsis of a temporal number has one dimension, the one
+ * of a temporal point has two or three.
+ * @param[in] temp Temporal value
+ * @param[in] count Number of time buckets
+ * @return On error return NULL
+ */
+TSynopsis *
+temporal_synopsis(const Temporal *temp, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_positive(count) ||
+      ! ensure_tnumber_tgeo_type(temp->temptype))
+    return NULL;
+
+  int ninsts;
+  const TInstant **instants = temporal_instants(temp, &ninsts);
+  int dims = tnumber_type(temp->temptype) ? 1 :
+    (MEOS_FLAGS_GET_Z(temp->flags) ? 3 : 2);
+  TSynopsis *result = palloc(SYNOPSIS_SIZE(dims, count));
+  result->count = count;
+  result->dims = (int16) dims;
+  result->padding = 0;
+  temporal_set_period(temp, &result->period);
+  /* Mark all buckets as empty */
+  for (int i = 0; i < count; i++)
+  {
+    for (int d = 0; d < dims; d++)
+    {
+      SYNOPSIS_LO(result, i, d) = DBL_MAX;
+      SYNOPSIS_HI(result, i, d) = -DBL_MAX;
+    }
+  }
+  TimestampTz lower = DatumGetTimestampTz(result->period.lower);
+  TimestampTz upper = DatumGetTimestampTz(result->period.upper);
+  meosType basetype = temptype_basetype(temp->temptype);
+  for (int i = 0; i < ninsts; i++)
+  {
+    const TInstant *inst = instants[i];
+    /* All instants fall into the single bucket when the duration is zero */
+    int bucket = (upper > lower) ?
+      (int) ((double) (inst->t - lower) * count / (upper - lower)) : 0;
+    if (bucket >= count)
+      bucket = count - 1;
+    double coords[3];
+    if (dims == 1)
+      coords[0] = datum_double(tinstant_value(inst), basetype);
+    else if (dims == 2)
+    {
+      const POINT2D *pt = DATUM_POINT2D_P(tinstant_value(inst));
+      coords[0] = pt->x; coords[1] = pt->y;
+    }
+    else /* dims == 3 */
+    {
+      const POINT3DZ *pt = DATUM_POINT3DZ_P(tinstant_value(inst));
+      coords[0] = pt->x; coords[1] = pt->y; coords[2] = pt->z;
+    }
+    for (int d = 0; d < dims; d++)
+    {
+      if (coords[d] < SYNOPSIS_LO(result, bucket, d))
+        SYNOPSIS_LO(result, bucket, d) = coords[d];
+      if (coords[d] > SYNOPSIS_HI(result, bucket, d))
+        SYNOPSIS_HI(result, bucket, d) = coords[d];
+    }
+  }
+  pfree(instants);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_similarity
+ * @brief Compute a lower bound of the similarity distance between two
+ * temporal values from their synopses, à la LB_Keogh.
+ *
+ * Every non-empty bucket of the first synopsis is compared with the envelope
+ * of the second one widened over the buckets within @p radius positions,
+ * and the largest separation between the envelopes is returned. Since any
+ * alignment deviating from the diagonal by at most @p radius buckets must
+ * match some pair of instants at least that far apart, the result is a
+ * lower bound of #temporal_dyntimewarp_distance_banded with a band of the
+ * corresponding width. When @p radius covers all buckets the bound holds
+ * for any alignment and thus also for #temporal_frechet_distance and
+ * #temporal_dyntimewarp_distance.
+ * @param[in] syn1,syn2 Synopses, which must have the same number of buckets
+ * and dimensions
+ * @param[in] radius Half width of the warping band, in buckets
+ * @return On error return -1.0, which never prunes a candidate pair
+ */
+double
+synopsis_lower_bound_distance(const TSynopsis *syn1, const TSynopsis *syn2,
+  int radius)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) syn1) || ! ensure_not_null((void *) syn2))
+    return -1.0;
+  if (syn1->count != syn2->count || syn1->dims != syn2->dims)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The synopses must have the same number of buckets and dimensions");
+    return -1.0;
+  }
+  if (radius < 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The radius must be non-negative");
+    return -1.0;
+  }
+
+  int count = syn1->count, dims = syn1->dims;
+  double result = 0.0;
+  for (int i = 0; i < count; i++)
+  {
+    /* Skip the buckets where the first synopsis has no instants */
+    if (SYNOPSIS_LO(syn1, i, 0) > SYNOPSIS_HI(syn1, i, 0))
+      continue;
+    /* Widen the envelope of the second synopsis over the warping window */
+    double lo2[3], hi2[3];
+    for (int d = 0; d < dims; d++)
+    {
+      lo2[d] = DBL_MAX;
+      hi2[d] = -DBL_MAX;
+    }
+    bool found = false;
+    int jmin = Max(i - radius, 0), jmax = Min(i + radius, count - 1);
+    for (int j = jmin; j <= jmax; j++)
+    {
+      if (SYNOPSIS_LO(syn2, j, 0) > SYNOPSIS_HI(syn2, j, 0))
+        continue;
+      found = true;
+      for (int d = 0; d < dims; d++)
+      {
+        lo2[d] = Min(lo2[d], SYNOPSIS_LO(syn2, j, d));
+        hi2[d] = Max(hi2[d], SYNOPSIS_HI(syn2, j, d));
+      }
+    }
+    /* A narrow radius may leave only empty buckets in the window */
+    if (! found)
+      continue;
+    double dist2 = 0.0;
+    for (int d = 0; d < dims; d++)
+    {
+      double gap = Max(0.0,
+        Max(SYNOPSIS_LO(syn1, i, d) - hi2[d], lo2[d] - SYNOPSIS_HI(syn1, i, d)));
+      dist2 += gap * gap;
+    }
+    double dist = sqrt(dist2);
+    if (dist > result)
+      result = dist;
+  }
+  return result;
+}
+#endif
+
+/*****************************************************************************
+ * Iterative implementation of the similarity distance with a full matrix
+ *****************************************************************************/
+
+#ifdef DEBUG_BUILD
+/**
+ * @brief Print a distance matrix in tabular form
  */
 void
 matrix_print(double *dist, int count1, int count2)
@@ -755,14 +1611,18 @@ tinstarr_similarity_path(double *dist, int count1, int count2, int *count)
  * @param[in] count1,count2 Number of instants of the temporal values
  * @param[in] simfunc Similarity function, i.e., Frechet or DTW
  * @param[out] dist Matrix keeping the distances
+ * @return False when the computation was canceled by the interrupt callback
  */
-static void
+static bool
 tinstarr_similarity_matrix1(const TInstant **instants1, int count1,
   const TInstant **instants2, int count2, SimFunc simfunc, double *dist)
 {
   datum_func2 func = pt_distance_fn(instants1[0]->flags);
   for (int i = 0; i < count1; i++)
   {
+    if (meos_interrupt_check())
+      return false;
+    meos_progress_report((double) i / count1);
     for (int j = 0; j < count2; j++)
     {
       const TInstant *inst1 = instants1[i];
@@ -811,7 +1671,7 @@ tinstarr_similarity_matrix1(const TInstant **instants1, int count1,
       }
     }
   }
-  return;
+  return true;
 }
 
 /**
@@ -831,8 +1691,12 @@ tinstarr_similarity_matrix(const TInstant **instants1, int count1,
   for (int i = 0; i < count1 * count2; i++)
     *(dist + i) = -1.0;
   /* Call the iterative computation of the similarity distance */
-  tinstarr_similarity_matrix1(instants1, count1, instants2, count2, simfunc,
-    dist);
+  if (! tinstarr_similarity_matrix1(instants1, count1, instants2, count2,
+        simfunc, dist))
+  {
+    pfree(dist);
+    return NULL;
+  }
   /* Compute the path */
   Match *result = tinstarr_similarity_path(dist, count1, count2, count);
   /* Free memory */
@@ -918,6 +1782,20 @@ static double
 tinstarr_hausdorff_distance(const TInstant **instants1, int count1,
   const TInstant **instants2, int count2)
 {
+  /* Use the reduced-precision mode when enabled and the type supports it */
+  if (MEOS_REDUCED_PRECISION)
+  {
+    int dim;
+    float *values1 = tinstarr_to_float(instants1, count1, &dim);
+    if (values1)
+    {
+      float *values2 = tinstarr_to_float(instants2, count2, &dim);
+      double result = tinstarr_hausdorff_distance_flt(values1, count1,
+        values2, count2, dim);
+      pfree(values1); pfree(values2);
+      return result;
+    }
+  }
   datum_func2 func = pt_distance_fn(instants1[0]->flags);
   const TInstant *inst1, *inst2;
   double cmax = 0.0, cmin;
@@ -925,6 +1803,9 @@ tinstarr_hausdorff_distance(const TInstant **instants1, int count1,
   int i, j;
   for (i = 0; i < count1; i++)
   {
+    if (meos_interrupt_check())
+      return -1.0;
+    meos_progress_report((double) i / (count1 + count2));
     inst1 = instants1[i];
     cmin = DBL_MAX;
     for (j = 0; j < count2; j++)
@@ -941,6 +1822,9 @@ tinstarr_hausdorff_distance(const TInstant **instants1, int count1,
   }
   for (j = 0; j < count2; j++)
   {
+    if (meos_interrupt_check())
+      return -1.0;
+    meos_progress_report((double) (count1 + j) / (count1 + count2));
     cmin = DBL_MAX;
     inst2 = instants2[j];
     for (i = 0; i < count1; i++)
@@ -982,6 +1866,182 @@ temporal_hausdorff_distance(const Temporal *temp1, const Temporal *temp2)
   return result;
 }
 
+/*****************************************************************************/
+
+/**
+ * @brief Bounding box of the values of an instant array, used to prune the
+ * scans of the bounded Hausdorff distance
+ */
+typedef struct
+{
+  int dims;               /**< Number of value dimensions */
+  double lo[3];           /**< Minimum of every dimension */
+  double hi[3];           /**< Maximum of every dimension */
+} HausdorffBox;
+
+/**
+ * @brief Copy into an array the value dimensions of a temporal instant
+ */
+static void
+hausdorff_coords(const TInstant *inst, int dims, double *coords)
+{
+  if (dims == 1)
+    coords[0] = DatumGetFloat8(tinstant_value(inst));
+  else if (dims == 2)
+  {
+    POINT2D point = datum_point2d(tinstant_value(inst));
+    coords[0] = point.x; coords[1] = point.y;
+  }
+  else /* dims == 3 */
+  {
+    POINT3DZ point = datum_point3dz(tinstant_value(inst));
+    coords[0] = point.x; coords[1] = point.y; coords[2] = point.z;
+  }
+  return;
+}
+
+/**
+ * @brief Compute the bounding box of the values of an instant array
+ * @return False when the values do not live in a Euclidean space and thus
+ * the box cannot be used for distance pruning
+ */
+static bool
+hausdorff_box_init(const TInstant **instants, int count, HausdorffBox *box)
+{
+  meosType temptype = instants[0]->temptype;
+  if (tgeo_type(temptype) && ! MEOS_FLAGS_GET_GEODETIC(instants[0]->flags))
+    box->dims = MEOS_FLAGS_GET_Z(instants[0]->flags) ? 3 : 2;
+  else if (temptype == T_TFLOAT)
+    box->dims = 1;
+  else
+    return false;
+  double coords[3];
+  hausdorff_coords(instants[0], box->dims, coords);
+  for (int d = 0; d < box->dims; d++)
+    box->lo[d] = box->hi[d] = coords[d];
+  for (int i = 1; i < count; i++)
+  {
+    hausdorff_coords(instants[i], box->dims, coords);
+    for (int d = 0; d < box->dims; d++)
+    {
+      box->lo[d] = Min(box->lo[d], coords[d]);
+      box->hi[d] = Max(box->hi[d], coords[d]);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Return the distance from the value of an instant to a bounding
+ * box, a lower bound of its distance to every instant inside the box
+ */
+static double
+hausdorff_box_distance(const TInstant *inst, const HausdorffBox *box)
+{
+  double coords[3], sum = 0.0;
+  hausdorff_coords(inst, box->dims, coords);
+  for (int d = 0; d < box->dims; d++)
+  {
+    double delta = 0.0;
+    if (coords[d] < box->lo[d])
+      delta = box->lo[d] - coords[d];
+    else if (coords[d] > box->hi[d])
+      delta = coords[d] - box->hi[d];
+    sum += delta * delta;
+  }
+  return sqrt(sum);
+}
+
+/**
+ * @brief Return true if the directed Hausdorff distance from the first to
+ * the second instant array is at most the bound
+ *
+ * Unlike the full computation, each point only needs ANY point of the other
+ * array within the bound, so the scan stops at the first hit; it starts at
+ * the match of the previous point and moves outward, since consecutive
+ * instants of a trajectory are close and so are their nearest neighbors.
+ * The first point with no hit settles the answer for the whole call.
+ */
+static bool
+tinstarr_hausdorff_directed_within(const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2, double dist, datum_func2 func,
+  const HausdorffBox *box2)
+{
+  int prev = 0;
+  for (int i = 0; i < count1; i++)
+  {
+    if (meos_interrupt_check())
+      return false;
+    const TInstant *inst1 = instants1[i];
+    /* A point farther from the box of the other array than the bound is
+     * farther than the bound from all of its points */
+    if (box2 && hausdorff_box_distance(inst1, box2) > dist)
+      return false;
+    bool found = false;
+    for (int f = prev, b = prev - 1; f < count2 || b >= 0; f++, b--)
+    {
+      if (f < count2 &&
+          tinstant_distance(inst1, instants2[f], func) <= dist)
+      {
+        prev = f;
+        found = true;
+        break;
+      }
+      if (b >= 0 &&
+          tinstant_distance(inst1, instants2[b], func) <= dist)
+      {
+        prev = b;
+        found = true;
+        break;
+      }
+    }
+    if (! found)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_similarity
+ * @brief Return true if the Hausdorff distance between two temporal values
+ * is at most the given bound
+ *
+ * Threshold queries do not need the distance itself: the scan of every
+ * point stops at the first point of the other value within the bound and
+ * the whole computation stops at the first point with none, so typically
+ * only a small fraction of the point pairs of #temporal_hausdorff_distance
+ * is examined.
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] dist Distance bound
+ * @return On error return false
+ */
+bool
+temporal_hausdorff_distance_within(const Temporal *temp1,
+  const Temporal *temp2, double dist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_same_temporal_type(temp1, temp2) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+    return false;
+
+  int count1, count2;
+  const TInstant **instants1 = temporal_instants(temp1, &count1);
+  const TInstant **instants2 = temporal_instants(temp2, &count2);
+  datum_func2 func = pt_distance_fn(instants1[0]->flags);
+  HausdorffBox box1, box2;
+  bool haveboxes = hausdorff_box_init(instants1, count1, &box1) &&
+    hausdorff_box_init(instants2, count2, &box2);
+  bool result =
+    tinstarr_hausdorff_directed_within(instants1, count1, instants2, count2,
+      dist, func, haveboxes ? &box2 : NULL) &&
+    tinstarr_hausdorff_directed_within(instants2, count2, instants1, count1,
+      dist, func, haveboxes ? &box1 : NULL);
+  /* Free memory */
+  pfree(instants1); pfree(instants2);
+  return result;
+}
+
 /***********************************************************************
  * Minimum distance simplification for temporal floats and points.
  * Inspired from Moving Pandas function MinDistanceGeneralizer
@@ -1610,6 +2670,188 @@ tsequence_simplify_dp(const TSequence *seq, double dist, bool syncdist,
   return result;
 }
 
+/**
+ * @brief Interval of a sequence pending subdivision when simplifying with a
+ * target number of instants
+ */
+typedef struct
+{
+  int i1;      /**< Index of the first reference instant */
+  int i2;      /**< Index of the second reference instant */
+  int split;   /**< Index of the interior instant with the maximum distance */
+  double dist; /**< Maximum distance within the interval */
+} DPSplit;
+
+/**
+ * @brief Compute the split of an interval and push it on the binary max-heap
+ * ordered by distance; intervals without interior instants are discarded
+ */
+static void
+tsequence_dp_heap_push(const TSequence *seq, int i1, int i2, bool syncdist,
+  DPSplit *heap, int *size)
+{
+  if (i1 + 1 >= i2)
+    return;
+  DPSplit elem;
+  elem.i1 = i1;
+  elem.i2 = i2;
+  /* For temporal floats only Synchronized Distance is used */
+  if (seq->temptype == T_TFLOAT)
+    tfloatseq_findsplit(seq, i1, i2, &elem.split, &elem.dist);
+  else /* tgeo_type(seq->temptype) */
+    tpointseq_findsplit(seq, i1, i2, syncdist, &elem.split, &elem.dist);
+  /* Sift the new element up */
+  int i = (*size)++;
+  while (i > 0 && heap[(i - 1) / 2].dist < elem.dist)
+  {
+    heap[i] = heap[(i - 1) / 2];
+    i = (i - 1) / 2;
+  }
+  heap[i] = elem;
+  return;
+}
+
+/**
+ * @brief Pop the interval with the maximum distance from the binary max-heap
+ */
+static DPSplit
+tsequence_dp_heap_pop(DPSplit *heap, int *size)
+{
+  DPSplit result = heap[0];
+  DPSplit elem = heap[--(*size)];
+  /* Sift the last element down from the root */
+  int i = 0;
+  while (true)
+  {
+    int child = 2 * i + 1;
+    if (child >= *size)
+      break;
+    if (child + 1 < *size && heap[child + 1].dist > heap[child].dist)
+      child++;
+    if (heap[child].dist <= elem.dist)
+      break;
+    heap[i] = heap[child];
+    i = child;
+  }
+  heap[i] = elem;
+  return result;
+}
+
+/**
+ * @brief Simplify the temporal sequence float/point to a target number of
+ * instants with a top-down greedy refinement.
+ *
+ * The instants are added in decreasing order of their Douglas-Peucker
+ * distance using a priority queue of the pending intervals, so the subset
+ * returned for a budget of n instants is the one the Douglas-Peucker
+ * algorithm would keep for the largest distance threshold yielding at most
+ * n instants, without searching for that threshold.
+ * @param[in] seq Temporal value
+ * @param[in] count Maximum number of instants in the result
+ * @param[in] syncdist True when computing the Synchronized Euclidean
+ * Distance (SED), false when computing the spatial only distance.
+ */
+static TSequence *
+tsequence_simplify_count(const TSequence *seq, int count, bool syncdist)
+{
+  assert(MEOS_FLAGS_LINEAR_INTERP(seq->flags));
+  assert(seq->temptype == T_TFLOAT || tgeo_type(seq->temptype));
+  assert(count >= 2);
+  if (seq->count <= count)
+    return tsequence_copy(seq);
+
+  /* The heap holds at most one interval per instant kept */
+  DPSplit *heap = palloc(sizeof(DPSplit) * count);
+  bool *keep = palloc0(sizeof(bool) * seq->count);
+  int size = 0, kept = 2;
+  keep[0] = keep[seq->count - 1] = true;
+  tsequence_dp_heap_push(seq, 0, seq->count - 1, syncdist, heap, &size);
+  while (kept < count && size > 0)
+  {
+    DPSplit top = tsequence_dp_heap_pop(heap, &size);
+    keep[top.split] = true;
+    kept++;
+    tsequence_dp_heap_push(seq, top.i1, top.split, syncdist, heap, &size);
+    tsequence_dp_heap_push(seq, top.split, top.i2, syncdist, heap, &size);
+  }
+
+  /* Create a new temporal sequence with the instants kept */
+  const TInstant **instants = palloc(sizeof(TInstant *) * kept);
+  int ninsts = 0;
+  for (int i = 0; i < seq->count; i++)
+    if (keep[i])
+      instants[ninsts++] = TSEQUENCE_INST_N(seq, i);
+  TSequence *result = tsequence_make(instants, ninsts, seq->period.lower_inc,
+    seq->period.upper_inc, LINEAR, NORMALIZE);
+  pfree(instants);
+  pfree(keep);
+  pfree(heap);
+  return result;
+}
+
+/**
+ * @brief Simplify the temporal sequence set float/point to a target number
+ * of instants with a top-down greedy refinement.
+ * @param[in] ss Temporal value
+ * @param[in] count Maximum number of instants in the result
+ * @param[in] syncdist True when computing the Synchronized Euclidean
+ * Distance (SED), false when computing the spatial only distance.
+ * @note The budget is distributed among the composing sequences in
+ * proportion to their number of instants, with at least two instants each
+ */
+static TSequenceSet *
+tsequenceset_simplify_count(const TSequenceSet *ss, int count, bool syncdist)
+{
+  TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    int target = Max(2, (int) ((int64) count * seq->count / ss->totalcount));
+    sequences[i] = tsequence_simplify_count(seq, target, syncdist);
+  }
+  return tsequenceset_make_free(sequences, ss->count, NORMALIZE);
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Simplify the temporal float/point to a target number of instants
+ * with a top-down greedy refinement of the Douglas-Peucker algorithm.
+ * @param[in] temp Temporal value
+ * @param[in] count Maximum number of instants in the result, at least 2
+ * @param[in] syncdist True when the Synchronized Distance is used, false when
+ * the spatial-only distance is used. Only used for temporal points.
+ * @note The funcion applies only for temporal sequences or sequence sets with
+ * linear interpolation. In all other cases, it returns a copy of the temporal
+ * value.
+ * @sqlfunc maxPointsSimplify()
+ */
+Temporal *
+temporal_simplify_count(const Temporal *temp, int count, bool syncdist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_tnumber_tgeo_type(temp->temptype))
+    return NULL;
+  if (count < 2)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The maximum number of instants must be at least 2");
+    return NULL;
+  }
+
+  Temporal *result;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT || ! MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+    result = temporal_copy(temp);
+  else if (temp->subtype == TSEQUENCE)
+    result = (Temporal *) tsequence_simplify_count((TSequence *) temp, count,
+      syncdist);
+  else /* temp->subtype == TSEQUENCESET */
+    result = (Temporal *) tsequenceset_simplify_count((TSequenceSet *) temp,
+      count, syncdist);
+  return result;
+}
+
 /**
  * @brief Simplify the temporal sequence set float/point using the
  * Douglas-Peucker line simplification algorithm.
@@ -1668,4 +2910,514 @@ temporal_simplify_dp(const Temporal *temp, double dist, bool syncdist)
   return result;
 }
 
+/***********************************************************************
+ * Online SQUISH-E simplification for growing sequences.
+ * The simplification functions above require the complete sequence.
+ * The stream below consumes the observations one at a time, keeps a
+ * bounded buffer of instants, and evicts the instant whose removal
+ * introduces the smallest error when the buffer is full or when that
+ * error is below the tolerance. When an instant is evicted its error
+ * carries over to its neighbors, so the accumulated error stays bounded
+ * as in the SQUISH-E algorithm.
+ ***********************************************************************/
+
+#if MEOS
+
+/**
+ * Structure keeping the state of an online simplification. The instants of
+ * the buffer are in increasing timestamp order and the first and last ones
+ * are never removed.
+ */
+struct SimplifyStream
+{
+  double dist;        /**< Tolerance, 0 when only the buffer size bounds */
+  bool syncdist;      /**< True for the Synchronized Euclidean Distance */
+  int maxcount;       /**< Maximum number of instants kept, 0 for no bound */
+  int count;          /**< Number of instants in the buffer */
+  int capacity;       /**< Number of instants the arrays can hold */
+  TInstant **instants; /**< Buffered instants, owned by the stream */
+  double *priority;   /**< Error introduced by removing the instant */
+  double *adjust;     /**< Accumulated error of evicted neighbor instants */
+};
+
+/**
+ * @brief Return the error introduced by removing an instant, that is, the
+ * distance between the instant and the segment joining its neighbors
+ * @param[in] start,end Neighbor instants
+ * @param[in] inst Instant to be removed
+ * @param[in] syncdist True when using the Synchronized Euclidean Distance
+ */
+static double
+tinstant_remove_error(const TInstant *start, const TInstant *inst,
+  const TInstant *end, bool syncdist)
+{
+  if (inst->temptype == T_TFLOAT)
+  {
+    double startval = DatumGetFloat8(tinstant_value(start));
+    double endval = DatumGetFloat8(tinstant_value(end));
+    double ratio = (double) (inst->t - start->t) /
+      (double) (end->t - start->t);
+    double value_interp = startval + (endval - startval) * ratio;
+    return fabs(DatumGetFloat8(tinstant_value(inst)) - value_interp);
+  }
+  /* Temporal point */
+  double d;
+  Datum value;
+  if (MEOS_FLAGS_GET_Z(inst->flags))
+  {
+    POINT3DZ *p3k = (POINT3DZ *) DATUM_POINT3DZ_P(tinstant_value(inst));
+    if (syncdist)
+    {
+      value = tsegment_value_at_timestamp(start, end, LINEAR, inst->t);
+      d = dist3d_pt_pt(p3k, (POINT3DZ *) DATUM_POINT3DZ_P(value));
+      pfree(DatumGetPointer(value));
+    }
+    else
+      d = dist3d_pt_seg(p3k,
+        (POINT3DZ *) DATUM_POINT3DZ_P(tinstant_value(start)),
+        (POINT3DZ *) DATUM_POINT3DZ_P(tinstant_value(end)));
+  }
+  else
+  {
+    POINT2D *p2k = (POINT2D *) DATUM_POINT2D_P(tinstant_value(inst));
+    if (syncdist)
+    {
+      value = tsegment_value_at_timestamp(start, end, LINEAR, inst->t);
+      d = dist2d_pt_pt(p2k, (POINT2D *) DATUM_POINT2D_P(value));
+      pfree(DatumGetPointer(value));
+    }
+    else
+      d = dist2d_pt_seg(p2k,
+        (POINT2D *) DATUM_POINT2D_P(tinstant_value(start)),
+        (POINT2D *) DATUM_POINT2D_P(tinstant_value(end)));
+  }
+  return d;
+}
+
+/**
+ * @brief Return the position of the interior instant of the buffer whose
+ * removal introduces the smallest error
+ */
+static int
+simplify_stream_argmin(const SimplifyStream *stream)
+{
+  int argmin = 1;
+  for (int i = 2; i < stream->count - 1; i++)
+    if (stream->priority[i] < stream->priority[argmin])
+      argmin = i;
+  return argmin;
+}
+
+/**
+ * @brief Remove an interior instant from the buffer carrying its error over
+ * to its neighbors
+ */
+static void
+simplify_stream_remove(SimplifyStream *stream, int idx)
+{
+  assert(idx > 0 && idx < stream->count - 1);
+  /* The error of the removed instant carries over to its neighbors */
+  stream->adjust[idx - 1] += stream->priority[idx];
+  stream->adjust[idx + 1] += stream->priority[idx];
+  pfree(stream->instants[idx]);
+  memmove(&stream->instants[idx], &stream->instants[idx + 1],
+    sizeof(TInstant *) * (stream->count - idx - 1));
+  memmove(&stream->priority[idx], &stream->priority[idx + 1],
+    sizeof(double) * (stream->count - idx - 1));
+  memmove(&stream->adjust[idx], &stream->adjust[idx + 1],
+    sizeof(double) * (stream->count - idx - 1));
+  stream->count--;
+  /* Refresh the errors of the neighbors, which are now adjacent */
+  for (int j = idx - 1; j <= idx; j++)
+    if (j > 0 && j < stream->count - 1)
+      stream->priority[j] = stream->adjust[j] + tinstant_remove_error(
+        stream->instants[j - 1], stream->instants[j], stream->instants[j + 1],
+        stream->syncdist);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Construct the state of an online simplification of a growing
+ * sequence of temporal float or temporal point observations.
+ * @param[in] dist Maximum error tolerated by an eager eviction, in the units
+ * of the values for temporal floats or the units of the coordinate system
+ * for temporal points, 0 when only the buffer size bounds the simplification
+ * @param[in] syncdist True when the Synchronized Distance is used, false when
+ * the spatial-only distance is used. Only used for temporal points.
+ * @param[in] maxcount Maximum number of instants kept, 0 when only the
+ * tolerance bounds the simplification
+ */
+SimplifyStream *
+simplify_stream_make(double dist, bool syncdist, int maxcount)
+{
+  /* Ensure validity of the arguments */
+  if (dist < 0 || maxcount < 0 || (dist == 0 && maxcount == 0) ||
+      (maxcount != 0 && maxcount < 2))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The simplification requires a positive tolerance or a maximum count "
+      "greater than 1");
+    return NULL;
+  }
+  SimplifyStream *result = palloc0(sizeof(SimplifyStream));
+  result->dist = dist;
+  result->syncdist = syncdist;
+  result->maxcount = maxcount;
+  /* One instant of slack so that an eviction may follow an addition */
+  result->capacity = (maxcount != 0) ? maxcount + 1 : 64;
+  result->instants = palloc(sizeof(TInstant *) * result->capacity);
+  result->priority = palloc(sizeof(double) * result->capacity);
+  result->adjust = palloc(sizeof(double) * result->capacity);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Add an instant to an online simplification.
+ * @param[in,out] stream Simplification state
+ * @param[in] inst Temporal instant
+ */
+bool
+simplify_stream_add(SimplifyStream *stream, const TInstant *inst)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) stream) || ! ensure_not_null((void *) inst))
+    return false;
+  if (inst->temptype != T_TFLOAT && ! tgeo_type(inst->temptype))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "Simplification requires a temporal float or a temporal point");
+    return false;
+  }
+  if (stream->count > 0)
+  {
+    const TInstant *last = stream->instants[stream->count - 1];
+    if (! ensure_same_temporal_type((Temporal *) last, (Temporal *) inst))
+      return false;
+    if (inst->t <= last->t)
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Timestamps for simplification must be increasing");
+      return false;
+    }
+  }
+
+  if (stream->count == stream->capacity)
+  {
+    stream->capacity *= 2;
+    stream->instants = repalloc(stream->instants,
+      sizeof(TInstant *) * stream->capacity);
+    stream->priority = repalloc(stream->priority,
+      sizeof(double) * stream->capacity);
+    stream->adjust = repalloc(stream->adjust,
+      sizeof(double) * stream->capacity);
+  }
+  /* The last instant of the buffer is never removed and thus has an
+   * infinite error until a successor arrives */
+  stream->instants[stream->count] = tinstant_copy(inst);
+  stream->priority[stream->count] = DBL_MAX;
+  stream->adjust[stream->count] = 0;
+  stream->count++;
+  /* The previously last instant became interior: compute its error */
+  if (stream->count >= 3)
+  {
+    int j = stream->count - 2;
+    stream->priority[j] = stream->adjust[j] + tinstant_remove_error(
+      stream->instants[j - 1], stream->instants[j], stream->instants[j + 1],
+      stream->syncdist);
+  }
+  /* Eagerly evict the instants whose removal stays within the tolerance */
+  if (stream->dist > 0)
+    while (stream->count > 2)
+    {
+      int argmin = simplify_stream_argmin(stream);
+      if (stream->priority[argmin] > stream->dist)
+        break;
+      simplify_stream_remove(stream, argmin);
+    }
+  /* Evict the instant with the smallest error when the buffer is full */
+  if (stream->maxcount != 0)
+    while (stream->count > stream->maxcount)
+      simplify_stream_remove(stream, simplify_stream_argmin(stream));
+  return true;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Return the simplified sequence of the instants added so far to an
+ * online simplification.
+ * @param[in] stream Simplification state
+ */
+TSequence *
+simplify_stream_sequence(const SimplifyStream *stream)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) stream))
+    return NULL;
+  if (stream->count == 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "No instants have been added to the simplification");
+    return NULL;
+  }
+  return tsequence_make((const TInstant **) stream->instants, stream->count,
+    true, true, LINEAR, NORMALIZE_NO);
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Free the state of an online simplification.
+ * @param[in] stream Simplification state
+ */
+void
+simplify_stream_free(SimplifyStream *stream)
+{
+  if (! stream)
+    return;
+  for (int i = 0; i < stream->count; i++)
+    pfree(stream->instants[i]);
+  pfree(stream->instants);
+  pfree(stream->priority);
+  pfree(stream->adjust);
+  pfree(stream);
+  return;
+}
+
+/***********************************************************************
+ * Multi-resolution simplification pyramid.
+ * Interactive applications simplify the same temporal value over and
+ * over with a tolerance depending on the zoom level. The pyramid below
+ * precomputes a fixed number of nested simplification levels once, so
+ * that retrieving the level appropriate for a tolerance afterwards costs
+ * only the result. Every level is simplified from the previous finer
+ * level with a tolerance growing by a constant factor, thus the instants
+ * of a level are a subset of those of the previous one and the total
+ * construction cost is a small multiple of a single simplification.
+ ***********************************************************************/
+
+/**
+ * Structure keeping the precomputed simplification levels of a temporal
+ * float or temporal point. Level 0 is the full-resolution value and the
+ * tolerance of level `i > 0` is `dist * pow(factor, i - 1)`.
+ */
+struct TemporalPyramid
+{
+  double dist;       /**< Tolerance of the first simplified level */
+  double factor;     /**< Growth factor of the tolerance between levels */
+  bool syncdist;     /**< True for the Synchronized Euclidean Distance */
+  int count;         /**< Number of levels including the full resolution */
+  Temporal **levels; /**< Levels from full resolution to coarsest */
+};
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Construct the simplification pyramid of a temporal float or
+ * temporal point.
+ * @param[in] temp Temporal value
+ * @param[in] dist Tolerance of the first simplified level, in the units of
+ * the values for temporal floats or the units of the coordinate system for
+ * temporal points
+ * @param[in] factor Growth factor of the tolerance between levels, greater
+ * than 1
+ * @param[in] maxlevels Maximum number of levels including the full
+ * resolution, at least 2
+ * @param[in] syncdist True when the Synchronized Distance is used, false
+ * when the spatial-only distance is used. Only used for temporal points.
+ * @note The construction stops before @p maxlevels when a level does not
+ * remove any instant from the previous one, since every subsequent level
+ * would be equal to it.
+ */
+TemporalPyramid *
+temporal_pyramid_make(const Temporal *temp, double dist, double factor,
+  int maxlevels, bool syncdist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_tnumber_tgeo_type(temp->temptype) ||
+      ! ensure_positive_datum(Float8GetDatum(dist), T_FLOAT8))
+    return NULL;
+  if (factor <= 1 || maxlevels < 2)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The pyramid requires a growth factor greater than 1 and at least 2 "
+      "levels");
+    return NULL;
+  }
+
+  TemporalPyramid *result = palloc0(sizeof(TemporalPyramid));
+  result->dist = dist;
+  result->factor = factor;
+  result->syncdist = syncdist;
+  result->levels = palloc(sizeof(Temporal *) * maxlevels);
+  result->levels[0] = temporal_copy(temp);
+  result->count = 1;
+  double d = dist;
+  for (int i = 1; i < maxlevels; i++)
+  {
+    /* Simplify the previous finer level so that the levels are nested */
+    Temporal *level = temporal_simplify_dp(result->levels[i - 1], d,
+      syncdist);
+    if (temporal_num_instants(level) ==
+        temporal_num_instants(result->levels[i - 1]))
+    {
+      pfree(level);
+      break;
+    }
+    result->levels[result->count++] = level;
+    d *= factor;
+  }
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Return the number of levels of a simplification pyramid.
+ * @param[in] pyramid Simplification pyramid
+ */
+int
+temporal_pyramid_num_levels(const TemporalPyramid *pyramid)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pyramid))
+    return -1;
+  return pyramid->count;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Return a level of a simplification pyramid.
+ * @param[in] pyramid Simplification pyramid
+ * @param[in] level Level number, 0 being the full resolution
+ * @note The result is owned by the pyramid and must not be freed.
+ */
+const Temporal *
+temporal_pyramid_level(const TemporalPyramid *pyramid, int level)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pyramid))
+    return NULL;
+  if (level < 0 || level >= pyramid->count)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The level must be between 0 and %d", pyramid->count - 1);
+    return NULL;
+  }
+  return pyramid->levels[level];
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Return the coarsest level of a simplification pyramid whose
+ * tolerance does not exceed the given one.
+ * @param[in] pyramid Simplification pyramid
+ * @param[in] dist Tolerance, in the units of the values for temporal floats
+ * or the units of the coordinate system for temporal points
+ * @note The full-resolution level is returned when the tolerance is smaller
+ * than the one of the first simplified level. The result is owned by the
+ * pyramid and must not be freed.
+ */
+const Temporal *
+temporal_pyramid_at_dist(const TemporalPyramid *pyramid, double dist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pyramid) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+    return NULL;
+  int level = 0;
+  double d = pyramid->dist;
+  while (level + 1 < pyramid->count && d <= dist)
+  {
+    level++;
+    d *= pyramid->factor;
+  }
+  return pyramid->levels[level];
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Return the levels of a simplification pyramid as ordered
+ * refinement layers in Well-Known Binary (WKB) format.
+ *
+ * The first layer is the coarsest level of the pyramid as a complete
+ * temporal value; every following layer is a discrete temporal value
+ * holding only the instants that the next finer level adds. A client thus
+ * renders the first layer as soon as it arrives and refines the display by
+ * merging the instants of each following layer by timestamp, obtaining
+ * after `k + 1` layers exactly the level `count - 1 - k` of the pyramid.
+ * The concatenated sizes of the layers received so far tell the client how
+ * far the refinement has progressed.
+ *
+ * @param[in] pyramid Simplification pyramid
+ * @param[in] variant Unsigned int8 value for the WKB variant
+ * @param[out] count Number of layers
+ * @param[out] sizes Array of sizes in bytes of the layers
+ * @return Array of layers from coarse to fine, serialized as in
+ * temporal_as_wkb(); the array, the layers, and the sizes array must be
+ * freed by the caller
+ */
+uint8_t **
+temporal_pyramid_as_layers_wkb(const TemporalPyramid *pyramid,
+  uint8_t variant, int *count, size_t **sizes)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pyramid) ||
+      ! ensure_not_null((void *) count) || ! ensure_not_null((void *) sizes))
+    return NULL;
+
+  int nlevels = pyramid->count;
+  uint8_t **result = palloc(sizeof(uint8_t *) * nlevels);
+  *sizes = palloc(sizeof(size_t) * nlevels);
+  /* The first layer is the coarsest level as a complete temporal value */
+  result[0] = temporal_as_wkb(pyramid->levels[nlevels - 1], variant,
+    &(*sizes)[0]);
+  /* Every following layer holds the instants that the next finer level
+   * adds; since the levels are nested, these are the instants of the finer
+   * level whose timestamp does not appear in the coarser one */
+  for (int i = 1; i < nlevels; i++)
+  {
+    const Temporal *finer = pyramid->levels[nlevels - 1 - i];
+    const Temporal *coarser = pyramid->levels[nlevels - i];
+    int fcount, ccount;
+    const TInstant **finsts = temporal_instants(finer, &fcount);
+    const TInstant **cinsts = temporal_instants(coarser, &ccount);
+    /* Merge on the timestamps, both arrays being sorted */
+    const TInstant **delta = palloc(sizeof(TInstant *) * (fcount - ccount));
+    int ndelta = 0, j = 0;
+    for (int k = 0; k < fcount; k++)
+    {
+      if (j < ccount && finsts[k]->t == cinsts[j]->t)
+        j++;
+      else
+        delta[ndelta++] = finsts[k];
+    }
+    TSequence *seq = tsequence_make(delta, ndelta, true, true, DISCRETE,
+      NORMALIZE_NO);
+    result[i] = temporal_as_wkb((const Temporal *) seq, variant,
+      &(*sizes)[i]);
+    pfree(seq); pfree(delta); pfree(finsts); pfree(cinsts);
+  }
+  *count = nlevels;
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_simplify
+ * @brief Free a simplification pyramid.
+ * @param[in] pyramid Simplification pyramid
+ */
+void
+temporal_pyramid_free(TemporalPyramid *pyramid)
+{
+  if (! pyramid)
+    return;
+  for (int i = 0; i < pyramid->count; i++)
+    pfree(pyramid->levels[i]);
+  pfree(pyramid->levels);
+  pfree(pyramid);
+  return;
+}
+
+#endif /* MEOS */
+
 /*****************************************************************************/
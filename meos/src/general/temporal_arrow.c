@@ -0,0 +1,408 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Conversion of temporal values from and to Apache Arrow columnar
+ * arrays
+ *
+ * The conversion uses the Arrow C Data Interface, a stable ABI of two plain
+ * C structures that every Arrow implementation understands, so MEOS does
+ * not depend on an Arrow library. A temporal value is exported as a struct
+ * array with a timestamp child column and one child column per value
+ * dimension: `value` for temporal numbers and `x`, `y`, and optionally `z`
+ * for temporal points.
+ *
+ * The in-memory format of temporal values interleaves timestamps and
+ * values per instant, hence the export fills the columnar buffers in one
+ * pass over the instants rather than handing out internal pointers; the
+ * import likewise assembles instants from the columns. Consumers receive
+ * ownership of the exported buffers through the release callbacks mandated
+ * by the interface.
+ */
+
+/* C */
+#include <stdlib.h>
+#include <string.h>
+/* Postgres */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporaltypes.h"
+#include "general/type_util.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/*****************************************************************************
+ * Release callbacks of the Arrow C Data Interface
+ *****************************************************************************/
+
+/**
+ * @brief Release an exported Arrow schema and its children
+ */
+static void
+temporal_arrow_schema_release(struct ArrowSchema *schema)
+{
+  for (int64_t i = 0; i < schema->n_children; i++)
+  {
+    struct ArrowSchema *child = schema->children[i];
+    if (child && child->release)
+      child->release(child);
+    free(child);
+  }
+  free(schema->children);
+  schema->release = NULL;
+  return;
+}
+
+/**
+ * @brief Release an exported Arrow array, its children, and their buffers
+ */
+static void
+temporal_arrow_array_release(struct ArrowArray *array)
+{
+  for (int64_t i = 0; i < array->n_children; i++)
+  {
+    struct ArrowArray *child = array->children[i];
+    if (child && child->release)
+      child->release(child);
+    free(child);
+  }
+  free(array->children);
+  /* The data buffer, if any, was allocated by the export; the validity
+   * buffer is always NULL since temporal values have no nulls */
+  if (array->n_buffers == 2)
+    free((void *) array->buffers[1]);
+  free(array->buffers);
+  array->release = NULL;
+  return;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Fill an Arrow schema; the format and name must outlive the schema,
+ * which holds for the string constants used below
+ */
+static void
+temporal_arrow_schema_set(struct ArrowSchema *schema, const char *format,
+  const char *name, int64_t n_children)
+{
+  memset(schema, 0, sizeof(struct ArrowSchema));
+  schema->format = format;
+  schema->name = name;
+  schema->n_children = n_children;
+  if (n_children > 0)
+  {
+    schema->children = calloc(n_children, sizeof(struct ArrowSchema *));
+    for (int64_t i = 0; i < n_children; i++)
+      schema->children[i] = calloc(1, sizeof(struct ArrowSchema));
+  }
+  schema->release = &temporal_arrow_schema_release;
+  return;
+}
+
+/**
+ * @brief Fill an Arrow array with a single data buffer of the given size,
+ * or no buffer for the outer struct array
+ */
+static void *
+temporal_arrow_array_set(struct ArrowArray *array, int64_t length,
+  size_t bufsize, int64_t n_children)
+{
+  memset(array, 0, sizeof(struct ArrowArray));
+  array->length = length;
+  array->null_count = 0;
+  array->n_buffers = bufsize ? 2 : 1;
+  array->buffers = calloc(array->n_buffers, sizeof(void *));
+  /* buffers[0] is the validity bitmap, NULL when there are no nulls */
+  if (bufsize)
+    array->buffers[1] = malloc(bufsize);
+  array->n_children = n_children;
+  if (n_children > 0)
+  {
+    array->children = calloc(n_children, sizeof(struct ArrowArray *));
+    for (int64_t i = 0; i < n_children; i++)
+      array->children[i] = calloc(1, sizeof(struct ArrowArray));
+  }
+  array->release = &temporal_arrow_array_release;
+  return bufsize ? (void *) array->buffers[1] : NULL;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Export a temporal value as an Arrow struct array
+ * @param[in] temp Temporal value, of type tint, tfloat, or tgeompoint
+ * @param[out] schema Arrow schema of the resulting array
+ * @param[out] array Arrow struct array with a timestamp child column and
+ * one child column per value dimension
+ * @return True on success
+ *
+ * The caller owns the resulting schema and array and must call their
+ * release callbacks, typically after handing them to an Arrow consumer.
+ */
+bool
+temporal_as_arrow(const Temporal *temp, struct ArrowSchema *schema,
+  struct ArrowArray *array)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) schema) ||
+      ! ensure_not_null((void *) array))
+    return false;
+  if (temp->temptype != T_TINT && temp->temptype != T_TFLOAT &&
+      temp->temptype != T_TGEOMPOINT)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "Arrow conversion is not supported for type %s",
+      meostype_name(temp->temptype));
+    return false;
+  }
+
+  int count;
+  const TInstant **instants = temporal_instants(temp, &count);
+  bool hasz = MEOS_FLAGS_GET_Z(temp->flags);
+  bool point = (temp->temptype == T_TGEOMPOINT);
+  int64_t ncols = point ? (hasz ? 4 : 3) : 2;
+
+  temporal_arrow_schema_set(schema, "+s", "", ncols);
+  temporal_arrow_schema_set(schema->children[0], "tsu:UTC", "t", 0);
+  if (point)
+  {
+    temporal_arrow_schema_set(schema->children[1], "g", "x", 0);
+    temporal_arrow_schema_set(schema->children[2], "g", "y", 0);
+    if (hasz)
+      temporal_arrow_schema_set(schema->children[3], "g", "z", 0);
+  }
+  else
+    temporal_arrow_schema_set(schema->children[1],
+      (temp->temptype == T_TINT) ? "i" : "g", "value", 0);
+
+  temporal_arrow_array_set(array, count, 0, ncols);
+  int64_t *times = temporal_arrow_array_set(array->children[0], count,
+    sizeof(int64_t) * count, 0);
+  if (point)
+  {
+    double *x = temporal_arrow_array_set(array->children[1], count,
+      sizeof(double) * count, 0);
+    double *y = temporal_arrow_array_set(array->children[2], count,
+      sizeof(double) * count, 0);
+    double *z = hasz ? temporal_arrow_array_set(array->children[3], count,
+      sizeof(double) * count, 0) : NULL;
+    for (int i = 0; i < count; i++)
+    {
+      POINT4D p;
+      datum_point4d(tinstant_value(instants[i]), &p);
+      times[i] = (int64_t) instants[i]->t;
+      x[i] = p.x;
+      y[i] = p.y;
+      if (hasz)
+        z[i] = p.z;
+    }
+  }
+  else if (temp->temptype == T_TINT)
+  {
+    int32_t *values = temporal_arrow_array_set(array->children[1], count,
+      sizeof(int32_t) * count, 0);
+    for (int i = 0; i < count; i++)
+    {
+      times[i] = (int64_t) instants[i]->t;
+      values[i] = DatumGetInt32(tinstant_value(instants[i]));
+    }
+  }
+  else /* temp->temptype == T_TFLOAT */
+  {
+    double *values = temporal_arrow_array_set(array->children[1], count,
+      sizeof(double) * count, 0);
+    for (int i = 0; i < count; i++)
+    {
+      times[i] = (int64_t) instants[i]->t;
+      values[i] = DatumGetFloat8(tinstant_value(instants[i]));
+    }
+  }
+  pfree(instants);
+  return true;
+}
+
+/**
+ * @brief Return the child column with the given name, or NULL
+ */
+static int
+temporal_arrow_child(const struct ArrowSchema *schema, const char *name)
+{
+  for (int64_t i = 0; i < schema->n_children; i++)
+    if (schema->children[i]->name &&
+        strcmp(schema->children[i]->name, name) == 0)
+      return (int) i;
+  return -1;
+}
+
+/**
+ * @brief Return the data buffer of an Arrow child array after validating
+ * its format
+ */
+static const void *
+temporal_arrow_column(const struct ArrowSchema *schema,
+  const struct ArrowArray *array, const char *name, const char *format)
+{
+  int child = temporal_arrow_child(schema, name);
+  if (child < 0 || child >= array->n_children ||
+      strncmp(schema->children[child]->format, format, strlen(format)) != 0 ||
+      array->children[child]->n_buffers < 2 ||
+      array->children[child]->null_count > 0)
+    return NULL;
+  return array->children[child]->buffers[1];
+}
+
+/**
+ * @brief Import a temporal value from an Arrow struct array
+ * @param[in] schema Arrow schema of the array
+ * @param[in] array Arrow struct array with a timestamp column `t` and
+ * either a `value` column or `x`, `y`, and optionally `z` columns, sorted
+ * by timestamp and without nulls
+ * @param[in] temptype Temporal type of the result: tint, tfloat, or
+ * tgeompoint
+ * @return A temporal sequence with step interpolation for tint and linear
+ * interpolation otherwise; on error return @p NULL
+ */
+static Temporal *
+temporal_from_arrow(const struct ArrowSchema *schema,
+  const struct ArrowArray *array, meosType temptype)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) schema) || ! ensure_not_null((void *) array))
+    return NULL;
+  if (temptype != T_TINT && temptype != T_TFLOAT && temptype != T_TGEOMPOINT)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "Arrow conversion is not supported for type %s",
+      meostype_name(temptype));
+    return NULL;
+  }
+  if (strcmp(schema->format, "+s") != 0 || array->length <= 0 ||
+      array->null_count > 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The Arrow array is not a non-empty struct array without nulls");
+    return NULL;
+  }
+
+  int count = (int) array->length;
+  const int64_t *times = temporal_arrow_column(schema, array, "t", "ts");
+  const int32_t *ivalues = NULL;
+  const double *fvalues = NULL, *x = NULL, *y = NULL, *z = NULL;
+  if (temptype == T_TINT)
+    ivalues = temporal_arrow_column(schema, array, "value", "i");
+  else if (temptype == T_TFLOAT)
+    fvalues = temporal_arrow_column(schema, array, "value", "g");
+  else /* temptype == T_TGEOMPOINT */
+  {
+    x = temporal_arrow_column(schema, array, "x", "g");
+    y = temporal_arrow_column(schema, array, "y", "g");
+    z = temporal_arrow_column(schema, array, "z", "g");
+  }
+  if (! times || (temptype == T_TINT && ! ivalues) ||
+      (temptype == T_TFLOAT && ! fvalues) ||
+      (temptype == T_TGEOMPOINT && (! x || ! y)))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The Arrow array does not have the expected columns");
+    return NULL;
+  }
+
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    TimestampTz t = (TimestampTz) times[i];
+    if (temptype == T_TINT)
+      instants[i] = tinstant_make(Int32GetDatum(ivalues[i]), T_TINT, t);
+    else if (temptype == T_TFLOAT)
+      instants[i] = tinstant_make(Float8GetDatum(fvalues[i]), T_TFLOAT, t);
+    else
+    {
+      GSERIALIZED *gs = gspoint_make(x[i], y[i], z ? z[i] : 0.0, z != NULL,
+        false, SRID_UNKNOWN);
+      instants[i] = tinstant_make(PointerGetDatum(gs), T_TGEOMPOINT, t);
+      pfree(gs);
+    }
+  }
+  interpType interp = (temptype == T_TINT) ? STEP : LINEAR;
+  return (Temporal *) tsequence_make_free(instants, count, true, true,
+    interp, NORMALIZE);
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Import a temporal integer from an Arrow struct array
+ * @param[in] schema Arrow schema of the array
+ * @param[in] array Arrow struct array with a timestamp column `t` and an
+ * int32 column `value`, sorted by timestamp and without nulls
+ * @return A temporal sequence with step interpolation; on error return
+ * @p NULL
+ */
+Temporal *
+tint_from_arrow(const struct ArrowSchema *schema,
+  const struct ArrowArray *array)
+{
+  return temporal_from_arrow(schema, array, T_TINT);
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Import a temporal float from an Arrow struct array
+ * @param[in] schema Arrow schema of the array
+ * @param[in] array Arrow struct array with a timestamp column `t` and a
+ * float64 column `value`, sorted by timestamp and without nulls
+ * @return A temporal sequence with linear interpolation; on error return
+ * @p NULL
+ */
+Temporal *
+tfloat_from_arrow(const struct ArrowSchema *schema,
+  const struct ArrowArray *array)
+{
+  return temporal_from_arrow(schema, array, T_TFLOAT);
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Import a temporal geometry point from an Arrow struct array
+ * @param[in] schema Arrow schema of the array
+ * @param[in] array Arrow struct array with a timestamp column `t` and
+ * float64 columns `x`, `y`, and optionally `z`, sorted by timestamp and
+ * without nulls
+ * @return A temporal sequence with linear interpolation; on error return
+ * @p NULL
+ */
+Temporal *
+tgeompoint_from_arrow(const struct ArrowSchema *schema,
+  const struct ArrowArray *array)
+{
+  return temporal_from_arrow(schema, array, T_TGEOMPOINT);
+}
+
+/*****************************************************************************/
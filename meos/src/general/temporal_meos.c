@@ -331,6 +331,128 @@ tpoint_value_at_timestamp(const Temporal *temp, TimestampTz t, bool strict,
 
 /*****************************************************************************/
 
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Return the value of a temporal boolean at a timestamp, resuming the
+ * search from the position of the previous lookup
+ * @sqlfunc valueAtTimestamp()
+ * @see #temporal_cursor_init
+ */
+bool
+tbool_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t,
+  bool strict, bool *value)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) cursor) ||
+      ! ensure_not_null((void *) value) ||
+      ! ensure_not_null((void *) cursor->temp) ||
+      ! ensure_temporal_has_type(cursor->temp, T_TBOOL))
+    return false;
+
+  Datum res;
+  bool result = temporal_cursor_value_at_timestamp(cursor, t, strict, &res);
+  *value = DatumGetBool(res);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Return the value of a temporal integer at a timestamp, resuming the
+ * search from the position of the previous lookup
+ * @sqlfunc valueAtTimestamp()
+ * @see #temporal_cursor_init
+ */
+bool
+tint_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t,
+  bool strict, int *value)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) cursor) ||
+      ! ensure_not_null((void *) value) ||
+      ! ensure_not_null((void *) cursor->temp) ||
+      ! ensure_temporal_has_type(cursor->temp, T_TINT))
+    return false;
+
+  Datum res;
+  bool result = temporal_cursor_value_at_timestamp(cursor, t, strict, &res);
+  *value = DatumGetInt32(res);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Return the value of a temporal float at a timestamp, resuming the
+ * search from the position of the previous lookup
+ * @sqlfunc valueAtTimestamp()
+ * @see #temporal_cursor_init
+ */
+bool
+tfloat_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t,
+  bool strict, double *value)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) cursor) ||
+      ! ensure_not_null((void *) value) ||
+      ! ensure_not_null((void *) cursor->temp) ||
+      ! ensure_temporal_has_type(cursor->temp, T_TFLOAT))
+    return false;
+
+  Datum res;
+  bool result = temporal_cursor_value_at_timestamp(cursor, t, strict, &res);
+  *value = DatumGetFloat8(res);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Return the value of a temporal text at a timestamp, resuming the
+ * search from the position of the previous lookup
+ * @sqlfunc valueAtTimestamp()
+ * @see #temporal_cursor_init
+ */
+bool
+ttext_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t,
+  bool strict, text **value)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) cursor) ||
+      ! ensure_not_null((void *) value) ||
+      ! ensure_not_null((void *) cursor->temp) ||
+      ! ensure_temporal_has_type(cursor->temp, T_TTEXT))
+    return false;
+
+  Datum res;
+  bool result = temporal_cursor_value_at_timestamp(cursor, t, strict, &res);
+  *value = DatumGetTextP(res);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Return the value of a temporal point at a timestamp, resuming the
+ * search from the position of the previous lookup
+ * @sqlfunc valueAtTimestamp()
+ * @see #temporal_cursor_init
+ */
+bool
+tpoint_cursor_value_at_timestamp(TemporalCursor *cursor, TimestampTz t,
+  bool strict, GSERIALIZED **value)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) cursor) ||
+      ! ensure_not_null((void *) value) ||
+      ! ensure_not_null((void *) cursor->temp) ||
+      ! ensure_tgeo_type(cursor->temp->temptype))
+    return false;
+
+  Datum res;
+  bool result = temporal_cursor_value_at_timestamp(cursor, t, strict, &res);
+  *value = DatumGetGserializedP(res);
+  return result;
+}
+
+/*****************************************************************************/
+
 /**
  * @ingroup libmeos_temporal_restrict
  * @brief Restrict a temporal value to its minimum base value
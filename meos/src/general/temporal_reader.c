@@ -0,0 +1,498 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Asynchronous prefetching reader of temporal values from text files.
+ *
+ * Loaders such as the AIS examples read a line, parse it into a temporal
+ * value, and process the result serially, so the disk, the parser, and the
+ * computation never overlap. A temporal reader runs the read and the parse
+ * stages on two background threads: an I/O thread fills one of two raw text
+ * buffers while the parse thread consumes the other, and the parse thread
+ * converts complete lines into batches of temporal values that the consumer
+ * takes with #temporal_reader_next while the next batches are being
+ * prepared.
+ *
+ * The conversion of a line into a temporal value is delegated to a
+ * caller-supplied function, so that application formats such as AIS records
+ * can be plugged in, and runs on the parse thread: it must only use
+ * thread-safe functionality, which includes the MEOS input functions. Lines
+ * for which the function returns @p NULL are skipped, which lets callers
+ * filter records.
+ */
+
+#include "general/temporal.h"
+
+/* C */
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+/* MEOS */
+#include <meos.h>
+
+/*****************************************************************************/
+
+/** Size of the raw input chunks read by the I/O thread */
+#define MEOS_READER_CHUNK (1 << 20)
+
+/**
+ * Raw text buffer handed from the I/O thread to the parse thread. A buffer
+ * always ends at a line boundary except for the last one of the file. The
+ * buffer contents are only accessed by the thread that owns the slot: the
+ * I/O thread while the slot is empty, the parse thread while it is full;
+ * only the flag itself is read and written under the reader lock.
+ */
+typedef struct
+{
+  char *data;           /**< Raw text of complete lines */
+  size_t len;           /**< Number of bytes used */
+  size_t size;          /**< Allocated size */
+  bool full;            /**< True when the buffer is ready to be parsed */
+} TemporalReaderBuffer;
+
+/**
+ * Batch of parsed temporal values handed from the parse thread to the
+ * consumer
+ */
+typedef struct
+{
+  Temporal **temps;     /**< Array of temporal values */
+  int count;            /**< Number of elements in the array */
+  bool full;            /**< True when the batch is ready to be taken */
+} TemporalReaderBatch;
+
+/**
+ * Structure to represent an open temporal reader. A single lock and
+ * condition variable coordinate the three participants: the pipeline
+ * exchanges megabyte-sized buffers and whole batches, so the stages
+ * synchronize a few times per million lines and contention is negligible.
+ */
+struct TemporalReader
+{
+  FILE *file;                  /**< File being read */
+  TemporalLineParseFn parse;   /**< Function parsing one line */
+  void *context;               /**< Context passed through to the function */
+  int batchsize;               /**< Number of temporal values per batch */
+  pthread_t iothread;          /**< Thread reading the file */
+  pthread_t parsethread;       /**< Thread parsing the lines */
+  pthread_mutex_t lock;        /**< Protects the fields below */
+  pthread_cond_t avail;        /**< Signaled when a slot changes state */
+  TemporalReaderBuffer buf[2]; /**< Double-buffered raw text */
+  TemporalReaderBatch out[2];  /**< Double-buffered result batches */
+  int nextout;                 /**< Batch slot the consumer takes next */
+  bool eof;                    /**< The I/O thread has read the whole file */
+  bool finished;               /**< The parse thread has emitted all batches */
+  bool failed;                 /**< A read error occurred */
+  bool closing;                /**< The consumer is closing the reader */
+};
+
+/*****************************************************************************/
+
+/**
+ * @brief Ensure that a raw buffer can hold the given number of bytes plus a
+ * terminating null added by the parse thread
+ */
+static void
+temporal_reader_buffer_reserve(TemporalReaderBuffer *buf, size_t len)
+{
+  if (buf->size >= len + 1)
+    return;
+  size_t newsize = Max(len + 1, buf->size * 2);
+  buf->data = buf->data ?
+    repalloc(buf->data, newsize) : palloc(newsize);
+  buf->size = newsize;
+}
+
+/**
+ * @brief Main function of the I/O thread.
+ *
+ * The thread alternates between the two raw buffers, filling the empty one
+ * with chunks of the file while the parse thread works on the other. Every
+ * delivered buffer is cut at the last newline read; the remainder of the
+ * line is carried over into the next buffer.
+ */
+static void *
+temporal_reader_io(void *arg)
+{
+  TemporalReader *reader = (TemporalReader *) arg;
+  /* Partial last line carried over from the previous chunk */
+  char *tail = NULL;
+  size_t taillen = 0, tailsize = 0;
+  int next = 0;
+  bool eof = false, failed = false;
+  while (! eof && ! failed)
+  {
+    /* Wait until the next buffer slot is empty */
+    TemporalReaderBuffer *buf = &reader->buf[next];
+    pthread_mutex_lock(&reader->lock);
+    while (buf->full && ! reader->closing)
+      pthread_cond_wait(&reader->avail, &reader->lock);
+    bool closing = reader->closing;
+    pthread_mutex_unlock(&reader->lock);
+    if (closing)
+      break;
+
+    /* Fill the buffer with the pending partial line and fresh chunks until
+     * it contains at least one complete line or the file is exhausted */
+    buf->len = 0;
+    if (taillen > 0)
+    {
+      temporal_reader_buffer_reserve(buf, taillen);
+      memcpy(buf->data, tail, taillen);
+      buf->len = taillen;
+      taillen = 0;
+    }
+    size_t lastnl = 0;
+    bool haslines = false;
+    do
+    {
+      temporal_reader_buffer_reserve(buf, buf->len + MEOS_READER_CHUNK);
+      size_t nread = fread(buf->data + buf->len, 1, MEOS_READER_CHUNK,
+        reader->file);
+      buf->len += nread;
+      if (nread < MEOS_READER_CHUNK)
+      {
+        if (ferror(reader->file))
+        {
+          meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+            "Error while reading file: %s", strerror(errno));
+          failed = true;
+        }
+        else
+          eof = true;
+      }
+      for (size_t i = buf->len; i > 0; i--)
+      {
+        if (buf->data[i - 1] == '\n')
+        {
+          lastnl = i;
+          haslines = true;
+          break;
+        }
+      }
+    } while (! haslines && ! eof && ! failed);
+
+    /* Carry the partial last line over to the next buffer; at the end of
+     * the file a line without a final newline is delivered as is */
+    if (haslines && ! eof && lastnl < buf->len)
+    {
+      size_t rest = buf->len - lastnl;
+      if (tailsize < rest)
+      {
+        tail = tail ? repalloc(tail, rest) : palloc(rest);
+        tailsize = rest;
+      }
+      memcpy(tail, buf->data + lastnl, rest);
+      taillen = rest;
+      buf->len = lastnl;
+    }
+
+    /* Publish the buffer */
+    pthread_mutex_lock(&reader->lock);
+    if (buf->len > 0)
+      buf->full = true;
+    if (eof)
+      reader->eof = true;
+    if (failed)
+      reader->failed = true;
+    pthread_cond_broadcast(&reader->avail);
+    pthread_mutex_unlock(&reader->lock);
+    next = 1 - next;
+  }
+  if (tail)
+    pfree(tail);
+  return NULL;
+}
+
+/**
+ * @brief Publish a batch of parsed temporal values, waiting until a batch
+ * slot is free
+ * @return False when the reader is being closed and the batch was discarded
+ */
+static bool
+temporal_reader_publish(TemporalReader *reader, int *slot, Temporal **temps,
+  int count)
+{
+  pthread_mutex_lock(&reader->lock);
+  while (reader->out[*slot].full && ! reader->closing)
+    pthread_cond_wait(&reader->avail, &reader->lock);
+  if (reader->closing)
+  {
+    pthread_mutex_unlock(&reader->lock);
+    for (int i = 0; i < count; i++)
+      pfree(temps[i]);
+    pfree(temps);
+    return false;
+  }
+  reader->out[*slot].temps = temps;
+  reader->out[*slot].count = count;
+  reader->out[*slot].full = true;
+  pthread_cond_broadcast(&reader->avail);
+  pthread_mutex_unlock(&reader->lock);
+  *slot = 1 - *slot;
+  return true;
+}
+
+/**
+ * @brief Main function of the parse thread.
+ *
+ * The thread takes filled raw buffers from the I/O thread, splits them into
+ * lines, applies the parse function of the reader to every line, and
+ * publishes the resulting temporal values in batches of the requested size.
+ */
+static void *
+temporal_reader_parse(void *arg)
+{
+  TemporalReader *reader = (TemporalReader *) arg;
+  Temporal **temps = palloc(sizeof(Temporal *) * reader->batchsize);
+  int count = 0;
+  int next = 0, slot = 0;
+  bool stop = false;
+  while (! stop)
+  {
+    /* Wait until the next buffer is filled or the file is exhausted */
+    TemporalReaderBuffer *buf = &reader->buf[next];
+    pthread_mutex_lock(&reader->lock);
+    while (! buf->full && ! reader->eof && ! reader->failed &&
+        ! reader->closing)
+      pthread_cond_wait(&reader->avail, &reader->lock);
+    bool process = buf->full;
+    bool closing = reader->closing || reader->failed;
+    pthread_mutex_unlock(&reader->lock);
+    if (closing)
+      break;
+    if (! process)
+    {
+      /* End of file: flush the last batch and tell the consumer */
+      if (count > 0)
+        temporal_reader_publish(reader, &slot, temps, count);
+      else
+        pfree(temps);
+      temps = NULL;
+      pthread_mutex_lock(&reader->lock);
+      reader->finished = true;
+      pthread_cond_broadcast(&reader->avail);
+      pthread_mutex_unlock(&reader->lock);
+      break;
+    }
+
+    /* Split the buffer into lines and parse them; the buffer always has
+     * room for the terminating null (see temporal_reader_buffer_reserve) */
+    buf->data[buf->len] = '\0';
+    char *line = buf->data;
+    char *end = buf->data + buf->len;
+    while (line < end && ! stop)
+    {
+      char *eol = strchr(line, '\n');
+      if (eol)
+        *eol = '\0';
+      Temporal *temp = reader->parse(line, reader->context);
+      if (temp)
+      {
+        temps[count++] = temp;
+        if (count == reader->batchsize)
+        {
+          if (! temporal_reader_publish(reader, &slot, temps, count))
+          {
+            /* The reader is being closed, the batch has been discarded */
+            temps = NULL;
+            stop = true;
+            break;
+          }
+          temps = palloc(sizeof(Temporal *) * reader->batchsize);
+          count = 0;
+        }
+      }
+      line = eol ? eol + 1 : end;
+    }
+
+    /* Return the buffer to the I/O thread */
+    pthread_mutex_lock(&reader->lock);
+    buf->len = 0;
+    buf->full = false;
+    pthread_cond_broadcast(&reader->avail);
+    pthread_mutex_unlock(&reader->lock);
+    next = 1 - next;
+  }
+  if (temps)
+  {
+    for (int i = 0; i < count; i++)
+      pfree(temps[i]);
+    pfree(temps);
+  }
+  return NULL;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Open a text file for asynchronous reading of temporal values.
+ *
+ * The file is read and parsed ahead of the consumer by two background
+ * threads, so that calls to #temporal_reader_next overlap the disk and the
+ * parsing with the computation of the caller.
+ * @param[in] path Name of the file to read
+ * @param[in] parse Function converting one line of the file into a temporal
+ * value; it runs on a background thread and may return @p NULL to skip the
+ * line
+ * @param[in] context Context passed through to the parse function
+ * @param[in] batchsize Number of temporal values per batch
+ * @return On error return @p NULL
+ */
+TemporalReader *
+temporal_reader_open(const char *path, TemporalLineParseFn parse,
+  void *context, int batchsize)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) path) || ! ensure_not_null((void *) parse) ||
+      ! ensure_positive(batchsize))
+    return NULL;
+
+  FILE *file = fopen(path, "r");
+  if (! file)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot open file '%s': %s", path, strerror(errno));
+    return NULL;
+  }
+
+  TemporalReader *reader = palloc0(sizeof(TemporalReader));
+  reader->file = file;
+  reader->parse = parse;
+  reader->context = context;
+  reader->batchsize = batchsize;
+  pthread_mutex_init(&reader->lock, NULL);
+  pthread_cond_init(&reader->avail, NULL);
+  if (pthread_create(&reader->iothread, NULL, &temporal_reader_io, reader))
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "Cannot create the reader threads");
+    fclose(file);
+    pfree(reader);
+    return NULL;
+  }
+  if (pthread_create(&reader->parsethread, NULL, &temporal_reader_parse,
+        reader))
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "Cannot create the reader threads");
+    pthread_mutex_lock(&reader->lock);
+    reader->closing = true;
+    pthread_cond_broadcast(&reader->avail);
+    pthread_mutex_unlock(&reader->lock);
+    pthread_join(reader->iothread, NULL);
+    fclose(file);
+    pfree(reader);
+    return NULL;
+  }
+  return reader;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Return the next batch of temporal values of a temporal reader.
+ *
+ * The batches are returned in file order. The caller becomes the owner of
+ * the array and of the temporal values it contains and must free them.
+ * @param[in] reader Temporal reader
+ * @param[out] temparr Array of temporal values, @p NULL when the file is
+ * exhausted or on error
+ * @return Number of elements in the array, 0 when the file is exhausted,
+ * and -1 on error
+ */
+int
+temporal_reader_next(TemporalReader *reader, Temporal ***temparr)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) reader) ||
+      ! ensure_not_null((void *) temparr))
+    return -1;
+
+  *temparr = NULL;
+  pthread_mutex_lock(&reader->lock);
+  TemporalReaderBatch *out = &reader->out[reader->nextout];
+  while (! out->full && ! reader->finished && ! reader->failed)
+    pthread_cond_wait(&reader->avail, &reader->lock);
+  int result;
+  if (out->full)
+  {
+    *temparr = out->temps;
+    result = out->count;
+    out->temps = NULL;
+    out->count = 0;
+    out->full = false;
+    reader->nextout = 1 - reader->nextout;
+    pthread_cond_broadcast(&reader->avail);
+  }
+  else
+    result = reader->failed ? -1 : 0;
+  pthread_mutex_unlock(&reader->lock);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Close a temporal reader, stopping the background threads.
+ *
+ * Batches that have not been taken by the consumer are freed.
+ */
+void
+temporal_reader_close(TemporalReader *reader)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) reader))
+    return;
+  pthread_mutex_lock(&reader->lock);
+  reader->closing = true;
+  pthread_cond_broadcast(&reader->avail);
+  pthread_mutex_unlock(&reader->lock);
+  pthread_join(reader->iothread, NULL);
+  pthread_join(reader->parsethread, NULL);
+  for (int i = 0; i < 2; i++)
+  {
+    if (reader->buf[i].data)
+      pfree(reader->buf[i].data);
+    if (reader->out[i].temps)
+    {
+      for (int j = 0; j < reader->out[i].count; j++)
+        pfree(reader->out[i].temps[j]);
+      pfree(reader->out[i].temps);
+    }
+  }
+  pthread_cond_destroy(&reader->avail);
+  pthread_mutex_destroy(&reader->lock);
+  fclose(reader->file);
+  pfree(reader);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,282 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Memory-mapped read-only store of temporal values.
+ *
+ * A temporal store is a file holding a collection of temporal values in
+ * their in-memory (varlena) representation together with an offset index.
+ * Opening a store maps the file read-only into the address space, after
+ * which the temporal values are accessed directly in the mapping without
+ * parsing or copying, letting the operating system page cache do the work.
+ *
+ * Since the records are raw memory images, a store file is tied to the
+ * architecture that wrote it; the header records the endianness and the
+ * format version and the file is rejected on mismatch.
+ */
+
+#include "general/temporal.h"
+
+/* C */
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+/* POSIX */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+/* MEOS */
+#include <meos.h>
+
+/*****************************************************************************/
+
+/* Magic string identifying a temporal store file */
+#define MEOS_STORE_MAGIC "MEOSTSTO"
+/* Current version of the file format */
+#define MEOS_STORE_VERSION 1
+/* Value written in the header to detect an endianness mismatch when read */
+#define MEOS_STORE_ENDIAN 0x00010203
+/* Alignment of the records, which must be at least MAXIMUM_ALIGNOF */
+#define MEOS_STORE_ALIGN 8
+
+/**
+ * Header of a temporal store file
+ */
+typedef struct
+{
+  char magic[8];    /**< Magic string MEOS_STORE_MAGIC */
+  uint32 version;   /**< Version of the file format */
+  uint32 endian;    /**< Endianness check value MEOS_STORE_ENDIAN */
+  int64 count;      /**< Number of temporal values stored */
+  int64 idxoffset;  /**< Offset of the record offset index */
+} TemporalStoreHeader;
+
+/**
+ * Structure to represent an open temporal store; the offsets pointer refers
+ * directly into the mapping
+ */
+struct TemporalStore
+{
+  void *map;            /**< Read-only mapping of the file */
+  size_t size;          /**< Size of the mapping in bytes */
+  int64 count;          /**< Number of temporal values stored */
+  const int64 *offsets; /**< Array of record offsets in the mapping */
+};
+
+/*****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Write an array of temporal values into a temporal store file.
+ * @param[in] path Name of the file to write
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @return True on success
+ */
+bool
+temporal_store_write(const char *path, const Temporal **temparr, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) path) || ! ensure_not_null((void *) temparr) ||
+      ! ensure_positive(count))
+    return false;
+
+  FILE *file = fopen(path, "wb");
+  if (! file)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot create file '%s': %s", path, strerror(errno));
+    return false;
+  }
+
+  int64 *offsets = palloc(sizeof(int64) * count);
+  TemporalStoreHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, MEOS_STORE_MAGIC, sizeof(header.magic));
+  header.version = MEOS_STORE_VERSION;
+  header.endian = MEOS_STORE_ENDIAN;
+  header.count = count;
+  /* The index offset is backpatched once the records are written */
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  int64 pos = sizeof(header);
+  static const char zeroes[MEOS_STORE_ALIGN] = { 0 };
+  for (int i = 0; ok && i < count; i++)
+  {
+    /* Pad to the record alignment */
+    int pad = (int) (pos % MEOS_STORE_ALIGN);
+    if (pad != 0)
+    {
+      pad = MEOS_STORE_ALIGN - pad;
+      ok = fwrite(zeroes, 1, pad, file) == (size_t) pad;
+      pos += pad;
+    }
+    offsets[i] = pos;
+    size_t size = VARSIZE(temparr[i]);
+    ok = ok && fwrite(temparr[i], 1, size, file) == size;
+    pos += size;
+  }
+  header.idxoffset = pos;
+  ok = ok && fwrite(offsets, sizeof(int64), count, file) == (size_t) count;
+  /* Backpatch the header with the index offset */
+  ok = ok && fseek(file, 0, SEEK_SET) == 0 &&
+    fwrite(&header, sizeof(header), 1, file) == 1;
+  pfree(offsets);
+  if (fclose(file) != 0)
+    ok = false;
+  if (! ok)
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot write file '%s': %s", path, strerror(errno));
+  return ok;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Open a temporal store file and map it read-only into memory.
+ * @param[in] path Name of the file to open
+ * @return On error return @p NULL
+ */
+TemporalStore *
+temporal_store_open(const char *path)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) path))
+    return NULL;
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot open file '%s': %s", path, strerror(errno));
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(TemporalStoreHeader))
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "File '%s' is not a temporal store", path);
+    close(fd);
+    return NULL;
+  }
+  void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  /* The mapping keeps its own reference to the file */
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot map file '%s': %s", path, strerror(errno));
+    return NULL;
+  }
+
+  const TemporalStoreHeader *header = (const TemporalStoreHeader *) map;
+  if (memcmp(header->magic, MEOS_STORE_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != MEOS_STORE_VERSION ||
+      header->endian != MEOS_STORE_ENDIAN ||
+      header->count <= 0 || header->idxoffset < (int64) sizeof(*header) ||
+      header->idxoffset + header->count * (int64) sizeof(int64) >
+        (int64) st.st_size)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "File '%s' is not a temporal store for this platform", path);
+    munmap(map, st.st_size);
+    return NULL;
+  }
+
+  TemporalStore *store = palloc(sizeof(TemporalStore));
+  store->map = map;
+  store->size = st.st_size;
+  store->count = header->count;
+  store->offsets = (const int64 *) ((const char *) map + header->idxoffset);
+  return store;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Return the number of temporal values in a temporal store.
+ */
+int
+temporal_store_count(const TemporalStore *store)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store))
+    return -1;
+  return (int) store->count;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Return the n-th temporal value of a temporal store.
+ *
+ * The result points directly into the read-only mapping: it must not be
+ * modified or freed and is only valid until the store is closed. Use
+ * temporal_copy() to obtain a private copy that outlives the store.
+ *
+ * @param[in] store Temporal store
+ * @param[in] index Record number, from 0 to the count of the store minus 1
+ * @return On error return @p NULL
+ */
+const Temporal *
+temporal_store_read(const TemporalStore *store, int index)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store))
+    return NULL;
+  if (index < 0 || index >= store->count)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Record number out of range: %d", index);
+    return NULL;
+  }
+  int64 offset = store->offsets[index];
+  if (offset < 0 || offset >= (int64) store->size)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Temporal store is corrupted: offset %lld out of bounds",
+      (long long) offset);
+    return NULL;
+  }
+  return (const Temporal *) ((const char *) store->map + offset);
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Close a temporal store and unmap the file.
+ */
+void
+temporal_store_close(TemporalStore *store)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store))
+    return;
+  munmap(store->map, store->size);
+  pfree(store);
+}
+
+/*****************************************************************************/
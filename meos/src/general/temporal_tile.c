@@ -295,6 +295,61 @@ interval_units(const Interval *interval)
   return interval->time + (interval->day * USECS_PER_DAY);
 }
 
+/*****************************************************************************
+ * Cache of validated durations
+ *****************************************************************************/
+
+/**
+ * Number of entries of the duration cache
+ */
+#define DURATION_CACHE_SIZE 4
+
+/**
+ * Thread-local cache of the last durations converted to time units
+ *
+ * The tile functions are typically executed many times with the same
+ * duration argument, for example, once per row of a prepared statement, and
+ * every call validated the interval and derived its width in time units
+ * anew. The cache remembers the last few durations seen by the thread so
+ * that repeated calls skip this setup. Entries are replaced with a
+ * least-recently-used policy driven by a use stamp; a zero stamp denotes a
+ * free entry.
+ */
+static __thread Interval duration_cache_key[DURATION_CACHE_SIZE];
+static __thread int64 duration_cache_tunits[DURATION_CACHE_SIZE];
+static __thread uint64 duration_cache_stamp[DURATION_CACHE_SIZE];
+static __thread uint64 duration_cache_clock = 0;
+
+/**
+ * @brief Return the width in time units of the buckets defined by a
+ * duration, validating the duration and caching the result
+ * @return On error return 0
+ */
+int64
+interval_units_checked(const Interval *duration)
+{
+  int lru = 0;
+  for (int i = 0; i < DURATION_CACHE_SIZE; i++)
+  {
+    if (duration_cache_stamp[i] &&
+        duration_cache_key[i].time == duration->time &&
+        duration_cache_key[i].day == duration->day &&
+        duration_cache_key[i].month == duration->month)
+    {
+      duration_cache_stamp[i] = ++duration_cache_clock;
+      return duration_cache_tunits[i];
+    }
+    if (duration_cache_stamp[i] < duration_cache_stamp[lru])
+      lru = i;
+  }
+  if (! ensure_valid_duration(duration))
+    return 0;
+  duration_cache_key[lru] = *duration;
+  duration_cache_tunits[lru] = interval_units(duration);
+  duration_cache_stamp[lru] = ++duration_cache_clock;
+  return duration_cache_tunits[lru];
+}
+
 /**
  * @brief Return the initial timestamp of the bucket in which a timestamp falls
  * @param[in] t Input timestamp
@@ -359,10 +414,10 @@ timestamptz_bucket1(TimestampTz t, int64 size, TimestampTz origin)
 TimestampTz
 timestamptz_bucket(TimestampTz t, const Interval *duration, TimestampTz origin)
 {
-  /* Ensure validity of the arguments */
-  if (! ensure_valid_duration(duration))
+  /* Validate the duration and derive its width through the duration cache */
+  int64 size = interval_units_checked(duration);
+  if (! size)
     return DT_NOEND;
-  int64 size = interval_units(duration);
   return timestamptz_bucket1(t, size, origin);
 }
 
@@ -495,11 +550,11 @@ period_bucket_list(const Span *s, const Interval *duration, TimestampTz origin,
 {
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) s) || ! ensure_span_has_type(s, T_TSTZSPAN) ||
-      ! ensure_not_null((void *) count) ||
-      ! ensure_valid_duration(duration))
+      ! ensure_not_null((void *) count))
+    return NULL;
+  int64 tunits = interval_units_checked(duration);
+  if (! tunits)
     return NULL;
-
-  int64 tunits = interval_units(duration);
   TimestampTz start_time = DatumGetTimestampTz(s->lower);
   TimestampTz end_time = DatumGetTimestampTz(s->upper);
   TimestampTz start_time_bucket = timestamptz_bucket(start_time, duration,
@@ -1076,8 +1131,10 @@ temporal_time_split(Temporal *temp, Interval *duration, TimestampTz torigin,
   TimestampTz **buckets, int *count)
 {
   /* Ensure validity of the arguments */
-  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) count) ||
-      ! ensure_valid_duration(duration))
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) count))
+    return NULL;
+  int64 tunits = interval_units_checked(duration);
+  if (! tunits)
     return NULL;
 
   Datum start_bucket, end_bucket;
@@ -1085,12 +1142,343 @@ temporal_time_split(Temporal *temp, Interval *duration, TimestampTz torigin,
   temporal_set_period(temp, &s);
   int nbuckets = period_no_buckets(&s, duration, torigin, &start_bucket,
     &end_bucket);
-  int64 tunits = interval_units(duration);
   return temporal_time_split1(temp, DatumGetTimestampTz(start_bucket),
     DatumGetTimestampTz(end_bucket), tunits, torigin, nbuckets, buckets,
     count);
 }
 
+/*****************************************************************************
+ * Streaming version of the time split
+ *
+ * The functions above materialize all the fragments of the split before the
+ * first one can be consumed, so splitting a long temporal value over a fine
+ * time grid needs memory proportional to the whole input plus the
+ * per-fragment overhead. The state below produces the fragments one bucket
+ * at a time with the same boundary semantics as #temporal_time_split: only
+ * the instants of the current bucket, the boundary instant carried between
+ * consecutive buckets, and at most one fragment produced ahead of time are
+ * resident.
+ *****************************************************************************/
+
+/**
+ * @brief Set the state to scan the given sequence, skipping the empty
+ * buckets before it
+ */
+static void
+time_split_state_load_seq(TimeSplitState *state, const TSequence *seq)
+{
+  state->seq = seq;
+  state->i = 0;
+  state->nfrags = 0;
+  state->upper = state->lower + state->tunits;
+  /* Filter the unnecesary time buckets before the sequence; the upper bound
+   * for the bucket is exclusive => the test below is >= */
+  while (state->lower < state->end &&
+    (DatumGetTimestampTz(seq->period.lower) >= state->upper ||
+     state->lower > DatumGetTimestampTz(seq->period.upper) ||
+     (state->lower == DatumGetTimestampTz(seq->period.upper) &&
+      ! seq->period.upper_inc)))
+  {
+    state->lower = state->upper;
+    state->upper += state->tunits;
+  }
+  /* Ensure the scratch array can hold the instants of a bucket plus the
+   * carried and the closing boundary instants */
+  if (state->maxinsts < seq->count + 2)
+  {
+    state->maxinsts = seq->count + 2;
+    state->instants = state->instants ?
+      repalloc(state->instants, sizeof(TInstant *) * state->maxinsts) :
+      palloc(sizeof(TInstant *) * state->maxinsts);
+  }
+  return;
+}
+
+/**
+ * @brief Produce the next fragment of the continuous sequence being scanned
+ * (see #tsequence_time_split_iter for the non-streaming version)
+ * @param[in,out] state Split state
+ * @param[out] time Start timestamp of the bucket containing the fragment
+ * @return @p NULL when the sequence is exhausted; the state then resets
+ * @p state->seq so that the caller loads the next composing sequence
+ */
+static TSequence *
+time_split_state_next_cont(TimeSplitState *state, TimestampTz *time)
+{
+  const TSequence *seq = state->seq;
+  const TInstant **instants = state->instants;
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  int ninsts = 0;
+  /* Reuse the end value of the previous bucket for the beginning of the
+   * bucket */
+  if (state->carry)
+    instants[ninsts++] = state->carry;
+  TInstant *closing = NULL;
+  while (state->i < seq->count)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, state->i);
+    if ((state->lower <= inst->t && inst->t < state->upper) ||
+      (inst->t == state->upper &&
+       (interp == LINEAR || state->i == seq->count - 1)))
+    {
+      instants[ninsts++] = inst;
+      state->i++;
+    }
+    else
+    {
+      assert(ninsts > 0);
+      /* Compute the value at the end of the bucket */
+      if (instants[ninsts - 1]->t < state->upper)
+      {
+        if (interp == LINEAR)
+          closing = tsegment_at_timestamp(instants[ninsts - 1], inst, interp,
+            state->upper);
+        else
+        {
+          /* The last two values of sequences with step interpolation and
+           * exclusive upper bound must be equal */
+          Datum value = tinstant_value(instants[ninsts - 1]);
+          closing = tinstant_make(value, seq->temptype, state->upper);
+        }
+        instants[ninsts++] = closing;
+      }
+      bool lower_inc1 = (state->nfrags == 0) ? seq->period.lower_inc : true;
+      *time = state->lower;
+      TSequence *result = tsequence_make(instants, ninsts, lower_inc1,
+        (ninsts > 1) ? false : true, interp, NORMALIZE);
+      state->nfrags++;
+      /* Move to the next bucket */
+      state->lower = state->upper;
+      state->upper += state->tunits;
+      bool finished = state->lower >= state->end ||
+        ! contains_period_timestamp(&seq->period, state->lower);
+      /* Carry the end value of the bucket to the beginning of the next one;
+       * the carried instant is owned by the state since the fragment it
+       * comes from is handed over to the caller */
+      TInstant *carry = NULL;
+      if (! finished && state->lower < inst->t)
+        carry = closing ? closing : tinstant_copy(instants[ninsts - 1]);
+      else if (closing)
+        pfree(closing);
+      if (state->carry)
+        pfree(state->carry);
+      state->carry = carry;
+      if (finished)
+      {
+        /* Realign the bucket on the fragment just output so that the next
+         * sequence of a sequence set may accumulate into the same bucket */
+        state->lower = *time;
+        state->seq = NULL;
+      }
+      return result;
+    }
+  }
+  /* Output the last fragment of the sequence (if any) */
+  if (state->carry)
+  {
+    pfree(state->carry);
+    state->carry = NULL;
+  }
+  state->seq = NULL;
+  if (ninsts == 0)
+    return NULL;
+  bool lower_inc1 = (state->nfrags == 0) ? seq->period.lower_inc : true;
+  *time = state->lower;
+  return tsequence_make(instants, ninsts, lower_inc1, seq->period.upper_inc,
+    interp, NORMALIZE);
+}
+
+/**
+ * @brief Produce the next fragment of a discrete sequence (see
+ * #tnumberseq_disc_time_split for the non-streaming version)
+ */
+static TSequence *
+time_split_state_next_disc(TimeSplitState *state, TimestampTz *time)
+{
+  const TSequence *seq = state->seq;
+  const TInstant **instants = state->instants;
+  if (state->i >= seq->count)
+    return NULL;
+  /* Skip the empty buckets before the next instant */
+  const TInstant *inst = TSEQUENCE_INST_N(seq, state->i);
+  while (inst->t >= state->upper)
+  {
+    state->lower = state->upper;
+    state->upper += state->tunits;
+  }
+  /* Gather the instants of the bucket */
+  int ninsts = 0;
+  while (state->i < seq->count)
+  {
+    inst = TSEQUENCE_INST_N(seq, state->i);
+    if (inst->t >= state->upper)
+      break;
+    instants[ninsts++] = inst;
+    state->i++;
+  }
+  *time = state->lower;
+  return tsequence_make(instants, ninsts, true, true, DISCRETE, NORMALIZE_NO);
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_tile
+ * @brief Create the state for splitting a temporal value into fragments with
+ * respect to period buckets, one bucket at a time
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @return On error return @p NULL
+ * @sqlfunc timeSplit()
+ */
+TimeSplitState *
+time_split_state_make(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp))
+    return NULL;
+  int64 tunits = interval_units_checked(duration);
+  if (! tunits)
+    return NULL;
+
+  Datum start_bucket, end_bucket;
+  Span s;
+  temporal_set_period(temp, &s);
+  period_no_buckets(&s, duration, torigin, &start_bucket, &end_bucket);
+  TimeSplitState *state = palloc0(sizeof(TimeSplitState));
+  state->tunits = tunits;
+  state->torigin = torigin;
+  state->end = DatumGetTimestampTz(end_bucket);
+  state->temp = temp;
+  state->lower = DatumGetTimestampTz(start_bucket);
+  state->upper = state->lower + state->tunits;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TSEQUENCE)
+  {
+    const TSequence *seq = (const TSequence *) temp;
+    if (MEOS_FLAGS_DISCRETE_INTERP(temp->flags))
+    {
+      state->seq = seq;
+      state->maxinsts = seq->count;
+      state->instants = palloc(sizeof(TInstant *) * state->maxinsts);
+    }
+    else
+      time_split_state_load_seq(state, seq);
+  }
+  else if (temp->subtype == TSEQUENCESET)
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    state->fragments = palloc(sizeof(TSequence *) * ss->count);
+  }
+  return state;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_tile
+ * @brief Produce the fragment of the next non-empty time bucket
+ * @param[in,out] state Split state
+ * @param[out] time Start timestamp of the bucket containing the fragment
+ * @return @p NULL when all the fragments have been produced
+ * @sqlfunc timeSplit()
+ */
+Temporal *
+time_split_state_next(TimeSplitState *state, TimestampTz *time)
+{
+  assert(state); assert(time);
+  if (state->done)
+    return NULL;
+
+  const Temporal *temp = state->temp;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+  {
+    const TInstant *inst = (const TInstant *) temp;
+    *time = timestamptz_bucket1(inst->t, state->tunits, state->torigin);
+    state->done = true;
+    return (Temporal *) tinstant_copy(inst);
+  }
+  else if (temp->subtype == TSEQUENCE)
+  {
+    TSequence *result = MEOS_FLAGS_DISCRETE_INTERP(temp->flags) ?
+      time_split_state_next_disc(state, time) :
+      time_split_state_next_cont(state, time);
+    if (! result)
+      state->done = true;
+    return (Temporal *) result;
+  }
+
+  /* temp->subtype == TSEQUENCESET: accumulate the fragments of the
+   * composing sequences that fall into the same time bucket */
+  const TSequenceSet *ss = (const TSequenceSet *) temp;
+  /* Start with the fragment of the next bucket saved by the previous call */
+  if (state->pending)
+  {
+    state->fragments[0] = state->pending;
+    state->nfragments = 1;
+    state->acctime = state->pendingtime;
+    state->pending = NULL;
+  }
+  while (true)
+  {
+    if (state->seq == NULL)
+    {
+      if (state->seqno == ss->count)
+        break;
+      time_split_state_load_seq(state, TSEQUENCESET_SEQ_N(ss, state->seqno++));
+    }
+    TimestampTz ftime;
+    TSequence *frag = time_split_state_next_cont(state, &ftime);
+    if (frag == NULL)
+      continue;
+    if (state->nfragments > 0 && ftime != state->acctime)
+    {
+      /* The fragment starts the next bucket: save it and output the
+       * accumulated bucket */
+      state->pending = frag;
+      state->pendingtime = ftime;
+      break;
+    }
+    state->fragments[state->nfragments++] = frag;
+    state->acctime = ftime;
+  }
+  if (state->nfragments == 0)
+  {
+    state->done = true;
+    return NULL;
+  }
+  TSequenceSet *result = tsequenceset_make(
+    (const TSequence **) state->fragments, state->nfragments, NORMALIZE);
+  for (int j = 0; j < state->nfragments; j++)
+    pfree(state->fragments[j]);
+  state->nfragments = 0;
+  *time = state->acctime;
+  return (Temporal *) result;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics_tile
+ * @brief Free the state of the streaming time split
+ */
+void
+time_split_state_free(TimeSplitState *state)
+{
+  assert(state);
+  if (state->instants)
+    pfree(state->instants);
+  if (state->carry)
+    pfree(state->carry);
+  if (state->pending)
+    pfree(state->pending);
+  if (state->fragments)
+  {
+    for (int j = 0; j < state->nfragments; j++)
+      pfree(state->fragments[j]);
+    pfree(state->fragments);
+  }
+  pfree(state);
+  return;
+}
+
 /*****************************************************************************
  * Value split functions for temporal numbers
  *****************************************************************************/
@@ -51,6 +51,7 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/pg_types.h"
+#include "general/set.h"
 #include "general/spanset.h"
 #include "general/temporaltypes.h"
 #include "general/type_parser.h"
@@ -244,6 +245,19 @@ tinstant_to_string(const TInstant *inst, int maxdd, outfunc value_out)
   assert(inst);
   assert(maxdd >= 0);
 
+  /* Write the value and the timestamp directly into the result when the
+   * base type has a buffer-writing output function */
+  if (value_out == &basetype_out)
+  {
+    size_t size = tinstant_to_string_size(inst, maxdd);
+    if (size)
+    {
+      char *result = palloc(size);
+      tinstant_to_string_buf(result, inst, maxdd);
+      return result;
+    }
+  }
+
   char *t = pg_timestamptz_out(inst->t);
   meosType basetype = temptype_basetype(inst->temptype);
   char *value = value_out(tinstant_value(inst), basetype, maxdd);
@@ -254,6 +268,44 @@ tinstant_to_string(const TInstant *inst, int maxdd, outfunc value_out)
   return result;
 }
 
+/**
+ * @brief Return the maximum size in bytes of the Well-Known Text (WKT)
+ * representation of a temporal instant, including the terminating NUL, or 0
+ * when the base type has no buffer-writing output function
+ */
+size_t
+tinstant_to_string_size(const TInstant *inst, int maxdd)
+{
+  assert(inst);
+  size_t size = basetype_out_size(tinstant_value(inst),
+    temptype_basetype(inst->temptype), maxdd);
+  if (size == 0)
+    return 0;
+  return size + basetype_out_size(TimestampTzGetDatum(inst->t),
+    T_TIMESTAMPTZ, 0) + 1; /* '@' */
+}
+
+/**
+ * @brief Write the Well-Known Text (WKT) representation of a temporal
+ * instant into the buffer
+ * @return Number of characters written, not including the terminating NUL
+ * @note The caller must have verified with #tinstant_to_string_size that the
+ * base type has a buffer-writing output function and sized the buffer
+ * accordingly
+ */
+size_t
+tinstant_to_string_buf(char *output, const TInstant *inst, int maxdd)
+{
+  assert(inst);
+  char *ptr = output;
+  ptr += basetype_out_buf(ptr, tinstant_value(inst),
+    temptype_basetype(inst->temptype), maxdd);
+  *ptr++ = '@';
+  ptr += basetype_out_buf(ptr, TimestampTzGetDatum(inst->t),
+    T_TIMESTAMPTZ, 0);
+  return (ptr - output);
+}
+
 /**
  * @ingroup libmeos_internal_temporal_inout
  * @brief Return the Well-Known Text (WKT) representation of a temporal instant.
@@ -307,11 +359,17 @@ tinstant_make(Datum value, meosType temptype, TimestampTz t)
   }
   else
   {
-    /* For base types passed by reference */
+    /* For base types passed by reference the value is copied at its exact
+     * size. The padding bytes that double-align consecutive instants are
+     * only needed inside a sequence, where they are added by the sequence
+     * constructors. A standalone instant is kept unpadded so that its
+     * varlena size is minimal: in PostgreSQL this lets more instant values
+     * be stored with a short one-byte header, increasing the tuple density
+     * of tables of single instants */
     int16 typlen = basetype_length(basetype);
     value_from = DatumGetPointer(value);
-    value_size = (typlen != -1) ? DOUBLE_PAD((unsigned int) typlen) :
-      DOUBLE_PAD(VARSIZE(value_from));
+    value_size = (typlen != -1) ? (unsigned int) typlen :
+      VARSIZE(value_from);
   }
   size += value_size;
   TInstant *result = palloc0(size);
@@ -712,14 +770,10 @@ tinstant_restrict_value(const TInstant *inst, Datum value, bool atfunc)
 bool
 tinstant_restrict_values_test(const TInstant *inst, const Set *s, bool atfunc)
 {
-  Datum value = tinstant_value(inst);
-  meosType basetype = temptype_basetype(inst->temptype);
-  for (int i = 0; i < s->count; i++)
-  {
-    if (datum_eq(value, SET_VAL_N(s, i), basetype))
-      return atfunc ? true : false;
-  }
-  return atfunc ? false : true;
+  /* The values of a set are sorted, probe with a binary search */
+  int loc;
+  bool found = set_find_value(s, tinstant_value(inst), &loc);
+  return atfunc ? found : ! found;
 }
 
 /**
@@ -47,6 +47,7 @@
 #include <meos_internal.h>
 #include "general/lifting.h"
 #include "general/pg_types.h"
+#include "general/temporal_boxops.h"
 #include "general/temporaltypes.h"
 #include "general/type_util.h"
 
@@ -209,6 +210,82 @@ tnumber_div_tp_at_timestamp(const TInstant *start1, const TInstant *end1,
     value, t);
 }
 
+/*****************************************************************************
+ * Specialized arithmetic on a temporal number and a base value
+ *
+ * The lifting machinery dispatches every value of the temporal number
+ * through the function pointers of LiftedFunctionInfo. For the hot
+ * same-type combinations -- tfloat x float8 and tint x int4 -- the
+ * instantiations expanded from the template below copy the temporal value,
+ * apply the operation directly on the instant values so that they stay in
+ * registers, and recompute the bounding boxes.
+ *
+ * Applying the operation instant by instant is exact also for linear
+ * interpolation since adding, subtracting, multiplying, or dividing by a
+ * constant maps linear segments to linear segments.
+ *****************************************************************************/
+
+#define TNUMBER_ARITHOP_SPECIALIZE(fname, ctype, DATUM_GET, DATUM_SET) \
+  static inline ctype \
+  fname##_apply(ctype v1, ctype v2, TArithmetic oper) \
+  { \
+    if (oper == ADD) \
+      return v1 + v2; \
+    if (oper == SUB) \
+      return v1 - v2; \
+    if (oper == MULT) \
+      return v1 * v2; \
+    return v1 / v2; /* oper == DIV */ \
+  } \
+  \
+  static void \
+  fname##_instants(TSequence *seq, ctype value, TArithmetic oper, \
+    bool invert) \
+  { \
+    for (int i = 0; i < seq->count; i++) \
+    { \
+      TInstant *inst = (TInstant *) TSEQUENCE_INST_N(seq, i); \
+      ctype v1 = DATUM_GET(inst->value); \
+      inst->value = DATUM_SET(invert ? fname##_apply(value, v1, oper) : \
+        fname##_apply(v1, value, oper)); \
+    } \
+    tsequence_compute_bbox(seq); \
+    return; \
+  } \
+  \
+  static Temporal * \
+  fname(const Temporal *temp, Datum value, TArithmetic oper, bool invert) \
+  { \
+    ctype v2 = DATUM_GET(value); \
+    Temporal *result = temporal_copy(temp); \
+    assert(temptype_subtype(result->subtype)); \
+    if (result->subtype == TINSTANT) \
+    { \
+      TInstant *inst = (TInstant *) result; \
+      ctype v1 = DATUM_GET(inst->value); \
+      inst->value = DATUM_SET(invert ? fname##_apply(v2, v1, oper) : \
+        fname##_apply(v1, v2, oper)); \
+    } \
+    else if (result->subtype == TSEQUENCE) \
+      fname##_instants((TSequence *) result, v2, oper, invert); \
+    else /* result->subtype == TSEQUENCESET */ \
+    { \
+      TSequenceSet *ss = (TSequenceSet *) result; \
+      for (int i = 0; i < ss->count; i++) \
+        fname##_instants((TSequence *) TSEQUENCESET_SEQ_N(ss, i), v2, oper, \
+          invert); \
+      tsequenceset_compute_bbox(ss); \
+    } \
+    return result; \
+  }
+
+TNUMBER_ARITHOP_SPECIALIZE(tint_int_arithop, int32, DatumGetInt32,
+  Int32GetDatum)
+#ifdef USE_FLOAT8_BYVAL
+TNUMBER_ARITHOP_SPECIALIZE(tfloat_float_arithop, double, DatumGetFloat8,
+  Float8GetDatum)
+#endif /* USE_FLOAT8_BYVAL */
+
 /*****************************************************************************
  * Generic functions
  *****************************************************************************/
@@ -251,6 +328,14 @@ arithop_tnumber_number(const Temporal *temp, Datum value, meosType basetype,
     }
   }
 
+  /* Specialized instantiations for the hot same-type combinations */
+  if (temp->temptype == T_TINT && basetype == T_INT4)
+    return tint_int_arithop(temp, value, oper, invert);
+#ifdef USE_FLOAT8_BYVAL
+  if (temp->temptype == T_TFLOAT && basetype == T_FLOAT8)
+    return tfloat_float_arithop(temp, value, oper, invert);
+#endif /* USE_FLOAT8_BYVAL */
+
   LiftedFunctionInfo lfinfo;
   memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
   lfinfo.func = (varfunc) func;
@@ -321,6 +406,169 @@ arithop_tnumber_tnumber(const Temporal *temp1, const Temporal *temp2,
   return result;
 }
 
+/*****************************************************************************
+ * Prepared arithmetic operations
+ *
+ * Streaming applications evaluate the same few arithmetic operations over
+ * every incoming temporal value. The entry points above rebuild the lifted
+ * function descriptor and redo the catalog lookups and dispatch decisions
+ * on every call. A prepared operation factors that setup out: the handle is
+ * built once from the operator and the argument types and can then be
+ * applied to any number of temporal values.
+ *****************************************************************************/
+
+/**
+ * @brief Prepare an arithmetic operation on a temporal number and a number
+ * @param[in] temptype Temporal type of the temporal argument
+ * @param[in] basetype Base type of the number argument
+ * @param[in] oper Enumeration that states the arithmetic operator
+ * @param[in] invert True if the number is the first argument of the
+ * function
+ * @return On error return NULL
+ */
+TNumberArithOp *
+tnumber_arithop_make(meosType temptype, meosType basetype, TArithmetic oper,
+  bool invert)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_tnumber_type(temptype))
+    return NULL;
+  if (temptype_basetype(temptype) != basetype)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The temporal type and the base type are not compatible");
+    return NULL;
+  }
+  Datum (*func)(Datum, Datum, meosType);
+  switch (oper)
+  {
+    case ADD:
+      func = &datum_add;
+      break;
+    case SUB:
+      func = &datum_sub;
+      break;
+    case MULT:
+      func = &datum_mult;
+      break;
+    case DIV:
+      func = &datum_div;
+      break;
+    default:
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Unknown arithmetic operator: %d", oper);
+      return NULL;
+  }
+
+  TNumberArithOp *op = palloc0(sizeof(TNumberArithOp));
+  op->oper = oper;
+  op->temptype = temptype;
+  op->basetype = basetype;
+  op->invert = invert;
+  op->specialized = (temptype == T_TINT && basetype == T_INT4);
+#ifdef USE_FLOAT8_BYVAL
+  op->specialized |= (temptype == T_TFLOAT && basetype == T_FLOAT8);
+#endif /* USE_FLOAT8_BYVAL */
+  LiftedFunctionInfo *lfinfo = &op->lfinfo;
+  lfinfo->func = (varfunc) func;
+  lfinfo->numparam = 0;
+  lfinfo->args = true;
+  lfinfo->argtype[0] = temptype_basetype(temptype);
+  lfinfo->argtype[1] = basetype;
+  lfinfo->restype = (temptype == T_TINT && basetype == T_INT4) ?
+    T_TINT : T_TFLOAT;
+  /* This parameter is not used for temp <op> base */
+  lfinfo->reslinear = false;
+  lfinfo->invert = invert;
+  lfinfo->discont = CONTINUOUS;
+  lfinfo->tpfunc_base = NULL;
+  lfinfo->tpfunc = NULL;
+  return op;
+}
+
+/**
+ * @brief Apply a prepared arithmetic operation to a temporal number and a
+ * number
+ * @param[in] op Prepared arithmetic operation
+ * @param[in] temp Temporal number
+ * @param[in] value Number
+ * @return On error return NULL
+ */
+Temporal *
+tnumber_arithop_apply(const TNumberArithOp *op, const Temporal *temp,
+  Datum value)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) op) || ! ensure_not_null((void *) temp) ||
+      ! ensure_temporal_has_type(temp, op->temptype))
+    return NULL;
+  /* If division test whether the denominator is zero */
+  if (op->oper == DIV)
+  {
+    if (op->invert)
+    {
+      if (temporal_ever_eq(temp, Float8GetDatum(0.0)))
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE, "Division by zero");
+        return NULL;
+      }
+    }
+    else
+    {
+      double d = datum_double(value, op->basetype);
+      if (fabs(d) < MEOS_EPSILON)
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE, "Division by zero");
+        return NULL;
+      }
+    }
+  }
+
+  if (op->specialized)
+  {
+    if (op->temptype == T_TINT)
+      return tint_int_arithop(temp, value, op->oper, op->invert);
+#ifdef USE_FLOAT8_BYVAL
+    return tfloat_float_arithop(temp, value, op->oper, op->invert);
+#endif /* USE_FLOAT8_BYVAL */
+  }
+
+  /* The lifted machinery receives a writable descriptor; apply on a copy so
+   * that the handle stays reusable */
+  LiftedFunctionInfo lfinfo = op->lfinfo;
+  return tfunc_temporal_base(temp, value, &lfinfo);
+}
+
+/**
+ * @brief Apply a prepared arithmetic operation to an array of temporal
+ * numbers and a number
+ * @param[in] op Prepared arithmetic operation
+ * @param[in] temparr Array of temporal numbers
+ * @param[in] count Number of elements in the array
+ * @param[in] value Number
+ * @return Array of temporal values, with a NULL element where the operation
+ * failed. On error return NULL
+ */
+Temporal **
+tnumber_arithop_apply_batch(const TNumberArithOp *op, const Temporal **temparr,
+  int count, Datum value)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) op) || ! ensure_not_null((void *) temparr) ||
+      ! ensure_positive(count))
+    return NULL;
+  /* Division and the specialized instantiations keep per-element dispatch */
+  if (op->oper == DIV || op->specialized)
+  {
+    Temporal **result = palloc(sizeof(Temporal *) * count);
+    for (int i = 0; i < count; i++)
+      result[i] = tnumber_arithop_apply(op, temparr[i], value);
+    return result;
+  }
+  LiftedFunctionInfo lfinfo = op->lfinfo;
+  return tfunc_temporal_base_batch(temparr, count, value, &lfinfo);
+}
+
 /*****************************************************************************
  * Absolute value
  *****************************************************************************/
@@ -446,10 +694,11 @@ tnumberseqset_abs(const TSequenceSet *ss)
   assert(ss);
   assert(tnumber_type(ss->temptype));
   TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(ss->flags);
   for (int i = 0; i < ss->count; i++)
   {
     const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
-    sequences[i] = MEOS_FLAGS_LINEAR_INTERP(ss->flags) ?
+    sequences[i] = linear ?
       tnumberseq_linear_abs(seq) : tnumberseq_iter_abs(seq);
   }
   return tsequenceset_make_free(sequences, ss->count, NORMALIZE);
@@ -57,6 +57,7 @@
 #include "general/pg_types.h"
 #include "general/set.h"
 #include "general/spanset.h"
+#include "general/stats.h"
 #include "general/temporaltypes.h"
 #include "general/temporal_boxops.h"
 #include "general/tnumber_distance.h"
@@ -428,6 +429,60 @@ tsequence_join(const TSequence *seq1, const TSequence *seq2,
  * General functions
  *****************************************************************************/
 
+/**
+ * @brief Return the index of the first instant of a temporal sequence whose
+ * timestamp is not less than a given one, or the number of instants when all
+ * of them are before it
+ *
+ * The probe-dependent branch of the textbook binary search is replaced by a
+ * conditional move on the base index, so the repeated searches issued by the
+ * synchronization loops do not pay a branch misprediction per probe.
+ */
+static int
+tsequence_timestamp_lower_bound(const TSequence *seq, TimestampTz t)
+{
+  int base = 0;
+  int n = seq->count;
+  /* Narrow the search window with the skip index when it is present, so that
+   * the search over the scattered instants below touches at most
+   * MEOS_SKIP_INDEX_STEP of them */
+  if (MEOS_FLAGS_GET_TIMES(seq->flags))
+  {
+    const TimestampTz *times = TSEQUENCE_TIMES_PTR(seq);
+    int nidx = MEOS_SKIP_INDEX_COUNT(seq->count);
+    int sbase = 0;
+    int sn = nidx;
+    while (sn > 1)
+    {
+      int half = sn / 2;
+      sbase = (times[sbase + half - 1] < t) ? sbase + half : sbase;
+      sn -= half;
+    }
+    if (times[sbase] < t)
+      sbase++;
+    /* sbase is the first entry of the skip index that is not less than the
+     * timestamp, or nidx when all of them are less */
+    if (sbase == 0)
+      /* The first instant is not less than the timestamp */
+      return 0;
+    base = (sbase - 1) * MEOS_SKIP_INDEX_STEP + 1;
+    n = ((sbase == nidx) ?
+      seq->count : sbase * MEOS_SKIP_INDEX_STEP + 1) - base;
+    if (n == 0)
+      /* The last entry of the skip index is the last instant and all the
+       * instants are before the timestamp */
+      return base;
+  }
+  while (n > 1)
+  {
+    int half = n / 2;
+    base = (TSEQUENCE_INST_N(seq, base + half - 1)->t < t) ? base + half :
+      base;
+    n -= half;
+  }
+  return (TSEQUENCE_INST_N(seq, base)->t < t) ? base + 1 : base;
+}
+
 /**
  * @brief Return the index of the segment of a temporal continuous sequence
  * containing a timestamp using binary search
@@ -456,24 +511,15 @@ int
 tcontseq_find_timestamp(const TSequence *seq, TimestampTz t)
 {
   assert(seq);
-  int first = 0;
-  int last = seq->count - 1;
-  while (first <= last)
-  {
-    int middle = (first + last) / 2;
-    const TInstant *inst1 = TSEQUENCE_INST_N(seq, middle);
-    const TInstant *inst2 = TSEQUENCE_INST_N(seq, middle + 1);
-    bool lower_inc = (middle == 0) ? seq->period.lower_inc : true;
-    bool upper_inc = (middle == seq->count - 1) ? seq->period.upper_inc : false;
-    if ((inst1->t < t && t < inst2->t) ||
-        (lower_inc && inst1->t == t) || (upper_inc && inst2->t == t))
-      return middle;
-    if (t <= inst1->t)
-      last = middle - 1;
-    else
-      first = middle + 1;
-  }
-  return -1;
+  int loc = tsequence_timestamp_lower_bound(seq, t);
+  if (loc == seq->count)
+    return -1;
+  if (TSEQUENCE_INST_N(seq, loc)->t == t)
+    /* At the first instant the inclusion depends on the lower bound */
+    return (loc > 0) ? loc : (seq->period.lower_inc ? 0 : -1);
+  /* The timestamp is strictly between the instants loc - 1 and loc; in
+   * particular, the result is -1 when it is before the first instant */
+  return loc - 1;
 }
 
 /**
@@ -503,21 +549,47 @@ int
 tdiscseq_find_timestamp(const TSequence *seq, TimestampTz t)
 {
   assert(seq);
-  int first = 0;
-  int last = seq->count - 1;
-  while (first <= last)
+  int loc = tsequence_timestamp_lower_bound(seq, t);
+  if (loc < seq->count && TSEQUENCE_INST_N(seq, loc)->t == t)
+    return loc;
+  return -1;
+}
+
+/**
+ * @brief Return the indexes of the segments of a temporal continuous
+ * sequence containing an ascending array of timestamps in a single forward
+ * pass
+ *
+ * Each entry of the output array receives the same result as
+ * #tcontseq_find_timestamp for the corresponding timestamp, but the
+ * instants are scanned only once for the whole array instead of once per
+ * probe.
+ *
+ * @param[in] seq Temporal continuous sequence
+ * @param[in] times Array of timestamps in ascending order
+ * @param[in] count Number of timestamps
+ * @param[out] locs Array of resulting indexes
+ */
+void
+tcontseq_find_timestamp_batch(const TSequence *seq, const TimestampTz *times,
+  int count, int *locs)
+{
+  assert(seq); assert(times); assert(locs);
+  int i = 0;
+  for (int k = 0; k < count; k++)
   {
-    int middle = (first + last) / 2;
-    const TInstant *inst = TSEQUENCE_INST_N(seq, middle);
-    int cmp = timestamptz_cmp_internal(inst->t, t);
-    if (cmp == 0)
-      return middle;
-    if (cmp > 0)
-      last = middle - 1;
+    TimestampTz t = times[k];
+    /* Advance the cursor to the first instant not before the timestamp */
+    while (i < seq->count && TSEQUENCE_INST_N(seq, i)->t < t)
+      i++;
+    if (i == seq->count)
+      locs[k] = -1;
+    else if (TSEQUENCE_INST_N(seq, i)->t == t)
+      locs[k] = (i > 0) ? i : (seq->period.lower_inc ? 0 : -1);
     else
-      first = middle + 1;
+      locs[k] = i - 1;
   }
-  return -1;
+  return;
 }
 
 /**
@@ -692,7 +764,22 @@ tsequence_to_string(const TSequence *seq, int maxdd, bool component,
   assert(seq);
   assert(maxdd >= 0);
 
+  /* Write the instants directly into the result when the base type has a
+   * buffer-writing output function, performing a single allocation instead
+   * of one per instant */
+  if (value_out == &basetype_out)
+  {
+    size_t size = tsequence_to_string_size(seq, maxdd, component);
+    if (size)
+    {
+      char *result = palloc(size);
+      tsequence_to_string_buf(result, seq, maxdd, component);
+      return result;
+    }
+  }
+
   char **strings = palloc(sizeof(char *) * seq->count);
+  size_t *lengths = palloc(sizeof(size_t) * seq->count);
   size_t outlen = 0;
   char prefix[20];
   interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
@@ -705,7 +792,8 @@ tsequence_to_string(const TSequence *seq, int maxdd, bool component,
   {
     const TInstant *inst = TSEQUENCE_INST_N(seq, i);
     strings[i] = tinstant_to_string(inst, maxdd, value_out);
-    outlen += strlen(strings[i]) + 1;
+    lengths[i] = strlen(strings[i]);
+    outlen += lengths[i] + 1;
   }
   char open, close;
   if (MEOS_FLAGS_DISCRETE_INTERP(seq->flags))
@@ -718,8 +806,78 @@ tsequence_to_string(const TSequence *seq, int maxdd, bool component,
     open = seq->period.lower_inc ? (char) '[' : (char) '(';
     close = seq->period.upper_inc ? (char) ']' : (char) ')';
   }
-  return stringarr_to_string(strings, seq->count, outlen, prefix, open, close,
-    QUOTES_NO, SPACES);
+  char *result = stringarr_to_string(strings, lengths, seq->count, outlen,
+    prefix, open, close, QUOTES_NO, SPACES);
+  pfree(lengths);
+  return result;
+}
+
+/**
+ * @brief Return the maximum size in bytes of the Well-Known Text (WKT)
+ * representation of a temporal sequence, including the terminating NUL, or 0
+ * when the base type has no buffer-writing output function
+ * @param[in] seq Temporal sequence
+ * @param[in] maxdd Maximum number of decimal digits
+ * @param[in] component True if the output string is a component of a
+ * temporal sequence set
+ */
+size_t
+tsequence_to_string_size(const TSequence *seq, int maxdd, bool component)
+{
+  assert(seq);
+  size_t size = 3; /* open, close, '\0' */
+  if (! component && MEOS_FLAGS_GET_CONTINUOUS(seq->flags) &&
+      MEOS_FLAGS_GET_INTERP(seq->flags) == STEP)
+    size += sizeof("Interp=Step;");
+  for (int i = 0; i < seq->count; i++)
+  {
+    size_t s = tinstant_to_string_size(TSEQUENCE_INST_N(seq, i), maxdd);
+    if (s == 0)
+      return 0;
+    size += s + 2; /* ", " separator */
+  }
+  return size;
+}
+
+/**
+ * @brief Write the Well-Known Text (WKT) representation of a temporal
+ * sequence into the buffer
+ * @return Number of characters written, not including the terminating NUL
+ * @note The caller must have verified with #tsequence_to_string_size that
+ * the base type has a buffer-writing output function and sized the buffer
+ * accordingly
+ */
+size_t
+tsequence_to_string_buf(char *output, const TSequence *seq, int maxdd,
+  bool component)
+{
+  assert(seq);
+  char *ptr = output;
+  if (! component && MEOS_FLAGS_GET_CONTINUOUS(seq->flags) &&
+      MEOS_FLAGS_GET_INTERP(seq->flags) == STEP)
+  {
+    strcpy(ptr, "Interp=Step;");
+    ptr += strlen(ptr);
+  }
+  if (MEOS_FLAGS_DISCRETE_INTERP(seq->flags))
+    *ptr++ = '{';
+  else
+    *ptr++ = seq->period.lower_inc ? '[' : '(';
+  for (int i = 0; i < seq->count; i++)
+  {
+    if (i)
+    {
+      *ptr++ = ',';
+      *ptr++ = ' ';
+    }
+    ptr += tinstant_to_string_buf(ptr, TSEQUENCE_INST_N(seq, i), maxdd);
+  }
+  if (MEOS_FLAGS_DISCRETE_INTERP(seq->flags))
+    *ptr++ = '}';
+  else
+    *ptr++ = seq->period.upper_inc ? ']' : ')';
+  *ptr = '\0';
+  return (ptr - output);
 }
 
 /**
@@ -783,6 +941,18 @@ TSEQUENCE_INST_N(const TSequence *seq, int index)
     ((char *) &seq->period) + seq->bboxsize +
     sizeof(size_t) * seq->maxcount + (TSEQUENCE_OFFSETS_PTR(seq))[index] );
 }
+
+/**
+ * @brief Return a pointer to the skip index of instant timestamps stored at
+ * the end of a temporal sequence
+ * @pre The times flag of the sequence is set
+ */
+const TimestampTz *
+TSEQUENCE_TIMES_PTR(const TSequence *seq)
+{
+  return (const TimestampTz *)( ((char *) seq) + VARSIZE(seq) -
+    (sizeof(TimestampTz) * MEOS_SKIP_INDEX_COUNT(seq->count)) );
+}
 #endif /* DEBUG_BUILD */
 
 /**
@@ -832,16 +1002,30 @@ tsequence_make1_exp(const TInstant **instants, int count, int maxcount,
    * estimation. The functions adding instants to a sequence must verify both
    * the maximum number of instants and the remaining space for adding an
    * additional variable-length instant of arbitrary size */
+  bool skipidx = false;
   if (count != maxcount)
     insts_size *= maxcount / count;
   else
+  {
     maxcount = newcount;
+    /* For a non-expandable sequence with numerous instants, a skip index
+     * storing the timestamp of every MEOS_SKIP_INDEX_STEP-th instant is
+     * appended at the end so that the timestamp searches narrow down to a
+     * few cache lines before touching the scattered instants. The index is
+     * not maintained for expandable sequences since the functions appending
+     * instants reuse the space at the end */
+    skipidx = (newcount >= MEOS_SKIP_INDEX_MINCOUNT);
+  }
+  size_t times_size = skipidx ?
+    sizeof(TimestampTz) * MEOS_SKIP_INDEX_COUNT(newcount) : 0;
   /* Total size of the struct */
   size_t memsize = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
-    sizeof(size_t) * maxcount + insts_size;
+    sizeof(size_t) * maxcount + insts_size + times_size;
 
   /* Create the temporal sequence */
+  MEOS_ALLOC_TAG(MEOS_ALLOC_TSEQUENCE);
   TSequence *result = palloc0(memsize);
+  MEOS_ALLOC_TAG(MEOS_ALLOC_GENERIC);
   SET_VARSIZE(result, memsize);
   result->count = newcount;
   result->maxcount = maxcount;
@@ -859,6 +1043,23 @@ tsequence_make1_exp(const TInstant **instants, int count, int maxcount,
     MEOS_FLAGS_SET_GEODETIC(result->flags,
       MEOS_FLAGS_GET_GEODETIC(instants[0]->flags));
   }
+  else if (tnumber_type(instants[0]->temptype))
+  {
+    /* Detect monotone value evolution, which enables binary searching the
+     * crossing window in the restriction functions */
+    meosType basetype = temptype_basetype(instants[0]->temptype);
+    bool incr = true, decr = true;
+    for (int i = 1; i < newcount && (incr || decr); i++)
+    {
+      int cmp = datum_cmp(tinstant_value(norminsts[i - 1]),
+        tinstant_value(norminsts[i]), basetype);
+      if (cmp > 0)
+        incr = false;
+      if (cmp < 0)
+        decr = false;
+    }
+    MEOS_FLAGS_SET_MONOTONE(result->flags, incr || decr);
+  }
   /* Initialization of the variable-length part */
   /* Store the bounding box passed as parameter or compute it if not given */
   if (bbox)
@@ -877,6 +1078,14 @@ tsequence_make1_exp(const TInstant **instants, int count, int maxcount,
     (TSEQUENCE_OFFSETS_PTR(result))[i] = pos;
     pos += DOUBLE_PAD(VARSIZE(norminsts[i]));
   }
+  /* Fill the skip index of instant timestamps */
+  if (skipidx)
+  {
+    MEOS_FLAGS_SET_TIMES(result->flags, true);
+    TimestampTz *times = (TimestampTz *) TSEQUENCE_TIMES_PTR(result);
+    for (int i = 0, j = 0; i < newcount; i += MEOS_SKIP_INDEX_STEP)
+      times[j++] = TSEQUENCE_INST_N(result, i)->t;
+  }
   if (interp != DISCRETE && normalize && count > 1)
     pfree(norminsts);
   return result;
@@ -1060,6 +1269,42 @@ tsequence_make(const TInstant **instants, int count, bool lower_inc,
     interp, normalize);
 }
 
+/**
+ * @ingroup libmeos_internal_temporal_constructor
+ * @brief Construct a temporal sequence from an array of temporal instants,
+ * applying the requested validation level.
+ *
+ * This constructor is intended for machine-generated input, for example,
+ * position reports received in ascending timestamp order, where the caller
+ * can guarantee the validity of the array and thus reduce the validation
+ * performed by #tsequence_make to an ordering test or skip it altogether.
+ * @param[in] instants Array of instants
+ * @param[in] count Number of elements in the array
+ * @param[in] lower_inc,upper_inc True if the respective bound is inclusive
+ * @param[in] interp Interpolation
+ * @param[in] normalize True if the resulting value should be normalized
+ * @param[in] validate Validation level applied to the array
+ */
+TSequence *
+tsequence_make_trusted(const TInstant **instants, int count, bool lower_inc,
+  bool upper_inc, interpType interp, bool normalize, validateLevel validate)
+{
+  assert(instants); assert(count > 0);
+  if (validate == VALIDATE_FULL &&
+      ! tsequence_make_valid(instants, count, lower_inc, upper_inc, interp))
+    return NULL;
+  if (validate == VALIDATE_ORDER)
+  {
+    /* Verify that the timestamps are in strictly increasing order */
+    for (int i = 1; i < count; i++)
+      if (! ensure_increasing_timestamps(instants[i - 1], instants[i],
+          MERGE_NO))
+        return NULL;
+  }
+  return tsequence_make1_exp(instants, count, count, lower_inc, upper_inc,
+    interp, normalize, NULL);
+}
+
 /**
  * @brief Construct a temporal sequence from an array of temporal instants
  * and free the array and the instants after the creation.
@@ -1107,10 +1352,223 @@ tsequence_make_free(TInstant **instants, int count, bool lower_inc,
 }
 
 #if MEOS
+/**
+ * @brief Ensure that the timestamps of the array are strictly increasing
+ */
+static bool
+ensure_increasing_times(const TimestampTz *times, int count)
+{
+  for (int i = 1; i < count; i++)
+  {
+    if (times[i - 1] >= times[i])
+    {
+      char *t1 = pg_timestamptz_out(times[i - 1]);
+      char *t2 = pg_timestamptz_out(times[i]);
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Timestamps for temporal value must be increasing: %s, %s", t1, t2);
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Ensure valid bounds when constructing a sequence from arrays, as
+ * done by #tsequence_make_valid1 for arrays of instants
+ */
+static bool
+tsequence_make_arrays_valid(int count, bool lower_inc, bool upper_inc,
+  meosType temptype, interpType interp)
+{
+  if (! ensure_valid_interpolation(temptype, interp))
+    return false;
+  if (count == 1 && (! lower_inc || ! upper_inc))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Instant sequence must have inclusive bounds");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @ingroup libmeos_internal_temporal_constructor
+ * @brief Construct a temporal sequence from arrays of values and timestamps,
+ * writing the final memory layout in a single pass.
+ *
+ * In contrast to #tsequence_make, no intermediate temporal instants are
+ * built, which avoids one allocation and one copy per instant when
+ * converting columnar batches.
+ * @param[in] values Array of values of a base type passed by value
+ * @param[in] temptype Temporal type
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the arrays
+ * @param[in] lower_inc,upper_inc True if the respective bound is inclusive
+ * @param[in] interp Interpolation
+ * @note The resulting sequence is not normalized
+ */
+TSequence *
+tsequence_make_from_arrays(const Datum *values, meosType temptype,
+  const TimestampTz *times, int count, bool lower_inc, bool upper_inc,
+  interpType interp)
+{
+  assert(values); assert(times); assert(count > 0);
+  meosType basetype = temptype_basetype(temptype);
+  assert(basetype_byvalue(basetype));
+  /* Ensure validity of the arguments */
+  if (! tsequence_make_arrays_valid(count, lower_inc, upper_inc, temptype,
+        interp) || ! ensure_increasing_times(times, count))
+    return NULL;
+  if (interp == STEP && count > 1 && ! upper_inc &&
+    datum_ne(values[count - 1], values[count - 2], basetype))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid end value for temporal sequence with step interpolation");
+    return NULL;
+  }
+
+  /* Get the bounding box size */
+  size_t bboxsize = DOUBLE_PAD(temporal_bbox_size(temptype));
+  /* The period component of the bbox is already declared in the struct */
+  size_t bboxsize_extra = bboxsize - sizeof(Span);
+  /* All instants of a by-value base type have the same size */
+  size_t instsize = DOUBLE_PAD(sizeof(TInstant));
+  size_t memsize = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
+    sizeof(size_t) * count + instsize * count;
+
+  /* Create the temporal sequence */
+  MEOS_ALLOC_TAG(MEOS_ALLOC_TSEQUENCE);
+  TSequence *result = palloc0(memsize);
+  MEOS_ALLOC_TAG(MEOS_ALLOC_GENERIC);
+  SET_VARSIZE(result, memsize);
+  result->count = result->maxcount = count;
+  result->temptype = temptype;
+  result->subtype = TSEQUENCE;
+  result->bboxsize = (int16) bboxsize;
+  bool continuous = temptype_continuous(temptype);
+  MEOS_FLAGS_SET_CONTINUOUS(result->flags, continuous);
+  MEOS_FLAGS_SET_INTERP(result->flags, interp);
+  MEOS_FLAGS_SET_X(result->flags, true);
+  MEOS_FLAGS_SET_T(result->flags, true);
+  /* Write the composing instants in place */
+  size_t pdata = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
+    sizeof(size_t) * count;
+  size_t pos = 0;
+  const TInstant **instants = palloc(sizeof(TInstant *) * count);
+  /* All instants have the same flags, compute the word once outside the
+   * loop instead of setting each bit on every instant */
+  int16 instflags = 0;
+  MEOS_FLAGS_SET_BYVAL(instflags, true);
+  MEOS_FLAGS_SET_CONTINUOUS(instflags, continuous);
+  MEOS_FLAGS_SET_X(instflags, true);
+  MEOS_FLAGS_SET_T(instflags, true);
+  for (int i = 0; i < count; i++)
+  {
+    TInstant *inst = (TInstant *) (((char *) result) + pdata + pos);
+    SET_VARSIZE(inst, instsize);
+    inst->temptype = (uint8) temptype;
+    inst->subtype = TINSTANT;
+    inst->t = times[i];
+    inst->value = values[i];
+    inst->flags = instflags;
+    (TSEQUENCE_OFFSETS_PTR(result))[i] = pos;
+    instants[i] = inst;
+    pos += instsize;
+  }
+  /* Compute the bounding box over the instants written in place */
+  tinstarr_compute_bbox(instants, count, lower_inc, upper_inc, interp,
+    TSEQUENCE_BBOX_PTR(result));
+  pfree(instants);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_constructor
+ * @brief Construct a temporal boolean sequence from arrays of booleans and
+ * timestamps, writing the final memory layout in a single pass.
+ * @param[in] values Array of booleans
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the arrays
+ * @param[in] lower_inc,upper_inc True if the respective bound is inclusive
+ */
+TSequence *
+tboolseq_make_from_arrays(const bool *values, const TimestampTz *times,
+  int count, bool lower_inc, bool upper_inc)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) values) || ! ensure_not_null((void *) times) ||
+      ! ensure_positive(count))
+    return NULL;
+  Datum *datums = palloc(sizeof(Datum) * count);
+  for (int i = 0; i < count; i++)
+    datums[i] = BoolGetDatum(values[i]);
+  TSequence *result = tsequence_make_from_arrays(datums, T_TBOOL, times,
+    count, lower_inc, upper_inc, STEP);
+  pfree(datums);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_constructor
+ * @brief Construct a temporal integer sequence from arrays of integers and
+ * timestamps, writing the final memory layout in a single pass.
+ * @param[in] values Array of integers
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the arrays
+ * @param[in] lower_inc,upper_inc True if the respective bound is inclusive
+ */
+TSequence *
+tintseq_make_from_arrays(const int *values, const TimestampTz *times,
+  int count, bool lower_inc, bool upper_inc)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) values) || ! ensure_not_null((void *) times) ||
+      ! ensure_positive(count))
+    return NULL;
+  Datum *datums = palloc(sizeof(Datum) * count);
+  for (int i = 0; i < count; i++)
+    datums[i] = Int32GetDatum(values[i]);
+  TSequence *result = tsequence_make_from_arrays(datums, T_TINT, times,
+    count, lower_inc, upper_inc, STEP);
+  pfree(datums);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_constructor
+ * @brief Construct a temporal float sequence from arrays of floats and
+ * timestamps, writing the final memory layout in a single pass.
+ * @param[in] values Array of floats
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the arrays
+ * @param[in] lower_inc,upper_inc True if the respective bound is inclusive
+ * @param[in] interp Interpolation
+ */
+TSequence *
+tfloatseq_make_from_arrays(const double *values, const TimestampTz *times,
+  int count, bool lower_inc, bool upper_inc, interpType interp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) values) || ! ensure_not_null((void *) times) ||
+      ! ensure_positive(count))
+    return NULL;
+  Datum *datums = palloc(sizeof(Datum) * count);
+  for (int i = 0; i < count; i++)
+    datums[i] = Float8GetDatum(values[i]);
+  TSequence *result = tsequence_make_from_arrays(datums, T_TFLOAT, times,
+    count, lower_inc, upper_inc, interp);
+  pfree(datums);
+  return result;
+}
+
 /**
  * @ingroup libmeos_internal_temporal_constructor
  * @brief Construct a temporal sequence from arrays of coordinates, one per
  * dimension, and timestamps.
+ *
+ * The final memory layout of the sequence is written in a single pass: a
+ * template point is serialized once and its coordinates are patched for
+ * every instant, so no intermediate temporal instants are built.
  * @param[in] xcoords Array of x coordinates
  * @param[in] ycoords Array of y coordinates
  * @param[in] zcoords Array of z coordinates
@@ -1130,16 +1588,101 @@ tpointseq_make_coords(const double *xcoords, const double *ycoords,
   assert(xcoords); assert(ycoords); assert(times);
   assert(count > 0);
   bool hasz = (zcoords != NULL);
-  TInstant **instants = palloc(sizeof(TInstant *) * count);
-  for (int i = 0; i < count; i ++)
+  meosType temptype = geodetic ? T_TGEOGPOINT : T_TGEOMPOINT;
+  /* Ensure validity of the arguments */
+  if (! tsequence_make_arrays_valid(count, lower_inc, upper_inc, temptype,
+        interp) || ! ensure_increasing_times(times, count))
+    return NULL;
+
+  /* Get the bounding box size */
+  size_t bboxsize = DOUBLE_PAD(temporal_bbox_size(temptype));
+  /* The period component of the bbox is already declared in the struct */
+  size_t bboxsize_extra = bboxsize - sizeof(Span);
+  /* Serialize a template point, which is patched for every instant. All
+   * points of a sequence have the same dimensions and thus the same size */
+  GSERIALIZED *gs = gspoint_make(xcoords[0], ycoords[0],
+    hasz ? zcoords[0] : 0.0, hasz, geodetic, srid);
+  size_t value_offset = sizeof(TInstant) - sizeof(Datum);
+  size_t instsize = DOUBLE_PAD(value_offset + DOUBLE_PAD(VARSIZE(gs)));
+  size_t memsize = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
+    sizeof(size_t) * count + instsize * count;
+
+  /* Create the temporal sequence */
+  MEOS_ALLOC_TAG(MEOS_ALLOC_TSEQUENCE);
+  TSequence *result = palloc0(memsize);
+  MEOS_ALLOC_TAG(MEOS_ALLOC_GENERIC);
+  SET_VARSIZE(result, memsize);
+  result->count = result->maxcount = count;
+  result->temptype = (uint8) temptype;
+  result->subtype = TSEQUENCE;
+  result->bboxsize = (int16) bboxsize;
+  MEOS_FLAGS_SET_CONTINUOUS(result->flags, true);
+  MEOS_FLAGS_SET_INTERP(result->flags, interp);
+  MEOS_FLAGS_SET_X(result->flags, true);
+  MEOS_FLAGS_SET_T(result->flags, true);
+  MEOS_FLAGS_SET_Z(result->flags, hasz);
+  MEOS_FLAGS_SET_GEODETIC(result->flags, geodetic);
+  /* Write the composing instants in place */
+  size_t pdata = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
+    sizeof(size_t) * count;
+  size_t pos = 0;
+  const TInstant **instants = palloc(sizeof(TInstant *) * count);
+  /* All instants have the same flags, compute the word once outside the
+   * loop instead of setting each bit on every instant */
+  int16 instflags = 0;
+  MEOS_FLAGS_SET_BYVAL(instflags, false);
+  MEOS_FLAGS_SET_CONTINUOUS(instflags, true);
+  MEOS_FLAGS_SET_X(instflags, true);
+  MEOS_FLAGS_SET_T(instflags, true);
+  MEOS_FLAGS_SET_Z(instflags, hasz);
+  MEOS_FLAGS_SET_GEODETIC(instflags, geodetic);
+  for (int i = 0; i < count; i++)
   {
-    Datum point = PointerGetDatum(gspoint_make(xcoords[i], ycoords[i],
-      hasz ? zcoords[i] : 0.0, hasz, geodetic, srid));
-    instants[i] = tinstant_make(point, geodetic ? T_TGEOGPOINT : T_TGEOMPOINT,
-      times[i]);
+    TInstant *inst = (TInstant *) (((char *) result) + pdata + pos);
+    SET_VARSIZE(inst, value_offset + DOUBLE_PAD(VARSIZE(gs)));
+    inst->temptype = (uint8) temptype;
+    inst->subtype = TINSTANT;
+    inst->t = times[i];
+    inst->flags = instflags;
+    /* Copy the template point and patch its coordinates */
+    GSERIALIZED *point = (GSERIALIZED *) (((char *) inst) + value_offset);
+    memcpy(point, gs, VARSIZE(gs));
+    if (hasz)
+    {
+      POINT3DZ *p = GSERIALIZED_POINT3DZ_P(point);
+      p->x = xcoords[i]; p->y = ycoords[i]; p->z = zcoords[i];
+    }
+    else
+    {
+      POINT2D *p = GSERIALIZED_POINT2D_P(point);
+      p->x = xcoords[i]; p->y = ycoords[i];
+    }
+    (TSEQUENCE_OFFSETS_PTR(result))[i] = pos;
+    instants[i] = inst;
+    pos += instsize;
+  }
+  pfree(gs);
+  /* Compute the bounding box over the instants written in place */
+  tinstarr_compute_bbox(instants, count, lower_inc, upper_inc, interp,
+    TSEQUENCE_BBOX_PTR(result));
+  /* Normalize the resulting sequence if requested. The fast path above is
+   * kept when there are no redundant instants to remove */
+  if (interp != DISCRETE && normalize && count > 2)
+  {
+    int newcount;
+    TInstant **norminsts = tinstarr_normalize(instants, interp, count,
+      &newcount);
+    if (newcount < count)
+    {
+      TSequence *norm = tsequence_make1_exp((const TInstant **) norminsts,
+        newcount, newcount, lower_inc, upper_inc, interp, false, NULL);
+      pfree(norminsts); pfree(instants); pfree(result);
+      return norm;
+    }
+    pfree(norminsts);
   }
-  return tsequence_make_free(instants, count, lower_inc, upper_inc, interp,
-    normalize);
+  pfree(instants);
+  return result;
 }
 #endif /* MEOS */
 
@@ -1389,6 +1932,10 @@ datum_distance(Datum value1, Datum value2, meosType basetype, int16 flags)
  * @param[in] inst Temporal instant
  * @param[in] maxdist Maximum distance for defining a gap
  * @param[in] maxt Maximum time interval for defining a gap
+ * @param[in] tolerance Tolerance of the dead-reckoning filter: when greater
+ * than zero and the interpolation is linear, the last instant is dropped if
+ * its value can be predicted within the tolerance by interpolating between
+ * its neighbouring instants
  * @param[in] expand True when reserving space for additional instants
  * @sqlfunc appendInstantGaps
  * @note It is the responsibility of the calling function to free the memory,
@@ -1397,7 +1944,7 @@ datum_distance(Datum value1, Datum value2, meosType basetype, int16 flags)
  */
 Temporal *
 tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
-  const Interval *maxt, bool expand)
+  const Interval *maxt, double tolerance, bool expand)
 {
   assert(seq); assert(inst);
   assert(seq->temptype == inst->temptype);
@@ -1500,6 +2047,19 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
       /* The new instant replaces the last instant of the sequence */
       count--;
     }
+    /* Dead-reckoning filter: the last instant is also replaced when its
+     * value can be predicted within the tolerance by interpolating between
+     * the penultimate and the new instants, which compresses near-linear
+     * streams online with a bounded error */
+    else if (tolerance > 0.0 && interp == LINEAR && penult->t < last->t &&
+      last->t < inst->t)
+    {
+      Datum pred = tsegment_value_at_timestamp(penult, inst, LINEAR, last->t);
+      double dist = datum_distance(pred, value1, basetype, flags);
+      DATUM_FREE(pred, basetype);
+      if (dist >= 0.0 && dist <= tolerance)
+        count--;
+    }
   }
 
   /* Account for expandable structures
@@ -1519,6 +2079,12 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
       break;
 
     /* There is enough space to add the new instant */
+    /* Bump the generation so that attached caches notice the in-place
+     * modification */
+    seq->generation++;
+    /* Invalidate the skip index, if any, since the last instant changes
+     * and the space of the index may be reused */
+    MEOS_FLAGS_SET_TIMES(seq->flags, false);
     if (count != seq->count)
     {
       /* Update the offsets array and the count when adding one instant */
@@ -1527,6 +2093,15 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
       seq->count++;
     }
     memcpy(new, inst, size);
+    /* Clear the monotonicity flag when the new value breaks the direction */
+    if (MEOS_FLAGS_GET_MONOTONE(seq->flags) && tnumber_type(seq->temptype))
+    {
+      int dir = datum_cmp(tinstant_value(TSEQUENCE_INST_N(seq, 0)),
+        tinstant_value(last), basetype);
+      int step = datum_cmp(tinstant_value(last), value, basetype);
+      if ((dir < 0 && step > 0) || (dir > 0 && step < 0))
+        MEOS_FLAGS_SET_MONOTONE(seq->flags, false);
+    }
     /* Expand the bounding box and return */
     tsequence_expand_bbox(seq, inst);
     return (Temporal *) seq;
@@ -1554,6 +2129,9 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
   TSequence *result = tsequence_make1_exp(instants, count, maxcount,
     seq->period.lower_inc, true, interp, NORMALIZE_NO, &bbox);
   pfree(instants);
+  /* Carry the generation over so that caches attached to the old value do
+   * not mistake the new one for it when the allocation reuses the address */
+  result->generation = (uint16) (seq->generation + 1);
   return (Temporal *) result;
 }
 
@@ -1736,16 +2314,18 @@ tseqarr_normalize(const TSequence **sequences, int count, int *newcount)
  * @brief Merge an array of temporal sequences.
  * @param[in] sequences Array of values
  * @param[in] count Number of elements in the array
+ * @param[in] sorted True when the array is already sorted on the periods of
+ * the sequences and the sorting step can be skipped
  * @param[out] totalcount Number of elements in the resulting array
  * @result Array of merged sequences
  * @note The values in the array may overlap on a single instant.
  */
 TSequence **
-tsequence_merge_array1(const TSequence **sequences, int count,
+tsequence_merge_array1(const TSequence **sequences, int count, bool sorted,
   int *totalcount)
 {
   assert(sequences); assert(totalcount);
-  if (count > 1)
+  if (count > 1 && ! sorted)
     tseqarr_sort((TSequence **) sequences, count);
   /* Test the validity of the composing sequences */
   const TSequence *seq1 = sequences[0];
@@ -1802,7 +2382,8 @@ tsequence_merge_array(const TSequence **sequences, int count)
 
   /* Continuous sequences */
   int totalcount;
-  TSequence **newseqs = tsequence_merge_array1(sequences, count, &totalcount);
+  TSequence **newseqs = tsequence_merge_array1(sequences, count, false,
+    &totalcount);
   Temporal *result;
   if (totalcount == 1)
   {
@@ -1838,12 +2419,16 @@ tsequence_compact(const TSequence *seq)
     insts_size += DOUBLE_PAD(VARSIZE(TSEQUENCE_INST_N(seq, i)));
   size_t seqsize = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
     seq->count * sizeof(size_t) + insts_size;
+  MEOS_ALLOC_TAG(MEOS_ALLOC_TSEQUENCE);
   TSequence *result = palloc0(seqsize);
+  MEOS_ALLOC_TAG(MEOS_ALLOC_GENERIC);
 
   /* Copy until the end of the offsets array */
   memcpy(result, seq, seqsize - insts_size);
   /* Set the maxcount */
   result->maxcount = result->count;
+  /* The skip index of the source, if any, is not copied */
+  MEOS_FLAGS_SET_TIMES(result->flags, false);
   /* Copy until the end of the offsets array */
   memcpy((char *) TSEQUENCE_INST_N(result, 0), TSEQUENCE_INST_N(seq, 0),
     insts_size);
@@ -1877,6 +2462,12 @@ tsequence_restart(TSequence *seq, int count)
   /* Copy the last instants at the beginning */
   last_n = TSEQUENCE_INST_N(seq, seq->count - count);
   memcpy(first, last_n, inst_size);
+  /* Bump the generation so that attached caches notice the in-place
+   * modification */
+  seq->generation++;
+  /* Invalidate the skip index, if any, before updating the count on which
+   * its location depends */
+  MEOS_FLAGS_SET_TIMES(seq->flags, false);
   /* Update the count and the bounding box */
   seq->count = count;
   size_t bboxsize = DOUBLE_PAD(temporal_bbox_size(seq->temptype));
@@ -1920,7 +2511,22 @@ TSequence *
 tinstant_to_tsequence(const TInstant *inst, interpType interp)
 {
   assert(inst);
-  return tsequence_make(&inst, 1, true, true, interp, NORMALIZE_NO);
+  return tsequence_make(&inst, 1, true, true, interp, NORMALIZE_NO);
+}
+
+/**
+ * @ingroup libmeos_internal_temporal_transf
+ * @brief Return a temporal instant transformed into a temporal sequence
+ * and free the instant after the conversion
+ * @see tinstant_to_tsequence
+ */
+TSequence *
+tinstant_to_tsequence_free(TInstant *inst, interpType interp)
+{
+  assert(inst);
+  TSequence *result = tinstant_to_tsequence(inst, interp);
+  pfree(inst);
+  return result;
 }
 
 /*****************************************************************************/
@@ -2150,6 +2756,8 @@ void
 tsequence_shift_scale_time_iter(TSequence *seq, TimestampTz delta,
   double scale)
 {
+  /* Invalidate the skip index, if any, since the timestamps change */
+  MEOS_FLAGS_SET_TIMES(seq->flags, false);
   /* Set the first instant from the bounding period which has been already
    * shifted and/or scaled */
   TInstant *inst = (TInstant *) TSEQUENCE_INST_N(seq, 0);
@@ -2804,6 +3412,7 @@ synchronize_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
 {
   assert(seq1); assert(seq2);
   assert(sync1); assert(sync2);
+  MEOS_STATS_INC(sync_calls);
   /* The temporal types of the arguments may be different */
   /* Test whether the bounding period of the two temporal values overlap */
   Span inter;
@@ -2925,6 +3534,253 @@ synchronize_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
   return true;
 }
 
+/**
+ * @brief Advance the synchronized iteration computing the next aligned pairs
+ *
+ * The function mirrors one step of the loop in the function
+ * synchronize_tsequence_tsequence and stores in the state the (at most two)
+ * pairs produced by the step, that is, a potential crossing followed by the
+ * pair at the next synchronization timestamp.
+ */
+static void
+tsequence_sync_iter_fill(TSeqSyncIter *iter)
+{
+  /* Free the scratch instants of the previous step, whose values may have
+   * been used as previous instants up to the current step */
+  for (int k = 0; k < iter->nfree_prev; k++)
+    pfree(iter->tofree_prev[k]);
+  memcpy(iter->tofree_prev, iter->tofree, sizeof(TInstant *) * iter->nfree);
+  iter->nfree_prev = iter->nfree;
+  iter->nfree = 0;
+  iter->npending = iter->curpending = 0;
+
+  if (iter->done)
+    return;
+  TimestampTz upper = DatumGetTimestampTz(iter->inter.upper);
+  if (! (iter->i < iter->seq1->count && iter->j < iter->seq2->count &&
+        (iter->inst1->t <= upper || iter->inst2->t <= upper)))
+  {
+    iter->done = true;
+    return;
+  }
+
+  TInstant *inst1 = (TInstant *) iter->inst1;
+  TInstant *inst2 = (TInstant *) iter->inst2;
+  int cmp = timestamptz_cmp_internal(inst1->t, inst2->t);
+  if (cmp == 0)
+  {
+    iter->i++; iter->j++;
+  }
+  else if (cmp < 0)
+  {
+    iter->i++;
+    inst2 = tsequence_at_timestamp(iter->seq2, inst1->t);
+    iter->tofree[iter->nfree++] = inst2;
+  }
+  else
+  {
+    iter->j++;
+    inst1 = tsequence_at_timestamp(iter->seq1, inst2->t);
+    iter->tofree[iter->nfree++] = inst1;
+  }
+  /* If not the first pair add a potential crossing before the new pair */
+  if (iter->crossings && iter->npairs > 0)
+  {
+    TimestampTz crosstime;
+    Datum inter1, inter2;
+    if (tsegment_intersection(iter->prev1, inst1, iter->interp1,
+      iter->prev2, inst2, iter->interp2, &inter1, &inter2, &crosstime))
+    {
+      TInstant *cross1 = tinstant_make(inter1, iter->seq1->temptype,
+        crosstime);
+      TInstant *cross2 = tinstant_make(inter2, iter->seq2->temptype,
+        crosstime);
+      iter->tofree[iter->nfree++] = cross1;
+      iter->tofree[iter->nfree++] = cross2;
+      iter->pending[iter->npending].t = crosstime;
+      iter->pending[iter->npending].value1 = tinstant_value(cross1);
+      iter->pending[iter->npending++].value2 = tinstant_value(cross2);
+    }
+  }
+  iter->pending[iter->npending].t = inst1->t;
+  iter->pending[iter->npending].value1 = tinstant_value(inst1);
+  iter->pending[iter->npending].value2 = tinstant_value(inst2);
+  if (iter->i == iter->seq1->count || iter->j == iter->seq2->count)
+  {
+    /* The last two values of sequences with step interpolation and
+       exclusive upper bound must be equal */
+    if (! iter->inter.upper_inc && iter->npairs + iter->npending > 0)
+    {
+      Datum prevval1 = iter->npending > 0 ?
+        iter->pending[iter->npending - 1].value1 : tinstant_value(iter->prev1);
+      Datum prevval2 = iter->npending > 0 ?
+        iter->pending[iter->npending - 1].value2 : tinstant_value(iter->prev2);
+      if (iter->interp1 != LINEAR)
+        iter->pending[iter->npending].value1 = prevval1;
+      if (iter->interp2 != LINEAR)
+        iter->pending[iter->npending].value2 = prevval2;
+    }
+    iter->done = true;
+  }
+  iter->npending++;
+  iter->prev1 = inst1;
+  iter->prev2 = inst2;
+  if (! iter->done)
+  {
+    iter->inst1 = TSEQUENCE_INST_N(iter->seq1, iter->i);
+    iter->inst2 = TSEQUENCE_INST_N(iter->seq2, iter->j);
+  }
+}
+
+/**
+ * @brief Start the synchronized iteration over two temporal sequences
+ *
+ * The iterator yields the aligned pairs of base values that the function
+ * synchronize_tsequence_tsequence would produce, without materializing the
+ * two synchronized sequences. The state is allocated by the caller and must
+ * be released with tsequence_sync_iter_close.
+ *
+ * @param[in] seq1,seq2 Input values
+ * @param[in] crossings True if turning points are added in the segments
+ * @param[out] iter State of the iteration
+ * @result Return false if the input values do not overlap on time
+ */
+bool
+tsequence_sync_iter_start(const TSequence *seq1, const TSequence *seq2,
+  bool crossings, TSeqSyncIter *iter)
+{
+  assert(seq1); assert(seq2); assert(iter);
+  memset(iter, 0, sizeof(TSeqSyncIter));
+  /* Test whether the bounding period of the two temporal values overlap */
+  if (! inter_span_span(&seq1->period, &seq2->period, &iter->inter))
+    return false;
+
+  iter->seq1 = seq1;
+  iter->seq2 = seq2;
+  iter->interp1 = MEOS_FLAGS_GET_INTERP(seq1->flags);
+  iter->interp2 = MEOS_FLAGS_GET_INTERP(seq2->flags);
+  iter->crossings = crossings &&
+    (iter->interp1 == LINEAR || iter->interp2 == LINEAR);
+
+  /* If the two sequences intersect at an instant */
+  if (iter->inter.lower == iter->inter.upper)
+  {
+    TInstant *inst1 = tsequence_at_timestamp(seq1, iter->inter.lower);
+    TInstant *inst2 = tsequence_at_timestamp(seq2, iter->inter.lower);
+    iter->tofree[iter->nfree++] = inst1;
+    iter->tofree[iter->nfree++] = inst2;
+    iter->pending[0].t = DatumGetTimestampTz(iter->inter.lower);
+    iter->pending[0].value1 = tinstant_value(inst1);
+    iter->pending[0].value2 = tinstant_value(inst2);
+    iter->npending = 1;
+    iter->done = true;
+    return true;
+  }
+
+  /* General case: advance the sequences to the intersection period */
+  iter->inst1 = TSEQUENCE_INST_N(seq1, 0);
+  iter->inst2 = TSEQUENCE_INST_N(seq2, 0);
+  if (iter->inst1->t < DatumGetTimestampTz(iter->inter.lower))
+  {
+    iter->i = tcontseq_find_timestamp(seq1, iter->inter.lower) + 1;
+    iter->inst1 = TSEQUENCE_INST_N(seq1, iter->i);
+  }
+  else if (iter->inst2->t < DatumGetTimestampTz(iter->inter.lower))
+  {
+    iter->j = tcontseq_find_timestamp(seq2, iter->inter.lower) + 1;
+    iter->inst2 = TSEQUENCE_INST_N(seq2, iter->j);
+  }
+  return true;
+}
+
+/**
+ * @brief Return the next aligned pair of the synchronized iteration
+ *
+ * @param[in,out] iter State of the iteration
+ * @param[out] t Timestamp of the pair
+ * @param[out] value1,value2 Base values of the two sequences at the timestamp
+ * @result Return false if the iteration is exhausted
+ * @note The output values are owned by the iterator and are valid until the
+ * next call to this function or to tsequence_sync_iter_close
+ */
+bool
+tsequence_sync_iter_next(TSeqSyncIter *iter, TimestampTz *t, Datum *value1,
+  Datum *value2)
+{
+  assert(iter); assert(t); assert(value1); assert(value2);
+  if (iter->curpending >= iter->npending)
+  {
+    tsequence_sync_iter_fill(iter);
+    if (iter->npending == 0)
+      return false;
+  }
+  *t = iter->pending[iter->curpending].t;
+  *value1 = iter->pending[iter->curpending].value1;
+  *value2 = iter->pending[iter->curpending].value2;
+  iter->curpending++;
+  iter->npairs++;
+  return true;
+}
+
+/**
+ * @brief Free the scratch instants held by the synchronized iteration
+ */
+void
+tsequence_sync_iter_close(TSeqSyncIter *iter)
+{
+  assert(iter);
+  for (int k = 0; k < iter->nfree_prev; k++)
+    pfree(iter->tofree_prev[k]);
+  for (int k = 0; k < iter->nfree; k++)
+    pfree(iter->tofree[k]);
+  iter->nfree_prev = iter->nfree = 0;
+}
+
+/**
+ * @brief Materialize the synchronized pairs of two temporal sequences in an
+ * interleaved scratch buffer
+ *
+ * Binary operations walking the two synchronized sequences alternate between
+ * two instant arrays and thus between distant cache lines. This function
+ * stores the aligned pairs in a single interleaved (t, value1, value2)
+ * buffer so that the inner loop of the operation streams one buffer
+ * linearly. The buffer is (re)allocated only when it is too small and can
+ * thus be reused across the pairs of sequences of an operation.
+ *
+ * @param[in] seq1,seq2 Input values
+ * @param[in] crossings True if turning points are added in the segments
+ * @param[in,out] pairs Scratch buffer, reallocated when too small
+ * @param[in,out] maxcount Capacity of the scratch buffer
+ * @return Number of pairs stored, 0 if the values do not overlap on time
+ * @note The base values are stored as raw datums and thus remain valid after
+ * the return only for base types passed by value
+ */
+int
+tsequence_sync_pairs(const TSequence *seq1, const TSequence *seq2,
+  bool crossings, TSyncPair **pairs, int *maxcount)
+{
+  assert(seq1); assert(seq2); assert(pairs); assert(maxcount);
+  /* Every synchronization step yields at most two pairs */
+  int bound = 2 * (seq1->count + seq2->count);
+  if (*pairs == NULL || *maxcount < bound)
+  {
+    if (*pairs)
+      pfree(*pairs);
+    *pairs = palloc(sizeof(TSyncPair) * bound);
+    *maxcount = bound;
+  }
+  TSeqSyncIter iter;
+  if (! tsequence_sync_iter_start(seq1, seq2, crossings, &iter))
+    return 0;
+  TSyncPair *buf = *pairs;
+  int count = 0;
+  while (tsequence_sync_iter_next(&iter, &buf[count].t, &buf[count].value1,
+      &buf[count].value2))
+    count++;
+  tsequence_sync_iter_close(&iter);
+  return count;
+}
+
 /*****************************************************************************
  * Intersection functions
  *****************************************************************************/
@@ -3315,6 +4171,57 @@ intersection_tinstant_tsequence(const TInstant *inst, const TSequence *seq,
  * Ever/always functions
  *****************************************************************************/
 
+/* Number of 64-bit words of the value membership filter (256 bits) */
+#define VALUE_BLOOM_WORDS 4
+/* Minimum number of instants before a filter is worth remembering */
+#define VALUE_BLOOM_MIN_COUNT 16
+
+/**
+ * @brief Cache of the value membership filter of the last scanned sequence
+ *
+ * Fleet monitoring asks whether a rare status ever occurred in a trip, and
+ * the answer is negative for almost every probed value, so each probe scans
+ * the whole sequence. The scan of a sequence with step or discrete
+ * interpolation now fills a small Bloom filter over the hashes of its values
+ * as a side product, together with a private copy of the sequence keyed by
+ * its bytes as in the other last-value caches. Subsequent probes of the same
+ * sequence with values absent from the filter are answered negatively
+ * without scanning. The filter is remembered only when a scan completes
+ * negatively, since a positive scan returns before hashing every value.
+ */
+typedef struct
+{
+  void *parent;       /**< Private copy of the filtered sequence */
+  size_t parentsize;  /**< Size of the sequence in bytes */
+  uint64 bits[VALUE_BLOOM_WORDS]; /**< Bloom filter over the value hashes */
+} ValueBloomCache;
+
+static __thread ValueBloomCache _value_bloom_cache = { NULL, 0, { 0 } };
+
+/**
+ * @brief Set in a membership filter the two bit positions derived from the
+ * hash of a value
+ */
+static void
+value_bloom_add(uint64 *bits, uint32 hash)
+{
+  uint32 pos1 = hash & 0xFF, pos2 = (hash >> 16) & 0xFF;
+  bits[pos1 >> 6] |= (uint64) 1 << (pos1 & 63);
+  bits[pos2 >> 6] |= (uint64) 1 << (pos2 & 63);
+  return;
+}
+
+/**
+ * @brief Return true if a value may be in a membership filter
+ */
+static bool
+value_bloom_test(const uint64 *bits, uint32 hash)
+{
+  uint32 pos1 = hash & 0xFF, pos2 = (hash >> 16) & 0xFF;
+  return (bits[pos1 >> 6] & ((uint64) 1 << (pos1 & 63))) != 0 &&
+    (bits[pos2 >> 6] & ((uint64) 1 << (pos2 & 63))) != 0;
+}
+
 /**
  * @ingroup libmeos_internal_temporal_comp_ever
  * @brief Return true if a temporal sequence is ever equal to a base value.
@@ -3335,11 +4242,42 @@ tsequence_ever_eq(const TSequence *seq, Datum value)
   /* Step interpolation or instantaneous sequence */
   if (! MEOS_FLAGS_LINEAR_INTERP(seq->flags) || seq->count == 1)
   {
+    ValueBloomCache *cache = &_value_bloom_cache;
+    bool build = false;
+    uint64 bits[VALUE_BLOOM_WORDS] = { 0 };
+    if (seq->count >= VALUE_BLOOM_MIN_COUNT)
+    {
+      if (cache->parent && cache->parentsize == VARSIZE(seq) &&
+          memcmp(cache->parent, seq, cache->parentsize) == 0)
+      {
+        /* Negative membership answered from the filter without scanning */
+        if (! value_bloom_test(cache->bits, datum_hash(value, basetype)))
+          return false;
+      }
+      else
+        build = true;
+    }
     for (i = 0; i < seq->count; i++)
     {
       value1 = tinstant_value(TSEQUENCE_INST_N(seq, i));
       if (datum_eq(value1, value, basetype))
         return true;
+      if (build)
+        value_bloom_add(bits, datum_hash(value1, basetype));
+    }
+    if (build)
+    {
+      /* Remember the filter of the completed negative scan */
+      void *parent = malloc(VARSIZE(seq));
+      if (parent)
+      {
+        if (cache->parent)
+          free(cache->parent);
+        cache->parent = parent;
+        cache->parentsize = VARSIZE(seq);
+        memcpy(cache->parent, seq, cache->parentsize);
+        memcpy(cache->bits, bits, sizeof(bits));
+      }
     }
     return false;
   }
@@ -3467,9 +4405,11 @@ bool
 tsequence_ever_lt(const TSequence *seq, Datum value)
 {
   assert(seq);
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *) seq, value, EVER))
-    return false;
+  /* Bounding box test, which decides the answer for temporal numbers */
+  bool result;
+  if (tnumber_type(seq->temptype) &&
+      tnumber_bbox_ev_al_lt_le((Temporal *) seq, value, EVER, true, &result))
+    return result;
 
   meosType basetype = temptype_basetype(seq->temptype);
   for (int i = 0; i < seq->count; i++)
@@ -3491,9 +4431,12 @@ bool
 tsequence_ever_le(const TSequence *seq, Datum value)
 {
   assert(seq);
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *) seq, value, EVER))
-    return false;
+  /* Bounding box test, which decides the answer for temporal numbers unless
+   * the value is equal to a minimum that may not be attained */
+  bool result;
+  if (tnumber_type(seq->temptype) &&
+      tnumber_bbox_ev_al_lt_le((Temporal *) seq, value, EVER, false, &result))
+    return result;
 
   Datum value1;
   int i;
@@ -3536,9 +4479,13 @@ bool
 tsequence_always_lt(const TSequence *seq, Datum value)
 {
   assert(seq);
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *) seq, value, ALWAYS))
-    return false;
+  /* Bounding box test, which decides the answer for temporal numbers unless
+   * the value is equal to a maximum that may not be attained */
+  bool result;
+  if (tnumber_type(seq->temptype) &&
+      tnumber_bbox_ev_al_lt_le((Temporal *) seq, value, ALWAYS, true,
+        &result))
+    return result;
 
   Datum value1;
   int i;
@@ -3582,14 +4529,12 @@ bool
 tsequence_always_le(const TSequence *seq, Datum value)
 {
   assert(seq);
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *) seq, value, ALWAYS))
-    return false;
-
-  /* The bounding box test above is enough to compute
-   * the answer for temporal numbers */
-  if (tnumber_type(seq->temptype))
-    return true;
+  /* Bounding box test, which decides the answer for temporal numbers */
+  bool result;
+  if (tnumber_type(seq->temptype) &&
+      tnumber_bbox_ev_al_lt_le((Temporal *) seq, value, ALWAYS, false,
+        &result))
+    return result;
 
   /* We are sure that the type has stewpwise interpolation since
    * there are currenty no other continuous base type besides tfloat
@@ -3774,8 +4719,7 @@ tsegment_restrict_value(const TInstant *inst1, const TInstant *inst2,
   if (atfunc)
   {
     TInstant *inst = tinstant_make(projvalue, inst1->temptype, t);
-    result[0] = tinstant_to_tsequence(inst, LINEAR);
-    pfree(inst);
+    result[0] = tinstant_to_tsequence_free(inst, LINEAR);
     DATUM_FREE(projvalue, basetype);
     return 1;
   }
@@ -3868,10 +4812,102 @@ tcontseq_restrict_value_iter(const TSequence *seq, Datum value, bool atfunc,
 
   /* General case */
   interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
-  inst1 = TSEQUENCE_INST_N(seq, 0);
-  bool lower_inc = seq->period.lower_inc;
   int nseqs = 0;
-  for (int i = 1; i < seq->count; i++)
+
+  /* Step interpolation: process the sequence as runs of equal values, that
+   * is, its run-length encoding. A run is kept when its value satisfies the
+   * restriction, which outputs one already normalized sequence per run kept
+   * instead of one sequence per segment that must be merged afterwards */
+  if (interp == STEP)
+  {
+    meosType basetype = temptype_basetype(seq->temptype);
+    int i = 0;
+    while (i < seq->count)
+    {
+      inst1 = TSEQUENCE_INST_N(seq, i);
+      Datum value1 = tinstant_value(inst1);
+      /* Find the last instant of the run of equal values */
+      int j = i;
+      while (j < seq->count - 1 && datum_eq(value1,
+          tinstant_value(TSEQUENCE_INST_N(seq, j + 1)), basetype))
+        j++;
+      if (datum_eq(value1, value, basetype) == atfunc)
+      {
+        bool lower_inc = (i == 0) ? seq->period.lower_inc : true;
+        TInstant *instants[2];
+        if (j == seq->count - 1)
+        {
+          /* The run extends to the end of the sequence */
+          if (i < j || seq->period.upper_inc)
+          {
+            instants[0] = (TInstant *) inst1;
+            instants[1] = (TInstant *) TSEQUENCE_INST_N(seq, j);
+            result[nseqs++] = tsequence_make((const TInstant **) instants,
+              (i < j) ? 2 : 1, lower_inc, seq->period.upper_inc, STEP,
+              NORMALIZE_NO);
+          }
+        }
+        else
+        {
+          /* The value holds until the instant that follows the run */
+          instants[0] = (TInstant *) inst1;
+          instants[1] = tinstant_make(value1, inst1->temptype,
+            (TSEQUENCE_INST_N(seq, j + 1))->t);
+          result[nseqs++] = tsequence_make((const TInstant **) instants, 2,
+            lower_inc, false, STEP, NORMALIZE_NO);
+          pfree(instants[1]);
+        }
+      }
+      i = j + 1;
+    }
+    return nseqs;
+  }
+
+  /* Linear interpolation */
+  int first = 1, last = seq->count - 1;
+  if (atfunc && tnumber_type(seq->temptype) &&
+      MEOS_FLAGS_GET_MONOTONE(seq->flags))
+  {
+    /* The values are monotone: binary search the window of segments whose
+     * range may contain the value and skip the provably non-crossing ones */
+    meosType basetype = temptype_basetype(seq->temptype);
+    int dir = datum_cmp(tinstant_value(TSEQUENCE_INST_N(seq, 0)),
+      tinstant_value(TSEQUENCE_INST_N(seq, seq->count - 1)), basetype) <= 0 ?
+      1 : -1;
+    /* First instant whose value is not before the searched value */
+    int lo = 0, hi = seq->count;
+    while (lo < hi)
+    {
+      int middle = (lo + hi) / 2;
+      if (dir * datum_cmp(tinstant_value(TSEQUENCE_INST_N(seq, middle)),
+            value, basetype) < 0)
+        lo = middle + 1;
+      else
+        hi = middle;
+    }
+    if (lo == seq->count)
+      /* All values are before the searched value */
+      return 0;
+    first = Max(lo, 1);
+    /* First instant whose value is after the searched value */
+    hi = seq->count;
+    while (lo < hi)
+    {
+      int middle = (lo + hi) / 2;
+      if (dir * datum_cmp(tinstant_value(TSEQUENCE_INST_N(seq, middle)),
+            value, basetype) <= 0)
+        lo = middle + 1;
+      else
+        hi = middle;
+    }
+    if (lo == 0)
+      /* All values are after the searched value */
+      return 0;
+    last = Min(lo, seq->count - 1);
+  }
+  inst1 = TSEQUENCE_INST_N(seq, first - 1);
+  bool lower_inc = (first == 1) ? seq->period.lower_inc : true;
+  for (int i = first; i <= last; i++)
   {
     const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
     bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
@@ -3898,6 +4934,12 @@ TSequenceSet *
 tcontseq_restrict_value(const TSequence *seq, Datum value, bool atfunc)
 {
   assert(seq);
+  /* For a temporal number whose bounding span does not contain the value
+   * at returns nothing, without allocating the result array */
+  if (atfunc && tnumber_type(seq->temptype) &&
+      ! contains_span_value(&((TBox *) TSEQUENCE_BBOX_PTR(seq))->span,
+          value, temptype_basetype(seq->temptype)))
+    return NULL;
   int count = seq->count;
   /* For minus and linear interpolation we need the double of the count */
   if (! atfunc && MEOS_FLAGS_LINEAR_INTERP(seq->flags))
@@ -3909,6 +4951,25 @@ tcontseq_restrict_value(const TSequence *seq, Datum value, bool atfunc)
 
 /*****************************************************************************/
 
+/**
+ * @brief Return the position of the first value of a sorted set that is not
+ * less than the given value
+ */
+static int
+set_lower_bound(const Set *s, Datum d)
+{
+  int first = 0, last = s->count;
+  while (first < last)
+  {
+    int middle = (first + last) / 2;
+    if (datum_cmp(SET_VAL_N(s, middle), d, s->basetype) < 0)
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
 /**
  * @brief Restrict a temporal sequence to an array of base values
  * (iterator function)
@@ -3944,6 +5005,8 @@ tsequence_at_values_iter(const TSequence *seq, const Set *set,
 
   /* General case */
   interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  meosType basetype = temptype_basetype(seq->temptype);
+  bool number = tnumber_type(seq->temptype);
   inst1 = TSEQUENCE_INST_N(seq, 0);
   bool lower_inc = seq->period.lower_inc;
   int nseqs = 0;
@@ -3951,10 +5014,44 @@ tsequence_at_values_iter(const TSequence *seq, const Set *set,
   {
     inst2 = TSEQUENCE_INST_N(seq, i);
     bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-    for (int j = 0; j < set->count; j++)
-      /* Each iteration adds between 0 and 2 sequences */
-      nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
-        upper_inc, SET_VAL_N(set, j), REST_AT, &result[nseqs]);
+    Datum value1 = tinstant_value(inst1);
+    Datum value2 = tinstant_value(inst2);
+    int loc;
+    /* The values of a set are sorted: restrict the inner loop to the values
+     * that can intersect the segment instead of scanning the whole set */
+    if (interp != LINEAR || datum_eq(value1, value2, basetype))
+    {
+      /* Constant or step segment: only the values at the bounds of the
+       * segment can contribute to the result */
+      if (set_find_value(set, value1, &loc))
+        nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
+          upper_inc, SET_VAL_N(set, loc), REST_AT, &result[nseqs]);
+      if (datum_ne(value1, value2, basetype) &&
+          set_find_value(set, value2, &loc))
+        nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
+          upper_inc, SET_VAL_N(set, loc), REST_AT, &result[nseqs]);
+    }
+    else if (number)
+    {
+      /* Linear segment of a temporal number: only the values within the
+       * range of the segment can intersect it */
+      Datum minvalue = datum_cmp(value1, value2, basetype) < 0 ?
+        value1 : value2;
+      Datum maxvalue = datum_cmp(value1, value2, basetype) < 0 ?
+        value2 : value1;
+      for (int j = set_lower_bound(set, minvalue); j < set->count &&
+           datum_cmp(SET_VAL_N(set, j), maxvalue, basetype) <= 0; j++)
+        /* Each iteration adds between 0 and 2 sequences */
+        nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
+          upper_inc, SET_VAL_N(set, j), REST_AT, &result[nseqs]);
+    }
+    else
+    {
+      for (int j = 0; j < set->count; j++)
+        /* Each iteration adds between 0 and 2 sequences */
+        nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
+          upper_inc, SET_VAL_N(set, j), REST_AT, &result[nseqs]);
+    }
     inst1 = inst2;
     lower_inc = true;
   }
@@ -4796,6 +5893,33 @@ tsequence_at_timestamp(const TSequence *seq, TimestampTz t)
     return tcontseq_at_timestamp(seq, t);
 }
 
+/**
+ * @brief Return a pointer to the instant of a temporal sequence at a
+ * timestamp, if any
+ *
+ * Zero-allocation companion of #tsequence_at_timestamp for read-only
+ * inspection: the result points into the sequence and is valid as long as the
+ * sequence is. The function returns NULL when the timestamp does not coincide
+ * with one of the composing instants, in particular when the value at the
+ * timestamp must be interpolated.
+ */
+const TInstant *
+tsequence_inst_at_timestamp(const TSequence *seq, TimestampTz t)
+{
+  assert(seq);
+  if (MEOS_FLAGS_DISCRETE_INTERP(seq->flags))
+  {
+    int loc = tdiscseq_find_timestamp(seq, t);
+    return (loc >= 0) ? TSEQUENCE_INST_N(seq, loc) : NULL;
+  }
+  /* Bounding box test */
+  if (! contains_period_timestamp(&seq->period, t))
+    return NULL;
+  int n = tcontseq_find_timestamp(seq, t);
+  const TInstant *inst = TSEQUENCE_INST_N(seq, n);
+  return (inst->t == t) ? inst : NULL;
+}
+
 /*****************************************************************************/
 
 /**
@@ -4946,15 +6070,33 @@ tcontseq_at_timestampset(const TSequence *seq, const Set *s)
     DatumGetTimestampTz(SET_VAL_N(s, 0)));
   int loc;
   set_find_value(s, TimestampTzGetDatum(t), &loc);
-  TInstant **instants = palloc(sizeof(TInstant *) * (s->count - loc));
+  /* Locate all the timestamps in a single forward pass */
+  int nprobes = s->count - loc;
+  TimestampTz *times = palloc(sizeof(TimestampTz) * nprobes);
+  for (int i = 0; i < nprobes; i++)
+    times[i] = DatumGetTimestampTz(SET_VAL_N(s, loc + i));
+  int *locs = palloc(sizeof(int) * nprobes);
+  tcontseq_find_timestamp_batch(seq, times, nprobes, locs);
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  TInstant **instants = palloc(sizeof(TInstant *) * nprobes);
   int ninsts = 0;
-  for (int i = loc; i < s->count; i++)
+  for (int i = 0; i < nprobes; i++)
   {
-    t = DatumGetTimestampTz(SET_VAL_N(s, i));
-    inst = tcontseq_at_timestamp(seq, t);
-    if (inst != NULL)
-      instants[ninsts++] = inst;
+    if (locs[i] < 0)
+      continue;
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq, locs[i]);
+    if (inst1->t == times[i])
+    {
+      /* The last instant is excluded when the upper bound is exclusive */
+      if (locs[i] == seq->count - 1 && ! seq->period.upper_inc)
+        continue;
+      instants[ninsts++] = tinstant_copy(inst1);
+    }
+    else
+      instants[ninsts++] = tsegment_at_timestamp(inst1,
+        TSEQUENCE_INST_N(seq, locs[i] + 1), interp, times[i]);
   }
+  pfree(times); pfree(locs);
   return tsequence_make_free(instants, ninsts, true, true, DISCRETE, NORMALIZE_NO);
 }
 
@@ -5123,8 +6265,7 @@ tcontseq_at_period(const TSequence *seq, const Span *s)
   if (inter.lower == inter.upper)
   {
     TInstant *inst = tcontseq_at_timestamp(seq, inter.lower);
-    result = tinstant_to_tsequence(inst, interp);
-    pfree(inst);
+    result = tinstant_to_tsequence_free(inst, interp);
     return result;
   }
 
@@ -5448,7 +6589,8 @@ tcontseq_insert(const TSequence *seq1, const TSequence *seq2)
   sequences[nseqs++] = (TSequence *) seq2;
 
   int count;
-  TSequence **newseqs = tsequence_merge_array1(sequences, nseqs, &count);
+  TSequence **newseqs = tsequence_merge_array1(sequences, nseqs, false,
+    &count);
   Temporal *result;
   if (count == 1)
   {
@@ -5826,6 +6968,78 @@ tsequence_restrict_periodset(const TSequence *seq, const SpanSet *ss,
  * Local aggregate functions
  *****************************************************************************/
 
+/** Number of instants up to which the batch reduction kernels run on a
+ * stack buffer instead of allocating the gathered arrays */
+#define TNUMBERSEQ_BATCH_STACKCOUNT 32
+
+/**
+ * @brief Gather the values and the timestamps of a temporal number sequence
+ * into contiguous double arrays
+ * @note The gathered arrays feed the batch reduction kernels below; the base
+ * type test is hoisted out of the loop so that the float case reduces to a
+ * strided copy
+ */
+static void
+tnumberseq_gather(const TSequence *seq, double *restrict values,
+  double *restrict times)
+{
+  meosType basetype = temptype_basetype(seq->temptype);
+  if (basetype == T_FLOAT8)
+    for (int i = 0; i < seq->count; i++)
+      values[i] = DatumGetFloat8(tinstant_value(TSEQUENCE_INST_N(seq, i)));
+  else
+    for (int i = 0; i < seq->count; i++)
+      values[i] = datum_double(tinstant_value(TSEQUENCE_INST_N(seq, i)),
+        basetype);
+  if (times)
+    for (int i = 0; i < seq->count; i++)
+      times[i] = (double) TSEQUENCE_INST_N(seq, i)->t;
+  return;
+}
+
+/**
+ * @brief Sum the values of a gathered sequence (batch kernel)
+ * @note The reduction loops run over contiguous arrays without calls or
+ * branches so that the compiler can vectorize them, instead of one Datum
+ * call per instant as in the scalar loops they replace
+ */
+static double
+tnumberseq_batch_sum(const double *restrict values, int count)
+{
+  double result = 0.0;
+  for (int i = 0; i < count; i++)
+    result += values[i];
+  return result;
+}
+
+/**
+ * @brief Trapezoidal time-weighted integral of a gathered sequence with
+ * linear interpolation (batch kernel)
+ */
+static double
+tnumberseq_batch_trapezoid(const double *restrict values,
+  const double *restrict times, int count)
+{
+  double result = 0.0;
+  for (int i = 0; i < count - 1; i++)
+    result += (values[i] + values[i + 1]) * (times[i + 1] - times[i]);
+  return result / 2.0;
+}
+
+/**
+ * @brief Time-weighted integral of a gathered sequence with step
+ * interpolation (batch kernel)
+ */
+static double
+tnumberseq_batch_step(const double *restrict values,
+  const double *restrict times, int count)
+{
+  double result = 0.0;
+  for (int i = 0; i < count - 1; i++)
+    result += values[i] * (times[i + 1] - times[i]);
+  return result;
+}
+
 /**
  * @ingroup libmeos_internal_temporal_agg
  * @brief Return the integral (area under the curve) of a temporal sequence
@@ -5836,28 +7050,20 @@ tnumberseq_integral(const TSequence *seq)
 {
   assert(seq);
   assert(tnumber_type(seq->temptype));
-  double result = 0;
-  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
-  for (int i = 1; i < seq->count; i++)
-  {
-    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
-    if (MEOS_FLAGS_LINEAR_INTERP(seq->flags))
-    {
-      /* Linear interpolation */
-      double min = Min(DatumGetFloat8(tinstant_value(inst1)),
-        DatumGetFloat8(tinstant_value(inst2)));
-      double max = Max(DatumGetFloat8(tinstant_value(inst1)),
-        DatumGetFloat8(tinstant_value(inst2)));
-      result += (max + min) * (double) (inst2->t - inst1->t) / 2.0;
-    }
-    else
-    {
-      /* Step interpolation */
-      result += datum_double(tinstant_value(inst1),
-        temptype_basetype(inst1->temptype)) * (double) (inst2->t - inst1->t);
-    }
-    inst1 = inst2;
-  }
+  if (seq->count < 2)
+    return 0.0;
+  /* Gather the values and timestamps into contiguous arrays and reduce them
+   * with the batch kernels */
+  double stackbuf[TNUMBERSEQ_BATCH_STACKCOUNT * 2];
+  double *values = (seq->count <= TNUMBERSEQ_BATCH_STACKCOUNT) ?
+    stackbuf : palloc(sizeof(double) * seq->count * 2);
+  double *times = &values[seq->count];
+  tnumberseq_gather(seq, values, times);
+  double result = MEOS_FLAGS_LINEAR_INTERP(seq->flags) ?
+    tnumberseq_batch_trapezoid(values, times, seq->count) :
+    tnumberseq_batch_step(values, times, seq->count);
+  if (values != stackbuf)
+    pfree(values);
   return result;
 }
 
@@ -5871,14 +7077,14 @@ tnumberdiscseq_twavg(const TSequence *seq)
 {
   assert(seq);
   assert(tnumber_type(seq->temptype));
-  meosType basetype = temptype_basetype(seq->temptype);
-  double result = 0.0;
-  for (int i = 0; i < seq->count; i++)
-  {
-    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
-    result += datum_double(tinstant_value(inst), basetype);
-  }
-  return result / seq->count;
+  double stackbuf[TNUMBERSEQ_BATCH_STACKCOUNT];
+  double *values = (seq->count <= TNUMBERSEQ_BATCH_STACKCOUNT) ?
+    stackbuf : palloc(sizeof(double) * seq->count);
+  tnumberseq_gather(seq, values, NULL);
+  double result = tnumberseq_batch_sum(values, seq->count) / seq->count;
+  if (values != stackbuf)
+    pfree(values);
+  return result;
 }
 
 /**
@@ -5933,8 +7139,11 @@ tsequence_eq(const TSequence *seq1, const TSequence *seq2)
 {
   assert(seq1); assert(seq2);
   assert(seq1->temptype == seq2->temptype);
-  /* If number of sequences, flags, or periods are not equal */
-  if (seq1->count != seq2->count || seq1->flags != seq2->flags ||
+  /* If number of sequences, flags, or periods are not equal; the flags
+   * recording representation artifacts such as the skip index depend on the
+   * construction history and do not participate in the comparison */
+  if (seq1->count != seq2->count ||
+      ((seq1->flags ^ seq2->flags) & ~MEOS_FLAGS_REPRESENTATION) ||
       ! span_eq(&seq1->period, &seq2->period))
     return false;
 
@@ -5984,10 +7193,13 @@ tsequence_cmp(const TSequence *seq1, const TSequence *seq2)
   /* seq1->count == seq2->count because of the bounding box and the
    * composing instant tests above */
 
-  /* Compare flags  */
-  if (seq1->flags < seq2->flags)
+  /* Compare flags, masking out the representational ones so that the order
+   * does not depend on the construction history */
+  int16 flags1 = seq1->flags & ~MEOS_FLAGS_REPRESENTATION;
+  int16 flags2 = seq2->flags & ~MEOS_FLAGS_REPRESENTATION;
+  if (flags1 < flags2)
     return -1;
-  if (seq1->flags > seq2->flags)
+  if (flags1 > flags2)
     return 1;
 
   /* The two values are equal */
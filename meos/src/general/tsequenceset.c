@@ -45,7 +45,11 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/interrupt.h"
 #include "general/pg_types.h"
+#if MEOS
+  #include "general/pool.h"
+#endif
 #include "general/set.h"
 #include "general/spanset.h"
 #include "general/temporaltypes.h"
@@ -87,24 +91,28 @@
 bool
 tsequenceset_find_timestamp(const TSequenceSet *ss, TimestampTz t, int *loc)
 {
+  /* When available, binary search the packed summary array of the sequence
+   * periods, which avoids touching the scattered sequence headers */
+  const Span *periods = MEOS_FLAGS_GET_PERIODS(ss->flags) ?
+    TSEQUENCESET_PERIODS_PTR(ss) : NULL;
   int first = 0, last = ss->count - 1;
   int middle = 0; /* make compiler quiet */
-  const TSequence *seq = NULL; /* make compiler quiet */
+  const Span *p = NULL; /* make compiler quiet */
   while (first <= last)
   {
     middle = (first + last)/2;
-    seq = TSEQUENCESET_SEQ_N(ss, middle);
-    if (contains_period_timestamp(&seq->period, t))
+    p = periods ? &periods[middle] : &TSEQUENCESET_SEQ_N(ss, middle)->period;
+    if (contains_period_timestamp(p, t))
     {
       *loc = middle;
       return true;
     }
-    if (t <= DatumGetTimestampTz(seq->period.lower))
+    if (t <= DatumGetTimestampTz(p->lower))
       last = middle - 1;
     else
       first = middle + 1;
   }
-  if (seq && t >= DatumGetTimestampTz(seq->period.upper))
+  if (p && t >= DatumGetTimestampTz(p->upper))
     middle++;
   *loc = middle;
   return false;
@@ -219,11 +227,24 @@ TSEQUENCESET_SEQ_N(const TSequenceSet *ss, int index)
     ((char *) &ss->period) + ss->bboxsize +
     (sizeof(size_t) * ss->maxcount) + (TSEQUENCESET_OFFSETS_PTR(ss))[index] );
 }
+
+/**
+ * @brief Return a pointer to the packed summary array of sequence periods
+ * stored at the end of a temporal sequence set
+ * @pre The periods flag of the sequence set is set
+ */
+const Span *
+TSEQUENCESET_PERIODS_PTR(const TSequenceSet *ss)
+{
+  return (const Span *)(
+    ((char *) ss) + VARSIZE(ss) - (sizeof(Span) * ss->count) );
+}
 #endif /* DEBUG_BUILD */
 
 /**
- * @ingroup libmeos_internal_temporal_constructor
- * @brief Construct a temporal sequence set from an array of temporal sequences
+ * @brief Construct a temporal sequence set from an array of temporal
+ * sequences, the main function of #tsequenceset_make_exp and
+ * #tsequenceset_make_trusted
  *
  * For example, the memory structure of a temporal sequence set with two
  * sequences is as follows
@@ -231,12 +252,14 @@ TSEQUENCESET_SEQ_N(const TSequenceSet *ss, int index)
  * ------------------------------------------------------------
  * ( TSequenceSet )_X | ( bbox )_X | offset_0 | offset_1 | ...
  * ------------------------------------------------------------
- * ---------------------------------------
- * ( TSequence_0 )_X | ( TSequence_1 )_X |
- * ---------------------------------------
+ * ---------------------------------------------------------------
+ * ( TSequence_0 )_X | ( TSequence_1 )_X | period_0 | period_1 |
+ * ---------------------------------------------------------------
  * @endcode
  * where the `_X` are unused bytes added for double padding, `offset_0` and
- * `offset_1` are offsets for the corresponding sequences.
+ * `offset_1` are offsets for the corresponding sequences, and `period_0`
+ * and `period_1` compose the packed summary array of the sequence periods,
+ * which is present only for non-expandable sequence sets.
  *
  * @param[in] sequences Array of sequences
  * @param[in] count Number of elements in the array
@@ -245,49 +268,91 @@ TSEQUENCESET_SEQ_N(const TSequenceSet *ss, int index)
  * In particular, normalize is false when synchronizing two temporal sequence
  * sets before applying an operation to them.
  */
-TSequenceSet *
-tsequenceset_make_exp(const TSequence **sequences, int count, int maxcount,
+static TSequenceSet *
+tsequenceset_make1_exp(const TSequence **sequences, int count, int maxcount,
   bool normalize)
 {
   assert(sequences); assert(count > 0); assert(count <= maxcount);
-  /* Ensure validity of the arguments */
-  if (! ensure_valid_tseqarr(sequences, count))
-    return NULL;
-
   /* Normalize the array of sequences */
   TSequence **normseqs = (TSequence **) sequences;
   int newcount = count;
   if (normalize && count > 1)
     normseqs = tseqarr_normalize(sequences, count, &newcount);
 
+  bool expandable = (count != maxcount);
+  /* For a non-expandable sequence set, strip the unused buffer space that
+   * member sequences constructed with expandable buffers carry, so that the
+   * stored value is as compact as possible. Following the note in
+   * #tsequence_compact, testing the maxcount does not detect the extra space
+   * possibly allocated for the (variable-length) instants, which is thus
+   * copied verbatim; this is acceptable since the bulk of the slack of the
+   * expandable sequences comes from the doubling of their maxcount */
+  bool compacted = false;
+  if (! expandable)
+  {
+    for (int i = 0; i < newcount; i++)
+    {
+      if (normseqs[i]->count < normseqs[i]->maxcount)
+      {
+        compacted = true;
+        break;
+      }
+    }
+    if (compacted)
+    {
+      TSequence **compactseqs = palloc(sizeof(TSequence *) * newcount);
+      for (int i = 0; i < newcount; i++)
+        compactseqs[i] = (normseqs[i]->count < normseqs[i]->maxcount) ?
+          tsequence_compact(normseqs[i]) : tsequence_copy(normseqs[i]);
+      if (normalize && count > 1)
+        pfree_array((void **) normseqs, newcount);
+      normseqs = compactseqs;
+    }
+  }
+
   /* Get the bounding box size */
   size_t bboxsize = DOUBLE_PAD(temporal_bbox_size(sequences[0]->temptype));
   /* The period component of the bbox is already declared in the struct */
   size_t bboxsize_extra = bboxsize - sizeof(Span);
 
-  /* Compute the size of the temporal sequence set */
+  /* Compute the size of the temporal sequence set. The loop also determines
+   * whether consecutive sequences share their boundary instant, in which
+   * case the totalcount overcounts the number of distinct instants */
   size_t seqs_size = 0;
   int totalcount = 0;
+  bool distinct = true;
   for (int i = 0; i < newcount; i++)
   {
     totalcount += normseqs[i]->count;
     seqs_size += DOUBLE_PAD(VARSIZE(normseqs[i]));
+    if (i > 0 && distinct && tinstant_eq(
+          TSEQUENCE_INST_N(normseqs[i - 1], normseqs[i - 1]->count - 1),
+          TSEQUENCE_INST_N(normseqs[i], 0)))
+      distinct = false;
   }
   /* Compute the total size for maxcount sequences as a proportion of the size
    * of the count sequences provided. Note that this is only an initial
    * estimation. The functions adding sequences to a sequence set must verify
    * both the maximum number of sequences and the remaining space for adding an
    * additional variable-length sequences of arbitrary size */
-  if (count != maxcount)
+  if (expandable)
     seqs_size *= maxcount / count;
   else
     maxcount = newcount;
+  /* For a non-expandable sequence set, a packed summary array of the sequence
+   * periods is appended at the end so that restriction functions can binary
+   * search within a contiguous block without touching the sequences. The
+   * array is not maintained for expandable sequence sets since the functions
+   * appending sequences reuse the space at the end */
+  size_t periods_size = expandable ? 0 : sizeof(Span) * newcount;
   /* Size of the struct and the offset array */
   size_t memsize = DOUBLE_PAD(sizeof(TSequenceSet)) + bboxsize_extra +
-    sizeof(size_t) * maxcount + seqs_size;
+    sizeof(size_t) * maxcount + seqs_size + periods_size;
 
   /* Create the temporal sequence set */
+  MEOS_ALLOC_TAG(MEOS_ALLOC_TSEQUENCESET);
   TSequenceSet *result = palloc0(memsize);
+  MEOS_ALLOC_TAG(MEOS_ALLOC_GENERIC);
   SET_VARSIZE(result, memsize);
   result->count = newcount;
   result->maxcount = maxcount;
@@ -301,6 +366,9 @@ tsequenceset_make_exp(const TSequence **sequences, int count, int maxcount,
     MEOS_FLAGS_GET_INTERP(sequences[0]->flags));
   MEOS_FLAGS_SET_X(result->flags, true);
   MEOS_FLAGS_SET_T(result->flags, true);
+  /* When the flag is set the accessor functions can use the totalcount as
+   * the number of distinct instants without walking the sequences */
+  MEOS_FLAGS_SET_DISTINCT(result->flags, distinct);
   if (tgeo_type(sequences[0]->temptype))
   {
     MEOS_FLAGS_SET_Z(result->flags, MEOS_FLAGS_GET_Z(sequences[0]->flags));
@@ -322,11 +390,85 @@ tsequenceset_make_exp(const TSequence **sequences, int count, int maxcount,
     (TSEQUENCESET_OFFSETS_PTR(result))[i] = pos;
     pos += DOUBLE_PAD(VARSIZE(normseqs[i]));
   }
-  if (normalize && count > 1)
+  /* Fill the packed summary array of the sequence periods */
+  if (! expandable)
+  {
+    MEOS_FLAGS_SET_PERIODS(result->flags, true);
+    Span *periods = (Span *) TSEQUENCESET_PERIODS_PTR(result);
+    for (int i = 0; i < newcount; i++)
+      periods[i] = normseqs[i]->period;
+  }
+  if (compacted || (normalize && count > 1))
     pfree_array((void **) normseqs, newcount);
   return result;
 }
 
+/**
+ * @ingroup libmeos_internal_temporal_constructor
+ * @brief Construct a temporal sequence set from an array of temporal
+ * sequences enabling the data structure to expand.
+ * @param[in] sequences Array of sequences
+ * @param[in] count Number of elements in the array
+ * @param[in] maxcount Maximum number of elements in the array
+ * @param[in] normalize True if the resulting value should be normalized.
+ * In particular, normalize is false when synchronizing two temporal sequence
+ * sets before applying an operation to them.
+ */
+TSequenceSet *
+tsequenceset_make_exp(const TSequence **sequences, int count, int maxcount,
+  bool normalize)
+{
+  assert(sequences); assert(count > 0); assert(count <= maxcount);
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_tseqarr(sequences, count))
+    return NULL;
+  return tsequenceset_make1_exp(sequences, count, maxcount, normalize);
+}
+
+/**
+ * @ingroup libmeos_internal_temporal_constructor
+ * @brief Construct a temporal sequence set from an array of temporal
+ * sequences, applying the requested validation level.
+ *
+ * This constructor is intended for machine-generated input, for example,
+ * sequences assembled from position reports received in ascending timestamp
+ * order, where the caller can guarantee the validity of the array and thus
+ * reduce the validation performed by #tsequenceset_make to an ordering test
+ * or skip it altogether.
+ * @param[in] sequences Array of sequences
+ * @param[in] count Number of elements in the array
+ * @param[in] normalize True if the resulting value should be normalized
+ * @param[in] validate Validation level applied to the array
+ */
+TSequenceSet *
+tsequenceset_make_trusted(const TSequence **sequences, int count,
+  bool normalize, validateLevel validate)
+{
+  assert(sequences); assert(count > 0);
+  if (validate == VALIDATE_FULL && ! ensure_valid_tseqarr(sequences, count))
+    return NULL;
+  if (validate == VALIDATE_ORDER)
+  {
+    /* Verify that the periods of the sequences are in increasing order */
+    for (int i = 1; i < count; i++)
+    {
+      TimestampTz upper1 = DatumGetTimestampTz(sequences[i - 1]->period.upper);
+      TimestampTz lower2 = DatumGetTimestampTz(sequences[i]->period.lower);
+      if ( upper1 > lower2 ||
+           ( upper1 == lower2 && sequences[i - 1]->period.upper_inc &&
+             sequences[i]->period.lower_inc ) )
+      {
+        char *t1 = pg_timestamptz_out(upper1);
+        char *t2 = pg_timestamptz_out(lower2);
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "Timestamps for temporal value must be increasing: %s, %s", t1, t2);
+        return NULL;
+      }
+    }
+  }
+  return tsequenceset_make1_exp(sequences, count, count, normalize);
+}
+
 /**
  * @ingroup libmeos_temporal_constructor
  * @brief Construct a temporal sequence set from an array of temporal sequences.
@@ -1009,6 +1151,11 @@ int
 tsequenceset_num_instants(const TSequenceSet *ss)
 {
   assert(ss);
+  /* The flag set at construction states that no boundary instant is shared
+   * by consecutive sequences, so the total count maintained in the header
+   * can be returned without walking the sequences */
+  if (MEOS_FLAGS_GET_DISTINCT(ss->flags))
+    return ss->totalcount;
   const TInstant *lastinst = NULL; /* make compiler quiet */
   bool first = true;
   int result = 0;
@@ -1070,6 +1217,28 @@ tsequenceset_inst_n(const TSequenceSet *ss, int n)
   return next;
 }
 
+/**
+ * @brief Return a pointer to the instant of a temporal sequence set at a
+ * timestamp, if any
+ *
+ * Zero-allocation companion of the restriction to a timestamp for read-only
+ * inspection: the result points into the sequence set and is valid as long as
+ * the sequence set is. The function returns NULL when the timestamp does not
+ * coincide with one of the composing instants.
+ */
+const TInstant *
+tsequenceset_inst_at_timestamp(const TSequenceSet *ss, TimestampTz t)
+{
+  assert(ss);
+  /* Bounding box test */
+  if (! contains_period_timestamp(&ss->period, t))
+    return NULL;
+  int loc;
+  if (! tsequenceset_find_timestamp(ss, t, &loc))
+    return NULL;
+  return tsequence_inst_at_timestamp(TSEQUENCESET_SEQ_N(ss, loc), t);
+}
+
 /**
  * @ingroup libmeos_internal_temporal_accessor
  * @brief Return the distinct instants of a temporal sequence set.
@@ -1326,9 +1495,27 @@ tsequenceset_restart(TSequenceSet *ss, int count)
   /* Copy the last instants at the beginning */
   last_n = TSEQUENCESET_SEQ_N(ss, ss->count - count);
   memcpy(first, last_n, seq_size);
-  /* Update the counts and the bounding box */
+  /* Bump the generation so that attached caches notice the in-place
+   * modification */
+  ss->generation++;
+  /* Update the counts and the bounding box; the periods summary array, if
+   * any, is no longer valid after the in-place modification */
+  MEOS_FLAGS_SET_PERIODS(ss->flags, false);
   ss->count = count;
   ss->totalcount = totalcount;
+  /* Recompute the distinct instants flag: the sequences sharing a boundary
+   * instant may have been dropped, in which case the remaining ones satisfy
+   * the flag even though the original sequence set did not */
+  bool distinct = true;
+  for (int i = 1; i < count && distinct; i++)
+  {
+    const TSequence *seq1 = TSEQUENCESET_SEQ_N(ss, i - 1);
+    const TSequence *seq2 = TSEQUENCESET_SEQ_N(ss, i);
+    if (tinstant_eq(TSEQUENCE_INST_N(seq1, seq1->count - 1),
+          TSEQUENCE_INST_N(seq2, 0)))
+      distinct = false;
+  }
+  MEOS_FLAGS_SET_DISTINCT(ss->flags, distinct);
   size_t bboxsize = DOUBLE_PAD(temporal_bbox_size(ss->temptype));
   if (bboxsize != 0)
     tsequenceset_compute_bbox(ss);
@@ -1349,9 +1536,7 @@ tinstant_to_tsequenceset(const TInstant *inst, interpType interp)
   assert(inst);
   assert(interp == STEP || interp == LINEAR);
   TSequence *seq = tinstant_to_tsequence(inst, interp);
-  TSequenceSet *result = tsequence_to_tsequenceset(seq);
-  pfree(seq);
-  return result;
+  return tsequence_to_tsequenceset_free(seq);
 }
 
 /**
@@ -1394,6 +1579,21 @@ tsequence_to_tsequenceset(const TSequence *seq)
   return tsequenceset_make(&seq, 1, NORMALIZE_NO);
 }
 
+/**
+ * @ingroup libmeos_internal_temporal_transf
+ * @brief Return a temporal sequence transformed into a temporal sequence set
+ * and free the sequence after the conversion
+ * @see tsequence_to_tsequenceset
+ */
+TSequenceSet *
+tsequence_to_tsequenceset_free(TSequence *seq)
+{
+  assert(seq);
+  TSequenceSet *result = tsequence_to_tsequenceset(seq);
+  pfree(seq);
+  return result;
+}
+
 /**
  * @ingroup libmeos_internal_temporal_transf
  * @brief Return a temporal sequence transformed into a temporal sequence set.
@@ -1636,6 +1836,8 @@ tsequenceset_shift_scale_time(const TSequenceSet *ss, const Interval *shift,
   TimestampTz origin = DatumGetTimestampTz(result->period.lower);
 
   /* Shift and/or scale each composing sequence */
+  Span *periods = MEOS_FLAGS_GET_PERIODS(result->flags) ?
+    (Span *) TSEQUENCESET_PERIODS_PTR(result) : NULL;
   for (int i = 0; i < ss->count; i++)
   {
     TSequence *seq = (TSequence *) TSEQUENCESET_SEQ_N(result, i);
@@ -1643,6 +1845,9 @@ tsequenceset_shift_scale_time(const TSequenceSet *ss, const Interval *shift,
     period_delta_scale_iter(&seq->period, origin, delta, scale);
     /* Shift and/or scale each instant of the composing sequence */
     tsequence_shift_scale_time_iter(seq, delta, scale);
+    /* Keep the periods summary array, if any, in sync */
+    if (periods)
+      periods[i] = seq->period;
   }
   return result;
 }
@@ -1705,9 +1910,11 @@ bool
 tsequenceset_ever_lt(const TSequenceSet *ss, Datum value)
 {
   assert(ss);
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *)ss, value, EVER))
-    return false;
+  /* Bounding box test, which decides the answer for temporal numbers */
+  bool result;
+  if (tnumber_type(ss->temptype) &&
+      tnumber_bbox_ev_al_lt_le((Temporal *) ss, value, EVER, true, &result))
+    return result;
 
   for (int i = 0; i < ss->count; i++)
   {
@@ -1728,9 +1935,12 @@ bool
 tsequenceset_ever_le(const TSequenceSet *ss, Datum value)
 {
   assert(ss);
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *)ss, value, EVER))
-    return false;
+  /* Bounding box test, which decides the answer for temporal numbers unless
+   * the value is equal to a minimum that may not be attained */
+  bool result;
+  if (tnumber_type(ss->temptype) &&
+      tnumber_bbox_ev_al_lt_le((Temporal *) ss, value, EVER, false, &result))
+    return result;
 
   for (int i = 0; i < ss->count; i++)
   {
@@ -1750,9 +1960,13 @@ bool
 tsequenceset_always_lt(const TSequenceSet *ss, Datum value)
 {
   assert(ss);
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *)ss, value, ALWAYS))
-    return false;
+  /* Bounding box test, which decides the answer for temporal numbers unless
+   * the value is equal to a maximum that may not be attained */
+  bool result;
+  if (tnumber_type(ss->temptype) &&
+      tnumber_bbox_ev_al_lt_le((Temporal *) ss, value, ALWAYS, true,
+        &result))
+    return result;
 
   for (int i = 0; i < ss->count; i++)
   {
@@ -1773,14 +1987,12 @@ bool
 tsequenceset_always_le(const TSequenceSet *ss, Datum value)
 {
   assert(ss);
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *)ss, value, ALWAYS))
-    return false;
-
-  /* The bounding box test above is enough to compute
-   * the answer for temporal numbers */
-  if (tnumber_type(ss->temptype))
-    return true;
+  /* Bounding box test, which decides the answer for temporal numbers */
+  bool result;
+  if (tnumber_type(ss->temptype) &&
+      tnumber_bbox_ev_al_lt_le((Temporal *) ss, value, ALWAYS, false,
+        &result))
+    return result;
 
   for (int i = 0; i < ss->count; i++)
   {
@@ -1795,6 +2007,114 @@ tsequenceset_always_le(const TSequenceSet *ss, Datum value)
  * Restriction Functions
  *****************************************************************************/
 
+/**
+ * @brief Return an upper bound on the number of sequences resulting from
+ * restricting each component sequence to a base value, using the value
+ * dimension of the bounding boxes.
+ *
+ * A temporal number sequence whose bounding span does not contain the value
+ * cannot produce any result for at, so the result array can be allocated to
+ * the right size instead of the total number of instants. For minus no such
+ * per-sequence bound exists and the caller keeps the worst case.
+ * @param[in] ss Temporal sequence set
+ * @param[in] value Base value
+ * @param[out] counts Per-sequence bounds, may be NULL
+ */
+static int
+tsequenceset_at_value_maxcount(const TSequenceSet *ss, Datum value,
+  int *counts)
+{
+  assert(tnumber_type(ss->temptype));
+  meosType basetype = temptype_basetype(ss->temptype);
+  int count = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    TBox *box = TSEQUENCE_BBOX_PTR(seq);
+    int c = contains_span_value(&box->span, value, basetype) ?
+      seq->count : 0;
+    if (counts)
+      counts[i] = c;
+    count += c;
+  }
+  return count;
+}
+
+#if MEOS
+/** Arguments of the restriction tasks submitted to the thread pool */
+typedef struct TseqsetRestrictValueTask
+{
+  const TSequenceSet *ss; /**< Sequence set being restricted */
+  Datum value;            /**< Restriction value */
+  bool atfunc;            /**< True if the restriction is at, false for minus */
+  TSequence **sequences;  /**< Array receiving the resulting sequences */
+  const int *offsets;     /**< Slot where each sequence writes its results */
+  int *counts;            /**< Number of results of each sequence */
+} TseqsetRestrictValueTask;
+
+/**
+ * @brief Restrict one sequence of a sequence set to (the complement of) a
+ * base value, task function executed on the thread pool
+ */
+static void
+tsequenceset_restrict_value_task(void *arg, int idx)
+{
+  TseqsetRestrictValueTask *task = (TseqsetRestrictValueTask *) arg;
+  task->counts[idx] = tcontseq_restrict_value_iter(
+    TSEQUENCESET_SEQ_N(task->ss, idx), task->value, task->atfunc,
+    &task->sequences[task->offsets[idx]]);
+  return;
+}
+
+/**
+ * @brief Restrict a temporal sequence set to (the complement of) a base
+ * value restricting the component sequences on the thread pool
+ *
+ * Each sequence writes its results at a precomputed offset bounding its
+ * maximum number of results; the resulting array is compacted afterwards.
+ */
+static TSequenceSet *
+tsequenceset_restrict_value_parallel(const TSequenceSet *ss, Datum value,
+  bool atfunc)
+{
+  /* For minus and linear interpolation we need the double of the count */
+  int mult = (! atfunc && MEOS_FLAGS_LINEAR_INTERP(ss->flags)) ? 2 : 1;
+  int *offsets = palloc(sizeof(int) * ss->count);
+  int *counts = palloc(sizeof(int) * ss->count);
+  /* For at the bounding boxes yield right-sized per-sequence bounds */
+  int *maxcounts = NULL;
+  if (atfunc && tnumber_type(ss->temptype))
+  {
+    maxcounts = palloc(sizeof(int) * ss->count);
+    tsequenceset_at_value_maxcount(ss, value, maxcounts);
+  }
+  int count = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    offsets[i] = count;
+    count += maxcounts ?
+      maxcounts[i] : TSEQUENCESET_SEQ_N(ss, i)->count * mult;
+  }
+  if (maxcounts)
+    pfree(maxcounts);
+  TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  TseqsetRestrictValueTask task =
+    { ss, value, atfunc, sequences, offsets, counts };
+  meos_pool_parallel_for(ss->count, &tsequenceset_restrict_value_task, &task);
+  /* Compact the per-sequence results */
+  int nseqs = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    if (nseqs != offsets[i] && counts[i] > 0)
+      memmove(&sequences[nseqs], &sequences[offsets[i]],
+        sizeof(TSequence *) * counts[i]);
+    nseqs += counts[i];
+  }
+  pfree(offsets); pfree(counts);
+  return tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+}
+#endif /* MEOS */
+
 /**
  * @ingroup libmeos_internal_temporal_restrict
  * @brief Restrict a temporal sequence set to (the complement of) a base value.
@@ -1812,10 +2132,24 @@ tsequenceset_restrict_value(const TSequenceSet *ss, Datum value, bool atfunc)
     return tcontseq_restrict_value(TSEQUENCESET_SEQ_N(ss, 0), value, atfunc);
 
   /* General case */
-  int count = ss->totalcount;
-  /* For minus and linear interpolation we need the double of the count */
-  if (! atfunc && MEOS_FLAGS_LINEAR_INTERP(ss->flags))
-    count *= 2;
+#if MEOS
+  if (meos_pool_active())
+    return tsequenceset_restrict_value_parallel(ss, value, atfunc);
+#endif /* MEOS */
+  int count;
+  if (atfunc && tnumber_type(ss->temptype))
+    /* The bounding boxes yield a right-sized bound for at */
+    count = tsequenceset_at_value_maxcount(ss, value, NULL);
+  else
+  {
+    count = ss->totalcount;
+    /* For minus and linear interpolation we need the double of the count */
+    if (! atfunc && MEOS_FLAGS_LINEAR_INTERP(ss->flags))
+      count *= 2;
+  }
+  if (count == 0)
+    /* No sequence can contain the value */
+    return NULL;
   TSequence **sequences = palloc(sizeof(TSequence *) * count);
   int nseqs = 0;
   for (int i = 0; i < ss->count; i++)
@@ -2187,6 +2521,104 @@ tsequenceset_restrict_period(const TSequenceSet *ss, const Span *s,
   }
 }
 
+#if MEOS
+/** Arguments of the period set restriction tasks submitted to the thread
+ * pool */
+typedef struct TseqsetRestrictPeriodSetTask
+{
+  const TSequenceSet *ss; /**< Sequence set being restricted */
+  const SpanSet *ps;      /**< Restriction period set */
+  bool atfunc;            /**< True if the restriction is at, false for minus */
+  TSequence **sequences;  /**< Array receiving the resulting sequences */
+  const int *offsets;     /**< Slot where each sequence writes its results */
+  int *counts;            /**< Number of results of each sequence */
+} TseqsetRestrictPeriodSetTask;
+
+/**
+ * @brief Restrict one sequence of a sequence set to (the complement of) a
+ * period set, task function executed on the thread pool
+ */
+static void
+tsequenceset_restrict_periodset_task(void *arg, int idx)
+{
+  TseqsetRestrictPeriodSetTask *task = (TseqsetRestrictPeriodSetTask *) arg;
+  const TSequence *seq = TSEQUENCESET_SEQ_N(task->ss, idx);
+  TSequence **result = &task->sequences[task->offsets[idx]];
+  /* Bounding box test */
+  if (! overlaps_span_span(&seq->period, &task->ps->span))
+  {
+    if (task->atfunc)
+      task->counts[idx] = 0;
+    else
+    {
+      result[0] = tsequence_copy(seq);
+      task->counts[idx] = 1;
+    }
+    return;
+  }
+  task->counts[idx] = task->atfunc ?
+    tcontseq_at_periodset1(seq, task->ps, result) :
+    tcontseq_minus_periodset_iter(seq, task->ps, result);
+  return;
+}
+
+/**
+ * @brief Restrict a temporal sequence set to (the complement of) a period
+ * set restricting the component sequences on the thread pool
+ *
+ * The component sequences are independent, so each one is restricted to the
+ * full period set by its own task and writes its results at a precomputed
+ * offset; the resulting array is compacted afterwards. The per-sequence
+ * bound on the number of results is obtained with two binary searches
+ * locating the periods overlapping the sequence.
+ */
+static TSequenceSet *
+tsequenceset_restrict_periodset_parallel(const TSequenceSet *ss,
+  const SpanSet *ps, bool atfunc)
+{
+  int *offsets = palloc(sizeof(int) * ss->count);
+  int *counts = palloc(sizeof(int) * ss->count);
+  /* When available, use the packed summary array of the sequence periods to
+   * compute the bounds without touching the sequence headers */
+  const Span *periods = MEOS_FLAGS_GET_PERIODS(ss->flags) ?
+    TSEQUENCESET_PERIODS_PTR(ss) : NULL;
+  int count = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const Span *per = periods ? &periods[i] :
+      &TSEQUENCESET_SEQ_N(ss, i)->period;
+    /* A sequence yields at most one result per overlapping period, plus
+     * one result for minus */
+    int loclo, lochi;
+    spanset_find_value(ps, per->lower, &loclo);
+    spanset_find_value(ps, per->upper, &lochi);
+    if (lochi >= ps->count)
+      lochi = ps->count - 1;
+    int c = Max(lochi - loclo + 1, 0);
+    if (! atfunc)
+      c++;
+    offsets[i] = count;
+    count += c;
+  }
+  TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  TseqsetRestrictPeriodSetTask task =
+    { ss, ps, atfunc, sequences, offsets, counts };
+  meos_pool_parallel_for(ss->count, &tsequenceset_restrict_periodset_task,
+    &task);
+  /* Compact the per-sequence results */
+  int nseqs = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    if (nseqs != offsets[i] && counts[i] > 0)
+      memmove(&sequences[nseqs], &sequences[offsets[i]],
+        sizeof(TSequence *) * counts[i]);
+    nseqs += counts[i];
+  }
+  pfree(offsets); pfree(counts);
+  return tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+}
+#endif /* MEOS */
+
 /**
  * @ingroup libmeos_internal_temporal_restrict
  * @brief Restrict a temporal sequence set to (the complement of) a period set.
@@ -2209,6 +2641,11 @@ tsequenceset_restrict_periodset(const TSequenceSet *ss, const SpanSet *ps,
   if (ss->count == 1)
     return tcontseq_restrict_periodset(TSEQUENCESET_SEQ_N(ss, 0), ps, atfunc);
 
+#if MEOS
+  if (meos_pool_active())
+    return tsequenceset_restrict_periodset_parallel(ss, ps, atfunc);
+#endif /* MEOS */
+
   /* General case */
   TSequence **sequences;
   int i = 0, j = 0, nseqs = 0;
@@ -2222,20 +2659,34 @@ tsequenceset_restrict_periodset(const TSequenceSet *ss, const SpanSet *ps,
   }
   else
     sequences = palloc(sizeof(TSequence *) * (ss->count + ps->count));
+  /* When available, use the packed summary array of the sequence periods to
+   * prune the non-overlapping sequences without touching their headers */
+  const Span *periods = MEOS_FLAGS_GET_PERIODS(ss->flags) ?
+    TSEQUENCESET_PERIODS_PTR(ss) : NULL;
   while (i < ss->count && j < ps->count)
   {
-    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    if (meos_interrupt_check())
+    {
+      for (int k = 0; k < nseqs; k++)
+        pfree(sequences[k]);
+      pfree(sequences);
+      return NULL;
+    }
+    meos_progress_report((double) i / ss->count);
+    const Span *seqper = periods ? &periods[i] :
+      &TSEQUENCESET_SEQ_N(ss, i)->period;
     const Span *p = spanset_sp_n(ps, j);
     /* The sequence and the period do not overlap */
-    if (left_span_span(&seq->period, p))
+    if (left_span_span(seqper, p))
     {
       if (! atfunc)
         /* Copy the sequence */
-        sequences[nseqs++] = tsequence_copy(seq);
+        sequences[nseqs++] = tsequence_copy(TSEQUENCESET_SEQ_N(ss, i));
       i++;
     }
-    else if (overlaps_span_span(&seq->period, p))
+    else if (overlaps_span_span(seqper, p))
     {
+      const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
       if (atfunc)
       {
         /* Compute the restriction of the sequence and the period */
@@ -2289,19 +2740,21 @@ tsequenceset_restrict_periodset(const TSequenceSet *ss, const SpanSet *ps,
  * @param[in] inst Temporal instant
  * @param[in] maxdist Maximum distance for defining a gap
  * @param[in] maxt Maximum time interval for defining a gap
+ * @param[in] tolerance Tolerance of the dead-reckoning filter, see
+ * #tsequence_append_tinstant
  * @param[in] expand True when reserving space for additional instants
  * @sqlfunc appendInstantGaps()
  */
 TSequenceSet *
 tsequenceset_append_tinstant(TSequenceSet *ss, const TInstant *inst,
-  double maxdist, const Interval *maxt, bool expand)
+  double maxdist, const Interval *maxt, double tolerance, bool expand)
 {
   assert(ss); assert(inst);
   assert(ss->temptype == inst->temptype);
   /* Append the instant to the last sequence */
   TSequence *last = (TSequence *) TSEQUENCESET_SEQ_N(ss, ss->count - 1);
   Temporal *temp = tsequence_append_tinstant(last, inst, maxdist, maxt,
-    expand);
+    tolerance, expand);
   /* The result may be a single sequence or a sequence set with 2 sequences */
   TSequence *seq1 = NULL, *seq2 = NULL;
   TSequenceSet *ss1 = NULL;
@@ -2324,6 +2777,8 @@ tsequenceset_append_tinstant(TSequenceSet *ss, const TInstant *inst,
    * no more available space */
   while (expand && count <= ss->maxcount)
   {
+    /* The periods summary array, if any, is overwritten when expanding */
+    MEOS_FLAGS_SET_PERIODS(ss->flags, false);
     /* Append the new sequence(s) if there is enough space: only one if the
      * instant was appended to the last sequence, or the two sequences
      * composing the sequence set that results from appending the instant */
@@ -2339,6 +2794,9 @@ tsequenceset_append_tinstant(TSequenceSet *ss, const TInstant *inst,
       break;
 
     /* There is enough space to add the new sequence(s) */
+    /* Bump the generation so that attached caches notice the in-place
+     * modification */
+    ss->generation++;
     /* Copy the new sequence if its address is different from last */
     if (last != seq1)
       memcpy(last, seq1, VARSIZE(seq1));
@@ -2351,6 +2809,12 @@ tsequenceset_append_tinstant(TSequenceSet *ss, const TInstant *inst,
       ss->totalcount++;
       last = (TSequence *) ((char *) last + size_seq1);
       memcpy(last, seq2, VARSIZE(seq2));
+      /* Invalidate the distinct instants flag when the new boundary
+       * instant is shared */
+      if (MEOS_FLAGS_GET_DISTINCT(ss->flags) && tinstant_eq(
+            TSEQUENCE_INST_N(seq1, seq1->count - 1),
+            TSEQUENCE_INST_N(seq2, 0)))
+        MEOS_FLAGS_SET_DISTINCT(ss->flags, false);
     }
     /* Expand the bounding box and return */
     tsequenceset_expand_bbox(ss, (TSequence *) seq1);
@@ -2378,6 +2842,10 @@ tsequenceset_append_tinstant(TSequenceSet *ss, const TInstant *inst,
   pfree(sequences);
   if ((void *) last != (void *) temp)
     pfree(temp);
+  /* Carry the generation over so that caches attached to the old value do
+   * not mistake the new one for it when the allocation reuses the address */
+  if (result)
+    result->generation = (uint16) (ss->generation + 1);
   return result;
 }
 
@@ -2442,6 +2910,8 @@ tsequenceset_append_tsequence(TSequenceSet *ss, const TSequence *seq,
    * not enough available space to append the new sequence */
   while (expand && count <= ss->maxcount)
   {
+    /* The periods summary array, if any, is overwritten when expanding */
+    MEOS_FLAGS_SET_PERIODS(ss->flags, false);
     /* Determine whether there is enough available space */
     size_t size_last = DOUBLE_PAD(VARSIZE(last));
     size_t size_seq = DOUBLE_PAD(VARSIZE(seq));
@@ -2454,6 +2924,9 @@ tsequenceset_append_tsequence(TSequenceSet *ss, const TSequence *seq,
       break;
 
     /* There is enough space to add the new sequence */
+    /* Bump the generation so that attached caches notice the in-place
+     * modification */
+    ss->generation++;
     if (join)
     {
       /* Set to 0 in case the new sequence is smaller than the current one */
@@ -2470,6 +2943,10 @@ tsequenceset_append_tsequence(TSequenceSet *ss, const TSequence *seq,
       /* Copy the sequence at the end */
       TSequence *new = (TSequence *) ((char *) last + size_last);
       memcpy(new, seq, VARSIZE(seq));
+      /* Invalidate the distinct instants flag when the new boundary
+       * instant is shared */
+      if (MEOS_FLAGS_GET_DISTINCT(ss->flags) && tinstant_eq(inst1, inst2))
+        MEOS_FLAGS_SET_DISTINCT(ss->flags, false);
     }
     /* Expand the bounding box and return */
     tsequenceset_expand_bbox(ss, seq);
@@ -2498,6 +2975,10 @@ tsequenceset_append_tsequence(TSequenceSet *ss, const TSequence *seq,
   TSequenceSet *result = tsequenceset_make_exp(sequences, count, maxcount,
     NORMALIZE_NO);
   pfree(sequences);
+  /* Carry the generation over so that caches attached to the old value do
+   * not mistake the new one for it when the allocation reuses the address */
+  if (result)
+    result->generation = (uint16) (ss->generation + 1);
   return result;
 }
 
@@ -2515,6 +2996,88 @@ tsequenceset_merge(const TSequenceSet *ss1, const TSequenceSet *ss2)
   return tsequenceset_merge_array(seqsets, 2);
 }
 
+/**
+ * @brief State of the k-way merge of the sequences of several sequence sets
+ *
+ * The sequences of each input sequence set form a run already sorted on
+ * their periods. A loser tree over the heads of the runs yields the next
+ * sequence in global order in O(log k) comparisons, so merging k inputs
+ * costs O(n log k) instead of the O(n log n) full sort of the concatenated
+ * sequences.
+ */
+typedef struct
+{
+  const TSequenceSet **seqsets; /**< Input sequence sets (the runs) */
+  int *pos;   /**< Position of the head sequence of each run */
+  int *tree;  /**< Loser tree: slot 0 holds the winner run, the internal
+                   nodes hold the losers of their subtree matches */
+  int count;  /**< Number of runs */
+} SeqsetMergeState;
+
+/**
+ * @brief Compare the head sequences of two runs, an exhausted run losing
+ * against any run that still has sequences
+ */
+static int
+seqset_merge_cmp(const SeqsetMergeState *state, int run1, int run2)
+{
+  bool left1 = state->pos[run1] < state->seqsets[run1]->count;
+  bool left2 = state->pos[run2] < state->seqsets[run2]->count;
+  if (! left1 || ! left2)
+    return left1 ? -1 : (left2 ? 1 : 0);
+  Span p1 = TSEQUENCESET_SEQ_N(state->seqsets[run1],
+    state->pos[run1])->period;
+  Span p2 = TSEQUENCESET_SEQ_N(state->seqsets[run2],
+    state->pos[run2])->period;
+  int cmp = span_cmp(&p1, &p2);
+  if (cmp)
+    return cmp;
+  return run1 - run2;
+}
+
+/**
+ * @brief Play the matches of the subtree of the loser tree rooted at a node,
+ * store the losers, and return the winner
+ *
+ * The leaves of the tree are implicit: node count + i stands for run i.
+ */
+static int
+seqset_merge_build(SeqsetMergeState *state, int node)
+{
+  if (node >= state->count)
+    return node - state->count;
+  int winner1 = seqset_merge_build(state, 2 * node);
+  int winner2 = seqset_merge_build(state, 2 * node + 1);
+  if (seqset_merge_cmp(state, winner1, winner2) <= 0)
+  {
+    state->tree[node] = winner2;
+    return winner1;
+  }
+  state->tree[node] = winner1;
+  return winner2;
+}
+
+/**
+ * @brief Replay the matches on the path from the leaf of the last winner to
+ * the root after its head sequence has been consumed
+ */
+static void
+seqset_merge_replay(SeqsetMergeState *state)
+{
+  int winner = state->tree[0];
+  for (int node = (state->count + winner) / 2; node >= 1; node /= 2)
+  {
+    if (seqset_merge_cmp(state, state->tree[node], winner) < 0)
+    {
+      int loser = winner;
+      winner = state->tree[node];
+      state->tree[node] = loser;
+    }
+  }
+  state->tree[0] = winner;
+  return;
+}
+
 /**
  * @ingroup libmeos_internal_temporal_modif
  * @brief Merge an array of temporal sequence sets.
@@ -2528,21 +3091,39 @@ tsequenceset_merge_array(const TSequenceSet **seqsets, int count)
 {
   assert(seqsets);
   assert(count > 0);
-  /* Collect the composing sequences */
+  /* Collect the composing sequences in global period order with a k-way
+   * merge of the runs of the input sequence sets */
   int totalcount = 0;
   for (int i = 0; i < count; i++)
     totalcount += seqsets[i]->count;
   const TSequence **sequences = palloc0(sizeof(TSequence *) * totalcount);
   int nseqs = 0;
-  for (int i = 0; i < count; i++)
+  if (count == 1)
   {
-    for (int j = 0; j < seqsets[i]->count; j++)
-      sequences[nseqs++] = TSEQUENCESET_SEQ_N(seqsets[i], j);
+    for (int j = 0; j < seqsets[0]->count; j++)
+      sequences[nseqs++] = TSEQUENCESET_SEQ_N(seqsets[0], j);
+  }
+  else
+  {
+    SeqsetMergeState state;
+    state.seqsets = seqsets;
+    state.count = count;
+    state.pos = palloc0(sizeof(int) * count);
+    state.tree = palloc(sizeof(int) * count);
+    state.tree[0] = seqset_merge_build(&state, 1);
+    while (nseqs < totalcount)
+    {
+      int run = state.tree[0];
+      sequences[nseqs++] = TSEQUENCESET_SEQ_N(seqsets[run],
+        state.pos[run]++);
+      seqset_merge_replay(&state);
+    }
+    pfree(state.pos); pfree(state.tree);
   }
   /* We cannot call directly #tsequence_merge_array since the result must be of
    * subtype TSEQUENCESET */
   int newcount;
-  TSequence **newseqs = tsequence_merge_array1(sequences, totalcount,
+  TSequence **newseqs = tsequence_merge_array1(sequences, totalcount, true,
     &newcount);
   return tsequenceset_make_free(newseqs, newcount, NORMALIZE);
 }
@@ -2892,7 +3473,55 @@ tsequenceset_to_string(const TSequenceSet *ss, int maxdd, outfunc value_out)
   assert(ss);
   assert(maxdd >= 0);
 
+  /* Write the sequences directly into the result when the base type has a
+   * buffer-writing output function, performing a single allocation instead
+   * of one per instant */
+  if (value_out == &basetype_out)
+  {
+    size_t size = 3; /* '{', '}', '\0' */
+    if (MEOS_FLAGS_GET_CONTINUOUS(ss->flags) &&
+        ! MEOS_FLAGS_LINEAR_INTERP(ss->flags))
+      size += sizeof("Interp=Step;");
+    for (int i = 0; i < ss->count; i++)
+    {
+      size_t s = tsequence_to_string_size(TSEQUENCESET_SEQ_N(ss, i), maxdd,
+        true);
+      if (s == 0)
+      {
+        size = 0;
+        break;
+      }
+      size += s + 2; /* ", " separator */
+    }
+    if (size)
+    {
+      char *result = palloc(size);
+      char *ptr = result;
+      if (MEOS_FLAGS_GET_CONTINUOUS(ss->flags) &&
+          ! MEOS_FLAGS_LINEAR_INTERP(ss->flags))
+      {
+        strcpy(ptr, "Interp=Step;");
+        ptr += strlen(ptr);
+      }
+      *ptr++ = '{';
+      for (int i = 0; i < ss->count; i++)
+      {
+        if (i)
+        {
+          *ptr++ = ',';
+          *ptr++ = ' ';
+        }
+        ptr += tsequence_to_string_buf(ptr, TSEQUENCESET_SEQ_N(ss, i), maxdd,
+          true);
+      }
+      *ptr++ = '}';
+      *ptr = '\0';
+      return result;
+    }
+  }
+
   char **strings = palloc(sizeof(char *) * ss->count);
+  size_t *lengths = palloc(sizeof(size_t) * ss->count);
   size_t outlen = 0;
   char prefix[20];
   if (MEOS_FLAGS_GET_CONTINUOUS(ss->flags) &&
@@ -2904,10 +3533,13 @@ tsequenceset_to_string(const TSequenceSet *ss, int maxdd, outfunc value_out)
   {
     const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
     strings[i] = tsequence_to_string(seq, maxdd, true, value_out);
-    outlen += strlen(strings[i]) + 1;
+    lengths[i] = strlen(strings[i]);
+    outlen += lengths[i] + 1;
   }
-  return stringarr_to_string(strings, ss->count, outlen, prefix, '{', '}',
-    QUOTES_NO, SPACES);
+  char *result = stringarr_to_string(strings, lengths, ss->count, outlen,
+    prefix, '{', '}', QUOTES_NO, SPACES);
+  pfree(lengths);
+  return result;
 }
 
 /**
@@ -3359,8 +3991,11 @@ tsequenceset_eq(const TSequenceSet *ss1, const TSequenceSet *ss2)
 {
   assert(ss1); assert(ss2);
   assert(ss1->temptype == ss2->temptype);
-  /* If number of sequences or flags are not equal */
-  if (ss1->count != ss2->count || ss1->flags != ss2->flags)
+  /* If number of sequences or flags are not equal; the flags recording
+   * representation artifacts such as the periods summary depend on the
+   * construction history and do not participate in the comparison */
+  if (ss1->count != ss2->count ||
+      ((ss1->flags ^ ss2->flags) & ~MEOS_FLAGS_REPRESENTATION))
     return false;
 
   /* If bounding boxes are not equal */
@@ -3408,7 +4043,8 @@ tsequenceset_cmp(const TSequenceSet *ss1, const TSequenceSet *ss2)
   /* ss1->count == ss2->count because of the bounding box and the
    * composing sequence tests above */
 
-  /* ss1->flags == ss2->flags since all the composing sequences are equal */
+  /* The non-representational flags of ss1 and ss2 are equal since all the
+   * composing sequences are equal */
 
   /* The two values are equal */
   return 0;
@@ -42,7 +42,9 @@
 #include <meos_internal.h>
 #include "general/pg_types.h"
 #include "general/set.h"
+#include "general/stats.h"
 #include "general/tbox.h"
+#include "general/tsequence.h"
 #include "general/type_parser.h"
 #include "general/type_util.h"
 #include "point/stbox.h"
@@ -74,6 +76,11 @@ typedef struct
   bool geodetic;          /**< Geodetic? */
   bool has_srid;          /**< SRID? */
   interpType interp;      /**< Interpolation */
+  bool compressed;        /**< Are the instant arrays compressed? */
+  const Span *period;     /**< When set, decompress only the blocks of the
+                               compressed instant arrays covering it */
+  bool dryrun;            /**< Validate the buffer without building values? */
+  bool trusted;           /**< Skip validation when assembling the values? */
   const uint8_t *pos;     /**< Current parse position */
 } wkb_parse_state;
 
@@ -1511,6 +1518,8 @@ temporal_flags_from_wkb_state(wkb_parse_state *s, uint8_t wkb_flags)
     if (wkb_flags & MEOS_WKB_SRIDFLAG)
       s->has_srid = true;
   }
+  /* Get the compression flag */
+  s->compressed = (wkb_flags & MEOS_WKB_COMPRESSEDFLAG) != 0;
   /* Mask off the upper flags to get the subtype */
   wkb_flags &= (uint8_t) 0x03;
   switch (wkb_flags)
@@ -1546,24 +1555,396 @@ tinstant_from_wkb_state(wkb_parse_state *s)
   /* Read the values from the buffer and create the instant */
   Datum value = basevalue_from_wkb_state(s);
   TimestampTz t = timestamp_from_wkb_state(s);
+  if (s->dryrun)
+  {
+    if (! basetype_byvalue(s->basetype))
+      pfree(DatumGetPointer(value));
+    return NULL;
+  }
   TInstant *result = tinstant_make(value, s->temptype, t);
   if (! basetype_byvalue(s->basetype))
     pfree(DatumGetPointer(value));
   return result;
 }
 
+/**
+ * @brief Read a varint and advance the parse state forward, that is, groups
+ * of 7 bits starting from the low-order ones, where the high bit of a byte
+ * states whether more bytes follow
+ */
+static uint64_t
+varint_from_wkb_state(wkb_parse_state *s)
+{
+  uint64_t result = 0;
+  int shift = 0;
+  uint8_t b;
+  do
+  {
+    b = (uint8_t) byte_from_wkb_state(s);
+    result |= (uint64_t) (b & 0x7F) << shift;
+    shift += 7;
+  } while ((b & 0x80) && shift < 64);
+  return result;
+}
+
+/**
+ * @brief Return the signed integer corresponding to a zigzag encoding
+ */
+static int64
+zigzag_decode(uint64_t val)
+{
+  return (int64) (val >> 1) ^ - (int64) (val & 1);
+}
+
+/**
+ * @brief Return the base value corresponding to the value dimensions read
+ * from a compressed WKB representation
+ */
+static Datum
+compressed_value_from_coords(wkb_parse_state *s, const double *coords,
+  int dims)
+{
+  if (dims == 1)
+    return Float8GetDatum(coords[0]);
+  LWPOINT *point = (dims == 3) ?
+    lwpoint_make3dz(s->srid, coords[0], coords[1], coords[2]) :
+    lwpoint_make2d(s->srid, coords[0], coords[1]);
+  FLAGS_SET_GEODETIC(point->flags, s->geodetic);
+  Datum result = PointerGetDatum(geo_serialize((LWGEOM *) point));
+  lwpoint_free(point);
+  return result;
+}
+
+/**
+ * @brief Read one block of temporal instants from its compressed WKB
+ * payload (see #tinstblock_to_wkb_buf), that is, the first timestamp and
+ * value in full, and for each subsequent instant the delta of the timestamp
+ * deltas as a zigzag varint and the XOR of each value dimension with the
+ * previous value as a length byte followed by the significant bytes
+ * @param[in] s Parse state
+ * @param[in] count Number of instants in the block
+ * @param[out] result Array filled with the instants, NULL on a dry run
+ * @return False on parse error
+ */
+static bool
+tinstblock_from_wkb_state(wkb_parse_state *s, int count, TInstant **result)
+{
+  int dims = tgeo_type(s->temptype) ? (s->hasz ? 3 : 2) : 1;
+  /* Read the first timestamp and the first value stored in full */
+  TimestampTz t = timestamp_from_wkb_state(s);
+  double coords[3];
+  uint64_t bits[3];
+  for (int d = 0; d < dims; d++)
+  {
+    coords[d] = double_from_wkb_state(s);
+    memcpy(&bits[d], &coords[d], sizeof(uint64_t));
+  }
+  if (result)
+  {
+    Datum value = compressed_value_from_coords(s, coords, dims);
+    result[0] = tinstant_make(value, s->temptype, t);
+    if (! basetype_byvalue(s->basetype))
+      pfree(DatumGetPointer(value));
+  }
+  int64 prevdelta = 0;
+  for (int i = 1; i < count; i++)
+  {
+    /* The first delta of deltas encodes the first delta itself */
+    prevdelta += zigzag_decode(varint_from_wkb_state(s));
+    t += prevdelta;
+    for (int d = 0; d < dims; d++)
+    {
+      int nbytes = (uint8_t) byte_from_wkb_state(s);
+      if (nbytes > 8)
+      {
+        meos_error(ERROR, MEOS_ERR_WKB_INPUT,
+          "Invalid XOR length in compressed WKB string: %d", nbytes);
+        /* Free only the instants built so far: the array, where this block
+         * may start at an offset, belongs to the caller */
+        if (result)
+          for (int k = 0; k < i; k++)
+            pfree(result[k]);
+        return false;
+      }
+      uint64_t xorval = 0;
+      for (int k = 0; k < nbytes; k++)
+        xorval |= (uint64_t) (uint8_t) byte_from_wkb_state(s) << (8 * k);
+      bits[d] ^= xorval;
+      memcpy(&coords[d], &bits[d], sizeof(uint64_t));
+    }
+    if (result)
+    {
+      Datum value = compressed_value_from_coords(s, coords, dims);
+      result[i] = tinstant_make(value, s->temptype, t);
+      if (! basetype_byvalue(s->basetype))
+        pfree(DatumGetPointer(value));
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Return a temporal instant array from its compressed WKB
+ * representation (see #tinstarr_compressed_to_wkb_buf), that is, a
+ * directory of fixed-size block headers followed by the block payloads
+ *
+ * When the parse state carries a period, the directory is binary searched
+ * for the range of blocks whose time extent covers it and only those
+ * blocks are decompressed; one extra block is kept on each side so that
+ * the segments crossing the period bounds under linear interpolation
+ * retain their defining instants. The exact trim to the period is left to
+ * the caller.
+ * @param[in] s Parse state
+ * @param[in] count Number of instants in the array
+ * @param[out] newcount Number of instants decompressed
+ * @param[out] has_first,has_last State whether the first (resp. last)
+ * instant of the array was decompressed
+ */
+static TInstant **
+tinstarr_compressed_from_wkb_state(wkb_parse_state *s, int count,
+  int *newcount, bool *has_first, bool *has_last)
+{
+  int dims = tgeo_type(s->temptype) ? (s->hasz ? 3 : 2) : 1;
+  int nblocks = (count + MEOS_WKB_COMPRESS_BLOCKSIZE - 1) /
+    MEOS_WKB_COMPRESS_BLOCKSIZE;
+  *newcount = count;
+  *has_first = *has_last = true;
+
+  /* Read the block directory, skipping the value extrema, which are not
+   * needed to decompress */
+  size_t extrema_size = 2 * (size_t) dims * MEOS_WKB_DOUBLE_SIZE;
+  TimestampTz *first = palloc(sizeof(TimestampTz) * nblocks);
+  TimestampTz *last = palloc(sizeof(TimestampTz) * nblocks);
+  int *endoff = palloc(sizeof(int) * nblocks);
+  for (int b = 0; b < nblocks; b++)
+  {
+    first[b] = timestamp_from_wkb_state(s);
+    last[b] = timestamp_from_wkb_state(s);
+    wkb_parse_state_check(s, extrema_size);
+    s->pos += extrema_size;
+    endoff[b] = int32_from_wkb_state(s);
+    if (endoff[b] < (b > 0 ? endoff[b - 1] : 0))
+    {
+      meos_error(ERROR, MEOS_ERR_WKB_INPUT,
+        "Invalid block offset in compressed WKB string: %d", endoff[b]);
+      pfree(first); pfree(last); pfree(endoff);
+      return NULL;
+    }
+  }
+
+  /* Determine the range of blocks to decompress */
+  int bfrom = 0, bto = nblocks - 1;
+  if (s->period && ! s->dryrun)
+  {
+    TimestampTz lower = DatumGetTimestampTz(s->period->lower);
+    TimestampTz upper = DatumGetTimestampTz(s->period->upper);
+    /* Binary search for the first block ending at or after the period
+     * start and for the last block starting at or before the period end */
+    int lo = 0, hi = nblocks;
+    while (lo < hi)
+    {
+      int mid = (lo + hi) / 2;
+      if (last[mid] < lower)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    bfrom = lo;
+    lo = 0; hi = nblocks;
+    while (lo < hi)
+    {
+      int mid = (lo + hi) / 2;
+      if (first[mid] <= upper)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    bto = lo - 1;
+    /* Keep one extra block on each side for the boundary segments; this
+     * also covers a period falling in the gap between two blocks */
+    bfrom = Max(bfrom - 1, 0);
+    bto = Min(bto + 1, nblocks - 1);
+    if (bfrom > bto)
+    {
+      /* The period is disjoint from the time extent of the array: consume
+       * the payloads and return no instants */
+      size_t skip = (size_t) endoff[nblocks - 1];
+      wkb_parse_state_check(s, skip);
+      s->pos += skip;
+      pfree(first); pfree(last); pfree(endoff);
+      *newcount = 0;
+      *has_first = *has_last = false;
+      return NULL;
+    }
+    *has_first = (bfrom == 0);
+    *has_last = (bto == nblocks - 1);
+  }
+
+  /* Skip the payloads of the blocks before the first one decompressed */
+  if (bfrom > 0)
+  {
+    size_t skip = (size_t) endoff[bfrom - 1];
+    wkb_parse_state_check(s, skip);
+    s->pos += skip;
+  }
+  /* Decompress the covering blocks */
+  int nout = (bto - bfrom) * MEOS_WKB_COMPRESS_BLOCKSIZE +
+    Min(MEOS_WKB_COMPRESS_BLOCKSIZE,
+      count - bto * MEOS_WKB_COMPRESS_BLOCKSIZE);
+  TInstant **result = s->dryrun ? NULL : palloc(sizeof(TInstant *) * nout);
+  int ninsts = 0;
+  for (int b = bfrom; b <= bto; b++)
+  {
+    int n = Min(MEOS_WKB_COMPRESS_BLOCKSIZE,
+      count - b * MEOS_WKB_COMPRESS_BLOCKSIZE);
+    if (! tinstblock_from_wkb_state(s, n, result ? &result[ninsts] : NULL))
+    {
+      if (result)
+        pfree_array((void **) result, ninsts);
+      pfree(first); pfree(last); pfree(endoff);
+      return NULL;
+    }
+    ninsts += n;
+  }
+  /* Skip the payloads of the blocks after the last one decompressed */
+  if (bto < nblocks - 1)
+  {
+    size_t skip = (size_t) (endoff[nblocks - 1] - endoff[bto]);
+    wkb_parse_state_check(s, skip);
+    s->pos += skip;
+  }
+  pfree(first); pfree(last); pfree(endoff);
+  *newcount = nout;
+  return result;
+}
+
 /**
  * @brief Return a temporal instant array from its WKB representation
+ * @param[in] s Parse state
+ * @param[in] count Number of instants in the array
+ * @param[out] newcount Number of instants returned, which may be smaller
+ * than count when the parse state carries a period and the array is
+ * compressed
+ * @param[out] has_first,has_last State whether the first (resp. last)
+ * instant of the array was returned
  */
 static TInstant **
-tinstarr_from_wkb_state(wkb_parse_state *s, int count)
-{
-  TInstant **result = palloc(sizeof(TInstant *) * count);
+tinstarr_from_wkb_state(wkb_parse_state *s, int count, int *newcount,
+  bool *has_first, bool *has_last)
+{
+  *newcount = count;
+  *has_first = *has_last = true;
+  if (s->compressed)
+    return tinstarr_compressed_from_wkb_state(s, count, newcount, has_first,
+      has_last);
+  TInstant **result = s->dryrun ? NULL :
+    palloc(sizeof(TInstant *) * count);
+  /* Block-wise read: when the buffer is in machine byte order and the base
+   * type has a fixed size, the instants form a fixed-stride block, so the
+   * bounds are checked once for the whole block and the values are read with
+   * plain copies instead of once-per-field checked reads */
+  size_t valsize = 0;
+  if (! s->swap_bytes)
+  {
+    if (s->basetype == T_BOOL)
+      valsize = MEOS_WKB_BYTE_SIZE;
+    else if (s->basetype == T_INT4)
+      valsize = MEOS_WKB_INT4_SIZE;
+    else if (s->basetype == T_INT8)
+      valsize = MEOS_WKB_INT8_SIZE;
+    else if (s->basetype == T_FLOAT8)
+      valsize = MEOS_WKB_DOUBLE_SIZE;
+  }
+  else if (s->basetype == T_INT8 || s->basetype == T_FLOAT8)
+  {
+    /* When the buffer is in the opposite byte order and the value and the
+     * timestamp are both 8-byte lanes, the whole block is byte swapped in a
+     * separate pass over the contiguous lanes, which the compiler can turn
+     * into bulk byte-shuffle instructions, instead of swapping every field
+     * byte by byte during the structural interpretation */
+    int nlanes = count * 2;
+    wkb_parse_state_check(s, (size_t) nlanes * MEOS_WKB_INT8_SIZE);
+    if (s->dryrun)
+    {
+      s->pos += (size_t) nlanes * MEOS_WKB_INT8_SIZE;
+      return NULL;
+    }
+    uint64_t *lanes = palloc(sizeof(uint64_t) * nlanes);
+    memcpy(lanes, s->pos, sizeof(uint64_t) * nlanes);
+    s->pos += (size_t) nlanes * MEOS_WKB_INT8_SIZE;
+    for (int i = 0; i < nlanes; i++)
+    {
+      uint64_t v = lanes[i];
+      v = (v >> 32) | (v << 32);
+      v = ((v & UINT64_C(0xFFFF0000FFFF0000)) >> 16) |
+          ((v & UINT64_C(0x0000FFFF0000FFFF)) << 16);
+      v = ((v & UINT64_C(0xFF00FF00FF00FF00)) >> 8) |
+          ((v & UINT64_C(0x00FF00FF00FF00FF)) << 8);
+      lanes[i] = v;
+    }
+    for (int i = 0; i < count; i++)
+    {
+      Datum value;
+      if (s->basetype == T_INT8)
+        value = Int64GetDatum((int64) lanes[2 * i]);
+      else /* s->basetype == T_FLOAT8 */
+      {
+        double d;
+        memcpy(&d, &lanes[2 * i], sizeof(double));
+        value = Float8GetDatum(d);
+      }
+      result[i] = tinstant_make(value, s->temptype,
+        (TimestampTz) lanes[2 * i + 1]);
+    }
+    pfree(lanes);
+    return result;
+  }
+  if (valsize != 0)
+  {
+    size_t stride = valsize + MEOS_WKB_TIMESTAMP_SIZE;
+    wkb_parse_state_check(s, stride * count);
+    for (int i = 0; i < count; i++)
+    {
+      Datum value = 0;
+      if (s->basetype == T_BOOL)
+        value = BoolGetDatum(s->pos[0]);
+      else if (s->basetype == T_INT4)
+      {
+        int32_t i4;
+        memcpy(&i4, s->pos, sizeof(int32_t));
+        value = Int32GetDatum(i4);
+      }
+      else if (s->basetype == T_INT8)
+      {
+        int64 i8;
+        memcpy(&i8, s->pos, sizeof(int64));
+        value = Int64GetDatum(i8);
+      }
+      else /* s->basetype == T_FLOAT8 */
+      {
+        double d;
+        memcpy(&d, s->pos, sizeof(double));
+        value = Float8GetDatum(d);
+      }
+      TimestampTz t;
+      memcpy(&t, s->pos + valsize, sizeof(TimestampTz));
+      s->pos += stride;
+      if (! s->dryrun)
+        result[i] = tinstant_make(value, s->temptype, t);
+    }
+    return result;
+  }
   for (int i = 0; i < count; i++)
   {
     /* Parse the point and the timestamp to create the instant point */
     Datum value = basevalue_from_wkb_state(s);
     TimestampTz t = timestamp_from_wkb_state(s);
+    if (s->dryrun)
+    {
+      if (! basetype_byvalue(s->basetype))
+        pfree(DatumGetPointer(value));
+      continue;
+    }
     result[i] = tinstant_make(value, s->temptype, t);
     if (! basetype_byvalue(s->basetype))
       pfree(DatumGetPointer(value));
@@ -1585,9 +1966,32 @@ tsequence_from_wkb_state(wkb_parse_state *s)
   bool lower_inc, upper_inc;
   bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
   /* Parse the instants */
-  TInstant **instants = tinstarr_from_wkb_state(s, count);
-  return tsequence_make_free(instants, count, lower_inc, upper_inc, s->interp,
-    NORMALIZE);
+  int newcount;
+  bool has_first, has_last;
+  TInstant **instants = tinstarr_from_wkb_state(s, count, &newcount,
+    &has_first, &has_last);
+  if (s->dryrun || newcount == 0)
+    return NULL;
+  /* When the leading (resp. trailing) instants were filtered out by a
+   * period, the bound of the remaining subset is inclusive; a period filter
+   * implies that the caller trims the result exactly afterwards */
+  if (! has_first || newcount == 1)
+    lower_inc = true;
+  if (! has_last || newcount == 1)
+    upper_inc = true;
+  /* Trusted input, e.g., produced by temporal_as_wkb, is already valid and
+   * normalized, so the per-instant validation and the normalization of the
+   * assembly can be skipped */
+  if (s->trusted)
+  {
+    TSequence *result = tsequence_make1_exp((const TInstant **) instants,
+      newcount, newcount, lower_inc, upper_inc, s->interp, NORMALIZE_NO,
+      NULL);
+    pfree_array((void **) instants, newcount);
+    return result;
+  }
+  return tsequence_make_free(instants, newcount, lower_inc, upper_inc,
+    s->interp, NORMALIZE);
 }
 
 /**
@@ -1599,8 +2003,9 @@ tsequenceset_from_wkb_state(wkb_parse_state *s)
   /* Get the number of sequences */
   int count = int32_from_wkb_state(s);
   assert(count > 0);
-  /* Parse the sequences */
+  /* Parse the sequences; a period filter may leave some of them empty */
   TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  int nseqs = 0;
   for (int i = 0; i < count; i++)
   {
     /* Get the number of instants */
@@ -1610,20 +2015,34 @@ tsequenceset_from_wkb_state(wkb_parse_state *s)
     bool lower_inc, upper_inc;
     bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
     /* Parse the instants */
-    TInstant **instants = palloc(sizeof(TInstant *) * countinst);
-    for (int j = 0; j < countinst; j++)
+    int newcount;
+    bool has_first, has_last;
+    TInstant **instants = tinstarr_from_wkb_state(s, countinst, &newcount,
+      &has_first, &has_last);
+    if (s->dryrun || newcount == 0)
+      continue;
+    if (! has_first || newcount == 1)
+      lower_inc = true;
+    if (! has_last || newcount == 1)
+      upper_inc = true;
+    if (s->trusted)
     {
-      /* Parse the value and the timestamp to create the temporal instant */
-      Datum value = basevalue_from_wkb_state(s);
-      TimestampTz t = timestamp_from_wkb_state(s);
-      instants[j] = tinstant_make(value, s->temptype, t);
-      if (! basetype_byvalue(s->basetype))
-        pfree(DatumGetPointer(value));
+      sequences[nseqs++] = tsequence_make1_exp((const TInstant **) instants,
+        newcount, newcount, lower_inc, upper_inc, s->interp, NORMALIZE_NO,
+        NULL);
+      pfree_array((void **) instants, newcount);
     }
-    sequences[i] = tsequence_make_free(instants, countinst, lower_inc,
-      upper_inc, s->interp, NORMALIZE);
+    else
+      sequences[nseqs++] = tsequence_make_free(instants, newcount, lower_inc,
+        upper_inc, s->interp, NORMALIZE);
   }
-  return tsequenceset_make_free(sequences, count, NORMALIZE);
+  if (s->dryrun || nseqs == 0)
+  {
+    pfree(sequences);
+    return NULL;
+  }
+  return tsequenceset_make_free(sequences, nseqs,
+    s->trusted ? NORMALIZE_NO : NORMALIZE);
 }
 
 /**
@@ -1665,6 +2084,8 @@ temporal_from_wkb_state(wkb_parse_state *s)
 Datum
 datum_from_wkb(const uint8_t *wkb, size_t size, meosType type)
 {
+  MEOS_STATS_INC(wkb_in_calls);
+  MEOS_STATS_ADD(wkb_in_bytes, size);
   /* Initialize the state appropriately */
   wkb_parse_state s;
   memset(&s, 0, sizeof(wkb_parse_state));
@@ -1913,6 +2334,142 @@ temporal_from_wkb(const uint8_t *wkb, size_t size)
   return DatumGetTemporalP(datum_from_wkb(wkb, size, T_TINT));
 }
 
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Return true if the buffer contains a valid WKB representation of a
+ * temporal value
+ *
+ * The buffer is fully walked and bounds-checked but no temporal value is
+ * built, so callers keeping WKB blobs in read-only storage (e.g., memory
+ * mapped files) can validate them once at load time and defer the
+ * materialization with #temporal_from_wkb until a value is actually needed.
+ */
+bool
+temporal_wkb_valid(const uint8_t *wkb, size_t size)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) wkb))
+    return false;
+
+  /* Initialize the state appropriately */
+  wkb_parse_state s;
+  memset(&s, 0, sizeof(wkb_parse_state));
+  s.wkb = s.pos = wkb;
+  s.wkb_size = size;
+  s.dryrun = true;
+  /* Fail when handed incorrect starting byte */
+  char wkb_little_endian = byte_from_wkb_state(&s);
+  if (wkb_little_endian != 1 && wkb_little_endian != 0)
+    return false;
+  /* Check the endianness of our input */
+  if (MEOS_IS_BIG_ENDIAN)
+    s.swap_bytes = (bool) wkb_little_endian;
+  else
+    s.swap_bytes = ! wkb_little_endian;
+
+  /* Walk the buffer keeping track of errors raised while parsing */
+  int last_errno = meos_errno_reset();
+  temporal_from_wkb_state(&s);
+  bool result = (meos_errno() == 0) && (s.pos == s.wkb + s.wkb_size);
+  meos_errno_restore(last_errno);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Return a temporal value from its Well-Known Binary (WKB)
+ * representation assuming that the buffer contains a valid value
+ *
+ * The buffer is still bounds-checked while parsing, but the per-instant
+ * validation and the normalization of the assembly are skipped, which makes
+ * a difference when bulk loading billions of rows. The function must only
+ * be applied to buffers produced by #temporal_as_wkb or checked beforehand
+ * with #temporal_wkb_valid; for untrusted input use #temporal_from_wkb.
+ * @return On error return NULL
+ */
+Temporal *
+temporal_from_wkb_trusted(const uint8_t *wkb, size_t size)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) wkb))
+    return NULL;
+
+  /* Initialize the state appropriately */
+  wkb_parse_state s;
+  memset(&s, 0, sizeof(wkb_parse_state));
+  s.wkb = s.pos = wkb;
+  s.wkb_size = size;
+  s.trusted = true;
+  /* Fail when handed incorrect starting byte */
+  char wkb_little_endian = byte_from_wkb_state(&s);
+  if (wkb_little_endian != 1 && wkb_little_endian != 0)
+  {
+    meos_error(ERROR, MEOS_ERR_WKB_INPUT,
+      "Invalid endian flag value in WKB string.");
+    return NULL;
+  }
+  /* Check the endianness of our input */
+  if (MEOS_IS_BIG_ENDIAN)
+    s.swap_bytes = (bool) wkb_little_endian;
+  else
+    s.swap_bytes = ! wkb_little_endian;
+  /* We pass ANY temporal type, the actual type is read from the byte string */
+  s.type = T_TINT;
+  return temporal_from_wkb_state(&s);
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Return a temporal value from its Well-Known Binary (WKB)
+ * representation restricted to a period
+ *
+ * When the buffer was written with the #WKB_COMPRESSED variant, the block
+ * directories of the compressed instant arrays are binary searched and only
+ * the blocks whose time extent covers the period are decompressed, so the
+ * cost is proportional to the size of the answer rather than to the size of
+ * the archive. Uncompressed buffers are parsed in full before the
+ * restriction.
+ * @return On error, or when the period does not overlap the temporal value,
+ * return NULL
+ */
+Temporal *
+temporal_from_wkb_period(const uint8_t *wkb, size_t size, const Span *p)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) wkb) || ! ensure_not_null((void *) p) ||
+      ! ensure_span_has_type(p, T_TSTZSPAN))
+    return NULL;
+
+  /* Initialize the state appropriately */
+  wkb_parse_state s;
+  memset(&s, 0, sizeof(wkb_parse_state));
+  s.wkb = s.pos = wkb;
+  s.wkb_size = size;
+  s.period = p;
+  /* Fail when handed incorrect starting byte */
+  char wkb_little_endian = byte_from_wkb_state(&s);
+  if (wkb_little_endian != 1 && wkb_little_endian != 0)
+  {
+    meos_error(ERROR, MEOS_ERR_WKB_INPUT,
+      "Invalid endian flag value in WKB string.");
+    return NULL;
+  }
+  /* Check the endianness of our input */
+  if (MEOS_IS_BIG_ENDIAN)
+    s.swap_bytes = (bool) wkb_little_endian;
+  else
+    s.swap_bytes = ! wkb_little_endian;
+  /* We pass ANY temporal type, the actual type is read from the byte string */
+  s.type = T_TINT;
+  Temporal *partial = temporal_from_wkb_state(&s);
+  if (! partial)
+    return NULL;
+  /* Trim exactly the instants of the boundary blocks outside the period */
+  Temporal *result = temporal_restrict_period(partial, p, REST_AT);
+  pfree(partial);
+  return result;
+}
+
 /**
  * @ingroup libmeos_temporal_inout
  * @brief Return a temporal value from its HexEWKB representation
@@ -1932,3 +2489,130 @@ temporal_from_hexwkb(const char *hexwkb)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Streaming text input
+ *****************************************************************************/
+
+#if MEOS
+/**
+ * Chunk of input text fed to a temporal input stream
+ */
+typedef struct TemporalStreamChunk
+{
+  struct TemporalStreamChunk *next; /**< Next chunk in arrival order */
+  size_t size;                      /**< Number of bytes in the chunk */
+  char data[];                      /**< Chunk bytes, not NUL-terminated */
+} TemporalStreamChunk;
+
+/**
+ * Structure to represent the state of a temporal input stream
+ *
+ * Producers that receive a large text or MF-JSON literal in pieces (e.g.
+ * from a message bus) can push the pieces as they arrive instead of
+ * growing and re-scanning a single buffer. The chunks are kept in a list
+ * and coalesced exactly once, into a buffer of exactly the right size,
+ * when the value is requested.
+ */
+struct TemporalStream
+{
+  TemporalStreamChunk *head;  /**< First chunk */
+  TemporalStreamChunk *tail;  /**< Last chunk */
+  size_t total;               /**< Total number of bytes fed */
+};
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Create an empty temporal input stream
+ */
+TemporalStream *
+temporal_stream_make(void)
+{
+  TemporalStream *stream = palloc(sizeof(TemporalStream));
+  stream->head = stream->tail = NULL;
+  stream->total = 0;
+  return stream;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Append a chunk of input text to a temporal input stream
+ * @param[in,out] stream Input stream
+ * @param[in] chunk Bytes to append, copied into the stream
+ * @param[in] size Number of bytes in the chunk
+ */
+void
+temporal_stream_feed(TemporalStream *stream, const char *chunk, size_t size)
+{
+  assert(stream); assert(chunk);
+  if (size == 0)
+    return;
+  TemporalStreamChunk *newchunk = palloc(sizeof(TemporalStreamChunk) + size);
+  newchunk->next = NULL;
+  newchunk->size = size;
+  memcpy(newchunk->data, chunk, size);
+  if (stream->tail)
+    stream->tail->next = newchunk;
+  else
+    stream->head = newchunk;
+  stream->tail = newchunk;
+  stream->total += size;
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Free a temporal input stream
+ */
+void
+temporal_stream_free(TemporalStream *stream)
+{
+  assert(stream);
+  TemporalStreamChunk *chunk = stream->head;
+  while (chunk)
+  {
+    TemporalStreamChunk *next = chunk->next;
+    pfree(chunk);
+    chunk = next;
+  }
+  pfree(stream);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Parse the text accumulated in a temporal input stream
+ *
+ * The chunks are coalesced once into a buffer of exactly the right size and
+ * handed to the input function, e.g. #tgeompoint_in or
+ * #temporal_from_mfjson. The stream is freed afterwards.
+ * @param[in] stream Input stream
+ * @param[in] infunc Input function applied to the accumulated text
+ * @return On error return NULL
+ */
+Temporal *
+temporal_stream_finish(TemporalStream *stream,
+  Temporal *(*infunc)(const char *))
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) stream) ||
+      ! ensure_not_null((void *) infunc))
+    return NULL;
+
+  char *str = palloc(stream->total + 1);
+  size_t pos = 0;
+  for (TemporalStreamChunk *chunk = stream->head; chunk;
+       chunk = chunk->next)
+  {
+    memcpy(&str[pos], chunk->data, chunk->size);
+    pos += chunk->size;
+  }
+  str[pos] = '\0';
+  temporal_stream_free(stream);
+  Temporal *result = infunc(str);
+  pfree(str);
+  return result;
+}
+#endif /* MEOS */
+
+/*****************************************************************************/
@@ -47,6 +47,7 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/pg_types.h"
+#include "general/stats.h"
 #include "general/tinstant.h"
 #include "general/tsequence.h"
 #include "general/tsequenceset.h"
@@ -71,15 +72,39 @@
  * Output in MFJSON format
  *****************************************************************************/
 
+/**
+ * @brief Write into the buffer a string fragment known at compile time
+ *
+ * The doubles of the MF-JSON output are formatted by the bundled ryu
+ * (through the PostGIS function lwprint_double); once this is the case,
+ * parsing a format string and consulting the locale in sprintf for every
+ * constant fragment and separator dominates the cost of exporting large
+ * values, so the fragments are copied directly instead.
+ */
+#define MFJSON_CONST_BUF(ptr, str) \
+  do { \
+    memcpy((ptr), (str), sizeof(str) - 1); \
+    (ptr) += sizeof(str) - 1; \
+  } while (0)
+
+/**
+ * @brief Write into the buffer a NUL-terminated string
+ */
+static size_t
+cstring_mfjson_buf(char *output, const char *str)
+{
+  size_t len = strlen(str);
+  memcpy(output, str, len);
+  return len;
+}
+
 /**
  * @brief Write into the buffer an integer represented in MF-JSON format
  */
 static size_t
 bool_mfjson_buf(char *output, bool b)
 {
-  char *ptr = output;
-  ptr += sprintf(ptr, "%s", b ? "true" : "false");
-  return (ptr - output);
+  return cstring_mfjson_buf(output, b ? "true" : "false");
 }
 
 /**
@@ -113,7 +138,9 @@ text_mfjson_buf(char *output, text *txt)
 {
   char *ptr = output;
   char *str = text2cstring(txt);
-  ptr += sprintf(ptr, "\"%s\"", str);
+  *ptr++ = '"';
+  ptr += cstring_mfjson_buf(ptr, str);
+  *ptr++ = '"';
   pfree(str);
   return (ptr - output);
 }
@@ -183,24 +210,24 @@ coordinates_mfjson_buf(char *output, const TInstant *inst, int precision)
 {
   assert(precision <= OUT_MAX_DOUBLE_PRECISION);
   char *ptr = output;
-  ptr += sprintf(ptr, "[");
+  *ptr++ = '[';
   if (MEOS_FLAGS_GET_Z(inst->flags))
   {
     const POINT3DZ *pt = DATUM_POINT3DZ_P(tinstant_value(inst));
     ptr += lwprint_double(pt->x, precision, ptr);
-    ptr += sprintf(ptr, ",");
+    *ptr++ = ',';
     ptr += lwprint_double(pt->y, precision, ptr);
-    ptr += sprintf(ptr, ",");
+    *ptr++ = ',';
     ptr += lwprint_double(pt->z, precision, ptr);
   }
   else
   {
     const POINT2D *pt = DATUM_POINT2D_P(tinstant_value(inst));
     ptr += lwprint_double(pt->x, precision, ptr);
-    ptr += sprintf(ptr, ",");
+    *ptr++ = ',';
     ptr += lwprint_double(pt->y, precision, ptr);
   }
-  ptr += sprintf(ptr, "]");
+  *ptr++ = ']';
   return (ptr - output);
 }
 
@@ -226,11 +253,15 @@ static size_t
 datetimes_mfjson_buf(char *output, TimestampTz t)
 {
   char *ptr = output;
-  char *tstr = pg_timestamptz_out(t);
+  *ptr++ = '"';
+  int len = pg_timestamptz_out_buf(t, ptr);
+  if (len < 0)
+    len = 0;
   /* Replace ' ' by 'T' as separator between date and time parts */
-  tstr[10] = 'T';
-  ptr += sprintf(ptr, "\"%s\"", tstr);
-  pfree(tstr);
+  if (len > 10)
+    ptr[10] = 'T';
+  ptr += len;
+  *ptr++ = '"';
   return (ptr - output);
 }
 
@@ -253,8 +284,10 @@ static size_t
 srs_mfjson_buf(char *output, char *srs)
 {
   char *ptr = output;
-  ptr += sprintf(ptr, "\"crs\":{\"type\":\"Name\",");
-  ptr += sprintf(ptr, "\"properties\":{\"name\":\"%s\"}},", srs);
+  MFJSON_CONST_BUF(ptr, "\"crs\":{\"type\":\"Name\",");
+  MFJSON_CONST_BUF(ptr, "\"properties\":{\"name\":\"");
+  ptr += cstring_mfjson_buf(ptr, srs);
+  MFJSON_CONST_BUF(ptr, "\"}},");
   return (ptr - output);
 }
 
@@ -280,12 +313,15 @@ static size_t
 period_mfjson_buf(char *output, const Span *p)
 {
   char *ptr = output;
-  ptr += sprintf(ptr, "\"period\":{\"begin\":");
+  MFJSON_CONST_BUF(ptr, "\"period\":{\"begin\":");
   ptr += datetimes_mfjson_buf(ptr, DatumGetTimestampTz(p->lower));
-  ptr += sprintf(ptr, ",\"end\":");
+  MFJSON_CONST_BUF(ptr, ",\"end\":");
   ptr += datetimes_mfjson_buf(ptr, DatumGetTimestampTz(p->upper));
-  ptr += sprintf(ptr, ",\"lower_inc\":%s,\"upper_inc\":%s},",
-    p->lower_inc ? "true" : "false", p->upper_inc ? "true" : "false");
+  MFJSON_CONST_BUF(ptr, ",\"lower_inc\":");
+  ptr += bool_mfjson_buf(ptr, p->lower_inc);
+  MFJSON_CONST_BUF(ptr, ",\"upper_inc\":");
+  ptr += bool_mfjson_buf(ptr, p->upper_inc);
+  MFJSON_CONST_BUF(ptr, "},");
   return (ptr - output);
 }
 
@@ -314,19 +350,21 @@ tbox_mfjson_buf(char *output, const TBox *bbox, int precision)
   assert(precision <= OUT_MAX_DOUBLE_PRECISION);
   bool intbox = bbox->span.basetype == T_INT4;
   char *ptr = output;
-  ptr += sprintf(ptr, "\"bbox\":[");
+  MFJSON_CONST_BUF(ptr, "\"bbox\":[");
   ptr += intbox ? sprintf(ptr, "%d", DatumGetInt32(bbox->span.lower)) :
     lwprint_double(DatumGetFloat8(bbox->span.lower), precision, ptr);
-  ptr += sprintf(ptr, ",");
+  *ptr++ = ',';
   ptr += intbox ? sprintf(ptr, "%d", DatumGetInt32(bbox->span.upper) - 1) :
     lwprint_double(DatumGetFloat8(bbox->span.upper), precision, ptr);
-  ptr += sprintf(ptr, "],\"period\":{\"begin\":");
+  MFJSON_CONST_BUF(ptr, "],\"period\":{\"begin\":");
   ptr += datetimes_mfjson_buf(ptr, DatumGetTimestampTz(bbox->period.lower));
-  ptr += sprintf(ptr, ",\"end\":");
+  MFJSON_CONST_BUF(ptr, ",\"end\":");
   ptr += datetimes_mfjson_buf(ptr, DatumGetTimestampTz(bbox->period.upper));
-  ptr += sprintf(ptr, ",\"lower_inc\":%s,\"upper_inc\":%s},",
-    bbox->period.lower_inc ? "true" : "false",
-  bbox->period.upper_inc ? "true" : "false");
+  MFJSON_CONST_BUF(ptr, ",\"lower_inc\":");
+  ptr += bool_mfjson_buf(ptr, bbox->period.lower_inc);
+  MFJSON_CONST_BUF(ptr, ",\"upper_inc\":");
+  ptr += bool_mfjson_buf(ptr, bbox->period.upper_inc);
+  MFJSON_CONST_BUF(ptr, "},");
   return (ptr - output);
 }
 
@@ -363,31 +401,33 @@ stbox_mfjson_buf(char *output, const STBox *bbox, bool hasz, int precision)
 {
   assert(precision <= OUT_MAX_DOUBLE_PRECISION);
   char *ptr = output;
-  ptr += sprintf(ptr, "\"bbox\":[[");
+  MFJSON_CONST_BUF(ptr, "\"bbox\":[[");
   ptr += lwprint_double(bbox->xmin, precision, ptr);
-  ptr += sprintf(ptr, ",");
+  *ptr++ = ',';
   ptr += lwprint_double(bbox->ymin, precision, ptr);
   if (hasz)
   {
-    ptr += sprintf(ptr, ",");
+    *ptr++ = ',';
     ptr += lwprint_double(bbox->zmin, precision, ptr);
   }
-  ptr += sprintf(ptr, "],[");
+  MFJSON_CONST_BUF(ptr, "],[");
   ptr += lwprint_double(bbox->xmax, precision, ptr);
-  ptr += sprintf(ptr, ",");
+  *ptr++ = ',';
   ptr += lwprint_double(bbox->ymax, precision, ptr);
   if (hasz)
   {
-    ptr += sprintf(ptr, ",");
+    *ptr++ = ',';
     ptr += lwprint_double(bbox->zmax, precision, ptr);
   }
-  ptr += sprintf(ptr, "]],\"period\":{\"begin\":");
+  MFJSON_CONST_BUF(ptr, "]],\"period\":{\"begin\":");
   ptr += datetimes_mfjson_buf(ptr, DatumGetTimestampTz(bbox->period.lower));
-  ptr += sprintf(ptr, ",\"end\":");
+  MFJSON_CONST_BUF(ptr, ",\"end\":");
   ptr += datetimes_mfjson_buf(ptr, DatumGetTimestampTz(bbox->period.upper));
-  ptr += sprintf(ptr, ",\"lower_inc\":%s,\"upper_inc\":%s},",
-    bbox->period.lower_inc ? "true" : "false",
-	bbox->period.upper_inc ? "true" : "false");
+  MFJSON_CONST_BUF(ptr, ",\"lower_inc\":");
+  ptr += bool_mfjson_buf(ptr, bbox->period.lower_inc);
+  MFJSON_CONST_BUF(ptr, ",\"upper_inc\":");
+  ptr += bool_mfjson_buf(ptr, bbox->period.upper_inc);
+  MFJSON_CONST_BUF(ptr, "},");
   return (ptr - output);
 }
 
@@ -500,22 +540,22 @@ temptype_mfjson_buf(char *output, meosType temptype)
   switch (temptype)
   {
     case T_TBOOL:
-      ptr += sprintf(ptr, "{\"type\":\"MovingBoolean\",");
+      MFJSON_CONST_BUF(ptr, "{\"type\":\"MovingBoolean\",");
       break;
     case T_TINT:
-      ptr += sprintf(ptr, "{\"type\":\"MovingInteger\",");
+      MFJSON_CONST_BUF(ptr, "{\"type\":\"MovingInteger\",");
       break;
     case T_TFLOAT:
-      ptr += sprintf(ptr, "{\"type\":\"MovingFloat\",");
+      MFJSON_CONST_BUF(ptr, "{\"type\":\"MovingFloat\",");
       break;
     case T_TTEXT:
-      ptr += sprintf(ptr, "{\"type\":\"MovingText\",");
+      MFJSON_CONST_BUF(ptr, "{\"type\":\"MovingText\",");
       break;
     case T_TGEOMPOINT:
-      ptr += sprintf(ptr, "{\"type\":\"MovingGeomPoint\",");
+      MFJSON_CONST_BUF(ptr, "{\"type\":\"MovingGeomPoint\",");
       break;
     case T_TGEOGPOINT:
-      ptr += sprintf(ptr, "{\"type\":\"MovingGeogPoint\",");
+      MFJSON_CONST_BUF(ptr, "{\"type\":\"MovingGeogPoint\",");
       break;
     default: /* Error! */
       meos_error(ERROR, MEOS_ERR_MFJSON_OUTPUT,
@@ -559,13 +599,15 @@ tinstant_mfjson_buf(const TInstant *inst, bool isgeo, bool hasz,
   ptr += temptype_mfjson_buf(ptr, inst->temptype);
   if (srs) ptr += srs_mfjson_buf(ptr, srs);
   if (bbox) ptr += bbox_mfjson_buf(inst->temptype, ptr, bbox, hasz, precision);
-  ptr += sprintf(ptr, "\"%s\":[", isgeo ? "coordinates" : "values");
+  *ptr++ = '"';
+  ptr += cstring_mfjson_buf(ptr, isgeo ? "coordinates" : "values");
+  MFJSON_CONST_BUF(ptr, "\":[");
   ptr += isgeo ? coordinates_mfjson_buf(ptr, inst, precision) :
     temporal_basevalue_mfjson_buf(ptr, tinstant_value(inst), inst->temptype,
       precision);
-  ptr += sprintf(ptr, "],\"datetimes\":[");
+  MFJSON_CONST_BUF(ptr, "],\"datetimes\":[");
   ptr += datetimes_mfjson_buf(ptr, inst->t);
-  ptr += sprintf(ptr, "],\"interpolation\":\"None\"}");
+  MFJSON_CONST_BUF(ptr, "],\"interpolation\":\"None\"}");
   return (ptr - output);
 }
 
@@ -699,26 +741,33 @@ tsequence_mfjson_buf(const TSequence *seq, bool isgeo, bool hasz,
   ptr += temptype_mfjson_buf(ptr, seq->temptype);
   if (srs) ptr += srs_mfjson_buf(ptr, srs);
   if (bbox) ptr += bbox_mfjson_buf(seq->temptype, ptr, bbox, hasz, precision);
-  ptr += sprintf(ptr, "\"%s\":[", isgeo ? "coordinates" : "values");
+  *ptr++ = '"';
+  ptr += cstring_mfjson_buf(ptr, isgeo ? "coordinates" : "values");
+  MFJSON_CONST_BUF(ptr, "\":[");
   for (int i = 0; i < seq->count; i++)
   {
-    if (i) ptr += sprintf(ptr, ",");
+    if (i) *ptr++ = ',';
     const TInstant *inst = TSEQUENCE_INST_N(seq, i);
     ptr += isgeo ? coordinates_mfjson_buf(ptr, inst, precision) :
       temporal_basevalue_mfjson_buf(ptr, tinstant_value(inst), inst->temptype,
       precision);
   }
-  ptr += sprintf(ptr, "],\"datetimes\":[");
+  MFJSON_CONST_BUF(ptr, "],\"datetimes\":[");
   for (int i = 0; i < seq->count; i++)
   {
-    if (i) ptr += sprintf(ptr, ",");
+    if (i) *ptr++ = ',';
     const TInstant *inst = TSEQUENCE_INST_N(seq, i);
     ptr += datetimes_mfjson_buf(ptr, inst->t);
   }
-  ptr += sprintf(ptr, "],\"lower_inc\":%s,\"upper_inc\":%s,\"interpolation\":\"%s\"}",
-    seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false",
+  MFJSON_CONST_BUF(ptr, "],\"lower_inc\":");
+  ptr += bool_mfjson_buf(ptr, seq->period.lower_inc);
+  MFJSON_CONST_BUF(ptr, ",\"upper_inc\":");
+  ptr += bool_mfjson_buf(ptr, seq->period.upper_inc);
+  MFJSON_CONST_BUF(ptr, ",\"interpolation\":\"");
+  ptr += cstring_mfjson_buf(ptr,
     MEOS_FLAGS_DISCRETE_INTERP(seq->flags) ? "Discrete" :
-    ( MEOS_FLAGS_LINEAR_INTERP(seq->flags) ? "Linear" : "Step" ) );
+    ( MEOS_FLAGS_LINEAR_INTERP(seq->flags) ? "Linear" : "Step" ));
+  MFJSON_CONST_BUF(ptr, "\"}");
   return (ptr - output);
 }
 
@@ -857,33 +906,39 @@ tsequenceset_mfjson_buf(const TSequenceSet *ss, bool isgeo, bool hasz,
   ptr += temptype_mfjson_buf(ptr, ss->temptype);
   if (srs) ptr += srs_mfjson_buf(ptr, srs);
   if (bbox) ptr += bbox_mfjson_buf(ss->temptype, ptr, bbox, hasz, precision);
-  ptr += sprintf(ptr, "\"sequences\":[");
+  MFJSON_CONST_BUF(ptr, "\"sequences\":[");
   for (int i = 0; i < ss->count; i++)
   {
     const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
-    if (i) ptr += sprintf(ptr, ",");
-    ptr += sprintf(ptr, "{\"%s\":[", isgeo ? "coordinates" : "values");
+    if (i) *ptr++ = ',';
+    MFJSON_CONST_BUF(ptr, "{\"");
+    ptr += cstring_mfjson_buf(ptr, isgeo ? "coordinates" : "values");
+    MFJSON_CONST_BUF(ptr, "\":[");
     for (int j = 0; j < seq->count; j++)
     {
-      if (j) ptr += sprintf(ptr, ",");
+      if (j) *ptr++ = ',';
       const TInstant *inst = TSEQUENCE_INST_N(seq, j);
       ptr += isgeo ? coordinates_mfjson_buf(ptr, inst, precision) :
         temporal_basevalue_mfjson_buf(ptr, tinstant_value(inst),
           inst->temptype, precision);
     }
-    ptr += sprintf(ptr, "],\"datetimes\":[");
+    MFJSON_CONST_BUF(ptr, "],\"datetimes\":[");
     for (int j = 0; j < seq->count; j++)
     {
-      if (j) ptr += sprintf(ptr, ",");
+      if (j) *ptr++ = ',';
       const TInstant *inst = TSEQUENCE_INST_N(seq, j);
       ptr += datetimes_mfjson_buf(ptr, inst->t);
     }
-    ptr += sprintf(ptr, "],\"lower_inc\":%s,\"upper_inc\":%s}",
-      seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ?
-        "true" : "false");
+    MFJSON_CONST_BUF(ptr, "],\"lower_inc\":");
+    ptr += bool_mfjson_buf(ptr, seq->period.lower_inc);
+    MFJSON_CONST_BUF(ptr, ",\"upper_inc\":");
+    ptr += bool_mfjson_buf(ptr, seq->period.upper_inc);
+    *ptr++ = '}';
   }
-  ptr += sprintf(ptr, "],\"interpolation\":\"%s\"}",
+  MFJSON_CONST_BUF(ptr, "],\"interpolation\":\"");
+  ptr += cstring_mfjson_buf(ptr,
     MEOS_FLAGS_LINEAR_INTERP(ss->flags) ? "Linear" : "Step");
+  MFJSON_CONST_BUF(ptr, "\"}");
   return (ptr - output);
 }
 
@@ -1012,6 +1067,293 @@ temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags,
   return (char *) json_object_to_json_string_ext(jobj, flags);
 }
 
+#if MEOS
+/*****************************************************************************
+ * Streaming output in MF-JSON format
+ *
+ * The document is produced with constant memory: the pieces are written with
+ * the same *_mfjson_buf functions as above into a single chunk buffer, which
+ * is handed to a caller-supplied callback each time it fills up, instead of
+ * sizing and materializing the whole document
+ *****************************************************************************/
+
+/**
+ * @brief State for writing an MF-JSON document in chunks
+ */
+typedef struct
+{
+  char *buf;     /**< Chunk buffer */
+  size_t size;   /**< Size of the chunk buffer */
+  size_t len;    /**< Number of bytes pending in the buffer */
+  size_t (*writefn)(const char *, size_t, void *); /**< Output callback */
+  void *state;   /**< Opaque state passed to the callback */
+  bool failed;   /**< True when the callback did not accept the bytes */
+} MfjsonWriter;
+
+/**
+ * @brief Send the pending bytes of the chunk buffer to the output callback
+ */
+static void
+mfjson_writer_flush(MfjsonWriter *writer)
+{
+  if (writer->len > 0 && ! writer->failed &&
+      writer->writefn(writer->buf, writer->len, writer->state) != writer->len)
+    writer->failed = true;
+  writer->len = 0;
+  return;
+}
+
+/**
+ * @brief Return a write position with at least the given number of bytes
+ * available, flushing the pending bytes when the buffer is full
+ */
+static char *
+mfjson_writer_reserve(MfjsonWriter *writer, size_t size)
+{
+  if (writer->size - writer->len < size)
+    mfjson_writer_flush(writer);
+  if (writer->size < size)
+  {
+    /* A single piece larger than the buffer, e.g., a long text value */
+    writer->buf = repalloc(writer->buf, size);
+    writer->size = size;
+  }
+  return writer->buf + writer->len;
+}
+
+/**
+ * @brief Write a temporal instant in MF-JSON format in chunks
+ */
+static void
+tinstant_mfjson_stream(const TInstant *inst, bool isgeo, bool hasz,
+  int precision, const bboxunion *bbox, char *srs, MfjsonWriter *writer)
+{
+  size_t size = tinstant_mfjson_size(inst, isgeo, hasz, precision, bbox, srs);
+  char *ptr = mfjson_writer_reserve(writer, size);
+  writer->len += tinstant_mfjson_buf(inst, isgeo, hasz, precision, bbox, srs,
+    ptr);
+  return;
+}
+
+/**
+ * @brief Write a temporal sequence in MF-JSON format in chunks
+ * @param[in] component True when the sequence is written as a component of
+ * a sequence set and thus has neither temporal type nor interpolation
+ */
+static void
+tsequence_mfjson_stream(const TSequence *seq, bool isgeo, bool hasz,
+  int precision, const bboxunion *bbox, char *srs, bool component,
+  MfjsonWriter *writer)
+{
+  char *ptr, *start;
+  /* Write the header */
+  if (component)
+  {
+    ptr = start = mfjson_writer_reserve(writer, sizeof("{\"coordinates\":["));
+    MFJSON_CONST_BUF(ptr, "{\"");
+    ptr += cstring_mfjson_buf(ptr, isgeo ? "coordinates" : "values");
+    MFJSON_CONST_BUF(ptr, "\":[");
+    writer->len += (ptr - start);
+  }
+  else
+  {
+    size_t size = temptype_mfjson_size(seq->temptype) +
+      sizeof("\"coordinates\":[");
+    if (srs) size += srs_mfjson_size(srs);
+    if (bbox) size += bbox_mfjson_size(seq->temptype, hasz, precision);
+    ptr = start = mfjson_writer_reserve(writer, size);
+    ptr += temptype_mfjson_buf(ptr, seq->temptype);
+    if (srs) ptr += srs_mfjson_buf(ptr, srs);
+    if (bbox) ptr += bbox_mfjson_buf(seq->temptype, ptr, bbox, hasz,
+      precision);
+    *ptr++ = '"';
+    ptr += cstring_mfjson_buf(ptr, isgeo ? "coordinates" : "values");
+    MFJSON_CONST_BUF(ptr, "\":[");
+    writer->len += (ptr - start);
+  }
+  /* Write the values */
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    size_t size = (isgeo ? coordinates_mfjson_size(1, hasz, precision) :
+      temporal_basevalue_mfjson_size(tinstant_value(inst), inst->temptype,
+        precision)) + sizeof(",");
+    ptr = start = mfjson_writer_reserve(writer, size);
+    if (i) *ptr++ = ',';
+    ptr += isgeo ? coordinates_mfjson_buf(ptr, inst, precision) :
+      temporal_basevalue_mfjson_buf(ptr, tinstant_value(inst), inst->temptype,
+        precision);
+    writer->len += (ptr - start);
+  }
+  /* Write the datetimes */
+  ptr = start = mfjson_writer_reserve(writer, sizeof("],\"datetimes\":["));
+  MFJSON_CONST_BUF(ptr, "],\"datetimes\":[");
+  writer->len += (ptr - start);
+  for (int i = 0; i < seq->count; i++)
+  {
+    ptr = start = mfjson_writer_reserve(writer, datetimes_mfjson_size(1) +
+      sizeof(","));
+    if (i) *ptr++ = ',';
+    ptr += datetimes_mfjson_buf(ptr, TSEQUENCE_INST_N(seq, i)->t);
+    writer->len += (ptr - start);
+  }
+  /* Write the footer */
+  ptr = start = mfjson_writer_reserve(writer, sizeof(
+    "],\"lower_inc\":false,\"upper_inc\":false,\"interpolation\":\"Discrete\"}"));
+  MFJSON_CONST_BUF(ptr, "],\"lower_inc\":");
+  ptr += bool_mfjson_buf(ptr, seq->period.lower_inc);
+  MFJSON_CONST_BUF(ptr, ",\"upper_inc\":");
+  ptr += bool_mfjson_buf(ptr, seq->period.upper_inc);
+  if (component)
+    *ptr++ = '}';
+  else
+  {
+    MFJSON_CONST_BUF(ptr, ",\"interpolation\":\"");
+    ptr += cstring_mfjson_buf(ptr,
+      MEOS_FLAGS_DISCRETE_INTERP(seq->flags) ? "Discrete" :
+      ( MEOS_FLAGS_LINEAR_INTERP(seq->flags) ? "Linear" : "Step" ));
+    MFJSON_CONST_BUF(ptr, "\"}");
+  }
+  writer->len += (ptr - start);
+  return;
+}
+
+/**
+ * @brief Write a temporal sequence set in MF-JSON format in chunks
+ */
+static void
+tsequenceset_mfjson_stream(const TSequenceSet *ss, bool isgeo, bool hasz,
+  int precision, const bboxunion *bbox, char *srs, MfjsonWriter *writer)
+{
+  /* Write the header */
+  size_t size = temptype_mfjson_size(ss->temptype) + sizeof("\"sequences\":[");
+  if (srs) size += srs_mfjson_size(srs);
+  if (bbox) size += bbox_mfjson_size(ss->temptype, hasz, precision);
+  char *ptr, *start;
+  ptr = start = mfjson_writer_reserve(writer, size);
+  ptr += temptype_mfjson_buf(ptr, ss->temptype);
+  if (srs) ptr += srs_mfjson_buf(ptr, srs);
+  if (bbox) ptr += bbox_mfjson_buf(ss->temptype, ptr, bbox, hasz, precision);
+  MFJSON_CONST_BUF(ptr, "\"sequences\":[");
+  writer->len += (ptr - start);
+  /* Write the composing sequences */
+  for (int i = 0; i < ss->count; i++)
+  {
+    if (i)
+    {
+      ptr = mfjson_writer_reserve(writer, sizeof(","));
+      *ptr = ',';
+      writer->len++;
+    }
+    tsequence_mfjson_stream(TSEQUENCESET_SEQ_N(ss, i), isgeo, hasz, precision,
+      NULL, NULL, true, writer);
+  }
+  /* Write the footer */
+  ptr = start = mfjson_writer_reserve(writer,
+    sizeof("],\"interpolation\":\"Linear\"}"));
+  MFJSON_CONST_BUF(ptr, "],\"interpolation\":\"");
+  ptr += cstring_mfjson_buf(ptr,
+    MEOS_FLAGS_LINEAR_INTERP(ss->flags) ? "Linear" : "Step");
+  MFJSON_CONST_BUF(ptr, "\"}");
+  writer->len += (ptr - start);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Write the MF-JSON representation of a temporal value in chunks
+ * through a callback function.
+ *
+ * Only a buffer of the given chunk size is materialized; it is sent to the
+ * callback each time it fills up, so arbitrarily large temporal values are
+ * output with constant memory and the first chunk is produced without
+ * traversing the whole value. The callback must return the number of bytes
+ * given to it; any other return value stops the output.
+ * @param[in] temp Temporal value
+ * @param[in] with_bbox True when the output value has the bounding box
+ * @param[in] precision Number of decimal digits
+ * @param[in] srs Spatial reference system
+ * @param[in] chunksize Size in bytes of the output buffer, at least 1024
+ * @param[in] writefn Callback receiving the successive chunks
+ * @param[in] state Opaque state passed to the callback
+ * @return True on success
+ * @sqlfunc asMFJSON()
+ */
+bool
+temporal_as_mfjson_stream(const Temporal *temp, bool with_bbox, int precision,
+  char *srs, size_t chunksize,
+  size_t (*writefn)(const char *, size_t, void *), void *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) writefn))
+    return false;
+
+  /* Get bounding box if needed */
+  bboxunion *bbox = NULL, tmp;
+  if (with_bbox)
+  {
+    temporal_set_bbox(temp, &tmp);
+    bbox = &tmp;
+  }
+  bool isgeo = tgeo_type(temp->temptype);
+  bool hasz = MEOS_FLAGS_GET_Z(temp->flags);
+  MfjsonWriter writer;
+  writer.size = Max(chunksize, 1024);
+  writer.buf = palloc(writer.size);
+  writer.len = 0;
+  writer.writefn = writefn;
+  writer.state = state;
+  writer.failed = false;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    tinstant_mfjson_stream((TInstant *) temp, isgeo, hasz, precision, bbox,
+      srs, &writer);
+  else if (temp->subtype == TSEQUENCE)
+    tsequence_mfjson_stream((TSequence *) temp, isgeo, hasz, precision, bbox,
+      srs, false, &writer);
+  else /* temp->subtype == TSEQUENCESET */
+    tsequenceset_mfjson_stream((TSequenceSet *) temp, isgeo, hasz, precision,
+      bbox, srs, &writer);
+  mfjson_writer_flush(&writer);
+  pfree(writer.buf);
+  return ! writer.failed;
+}
+
+/**
+ * @brief Callback writing a chunk of an MF-JSON document to a file
+ */
+static size_t
+mfjson_file_write(const char *data, size_t size, void *state)
+{
+  return fwrite(data, 1, size, (FILE *) state);
+}
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Write the MF-JSON representation of a temporal value to a file in
+ * chunks.
+ * @param[in] temp Temporal value
+ * @param[in] with_bbox True when the output value has the bounding box
+ * @param[in] precision Number of decimal digits
+ * @param[in] srs Spatial reference system
+ * @param[in] chunksize Size in bytes of the output buffer, at least 1024
+ * @param[in] file Output file, which must be open for writing
+ * @return True on success
+ * @see temporal_as_mfjson_stream
+ * @sqlfunc asMFJSON()
+ */
+bool
+temporal_as_mfjson_file(const Temporal *temp, bool with_bbox, int precision,
+  char *srs, size_t chunksize, FILE *file)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) file))
+    return false;
+  return temporal_as_mfjson_stream(temp, with_bbox, precision, srs, chunksize,
+    &mfjson_file_write, file);
+}
+#endif /* MEOS */
+
 /*****************************************************************************
  * Output in WKT format
  *****************************************************************************/
@@ -1269,6 +1611,188 @@ temporal_basetype_to_wkb_size(Datum value, meosType basetype, int16 flags)
   return basetype_to_wkb_size(value, basetype, flags);
 }
 
+/*****************************************************************************
+ * Compressed WKB representation of the instant arrays of temporal floats
+ * and temporal points (see #WKB_COMPRESSED), inspired by the Gorilla time
+ * series database
+ *
+ * The instants are compressed in blocks of #MEOS_WKB_COMPRESS_BLOCKSIZE
+ * instants. The array starts with a directory of fixed-size block headers
+ * holding the first and last timestamp of the block, the minimum and
+ * maximum of every value dimension, and the cumulative end offset of the
+ * block payload, followed by the block payloads. Since the headers have a
+ * fixed stride, a reader can binary search the directory and decompress
+ * only the blocks covering a timestamp or a period (see
+ * #temporal_from_wkb_period).
+ *
+ * Within a block
+ * - The first timestamp is stored in full and every subsequent one as the
+ *   delta of the deltas between consecutive timestamps, zigzag-encoded as a
+ *   variable-length integer, so regularly sampled sequences take a single
+ *   byte per additional timestamp
+ * - The first value is stored in full and every subsequent one as the XOR
+ *   of its bit pattern with the previous value, stored as a length byte
+ *   followed by the significant bytes, so smooth series drop the high-order
+ *   bytes shared with the previous value
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the instant arrays of a temporal value are output in
+ * compressed form for the given variant
+ */
+static bool
+temporal_wkb_compressed(const Temporal *temp, uint8_t variant)
+{
+  if (! (variant & WKB_COMPRESSED) || temp->subtype == TINSTANT)
+    return false;
+  meosType basetype = temptype_basetype(temp->temptype);
+  return basetype == T_FLOAT8 || basetype == T_GEOMETRY ||
+    basetype == T_GEOGRAPHY;
+}
+
+/**
+ * @brief Return the number of value dimensions compressed for an instant
+ */
+static int
+tinstant_wkb_dims(const TInstant *inst)
+{
+  if (! tgeo_type(inst->temptype))
+    return 1;
+  return MEOS_FLAGS_GET_Z(inst->flags) ? 3 : 2;
+}
+
+/**
+ * @brief Copy into an array the value dimensions of a temporal instant
+ */
+static void
+tinstant_wkb_coords(const TInstant *inst, int dims, double *coords)
+{
+  if (dims == 1)
+    coords[0] = DatumGetFloat8(tinstant_value(inst));
+  else if (dims == 2)
+  {
+    const POINT2D *point = DATUM_POINT2D_P(tinstant_value(inst));
+    coords[0] = point->x; coords[1] = point->y;
+  }
+  else /* dims == 3 */
+  {
+    const POINT3DZ *point = DATUM_POINT3DZ_P(tinstant_value(inst));
+    coords[0] = point->x; coords[1] = point->y; coords[2] = point->z;
+  }
+  return;
+}
+
+/**
+ * @brief Return the zigzag encoding of a signed integer, which stores small
+ * negative and positive values alike in few bytes when varint-encoded
+ */
+static uint64_t
+zigzag_encode(int64 i)
+{
+  return ((uint64_t) i << 1) ^ (uint64_t) (i >> 63);
+}
+
+/**
+ * @brief Return the number of bytes of the varint encoding of an integer
+ */
+static size_t
+varint_to_wkb_size(uint64_t val)
+{
+  size_t size = 1;
+  while (val >= 0x80)
+  {
+    val >>= 7;
+    size++;
+  }
+  return size;
+}
+
+/**
+ * @brief Return the number of significant bytes of an XORed value, that is,
+ * without its high-order zero bytes
+ */
+static int
+wkb_xor_nbytes(uint64_t xorval)
+{
+  int nbytes = 0;
+  while (xorval)
+  {
+    xorval >>= 8;
+    nbytes++;
+  }
+  return nbytes;
+}
+
+/**
+ * @brief Return the size in bytes of the payload of one block of temporal
+ * instants represented in compressed Well-Known Binary (WKB) format
+ */
+static size_t
+tinstblock_to_wkb_size(const TInstant **instants, int count)
+{
+  int dims = tinstant_wkb_dims(instants[0]);
+  /* First timestamp and first value stored in full */
+  size_t result = MEOS_WKB_TIMESTAMP_SIZE + MEOS_WKB_DOUBLE_SIZE * dims;
+  double coords[3], prevcoords[3];
+  uint64_t bits, prevbits[3];
+  tinstant_wkb_coords(instants[0], dims, prevcoords);
+  for (int d = 0; d < dims; d++)
+    memcpy(&prevbits[d], &prevcoords[d], sizeof(uint64_t));
+  int64 prevdelta = 0;
+  for (int i = 1; i < count; i++)
+  {
+    /* The first delta of deltas encodes the first delta itself */
+    int64 delta = (int64) instants[i]->t - (int64) instants[i - 1]->t;
+    result += varint_to_wkb_size(zigzag_encode(delta - prevdelta));
+    prevdelta = delta;
+    tinstant_wkb_coords(instants[i], dims, coords);
+    for (int d = 0; d < dims; d++)
+    {
+      memcpy(&bits, &coords[d], sizeof(uint64_t));
+      result += MEOS_WKB_BYTE_SIZE + wkb_xor_nbytes(bits ^ prevbits[d]);
+      prevbits[d] = bits;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Return the size in bytes of the fixed-size header of one block of
+ * temporal instants represented in compressed Well-Known Binary (WKB) format
+ */
+static size_t
+tinstblock_header_wkb_size(int dims)
+{
+  /* First and last timestamp, minimum and maximum of every value dimension,
+   * and cumulative end offset of the block payload */
+  return 2 * MEOS_WKB_TIMESTAMP_SIZE + 2 * dims * MEOS_WKB_DOUBLE_SIZE +
+    MEOS_WKB_INT4_SIZE;
+}
+
+/**
+ * @brief Return the size in bytes of an array of temporal instants
+ * represented in compressed Well-Known Binary (WKB) format, that is, the
+ * block directory followed by the block payloads
+ */
+static size_t
+tinstarr_compressed_to_wkb_size(const TInstant **instants, int count)
+{
+  int dims = tinstant_wkb_dims(instants[0]);
+  int nblocks = (count + MEOS_WKB_COMPRESS_BLOCKSIZE - 1) /
+    MEOS_WKB_COMPRESS_BLOCKSIZE;
+  size_t result = (size_t) nblocks * tinstblock_header_wkb_size(dims);
+  for (int b = 0; b < nblocks; b++)
+  {
+    int n = Min(MEOS_WKB_COMPRESS_BLOCKSIZE,
+      count - b * MEOS_WKB_COMPRESS_BLOCKSIZE);
+    result += tinstblock_to_wkb_size(
+      &instants[b * MEOS_WKB_COMPRESS_BLOCKSIZE], n);
+  }
+  return result;
+}
+
+/*****************************************************************************/
+
 /**
  * @brief Return the maximum size in bytes of an array of temporal instants
  * represented in Well-Known Binary (WKB) format
@@ -1338,7 +1862,10 @@ tsequence_to_wkb_size(const TSequence *seq, uint8_t variant)
   size += MEOS_WKB_INT4_SIZE + MEOS_WKB_BYTE_SIZE;
   const TInstant **instants = tsequence_instants(seq);
   /* Include the TInstant array */
-  size += tinstarr_to_wkb_size(instants, seq->count);
+  if (temporal_wkb_compressed((Temporal *) seq, variant))
+    size += tinstarr_compressed_to_wkb_size(instants, seq->count);
+  else
+    size += tinstarr_to_wkb_size(instants, seq->count);
   pfree(instants);
   return size;
 }
@@ -1360,10 +1887,24 @@ tsequenceset_to_wkb_size(const TSequenceSet *ss, uint8_t variant)
   size += MEOS_WKB_INT4_SIZE;
   /* For each sequence include the number of instants and the period bounds flag */
   size += ss->count * (MEOS_WKB_INT4_SIZE + MEOS_WKB_BYTE_SIZE);
-  /* Include all the instants of all the sequences */
-  const TInstant **instants = tsequenceset_instants(ss);
-  size += tinstarr_to_wkb_size(instants, ss->totalcount);
-  pfree(instants);
+  /* Include all the instants of all the sequences. The compression restarts
+   * at each composing sequence, as done by #tsequenceset_to_wkb_buf */
+  if (temporal_wkb_compressed((Temporal *) ss, variant))
+  {
+    for (int i = 0; i < ss->count; i++)
+    {
+      const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+      const TInstant **instants = tsequence_instants(seq);
+      size += tinstarr_compressed_to_wkb_size(instants, seq->count);
+      pfree(instants);
+    }
+  }
+  else
+  {
+    const TInstant **instants = tsequenceset_instants(ss);
+    size += tinstarr_to_wkb_size(instants, ss->totalcount);
+    pfree(instants);
+  }
   return size;
 }
 
@@ -1434,6 +1975,40 @@ wkb_swap_bytes(uint8_t variant)
   return true;
 }
 
+/*****************************************************************************
+ * Streaming hash sink for the WKB writer
+ *
+ * When the sink is active, the leaf write functions below fold the bytes they
+ * would output into a running FNV-1a hash instead of storing them, so that
+ * the WKB representation of a value can be hashed without allocating and
+ * filling the output buffer. The composite write functions only advance the
+ * buffer pointer, hence they can be driven over a dummy buffer.
+ *****************************************************************************/
+
+#define WKB_HASH_FNV_OFFSET UINT64CONST(0xCBF29CE484222325)
+#define WKB_HASH_FNV_PRIME UINT64CONST(0x00000100000001B3)
+
+static __thread struct
+{
+  bool active; /**< True when the WKB writer feeds the hash sink */
+  uint64 state; /**< Running FNV-1a hash value */
+} _wkb_hash_sink = { false, 0 };
+
+/**
+ * @brief Fold the bytes that the WKB writer would output into the hash sink
+ */
+static inline void
+wkb_hash_sink_fold(const char *valptr, size_t size, bool swap)
+{
+  uint64 state = _wkb_hash_sink.state;
+  for (size_t i = 0; i < size; i++)
+  {
+    state ^= (uint8_t) valptr[swap ? size - 1 - i : i];
+    state *= WKB_HASH_FNV_PRIME;
+  }
+  _wkb_hash_sink.state = state;
+}
+
 /**
  * @brief Write into the buffer the bytes of the value represented in Well-Known
  * Binary (WKB) format
@@ -1441,6 +2016,11 @@ wkb_swap_bytes(uint8_t variant)
 uint8_t *
 bytes_to_wkb_buf(char *valptr, size_t size, uint8_t *buf, uint8_t variant)
 {
+  if (_wkb_hash_sink.active)
+  {
+    wkb_hash_sink_fold(valptr, size, wkb_swap_bytes(variant));
+    return buf + size;
+  }
   if (variant & WKB_HEX)
   {
     int swap = wkb_swap_bytes(variant);
@@ -1477,6 +2057,12 @@ bytes_to_wkb_buf(char *valptr, size_t size, uint8_t *buf, uint8_t variant)
 uint8_t *
 endian_to_wkb_buf(uint8_t *buf, uint8_t variant)
 {
+  if (_wkb_hash_sink.active)
+  {
+    char endian = ((variant & WKB_NDR) ? (char) 1 : (char) 0);
+    wkb_hash_sink_fold(&endian, 1, false);
+    return buf + 1;
+  }
   if (variant & WKB_HEX)
   {
     buf[0] = '0';
@@ -1776,6 +2362,11 @@ bounds_to_wkb_buf(bool lower_inc, bool upper_inc, uint8_t *buf, uint8_t variant)
     wkb_bounds |= MEOS_WKB_LOWER_INC;
   if (upper_inc)
     wkb_bounds |= MEOS_WKB_UPPER_INC;
+  if (_wkb_hash_sink.active)
+  {
+    wkb_hash_sink_fold((char *) &wkb_bounds, 1, false);
+    return buf + 1;
+  }
   if (variant & WKB_HEX)
   {
     buf[0] = '0';
@@ -1913,6 +2504,11 @@ tbox_to_wkb_flags_buf(const TBox *box, uint8_t *buf, uint8_t variant)
     wkb_flags |= MEOS_WKB_XFLAG;
   if (MEOS_FLAGS_GET_T(box->flags))
     wkb_flags |= MEOS_WKB_TFLAG;
+  if (_wkb_hash_sink.active)
+  {
+    wkb_hash_sink_fold((char *) &wkb_flags, 1, false);
+    return buf + 1;
+  }
   if (variant & WKB_HEX)
   {
     buf[0] = '0';
@@ -2019,12 +2615,132 @@ stbox_to_wkb_buf(const STBox *box, uint8_t *buf, uint8_t variant)
 
 /*****************************************************************************/
 
+/**
+ * @brief Write into the buffer a varint represented in Well-Known Binary
+ * (WKB) format, that is, groups of 7 bits starting from the low-order ones,
+ * where the high bit of a byte states whether more bytes follow
+ */
+static uint8_t *
+varint_to_wkb_buf(uint64_t val, uint8_t *buf, uint8_t variant)
+{
+  while (val >= 0x80)
+  {
+    buf = uint8_to_wkb_buf((uint8_t) ((val & 0x7F) | 0x80), buf, variant);
+    val >>= 7;
+  }
+  return uint8_to_wkb_buf((uint8_t) val, buf, variant);
+}
+
+/**
+ * @brief Write into the buffer the payload of one block of temporal
+ * instants represented in compressed Well-Known Binary (WKB) format as
+ * follows
+ * - First timestamp (in full) and first value (in full)
+ * - For each subsequent instant
+ *   - Delta of the timestamp deltas, zigzag-encoded as a varint
+ *   - For each value dimension, the XOR with the previous value as a length
+ *     byte followed by the significant bytes, low-order first
+ */
+static uint8_t *
+tinstblock_to_wkb_buf(const TInstant **instants, int count,
+  uint8_t *buf, uint8_t variant)
+{
+  int dims = tinstant_wkb_dims(instants[0]);
+  /* Write the first timestamp and the first value in full */
+  buf = timestamp_to_wkb_buf(instants[0]->t, buf, variant);
+  double coords[3], prevcoords[3];
+  uint64_t bits, prevbits[3];
+  tinstant_wkb_coords(instants[0], dims, prevcoords);
+  for (int d = 0; d < dims; d++)
+  {
+    buf = double_to_wkb_buf(prevcoords[d], buf, variant);
+    memcpy(&prevbits[d], &prevcoords[d], sizeof(uint64_t));
+  }
+  int64 prevdelta = 0;
+  for (int i = 1; i < count; i++)
+  {
+    /* The first delta of deltas encodes the first delta itself */
+    int64 delta = (int64) instants[i]->t - (int64) instants[i - 1]->t;
+    buf = varint_to_wkb_buf(zigzag_encode(delta - prevdelta), buf, variant);
+    prevdelta = delta;
+    tinstant_wkb_coords(instants[i], dims, coords);
+    for (int d = 0; d < dims; d++)
+    {
+      memcpy(&bits, &coords[d], sizeof(uint64_t));
+      uint64_t xorval = bits ^ prevbits[d];
+      int nbytes = wkb_xor_nbytes(xorval);
+      buf = uint8_to_wkb_buf((uint8_t) nbytes, buf, variant);
+      for (int k = 0; k < nbytes; k++)
+        buf = uint8_to_wkb_buf((uint8_t) (xorval >> (8 * k)), buf, variant);
+      prevbits[d] = bits;
+    }
+  }
+  return buf;
+}
+
+/**
+ * @brief Write into the buffer an array of temporal instants represented in
+ * compressed Well-Known Binary (WKB) format, that is, the directory of
+ * fixed-size block headers followed by the block payloads
+ */
+static uint8_t *
+tinstarr_compressed_to_wkb_buf(const TInstant **instants, int count,
+  uint8_t *buf, uint8_t variant)
+{
+  int dims = tinstant_wkb_dims(instants[0]);
+  int nblocks = (count + MEOS_WKB_COMPRESS_BLOCKSIZE - 1) /
+    MEOS_WKB_COMPRESS_BLOCKSIZE;
+  /* Write the block directory */
+  size_t endoffset = 0;
+  for (int b = 0; b < nblocks; b++)
+  {
+    const TInstant **block = &instants[b * MEOS_WKB_COMPRESS_BLOCKSIZE];
+    int n = Min(MEOS_WKB_COMPRESS_BLOCKSIZE,
+      count - b * MEOS_WKB_COMPRESS_BLOCKSIZE);
+    /* First and last timestamp of the block */
+    buf = timestamp_to_wkb_buf(block[0]->t, buf, variant);
+    buf = timestamp_to_wkb_buf(block[n - 1]->t, buf, variant);
+    /* Minimum and maximum of every value dimension */
+    double vmin[3], vmax[3], coords[3];
+    tinstant_wkb_coords(block[0], dims, vmin);
+    memcpy(vmax, vmin, sizeof(vmax));
+    for (int i = 1; i < n; i++)
+    {
+      tinstant_wkb_coords(block[i], dims, coords);
+      for (int d = 0; d < dims; d++)
+      {
+        vmin[d] = Min(vmin[d], coords[d]);
+        vmax[d] = Max(vmax[d], coords[d]);
+      }
+    }
+    for (int d = 0; d < dims; d++)
+    {
+      buf = double_to_wkb_buf(vmin[d], buf, variant);
+      buf = double_to_wkb_buf(vmax[d], buf, variant);
+    }
+    /* Cumulative end offset of the block payload */
+    endoffset += tinstblock_to_wkb_size(block, n);
+    buf = int32_to_wkb_buf((int) endoffset, buf, variant);
+  }
+  /* Write the block payloads */
+  for (int b = 0; b < nblocks; b++)
+  {
+    int n = Min(MEOS_WKB_COMPRESS_BLOCKSIZE,
+      count - b * MEOS_WKB_COMPRESS_BLOCKSIZE);
+    buf = tinstblock_to_wkb_buf(&instants[b * MEOS_WKB_COMPRESS_BLOCKSIZE],
+      n, buf, variant);
+  }
+  return buf;
+}
+
+/*****************************************************************************/
+
 /**
  * @brief Write into the buffer the flag containing the temporal type and
  * other characteristics represented in Well-Known Binary (WKB) format.
  * In binary format it is a byte as follows
- * xSGZIITT
- * S = SRID, G = Geodetic, Z = has Z, x = unused bit
+ * CSGZIITT
+ * C = Compressed, S = SRID, G = Geodetic, Z = has Z
  * II = Interpolation with values 0 to 2
  * TT = Temporal subtype with values 1 to 3
  */
@@ -2044,6 +2760,8 @@ temporal_flags_to_wkb_buf(const Temporal *temp, uint8_t *buf, uint8_t variant)
     if (tpoint_wkb_needs_srid(temp, variant))
       wkb_flags |= MEOS_WKB_SRIDFLAG;
   }
+  if (temporal_wkb_compressed(temp, variant))
+    wkb_flags |= MEOS_WKB_COMPRESSEDFLAG;
   /* Write the flags */
   return uint8_to_wkb_buf(wkb_flags, buf, variant);
 }
@@ -2121,10 +2839,19 @@ tsequence_to_wkb_buf(const TSequence *seq, uint8_t *buf, uint8_t variant)
   buf = bounds_to_wkb_buf(seq->period.lower_inc, seq->period.upper_inc, buf,
     variant);
   /* Write the array of instants */
-  for (int i = 0; i < seq->count; i++)
+  if (temporal_wkb_compressed((Temporal *) seq, variant))
   {
-    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
-    buf = tinstant_basevalue_time_to_wkb_buf(inst, buf, variant);
+    const TInstant **instants = tsequence_instants(seq);
+    buf = tinstarr_compressed_to_wkb_buf(instants, seq->count, buf, variant);
+    pfree(instants);
+  }
+  else
+  {
+    for (int i = 0; i < seq->count; i++)
+    {
+      const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+      buf = tinstant_basevalue_time_to_wkb_buf(inst, buf, variant);
+    }
   }
   return buf;
 }
@@ -2166,11 +2893,22 @@ tsequenceset_to_wkb_buf(const TSequenceSet *ss, uint8_t *buf, uint8_t variant)
     /* Write the period bounds */
     buf = bounds_to_wkb_buf(seq->period.lower_inc, seq->period.upper_inc, buf,
       variant);
-    /* Write the array of instants */
-    for (int j = 0; j < seq->count; j++)
+    /* Write the array of instants, restarting the compression at each
+     * composing sequence */
+    if (temporal_wkb_compressed((Temporal *) ss, variant))
     {
-      const TInstant *inst = TSEQUENCE_INST_N(seq, j);
-      buf = tinstant_basevalue_time_to_wkb_buf(inst, buf, variant);
+      const TInstant **instants = tsequence_instants(seq);
+      buf = tinstarr_compressed_to_wkb_buf(instants, seq->count, buf,
+        variant);
+      pfree(instants);
+    }
+    else
+    {
+      for (int j = 0; j < seq->count; j++)
+      {
+        const TInstant *inst = TSEQUENCE_INST_N(seq, j);
+        buf = tinstant_basevalue_time_to_wkb_buf(inst, buf, variant);
+      }
     }
   }
   return buf;
@@ -2244,6 +2982,10 @@ datum_as_wkb(Datum value, meosType type, uint8_t variant, size_t *size_out)
   uint8_t *buf = NULL;
   uint8_t *wkb_out = NULL;
 
+  /* An error raised while the hash sink was driving the writer may have left
+   * the sink active; deactivate it so that the buffer is actually filled */
+  _wkb_hash_sink.active = false;
+
   /* Initialize output size */
   if (size_out) *size_out = 0;
 
@@ -2305,6 +3047,8 @@ datum_as_wkb(Datum value, meosType type, uint8_t variant, size_t *size_out)
   if (size_out)
     *size_out = buf_size;
 
+  MEOS_STATS_INC(wkb_out_calls);
+  MEOS_STATS_ADD(wkb_out_bytes, buf_size);
   return wkb_out;
 }
 
@@ -2320,6 +3064,35 @@ datum_as_hexwkb(Datum value, meosType type, uint8_t variant, size_t *size)
   return result;
 }
 
+/**
+ * @brief Return the 64-bit hash of the WKB representation of a datum value
+ * computed with a seed.
+ *
+ * The WKB writer is driven in streaming mode: the bytes are folded into the
+ * hash as they are produced and the output buffer is never materialized.
+ * The little-endian extended variant is always hashed so that the result
+ * does not depend on the machine architecture.
+ */
+uint64
+datum_hash_wkb_extended(Datum value, meosType type, uint64 seed)
+{
+  /* Dummy buffer over which the composite write functions advance */
+  uint8_t dummy;
+
+  /* Seed the hash state and activate the sink */
+  _wkb_hash_sink.state = WKB_HASH_FNV_OFFSET;
+  _wkb_hash_sink.active = true;
+  wkb_hash_sink_fold((char *) &seed, sizeof(uint64), false);
+
+  /* Drive the WKB writer, which feeds the sink instead of the buffer */
+  datum_to_wkb_buf(value, type, &dummy,
+    (uint8_t) WKB_NDR | (uint8_t) WKB_EXTENDED);
+
+  /* Deactivate the sink and return the accumulated hash */
+  _wkb_hash_sink.active = false;
+  return _wkb_hash_sink.state;
+}
+
 /*****************************************************************************
  * WKB and HexWKB functions for the MEOS API
  *****************************************************************************/
@@ -2536,6 +3309,82 @@ temporal_as_hexwkb(const Temporal *temp, uint8_t variant, size_t *size_out)
     variant | (uint8_t) WKB_HEX, size_out);
   return result;
 }
+
+/**
+ * @ingroup libmeos_temporal_inout
+ * @brief Write the WKB representation of an array of temporal values into a
+ * buffer provided by the caller.
+ *
+ * The values are written back to back into the buffer without any per-value
+ * allocation, so that export pipelines serializing many rows can reuse one
+ * large buffer across calls. The endianness resolution is shared by all the
+ * values instead of being redone per value.
+ *
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[in] variant Unsigned bitmask value as in #temporal_as_wkb, except
+ * that the hex-encoded ASCII variant is not supported
+ * @param[out] buf Output buffer provided by the caller
+ * @param[in] buf_size Size of the output buffer in bytes
+ * @param[out] sizes If supplied, receives the size in bytes of the WKB of
+ * each value, from which the caller can derive the start of every value for
+ * scatter-gather output
+ * @return On success the total number of bytes written; on error, in
+ * particular when the buffer is too small for the values, return SIZE_MAX
+ */
+size_t
+temporalarr_as_wkb_buf(const Temporal **temparr, int count, uint8_t variant,
+  uint8_t *buf, size_t buf_size, size_t *sizes)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_not_null((void *) buf) ||
+      ! ensure_positive(count))
+    return SIZE_MAX;
+  if (variant & WKB_HEX)
+  {
+    meos_error(ERROR, MEOS_ERR_WKB_OUTPUT,
+      "The hex-encoded variant is not supported by the batch WKB writer");
+    return SIZE_MAX;
+  }
+
+  /* Shared setup: if neither or both endian variants are specified, choose
+   * the native order once for all the values */
+  if (! (variant & WKB_NDR || variant & WKB_XDR) ||
+    (variant & WKB_NDR && variant & WKB_XDR))
+  {
+    if (MEOS_IS_BIG_ENDIAN)
+      variant = variant | (uint8_t) WKB_XDR;
+    else
+      variant = variant | (uint8_t) WKB_NDR;
+  }
+
+  uint8_t *ptr = buf;
+  size_t avail = buf_size;
+  for (int i = 0; i < count; i++)
+  {
+    const Temporal *temp = temparr[i];
+    size_t size = datum_to_wkb_size(PointerGetDatum(temp), temp->temptype,
+      variant);
+    if (size == 0 || size > avail)
+    {
+      meos_error(ERROR, MEOS_ERR_WKB_OUTPUT,
+        "The buffer of the batch WKB writer is too small: " UINT64_FORMAT
+        " bytes available, " UINT64_FORMAT " needed for value %d",
+        avail, size, i);
+      return SIZE_MAX;
+    }
+    uint8_t *next = datum_to_wkb_buf(PointerGetDatum(temp), temp->temptype,
+      ptr, variant);
+    assert((size_t) (next - ptr) == size);
+    if (sizes)
+      sizes[i] = size;
+    ptr = next;
+    avail -= size;
+  }
+  MEOS_STATS_ADD(wkb_out_calls, count);
+  MEOS_STATS_ADD(wkb_out_bytes, (size_t) (ptr - buf));
+  return (size_t) (ptr - buf);
+}
 #endif /* MEOS */
 
 /*****************************************************************************/
@@ -40,6 +40,7 @@
 #include <limits.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <utils/datetime.h>
 #include <utils/float.h>
 #include <utils/timestamp.h>
 #if POSTGRESQL_VERSION_NUMBER >= 160000
@@ -51,6 +52,7 @@
 #include "general/temporal.h"
 #include "general/pg_types.h"
 #include "general/doublen.h"
+#include "general/type_out.h"
 #include "general/type_parser.h"
 #include "point/pgis_call.h"
 #include "point/tpoint_spatialfuncs.h"
@@ -590,14 +592,77 @@ spanarr_sort(Span *spans, int count)
     (qsort_comparator) &span_cmp);
 }
 
+/* Threshold under which the radix sort of instants falls back to qsort:
+ * for short arrays the counting passes cost more than the comparisons */
+#define TINSTARR_RADIX_MIN 64
+
+/**
+ * @brief Pair of sort key and instant used by the radix sort of instants
+ */
+typedef struct
+{
+  uint64 key;
+  TInstant *inst;
+} RadixPair;
+
 /**
  * @brief Sort function for temporal instants
+ * @note Arrays of at least #TINSTARR_RADIX_MIN elements are sorted with a
+ * stable LSD radix sort on the 8-byte timestamps, which avoids the
+ * per-comparison function calls of qsort when assembling large out-of-order
+ * batches. Passes where all timestamps share a byte, typically the high
+ * ones, are skipped.
  */
 void
 tinstarr_sort(TInstant **instants, int count)
 {
-  qsort(instants, (size_t) count, sizeof(TInstant *),
-    (qsort_comparator) &tinstarr_sort_cmp);
+  if (count < TINSTARR_RADIX_MIN)
+  {
+    qsort(instants, (size_t) count, sizeof(TInstant *),
+      (qsort_comparator) &tinstarr_sort_cmp);
+    return;
+  }
+
+  RadixPair *pairs = palloc(sizeof(RadixPair) * count * 2);
+  RadixPair *src = pairs, *dst = pairs + count;
+  /* Flip the sign bit so that signed timestamps order as unsigned keys */
+  for (int i = 0; i < count; i++)
+  {
+    src[i].key = ((uint64) instants[i]->t) ^ ((uint64) 1 << 63);
+    src[i].inst = instants[i];
+  }
+  /* Compute the eight byte histograms in a single pass */
+  int hist[8][256];
+  memset(hist, 0, sizeof(hist));
+  for (int i = 0; i < count; i++)
+  {
+    uint64 key = src[i].key;
+    for (int b = 0; b < 8; b++)
+      hist[b][(key >> (b * 8)) & 0xFF]++;
+  }
+  for (int b = 0; b < 8; b++)
+  {
+    int *h = hist[b];
+    /* Skip the pass if all keys share this byte */
+    if (h[(src[0].key >> (b * 8)) & 0xFF] == count)
+      continue;
+    /* Exclusive prefix sum turning counts into target positions */
+    int sum = 0;
+    for (int j = 0; j < 256; j++)
+    {
+      int c = h[j];
+      h[j] = sum;
+      sum += c;
+    }
+    for (int i = 0; i < count; i++)
+      dst[h[(src[i].key >> (b * 8)) & 0xFF]++] = src[i];
+    RadixPair *swap = src;
+    src = dst;
+    dst = swap;
+  }
+  for (int i = 0; i < count; i++)
+    instants[i] = src[i].inst;
+  pfree(pairs);
 }
 
 /**
@@ -769,6 +834,8 @@ pfree_array(void **array, int count)
  * @brief Return the string resulting from assembling the array of strings.
  * The function frees the memory of the input strings after finishing.
  * @param[in] strings Array of strings to ouput
+ * @param[in] lengths Array of lengths of the strings, cached by the caller
+ * during the size pass so that the strings are not traversed again
  * @param[in] count Number of elements in the input array
  * @param[in] outlen Total length of the elements and the additional ','
  * @param[in] prefix Prefix to add to the string (e.g., for interpolation)
@@ -777,8 +844,8 @@ pfree_array(void **array, int count)
  * @param[in] spaces True when elements should be separated by spaces
  */
 char *
-stringarr_to_string(char **strings, int count, size_t outlen, char *prefix,
-  char open, char close, bool quotes, bool spaces)
+stringarr_to_string(char **strings, const size_t *lengths, int count,
+  size_t outlen, char *prefix, char open, char close, bool quotes, bool spaces)
 {
   size_t size = strlen(prefix) + outlen + 3;
   if (quotes)
@@ -794,8 +861,8 @@ stringarr_to_string(char **strings, int count, size_t outlen, char *prefix,
   {
     if (quotes)
       result[pos++] = '"';
-    strcpy(result + pos, strings[i]);
-    pos += strlen(strings[i]);
+    memcpy(result + pos, strings[i], lengths[i]);
+    pos += lengths[i];
     if (quotes)
       result[pos++] = '"';
     result[pos++] = ',';
@@ -817,6 +884,78 @@ stringarr_to_string(char **strings, int count, size_t outlen, char *prefix,
   return result;
 }
 
+#if MEOS
+/**
+ * @brief Send the pending bytes of the chunk buffer of a string writer to
+ * the output callback
+ */
+static void
+string_writer_flush(StringWriter *writer)
+{
+  if (writer->len > 0 && ! writer->failed &&
+      writer->writefn(writer->buf, writer->len, writer->state) != writer->len)
+    writer->failed = true;
+  writer->len = 0;
+  return;
+}
+
+/**
+ * @brief Initialize a string writer producing its output in chunks
+ * @param[out] writer String writer
+ * @param[in] chunksize Size in bytes of the chunk buffer, at least 1024
+ * @param[in] writefn Callback receiving the successive chunks
+ * @param[in] state Opaque state passed to the callback
+ */
+void
+string_writer_init(StringWriter *writer, size_t chunksize,
+  size_t (*writefn)(const char *, size_t, void *), void *state)
+{
+  writer->size = Max(chunksize, 1024);
+  writer->buf = palloc(writer->size);
+  writer->len = 0;
+  writer->writefn = writefn;
+  writer->state = state;
+  writer->failed = false;
+  return;
+}
+
+/**
+ * @brief Append a string to a string writer, flushing the pending bytes to
+ * the output callback when the chunk buffer fills up
+ */
+void
+string_writer_append(StringWriter *writer, const char *str, size_t length)
+{
+  /* Pieces larger than the chunk buffer are sent to the callback directly */
+  if (length >= writer->size)
+  {
+    string_writer_flush(writer);
+    if (! writer->failed &&
+        writer->writefn(str, length, writer->state) != length)
+      writer->failed = true;
+    return;
+  }
+  if (writer->size - writer->len < length)
+    string_writer_flush(writer);
+  memcpy(writer->buf + writer->len, str, length);
+  writer->len += length;
+  return;
+}
+
+/**
+ * @brief Flush the pending bytes of a string writer and free its chunk
+ * buffer
+ * @return True when all the chunks were accepted by the output callback
+ */
+bool
+string_writer_finish(StringWriter *writer)
+{
+  string_writer_flush(writer);
+  pfree(writer->buf);
+  return ! writer->failed;
+}
+#endif /* MEOS */
+
 /*****************************************************************************
  * Hypotenuse functions
  *****************************************************************************/
@@ -1094,4 +1233,87 @@ basetype_out(Datum value, meosType basetype, int maxdd)
   }
 }
 
+/**
+ * @brief Return the maximum size in bytes of the output representation of a
+ * value of the base type, including the terminating NUL, or 0 when the base
+ * type has no buffer-writing output function
+ */
+size_t
+basetype_out_size(Datum value, meosType basetype,
+  int maxdd __attribute__((unused)))
+{
+  assert(meos_basetype(basetype));
+  assert(maxdd >= 0);
+
+  switch (basetype)
+  {
+    case T_TIMESTAMPTZ:
+      return MAXDATELEN + 1;
+    case T_BOOL:
+      return 2;
+    case T_INT4:
+      return sizeof("+2147483647");
+    case T_INT8:
+      return sizeof("+9223372036854775807");
+    case T_FLOAT8:
+      return OUT_DOUBLE_BUFFER_SIZE;
+    case T_TEXT:
+      return VARSIZE_ANY_EXHDR(DatumGetTextP(value)) + sizeof("\"\"");
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief Write the output representation of a value of the base type into
+ * the buffer
+ * @return Number of characters written, not including the terminating NUL
+ * @note The caller must have verified with #basetype_out_size that the base
+ * type has a buffer-writing output function and sized the buffer accordingly
+ */
+size_t
+basetype_out_buf(char *output, Datum value, meosType basetype, int maxdd)
+{
+  assert(meos_basetype(basetype));
+  assert(maxdd >= 0);
+
+  switch (basetype)
+  {
+    case T_TIMESTAMPTZ:
+    {
+      int len = pg_timestamptz_out_buf(DatumGetTimestampTz(value), output);
+      if (len < 0)
+      {
+        output[0] = '\0';
+        return 0;
+      }
+      return len;
+    }
+    case T_BOOL:
+      return bool_out_buf(DatumGetBool(value), output);
+    case T_INT4:
+      return int4_out_buf(DatumGetInt32(value), output);
+    case T_INT8:
+      return int8_out_buf(DatumGetInt64(value), output);
+    case T_FLOAT8:
+      return float8_out_buf(DatumGetFloat8(value), maxdd, output);
+    case T_TEXT:
+    {
+      const text *txt = DatumGetTextP(value);
+      size_t len = VARSIZE_ANY_EXHDR(txt);
+      char *ptr = output;
+      *ptr++ = '"';
+      memcpy(ptr, VARDATA_ANY(txt), len);
+      ptr += len;
+      *ptr++ = '"';
+      *ptr = '\0';
+      return (ptr - output);
+    }
+    default: /* Error! */
+      meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+        "Unknown output function for base type: %d", basetype);
+      return 0;
+  }
+}
+
 /*****************************************************************************/
@@ -45,6 +45,7 @@
 #include "general/tsequence.h"
 #include "general/type_parser.h"
 #include "general/type_util.h"
+#include "point/pgis_call.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "npoint/tnpoint_static.h"
 #include "npoint/tnpoint_parser.h"
@@ -156,6 +157,164 @@ tnpoint_tgeompoint(const Temporal *temp)
 
 /*****************************************************************************/
 
+/**
+ * @brief Convert a temporal network point into a temporal geometric point
+ * interpolating the position on the geometry of a route batch
+ */
+static TInstant *
+tnpointinst_tgeompointinst_batch(const TInstant *inst,
+  const RouteBatch *batch)
+{
+  const Npoint *np = DatumGetNpointP(tinstant_value(inst));
+  const GSERIALIZED *line = route_batch_geom(batch, np->rid);
+  GSERIALIZED *geom = gserialized_line_interpolate_point(
+    (GSERIALIZED *) line, np->pos, 0);
+  TInstant *result = tinstant_make(PointerGetDatum(geom), T_TGEOMPOINT,
+    inst->t);
+  pfree(geom);
+  return result;
+}
+
+/**
+ * @brief Convert a temporal network point into a temporal geometric point
+ * interpolating the positions on the geometries of a route batch
+ */
+static TSequence *
+tnpointdiscseq_tgeompointdiscseq_batch(const TSequence *seq,
+  const RouteBatch *batch)
+{
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    instants[i] = tnpointinst_tgeompointinst_batch(inst, batch);
+  }
+  return tsequence_make_free(instants, seq->count, true, true, DISCRETE,
+    NORMALIZE_NO);
+}
+
+/**
+ * @brief Convert a temporal network point into a temporal geometric point
+ * interpolating the positions on the geometries of a route batch
+ */
+static TSequence *
+tnpointcontseq_tgeompointcontseq_batch(const TSequence *seq,
+  const RouteBatch *batch)
+{
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  const TInstant *inst = TSEQUENCE_INST_N(seq, 0);
+  const Npoint *np = DatumGetNpointP(tinstant_value(inst));
+  const GSERIALIZED *line = route_batch_geom(batch, np->rid);
+  int srid = gserialized_get_srid(line);
+  LWLINE *lwline = (LWLINE *) lwgeom_from_gserialized(line);
+  for (int i = 0; i < seq->count; i++)
+  {
+    inst = TSEQUENCE_INST_N(seq, i);
+    np = DatumGetNpointP(tinstant_value(inst));
+    POINTARRAY *opa = lwline_interpolate_points(lwline, np->pos, 0);
+    assert(opa->npoints <= 1);
+    LWGEOM *lwpoint = lwpoint_as_lwgeom(lwpoint_construct(srid, NULL, opa));
+    Datum point = PointerGetDatum(geo_serialize(lwpoint));
+    instants[i] = tinstant_make(point, T_TGEOMPOINT, inst->t);
+    lwgeom_free(lwpoint);
+    pfree(DatumGetPointer(point));
+  }
+  lwline_free(lwline);
+  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
+    seq->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE_NO);
+}
+
+/**
+ * @brief Convert a temporal network point into a temporal geometric point
+ * interpolating the positions on the geometries of a route batch
+ */
+static Temporal *
+tnpoint_tgeompoint1(const Temporal *temp, const RouteBatch *batch)
+{
+  Temporal *result;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    result = (Temporal *) tnpointinst_tgeompointinst_batch((TInstant *) temp,
+      batch);
+  else if (temp->subtype == TSEQUENCE)
+    result = MEOS_FLAGS_DISCRETE_INTERP(temp->flags) ?
+      (Temporal *) tnpointdiscseq_tgeompointdiscseq_batch((TSequence *) temp,
+        batch) :
+      (Temporal *) tnpointcontseq_tgeompointcontseq_batch((TSequence *) temp,
+        batch);
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    TSequenceSet *ss = (TSequenceSet *) temp;
+    TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+    for (int i = 0; i < ss->count; i++)
+      sequences[i] = tnpointcontseq_tgeompointcontseq_batch(
+        TSEQUENCESET_SEQ_N(ss, i), batch);
+    result = (Temporal *) tsequenceset_make_free(sequences, ss->count,
+      NORMALIZE_NO);
+  }
+  return result;
+}
+
+/**
+ * @brief Convert an array of temporal network points into temporal
+ * geometric points fetching the geometry of every distinct route exactly
+ * once
+ *
+ * Converting the values one at a time fetches the geometry of a route from
+ * the edge table for every value that traverses it. The batch conversion
+ * collects the distinct routes of all the values first, fetches their
+ * geometries with one query per chunk of routes, and interpolates all the
+ * positions against the fetched geometries.
+ * @param[in] temparr Array of temporal network points
+ * @param[in] count Number of values
+ * @return On error return NULL
+ */
+Temporal **
+tnpoint_tgeompoint_batch(const Temporal **temparr, int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count))
+    return NULL;
+  int total = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_not_null((void *) temparr[i]) ||
+        ! ensure_temporal_has_type(temparr[i], T_TNPOINT))
+      return NULL;
+    total += temporal_num_instants(temparr[i]);
+  }
+
+  /* Collect the route identifiers of all the values */
+  int64 *rids = palloc(sizeof(int64) * total);
+  int nrids = 0;
+  for (int i = 0; i < count; i++)
+  {
+    int ninsts;
+    const TInstant **instants = temporal_instants(temparr[i], &ninsts);
+    for (int j = 0; j < ninsts; j++)
+    {
+      int64 rid = DatumGetNpointP(tinstant_value(instants[j]))->rid;
+      /* Skip runs of the same route to keep the array small, the batch
+       * removes the remaining duplicates */
+      if (nrids == 0 || rids[nrids - 1] != rid)
+        rids[nrids++] = rid;
+    }
+    pfree(instants);
+  }
+
+  RouteBatch *batch = route_batch_make(rids, nrids);
+  pfree(rids);
+  if (! batch)
+    return NULL;
+  Temporal **result = palloc(sizeof(Temporal *) * count);
+  for (int i = 0; i < count; i++)
+    result[i] = tnpoint_tgeompoint1(temparr[i], batch);
+  route_batch_free(batch);
+  return result;
+}
+
+/*****************************************************************************/
+
 /**
  * @brief Convert a temporal geometric point as a temporal network point.
  */
@@ -499,4 +658,204 @@ tnpoint_routes(const Temporal *temp)
   return result;
 }
 
+/*****************************************************************************
+ * Restriction functions
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the route of a temporal network point instant
+ * satisfies the restriction to (the complement of) a route
+ */
+static bool
+tnpointinst_restrict_route_test(const TInstant *inst, int64 rid, bool atfunc)
+{
+  bool equal = (tnpointinst_route(inst) == rid);
+  return atfunc ? equal : ! equal;
+}
+
+/**
+ * @brief Return true if the route of a temporal network point instant
+ * satisfies the restriction to (the complement of) a set of routes
+ */
+static bool
+tnpointinst_restrict_routes_test(const TInstant *inst, const Set *s,
+  bool atfunc)
+{
+  bool found = contains_set_value(s, Int64GetDatum(tnpointinst_route(inst)),
+    T_INT8);
+  return atfunc ? found : ! found;
+}
+
+/**
+ * @brief Restrict a temporal network point discrete sequence to (the
+ * complement of) a route
+ * @note Only the route identifiers of the instants are compared, the values
+ * themselves are never fetched
+ */
+TSequence *
+tnpointdiscseq_restrict_route(const TSequence *seq, int64 rid, bool atfunc)
+{
+  assert(seq);
+  const TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  int count = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    if (tnpointinst_restrict_route_test(inst, rid, atfunc))
+      instants[count++] = inst;
+  }
+  TSequence *result = (count == 0) ? NULL :
+    tsequence_make(instants, count, true, true, DISCRETE, NORMALIZE_NO);
+  pfree(instants);
+  return result;
+}
+
+/**
+ * @brief Restrict a temporal network point discrete sequence to (the
+ * complement of) a set of routes
+ */
+TSequence *
+tnpointdiscseq_restrict_routes(const TSequence *seq, const Set *s,
+  bool atfunc)
+{
+  assert(seq); assert(s);
+  const TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  int count = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    if (tnpointinst_restrict_routes_test(inst, s, atfunc))
+      instants[count++] = inst;
+  }
+  TSequence *result = (count == 0) ? NULL :
+    tsequence_make(instants, count, true, true, DISCRETE, NORMALIZE_NO);
+  pfree(instants);
+  return result;
+}
+
+/**
+ * @brief Restrict a temporal network point continuous sequence to (the
+ * complement of) a route
+ * @note All instants of a continuous sequence are on the same route and thus
+ * only the first instant is read
+ */
+TSequence *
+tnpointcontseq_restrict_route(const TSequence *seq, int64 rid, bool atfunc)
+{
+  assert(seq);
+  if (tnpointinst_restrict_route_test(TSEQUENCE_INST_N(seq, 0), rid, atfunc))
+    return tsequence_copy(seq);
+  return NULL;
+}
+
+/**
+ * @brief Restrict a temporal network point continuous sequence to (the
+ * complement of) a set of routes
+ */
+TSequence *
+tnpointcontseq_restrict_routes(const TSequence *seq, const Set *s,
+  bool atfunc)
+{
+  assert(seq); assert(s);
+  if (tnpointinst_restrict_routes_test(TSEQUENCE_INST_N(seq, 0), s, atfunc))
+    return tsequence_copy(seq);
+  return NULL;
+}
+
+/**
+ * @brief Restrict a temporal network point sequence set to (the complement
+ * of) a route
+ * @note Since all instants of a sequence are on the same route, only one
+ * instant per sequence is read and the matching sequences are kept as a whole
+ */
+TSequenceSet *
+tnpointseqset_restrict_route(const TSequenceSet *ss, int64 rid, bool atfunc)
+{
+  assert(ss);
+  const TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+  int count = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    if (tnpointinst_restrict_route_test(TSEQUENCE_INST_N(seq, 0), rid,
+        atfunc))
+      sequences[count++] = seq;
+  }
+  TSequenceSet *result = (count == 0) ? NULL :
+    tsequenceset_make(sequences, count, NORMALIZE_NO);
+  pfree(sequences);
+  return result;
+}
+
+/**
+ * @brief Restrict a temporal network point sequence set to (the complement
+ * of) a set of routes
+ */
+TSequenceSet *
+tnpointseqset_restrict_routes(const TSequenceSet *ss, const Set *s,
+  bool atfunc)
+{
+  assert(ss); assert(s);
+  const TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+  int count = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    if (tnpointinst_restrict_routes_test(TSEQUENCE_INST_N(seq, 0), s,
+        atfunc))
+      sequences[count++] = seq;
+  }
+  TSequenceSet *result = (count == 0) ? NULL :
+    tsequenceset_make(sequences, count, NORMALIZE_NO);
+  pfree(sequences);
+  return result;
+}
+
+/**
+ * @brief Restrict a temporal network point to (the complement of) a route
+ */
+Temporal *
+tnpoint_restrict_route(const Temporal *temp, int64 rid, bool atfunc)
+{
+  Temporal *result;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    result = tnpointinst_restrict_route_test((TInstant *) temp, rid, atfunc) ?
+      (Temporal *) tinstant_copy((TInstant *) temp) : NULL;
+  else if (temp->subtype == TSEQUENCE)
+    result = MEOS_FLAGS_DISCRETE_INTERP(temp->flags) ?
+      (Temporal *) tnpointdiscseq_restrict_route((TSequence *) temp, rid,
+        atfunc) :
+      (Temporal *) tnpointcontseq_restrict_route((TSequence *) temp, rid,
+        atfunc);
+  else /* temp->subtype == TSEQUENCESET */
+    result = (Temporal *) tnpointseqset_restrict_route((TSequenceSet *) temp,
+      rid, atfunc);
+  return result;
+}
+
+/**
+ * @brief Restrict a temporal network point to (the complement of) a set of
+ * routes
+ */
+Temporal *
+tnpoint_restrict_routes(const Temporal *temp, const Set *s, bool atfunc)
+{
+  Temporal *result;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    result = tnpointinst_restrict_routes_test((TInstant *) temp, s, atfunc) ?
+      (Temporal *) tinstant_copy((TInstant *) temp) : NULL;
+  else if (temp->subtype == TSEQUENCE)
+    result = MEOS_FLAGS_DISCRETE_INTERP(temp->flags) ?
+      (Temporal *) tnpointdiscseq_restrict_routes((TSequence *) temp, s,
+        atfunc) :
+      (Temporal *) tnpointcontseq_restrict_routes((TSequence *) temp, s,
+        atfunc);
+  else /* temp->subtype == TSEQUENCESET */
+    result = (Temporal *) tnpointseqset_restrict_routes((TSequenceSet *) temp,
+      s, atfunc);
+  return result;
+}
+
 /*****************************************************************************/
@@ -430,8 +430,7 @@ tnpointseq_cumulative_length(const TSequence *seq, double prevlength)
     inst1 = TSEQUENCE_INST_N(seq, 0);
     TInstant *inst = tinstant_make(Float8GetDatum(prevlength), T_TFLOAT,
       inst1->t);
-    TSequence *result = tinstant_to_tsequence(inst, LINEAR);
-    pfree(inst);
+    TSequence *result = tinstant_to_tsequence_free(inst, LINEAR);
     return result;
   }
 
@@ -48,6 +48,7 @@
 /* MEOS */
 #include <meos.h>
 #include "general/pg_types.h"
+#include "general/stats.h"
 #include "general/tnumber_mathfuncs.h"
 #include "general/type_out.h"
 #include "general/type_util.h"
@@ -111,11 +112,10 @@ npointarr_geom(Npoint **points, int count)
   LWGEOM **geoms = palloc(sizeof(LWGEOM *) * count);
   for (int i = 0; i < count; i++)
   {
-    GSERIALIZED *gsline = route_geom(points[i]->rid);
-    int32_t srid = gserialized_get_srid(gsline);
-    LWGEOM *line = lwgeom_from_gserialized(gsline);
-    geoms[i] = lwgeom_line_interpolate_point(line, points[i]->pos, srid, 0);
-    pfree(gsline); pfree(line);
+    GSERIALIZED *gspoint = route_interpolate_point(points[i]->rid,
+      points[i]->pos);
+    geoms[i] = lwgeom_from_gserialized(gspoint);
+    pfree(gspoint);
   }
   int newcount;
   LWGEOM **newgeoms = lwpointarr_remove_duplicates(geoms, count, &newcount);
@@ -437,6 +437,240 @@ nsegment_end_position(const Nsegment *ns)
   return ns->pos2;
 }
 
+/*****************************************************************************
+ * Route cache
+ *
+ * Fleets run on a fixed road network and thus the same routes are fetched
+ * from the ways table and measured over and over. The cache below keeps the
+ * most recently used routes for the lifetime of the process: the geometry
+ * and the length fetched from the edge table, and a cumulative length table
+ * built at the first interpolation on the route so that subsequent
+ * interpolations are a binary search instead of a walk along the line.
+ *****************************************************************************/
+
+/** Number of routes kept in the process-lifetime route cache */
+#define ROUTE_CACHE_SIZE 128
+
+/**
+ * Entry of the route cache
+ */
+typedef struct RouteCacheEntry
+{
+  int64 rid;          /**< Route identifier */
+  GSERIALIZED *geom;  /**< Route geometry, NULL when not fetched yet */
+  bool haslength;     /**< True when the length has been fetched */
+  double length;      /**< Length of the route in the edge table */
+  uint32_t npoints;   /**< Number of vertices of the route geometry */
+  double *cumlength;  /**< Cumulative length at every vertex, NULL until the
+                           first interpolation on the route */
+  uint64 lastused;    /**< Value of the clock at the last access */
+} RouteCacheEntry;
+
+/** Process-lifetime cache of the most recently used routes. The entries are
+ * allocated with malloc since they outlive the memory contexts of the
+ * queries that fill them */
+static RouteCacheEntry _route_cache[ROUTE_CACHE_SIZE];
+/** Logical clock advanced at every access for least-recently used eviction */
+static uint64 _route_cache_clock = 0;
+
+/**
+ * @brief Return the cache entry of a route, NULL when the route is not
+ * in the cache
+ */
+static RouteCacheEntry *
+route_cache_find(int64 rid)
+{
+  for (int i = 0; i < ROUTE_CACHE_SIZE; i++)
+    if (_route_cache[i].lastused != 0 && _route_cache[i].rid == rid)
+    {
+      _route_cache[i].lastused = ++_route_cache_clock;
+      MEOS_STATS_INC(cache_hits);
+      return &_route_cache[i];
+    }
+  MEOS_STATS_INC(cache_misses);
+  return NULL;
+}
+
+/**
+ * @brief Return a fresh cache entry for a route, evicting the least
+ * recently used entry when the cache is full
+ */
+static RouteCacheEntry *
+route_cache_add(int64 rid)
+{
+  RouteCacheEntry *entry = &_route_cache[0];
+  for (int i = 1; i < ROUTE_CACHE_SIZE; i++)
+    if (_route_cache[i].lastused < entry->lastused)
+      entry = &_route_cache[i];
+  if (entry->geom)
+    free(entry->geom);
+  if (entry->cumlength)
+    free(entry->cumlength);
+  memset(entry, 0, sizeof(RouteCacheEntry));
+  entry->rid = rid;
+  entry->lastused = ++_route_cache_clock;
+  return entry;
+}
+
+/*****************************************************************************
+ * Route batches
+ *
+ * Converting a large batch of temporal network points touches many more
+ * routes than the route cache keeps. A route batch fetches the geometry of
+ * every distinct route of the batch exactly once, with one query per chunk
+ * of route identifiers instead of one query per value, and serves lookups
+ * with a binary search over the identifiers.
+ *****************************************************************************/
+
+/** Number of route identifiers fetched by a single query */
+#define ROUTE_BATCH_CHUNK 64
+
+/**
+ * @brief Return a negative or a positive value depending on whether the
+ * first route identifier is less than or greater than the second one
+ */
+static int
+rid_cmp(const void *a, const void *b)
+{
+  int64 rid1 = *(const int64 *) a;
+  int64 rid2 = *(const int64 *) b;
+  if (rid1 < rid2)
+    return -1;
+  if (rid1 > rid2)
+    return 1;
+  return 0;
+}
+
+/**
+ * @brief Construct a route batch with the geometries of the given routes
+ * @param[in] rids Array of route identifiers, may contain duplicates
+ * @param[in] count Number of elements in the array
+ * @return On error return NULL
+ */
+RouteBatch *
+route_batch_make(int64 *rids, int count)
+{
+  assert(rids);
+  assert(count > 0);
+  /* Sort the identifiers and remove the duplicates */
+  qsort(rids, count, sizeof(int64), &rid_cmp);
+  RouteBatch *batch = palloc(sizeof(RouteBatch));
+  batch->rids = palloc(sizeof(int64) * count);
+  batch->geoms = palloc0(sizeof(GSERIALIZED *) * count);
+  batch->count = 0;
+  for (int i = 0; i < count; i++)
+    if (i == 0 || rids[i] != rids[i - 1])
+      batch->rids[batch->count++] = rids[i];
+
+  /* Fetch the geometries one chunk of routes at a time */
+  char sql[ROUTE_BATCH_CHUNK * 24 + 64];
+  for (int lower = 0; lower < batch->count; lower += ROUTE_BATCH_CHUNK)
+  {
+    int upper = Min(lower + ROUTE_BATCH_CHUNK, batch->count);
+    char *ptr = sql;
+    ptr += sprintf(ptr,
+      "SELECT gid, the_geom FROM public.ways WHERE gid IN (");
+    for (int i = lower; i < upper; i++)
+      ptr += sprintf(ptr, "%s%ld", (i == lower) ? "" : ",", batch->rids[i]);
+    sprintf(ptr, ")");
+    SPI_connect();
+    int ret = SPI_execute(sql, true, upper - lower);
+    if (ret > 0 && SPI_tuptable != NULL)
+    {
+      SPITupleTable *tuptable = SPI_tuptable;
+      for (uint64 row = 0; row < SPI_processed; row++)
+      {
+        bool isNull;
+        int64 rid = DatumGetInt64(SPI_getbinval(tuptable->vals[row],
+          tuptable->tupdesc, 1, &isNull));
+        if (isNull)
+          continue;
+        Datum line = SPI_getbinval(tuptable->vals[row], tuptable->tupdesc, 2,
+          &isNull);
+        if (isNull)
+          continue;
+        /* Must allocate this in upper executor context to keep it alive
+         * after SPI_finish() */
+        GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(line);
+        GSERIALIZED *geom = (GSERIALIZED *) SPI_palloc(gs->size);
+        memcpy(geom, gs, gs->size);
+        route_batch_set(batch, rid, geom);
+      }
+    }
+    SPI_finish();
+  }
+
+  /* Ensure all the routes were found */
+  for (int i = 0; i < batch->count; i++)
+    if (! batch->geoms[i])
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Cannot get the geometry for route %ld", batch->rids[i]);
+      route_batch_free(batch);
+      return NULL;
+    }
+  return batch;
+}
+
+/**
+ * @brief Return the position of a route identifier in a route batch, -1
+ * when the route is not in the batch
+ */
+static int
+route_batch_pos(const RouteBatch *batch, int64 rid)
+{
+  int lower = 0, upper = batch->count - 1;
+  while (lower <= upper)
+  {
+    int middle = (lower + upper) / 2;
+    if (batch->rids[middle] == rid)
+      return middle;
+    if (batch->rids[middle] < rid)
+      lower = middle + 1;
+    else
+      upper = middle - 1;
+  }
+  return -1;
+}
+
+/**
+ * @brief Store the geometry of a route in a route batch
+ */
+void
+route_batch_set(RouteBatch *batch, int64 rid, GSERIALIZED *geom)
+{
+  int pos = route_batch_pos(batch, rid);
+  assert(pos >= 0);
+  batch->geoms[pos] = geom;
+  return;
+}
+
+/**
+ * @brief Return the geometry of a route in a route batch
+ * @note The result is owned by the batch and must not be freed
+ */
+const GSERIALIZED *
+route_batch_geom(const RouteBatch *batch, int64 rid)
+{
+  int pos = route_batch_pos(batch, rid);
+  return (pos >= 0) ? batch->geoms[pos] : NULL;
+}
+
+/**
+ * @brief Free a route batch
+ */
+void
+route_batch_free(RouteBatch *batch)
+{
+  for (int i = 0; i < batch->count; i++)
+    if (batch->geoms[i])
+      pfree(batch->geoms[i]);
+  pfree(batch->rids);
+  pfree(batch->geoms);
+  pfree(batch);
+  return;
+}
+
 /*****************************************************************************
  * Conversions between network and Euclidean space
  *****************************************************************************/
@@ -472,6 +706,10 @@ route_exists(int64 rid)
 double
 route_length(int64 rid)
 {
+  RouteCacheEntry *entry = route_cache_find(rid);
+  if (entry && entry->haslength)
+    return entry->length;
+
   char sql[64];
   sprintf(sql, "SELECT length FROM public.ways WHERE gid = %ld", rid);
   bool isNull = true;
@@ -493,17 +731,26 @@ route_length(int64 rid)
       "Cannot get the length for route %ld", rid);
     return -1.0;
   }
+  /* Remember the length for the lifetime of the process */
+  if (! entry)
+    entry = route_cache_add(rid);
+  entry->haslength = true;
+  entry->length = result;
   return result;
 }
 
 /**
- * @brief Access the edge table to get the route geometry from corresponding
- * route identifier
+ * @brief Return the cache entry of a route with its geometry, fetching it
+ * from the edge table when the route is not in the cache
  * @return On error return NULL
  */
-GSERIALIZED *
-route_geom(int64 rid)
+static RouteCacheEntry *
+route_cache_geom(int64 rid)
 {
+  RouteCacheEntry *entry = route_cache_find(rid);
+  if (entry && entry->geom)
+    return entry;
+
   char sql[64];
   sprintf(sql, "SELECT the_geom FROM public.ways WHERE gid = %ld", rid);
   bool isNull = true;
@@ -517,9 +764,9 @@ route_geom(int64 rid)
     Datum line = SPI_getbinval(tuptable->vals[0], tuptable->tupdesc, 1, &isNull);
     if (!isNull)
     {
-      /* Must allocate this in upper executor context to keep it alive after SPI_finish() */
+      /* The cache entries outlive the memory contexts of the queries */
       GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(line);
-      result = (GSERIALIZED *) SPI_palloc(gs->size);
+      result = (GSERIALIZED *) malloc(gs->size);
       memcpy(result, gs, gs->size);
     }
   }
@@ -534,10 +781,111 @@ route_geom(int64 rid)
 
   if (! ensure_not_empty(result))
   {
-    pfree(result);
+    free(result);
     return NULL;
   }
 
+  if (! entry)
+    entry = route_cache_add(rid);
+  entry->geom = result;
+  return entry;
+}
+
+/**
+ * @brief Access the edge table to get the route geometry from corresponding
+ * route identifier
+ * @return On error return NULL
+ */
+GSERIALIZED *
+route_geom(int64 rid)
+{
+  RouteCacheEntry *entry = route_cache_geom(rid);
+  if (! entry)
+    return NULL;
+  /* Return a copy since the callers free the result */
+  GSERIALIZED *result = palloc(entry->geom->size);
+  memcpy(result, entry->geom, entry->geom->size);
+  return result;
+}
+
+/**
+ * @brief Build the cumulative length table of a cached route
+ */
+static void
+route_cache_measure(RouteCacheEntry *entry)
+{
+  LWLINE *line = (LWLINE *) lwgeom_from_gserialized(entry->geom);
+  POINTARRAY *pa = line->points;
+  entry->npoints = pa->npoints;
+  entry->cumlength = malloc(sizeof(double) * pa->npoints);
+  entry->cumlength[0] = 0;
+  const POINT2D *p1 = getPoint2d_cp(pa, 0);
+  for (uint32_t i = 1; i < pa->npoints; i++)
+  {
+    const POINT2D *p2 = getPoint2d_cp(pa, i);
+    entry->cumlength[i] = entry->cumlength[i - 1] +
+      hypot(p2->x - p1->x, p2->y - p1->y);
+    p1 = p2;
+  }
+  lwline_free(line);
+  return;
+}
+
+/**
+ * @brief Return the point at a fraction of the total length of a route
+ * using the cumulative length table of the route cache
+ * @return On error return NULL
+ */
+GSERIALIZED *
+route_interpolate_point(int64 rid, double pos)
+{
+  RouteCacheEntry *entry = route_cache_geom(rid);
+  if (! entry)
+    return NULL;
+  /* Fall back to the generic interpolation for 3D or non-line routes */
+  if (gserialized_get_type(entry->geom) != LINETYPE ||
+      FLAGS_GET_Z(entry->geom->gflags))
+    return gserialized_line_interpolate_point(entry->geom, pos, 0);
+
+  if (! entry->cumlength)
+    route_cache_measure(entry);
+  int32_t srid = gserialized_get_srid(entry->geom);
+  LWLINE *line = (LWLINE *) lwgeom_from_gserialized(entry->geom);
+  POINTARRAY *pa = line->points;
+  double total = entry->cumlength[entry->npoints - 1];
+  GSERIALIZED *result;
+  if (total == 0 || pos <= 0)
+  {
+    const POINT2D *p = getPoint2d_cp(pa, 0);
+    result = gspoint_make(p->x, p->y, 0, false, false, srid);
+  }
+  else if (pos >= 1)
+  {
+    const POINT2D *p = getPoint2d_cp(pa, entry->npoints - 1);
+    result = gspoint_make(p->x, p->y, 0, false, false, srid);
+  }
+  else
+  {
+    /* Binary search for the segment containing the target length */
+    double target = pos * total;
+    uint32_t lower = 0, upper = entry->npoints - 1;
+    while (lower + 1 < upper)
+    {
+      uint32_t middle = (lower + upper) / 2;
+      if (entry->cumlength[middle] <= target)
+        lower = middle;
+      else
+        upper = middle;
+    }
+    const POINT2D *p1 = getPoint2d_cp(pa, lower);
+    const POINT2D *p2 = getPoint2d_cp(pa, lower + 1);
+    double seglength = entry->cumlength[lower + 1] - entry->cumlength[lower];
+    double ratio = (seglength == 0) ? 0 :
+      (target - entry->cumlength[lower]) / seglength;
+    result = gspoint_make(p1->x + ratio * (p2->x - p1->x),
+      p1->y + ratio * (p2->y - p1->y), 0, false, false, srid);
+  }
+  lwline_free(line);
   return result;
 }
 
@@ -582,10 +930,7 @@ rid_from_geom(Datum geom)
 GSERIALIZED *
 npoint_geom(const Npoint *np)
 {
-  GSERIALIZED *line = route_geom(np->rid);
-  GSERIALIZED *result = gserialized_line_interpolate_point(line, np->pos, 0);
-  pfree(line);
-  return result;
+  return route_interpolate_point(np->rid, np->pos);
 }
 
 /**
@@ -51,6 +51,7 @@
 #include <lwgeom_geos.h>
 /* MEOS */
 #include "general/temporal.h"
+#include "point/lwgeom_inline.h"
 #include "point/tpoint_spatialfuncs.h"
 
 /* To avoid including lwgeom_functions_analytic.h */
@@ -662,7 +663,7 @@ gserialized_azimuth(GSERIALIZED *gs1, GSERIALIZED *gs2, double *result)
   }
 
   /* Compute azimuth */
-  if (! azimuth_pt_pt(&p1, &p2, result))
+  if (! meos_azimuth_pt_pt(&p1, &p2, result))
     return false;
 
   return true;
@@ -781,6 +782,87 @@ GEOS2POSTGIS(GEOSGeom geom, char want3d)
   return result;
 }
 
+/*****************************************************************************
+ * Prepared geometry cache
+ *****************************************************************************/
+
+/**
+ * @brief Cache of the last geometry converted to a GEOS prepared geometry
+ *
+ * The temporal spatial relationships evaluate the same base geometry, e.g.,
+ * a geofence, against every simple component of a trajectory, which without
+ * a cache converts that geometry GSERIALIZED->LWGEOM->GEOS on every call.
+ * The cache keeps the GEOS geometry and its prepared version for the last
+ * repeated geometry seen, keyed by the address of the serialized geometry,
+ * so that the conversion and the preparation are paid once per scan. As in
+ * PostGIS, the geometry is prepared only on its second use so that one-shot
+ * calls do not pay for the preparation. Since addresses can be recycled by
+ * the memory allocator, the size and the leading bytes of the geometry are
+ * compared as well before the cached entry is used. The cache is
+ * thread-local since the spatial relationships may be called from the
+ * threads of the pool.
+ */
+typedef struct
+{
+  const GSERIALIZED *gs;  /**< Address of the cached geometry */
+  size_t size;            /**< Size of the cached geometry in bytes */
+  char header[64];        /**< Leading bytes to guard against address reuse */
+  GEOSGeometry *geos;     /**< GEOS version of the geometry */
+  const GEOSPreparedGeometry *prep; /**< Prepared version of the geometry */
+} GeosPreparedCache;
+
+static __thread GeosPreparedCache _geos_prep_cache =
+  { NULL, 0, { 0 }, NULL, NULL };
+
+/**
+ * @brief Empty the prepared geometry cache of the current thread
+ */
+void
+meos_geos_prepared_cache_clear(void)
+{
+  GeosPreparedCache *cache = &_geos_prep_cache;
+  if (cache->prep)
+    GEOSPreparedGeom_destroy(cache->prep);
+  if (cache->geos)
+    GEOSGeom_destroy(cache->geos);
+  memset(cache, 0, sizeof(GeosPreparedCache));
+}
+
+/**
+ * @brief Return the prepared version of a geometry seen on a previous call,
+ * or NULL on its first use
+ */
+static const GEOSPreparedGeometry *
+geos_prepared_lookup(const GSERIALIZED *gs)
+{
+  GeosPreparedCache *cache = &_geos_prep_cache;
+  size_t size = VARSIZE(gs);
+  size_t headersz = Min(size, sizeof(cache->header));
+  if (cache->gs != gs || cache->size != size ||
+      memcmp(cache->header, (const char *) gs, headersz) != 0)
+  {
+    /* Another geometry: drop the cached entry and remember the new one,
+     * without paying for the conversion on its first use */
+    meos_geos_prepared_cache_clear();
+    cache->gs = gs;
+    cache->size = size;
+    memcpy(cache->header, (const char *) gs, headersz);
+    return NULL;
+  }
+  if (! cache->prep)
+  {
+    /* Second use of the geometry: convert and prepare it */
+    cache->geos = POSTGIS2GEOS(gs);
+    if (! cache->geos)
+    {
+      cache->gs = NULL;
+      return NULL;
+    }
+    cache->prep = GEOSPrepare(cache->geos);
+  }
+  return cache->prep;
+}
+
 /**
  * @brief Transform the GSERIALIZED geometries into GEOSGeometry and
  * call the GEOS function passed as argument
@@ -819,6 +901,42 @@ meos_call_geos2(const GSERIALIZED *gs1, const GSERIALIZED *gs2,
   return result;
 }
 
+/**
+ * @brief Call a GEOS binary predicate with the prepared version of the
+ * first geometry when it is used repeatedly
+ * @note The non-prepared fallback calls @p func with @p gsrepeat as first
+ * argument, hence @p gsrepeat must be the first argument of the predicate
+ * or the predicate must be symmetric
+ */
+static char
+meos_call_geos2_prep(const GSERIALIZED *gsrepeat, const GSERIALIZED *gsother,
+  char (*prepfunc)(const GEOSPreparedGeometry *prep, const GEOSGeometry *geos),
+  char (*func)(const GEOSGeometry *geos1, const GEOSGeometry *geos2))
+{
+  initGEOS(lwnotice, lwgeom_geos_error);
+
+  const GEOSPreparedGeometry *prep = geos_prepared_lookup(gsrepeat);
+  if (! prep)
+    return meos_call_geos2(gsrepeat, gsother, func);
+
+  GEOSGeometry *other = POSTGIS2GEOS(gsother);
+  if (! other)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "Second argument geometry could not be converted to GEOS");
+    return 2;
+  }
+
+  char result = prepfunc(prep, other);
+  GEOSGeom_destroy(other);
+
+  if (result == 2)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "GEOS returned error");
+
+  return result;
+}
+
 /**
  * @brief Return true if the geometries intersect or the first contains
  * the other, where the function called depend on the third argument
@@ -868,9 +986,13 @@ gserialized_spatialrel(const GSERIALIZED *gs1, const GSERIALIZED *gs2,
   switch (rel)
   {
     case INTERSECTS:
-      return (bool) meos_call_geos2(gs1, gs2, &GEOSIntersects);
+      /* The temporal call sites pass the repeated geometry, e.g., a
+       * geofence, as second argument and Intersects is symmetric */
+      return (bool) meos_call_geos2_prep(gs2, gs1, &GEOSPreparedIntersects,
+        &GEOSIntersects);
     case CONTAINS:
-      return (bool) meos_call_geos2(gs1, gs2, &GEOSContains);
+      return (bool) meos_call_geos2_prep(gs1, gs2, &GEOSPreparedContains,
+        &GEOSContains);
     case TOUCHES:
       return (bool) meos_call_geos2(gs1, gs2, &GEOSTouches);
     default:
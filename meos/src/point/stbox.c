@@ -1685,6 +1685,39 @@ union_stbox_stbox(const STBox *box1, const STBox *box2, bool strict)
   return result;
 }
 
+/**
+ * @ingroup libmeos_box_set
+ * @brief Set a caller-provided box with the union of two spatiotemporal
+ * boxes.
+ * @return Return false if the union of the boxes cannot be computed
+ * @note This function is equivalent to @ref union_stbox_stbox without memory
+ * allocation
+ */
+bool
+union_stbox_stbox_buf(const STBox *box1, const STBox *box2, bool strict,
+  STBox *result)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) box1) || ! ensure_not_null((void *) box2) ||
+      ! ensure_not_null((void *) result) ||
+      ! ensure_same_geodetic(box1->flags, box2->flags) ||
+      ! ensure_same_dimensionality(box1->flags, box2->flags) ||
+      ! ensure_same_srid_stbox(box1, box2))
+    return false;
+  /* If the strict parameter is true, we need to ensure that the boxes
+   * intersect, otherwise their union cannot be represented by a box */
+  if (strict && ! overlaps_stbox_stbox(box1, box2))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Result of box union would not be contiguous");
+    return false;
+  }
+
+  memcpy(result, box1, sizeof(STBox));
+  stbox_expand(box2, result);
+  return true;
+}
+
 /**
  * @ingroup libmeos_internal_box_set
  * @brief Set a spatiotemporal box with the result of the intersection of the
@@ -1762,6 +1795,28 @@ intersection_stbox_stbox(const STBox *box1, const STBox *box2)
   return result;
 }
 
+/**
+ * @ingroup libmeos_box_set
+ * @brief Set a caller-provided box with the intersection of two
+ * spatiotemporal boxes.
+ * @return Return false if the boxes do not intersect
+ * @note This function is equivalent to @ref intersection_stbox_stbox without
+ * memory allocation
+ */
+bool
+intersection_stbox_stbox_buf(const STBox *box1, const STBox *box2,
+  STBox *result)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) box1) || ! ensure_not_null((void *) box2) ||
+      ! ensure_not_null((void *) result) ||
+      ! ensure_same_geodetic(box1->flags, box2->flags) ||
+      ! ensure_same_srid_stbox(box1, box2))
+    return false;
+
+  return inter_stbox_stbox(box1, box2, result);
+}
+
 /*****************************************************************************
  * Split functions
  *****************************************************************************/
@@ -88,6 +88,24 @@ tpoint_to_stbox(const Temporal *temp)
   return result;
 }
 
+/**
+ * @ingroup libmeos_box_conversion
+ * @brief Set a caller-provided box with the bounding box of a temporal point
+ * @note This function is equivalent to @ref tpoint_to_stbox without memory
+ * allocation
+ */
+bool
+tpoint_to_stbox_buf(const Temporal *temp, STBox *result)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) result) ||
+      ! ensure_tspatial_type(temp->temptype))
+    return false;
+
+  temporal_set_bbox(temp, result);
+  return true;
+}
+
 /*****************************************************************************
  * Transformation functions
  *****************************************************************************/
@@ -369,11 +369,11 @@ tpointseq_tcentroid_finalfn(TSequence **sequences, int count, int srid)
 
 /**
  * @ingroup libmeos_temporal_agg
- * @brief Final function for temporal centroid aggregation of temporal point
- * values
+ * @brief Read the current value of a temporal centroid aggregation without
+ * modifying the state
  */
 Temporal *
-tpoint_tcentroid_finalfn(SkipList *state)
+tpoint_tcentroid_readfn(SkipList *state)
 {
   if (state == NULL || state->length == 0)
     return NULL;
@@ -389,7 +389,19 @@ tpoint_tcentroid_finalfn(SkipList *state)
     result = (Temporal *) tpointseq_tcentroid_finalfn((TSequence **) values,
       state->length, srid);
   pfree(values);
-  skiplist_free(state);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Final function for temporal centroid aggregation of temporal points
+ */
+Temporal *
+tpoint_tcentroid_finalfn(SkipList *state)
+{
+  Temporal *result = tpoint_tcentroid_readfn(state);
+  if (result)
+    skiplist_free(state);
   return result;
 }
 
@@ -54,6 +54,7 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/temporaltypes.h"
+#include "general/temporal_tile.h"
 #include "point/tpoint.h"
 #include "point/tpoint_spatialfuncs.h"
 
@@ -148,6 +149,156 @@ tpointseqarr_set_stbox(const TSequence **sequences, int count, STBox *box)
   return;
 }
 
+/*****************************************************************************
+ * Geocentric bounding boxes for indexing temporal geography points
+ *
+ * The regular bounding box of a temporal geography point stores raw
+ * longitude/latitude extents and thus may blow up to cover (almost) the whole
+ * planet when the point crosses the ±180° meridian or approaches a pole.
+ * The functions below compute instead a bounding box of the point on the
+ * unit sphere in geocentric XYZ coordinates, where great-circle arcs have no
+ * discontinuity, as done by PostGIS for its GIDX geography keys. Such a box
+ * is the axis-aligned footprint of a spherical cap/patch and supports the
+ * same min/max union and intersection arithmetic as a regular `STBox`, which
+ * allows the GiST machinery for spatiotemporal boxes to be reused unchanged.
+ *****************************************************************************/
+
+/**
+ * @brief Transform a temporal geography point instant into a unit-sphere
+ * geocentric point
+ * @note The altitude of 3D points is ignored, the resulting box is lossy and
+ * index lookups using it must recheck
+ */
+static void
+tpointinst_geocentric(const TInstant *inst, POINT3D *p)
+{
+  GSERIALIZED *point = DatumGetGserializedP(tinstant_value(inst));
+  double x, y, z;
+  point_get_coords(point, false, &x, &y, &z);
+  POINT2D g;
+  g.x = x;
+  g.y = y;
+  ll2cart(&g, p);
+  return;
+}
+
+/**
+ * @brief Expand a geocentric spatiotemporal box with a unit-sphere point
+ */
+static void
+geocentric_stbox_expand(const POINT3D *p, STBox *box)
+{
+  box->xmin = Min(box->xmin, p->x);
+  box->xmax = Max(box->xmax, p->x);
+  box->ymin = Min(box->ymin, p->y);
+  box->ymax = Max(box->ymax, p->y);
+  box->zmin = Min(box->zmin, p->z);
+  box->zmax = Max(box->zmax, p->z);
+  return;
+}
+
+/**
+ * @ingroup libmeos_internal_temporal_spatial_accessor
+ * @brief Set the geocentric (unit-sphere) spatiotemporal box of a temporal
+ * geography point
+ * @param[in] temp Temporal value
+ * @param[out] box Spatiotemporal box where the *x*, *y*, and *z* coordinates
+ * are geocentric coordinates on the unit sphere
+ * @note For linear interpolation the box of every segment is computed from
+ * the great-circle arc, not only from its end points, since the arc may
+ * leave the box of the latter
+ */
+void
+tpoint_set_geocentric_stbox(const Temporal *temp, STBox *box)
+{
+  assert(temp); assert(box);
+  assert(tgeo_type(temp->temptype));
+  assert(MEOS_FLAGS_GET_GEODETIC(temp->flags));
+  /* Take the period, SRID, and flags from the regular bounding box */
+  temporal_set_bbox(temp, box);
+  int count;
+  const TInstant **instants = temporal_instants(temp, &count);
+  POINT3D p1, p2;
+  tpointinst_geocentric(instants[0], &p1);
+  box->xmin = box->xmax = p1.x;
+  box->ymin = box->ymax = p1.y;
+  box->zmin = box->zmax = p1.z;
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(temp->flags);
+  for (int i = 1; i < count; i++)
+  {
+    tpointinst_geocentric(instants[i], &p2);
+    if (linear)
+    {
+      GBOX gbox;
+      edge_calculate_gbox(&p1, &p2, &gbox);
+      box->xmin = Min(box->xmin, gbox.xmin);
+      box->xmax = Max(box->xmax, gbox.xmax);
+      box->ymin = Min(box->ymin, gbox.ymin);
+      box->ymax = Max(box->ymax, gbox.ymax);
+      box->zmin = Min(box->zmin, gbox.zmin);
+      box->zmax = Max(box->zmax, gbox.zmax);
+    }
+    else
+      geocentric_stbox_expand(&p2, box);
+    p1 = p2;
+  }
+  pfree(instants);
+  MEOS_FLAGS_SET_X(box->flags, true);
+  MEOS_FLAGS_SET_Z(box->flags, true);
+  return;
+}
+
+/**
+ * @ingroup libmeos_internal_box_conversion
+ * @brief Set a geocentric (unit-sphere) spatiotemporal box covering a
+ * spatiotemporal box given in longitude/latitude coordinates
+ * @param[in] box Spatiotemporal box
+ * @param[out] result Spatiotemporal box where the *x*, *y*, and *z*
+ * coordinates are geocentric coordinates on the unit sphere
+ * @note The extrema of the geocentric coordinates over a longitude/latitude
+ * rectangle are reached either at its corners or where a cardinal meridian
+ * or the equator crosses the rectangle, hence evaluating all candidate
+ * longitude/latitude pairs yields the exact covering box
+ */
+void
+stbox_set_geocentric(const STBox *box, STBox *result)
+{
+  assert(box); assert(result);
+  memcpy(result, box, sizeof(STBox));
+  if (! MEOS_FLAGS_GET_X(box->flags))
+    return;
+  double lats[3], lons[7];
+  int nlats = 0, nlons = 0;
+  lats[nlats++] = box->ymin;
+  lats[nlats++] = box->ymax;
+  if (box->ymin < 0.0 && 0.0 < box->ymax)
+    lats[nlats++] = 0.0;
+  lons[nlons++] = box->xmin;
+  lons[nlons++] = box->xmax;
+  for (double meridian = -180.0; meridian <= 180.0; meridian += 90.0)
+    if (box->xmin < meridian && meridian < box->xmax)
+      lons[nlons++] = meridian;
+  for (int i = 0; i < nlats; i++)
+    for (int j = 0; j < nlons; j++)
+    {
+      POINT2D g;
+      POINT3D p;
+      g.x = lons[j];
+      g.y = lats[i];
+      ll2cart(&g, &p);
+      if (i == 0 && j == 0)
+      {
+        result->xmin = result->xmax = p.x;
+        result->ymin = result->ymax = p.y;
+        result->zmin = result->zmax = p.z;
+      }
+      else
+        geocentric_stbox_expand(&p, result);
+    }
+  MEOS_FLAGS_SET_Z(result->flags, true);
+  return;
+}
+
 /*****************************************************************************
  * Boxes functions
  * These functions can be used for defining MultiEntry (a.k.a.) VODKA indexes
@@ -260,4 +411,180 @@ tpoint_stboxes(const Temporal *temp, int *count)
   return result;
 }
 
+/*****************************************************************************
+ * Moving window extent
+ *****************************************************************************/
+
+/**
+ * @brief Monotonic deque retaining the indices of the candidate extrema of
+ * a sliding window, increasing in both index and rank
+ */
+typedef struct
+{
+  int *idx;               /**< Indices of the candidate extrema */
+  int front;              /**< First valid position */
+  int back;               /**< One past the last valid position */
+} MovingDeque;
+
+/**
+ * @brief Push an instant on a monotonic deque, discarding the candidates
+ * it dominates
+ */
+static void
+moving_deque_push(MovingDeque *dq, const double *values, int i, bool ismax)
+{
+  while (dq->back > dq->front && (ismax ?
+      values[dq->idx[dq->back - 1]] <= values[i] :
+      values[dq->idx[dq->back - 1]] >= values[i]))
+    dq->back--;
+  dq->idx[dq->back++] = i;
+  return;
+}
+
+/**
+ * @brief Return the extreme value of the window starting at instant lo,
+ * expiring the candidates that have left the window
+ */
+static double
+moving_deque_extreme(MovingDeque *dq, const double *values, int lo)
+{
+  while (dq->idx[dq->front] < lo)
+    dq->front++;
+  return values[dq->idx[dq->front]];
+}
+
+/**
+ * @brief Return the moving window extent of a temporal sequence point
+ * (iterator function)
+ * @param[in] seq Temporal value
+ * @param[in] wunits Duration of the window in PostgreSQL time units
+ * @param[out] result Array of spatiotemporal boxes, one per instant
+ *
+ * Each instant is pushed once on and popped at most once from the monotonic
+ * deque of every coordinate extreme, so the whole sweep is O(n) regardless
+ * of the window size.
+ */
+static void
+tpointseq_moving_extent_iter(const TSequence *seq, int64 wunits,
+  STBox *result)
+{
+  int count = seq->count;
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  int32 srid = tpoint_srid((const Temporal *) seq);
+
+  /* Extract the coordinates and timestamps to contiguous arrays */
+  double *x = palloc(sizeof(double) * count);
+  double *y = palloc(sizeof(double) * count);
+  double *z = hasz ? palloc(sizeof(double) * count) : NULL;
+  TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+  tpointseq_extract_coords(seq, x, y, z, times);
+
+  /* One minimum and one maximum deque per coordinate */
+  int ndq = hasz ? 6 : 4;
+  const double *coords[6] = { x, x, y, y, z, z };
+  MovingDeque dq[6];
+  int *storage = palloc(sizeof(int) * count * ndq);
+  for (int d = 0; d < ndq; d++)
+  {
+    dq[d].idx = storage + (size_t) d * count;
+    dq[d].front = dq[d].back = 0;
+  }
+
+  int lo = 0;
+  for (int i = 0; i < count; i++)
+  {
+    /* Advance the window start; lo never passes i since the window always
+     * contains the instant it ends at */
+    while (times[lo] <= times[i] - wunits)
+      lo++;
+    for (int d = 0; d < ndq; d++)
+      moving_deque_push(&dq[d], coords[d], i, d % 2 == 0);
+    double zmin = 0, zmax = 0;
+    double xmax = moving_deque_extreme(&dq[0], x, lo);
+    double xmin = moving_deque_extreme(&dq[1], x, lo);
+    double ymax = moving_deque_extreme(&dq[2], y, lo);
+    double ymin = moving_deque_extreme(&dq[3], y, lo);
+    if (hasz)
+    {
+      zmax = moving_deque_extreme(&dq[4], z, lo);
+      zmin = moving_deque_extreme(&dq[5], z, lo);
+    }
+    Span p;
+    span_set(TimestampTzGetDatum(times[lo]), TimestampTzGetDatum(times[i]),
+      true, true, T_TIMESTAMPTZ, &p);
+    stbox_set(true, hasz, false, srid, xmin, xmax, ymin, ymax, zmin, zmax,
+      &p, &result[i]);
+  }
+  pfree(storage);
+  pfree(x); pfree(y); pfree(times);
+  if (z)
+    pfree(z);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_spatial_accessor
+ * @brief Return the moving window extent of a temporal point, that is, for
+ * every instant the spatiotemporal box of the instants observed during the
+ * window of the given duration ending at it
+ * @param[in] temp Temporal value
+ * @param[in] duration Duration of the window
+ * @param[out] count Number of elements in the output array
+ * @return Array of spatiotemporal boxes, one per instant of the temporal
+ * point; on error return @p NULL
+ * @note The extent covers the observed instants: for linear interpolation
+ * the segment entering the window is accounted from its first instant
+ * inside it. For a sequence set the window does not extend across the gaps
+ * between the sequences.
+ */
+STBox *
+tpoint_moving_extent(const Temporal *temp, const Interval *duration,
+  int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_not_null((void *) duration) ||
+      ! ensure_not_null((void *) count) ||
+      ! ensure_tgeo_type(temp->temptype) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+  if (MEOS_FLAGS_GET_GEODETIC(temp->flags))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The moving extent is not supported for geographies");
+    return NULL;
+  }
+
+  int64 wunits = interval_units(duration);
+  STBox *result;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+  {
+    result = palloc(sizeof(STBox));
+    tpointinst_set_stbox((const TInstant *) temp, result);
+    *count = 1;
+  }
+  else if (temp->subtype == TSEQUENCE)
+  {
+    const TSequence *seq = (const TSequence *) temp;
+    result = palloc(sizeof(STBox) * seq->count);
+    tpointseq_moving_extent_iter(seq, wunits, result);
+    *count = seq->count;
+  }
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    result = palloc(sizeof(STBox) * ss->totalcount);
+    int nboxes = 0;
+    for (int i = 0; i < ss->count; i++)
+    {
+      const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+      tpointseq_moving_extent_iter(seq, wunits, &result[nboxes]);
+      nboxes += seq->count;
+    }
+    *count = nboxes;
+  }
+  return result;
+}
+
 /*****************************************************************************/
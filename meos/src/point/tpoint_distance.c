@@ -50,6 +50,7 @@
 #include "general/lifting.h"
 #include "general/temporaltypes.h"
 #include "general/type_util.h"
+#include "point/lwgeom_inline.h"
 #include "point/pgis_call.h"
 #include "point/geography_funcs.h"
 #include "point/tpoint.h"
@@ -463,6 +464,118 @@ distance_tpoint_point(const Temporal *temp, const GSERIALIZED *gs)
   return result;
 }
 
+/*****************************************************************************
+ * Batch distance kernel for synchronized sequences
+ *****************************************************************************/
+
+/**
+ * @brief Compute the Euclidean distances between two runs of synchronized
+ * instants in a single pass (batch kernel)
+ * @note The loop runs over contiguous coordinate arrays so that the compiler
+ * can vectorize it, instead of one Datum call per instant pair
+ */
+static void
+tpoint_distance_batch(const double *restrict x1, const double *restrict y1,
+  const double *restrict z1, const double *restrict x2,
+  const double *restrict y2, const double *restrict z2, int count,
+  double *restrict dist)
+{
+  if (z1)
+    for (int i = 0; i < count; i++)
+      dist[i] = sqrt((x1[i] - x2[i]) * (x1[i] - x2[i]) +
+        (y1[i] - y2[i]) * (y1[i] - y2[i]) +
+        (z1[i] - z2[i]) * (z1[i] - z2[i]));
+  else
+    for (int i = 0; i < count; i++)
+      dist[i] = sqrt((x1[i] - x2[i]) * (x1[i] - x2[i]) +
+        (y1[i] - y2[i]) * (y1[i] - y2[i]));
+  return;
+}
+
+/**
+ * @brief Return true if the two temporal point sequences are synchronized,
+ * that is, they have instants at exactly the same timestamps
+ */
+static bool
+tpointseq_synchronized(const TSequence *seq1, const TSequence *seq2)
+{
+  if (seq1->count != seq2->count)
+    return false;
+  for (int i = 0; i < seq1->count; i++)
+    if (TSEQUENCE_INST_N(seq1, i)->t != TSEQUENCE_INST_N(seq2, i)->t)
+      return false;
+  return true;
+}
+
+/**
+ * @brief Return the temporal distance between two synchronized temporal
+ * point sequences (fast path)
+ *
+ * The coordinates of both sequences are gathered into contiguous arrays and
+ * the distances at the shared timestamps are computed with the batch kernel.
+ * For linear interpolation the turning points, where the distance function
+ * reaches a local minimum inside a segment, are added as in
+ * @ref tpoint_min_dist_at_timestamp.
+ * @pre The sequences are synchronized, have planar coordinates, and have
+ * the same dimensionality
+ */
+static TSequence *
+distance_tpointseq_tpointseq_sync(const TSequence *seq1, const TSequence *seq2)
+{
+  int count = seq1->count;
+  bool hasz = MEOS_FLAGS_GET_Z(seq1->flags);
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq1->flags) ||
+    MEOS_FLAGS_LINEAR_INTERP(seq2->flags);
+  int ncoords = hasz ? 3 : 2;
+  double *x1 = palloc(sizeof(double) * count * (2 * ncoords + 1));
+  double *y1 = &x1[count], *z1 = hasz ? &x1[count * 2] : NULL;
+  double *x2 = &x1[count * ncoords], *y2 = &x2[count],
+    *z2 = hasz ? &x2[count * 2] : NULL;
+  double *dist = &x1[count * 2 * ncoords];
+  tpointseq_extract_coords(seq1, x1, y1, z1, NULL);
+  tpointseq_extract_coords(seq2, x2, y2, z2, NULL);
+  tpoint_distance_batch(x1, y1, z1, x2, y2, z2, count, dist);
+
+  /* Each segment may contribute at most one additional turning point */
+  TInstant **instants = palloc(sizeof(TInstant *) * count * 2);
+  int ninsts = 0;
+  for (int i = 0; i < count; i++)
+  {
+    TimestampTz t = TSEQUENCE_INST_N(seq1, i)->t;
+    instants[ninsts++] = tinstant_make(Float8GetDatum(dist[i]), T_TFLOAT, t);
+    if (linear && i < count - 1)
+    {
+      /* Relative position dP and relative velocity dV of the two points;
+       * the squared distance |dP + s dV|^2 is minimal at
+       * s = - dP . dV / |dV|^2 */
+      double dpx = x2[i] - x1[i], dpy = y2[i] - y1[i],
+        dpz = hasz ? z2[i] - z1[i] : 0;
+      double dvx = (x2[i + 1] - x1[i + 1]) - dpx,
+        dvy = (y2[i + 1] - y1[i + 1]) - dpy,
+        dvz = hasz ? (z2[i + 1] - z1[i + 1]) - dpz : 0;
+      double dv2 = dvx * dvx + dvy * dvy + dvz * dvz;
+      if (dv2 != 0)
+      {
+        double s = - (dpx * dvx + dpy * dvy + dpz * dvz) / dv2;
+        if (s > MEOS_EPSILON && s < 1.0 - MEOS_EPSILON)
+        {
+          double mindist = sqrt((dpx + s * dvx) * (dpx + s * dvx) +
+            (dpy + s * dvy) * (dpy + s * dvy) +
+            (dpz + s * dvz) * (dpz + s * dvz));
+          TimestampTz t1 = TSEQUENCE_INST_N(seq1, i + 1)->t;
+          TimestampTz tmin = t + (TimestampTz) ((double) (t1 - t) * s);
+          instants[ninsts++] = tinstant_make(Float8GetDatum(mindist),
+            T_TFLOAT, tmin);
+        }
+      }
+    }
+  }
+  pfree(x1);
+  interpType interp = linear ? LINEAR : MEOS_FLAGS_GET_INTERP(seq1->flags);
+  return tsequence_make_free(instants, ninsts, seq1->period.lower_inc,
+    seq1->period.upper_inc, interp, NORMALIZE);
+}
+
 /**
  * @ingroup libmeos_temporal_dist
  * @brief Return the temporal distance between two temporal points.
@@ -476,6 +589,14 @@ distance_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
       ! ensure_same_dimensionality(temp1->flags, temp2->flags))
     return NULL;
 
+  /* Fast path for synchronized planar sequences: compute the distances with
+   * the batch kernel and bypass the lifting machinery */
+  if (temp1->subtype == TSEQUENCE && temp2->subtype == TSEQUENCE &&
+      ! MEOS_FLAGS_GET_GEODETIC(temp1->flags) &&
+      tpointseq_synchronized((TSequence *) temp1, (TSequence *) temp2))
+    return (Temporal *) distance_tpointseq_tpointseq_sync(
+      (TSequence *) temp1, (TSequence *) temp2);
+
   LiftedFunctionInfo lfinfo;
   memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
   lfinfo.func = (varfunc) pt_distance_fn(temp1->flags);
@@ -741,6 +862,144 @@ nai_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
   return result;
 }
 
+/**
+ * @brief Candidate segment pair for the branch-and-bound search of the
+ * nearest approach instant, with a lower bound on the distance between the
+ * two sequences during the segment
+ */
+typedef struct
+{
+  double bound;    /**< Distance between the bounding boxes of the segments */
+  int i;           /**< Index of the segment in both sequences */
+} NAISegmentPair;
+
+/**
+ * @brief Comparator function for sorting the candidate segment pairs on
+ * increasing lower bound
+ */
+static int
+nai_segment_pair_cmp(const void *a, const void *b)
+{
+  double bound1 = ((const NAISegmentPair *) a)->bound;
+  double bound2 = ((const NAISegmentPair *) b)->bound;
+  if (bound1 < bound2)
+    return -1;
+  if (bound1 > bound2)
+    return 1;
+  return 0;
+}
+
+/**
+ * @brief Return the nearest approach instant between two synchronized
+ * temporal point sequences with linear interpolation (branch and bound)
+ *
+ * Instead of evaluating the distance on every segment pair, the pairs are
+ * visited in increasing order of the distance between their bounding boxes,
+ * which is a lower bound on the distance during the segment. The search
+ * stops as soon as the bound of the next candidate exceeds the minimum
+ * distance found so far, which typically happens after a few segment pairs.
+ * @pre The sequences are synchronized, have planar coordinates, the same
+ * dimensionality, linear interpolation, and more than one instant
+ */
+static TInstant *
+nai_tpointseq_tpointseq_sync(const TSequence *seq1, const TSequence *seq2)
+{
+  int count = seq1->count;
+  bool hasz = MEOS_FLAGS_GET_Z(seq1->flags);
+  int ncoords = hasz ? 3 : 2;
+  double *x1 = palloc(sizeof(double) * count * 2 * ncoords);
+  double *y1 = &x1[count], *z1 = hasz ? &x1[count * 2] : NULL;
+  double *x2 = &x1[count * ncoords], *y2 = &x2[count],
+    *z2 = hasz ? &x2[count * 2] : NULL;
+  tpointseq_extract_coords(seq1, x1, y1, z1, NULL);
+  tpointseq_extract_coords(seq2, x2, y2, z2, NULL);
+
+  /* Compute the lower bound of every segment pair as the distance between
+   * the bounding boxes of the two segments */
+  NAISegmentPair *pairs = palloc(sizeof(NAISegmentPair) * (count - 1));
+  for (int i = 0; i < count - 1; i++)
+  {
+    double gap, bound2 = 0;
+    gap = Max(Min(x1[i], x1[i + 1]) - Max(x2[i], x2[i + 1]),
+      Min(x2[i], x2[i + 1]) - Max(x1[i], x1[i + 1]));
+    if (gap > 0)
+      bound2 += gap * gap;
+    gap = Max(Min(y1[i], y1[i + 1]) - Max(y2[i], y2[i + 1]),
+      Min(y2[i], y2[i + 1]) - Max(y1[i], y1[i + 1]));
+    if (gap > 0)
+      bound2 += gap * gap;
+    if (hasz)
+    {
+      gap = Max(Min(z1[i], z1[i + 1]) - Max(z2[i], z2[i + 1]),
+        Min(z2[i], z2[i + 1]) - Max(z1[i], z1[i + 1]));
+      if (gap > 0)
+        bound2 += gap * gap;
+    }
+    pairs[i].bound = sqrt(bound2);
+    pairs[i].i = i;
+  }
+  qsort(pairs, count - 1, sizeof(NAISegmentPair), &nai_segment_pair_cmp);
+
+  /* Evaluate the candidates in increasing bound order with pruning */
+  double mindist = DBL_MAX;
+  TimestampTz tmin = TSEQUENCE_INST_N(seq1, 0)->t;
+  for (int k = 0; k < count - 1; k++)
+  {
+    if (pairs[k].bound >= mindist)
+      break;
+    int i = pairs[k].i;
+    /* Relative position dP and relative velocity dV of the two points;
+     * the squared distance |dP + s dV|^2 is minimal at
+     * s = - dP . dV / |dV|^2 */
+    double dpx = x2[i] - x1[i], dpy = y2[i] - y1[i],
+      dpz = hasz ? z2[i] - z1[i] : 0;
+    double dvx = (x2[i + 1] - x1[i + 1]) - dpx,
+      dvy = (y2[i + 1] - y1[i + 1]) - dpy,
+      dvz = hasz ? (z2[i + 1] - z1[i + 1]) - dpz : 0;
+    double dist = sqrt(dpx * dpx + dpy * dpy + dpz * dpz);
+    if (dist < mindist)
+    {
+      mindist = dist;
+      tmin = TSEQUENCE_INST_N(seq1, i)->t;
+    }
+    double d1x = dpx + dvx, d1y = dpy + dvy, d1z = dpz + dvz;
+    dist = sqrt(d1x * d1x + d1y * d1y + d1z * d1z);
+    if (dist < mindist)
+    {
+      mindist = dist;
+      tmin = TSEQUENCE_INST_N(seq1, i + 1)->t;
+    }
+    double dv2 = dvx * dvx + dvy * dvy + dvz * dvz;
+    if (dv2 != 0)
+    {
+      double s = - (dpx * dvx + dpy * dvy + dpz * dvz) / dv2;
+      if (s > 0.0 && s < 1.0)
+      {
+        dist = sqrt((dpx + s * dvx) * (dpx + s * dvx) +
+          (dpy + s * dvy) * (dpy + s * dvy) +
+          (dpz + s * dvz) * (dpz + s * dvz));
+        if (dist < mindist)
+        {
+          mindist = dist;
+          TimestampTz t = TSEQUENCE_INST_N(seq1, i)->t;
+          TimestampTz t1 = TSEQUENCE_INST_N(seq1, i + 1)->t;
+          tmin = t + (TimestampTz) ((double) (t1 - t) * s);
+        }
+      }
+    }
+    if (mindist == 0.0)
+      break;
+  }
+  pfree(x1); pfree(pairs);
+
+  /* The closest point may be at an exclusive bound => 3rd argument = false */
+  Datum value;
+  tsequence_value_at_timestamp(seq1, tmin, false, &value);
+  TInstant *result = tinstant_make(value, seq1->temptype, tmin);
+  pfree(DatumGetPointer(value));
+  return result;
+}
+
 /**
  * @ingroup libmeos_temporal_dist
  * @brief Return the nearest approach instant between the temporal points.
@@ -754,6 +1013,18 @@ nai_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
       ! ensure_same_dimensionality(temp1->flags, temp2->flags))
     return NULL;
 
+  /* Branch-and-bound fast path for synchronized planar sequences with
+   * linear interpolation, which avoids materializing the full temporal
+   * distance when the minimum is found after a few segment pairs */
+  if (temp1->subtype == TSEQUENCE && temp2->subtype == TSEQUENCE &&
+      ! MEOS_FLAGS_GET_GEODETIC(temp1->flags) &&
+      MEOS_FLAGS_LINEAR_INTERP(temp1->flags) &&
+      MEOS_FLAGS_LINEAR_INTERP(temp2->flags) &&
+      ((TSequence *) temp1)->count > 1 &&
+      tpointseq_synchronized((TSequence *) temp1, (TSequence *) temp2))
+    return nai_tpointseq_tpointseq_sync((TSequence *) temp1,
+      (TSequence *) temp2);
+
   TInstant *result = NULL;
   Temporal *dist = distance_tpoint_tpoint(temp1, temp2);
   if (dist != NULL)
@@ -0,0 +1,503 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Spatiotemporal join of two collections of temporal points.
+ *
+ * Encounter detection between two trip collections amounts to a
+ * spatiotemporal join: find the pairs of trips that are ever within a given
+ * distance of each other. Driving the pairwise predicates from application
+ * code evaluates all N x M pairs, although trips that are never in the same
+ * region at the same time can be dismissed without looking at a single
+ * instant.
+ *
+ * The join buckets both collections over a space-time grid in the style of
+ * the multidimensional grids of tpoint_tile.c: every segment of a trip is
+ * assigned to the grid cells overlapped by its bounding box, so only trips
+ * that share a cell, enlarged by the query distance on the probe side, meet
+ * the exact predicate. The exact evaluations are independent of each other
+ * and run on the internal thread pool.
+ */
+
+/* C */
+#include <assert.h>
+#include <math.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/pool.h"
+#include "general/temporaltypes.h"
+#include "general/temporal_tile.h"
+#include "point/tpoint_spatialfuncs.h"
+
+#if MEOS
+
+/*****************************************************************************/
+
+/** Maximum number of cells of the join grid */
+#define MEOS_JOIN_MAX_CELLS (1 << 22)
+
+/**
+ * Structure to represent the space-time grid of a join. The cells cover the
+ * union of the bounding boxes of the two collections; the Z dimension, if
+ * any, is not partitioned, the exact predicate decides for it.
+ */
+typedef struct
+{
+  double xmin;       /**< Minimum x value of the grid */
+  double ymin;       /**< Minimum y value of the grid */
+  double xsize;      /**< Size of a cell in the x dimension */
+  double ysize;      /**< Size of a cell in the y dimension */
+  TimestampTz tmin;  /**< Start of the grid in the time dimension */
+  int64 tunits;      /**< Size of a cell in the time dimension, 0 when the
+                          time dimension is not partitioned */
+  int nx;            /**< Number of cells in the x dimension */
+  int ny;            /**< Number of cells in the y dimension */
+  int nt;            /**< Number of cells in the time dimension */
+  int64 ncells;      /**< Total number of cells */
+} JoinGrid;
+
+/**
+ * Growable array of the cells overlapped by one temporal point
+ */
+typedef struct
+{
+  int *cells;        /**< Array of cell numbers */
+  int count;         /**< Number of cells in the array */
+  int size;          /**< Allocated size of the array */
+} JoinCells;
+
+/**
+ * Structure shared by the tasks probing the grid, one per temporal point of
+ * the first collection. Each task writes only its own slot of the result
+ * arrays, so the tasks need no synchronization.
+ */
+typedef struct
+{
+  const Temporal **temparr1; /**< First collection */
+  const Temporal **temparr2; /**< Second collection */
+  int count2;                /**< Number of elements of the second collection */
+  double dist;               /**< Query distance */
+  const JoinGrid *grid;      /**< Join grid */
+  int rx;                    /**< Query distance in cells in the x dimension */
+  int ry;                    /**< Query distance in cells in the y dimension */
+  const int *bucketstart;    /**< Start of each cell bucket, one per cell */
+  const int *bucketitems;    /**< Elements of the cell buckets */
+  Match **results;           /**< Matches found by each task */
+  int *nresults;             /**< Number of matches found by each task */
+} JoinProbeState;
+
+/*****************************************************************************
+ * Assignment of temporal points to grid cells
+ *****************************************************************************/
+
+/**
+ * @brief Return the cell coordinate of a value in one grid dimension,
+ * clamped to the grid
+ */
+static inline int
+join_grid_coord(double v, double min, double size, int n)
+{
+  int c = (int) ((v - min) / size);
+  return Min(Max(c, 0), n - 1);
+}
+
+/**
+ * @brief Append a cell to the cell array of a temporal point unless the
+ * stamp records that it is already there
+ */
+static void
+join_cells_add(JoinCells *jc, uint32 *stamp, uint32 stampval, int cell)
+{
+  if (stamp[cell] == stampval)
+    return;
+  stamp[cell] = stampval;
+  if (jc->count == jc->size)
+  {
+    jc->size = jc->size ? jc->size * 2 : 64;
+    jc->cells = jc->cells ?
+      repalloc(jc->cells, sizeof(int) * jc->size) :
+      palloc(sizeof(int) * jc->size);
+  }
+  jc->cells[jc->count++] = cell;
+  return;
+}
+
+/**
+ * @brief Add the cells overlapped by the bounding box of one segment,
+ * enlarged by the given number of cells in the spatial dimensions
+ */
+static void
+join_cells_add_range(const JoinGrid *grid, const POINT2D *p1,
+  const POINT2D *p2, TimestampTz t1, TimestampTz t2, int rx, int ry,
+  uint32 *stamp, uint32 stampval, JoinCells *jc)
+{
+  int cx0 = join_grid_coord(Min(p1->x, p2->x), grid->xmin, grid->xsize,
+    grid->nx);
+  int cx1 = join_grid_coord(Max(p1->x, p2->x), grid->xmin, grid->xsize,
+    grid->nx);
+  int cy0 = join_grid_coord(Min(p1->y, p2->y), grid->ymin, grid->ysize,
+    grid->ny);
+  int cy1 = join_grid_coord(Max(p1->y, p2->y), grid->ymin, grid->ysize,
+    grid->ny);
+  cx0 = Max(cx0 - rx, 0);
+  cx1 = Min(cx1 + rx, grid->nx - 1);
+  cy0 = Max(cy0 - ry, 0);
+  cy1 = Min(cy1 + ry, grid->ny - 1);
+  int ct0 = 0, ct1 = 0;
+  if (grid->tunits)
+  {
+    ct0 = (int) Min(Max((t1 - grid->tmin) / grid->tunits, 0), grid->nt - 1);
+    ct1 = (int) Min(Max((t2 - grid->tmin) / grid->tunits, 0), grid->nt - 1);
+  }
+  for (int ct = ct0; ct <= ct1; ct++)
+    for (int cy = cy0; cy <= cy1; cy++)
+      for (int cx = cx0; cx <= cx1; cx++)
+        join_cells_add(jc, stamp, stampval,
+          (ct * grid->ny + cy) * grid->nx + cx);
+  return;
+}
+
+/**
+ * @brief Add the cells overlapped by the segments of a temporal point
+ * sequence.
+ *
+ * The bounding box of a segment covers the step and discrete
+ * interpolations as well, so the assignment always yields a superset of the
+ * traversed cells and never loses a candidate pair.
+ */
+static void
+tpointseq_join_cells(const TSequence *seq, const JoinGrid *grid, int rx,
+  int ry, uint32 *stamp, uint32 stampval, JoinCells *jc)
+{
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  const POINT2D *p1 = DATUM_POINT2D_P(tinstant_value(inst1));
+  if (seq->count == 1)
+  {
+    join_cells_add_range(grid, p1, p1, inst1->t, inst1->t, rx, ry, stamp,
+      stampval, jc);
+    return;
+  }
+  for (int i = 1; i < seq->count; i++)
+  {
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+    const POINT2D *p2 = DATUM_POINT2D_P(tinstant_value(inst2));
+    join_cells_add_range(grid, p1, p2, inst1->t, inst2->t, rx, ry, stamp,
+      stampval, jc);
+    inst1 = inst2;
+    p1 = p2;
+  }
+  return;
+}
+
+/**
+ * @brief Add the cells overlapped by a temporal point
+ */
+static void
+tpoint_join_cells(const Temporal *temp, const JoinGrid *grid, int rx, int ry,
+  uint32 *stamp, uint32 stampval, JoinCells *jc)
+{
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+  {
+    const TInstant *inst = (const TInstant *) temp;
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_value(inst));
+    join_cells_add_range(grid, p, p, inst->t, inst->t, rx, ry, stamp,
+      stampval, jc);
+  }
+  else if (temp->subtype == TSEQUENCE)
+    tpointseq_join_cells((const TSequence *) temp, grid, rx, ry, stamp,
+      stampval, jc);
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    for (int i = 0; i < ss->count; i++)
+      tpointseq_join_cells(TSEQUENCESET_SEQ_N(ss, i), grid, rx, ry, stamp,
+        stampval, jc);
+  }
+  return;
+}
+
+/*****************************************************************************
+ * Probe tasks
+ *****************************************************************************/
+
+/* Per-thread scratch of the probe tasks: the stamp over the grid cells
+ * dedups the cells of one probed trip, the stamp over the second collection
+ * dedups its candidates. Both are reused across tasks of the same worker */
+static __thread uint32 *join_cell_stamp = NULL;
+static __thread int64 join_cell_stamp_size = 0;
+static __thread uint32 join_cell_stampval = 0;
+static __thread uint32 *join_cand_stamp = NULL;
+static __thread int join_cand_stamp_size = 0;
+static __thread uint32 join_cand_stampval = 0;
+
+/**
+ * @brief Ensure that a per-thread stamp array has the given size, zeroing
+ * it and restarting its stamp counter when it is (re)created
+ */
+static uint32 *
+join_stamp_reserve(uint32 *stamp, int64 oldsize, int64 size, uint32 *stampval)
+{
+  if (stamp != NULL && oldsize >= size)
+    return stamp;
+  if (stamp != NULL)
+    pfree(stamp);
+  stamp = palloc0(sizeof(uint32) * size);
+  *stampval = 0;
+  return stamp;
+}
+
+/**
+ * @brief Probe the grid with one temporal point of the first collection and
+ * evaluate the exact predicate on the candidates found in its cells
+ */
+static void
+tpoint_join_probe(void *arg, int idx)
+{
+  JoinProbeState *st = (JoinProbeState *) arg;
+  join_cell_stamp = join_stamp_reserve(join_cell_stamp, join_cell_stamp_size,
+    st->grid->ncells, &join_cell_stampval);
+  join_cell_stamp_size = Max(join_cell_stamp_size, st->grid->ncells);
+  join_cand_stamp = join_stamp_reserve(join_cand_stamp, join_cand_stamp_size,
+    st->count2, &join_cand_stampval);
+  join_cand_stamp_size = Max(join_cand_stamp_size, (int64) st->count2);
+
+  /* Collect the cells of the probed trip, enlarged by the query distance */
+  JoinCells jc;
+  memset(&jc, 0, sizeof(jc));
+  tpoint_join_cells(st->temparr1[idx], st->grid, st->rx, st->ry,
+    join_cell_stamp, ++join_cell_stampval, &jc);
+
+  /* Evaluate the exact predicate on the candidates of the cell buckets */
+  Match *matches = NULL;
+  int nmatches = 0, size = 0;
+  uint32 candval = ++join_cand_stampval;
+  for (int c = 0; c < jc.count; c++)
+  {
+    int cell = jc.cells[c];
+    for (int k = st->bucketstart[cell]; k < st->bucketstart[cell + 1]; k++)
+    {
+      int j = st->bucketitems[k];
+      if (join_cand_stamp[j] == candval)
+        continue;
+      join_cand_stamp[j] = candval;
+      if (edwithin_tpoint_tpoint(st->temparr1[idx], st->temparr2[j],
+            st->dist) != 1)
+        continue;
+      if (nmatches == size)
+      {
+        size = size ? size * 2 : 8;
+        matches = matches ?
+          repalloc(matches, sizeof(Match) * size) :
+          palloc(sizeof(Match) * size);
+      }
+      matches[nmatches].i = idx;
+      matches[nmatches].j = j;
+      nmatches++;
+    }
+  }
+  if (jc.cells)
+    pfree(jc.cells);
+  st->results[idx] = matches;
+  st->nresults[idx] = nmatches;
+  return;
+}
+
+/*****************************************************************************
+ * Join interface
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_spatial_rel_ever
+ * @brief Return the pairs of temporal points of two collections that are
+ * ever within a distance of each other.
+ *
+ * Both collections are bucketed over a space-time grid and the exact
+ * predicate #edwithin_tpoint_tpoint is only evaluated for the pairs that
+ * share a grid cell, in parallel when the thread pool is active. The cell
+ * sizes trade memory for candidate pruning: cells in the order of the
+ * typical trip extent per time slice work well, and the time slicing is
+ * what prunes trips visiting the same region at different moments.
+ * @param[in] temparr1,count1 First collection of temporal points
+ * @param[in] temparr2,count2 Second collection of temporal points
+ * @param[in] dist Distance
+ * @param[in] xsize,ysize Spatial size of the grid cells
+ * @param[in] duration Temporal size of the grid cells, may be @p NULL when
+ * the time dimension is not partitioned
+ * @param[out] count Number of elements of the output array
+ * @return Array of pairs of indices in the two collections, @p NULL on
+ * error. When joining a collection with itself the result contains both
+ * (i, j) and (j, i), callers keep the pairs with i < j.
+ * @note The function requires planar coordinates, where the distance and
+ * the cell sizes are expressed in the units of the coordinate system
+ */
+Match *
+tpointarr_dwithin_join(const Temporal **temparr1, int count1,
+  const Temporal **temparr2, int count2, double dist, double xsize,
+  double ysize, const Interval *duration, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr1) ||
+      ! ensure_not_null((void *) temparr2) ||
+      ! ensure_not_null((void *) count) ||
+      ! ensure_positive(count1) || ! ensure_positive(count2) ||
+      ! ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8) ||
+      ! ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8) ||
+      ! ensure_not_geodetic(temparr1[0]->flags) ||
+      (duration && ! ensure_valid_duration(duration)))
+    return NULL;
+  for (int i = 0; i < count1; i++)
+    if (! ensure_valid_tpoint_tpoint(temparr1[0], temparr1[i]))
+      return NULL;
+  for (int j = 0; j < count2; j++)
+    if (! ensure_valid_tpoint_tpoint(temparr1[0], temparr2[j]))
+      return NULL;
+
+  /* Compute the extent of the two collections */
+  STBox extent, box;
+  temporal_set_bbox(temparr1[0], &extent);
+  for (int i = 1; i < count1; i++)
+  {
+    temporal_set_bbox(temparr1[i], &box);
+    stbox_expand(&box, &extent);
+  }
+  for (int j = 0; j < count2; j++)
+  {
+    temporal_set_bbox(temparr2[j], &box);
+    stbox_expand(&box, &extent);
+  }
+
+  /* Set up the grid */
+  JoinGrid grid;
+  memset(&grid, 0, sizeof(grid));
+  grid.xmin = extent.xmin;
+  grid.ymin = extent.ymin;
+  grid.xsize = xsize;
+  grid.ysize = ysize;
+  grid.nx = (int) ((extent.xmax - extent.xmin) / xsize) + 1;
+  grid.ny = (int) ((extent.ymax - extent.ymin) / ysize) + 1;
+  grid.nt = 1;
+  if (duration)
+  {
+    grid.tunits = interval_units(duration);
+    grid.tmin = DatumGetTimestampTz(extent.period.lower);
+    grid.nt = (int) ((DatumGetTimestampTz(extent.period.upper) - grid.tmin) /
+      grid.tunits) + 1;
+  }
+  grid.ncells = (int64) grid.nx * grid.ny * grid.nt;
+  if (grid.ncells > MEOS_JOIN_MAX_CELLS)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The join grid has too many cells (" INT64_FORMAT "), "
+      "enlarge the cell sizes", grid.ncells);
+    return NULL;
+  }
+
+  /* Bucket the second collection: collect the cells of every element and
+   * arrange them into one bucket of element numbers per cell */
+  uint32 *stamp = palloc0(sizeof(uint32) * grid.ncells);
+  uint32 stampval = 0;
+  int **jcells = palloc(sizeof(int *) * count2);
+  int *njcells = palloc(sizeof(int) * count2);
+  int64 nitems = 0;
+  for (int j = 0; j < count2; j++)
+  {
+    JoinCells jc;
+    memset(&jc, 0, sizeof(jc));
+    tpoint_join_cells(temparr2[j], &grid, 0, 0, stamp, ++stampval, &jc);
+    jcells[j] = jc.cells;
+    njcells[j] = jc.count;
+    nitems += jc.count;
+  }
+  int *bucketstart = palloc0(sizeof(int) * (grid.ncells + 1));
+  for (int j = 0; j < count2; j++)
+    for (int c = 0; c < njcells[j]; c++)
+      bucketstart[jcells[j][c] + 1]++;
+  for (int64 c = 0; c < grid.ncells; c++)
+    bucketstart[c + 1] += bucketstart[c];
+  int *bucketitems = palloc(sizeof(int) * Max(nitems, 1));
+  int *bucketnext = palloc(sizeof(int) * grid.ncells);
+  memcpy(bucketnext, bucketstart, sizeof(int) * grid.ncells);
+  for (int j = 0; j < count2; j++)
+  {
+    for (int c = 0; c < njcells[j]; c++)
+      bucketitems[bucketnext[jcells[j][c]]++] = j;
+    if (jcells[j])
+      pfree(jcells[j]);
+  }
+  pfree(bucketnext);
+  pfree(jcells);
+  pfree(njcells);
+  pfree(stamp);
+
+  /* Probe the grid with the first collection on the thread pool */
+  JoinProbeState st;
+  memset(&st, 0, sizeof(st));
+  st.temparr1 = temparr1;
+  st.temparr2 = temparr2;
+  st.count2 = count2;
+  st.dist = dist;
+  st.grid = &grid;
+  st.rx = (int) ceil(dist / xsize);
+  st.ry = (int) ceil(dist / ysize);
+  st.bucketstart = bucketstart;
+  st.bucketitems = bucketitems;
+  st.results = palloc0(sizeof(Match *) * count1);
+  st.nresults = palloc0(sizeof(int) * count1);
+  meos_pool_parallel_for(count1, &tpoint_join_probe, &st);
+
+  /* Assemble the matches of the tasks in order of the first collection */
+  int total = 0;
+  for (int i = 0; i < count1; i++)
+    total += st.nresults[i];
+  Match *result = palloc(sizeof(Match) * Max(total, 1));
+  int n = 0;
+  for (int i = 0; i < count1; i++)
+  {
+    if (st.results[i])
+    {
+      memcpy(&result[n], st.results[i], sizeof(Match) * st.nresults[i]);
+      n += st.nresults[i];
+      pfree(st.results[i]);
+    }
+  }
+  pfree(st.results);
+  pfree(st.nresults);
+  pfree(bucketstart);
+  pfree(bucketitems);
+  *count = total;
+  return result;
+}
+
+#endif /* MEOS */
+
+/*****************************************************************************/
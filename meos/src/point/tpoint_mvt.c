@@ -0,0 +1,483 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Output of temporal points in Mapbox Vector Tile (MVT) format.
+ *
+ * Contrary to #tpoint_AsMVTGeom, which outputs a geometry and an array of
+ * timestamps that must still be assembled into a tile by the caller
+ * (typically with the PostGIS function `ST_AsMVT`), the function
+ * #tpoint_as_mvt directly encodes a complete tile: the temporal point is
+ * simplified to the tile resolution, quantized to tile coordinates, and
+ * written in the protocol buffers wire format in a single pass, without
+ * materializing an intermediate geometry.
+ *
+ * The encoder produces one layer containing at most two features: a
+ * (multi)linestring with the continuous sequences and a (multi)point with
+ * the instants that do not belong to one. Since the MVT format cannot
+ * attach a value to each vertex, the timestamps are summarized by two
+ * feature attributes `start` and `end` holding the temporal extent of the
+ * feature in Unix epoch seconds; callers needing the timestamps of every
+ * vertex must use #tpoint_AsMVTGeom.
+ */
+
+#include "point/tpoint_mvt.h"
+
+/* C */
+#include <assert.h>
+#include <string.h>
+/* PostgreSQL */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporaltypes.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/* Value of the `version` field of a layer */
+#define MVT_VERSION 2
+
+/* Fields of the `Tile`, `Layer`, `Feature`, and `Value` messages */
+#define MVT_TILE_LAYER        3
+#define MVT_LAYER_NAME        1
+#define MVT_LAYER_FEATURES    2
+#define MVT_LAYER_KEYS        3
+#define MVT_LAYER_VALUES      4
+#define MVT_LAYER_EXTENT      5
+#define MVT_LAYER_VERSION     15
+#define MVT_FEATURE_TAGS      2
+#define MVT_FEATURE_TYPE      3
+#define MVT_FEATURE_GEOMETRY  4
+#define MVT_VALUE_INT         4
+
+/* Protocol buffers wire types */
+#define MVT_WIRE_VARINT 0
+#define MVT_WIRE_BYTES  2
+
+/* Geometry types and commands of a feature */
+#define MVT_POINT       1
+#define MVT_LINESTRING  2
+#define MVT_CMD_MOVETO  1
+#define MVT_CMD_LINETO  2
+
+/* Number of seconds difference between Unix and PostgreSQL epochs */
+#define DELTA_UNIX_POSTGRES_EPOCH 946684800
+
+/*****************************************************************************
+ * Protocol buffers wire format writer
+ *****************************************************************************/
+
+/**
+ * Growable byte buffer holding an encoded protocol buffers message
+ */
+typedef struct
+{
+  uint8_t *data;    /**< Bytes written so far */
+  size_t length;    /**< Number of bytes written */
+  size_t maxlength; /**< Number of bytes allocated */
+} MVTBuf;
+
+/**
+ * @brief Initialize a byte buffer
+ */
+static void
+mvt_buf_init(MVTBuf *buf)
+{
+  buf->maxlength = 64;
+  buf->length = 0;
+  buf->data = palloc(buf->maxlength);
+  return;
+}
+
+/**
+ * @brief Append bytes at the end of a byte buffer, growing it when needed
+ */
+static void
+mvt_buf_append(MVTBuf *buf, const uint8_t *data, size_t length)
+{
+  if (buf->length + length > buf->maxlength)
+  {
+    while (buf->length + length > buf->maxlength)
+      buf->maxlength *= 2;
+    buf->data = repalloc(buf->data, buf->maxlength);
+  }
+  memcpy(buf->data + buf->length, data, length);
+  buf->length += length;
+  return;
+}
+
+/**
+ * @brief Append a base 128 varint at the end of a byte buffer
+ */
+static void
+mvt_put_varint(MVTBuf *buf, uint64 value)
+{
+  /* A 64-bit varint takes at most 10 bytes */
+  uint8_t bytes[10];
+  int nbytes = 0;
+  while (value >= 0x80)
+  {
+    bytes[nbytes++] = (uint8_t) (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  bytes[nbytes++] = (uint8_t) value;
+  mvt_buf_append(buf, bytes, nbytes);
+  return;
+}
+
+/**
+ * @brief Append the key of a field at the end of a byte buffer
+ */
+static void
+mvt_put_key(MVTBuf *buf, uint32 field, uint32 wiretype)
+{
+  mvt_put_varint(buf, (field << 3) | wiretype);
+  return;
+}
+
+/**
+ * @brief Append a varint field at the end of a byte buffer
+ */
+static void
+mvt_put_tag_varint(MVTBuf *buf, uint32 field, uint64 value)
+{
+  mvt_put_key(buf, field, MVT_WIRE_VARINT);
+  mvt_put_varint(buf, value);
+  return;
+}
+
+/**
+ * @brief Append a length-delimited field at the end of a byte buffer
+ */
+static void
+mvt_put_tag_bytes(MVTBuf *buf, uint32 field, const uint8_t *data,
+  size_t length)
+{
+  mvt_put_key(buf, field, MVT_WIRE_BYTES);
+  mvt_put_varint(buf, length);
+  mvt_buf_append(buf, data, length);
+  return;
+}
+
+/**
+ * @brief Return the zig-zag encoding of a signed parameter integer
+ */
+static uint32
+mvt_zigzag(int32 value)
+{
+  return ((uint32) value << 1) ^ (uint32) (value >> 31);
+}
+
+/*****************************************************************************
+ * Encoding of the geometry commands
+ *****************************************************************************/
+
+/**
+ * @brief Return the tile coordinates of a temporal instant point
+ *
+ * The instant results from #tpoint_mvt and thus its coordinates are integral
+ * values in tile coordinate space.
+ */
+static void
+mvt_instant_coords(const TInstant *inst, int32 *x, int32 *y)
+{
+  POINT2D p = datum_point2d(tinstant_value(inst));
+  *x = (int32) p.x;
+  *y = (int32) p.y;
+  return;
+}
+
+/**
+ * @brief Append the geometry of a (multi)point feature gathering the given
+ * instants
+ * @param[in,out] buf Byte buffer of the feature
+ * @param[in] instants Instants of the feature
+ * @param[in] count Number of instants
+ * @param[in,out] cursorx,cursory Cursor of the geometry encoding
+ */
+static void
+mvt_encode_points(MVTBuf *buf, const TInstant **instants, int count,
+  int32 *cursorx, int32 *cursory)
+{
+  mvt_put_varint(buf, MVT_CMD_MOVETO | ((uint32) count << 3));
+  for (int i = 0; i < count; i++)
+  {
+    int32 x, y;
+    mvt_instant_coords(instants[i], &x, &y);
+    mvt_put_varint(buf, mvt_zigzag(x - *cursorx));
+    mvt_put_varint(buf, mvt_zigzag(y - *cursory));
+    *cursorx = x;
+    *cursory = y;
+  }
+  return;
+}
+
+/**
+ * @brief Append the geometry of a (multi)linestring feature gathering the
+ * given sequences
+ * @param[in,out] buf Byte buffer of the feature
+ * @param[in] sequences Sequences of the feature, each one with at least two
+ * instants
+ * @param[in] count Number of sequences
+ * @param[in,out] cursorx,cursory Cursor of the geometry encoding
+ */
+static void
+mvt_encode_lines(MVTBuf *buf, const TSequence **sequences, int count,
+  int32 *cursorx, int32 *cursory)
+{
+  for (int i = 0; i < count; i++)
+  {
+    const TSequence *seq = sequences[i];
+    assert(seq->count > 1);
+    int32 x, y;
+    mvt_instant_coords(TSEQUENCE_INST_N(seq, 0), &x, &y);
+    mvt_put_varint(buf, MVT_CMD_MOVETO | (1 << 3));
+    mvt_put_varint(buf, mvt_zigzag(x - *cursorx));
+    mvt_put_varint(buf, mvt_zigzag(y - *cursory));
+    *cursorx = x;
+    *cursory = y;
+    mvt_put_varint(buf, MVT_CMD_LINETO | ((uint32) (seq->count - 1) << 3));
+    for (int j = 1; j < seq->count; j++)
+    {
+      mvt_instant_coords(TSEQUENCE_INST_N(seq, j), &x, &y);
+      mvt_put_varint(buf, mvt_zigzag(x - *cursorx));
+      mvt_put_varint(buf, mvt_zigzag(y - *cursory));
+      *cursorx = x;
+      *cursory = y;
+    }
+  }
+  return;
+}
+
+/*****************************************************************************
+ * Encoding of the features and the layer
+ *****************************************************************************/
+
+/**
+ * @brief Append a feature at the end of the byte buffer of a layer
+ * @param[in,out] layer Byte buffer of the layer
+ * @param[in] type Geometry type of the feature
+ * @param[in] geometry Byte buffer holding the encoded geometry commands
+ * @param[in] start,end Temporal extent of the feature
+ * @param[in,out] values Byte buffer of the value table of the layer, to
+ * which the start and end values are appended
+ * @param[in,out] nvalues Number of values in the value table
+ */
+static void
+mvt_encode_feature(MVTBuf *layer, uint32 type, const MVTBuf *geometry,
+  TimestampTz start, TimestampTz end, MVTBuf *values, uint32 *nvalues)
+{
+  /* Append the start and end values to the value table of the layer. The
+   * keys `start` and `end` are at indexes 0 and 1 of the key table */
+  uint32 tags[4];
+  TimestampTz times[2] = { start, end };
+  for (int i = 0; i < 2; i++)
+  {
+    MVTBuf value;
+    mvt_buf_init(&value);
+    int64 epoch = (times[i] / 1000000) + DELTA_UNIX_POSTGRES_EPOCH;
+    mvt_put_tag_varint(&value, MVT_VALUE_INT, (uint64) epoch);
+    mvt_put_tag_bytes(values, MVT_LAYER_VALUES, value.data, value.length);
+    pfree(value.data);
+    tags[2 * i] = (uint32) i;
+    tags[2 * i + 1] = (*nvalues)++;
+  }
+
+  /* Encode the feature */
+  MVTBuf feature;
+  mvt_buf_init(&feature);
+  MVTBuf packed;
+  mvt_buf_init(&packed);
+  for (int i = 0; i < 4; i++)
+    mvt_put_varint(&packed, tags[i]);
+  mvt_put_tag_bytes(&feature, MVT_FEATURE_TAGS, packed.data, packed.length);
+  pfree(packed.data);
+  mvt_put_tag_varint(&feature, MVT_FEATURE_TYPE, type);
+  mvt_put_tag_bytes(&feature, MVT_FEATURE_GEOMETRY, geometry->data,
+    geometry->length);
+  mvt_put_tag_bytes(layer, MVT_LAYER_FEATURES, feature.data, feature.length);
+  pfree(feature.data);
+  return;
+}
+
+/**
+ * @brief Encode a temporal point in tile coordinate space as a tile layer
+ * @param[in] temp Temporal point resulting from #tpoint_mvt, may be NULL
+ * when the simplification left nothing to encode
+ * @param[in] extent Tile extent in tile coordinate space
+ * @param[in] name Name of the layer
+ * @param[out] size Number of bytes of the result
+ */
+static uint8_t *
+mvt_encode_layer(const Temporal *temp, int32_t extent, const char *name,
+  size_t *size)
+{
+  /* Gather the continuous sequences and the instants that do not belong to
+   * one, which are respectively encoded as a (multi)linestring and a
+   * (multi)point feature */
+  const TSequence **sequences = NULL;
+  const TInstant **instants = NULL;
+  int nseqs = 0, ninsts = 0;
+  if (temp != NULL)
+  {
+    if (temp->subtype == TINSTANT)
+    {
+      instants = palloc(sizeof(TInstant *));
+      instants[ninsts++] = (const TInstant *) temp;
+    }
+    else if (temp->subtype == TSEQUENCE)
+    {
+      const TSequence *seq = (const TSequence *) temp;
+      if (MEOS_FLAGS_DISCRETE_INTERP(temp->flags) || seq->count == 1)
+      {
+        instants = palloc(sizeof(TInstant *) * seq->count);
+        for (int i = 0; i < seq->count; i++)
+          instants[ninsts++] = TSEQUENCE_INST_N(seq, i);
+      }
+      else
+      {
+        sequences = palloc(sizeof(TSequence *));
+        sequences[nseqs++] = seq;
+      }
+    }
+    else /* temp->subtype == TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      sequences = palloc(sizeof(TSequence *) * ss->count);
+      instants = palloc(sizeof(TInstant *) * ss->count);
+      for (int i = 0; i < ss->count; i++)
+      {
+        const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+        if (seq->count == 1)
+          instants[ninsts++] = TSEQUENCE_INST_N(seq, 0);
+        else
+          sequences[nseqs++] = seq;
+      }
+    }
+  }
+
+  MVTBuf layer;
+  mvt_buf_init(&layer);
+  mvt_put_tag_varint(&layer, MVT_LAYER_VERSION, MVT_VERSION);
+  mvt_put_tag_bytes(&layer, MVT_LAYER_NAME, (const uint8_t *) name,
+    strlen(name));
+  mvt_put_tag_bytes(&layer, MVT_LAYER_KEYS, (const uint8_t *) "start", 5);
+  mvt_put_tag_bytes(&layer, MVT_LAYER_KEYS, (const uint8_t *) "end", 3);
+
+  /* The geometry cursor is shared by the features of the layer */
+  MVTBuf values;
+  mvt_buf_init(&values);
+  uint32 nvalues = 0;
+  int32 cursorx = 0, cursory = 0;
+  if (nseqs > 0)
+  {
+    MVTBuf geometry;
+    mvt_buf_init(&geometry);
+    mvt_encode_lines(&geometry, sequences, nseqs, &cursorx, &cursory);
+    mvt_encode_feature(&layer, MVT_LINESTRING, &geometry,
+      TSEQUENCE_INST_N(sequences[0], 0)->t,
+      TSEQUENCE_INST_N(sequences[nseqs - 1],
+        sequences[nseqs - 1]->count - 1)->t, &values, &nvalues);
+    pfree(geometry.data);
+  }
+  if (ninsts > 0)
+  {
+    MVTBuf geometry;
+    mvt_buf_init(&geometry);
+    mvt_encode_points(&geometry, instants, ninsts, &cursorx, &cursory);
+    mvt_encode_feature(&layer, MVT_POINT, &geometry, instants[0]->t,
+      instants[ninsts - 1]->t, &values, &nvalues);
+    pfree(geometry.data);
+  }
+  /* Append the value table, already encoded as a sequence of fields */
+  mvt_buf_append(&layer, values.data, values.length);
+  mvt_put_tag_varint(&layer, MVT_LAYER_EXTENT, (uint64) extent);
+  pfree(values.data);
+  if (sequences != NULL)
+    pfree(sequences);
+  if (instants != NULL)
+    pfree(instants);
+
+  /* Wrap the layer into a tile */
+  MVTBuf tile;
+  mvt_buf_init(&tile);
+  mvt_put_tag_bytes(&tile, MVT_TILE_LAYER, layer.data, layer.length);
+  pfree(layer.data);
+  *size = tile.length;
+  return tile.data;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_spatial_transf
+ * @brief Encode a temporal point as a complete Mapbox Vector Tile
+ * @param[in] temp Temporal point
+ * @param[in] bounds Geometric bounds of the tile contents without buffer
+ * @param[in] extent Tile extent in tile coordinate space
+ * @param[in] buffer Buffer distance in tile coordinate space
+ * @param[in] clip_geom True if temporal point should be clipped
+ * @param[in] name Name of the layer
+ * @param[out] size Number of bytes of the result
+ * @sqlfunc asMVT()
+ */
+uint8_t *
+tpoint_as_mvt(const Temporal *temp, const STBox *bounds, int32_t extent,
+  int32_t buffer, bool clip_geom, const char *name, size_t *size)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) bounds) ||
+      ! ensure_not_null((void *) name) || ! ensure_not_null((void *) size) ||
+      ! ensure_tgeo_type(temp->temptype) || ! ensure_has_not_Z(temp->flags))
+    return NULL;
+  if (bounds->xmax - bounds->xmin <= 0 || bounds->ymax - bounds->ymin <= 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "%s: Geometric bounds are too small", __func__);
+    return NULL;
+  }
+  if (extent <= 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "%s: Extent must be greater than 0", __func__);
+    return NULL;
+  }
+
+  /* Simplify to the tile resolution and quantize to tile coordinates */
+  Temporal *mvt = tpoint_mvt(temp, bounds, extent, buffer, clip_geom);
+
+  /* Encode the result, an empty layer when nothing remains in the tile */
+  uint8_t *result = mvt_encode_layer(mvt, extent, name, size);
+  if (mvt != NULL)
+    pfree(mvt);
+  return result;
+}
+
+/*****************************************************************************/
@@ -47,9 +47,11 @@
 #include <meos_internal.h>
 #include "general/pg_types.h"
 #include "general/lifting.h"
+#include "general/pool.h"
 #include "general/temporaltypes.h"
 #include "general/tnumber_mathfuncs.h"
 #include "general/type_util.h"
+#include "point/lwgeom_inline.h"
 #include "point/tpoint_spatialrels.h"
 
 /*****************************************************************************
@@ -175,33 +177,6 @@ seg2d_side(const POINT2D *p1, const POINT2D *p2, const POINT2D *q)
     return SIGNUM(side);
 }
 
-/**
- * @brief Function derived from PostGIS file lwalgorithm.c since it is declared
- * static
- */
-static bool
-lw_seg_interact(const POINT2D *p1, const POINT2D *p2, const POINT2D *q1,
-  const POINT2D *q2)
-{
-  double minq = FP_MIN(q1->x, q2->x);
-  double maxq = FP_MAX(q1->x, q2->x);
-  double minp = FP_MIN(p1->x, p2->x);
-  double maxp = FP_MAX(p1->x, p2->x);
-
-  if (FP_GT(minp, maxq) || FP_LT(maxp, minq))
-    return false;
-
-  minq = FP_MIN(q1->y, q2->y);
-  maxq = FP_MAX(q1->y, q2->y);
-  minp = FP_MIN(p1->y, p2->y);
-  maxp = FP_MAX(p1->y, p2->y);
-
-  if (FP_GT(minp,maxq) || FP_LT(maxp,minq))
-    return false;
-
-  return true;
-}
-
 /**
  * @brief Find the UNIQUE point of intersection p between two closed segments
  * ab and cd. Return p and a MEOS_SEG_INTER_TYPE value.
@@ -218,7 +193,7 @@ seg2d_intersection(const POINT2D *a, const POINT2D *b, const POINT2D *c,
   int pq1, pq2, qp1, qp2;
 
   /* No envelope interaction => we are done. */
-  if (! lw_seg_interact(a, b, c, d))
+  if (! meos_lw_seg_interact(a, b, c, d))
     return MEOS_SEG_NO_INTERSECTION;
 
   /* Are the start and end points of q on the same side of p? */
@@ -385,7 +360,7 @@ tpointseq_linear_find_splits(const TSequence *seq, int *count)
     while (j < end)
     {
       /* If the bounding boxes of the segments intersect */
-      if (lw_seg_interact(points[i], points[i + 1], points[j],
+      if (meos_lw_seg_interact(points[i], points[i + 1], points[j],
         points[j + 1]))
       {
         /* Candidate for intersection */
@@ -2449,6 +2424,92 @@ tpoint_minus_stbox(const Temporal *temp, const STBox *box, bool border_inc)
   Temporal *result = tpoint_restrict_stbox(temp, box, border_inc, REST_MINUS);
   return result;
 }
+
+/*****************************************************************************/
+
+/** Arguments of the batch restriction tasks submitted to the thread pool */
+typedef struct TpointArrRestrictStboxTask
+{
+  const Temporal **temparr; /**< Array of temporal points being restricted */
+  const STBox *box;         /**< Spatiotemporal box */
+  bool border_inc;          /**< True when the box contains the upper border */
+  Temporal **result;        /**< Array receiving the results */
+  const int *todo;          /**< Positions of the values left to restrict */
+} TpointArrRestrictStboxTask;
+
+/**
+ * @brief Restrict one temporal point of a batch to a spatiotemporal box,
+ * task function executed on the thread pool
+ */
+static void
+tpointarr_at_stbox_task(void *arg, int idx)
+{
+  TpointArrRestrictStboxTask *task = (TpointArrRestrictStboxTask *) arg;
+  int i = task->todo[idx];
+  task->result[i] = tpoint_restrict_stbox(task->temparr[i], task->box,
+    task->border_inc, REST_AT);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_restrict
+ * @brief Restrict an array of temporal points to a single spatiotemporal
+ * box.
+ *
+ * The arguments are validated once, a bounding box prefilter discards the
+ * values that do not overlap the box, and the remaining clips are executed
+ * on the thread pool, which makes the function considerably faster than
+ * restricting the values one by one.
+ * @param[in] temparr Array of temporal points
+ * @param[in] count Number of elements in the array
+ * @param[in] box Spatiotemporal box
+ * @param[in] border_inc True when the box contains the upper border
+ * @return Array of @p count results, where an entry is @p NULL when the
+ * restriction is empty. On error return @p NULL.
+ * @sqlfunc atStbox()
+ */
+Temporal **
+tpointarr_at_stbox(const Temporal **temparr, int count, const STBox *box,
+  bool border_inc)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_not_null((void *) box) ||
+      ! ensure_positive(count))
+    return NULL;
+
+  Temporal **result = palloc0(sizeof(Temporal *) * count);
+  int *todo = palloc(sizeof(int) * count);
+  int ntodo = 0;
+  bool hasx = MEOS_FLAGS_GET_X(box->flags);
+  STBox box1;
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_valid_tpoint_box(temparr[i], box))
+    {
+      pfree(result); pfree(todo);
+      return NULL;
+    }
+    /* Bounding box prefilter: non-overlapping values have an empty
+     * restriction and are not submitted to the pool */
+    if (hasx)
+    {
+      temporal_set_bbox(temparr[i], &box1);
+      if (! overlaps_stbox_stbox(&box1, box))
+        continue;
+    }
+    todo[ntodo++] = i;
+  }
+
+  /* Clip the candidate values on the thread pool */
+  if (ntodo > 0)
+  {
+    TpointArrRestrictStboxTask task =
+      { temparr, box, border_inc, result, todo };
+    meos_pool_parallel_for(ntodo, &tpointarr_at_stbox_task, &task);
+  }
+  pfree(todo);
+  return result;
+}
 #endif /* MEOS */
 
 /*****************************************************************************/
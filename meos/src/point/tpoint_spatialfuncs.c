@@ -36,6 +36,11 @@
 
 /* C */
 #include <assert.h>
+#include <math.h>
+#if MEOS
+  #include <pthread.h>
+  #include <stdio.h>
+#endif
 /* PostgreSQL */
 #include <utils/float.h>
 #if POSTGRESQL_VERSION_NUMBER >= 160000
@@ -55,6 +60,7 @@
 #include "general/temporaltypes.h"
 #include "general/tnumber_mathfuncs.h"
 #include "general/type_util.h"
+#include "point/lwgeom_inline.h"
 #include "point/pgis_call.h"
 #include "point/tpoint_distance.h"
 #if NPOINT
@@ -299,7 +305,7 @@ pt_distance2d(Datum geom1, Datum geom2)
 {
   const POINT2D *p1 = DATUM_POINT2D_P(geom1);
   const POINT2D *p2 = DATUM_POINT2D_P(geom2);
-  return Float8GetDatum(distance2d_pt_pt(p1, p2));
+  return Float8GetDatum(meos_distance2d_pt_pt(p1, p2));
 }
 
 /**
@@ -310,7 +316,7 @@ pt_distance3d(Datum geom1, Datum geom2)
 {
   const POINT3DZ *p1 = DATUM_POINT3DZ_P(geom1);
   const POINT3DZ *p2 = DATUM_POINT3DZ_P(geom2);
-  return Float8GetDatum(distance3d_pt_pt((POINT3D *) p1, (POINT3D *) p2));
+  return Float8GetDatum(meos_distance3d_pt_pt((POINT3D *) p1, (POINT3D *) p2));
 }
 
 /**
@@ -1159,104 +1165,10 @@ tpoint_always_eq(const Temporal *temp, const GSERIALIZED *gs)
 
 /*****************************************************************************
  * Functions derived from PostGIS to increase floating-point precision
+ * The Cartesian segment-ratio functions are in lwgeom_inline.h so that the
+ * per-segment calls of the trajectory loops are inlined
  *****************************************************************************/
 
-/**
- * @brief Return a long double between 0 and 1 representing the location of the
- * closest point on the segment to the given point, as a fraction of total
- * segment length (2D version)
- * @note Function derived from the PostGIS function closest_point_on_segment
- */
-long double
-closest_point2d_on_segment_ratio(const POINT2D *p, const POINT2D *A,
-  const POINT2D *B, POINT2D *closest)
-{
-  if (FP_EQUALS(A->x, B->x) && FP_EQUALS(A->y, B->y))
-  {
-    if (closest)
-      *closest = *A;
-    return 0.0;
-  }
-
-  /*
-   * We use comp.graphics.algorithms Frequently Asked Questions method
-   *
-   * (1)          AC dot AB
-   *         r = ----------
-   *              ||AB||^2
-   *  r has the following meaning:
-   *  r=0 P = A
-   *  r=1 P = B
-   *  r<0 P is on the backward extension of AB
-   *  r>1 P is on the forward extension of AB
-   *  0<r<1 P is interior to AB
-   *
-   */
-  long double r = ( (p->x-A->x) * (B->x-A->x) + (p->y-A->y) * (B->y-A->y) ) /
-    ( (B->x-A->x) * (B->x-A->x) + (B->y-A->y) * (B->y-A->y) );
-
-  if (r < 0)
-  {
-    if (closest)
-      *closest = *A;
-    return 0.0;
-  }
-  if (r > 1)
-  {
-    if (closest)
-      *closest = *B;
-    return 1.0;
-  }
-
-  if (closest)
-  {
-    closest->x = (double) (A->x + ( (B->x - A->x) * r ));
-    closest->y = (double) (A->y + ( (B->y - A->y) * r ));
-  }
-  return r;
-}
-
-/**
- * @brief Return a float between 0 and 1 representing the location of the
- * closest point on the segment to the given point, as a fraction of total
- * segment length (3D version)
- * @note Function derived from the PostGIS function closest_point_on_segment
- */
-long double
-closest_point3dz_on_segment_ratio(const POINT3DZ *p, const POINT3DZ *A,
-  const POINT3DZ *B, POINT3DZ *closest)
-{
-  if (FP_EQUALS(A->x, B->x) && FP_EQUALS(A->y, B->y) && FP_EQUALS(A->z, B->z))
-  {
-    *closest = *A;
-    return 0.0;
-  }
-
-  /*
-   * Function #closest_point2d_on_segment_ratio explains how r is computed
-   */
-  long double r = ( (p->x-A->x) * (B->x-A->x) + (p->y-A->y) * (B->y-A->y) +
-      (p->z-A->z) * (B->z-A->z) ) /
-    ( (B->x-A->x) * (B->x-A->x) + (B->y-A->y) * (B->y-A->y) +
-      (B->z-A->z) * (B->z-A->z) );
-
-  if (r < 0)
-  {
-    *closest = *A;
-    return 0.0;
-  }
-  if (r > 1)
-  {
-    *closest = *B;
-    return 1.0;
-  }
-
-  closest->x = (double) (A->x + ( (B->x - A->x) * r ));
-  closest->y = (double) (A->y + ( (B->y - A->y) * r ));
-  closest->z = (double) (A->z + ( (B->z - A->z) * r ));
-  return r;
-}
-
 /**
  * @brief Return a float between 0 and 1 representing the location of the
  * closest point on the geography segment to the given point, as a fraction of
@@ -1345,7 +1257,7 @@ interpolate_point4d_spheroid(const POINT4D *p1, const POINT4D *p2,
   }
 
   /* Compute Cartesian interpolation and precompute z/m values */
-  interpolate_point4d(p1, p2, p, f);
+  meos_interpolate_point4d(p1, p2, p, f);
 
   /* If success, use newly computed lat and lon,
    * otherwise return precomputed cartesian result */
@@ -1368,11 +1280,24 @@ GSERIALIZED *
 gspoint_make(double x, double y, double z, bool hasz, bool geodetic,
   int32 srid)
 {
-  LWPOINT *point = hasz ?
-    lwpoint_make3dz(srid, x, y, z) : lwpoint_make2d(srid, x, y);
-  FLAGS_SET_GEODETIC(point->flags, geodetic);
-  GSERIALIZED *result = geo_serialize((LWGEOM *) point);
-  lwpoint_free(point);
+  /* Write the serialized form directly: a point is a fixed-size value made
+   * of srid+flags, type, number of points, and the coordinates, so going
+   * through an LWPOINT would only copy the coordinates a second time */
+  size_t ptsize = sizeof(double) * (hasz ? 3 : 2);
+  GSERIALIZED *result = palloc(16 + ptsize);
+  SET_VARSIZE(result, 16 + ptsize);
+  result->gflags = 0;
+  FLAGS_SET_Z(result->gflags, hasz ? 1 : 0);
+  FLAGS_SET_GEODETIC(result->gflags, geodetic ? 1 : 0);
+  gserialized_set_srid(result, srid);
+  uint32_t *meta = (uint32_t *) result->data;
+  meta[0] = POINTTYPE;
+  meta[1] = 1;
+  double *coords = (double *) (result->data + 8);
+  coords[0] = x;
+  coords[1] = y;
+  if (hasz)
+    coords[2] = z;
   return result;
 }
 
@@ -1436,9 +1361,9 @@ geosegm_locate_point(Datum start, Datum end, Datum point, double *dist)
     /* Get the closest point and the distance */
     result = closest_point_on_segment_sphere(&p, &p1, &p2, &closest, &d);
     /* For robustness, force 0/1 when closest point == start/endpoint */
-    if (p4d_same(&p1, &closest))
+    if (meos_p4d_same(&p1, &closest))
       result = 0.0;
-    else if (p4d_same(&p2, &closest))
+    else if (meos_p4d_same(&p2, &closest))
       result = 1.0;
     /* Return the distance between the closest point and the point if requested */
     if (dist)
@@ -1460,12 +1385,12 @@ geosegm_locate_point(Datum start, Datum end, Datum point, double *dist)
       POINT3DZ proj;
       result = closest_point3dz_on_segment_ratio(p, p1, p2, &proj);
       /* For robustness, force 0/1 when closest point == start/endpoint */
-      if (p3d_same((POINT3D *) p1, (POINT3D *) &proj))
+      if (meos_p3d_same((POINT3D *) p1, (POINT3D *) &proj))
         result = 0.0;
-      else if (p3d_same((POINT3D *) p2, (POINT3D *) &proj))
+      else if (meos_p3d_same((POINT3D *) p2, (POINT3D *) &proj))
         result = 1.0;
       if (dist)
-        *dist = distance3d_pt_pt((POINT3D *) p, (POINT3D *) &proj);
+        *dist = meos_distance3d_pt_pt((POINT3D *) p, (POINT3D *) &proj);
     }
     else
     {
@@ -1474,12 +1399,12 @@ geosegm_locate_point(Datum start, Datum end, Datum point, double *dist)
       const POINT2D *p = DATUM_POINT2D_P(point);
       POINT2D proj;
       result = closest_point2d_on_segment_ratio(p, p1, p2, &proj);
-      if (p2d_same(p1, &proj))
+      if (meos_p2d_same(p1, &proj))
         result = 0.0;
-      else if (p2d_same(p2, &proj))
+      else if (meos_p2d_same(p2, &proj))
         result = 1.0;
       if (dist)
-        *dist = distance2d_pt_pt((POINT2D *) p, &proj);
+        *dist = meos_distance2d_pt_pt((POINT2D *) p, &proj);
     }
   }
   return result;
@@ -1691,7 +1616,7 @@ geopoint_collinear(Datum value1, Datum value2, Datum value3,
   if (geodetic)
     interpolate_point4d_spheroid(&p1, &p3, &p, NULL, ratio);
   else
-    interpolate_point4d(&p1, &p3, &p, ratio);
+    meos_interpolate_point4d(&p1, &p3, &p, ratio);
 
   bool result = hasz ?
     fabs(p2.x - p.x) <= MEOS_EPSILON && fabs(p2.y - p.y) <= MEOS_EPSILON &&
@@ -1851,6 +1776,81 @@ tpointseq_disc_trajectory(const TSequence *seq)
   return result;
 }
 
+/**
+ * @brief Build the linestring trajectory of a temporal sequence point
+ * directly in its serialized form
+ * @param[in] seq Temporal sequence with linear interpolation
+ *
+ * The coordinates of the composing points and of a serialized linestring
+ * are both flat arrays of doubles, so the points are copied straight from
+ * the instants into the result, skipping the intermediate LWGEOM and its
+ * second copy of every coordinate. The float bounding box is computed
+ * during the copy with the same rounding as the serializer. Geodetic
+ * sequences keep the generic path since their bounding box is computed on
+ * the sphere.
+ */
+static GSERIALIZED *
+tpointseq_linear_trajectory_direct(const TSequence *seq)
+{
+  const TInstant *inst = TSEQUENCE_INST_N(seq, 0);
+  const GSERIALIZED *gsfirst = DatumGetGserializedP(tinstant_value(inst));
+  bool hasz = FLAGS_GET_Z(gsfirst->gflags) != 0;
+  int ndims = hasz ? 3 : 2;
+  size_t ptsize = sizeof(double) * ndims;
+  /* Serialized layout: srid+flags, float bounding box, type, npoints, and
+   * the coordinates; the first two occupy 8 bytes each */
+  size_t bboxsize = sizeof(float) * 2 * ndims;
+  size_t hdrsize = 8 + bboxsize + 8;
+  GSERIALIZED *result = palloc(hdrsize + ptsize * seq->count);
+  double *coords = (double *) (result->data + bboxsize + 8);
+
+  /* Copy the coordinates, removing consecutive equal points, and gather
+   * the bounding box */
+  double min[3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+  double max[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+  int npoints = 0;
+  const double *prev = NULL;
+  for (int i = 0; i < seq->count; i++)
+  {
+    const GSERIALIZED *gs = DatumGetGserializedP(
+      tinstant_value(TSEQUENCE_INST_N(seq, i)));
+    const double *pt = (const double *) GSERIALIZED_POINT2D_P(gs);
+    /* Remove two consecutive points if they are equal */
+    if (prev && memcmp(prev, pt, ptsize) == 0)
+      continue;
+    memcpy(&coords[npoints * ndims], pt, ptsize);
+    prev = &coords[npoints * ndims];
+    for (int dim = 0; dim < ndims; dim++)
+    {
+      min[dim] = Min(min[dim], pt[dim]);
+      max[dim] = Max(max[dim], pt[dim]);
+    }
+    npoints++;
+  }
+  if (npoints == 1)
+  {
+    /* All the points are equal: the trajectory is the point itself */
+    pfree(result);
+    return DatumGetGserializedP(tinstant_value_copy(inst));
+  }
+
+  /* Fill the header */
+  SET_VARSIZE(result, hdrsize + ptsize * npoints);
+  result->gflags = gsfirst->gflags;
+  FLAGS_SET_BBOX(result->gflags, 1);
+  gserialized_set_srid(result, gserialized_get_srid(gsfirst));
+  float *bbox = (float *) result->data;
+  for (int dim = 0; dim < ndims; dim++)
+  {
+    *bbox++ = next_float_down(min[dim]);
+    *bbox++ = next_float_up(max[dim]);
+  }
+  uint32_t *meta = (uint32_t *) (result->data + bboxsize);
+  meta[0] = LINETYPE;
+  meta[1] = (uint32_t) npoints;
+  return result;
+}
+
 /**
  * @brief Return the trajectory of a temporal sequence point
  * @param[in] seq Temporal sequence
@@ -1862,6 +1862,10 @@ GSERIALIZED *
 tpointseq_cont_trajectory(const TSequence *seq)
 {
   assert(seq->count > 1);
+  /* Write linear non-geodetic trajectories straight in serialized form */
+  if (MEOS_FLAGS_LINEAR_INTERP(seq->flags) &&
+      ! MEOS_FLAGS_GET_GEODETIC(seq->flags))
+    return tpointseq_linear_trajectory_direct(seq);
   LWGEOM **points = palloc(sizeof(LWGEOM *) * seq->count);
   /* Remove two consecutive points if they are equal */
   Datum value = tinstant_value(TSEQUENCE_INST_N(seq, 0));
@@ -2242,6 +2246,251 @@ tpoint_set_srid(const Temporal *temp, int32 srid)
   return result;
 }
 
+#if MEOS
+/*****************************************************************************
+ * Transformation to another SRID
+ *
+ * In MEOS there is no spatial_ref_sys table; the coordinate reference
+ * systems are resolved by their EPSG code through the PROJ database. The
+ * resulting PROJ objects are kept in a small append-only cache keyed by the
+ * SRID pair so that reprojecting millions of points from several threads
+ * does not serialize on the costly projection setup: lookups scan the cache
+ * without taking any lock and only the insertion of a new pair is protected
+ * by a mutex.
+ *****************************************************************************/
+
+#define MEOS_PROJ_CACHE_SIZE 32
+
+typedef struct
+{
+  int32 srid_from;  /**< SRID of the source coordinate reference system */
+  int32 srid_to;    /**< SRID of the target coordinate reference system */
+  LWPROJ *pj;       /**< Projection object shared by all threads */
+} MeosProjEntry;
+
+static MeosProjEntry meos_proj_cache[MEOS_PROJ_CACHE_SIZE];
+static int meos_proj_count = 0;
+static pthread_mutex_t meos_proj_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Create a projection object between two SRIDs resolved as EPSG codes
+ */
+static LWPROJ *
+meos_proj_create(int32 srid_from, int32 srid_to)
+{
+  char instr[16], outstr[16];
+  snprintf(instr, sizeof(instr), "EPSG:%d", srid_from);
+  snprintf(outstr, sizeof(outstr), "EPSG:%d", srid_to);
+  PJ *pj = proj_create_crs_to_crs(NULL, instr, outstr, NULL);
+  if (! pj)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Transformation between SRID %d and %d is not known to PROJ",
+      srid_from, srid_to);
+    return NULL;
+  }
+  LWPROJ *result = lwproj_from_PJ(pj, LW_FALSE);
+  if (! result)
+  {
+    proj_destroy(pj);
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "Cannot create the projection between SRID %d and %d",
+      srid_from, srid_to);
+    return NULL;
+  }
+  return result;
+}
+
+/**
+ * @brief Free a projection object that could not be cached
+ */
+static void
+meos_proj_free(LWPROJ *pj)
+{
+  proj_destroy(pj->pj);
+  lwfree(pj);
+  return;
+}
+
+/**
+ * @brief Return the projection object between two SRIDs, creating and
+ * caching it upon the first request
+ * @param[in] srid_from,srid_to SRIDs of the coordinate reference systems
+ * @param[out] cached True when the result is owned by the cache, false when
+ * the cache is full and the caller must free the result
+ */
+static LWPROJ *
+meos_proj_lookup(int32 srid_from, int32 srid_to, bool *cached)
+{
+  /* Lock-free lookup: the entries before the published count are immutable */
+  int count = __atomic_load_n(&meos_proj_count, __ATOMIC_ACQUIRE);
+  *cached = true;
+  for (int i = 0; i < count; i++)
+    if (meos_proj_cache[i].srid_from == srid_from &&
+        meos_proj_cache[i].srid_to == srid_to)
+      return meos_proj_cache[i].pj;
+
+  /* Create the projection before taking the lock */
+  LWPROJ *pj = meos_proj_create(srid_from, srid_to);
+  if (! pj)
+    return NULL;
+  pthread_mutex_lock(&meos_proj_lock);
+  /* Another thread may have inserted the same pair in the meantime */
+  count = meos_proj_count;
+  for (int i = 0; i < count; i++)
+    if (meos_proj_cache[i].srid_from == srid_from &&
+        meos_proj_cache[i].srid_to == srid_to)
+    {
+      pthread_mutex_unlock(&meos_proj_lock);
+      meos_proj_free(pj);
+      return meos_proj_cache[i].pj;
+    }
+  if (count < MEOS_PROJ_CACHE_SIZE)
+  {
+    meos_proj_cache[count].srid_from = srid_from;
+    meos_proj_cache[count].srid_to = srid_to;
+    meos_proj_cache[count].pj = pj;
+    /* Publish the entry; readers that load the new count see it filled */
+    __atomic_store_n(&meos_proj_count, count + 1, __ATOMIC_RELEASE);
+  }
+  else
+    *cached = false;
+  pthread_mutex_unlock(&meos_proj_lock);
+  return pj;
+}
+
+/**
+ * @brief Transform a temporal instant point to another SRID (iterator
+ * function)
+ */
+static TInstant *
+tpointinst_transform_iter(const TInstant *inst, int32 srid, LWPROJ *pj)
+{
+  POINT4D p;
+  datum_point4d(tinstant_value(inst), &p);
+  POINTARRAY *pa = ptarray_construct((char) MEOS_FLAGS_GET_Z(inst->flags), 0, 1);
+  ptarray_set_point4d(pa, 0, &p);
+  if (ptarray_transform(pa, pj) != LW_SUCCESS)
+  {
+    ptarray_free(pa);
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "Error when transforming point");
+    return NULL;
+  }
+  getPoint4d_p(pa, 0, &p);
+  ptarray_free(pa);
+  GSERIALIZED *gs = gspoint_make(p.x, p.y, p.z,
+    MEOS_FLAGS_GET_Z(inst->flags), MEOS_FLAGS_GET_GEODETIC(inst->flags), srid);
+  TInstant *result = tinstant_make(PointerGetDatum(gs), inst->temptype,
+    inst->t);
+  pfree(gs);
+  return result;
+}
+
+/**
+ * @brief Transform a temporal sequence point to another SRID (iterator
+ * function)
+ * @note All the points of the sequence are transformed in a SINGLE call to
+ * PROJ through a point array gathering the coordinates
+ */
+static TSequence *
+tpointseq_transform_iter(const TSequence *seq, int32 srid, LWPROJ *pj)
+{
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  bool geodetic = MEOS_FLAGS_GET_GEODETIC(seq->flags);
+  POINT4D p;
+  POINTARRAY *pa = ptarray_construct((char) hasz, 0, seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    datum_point4d(tinstant_value(TSEQUENCE_INST_N(seq, i)), &p);
+    ptarray_set_point4d(pa, i, &p);
+  }
+  if (ptarray_transform(pa, pj) != LW_SUCCESS)
+  {
+    ptarray_free(pa);
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "Error when transforming point");
+    return NULL;
+  }
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    getPoint4d_p(pa, i, &p);
+    GSERIALIZED *gs = gspoint_make(p.x, p.y, p.z, hasz, geodetic, srid);
+    instants[i] = tinstant_make(PointerGetDatum(gs), seq->temptype,
+      TSEQUENCE_INST_N(seq, i)->t);
+    pfree(gs);
+  }
+  ptarray_free(pa);
+  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
+    seq->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE_NO);
+}
+
+/**
+ * @brief Transform a temporal sequence set point to another SRID (iterator
+ * function)
+ */
+static TSequenceSet *
+tpointseqset_transform_iter(const TSequenceSet *ss, int32 srid, LWPROJ *pj)
+{
+  TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+  for (int i = 0; i < ss->count; i++)
+  {
+    sequences[i] = tpointseq_transform_iter(TSEQUENCESET_SEQ_N(ss, i), srid,
+      pj);
+    if (! sequences[i])
+    {
+      pfree_array((void **) sequences, i);
+      return NULL;
+    }
+  }
+  return tsequenceset_make_free(sequences, ss->count, NORMALIZE_NO);
+}
+
+/**
+ * @ingroup libmeos_temporal_spatial_transf
+ * @brief Transform a temporal point to another SRID.
+ * @param[in] temp Temporal point
+ * @param[in] srid SRID of the target coordinate reference system
+ * @return On error return NULL
+ * @sqlfunc transform()
+ */
+Temporal *
+tpoint_transform(const Temporal *temp, int32 srid)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_tgeo_type(temp->temptype))
+    return NULL;
+  int32 srid_from = tpoint_srid(temp);
+  if (srid_from == srid)
+    return temporal_copy(temp);
+  if (srid_from <= 0 || srid <= 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The SRID of the temporal point and the target SRID must be known");
+    return NULL;
+  }
+
+  bool cached;
+  LWPROJ *pj = meos_proj_lookup(srid_from, srid, &cached);
+  if (! pj)
+    return NULL;
+
+  Temporal *result;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    result = (Temporal *) tpointinst_transform_iter((TInstant *) temp, srid,
+      pj);
+  else if (temp->subtype == TSEQUENCE)
+    result = (Temporal *) tpointseq_transform_iter((TSequence *) temp, srid,
+      pj);
+  else /* temp->subtype == TSEQUENCESET */
+    result = (Temporal *) tpointseqset_transform_iter((TSequenceSet *) temp,
+      srid, pj);
+  if (! cached)
+    meos_proj_free(pj);
+  return result;
+}
+#endif /* MEOS */
+
 /*****************************************************************************
  * Conversion functions
  * Notice that a geometry point and a geography point are of different size
@@ -3533,7 +3782,7 @@ tpoint_grid(const Temporal *temp, const gridspec *grid, bool filter_pts)
  * @param[in] buffer Buffer distance in tile coordinate space
  * @param[in] clip_geom True if temporal point should be clipped
  */
-static Temporal *
+Temporal *
 tpoint_mvt(const Temporal *tpoint, const STBox *box, uint32_t extent,
   uint32_t buffer, bool clip_geom)
 {
@@ -4173,6 +4422,74 @@ tpointarr_round(const Temporal **temparr, int count, int maxdd)
   return result;
 }
 
+/*****************************************************************************
+ * Columnar (structure-of-arrays) extraction
+ *
+ * Temporal sequences store an array of full TInstant values and thus
+ * interleave varlena headers, flags, timestamps, and serialized points in
+ * memory. Hot loops that only need the coordinates (and possibly the
+ * timestamps) incur a cache miss per instant on long sequences. The
+ * following function gathers the coordinates into contiguous arrays in a
+ * single pass so that subsequent loops stream over cache-dense data.
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_internal_temporal_spatial_accessor
+ * @brief Extract the coordinates and optionally the timestamps of a temporal
+ * sequence point into contiguous arrays
+ * @param[in] seq Temporal sequence
+ * @param[out] x,y Arrays of X and Y coordinates, must hold `seq->count`
+ * elements
+ * @param[out] z Array of Z coordinates, may be @p NULL for 2D sequences
+ * @param[out] times Array of timestamps, may be @p NULL if not needed
+ */
+void
+tpointseq_extract_coords(const TSequence *seq, double *x, double *y,
+  double *z, TimestampTz *times)
+{
+  assert(seq); assert(x); assert(y);
+  assert(tgeo_type(seq->temptype));
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  assert(! hasz || z);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    if (hasz)
+    {
+      const POINT3DZ *p = DATUM_POINT3DZ_P(tinstant_value(inst));
+      x[i] = p->x; y[i] = p->y; z[i] = p->z;
+    }
+    else
+    {
+      const POINT2D *p = DATUM_POINT2D_P(tinstant_value(inst));
+      x[i] = p->x; y[i] = p->y;
+    }
+    if (times)
+      times[i] = inst->t;
+  }
+  return;
+}
+
+/**
+ * @ingroup libmeos_internal_temporal_spatial_accessor
+ * @brief Return an array with the points of a temporal sequence point
+ * decoded into POINT4D records
+ *
+ * Decoding the serialized points once into a contiguous array avoids
+ * re-reading the flags and coordinates of every GSERIALIZED value at each
+ * access in the loops of the spatial functions below.
+ */
+POINT4D *
+tpointseq_points(const TSequence *seq)
+{
+  assert(seq);
+  assert(tgeo_type(seq->temptype));
+  POINT4D *result = palloc(sizeof(POINT4D) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+    datum_point4d(tinstant_value(TSEQUENCE_INST_N(seq, i)), &result[i]);
+  return result;
+}
+
 /*****************************************************************************
  * Length functions
  *****************************************************************************/
@@ -4186,16 +4503,13 @@ static double
 tpointseq_length_2d(const TSequence *seq)
 {
   double result = 0;
-  Datum start = tinstant_value(TSEQUENCE_INST_N(seq, 0));
-  const POINT2D *p1 = DATUM_POINT2D_P(start);
+  double *x = palloc(sizeof(double) * seq->count * 2);
+  double *y = &x[seq->count];
+  tpointseq_extract_coords(seq, x, y, NULL, NULL);
   for (int i = 1; i < seq->count; i++)
-  {
-    Datum end = tinstant_value(TSEQUENCE_INST_N(seq, i));
-    const POINT2D *p2 = DATUM_POINT2D_P(end);
-    result += sqrt( ((p1->x - p2->x) * (p1->x - p2->x)) +
-      ((p1->y - p2->y) * (p1->y - p2->y)) );
-    p1 = p2;
-  }
+    result += sqrt( ((x[i - 1] - x[i]) * (x[i - 1] - x[i])) +
+      ((y[i - 1] - y[i]) * (y[i - 1] - y[i])) );
+  pfree(x);
   return result;
 }
 
@@ -4208,17 +4522,48 @@ static double
 tpointseq_length_3d(const TSequence *seq)
 {
   double result = 0;
-  Datum start = tinstant_value(TSEQUENCE_INST_N(seq, 0));
-  const POINT3DZ *p1 = DATUM_POINT3DZ_P(start);
+  double *x = palloc(sizeof(double) * seq->count * 3);
+  double *y = &x[seq->count];
+  double *z = &x[seq->count * 2];
+  tpointseq_extract_coords(seq, x, y, z, NULL);
+  for (int i = 1; i < seq->count; i++)
+    result += sqrt( ((x[i - 1] - x[i]) * (x[i - 1] - x[i])) +
+      ((y[i - 1] - y[i]) * (y[i - 1] - y[i])) +
+      ((z[i - 1] - z[i]) * (z[i - 1] - z[i])) );
+  pfree(x);
+  return result;
+}
+
+/**
+ * @brief Return the length traversed by a temporal sequence point with
+ * geodetic coordinates
+ *
+ * Batch kernel measuring the decoded coordinate arrays directly: every point
+ * is converted to geographic coordinates exactly once, instead of once per
+ * adjacent segment, and neither the trajectory geometry nor its LWGEOM
+ * counterpart is materialized. The per-segment distance is the same
+ * spheroidal computation used by liblwgeom, so the result is identical to
+ * measuring the trajectory.
+ * @pre The temporal point has linear interpolation and 2D coordinates
+ */
+static double
+tpointseq_length_geodetic(const TSequence *seq)
+{
+  double result = 0;
+  double *x = palloc(sizeof(double) * seq->count * 2);
+  double *y = &x[seq->count];
+  tpointseq_extract_coords(seq, x, y, NULL, NULL);
+  SPHEROID s;
+  spheroid_init(&s, WGS84_MAJOR_AXIS, WGS84_MINOR_AXIS);
+  GEOGRAPHIC_POINT g1, g2;
+  geographic_point_init(x[0], y[0], &g1);
   for (int i = 1; i < seq->count; i++)
   {
-    Datum end = tinstant_value(TSEQUENCE_INST_N(seq, i));
-    const POINT3DZ *p2 = DATUM_POINT3DZ_P(end);
-    result += sqrt( ((p1->x - p2->x)*(p1->x - p2->x)) +
-      ((p1->y - p2->y)*(p1->y - p2->y)) +
-      ((p1->z - p2->z)*(p1->z - p2->z)) );
-    p1 = p2;
+    geographic_point_init(x[i], y[i], &g2);
+    result += spheroid_distance(&g1, &g2, &s);
+    g1 = g2;
   }
+  pfree(x);
   return result;
 }
 
@@ -4241,9 +4586,14 @@ tpointseq_length(const TSequence *seq)
     return MEOS_FLAGS_GET_Z(seq->flags) ?
       tpointseq_length_3d(seq) : tpointseq_length_2d(seq);
   }
+  else if (! MEOS_FLAGS_GET_Z(seq->flags))
+  {
+    return tpointseq_length_geodetic(seq);
+  }
   else
   {
-    /* We are sure that the trajectory is a line */
+    /* For 3D geodetic coordinates the vertical component contributes to the
+     * length, so we measure the trajectory. We are sure that it is a line */
     GSERIALIZED *traj = tpointseq_cont_trajectory(seq);
     double result = gserialized_geog_length(traj, true);
     pfree(traj);
@@ -4314,26 +4664,46 @@ tpointseq_cumulative_length(const TSequence *seq, double prevlength)
     inst1 = TSEQUENCE_INST_N(seq, 0);
     TInstant *inst = tinstant_make(Float8GetDatum(prevlength), T_TFLOAT,
       inst1->t);
-    TSequence *result = tinstant_to_tsequence(inst, LINEAR);
-    pfree(inst);
+    TSequence *result = tinstant_to_tsequence_free(inst, LINEAR);
     return result;
   }
 
   /* General case */
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  datum_func2 func = pt_distance_fn(seq->flags);
-  inst1 = TSEQUENCE_INST_N(seq, 0);
-  Datum value1 = tinstant_value(inst1);
   double length = prevlength;
-  instants[0] = tinstant_make(Float8GetDatum(length), T_TFLOAT, inst1->t);
-  for (int i = 1; i < seq->count; i++)
+  if (! MEOS_FLAGS_GET_GEODETIC(seq->flags))
   {
-    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
-    Datum value2 = tinstant_value(inst2);
-    if (! datum_point_eq(value1, value2))
-      length += DatumGetFloat8(func(value1, value2));
-    instants[i] = tinstant_make(Float8GetDatum(length), T_TFLOAT, inst2->t);
-    value1 = value2;
+    /* Decode the points once and compute the distances from the array */
+    bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+    POINT4D *points = tpointseq_points(seq);
+    instants[0] = tinstant_make(Float8GetDatum(length), T_TFLOAT,
+      TSEQUENCE_INST_N(seq, 0)->t);
+    for (int i = 1; i < seq->count; i++)
+    {
+      double dx = points[i].x - points[i - 1].x;
+      double dy = points[i].y - points[i - 1].y;
+      double dz = hasz ? points[i].z - points[i - 1].z : 0.0;
+      length += sqrt(dx * dx + dy * dy + dz * dz);
+      instants[i] = tinstant_make(Float8GetDatum(length), T_TFLOAT,
+        TSEQUENCE_INST_N(seq, i)->t);
+    }
+    pfree(points);
+  }
+  else
+  {
+    datum_func2 func = pt_distance_fn(seq->flags);
+    inst1 = TSEQUENCE_INST_N(seq, 0);
+    Datum value1 = tinstant_value(inst1);
+    instants[0] = tinstant_make(Float8GetDatum(length), T_TFLOAT, inst1->t);
+    for (int i = 1; i < seq->count; i++)
+    {
+      const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+      Datum value2 = tinstant_value(inst2);
+      if (! datum_point_eq(value1, value2))
+        length += DatumGetFloat8(func(value1, value2));
+      instants[i] = tinstant_make(Float8GetDatum(length), T_TFLOAT, inst2->t);
+      value1 = value2;
+    }
   }
   return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
     seq->period.upper_inc, LINEAR, NORMALIZE);
@@ -4387,6 +4757,181 @@ tpoint_cumulative_length(const Temporal *temp)
   return result;
 }
 
+#if MEOS
+/*****************************************************************************
+ * Cumulative-length index
+ *
+ * Locating a position along a trip by traveled distance requires the
+ * cumulative length of the instants, which is linear to compute. Programs
+ * that issue many distance-parameterized queries against the same sequence
+ * build the index below once and then resolve each query with a binary
+ * search on the precomputed lengths.
+ *****************************************************************************/
+
+/**
+ * @brief Structure to represent the precomputed cumulative lengths of the
+ * instants of a temporal point sequence
+ */
+struct TPointLengthIndex
+{
+  TSequence *seq;       /**< Copy of the indexed sequence */
+  int count;            /**< Number of instants */
+  TimestampTz *times;   /**< Timestamps of the instants */
+  double *lengths;      /**< Cumulative length at each instant */
+};
+
+/**
+ * @ingroup libmeos_temporal_spatial_accessor
+ * @brief Build a cumulative-length index for a temporal point sequence.
+ * @return On error return @p NULL
+ * @see #tpointseq_length_index_timestamp_at_length
+ */
+TPointLengthIndex *
+tpointseq_length_index_make(const TSequence *seq)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) seq) || ! ensure_tgeo_type(seq->temptype))
+    return NULL;
+  if (! MEOS_FLAGS_LINEAR_INTERP(seq->flags))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The temporal point must have linear interpolation");
+    return NULL;
+  }
+
+  TPointLengthIndex *result = palloc(sizeof(TPointLengthIndex));
+  result->seq = tsequence_copy(seq);
+  result->count = seq->count;
+  result->times = palloc(sizeof(TimestampTz) * seq->count);
+  result->lengths = palloc(sizeof(double) * seq->count);
+  result->times[0] = TSEQUENCE_INST_N(seq, 0)->t;
+  result->lengths[0] = 0.0;
+  if (! MEOS_FLAGS_GET_GEODETIC(seq->flags))
+  {
+    /* Decode the points once and compute the distances from the array */
+    bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+    POINT4D *points = tpointseq_points(seq);
+    for (int i = 1; i < seq->count; i++)
+    {
+      double dx = points[i].x - points[i - 1].x;
+      double dy = points[i].y - points[i - 1].y;
+      double dz = hasz ? points[i].z - points[i - 1].z : 0.0;
+      result->times[i] = TSEQUENCE_INST_N(seq, i)->t;
+      result->lengths[i] = result->lengths[i - 1] +
+        sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    pfree(points);
+  }
+  else
+  {
+    datum_func2 func = pt_distance_fn(seq->flags);
+    Datum value1 = tinstant_value(TSEQUENCE_INST_N(seq, 0));
+    for (int i = 1; i < seq->count; i++)
+    {
+      const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+      Datum value2 = tinstant_value(inst2);
+      double length = result->lengths[i - 1];
+      if (! datum_point_eq(value1, value2))
+        length += DatumGetFloat8(func(value1, value2));
+      result->times[i] = inst2->t;
+      result->lengths[i] = length;
+      value1 = value2;
+    }
+  }
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_spatial_accessor
+ * @brief Return the total length of an indexed temporal point sequence.
+ */
+double
+tpointseq_length_index_length(const TPointLengthIndex *idx)
+{
+  assert(idx);
+  return idx->lengths[idx->count - 1];
+}
+
+/**
+ * @ingroup libmeos_temporal_spatial_accessor
+ * @brief Return the timestamp at which an indexed temporal point sequence
+ * has traveled a given length.
+ * @param[in] idx Cumulative-length index
+ * @param[in] length Traveled length
+ * @param[out] t Resulting timestamp
+ * @return Return false if the length is negative or exceeds the total
+ * length of the sequence
+ */
+bool
+tpointseq_length_index_timestamp_at_length(const TPointLengthIndex *idx,
+  double length, TimestampTz *t)
+{
+  assert(idx); assert(t);
+  if (length < 0.0 || length > idx->lengths[idx->count - 1])
+    return false;
+
+  /* Find the first instant whose cumulative length is not less than the
+   * searched length */
+  int first = 0, last = idx->count - 1;
+  while (first < last)
+  {
+    int middle = (first + last) / 2;
+    if (idx->lengths[middle] < length)
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  if (first == 0 || idx->lengths[first] == idx->lengths[first - 1])
+  {
+    *t = idx->times[first];
+    return true;
+  }
+
+  /* Interpolate the timestamp within the segment */
+  double fraction = (length - idx->lengths[first - 1]) /
+    (idx->lengths[first] - idx->lengths[first - 1]);
+  *t = idx->times[first - 1] + (TimestampTz)
+    ((idx->times[first] - idx->times[first - 1]) * fraction);
+  return true;
+}
+
+/**
+ * @ingroup libmeos_temporal_spatial_accessor
+ * @brief Return the point at which an indexed temporal point sequence has
+ * traveled a given length.
+ * @return Return @p NULL if the length is negative or exceeds the total
+ * length of the sequence
+ */
+GSERIALIZED *
+tpointseq_length_index_value_at_length(const TPointLengthIndex *idx,
+  double length)
+{
+  assert(idx);
+  TimestampTz t;
+  if (! tpointseq_length_index_timestamp_at_length(idx, length, &t))
+    return NULL;
+  Datum value;
+  tsequence_value_at_timestamp(idx->seq, t, true, &value);
+  return DatumGetGserializedP(value);
+}
+
+/**
+ * @ingroup libmeos_temporal_spatial_accessor
+ * @brief Free a cumulative-length index.
+ */
+void
+tpointseq_length_index_free(TPointLengthIndex *idx)
+{
+  if (! idx)
+    return;
+  pfree(idx->seq);
+  pfree(idx->times);
+  pfree(idx->lengths);
+  pfree(idx);
+  return;
+}
+#endif /* MEOS */
+
 /*****************************************************************************/
 
 /**
@@ -4408,6 +4953,104 @@ tpoint_convex_hull(const Temporal *temp)
   return result;
 }
 
+/*****************************************************************************
+ * Derived-channel cache
+ *****************************************************************************/
+
+/**
+ * @brief Cache of the derived channels computed from the last temporal point
+ *
+ * ETL pipelines request the speed and the azimuth of the same trips
+ * repeatedly across jobs, and both derivatives walk every segment of the
+ * trajectory on every call. The cache keeps, per derived channel, a private
+ * copy of the last parent value together with the computed channel, so that
+ * a repeated request is answered with a copy of the cached channel instead
+ * of being recomputed. Since temporal values are immutable, a modified value
+ * is a different sequence of bytes and the byte comparison of the parent is
+ * at the same time the lookup and the invalidation; the comparison is linear
+ * in the size of the value but far cheaper than the per-segment distance and
+ * angle computations it saves. The cache is thread-local since the accessors
+ * may be called from the threads of the pool, and its entries are allocated
+ * with malloc since they outlive the per-query memory contexts.
+ */
+typedef struct
+{
+  void *parent;       /**< Private copy of the parent temporal point */
+  size_t parentsize;  /**< Size of the parent in bytes */
+  void *channel;      /**< Computed derived channel */
+  size_t channelsize; /**< Size of the derived channel in bytes */
+} DerivedChannelCache;
+
+/* Derived channels kept in the cache */
+#define DERIVED_SPEED    0
+#define DERIVED_AZIMUTH  1
+#define DERIVED_CHANNELS 2
+
+static __thread DerivedChannelCache
+  _derived_channel_cache[DERIVED_CHANNELS] = { { NULL, 0, NULL, 0 } };
+
+/**
+ * @brief Empty the derived-channel cache of the current thread
+ */
+void
+meos_derived_channel_cache_clear(void)
+{
+  for (int i = 0; i < DERIVED_CHANNELS; i++)
+  {
+    DerivedChannelCache *cache = &_derived_channel_cache[i];
+    if (cache->parent)
+      free(cache->parent);
+    if (cache->channel)
+      free(cache->channel);
+    memset(cache, 0, sizeof(DerivedChannelCache));
+  }
+}
+
+/**
+ * @brief Return a copy of the cached derived channel of a temporal point or
+ * NULL when the cache holds the channel of another value
+ */
+static Temporal *
+derived_channel_cache_get(int channel, const Temporal *temp)
+{
+  DerivedChannelCache *cache = &_derived_channel_cache[channel];
+  if (! cache->parent || cache->parentsize != VARSIZE(temp) ||
+      memcmp(cache->parent, temp, cache->parentsize) != 0)
+    return NULL;
+  Temporal *result = palloc(cache->channelsize);
+  memcpy(result, cache->channel, cache->channelsize);
+  return result;
+}
+
+/**
+ * @brief Store a computed derived channel of a temporal point in the cache
+ */
+static void
+derived_channel_cache_put(int channel, const Temporal *temp,
+  const Temporal *value)
+{
+  DerivedChannelCache *cache = &_derived_channel_cache[channel];
+  void *parent = malloc(VARSIZE(temp));
+  void *result = malloc(VARSIZE(value));
+  if (! parent || ! result)
+  {
+    /* Never fail a computation for lack of cache memory */
+    free(parent); free(result);
+    return;
+  }
+  if (cache->parent)
+    free(cache->parent);
+  if (cache->channel)
+    free(cache->channel);
+  cache->parent = parent;
+  cache->parentsize = VARSIZE(temp);
+  memcpy(cache->parent, temp, cache->parentsize);
+  cache->channel = result;
+  cache->channelsize = VARSIZE(value);
+  memcpy(cache->channel, value, cache->channelsize);
+  return;
+}
+
 /*****************************************************************************
  * Speed functions
  *****************************************************************************/
@@ -4431,20 +5074,41 @@ tpointseq_speed(const TSequence *seq)
 
   /* General case */
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  datum_func2 func = pt_distance_fn(seq->flags);
-  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
-  Datum value1 = tinstant_value(inst1);
   double speed = 0.0; /* make compiler quiet */
-  for (int i = 0; i < seq->count - 1; i++)
+  if (! MEOS_FLAGS_GET_GEODETIC(seq->flags))
   {
-    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
-    Datum value2 = tinstant_value(inst2);
-    speed = datum_point_eq(value1, value2) ? 0.0 :
-      DatumGetFloat8(func(value1, value2)) /
+    /* Decode the points once and compute the distances from the array */
+    bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+    POINT4D *points = tpointseq_points(seq);
+    for (int i = 0; i < seq->count - 1; i++)
+    {
+      const TInstant *inst1 = TSEQUENCE_INST_N(seq, i);
+      const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
+      double dx = points[i + 1].x - points[i].x;
+      double dy = points[i + 1].y - points[i].y;
+      double dz = hasz ? points[i + 1].z - points[i].z : 0.0;
+      speed = sqrt(dx * dx + dy * dy + dz * dz) /
         ((double)(inst2->t - inst1->t) / 1000000.0);
-    instants[i] = tinstant_make(Float8GetDatum(speed), T_TFLOAT, inst1->t);
-    inst1 = inst2;
-    value1 = value2;
+      instants[i] = tinstant_make(Float8GetDatum(speed), T_TFLOAT, inst1->t);
+    }
+    pfree(points);
+  }
+  else
+  {
+    datum_func2 func = pt_distance_fn(seq->flags);
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+    Datum value1 = tinstant_value(inst1);
+    for (int i = 0; i < seq->count - 1; i++)
+    {
+      const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
+      Datum value2 = tinstant_value(inst2);
+      speed = datum_point_eq(value1, value2) ? 0.0 :
+        DatumGetFloat8(func(value1, value2)) /
+          ((double)(inst2->t - inst1->t) / 1000000.0);
+      instants[i] = tinstant_make(Float8GetDatum(speed), T_TFLOAT, inst1->t);
+      inst1 = inst2;
+      value1 = value2;
+    }
   }
   instants[seq->count - 1] = tinstant_make(Float8GetDatum(speed), T_TFLOAT,
     seq->period.upper);
@@ -4494,11 +5158,17 @@ tpoint_speed(const Temporal *temp)
   Temporal *result = NULL;
   assert(temptype_subtype(temp->subtype));
   if (temp->subtype == TINSTANT || ! MEOS_FLAGS_LINEAR_INTERP(temp->flags))
-    ;
-  else if (temp->subtype == TSEQUENCE)
+    return NULL;
+  /* Answer repeated requests from the derived-channel cache */
+  result = derived_channel_cache_get(DERIVED_SPEED, temp);
+  if (result)
+    return result;
+  if (temp->subtype == TSEQUENCE)
     result = (Temporal *) tpointseq_speed((TSequence *) temp);
   else /* temp->subtype == TSEQUENCESET */
     result = (Temporal *) tpointseqset_speed((TSequenceSet *) temp);
+  if (result)
+    derived_channel_cache_put(DERIVED_SPEED, temp, result);
   return result;
 }
 
@@ -4626,6 +5296,108 @@ tpoint_twcentroid(const Temporal *temp)
   return result;
 }
 
+/**
+ * @ingroup libmeos_temporal_agg
+ * @brief Return the approximate time-weighed centroid of a temporal geometry
+ * point computed from a stratified sample of its composing sequences.
+ *
+ * The composing sequences are partitioned in time order into as many strata
+ * as requested by the sample fraction and the centroid of one sequence per
+ * stratum is computed exactly, so all parts of the time extent contribute
+ * to the estimate. The reported error is the Euclidean combination of the
+ * per-coordinate half-widths of the 95% confidence intervals, in the units
+ * of the coordinates. Values that are not sequence sets, or for which the
+ * fraction does not reduce the work, are computed exactly with a zero
+ * error.
+ * @param[in] temp Temporal value
+ * @param[in] fraction Fraction of the composing sequences sampled, in (0, 1]
+ * @param[out] error Radius of the 95% confidence region, may be NULL
+ * @return On error return NULL
+ * @sqlfunc twCentroidApprox
+ */
+GSERIALIZED *
+tpoint_twcentroid_approx(const Temporal *temp, double fraction, double *error)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_tgeo_type(temp->temptype))
+    return NULL;
+  if (fraction <= 0.0 || fraction > 1.0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The sample fraction must be in (0, 1]");
+    return NULL;
+  }
+
+  if (error)
+    *error = 0.0;
+  /* The sampling strata are the composing sequences */
+  if (temp->subtype != TSEQUENCESET)
+    return tpoint_twcentroid(temp);
+  const TSequenceSet *ss = (TSequenceSet *) temp;
+  int n = (int) ceil(ss->count * fraction);
+  if (n < 2)
+    n = 2;
+  if (n >= ss->count)
+    return tpoint_twcentroid(temp);
+
+  int srid = tpointseqset_srid(ss);
+  bool hasz = MEOS_FLAGS_GET_Z(ss->flags);
+  interpType interp = MEOS_FLAGS_GET_INTERP(ss->flags);
+  /* Compute the centroid of one sequence in the middle of each stratum of
+   * consecutive sequences, weighted by its duration */
+  double *xmeans = palloc(sizeof(double) * n);
+  double *ymeans = palloc(sizeof(double) * n);
+  double *zmeans = hasz ? palloc(sizeof(double) * n) : NULL;
+  double *weights = palloc(sizeof(double) * n);
+  double sumw = 0.0, sumwx = 0.0, sumwy = 0.0, sumwz = 0.0;
+  for (int k = 0; k < n; k++)
+  {
+    int idx = (int) (((int64) (2 * k + 1) * ss->count) / (2 * n));
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, idx);
+    TSequence *seqx, *seqy, *seqz;
+    tpointseq_twcentroid_iter(seq, hasz, interp, &seqx, &seqy, &seqz);
+    xmeans[k] = tnumberseq_twavg(seqx);
+    ymeans[k] = tnumberseq_twavg(seqy);
+    if (hasz)
+      zmeans[k] = tnumberseq_twavg(seqz);
+    pfree(seqx); pfree(seqy);
+    if (hasz)
+      pfree(seqz);
+    double w = (double) (DatumGetTimestampTz(seq->period.upper) -
+      DatumGetTimestampTz(seq->period.lower));
+    /* Instantaneous sequences count with a nominal weight */
+    if (w <= 0.0)
+      w = 1.0;
+    weights[k] = w;
+    sumw += w;
+    sumwx += w * xmeans[k];
+    sumwy += w * ymeans[k];
+    if (hasz)
+      sumwz += w * zmeans[k];
+  }
+  double twavgx = sumwx / sumw;
+  double twavgy = sumwy / sumw;
+  double twavgz = hasz ? sumwz / sumw : 0.0;
+  if (error)
+  {
+    /* Weighted variance of the per-sequence centroids around the estimate,
+     * scaled by the sample size and combined over the coordinates */
+    double varx = 0.0, vary = 0.0, varz = 0.0;
+    for (int k = 0; k < n; k++)
+    {
+      varx += weights[k] * (xmeans[k] - twavgx) * (xmeans[k] - twavgx);
+      vary += weights[k] * (ymeans[k] - twavgy) * (ymeans[k] - twavgy);
+      if (hasz)
+        varz += weights[k] * (zmeans[k] - twavgz) * (zmeans[k] - twavgz);
+    }
+    *error = 1.96 * sqrt((varx + vary + varz) / sumw / n);
+  }
+  pfree(xmeans); pfree(ymeans); pfree(weights);
+  if (hasz)
+    pfree(zmeans);
+  return gspoint_make(twavgx, twavgy, twavgz, hasz, false, srid);
+}
+
 /*****************************************************************************
  * Direction
  *****************************************************************************/
@@ -4639,7 +5411,7 @@ geom_azimuth(Datum geom1, Datum geom2)
   const POINT2D *p1 = DATUM_POINT2D_P(geom1);
   const POINT2D *p2 = DATUM_POINT2D_P(geom2);
   double result;
-  azimuth_pt_pt(p1, p2, &result);
+  meos_azimuth_pt_pt(p1, p2, &result);
   return Float8GetDatum(result);
 }
 
@@ -4881,11 +5653,17 @@ tpoint_azimuth(const Temporal *temp)
   Temporal *result = NULL;
   assert(temptype_subtype(temp->subtype));
   if (temp->subtype == TINSTANT || ! MEOS_FLAGS_LINEAR_INTERP(temp->flags))
-    ;
-  else if (temp->subtype == TSEQUENCE)
+    return NULL;
+  /* Answer repeated requests from the derived-channel cache */
+  result = derived_channel_cache_get(DERIVED_AZIMUTH, temp);
+  if (result)
+    return result;
+  if (temp->subtype == TSEQUENCE)
     result = (Temporal *) tpointseq_azimuth((TSequence *) temp);
   else /* temp->subtype == TSEQUENCESET */
     result = (Temporal *) tpointseqset_azimuth((TSequenceSet *) temp);
+  if (result)
+    derived_channel_cache_put(DERIVED_AZIMUTH, temp, result);
   return result;
 }
 
@@ -5407,15 +6185,24 @@ tpointseq_stops_iter(const TSequence *seq, double maxdist, int64 mintunits,
 
   /* Use GEOS only for non-scalar input */
   bool geodetic = MEOS_FLAGS_GET_GEODETIC(seq->flags);
+  /* For planar points the bounding box of the window yields cheap bounds on
+   * the result of the exact GEOS test and the multipoint is only built for
+   * the windows whose box cannot decide */
+  bool bounds = tgeo_type(seq->temptype) && ! geodetic;
   const TInstant *inst1 = NULL, *inst2 = NULL; /* make compiler quiet */
   GEOSGeometry *geom = NULL;
   initGEOS(lwnotice, lwgeom_geos_error);
   geom = GEOSGeom_createEmptyCollection(GEOS_MULTIPOINT);
 
   int end, start = 0, nseqs = 0;
+  /* Window [geom_start, geom_end] covered by the multipoint, initially
+   * empty */
+  int geom_start = 0, geom_end = -1;
+  /* Bounding box of the window */
+  double minx = 0, maxx = 0, miny = 0, maxy = 0;
+  bool box_valid = false;
   bool  is_stopped = false,
-        previously_stopped = false,
-        rebuild_geom = false;
+        previously_stopped = false;
 
   for (end = 0; end < seq->count; ++end)
   {
@@ -5426,22 +6213,63 @@ tpointseq_stops_iter(const TSequence *seq, double maxdist, int64 mintunits,
       && (int64)(inst2->t - inst1->t) >= mintunits)
     {
       inst1 = TSEQUENCE_INST_N(seq, ++start);
-      rebuild_geom = true;
+      box_valid = false;
     }
 
-    if (rebuild_geom)
+    if (bounds)
     {
-      GEOSGeom_destroy(geom);
-      geom = multipoint_make(seq, start, end);
-      rebuild_geom = false;
+      /* Maintain the bounding box of the window, recomputing it when the
+       * window was shrunk at the start */
+      const POINT2D *pt;
+      if (! box_valid)
+      {
+        pt = DATUM_POINT2D_P(tinstant_value(TSEQUENCE_INST_N(seq, start)));
+        minx = maxx = pt->x;
+        miny = maxy = pt->y;
+        for (int i = start + 1; i <= end; ++i)
+        {
+          pt = DATUM_POINT2D_P(tinstant_value(TSEQUENCE_INST_N(seq, i)));
+          minx = fmin(minx, pt->x); maxx = fmax(maxx, pt->x);
+          miny = fmin(miny, pt->y); maxy = fmax(maxy, pt->y);
+        }
+        box_valid = true;
+      }
+      else
+      {
+        pt = DATUM_POINT2D_P(tinstant_value(inst2));
+        minx = fmin(minx, pt->x); maxx = fmax(maxx, pt->x);
+        miny = fmin(miny, pt->y); maxy = fmax(maxy, pt->y);
+      }
     }
-    else
-      geom = multipoint_add_inst_free(geom, inst2);
 
     if (end - start == 0)
       continue;
 
-    is_stopped = mrr_distance_geos(geom, geodetic) <= maxdist;
+    double dx = maxx - minx, dy = maxy - miny;
+    if (bounds && (dx > maxdist || dy > maxdist))
+      /* Two points touch opposite sides of the box, so the diameter of the
+       * window exceeds the distance */
+      is_stopped = false;
+    else if (bounds && 2.0 * (dx * dx + dy * dy) <= maxdist * maxdist)
+      /* The sides of the minimum rotated rectangle are bounded by the
+       * diameter, which is bounded by the box diagonal, so its diagonal is
+       * at most sqrt(2) times the box diagonal */
+      is_stopped = true;
+    else
+    {
+      /* Exact test: bring the multipoint up to date with the window */
+      if (geom_start == start && geom_end == end - 1)
+        geom = multipoint_add_inst_free(geom, inst2);
+      else
+      {
+        GEOSGeom_destroy(geom);
+        geom = multipoint_make(seq, start, end);
+      }
+      geom_start = start;
+      geom_end = end;
+      is_stopped = mrr_distance_geos(geom, geodetic) <= maxdist;
+    }
+
     inst2 = TSEQUENCE_INST_N(seq, end - 1);
     if (! is_stopped && previously_stopped
       && (int64)(inst2->t - inst1->t) >= mintunits) // Found a stop
@@ -5452,7 +6280,7 @@ tpointseq_stops_iter(const TSequence *seq, double maxdist, int64 mintunits,
       result[nseqs++] = tsequence_make(insts, end - start,
         true, true, LINEAR, NORMALIZE_NO);
       start = end;
-      rebuild_geom = true;
+      box_valid = false;
     }
     previously_stopped = is_stopped;
   }
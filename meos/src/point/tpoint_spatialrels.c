@@ -601,16 +601,103 @@ edwithin_tpointseq_tpointseq_discstep(const TSequence *seq1,
   return false;
 }
 
+#if MEOS_FLOAT_PREFILTER
+/**
+ * @brief Mark the segment pairs of two synchronized sequences that may come
+ * within the given distance (single-precision prefilter kernel)
+ *
+ * The arrays hold the relative coordinates of the two points at the shared
+ * timestamps. The relative motion is linear inside a segment, so the minimum
+ * distance over a segment is the distance from the origin to the relative
+ * segment, computed here in single precision over contiguous lanes that the
+ * compiler can vectorize twice as wide as the double kernels. The threshold
+ * passed by the caller is inflated to absorb the rounding of the narrow
+ * lanes, so the prefilter never discards a true candidate.
+ */
+static void
+edwithin_prefilter_batch(const float *restrict rx, const float *restrict ry,
+  const float *restrict rz, int count, float dist, bool *restrict cand)
+{
+  float dist2 = dist * dist;
+  for (int i = 0; i < count - 1; i++)
+  {
+    float px = rx[i], py = ry[i], pz = rz ? rz[i] : 0.0f;
+    float vx = rx[i + 1] - px, vy = ry[i + 1] - py,
+      vz = rz ? rz[i + 1] - pz : 0.0f;
+    float vv = vx * vx + vy * vy + vz * vz;
+    float s = (vv > 0.0f) ? - (px * vx + py * vy + pz * vz) / vv : 0.0f;
+    s = (s < 0.0f) ? 0.0f : ((s > 1.0f) ? 1.0f : s);
+    float mx = px + s * vx, my = py + s * vy, mz = pz + s * vz;
+    cand[i] = (mx * mx + my * my + mz * mz) <= dist2;
+  }
+  return;
+}
+
+/**
+ * @brief Return the candidate segment pairs of two synchronized continuous
+ * sequences for the dwithin functions, or NULL when the prefilter does not
+ * apply
+ */
+static bool *
+edwithin_prefilter(const TSequence *seq1, const TSequence *seq2, double dist)
+{
+  /* The relative-segment bound is Euclidean and thus does not apply to
+   * geographies, whose dwithin distance is measured on the sphere */
+  if (MEOS_FLAGS_GET_GEODETIC(seq1->flags) ||
+      ! MEOS_FLAGS_LINEAR_INTERP(seq1->flags) ||
+      ! MEOS_FLAGS_LINEAR_INTERP(seq2->flags) || seq1->count < 2)
+    return NULL;
+  int count = seq1->count;
+  bool hasz = MEOS_FLAGS_GET_Z(seq1->flags);
+  float *rx = palloc(sizeof(float) * count * (hasz ? 3 : 2));
+  float *ry = &rx[count], *rz = hasz ? &rx[count * 2] : NULL;
+  /* The differences are taken in double precision before narrowing, so the
+   * rounding is relative to the distance between the points rather than to
+   * their absolute coordinates */
+  float maxmag = 0.0f;
+  for (int i = 0; i < count; i++)
+  {
+    Datum value1 = tinstant_value(TSEQUENCE_INST_N(seq1, i));
+    Datum value2 = tinstant_value(TSEQUENCE_INST_N(seq2, i));
+    if (hasz)
+    {
+      const POINT3DZ *p1 = DATUM_POINT3DZ_P(value1);
+      const POINT3DZ *p2 = DATUM_POINT3DZ_P(value2);
+      rx[i] = (float) (p1->x - p2->x);
+      ry[i] = (float) (p1->y - p2->y);
+      rz[i] = (float) (p1->z - p2->z);
+      maxmag = Max(maxmag, fabsf(rz[i]));
+    }
+    else
+    {
+      const POINT2D *p1 = DATUM_POINT2D_P(value1);
+      const POINT2D *p2 = DATUM_POINT2D_P(value2);
+      rx[i] = (float) (p1->x - p2->x);
+      ry[i] = (float) (p1->y - p2->y);
+    }
+    maxmag = Max(maxmag, Max(fabsf(rx[i]), fabsf(ry[i])));
+  }
+  bool *result = palloc(sizeof(bool) * (count - 1));
+  edwithin_prefilter_batch(rx, ry, rz, count,
+    (float) dist + maxmag * 1e-5f, result);
+  pfree(rx);
+  return result;
+}
+#endif /* MEOS_FLOAT_PREFILTER */
+
 /**
  * @brief Return true if the temporal points are ever within the given distance
  * @param[in] seq1,seq2 Temporal points
  * @param[in] dist Distance
  * @param[in] func DWithin function (2D or 3D)
+ * @param[in] candidate Segment pairs selected by the single-precision
+ * prefilter, may be @p NULL when the prefilter is disabled or does not apply
  * @pre The temporal points are synchronized
  */
 static bool
-edwithin_tpointseq_tpointseq_cont(const TSequence *seq1, const TSequence *seq2,
-  double dist, datum_func3 func)
+edwithin_tpointseq_tpointseq_cont1(const TSequence *seq1,
+  const TSequence *seq2, double dist, datum_func3 func,
+  const bool *candidate)
 {
   const TInstant *start1, *start2;
   if (seq1->count == 1)
@@ -639,6 +726,17 @@ edwithin_tpointseq_tpointseq_cont(const TSequence *seq1, const TSequence *seq2,
     TimestampTz upper = end1->t;
     bool upper_inc = (i == seq1->count - 1) ? seq1->period.upper_inc : false;
 
+    /* Skip the segments which the prefilter proved never come within the
+     * distance */
+    if (candidate && ! candidate[i - 1])
+    {
+      sv1 = ev1;
+      sv2 = ev2;
+      lower = upper;
+      lower_inc = true;
+      continue;
+    }
+
     /* Both segments are constant */
     if (datum_point_eq(sv1, ev1) && datum_point_eq(sv2, ev2) &&
         DatumGetBool(func(sv1, sv2, Float8GetDatum(dist))))
@@ -667,6 +765,29 @@ edwithin_tpointseq_tpointseq_cont(const TSequence *seq1, const TSequence *seq2,
   return false;
 }
 
+/**
+ * @brief Return true if the temporal points are ever within the given distance
+ * @param[in] seq1,seq2 Temporal points
+ * @param[in] dist Distance
+ * @param[in] func DWithin function (2D or 3D)
+ * @pre The temporal points are synchronized
+ */
+static bool
+edwithin_tpointseq_tpointseq_cont(const TSequence *seq1, const TSequence *seq2,
+  double dist, datum_func3 func)
+{
+#if MEOS_FLOAT_PREFILTER
+  bool *candidate = edwithin_prefilter(seq1, seq2, dist);
+  bool result = edwithin_tpointseq_tpointseq_cont1(seq1, seq2, dist, func,
+    candidate);
+  if (candidate)
+    pfree(candidate);
+  return result;
+#else
+  return edwithin_tpointseq_tpointseq_cont1(seq1, seq2, dist, func, NULL);
+#endif /* MEOS_FLOAT_PREFILTER */
+}
+
 /**
  * @brief Return true if the temporal points are ever within the given distance
  * @param[in] ss1,ss2 Temporal points
@@ -80,6 +80,9 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/lifting.h"
+#if MEOS
+  #include "general/pool.h"
+#endif
 #include "general/spanset.h"
 #include "general/temporaltypes.h"
 #include "general/tbool_boolops.h"
@@ -309,8 +312,7 @@ tinterrel_tpointseq_cont_geom_iter(const TSequence *seq, Datum geom,
     TInstant *inst = tinterrel_tpointinst_geom(TSEQUENCE_INST_N(seq, 0),
       geom, tinter, func);
     TSequence **result = palloc(sizeof(TSequence *));
-    result[0] = tinstant_to_tsequence(inst, STEP);
-    pfree(inst);
+    result[0] = tinstant_to_tsequence_free(inst, STEP);
     *count = 1;
     return result;
   }
@@ -745,6 +747,51 @@ tdwithin_tpointsegm_tpointsegm(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
   }
 }
 
+/**
+ * @brief Return true if the bounding boxes of two segments are separated by
+ * more than the given distance
+ * @param[in] sv1,ev1 Points defining the first segment
+ * @param[in] sv2,ev2 Points defining the second segment
+ * @param[in] hasz True for 3D segments
+ * @param[in] dist Distance
+ * @note The distance between the axis-aligned bounding boxes of the segments
+ * is a lower bound of the distance between the moving points in the metric
+ * used by #tdwithin_tpointsegm_tpointsegm. Therefore, when the function
+ * returns true the quadratic equation has no solution within the segments
+ * and solving it can be skipped altogether.
+ */
+static bool
+tdwithin_tpointsegm_bbox_far(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
+  bool hasz, double dist)
+{
+  double dx, dy, dz = 0.0;
+  if (hasz) /* 3D */
+  {
+    const POINT3DZ *p1 = DATUM_POINT3DZ_P(sv1);
+    const POINT3DZ *p2 = DATUM_POINT3DZ_P(ev1);
+    const POINT3DZ *p3 = DATUM_POINT3DZ_P(sv2);
+    const POINT3DZ *p4 = DATUM_POINT3DZ_P(ev2);
+    dx = Max(0.0, Max(Min(p1->x, p2->x) - Max(p3->x, p4->x),
+      Min(p3->x, p4->x) - Max(p1->x, p2->x)));
+    dy = Max(0.0, Max(Min(p1->y, p2->y) - Max(p3->y, p4->y),
+      Min(p3->y, p4->y) - Max(p1->y, p2->y)));
+    dz = Max(0.0, Max(Min(p1->z, p2->z) - Max(p3->z, p4->z),
+      Min(p3->z, p4->z) - Max(p1->z, p2->z)));
+  }
+  else /* 2D */
+  {
+    const POINT2D *p1 = DATUM_POINT2D_P(sv1);
+    const POINT2D *p2 = DATUM_POINT2D_P(ev1);
+    const POINT2D *p3 = DATUM_POINT2D_P(sv2);
+    const POINT2D *p4 = DATUM_POINT2D_P(ev2);
+    dx = Max(0.0, Max(Min(p1->x, p2->x) - Max(p3->x, p4->x),
+      Min(p3->x, p4->x) - Max(p1->x, p2->x)));
+    dy = Max(0.0, Max(Min(p1->y, p2->y) - Max(p3->y, p4->y),
+      Min(p3->y, p4->y) - Max(p1->y, p2->y)));
+  }
+  return (dx * dx + dy * dy + dz * dz) > (dist * dist);
+}
+
 /**
  * @brief Construct the result of the tdwithin function of a segment from
  * the solutions of the quadratic equation found previously
@@ -798,6 +845,66 @@ tdwithin_add_solutions(int solutions, TimestampTz lower, TimestampTz upper,
   return nseqs;
 }
 
+#if MEOS
+/**
+ * @brief Task solving the distance equations of a batch of segment pairs on
+ * the thread pool
+ */
+typedef struct
+{
+  const TSequence *seq1;  /**< First temporal point */
+  const TSequence *seq2;  /**< Second temporal point */
+  double dist;            /**< Distance */
+  bool hasz;              /**< True for 3D points */
+  bool linear1;           /**< True when the first sequence is linear */
+  bool linear2;           /**< True when the second sequence is linear */
+  datum_func3 func;       /**< DWithin function (2D or 3D) */
+  int8 *solutions;        /**< Number of solutions, -1 for constant segments */
+  TimestampTz *t1;        /**< First solution of each segment */
+  TimestampTz *t2;        /**< Second solution of each segment */
+} TdwithinBatchTask;
+
+/**
+ * @brief Solve the distance equation of the segment pair starting at the
+ * given instant, task function executed on the thread pool
+ *
+ * The equation of every pair of synchronized segments is independent numeric
+ * work, so for long sequences the solutions are computed in bulk before the
+ * sequential construction of the result sequences.
+ */
+static void
+tdwithin_tpointsegm_batch_task(void *arg, int idx)
+{
+  TdwithinBatchTask *task = (TdwithinBatchTask *) arg;
+  const TInstant *start1 = TSEQUENCE_INST_N(task->seq1, idx);
+  const TInstant *start2 = TSEQUENCE_INST_N(task->seq2, idx);
+  const TInstant *end1 = TSEQUENCE_INST_N(task->seq1, idx + 1);
+  const TInstant *end2 = TSEQUENCE_INST_N(task->seq2, idx + 1);
+  Datum sv1 = tinstant_value(start1);
+  Datum sv2 = tinstant_value(start2);
+  Datum ev1 = tinstant_value(end1);
+  Datum ev2 = tinstant_value(end2);
+  /* Constant segments are handled by the sequential loop */
+  if (datum_point_eq(sv1, ev1) && datum_point_eq(sv2, ev2))
+  {
+    task->solutions[idx] = -1;
+    return;
+  }
+  Datum sev1 = task->linear1 ? ev1 : sv1;
+  Datum sev2 = task->linear2 ? ev2 : sv2;
+  TimestampTz t1 = 0, t2 = 0;
+  /* Solve the quadratic equation only when the bounding boxes of the
+   * segments are not farther apart than the distance */
+  task->solutions[idx] = tdwithin_tpointsegm_bbox_far(sv1, sev1, sv2, sev2,
+      task->hasz, task->dist) ? 0 :
+    (int8) tdwithin_tpointsegm_tpointsegm(sv1, sev1, sv2, sev2, start1->t,
+      end1->t, task->dist, task->hasz, task->func, &t1, &t2);
+  task->t1[idx] = t1;
+  task->t2[idx] = t2;
+  return;
+}
+#endif /* MEOS */
+
 /**
  * @brief Return the timestamps at which the segments of two temporal points are
  * within the given distance (iterator function)
@@ -819,8 +926,7 @@ tdwithin_tpointseq_tpointseq_iter(const TSequence *seq1, const TSequence *seq2,
   {
     TInstant *inst = tinstant_make(func(tinstant_value(start1),
       tinstant_value(start2), dist), T_TBOOL, start1->t);
-    result[0] = tinstant_to_tsequence(inst, STEP);
-    pfree(inst);
+    result[0] = tinstant_to_tsequence_free(inst, STEP);
     return 1;
   }
 
@@ -840,6 +946,21 @@ tdwithin_tpointseq_tpointseq_iter(const TSequence *seq1, const TSequence *seq2,
   instants[0] = tinstant_make(datum_true, T_TBOOL, lower);
   instants[1] = tinstant_copy(instants[0]);
   instants[2] = tinstant_copy(instants[0]);
+#if MEOS
+  /* Solve the segment equations in bulk on the thread pool */
+  int8 *batch = NULL;
+  TimestampTz *batch_t1 = NULL, *batch_t2 = NULL;
+  if (meos_pool_active())
+  {
+    batch = palloc(sizeof(int8) * (seq1->count - 1));
+    batch_t1 = palloc(sizeof(TimestampTz) * (seq1->count - 1));
+    batch_t2 = palloc(sizeof(TimestampTz) * (seq1->count - 1));
+    TdwithinBatchTask task = { seq1, seq2, DatumGetFloat8(dist), hasz,
+      linear1, linear2, func, batch, batch_t1, batch_t2 };
+    meos_pool_parallel_for(seq1->count - 1, &tdwithin_tpointsegm_batch_task,
+      &task);
+  }
+#endif /* MEOS */
   for (int i = 1; i < seq1->count; i++)
   {
     /* Each iteration of the for loop adds between one and three sequences */
@@ -867,8 +988,23 @@ tdwithin_tpointseq_tpointseq_iter(const TSequence *seq1, const TSequence *seq2,
       TimestampTz t1, t2;
       Datum sev1 = linear1 ? ev1 : sv1;
       Datum sev2 = linear2 ? ev2 : sv2;
-      int solutions = tdwithin_tpointsegm_tpointsegm(sv1, sev1, sv2, sev2,
-        lower, upper, DatumGetFloat8(dist), hasz, func, &t1, &t2);
+      int solutions;
+#if MEOS
+      if (batch)
+      {
+        /* The solutions were computed in bulk on the thread pool */
+        solutions = batch[i - 1];
+        t1 = batch_t1[i - 1];
+        t2 = batch_t2[i - 1];
+      }
+      else
+#endif /* MEOS */
+      /* Solve the quadratic equation only when the bounding boxes of the
+       * segments are not farther apart than the distance */
+      solutions = tdwithin_tpointsegm_bbox_far(sv1, sev1, sv2, sev2, hasz,
+          DatumGetFloat8(dist)) ? 0 :
+        tdwithin_tpointsegm_tpointsegm(sv1, sev1, sv2, sev2,
+          lower, upper, DatumGetFloat8(dist), hasz, func, &t1, &t2);
       bool upper_inc1 = linear1 && linear2 && upper_inc;
       nseqs += tdwithin_add_solutions(solutions, lower, upper, lower_inc,
         upper_inc, upper_inc1, t1, t2, instants, &result[nseqs]);
@@ -885,6 +1021,12 @@ tdwithin_tpointseq_tpointseq_iter(const TSequence *seq1, const TSequence *seq2,
     lower = upper;
     lower_inc = true;
   }
+#if MEOS
+  if (batch)
+  {
+    pfree(batch); pfree(batch_t1); pfree(batch_t2);
+  }
+#endif /* MEOS */
   pfree(instants[0]); pfree(instants[1]); pfree(instants[2]);
   return nseqs;
 }
@@ -960,8 +1102,7 @@ tdwithin_tpointseq_point_iter(const TSequence *seq, Datum point, Datum dist,
   {
     TInstant *inst = tinstant_make(func(startvalue, point, dist), T_TBOOL,
       start->t);
-    result[0] = tinstant_to_tsequence(inst, STEP);
-    pfree(inst);
+    result[0] = tinstant_to_tsequence_free(inst, STEP);
     return 1;
   }
 
@@ -1007,8 +1148,12 @@ tdwithin_tpointseq_point_iter(const TSequence *seq, Datum point, Datum dist,
       /* Find the instants t1 and t2 (if any) during which the dwithin
        * function is true */
       TimestampTz t1, t2;
-      int solutions = tdwithin_tpointsegm_tpointsegm(startvalue, endvalue,
-        point, point, lower, upper, DatumGetFloat8(dist), hasz, func, &t1, &t2);
+      /* Solve the quadratic equation only when the bounding boxes of the
+       * segment and the point are not farther apart than the distance */
+      int solutions = tdwithin_tpointsegm_bbox_far(startvalue, endvalue,
+          point, point, hasz, DatumGetFloat8(dist)) ? 0 :
+        tdwithin_tpointsegm_tpointsegm(startvalue, endvalue,
+          point, point, lower, upper, DatumGetFloat8(dist), hasz, func, &t1, &t2);
       bool upper_inc1 = linear && upper_inc;
       nseqs += tdwithin_add_solutions(solutions, lower, upper, lower_inc,
         upper_inc, upper_inc1, t1, t2, instants, &result[nseqs]);
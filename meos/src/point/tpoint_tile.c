@@ -34,6 +34,11 @@
 
 /* C */
 #include <assert.h>
+#if MEOS
+/* POSIX */
+#include <pthread.h>
+#include <unistd.h>
+#endif /* MEOS */
 /* PostgreSQL */
 #include <float.h>
 #include <postgres.h>
@@ -43,63 +48,96 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/interrupt.h"
 #include "general/temporaltypes.h"
 #include "general/temporal_tile.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_tile.h"
 
 /*****************************************************************************
- * Bit Matrix implementation based on
- * https://www.pvladov.com/2012/05/bit-matrix-in-c-sharp.html
+ * Bit Matrix implementation storing the bits in a sparse array of fixed-size
+ * chunks. A chunk is allocated the first time a bit in it is set and thus,
+ * splitting a temporal point over a fine grid only allocates memory
+ * proportional to the cells traversed by the trajectory instead of the full
+ * grid
  *****************************************************************************/
 
 /**
- * @brief Create a bit matrix
+ * @brief Create a bit matrix with all bits set to 0
  */
 BitMatrix *
 bitmatrix_make(int *count, int ndims)
 {
-  /* Calculate the needed number of bits and bytes */
-  int i, bitCount = 1;
+  /* Calculate the needed number of bits and chunks */
+  int i;
+  uint64 bitCount = 1;
   for (i = 0; i < ndims; i++)
-    bitCount *= count[i];
-  int byteCount = bitCount >> 3;
-  if (bitCount % 8 != 0)
-    byteCount++;
-  /* Allocate the needed number of bytes taking into account that there is
-   * already one byte allocated in the struct */
-  size_t size = sizeof(BitMatrix) + byteCount - 1;
-  /* palloc0 to set all bits to 0 */
-  BitMatrix *result = palloc0(size);
-  /* Fill the structure */
+    bitCount *= (uint64) count[i];
+  uint64 chunkCount = (bitCount + BITMATRIX_CHUNK_BITS - 1) /
+    BITMATRIX_CHUNK_BITS;
+  BitMatrix *result = palloc0(sizeof(BitMatrix));
+  /* Fill the structure, the chunks are allocated lazily when a bit in them
+   * is first set */
   result->ndims = ndims;
   for (i = 0; i < ndims; i++)
     result->count[i] = count[i];
+  result->nchunks = chunkCount;
+  result->chunks = palloc0(sizeof(uint8_t *) * chunkCount);
   return result;
 }
 
 /**
- * @brief Get the value of the bit in the bit matrix
+ * @brief Free a bit matrix and the chunks allocated for it
  */
-static bool
-bitmatrix_get(const BitMatrix *bm, int *coords)
+void
+bitmatrix_free(BitMatrix *bm)
+{
+  for (uint64 i = 0; i < bm->nchunks; i++)
+  {
+    if (bm->chunks[i])
+      pfree(bm->chunks[i]);
+  }
+  pfree(bm->chunks);
+  pfree(bm);
+  return;
+}
+
+/**
+ * @brief Compute the position of the bit corresponding to the coordinates
+ * in the row-major linearization of the bit matrix
+ */
+static uint64
+bitmatrix_position(const BitMatrix *bm, int *coords)
 {
   int i, j;
   for (i = 0; i < bm->ndims; i++)
     assert(coords[i] <= bm->count[i]);
-  int pos = 0;
+  uint64 pos = 0;
   for (i = 0; i < bm->ndims; i++)
   {
-    int offset = coords[i];
+    uint64 offset = (uint64) coords[i];
     for (j = i + 1; j < bm->ndims; j++)
-    {
-      offset *= bm->count[j];
-    }
+      offset *= (uint64) bm->count[j];
     pos += offset;
   }
+  return pos;
+}
+
+/**
+ * @brief Get the value of the bit in the bit matrix
+ */
+static bool
+bitmatrix_get(const BitMatrix *bm, int *coords)
+{
+  uint64 pos = bitmatrix_position(bm, coords);
+  const uint8_t *chunk = bm->chunks[pos / BITMATRIX_CHUNK_BITS];
+  /* A chunk that was never allocated has all its bits set to 0 */
+  if (chunk == NULL)
+    return false;
+  pos %= BITMATRIX_CHUNK_BITS;
   int index = pos % 8;
   pos >>= 3;
-  return (bm->byte[pos] & (((uint8_t)1) << index)) != 0;
+  return (chunk[pos] & (((uint8_t)1) << index)) != 0;
 }
 
 /**
@@ -108,22 +146,23 @@ bitmatrix_get(const BitMatrix *bm, int *coords)
 static void
 bitmatrix_set_cell(BitMatrix *bm, int *coords, bool value)
 {
-  int i, j, pos = 0;
-  for (i = 0; i < bm->ndims; i++)
-    assert(coords[i] <= bm->count[i]);
-  for (i = 0; i < bm->ndims - 1; i++)
+  uint64 pos = bitmatrix_position(bm, coords);
+  uint8_t *chunk = bm->chunks[pos / BITMATRIX_CHUNK_BITS];
+  if (chunk == NULL)
   {
-    int offset = coords[i];
-    for (j = i + 1; j < bm->ndims; j++)
-      offset *= bm->count[j];
-    pos += offset;
+    /* Setting a bit to 0 in a chunk that was never allocated is a no-op */
+    if (! value)
+      return;
+    /* palloc0 to set all bits of the chunk to 0 */
+    chunk = palloc0(BITMATRIX_CHUNK_BITS / 8);
+    bm->chunks[pos / BITMATRIX_CHUNK_BITS] = chunk;
   }
-  pos += coords[bm->ndims - 1];
+  pos %= BITMATRIX_CHUNK_BITS;
   int index = pos % 8;
   pos >>= 3;
-  bm->byte[pos] &= (unsigned char)(~(1 << index));
+  chunk[pos] &= (unsigned char)(~(1 << index));
   if (value)
-    bm->byte[pos] |= (uint8_t)(1 << index);
+    chunk[pos] |= (uint8_t)(1 << index);
   return;
 }
 
@@ -875,6 +914,110 @@ tpoint_set_tiles(const Temporal *temp, const STboxGridState *state,
 
 /*****************************************************************************/
 #if MEOS
+
+/* Number of tiles from which the split is done with multiple threads */
+#define MEOS_PARALLEL_TILE_MIN 64
+/* Maximum number of threads used to split a temporal point over a grid */
+#define MEOS_PARALLEL_TILE_MAXTHREADS 8
+
+/**
+ * Structure shared by the threads splitting a temporal point over a grid
+ */
+typedef struct
+{
+  const Temporal *temp;  /**< Temporal point to split */
+  const STBox *boxes;    /**< Tiles of the grid */
+  Temporal **result;     /**< Restriction to each tile, may be NULL */
+  int count;             /**< Number of tiles */
+  int next;              /**< Next tile to process, protected by the mutex */
+  pthread_mutex_t mutex; /**< Mutex protecting the next tile counter */
+} TileSweepState;
+
+/**
+ * @brief Worker function restricting the temporal point to the tiles that
+ * the other workers have not yet claimed
+ */
+static void *
+tpoint_tile_split_worker(void *arg)
+{
+  TileSweepState *state = (TileSweepState *) arg;
+  while (true)
+  {
+    pthread_mutex_lock(&state->mutex);
+    int i = state->next++;
+    pthread_mutex_unlock(&state->mutex);
+    if (i >= state->count)
+      break;
+    state->result[i] = tpoint_restrict_stbox(state->temp, &state->boxes[i],
+      BORDER_EXC, REST_AT);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Restrict a temporal point to all the tiles of a grid in one sweep
+ *
+ * The restrictions to the tiles are independent of each other and are
+ * partitioned dynamically across a team of threads, the calling thread being
+ * one of the workers. The sweep is done serially for small grids, when the
+ * arena allocator is active (its allocation path is not thread-safe), or
+ * when thread creation fails.
+ * @return False when the serial sweep was canceled by the interrupt
+ * callback. The parallel sweep is not interruptible since errors cannot be
+ * raised from the worker threads.
+ */
+static bool
+tpoint_tile_split_sweep(const Temporal *temp, const STBox *boxes, int count,
+  Temporal **result)
+{
+  TileSweepState state;
+  state.temp = temp;
+  state.boxes = boxes;
+  state.result = result;
+  state.count = count;
+  state.next = 0;
+
+  int nthreads = 1;
+  if (count >= MEOS_PARALLEL_TILE_MIN && ! meos_arena_active())
+  {
+    long ncores = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = Min((int) Max(ncores, 1), MEOS_PARALLEL_TILE_MAXTHREADS);
+  }
+  if (nthreads == 1)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (meos_interrupt_check())
+      {
+        for (int j = 0; j < i; j++)
+          if (result[j])
+            pfree(result[j]);
+        return false;
+      }
+      meos_progress_report((double) i / count);
+      result[i] = tpoint_restrict_stbox(temp, &boxes[i], BORDER_EXC, REST_AT);
+    }
+    return true;
+  }
+
+  pthread_mutex_init(&state.mutex, NULL);
+  pthread_t threads[MEOS_PARALLEL_TILE_MAXTHREADS];
+  int ncreated = 0;
+  for (int i = 0; i < nthreads - 1; i++)
+  {
+    if (pthread_create(&threads[ncreated], NULL, &tpoint_tile_split_worker,
+        &state) != 0)
+      break;
+    ncreated++;
+  }
+  /* The calling thread processes tiles alongside the created threads */
+  tpoint_tile_split_worker(&state);
+  for (int i = 0; i < ncreated; i++)
+    pthread_join(threads[i], NULL);
+  pthread_mutex_destroy(&state.mutex);
+  return true;
+}
+
 /**
  * @brief Split a temporal value with respect to a space and possibly time grid
  */
@@ -973,6 +1116,39 @@ tpoint_space_time_split(Temporal *temp, float xsize, float ysize, float zsize,
       ntiles *= count[j++];
   }
 
+  /* Enumerate the tiles of the grid
+   * It is necessary to test if we found a tile since the previous tile
+   * may be the last one set in the associated bit matrix */
+  STBox *boxes = palloc(sizeof(STBox) * ntiles);
+  int nboxes = 0;
+  while (! state->done)
+  {
+    if (meos_interrupt_check())
+    {
+      if (state->bm)
+        bitmatrix_free(state->bm);
+      pfree(boxes); pfree(state);
+      return NULL;
+    }
+    if (! stbox_tile_state_get(state, &boxes[nboxes]))
+      break;
+    nboxes++;
+    stbox_tile_state_next(state);
+  }
+  if (state->bm)
+    bitmatrix_free(state->bm);
+
+  /* Restrict the temporal point to all the tiles in one, possibly
+   * multi-threaded, sweep */
+  Temporal **attiles = palloc(sizeof(Temporal *) * ntiles);
+  if (! tpoint_tile_split_sweep(state->temp, boxes, nboxes, attiles))
+  {
+    pfree(attiles); pfree(boxes); pfree(state);
+    return NULL;
+  }
+
+  /* Assemble the values of the result, skipping the tiles for which atStbox
+   * was NULL */
   GSERIALIZED **spaces = palloc(sizeof(GSERIALIZED *) * ntiles);
   TimestampTz *times = NULL;
   if (timesplit)
@@ -980,44 +1156,21 @@ tpoint_space_time_split(Temporal *temp, float xsize, float ysize, float zsize,
   Temporal **result = palloc(sizeof(Temporal *) * ntiles);
   hasz = MEOS_FLAGS_GET_Z(state->temp->flags);
   int i = 0;
-  /* We need to loop since atStbox may be NULL */
-  while (true)
+  for (int j = 0; j < nboxes; j++)
   {
-    /* Stop when we have used up all the grid tiles */
-    if (state->done)
-    {
-      if (state->bm)
-         pfree(state->bm);
-      pfree(state);
-      break;
-    }
-
-    /* Get current tile (if any) and advance state
-     * It is necessary to test if we found a tile since the previous tile
-     * may be the last one set in the associated bit matrix */
-    STBox box;
-    bool found = stbox_tile_state_get(state, &box);
-    if (! found)
-    {
-      if (state->bm) pfree(state->bm);
-      pfree(state);
-      break;
-    }
-    stbox_tile_state_next(state);
-
-    /* Restrict the temporal point to the box */
-    Temporal *atstbox = tpoint_restrict_stbox(state->temp, &box, BORDER_EXC,
-      REST_AT);
-    if (atstbox == NULL)
+    if (attiles[j] == NULL)
       continue;
 
     /* Construct value of the result */
-    spaces[i] = gspoint_make(box.xmin, box.ymin, box.zmin, hasz,
-      false, box.srid);
+    spaces[i] = gspoint_make(boxes[j].xmin, boxes[j].ymin, boxes[j].zmin,
+      hasz, false, boxes[j].srid);
     if (timesplit)
-      times[i] = DatumGetTimestampTz(box.period.lower);
-    result[i++] = atstbox;
+      times[i] = DatumGetTimestampTz(boxes[j].period.lower);
+    result[i++] = attiles[j];
   }
+  pfree(attiles);
+  pfree(boxes);
+  pfree(state);
   *newcount = i;
   if (space_buckets)
     *space_buckets = spaces;
@@ -1025,6 +1178,452 @@ tpoint_space_time_split(Temporal *temp, float xsize, float ysize, float zsize,
     *time_buckets = times;
   return result;
 }
+
+/*****************************************************************************/
+
+/** Maximum number of levels of a tile pyramid */
+#define MEOS_TILE_MAXLEVELS 16
+
+/**
+ * @brief Grouping key of a tile fragment under its parent tile
+ */
+typedef struct
+{
+  double x;           /**< X coordinate of the parent tile */
+  double y;           /**< Y coordinate of the parent tile */
+  double z;           /**< Z coordinate of the parent tile */
+  TimestampTz t;      /**< Time bucket, kept fixed across the levels */
+  int idx;            /**< Index of the child fragment */
+} STboxPyramidCell;
+
+/**
+ * @brief Comparator grouping the fragments of the same parent tile together
+ * @note The parent coordinates of sibling fragments are produced by
+ * identical #float_bucket computations and thus compare exactly equal
+ */
+static int
+stbox_pyramid_cell_cmp(const void *a, const void *b)
+{
+  const STboxPyramidCell *c1 = (const STboxPyramidCell *) a;
+  const STboxPyramidCell *c2 = (const STboxPyramidCell *) b;
+  if (c1->t != c2->t)
+    return (c1->t < c2->t) ? -1 : 1;
+  if (c1->x != c2->x)
+    return (c1->x < c2->x) ? -1 : 1;
+  if (c1->y != c2->y)
+    return (c1->y < c2->y) ? -1 : 1;
+  if (c1->z != c2->z)
+    return (c1->z < c2->z) ? -1 : 1;
+  return 0;
+}
+
+/**
+ * @brief Split a temporal value with respect to a pyramid of space and
+ * possibly time grids, producing every level in a single pass
+ * @param[in] temp Temporal point
+ * @param[in] xsize,ysize,zsize Tile sizes of the finest level in the units
+ * of the SRID; each coarser level doubles the spatial sizes
+ * @param[in] duration Optional duration of the time tiles, kept fixed
+ * across the levels
+ * @param[in] sorigin Spatial origin of the tiles
+ * @param[in] torigin Time origin of the tiles
+ * @param[in] bitmatrix True when using a bitmatrix to speed up the
+ * computation of the finest level
+ * @param[in] levels Number of levels of the pyramid
+ * @param[out] space_buckets Spatial origins of the tiles of the fragments
+ * @param[out] time_buckets Temporal origins of the tiles of the fragments
+ * @param[out] level_counts Number of fragments of every level
+ * @param[out] newcount Total number of fragments
+ * @return Fragments of all the levels, finest first; on error return
+ * @p NULL
+ *
+ * Only the finest level restricts the temporal point to its tiles, which
+ * dominates the cost of a split. Every coarser tile is then obtained by
+ * merging the fragments of its child tiles with #temporal_merge_array,
+ * since the children partition the parent, so a whole pyramid costs only
+ * slightly more than its finest level instead of one full split per level.
+ */
+Temporal **
+tpoint_space_time_split_pyramid(Temporal *temp, float xsize, float ysize,
+  float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin,
+  bool bitmatrix, int levels, GSERIALIZED ***space_buckets,
+  TimestampTz **time_buckets, int **level_counts, int *newcount)
+{
+  /* Ensure validity of the arguments; the remaining ones are verified by
+   * the split of the finest level */
+  if (! ensure_positive(levels))
+    return NULL;
+  if (levels > MEOS_TILE_MAXLEVELS)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of levels must be at most %d", MEOS_TILE_MAXLEVELS);
+    return NULL;
+  }
+
+  /* Split once at the finest grid */
+  int count0;
+  GSERIALIZED **spaces0;
+  TimestampTz *times0 = NULL;
+  Temporal **frags0 = tpoint_space_time_split(temp, xsize, ysize, zsize,
+    duration, sorigin, torigin, bitmatrix, &spaces0, &times0, &count0);
+  if (! frags0)
+    return NULL;
+
+  /* Spatial origin for aligning the parent tiles */
+  bool hasz = MEOS_FLAGS_GET_Z(temp->flags);
+  POINT3DZ pt;
+  memset(&pt, 0, sizeof(POINT3DZ));
+  if (hasz)
+  {
+    const POINT3DZ *p3d = GSERIALIZED_POINT3DZ_P(sorigin);
+    pt = *p3d;
+  }
+  else
+  {
+    const POINT2D *p2d = GSERIALIZED_POINT2D_P(sorigin);
+    pt.x = p2d->x;
+    pt.y = p2d->y;
+  }
+  int32 srid = gserialized_get_srid(spaces0 && count0 ? spaces0[0] : sorigin);
+
+  /* Per-level arrays, finest first */
+  Temporal **frags[MEOS_TILE_MAXLEVELS];
+  GSERIALIZED **spaces[MEOS_TILE_MAXLEVELS];
+  TimestampTz *times[MEOS_TILE_MAXLEVELS];
+  int counts[MEOS_TILE_MAXLEVELS];
+  frags[0] = frags0; spaces[0] = spaces0; times[0] = times0;
+  counts[0] = count0;
+  int total = count0;
+
+  /* Aggregate the tiles upwards through the pyramid */
+  for (int l = 1; l < levels; l++)
+  {
+    int nchildren = counts[l - 1];
+    double xs = (double) xsize * (double) (1 << l);
+    double ys = (double) ysize * (double) (1 << l);
+    double zs = (double) zsize * (double) (1 << l);
+    STboxPyramidCell *cells = palloc(sizeof(STboxPyramidCell) *
+      Max(nchildren, 1));
+    for (int j = 0; j < nchildren; j++)
+    {
+      const GSERIALIZED *gs = spaces[l - 1][j];
+      memset(&cells[j], 0, sizeof(STboxPyramidCell));
+      if (hasz)
+      {
+        const POINT3DZ *p3d = GSERIALIZED_POINT3DZ_P(gs);
+        cells[j].x = float_bucket(p3d->x, xs, pt.x);
+        cells[j].y = float_bucket(p3d->y, ys, pt.y);
+        cells[j].z = float_bucket(p3d->z, zs, pt.z);
+      }
+      else
+      {
+        const POINT2D *p2d = GSERIALIZED_POINT2D_P(gs);
+        cells[j].x = float_bucket(p2d->x, xs, pt.x);
+        cells[j].y = float_bucket(p2d->y, ys, pt.y);
+      }
+      if (times[l - 1])
+        cells[j].t = times[l - 1][j];
+      cells[j].idx = j;
+    }
+    qsort(cells, nchildren, sizeof(STboxPyramidCell),
+      &stbox_pyramid_cell_cmp);
+
+    /* Merge every run of fragments sharing a parent tile */
+    frags[l] = palloc(sizeof(Temporal *) * Max(nchildren, 1));
+    spaces[l] = palloc(sizeof(GSERIALIZED *) * Max(nchildren, 1));
+    times[l] = times[l - 1] ?
+      palloc(sizeof(TimestampTz) * Max(nchildren, 1)) : NULL;
+    int nparents = 0;
+    Temporal **children = palloc(sizeof(Temporal *) * Max(nchildren, 1));
+    int j = 0;
+    while (j < nchildren)
+    {
+      int k = j;
+      while (k < nchildren &&
+          stbox_pyramid_cell_cmp(&cells[j], &cells[k]) == 0)
+      {
+        children[k - j] = frags[l - 1][cells[k].idx];
+        k++;
+      }
+      frags[l][nparents] = (k - j == 1) ?
+        temporal_copy(children[0]) : temporal_merge_array(children, k - j);
+      spaces[l][nparents] = gspoint_make(cells[j].x, cells[j].y, cells[j].z,
+        hasz, false, srid);
+      if (times[l])
+        times[l][nparents] = cells[j].t;
+      nparents++;
+      j = k;
+    }
+    pfree(children);
+    pfree(cells);
+    counts[l] = nparents;
+    total += nparents;
+  }
+
+  /* Concatenate the levels, finest first */
+  Temporal **result = palloc(sizeof(Temporal *) * Max(total, 1));
+  GSERIALIZED **allspaces = palloc(sizeof(GSERIALIZED *) * Max(total, 1));
+  TimestampTz *alltimes = times[0] ?
+    palloc(sizeof(TimestampTz) * Max(total, 1)) : NULL;
+  int *levelcounts = palloc(sizeof(int) * levels);
+  int i = 0;
+  for (int l = 0; l < levels; l++)
+  {
+    levelcounts[l] = counts[l];
+    for (int j = 0; j < counts[l]; j++)
+    {
+      result[i] = frags[l][j];
+      allspaces[i] = spaces[l][j];
+      if (alltimes)
+        alltimes[i] = times[l][j];
+      i++;
+    }
+    pfree(frags[l]);
+    pfree(spaces[l]);
+    if (times[l])
+      pfree(times[l]);
+  }
+  assert(i == total);
+  *newcount = total;
+  if (level_counts)
+    *level_counts = levelcounts;
+  else
+    pfree(levelcounts);
+  if (space_buckets)
+    *space_buckets = allspaces;
+  else
+    pfree(allspaces);
+  if (time_buckets)
+    *time_buckets = alltimes;
+  else if (alltimes)
+    pfree(alltimes);
+  return result;
+}
+
+/*****************************************************************************/
+
+/* Number of rows of the count-min sketch used for the top-k tiles */
+#define MEOS_TOPK_CMIN_ROWS 4
+/* Bounds on the width of the count-min sketch rows */
+#define MEOS_TOPK_CMIN_MINWIDTH 4096
+#define MEOS_TOPK_CMIN_MAXWIDTH 65536
+
+/**
+ * @brief Candidate tile tracked by the top-k computation
+ */
+typedef struct
+{
+  uint64 est;            /**< Estimated number of visits */
+  int coords[MAXDIMS];   /**< Tile coordinates in the grid */
+} STboxTopkCand;
+
+/**
+ * @brief Finalizer mixing the bits of a tile key into a hash value
+ */
+static inline uint64
+tile_topk_hash(uint64 h)
+{
+  h ^= h >> 33;
+  h *= UINT64CONST(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  h *= UINT64CONST(0xc4ceb9fe1a85ec53);
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * @brief Comparator ordering the candidate tiles by decreasing estimate
+ */
+static int
+stbox_topk_cand_cmp(const void *a, const void *b)
+{
+  uint64 e1 = ((const STboxTopkCand *) a)->est;
+  uint64 e2 = ((const STboxTopkCand *) b)->est;
+  if (e1 != e2)
+    return (e1 > e2) ? -1 : 1;
+  return 0;
+}
+
+/**
+ * @brief Return the k most visited tiles of a space and possibly time grid
+ * @param[in] temp Temporal point
+ * @param[in] xsize,ysize,zsize Size of the tiles in the units of the SRID
+ * @param[in] duration Optional duration of the time tiles
+ * @param[in] sorigin Spatial origin of the tiles
+ * @param[in] torigin Time origin of the tiles
+ * @param[in] k Number of tiles requested
+ * @param[out] tile_counts Estimated number of visits of every tile, may be
+ * @p NULL
+ * @param[out] count Number of tiles of the result
+ * @return Tiles ordered by decreasing estimated visits; on error return
+ * @p NULL
+ *
+ * The grid assignment is done in a single pass over the instants with a
+ * count-min sketch feeding a list of the k best candidates, so neither the
+ * tiles nor the restrictions of the temporal point to them are ever
+ * materialized, unlike a split followed by counting. The estimates are
+ * upper bounds that may overcount heavily colliding tiles, and a visit is
+ * an instant falling in a tile, so linear interpolation between distant
+ * instants does not count the traversed tiles: this is intended for
+ * dashboard-grade rankings, where the exact split is overkill.
+ */
+STBox *
+tpoint_space_time_topk(Temporal *temp, float xsize, float ysize, float zsize,
+  Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, int k,
+  uint64 **tile_counts, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) sorigin) ||
+      ! ensure_not_null((void *) count) || ! ensure_positive(k))
+    return NULL;
+
+  /* Set bounding box */
+  STBox bounds;
+  temporal_set_bbox(temp, &bounds);
+  bool timesplit = (duration != NULL);
+  if (! timesplit)
+    /* Disallow T dimension for generating a spatial only grid */
+    MEOS_FLAGS_SET_T(bounds.flags, false);
+
+  /* Ensure parameter validity */
+  POINT3DZ pt;
+  int64 tunits = 0;
+  ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8);
+  ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8);
+  ensure_positive_datum(Float8GetDatum(zsize), T_FLOAT8);
+  ensure_not_empty(sorigin);
+  ensure_point_type(sorigin);
+  ensure_same_geodetic(temp->flags, sorigin->gflags);
+  int32 gs_srid = gserialized_get_srid(sorigin);
+  if (gs_srid != SRID_UNKNOWN)
+    ensure_same_srid(bounds.srid, gs_srid);
+  memset(&pt, 0, sizeof(POINT3DZ));
+  if (MEOS_FLAGS_GET_Z(temp->flags))
+  {
+    ensure_has_Z_gs(sorigin);
+    const POINT3DZ *p3d = GSERIALIZED_POINT3DZ_P(sorigin);
+    pt.x = p3d->x;
+    pt.y = p3d->y;
+    pt.z = p3d->z;
+  }
+  else
+  {
+    const POINT2D *p2d = GSERIALIZED_POINT2D_P(sorigin);
+    pt.x = p2d->x;
+    pt.y = p2d->y;
+  }
+  if (timesplit)
+  {
+    ensure_valid_duration(duration);
+    tunits = interval_units(duration);
+  }
+
+  /* Create the grid state used only to assign coordinates */
+  STboxGridState *state = stbox_tile_state_make(temp, &bounds, xsize, ysize,
+    zsize, tunits, pt, torigin);
+  bool hasz = MEOS_FLAGS_GET_Z(state->box.flags);
+  bool hast = (state->tunits > 0);
+
+  /* Size the sketch rows from k so collisions stay rare for usual k */
+  int width = MEOS_TOPK_CMIN_MINWIDTH;
+  while (width < k * 256 && width < MEOS_TOPK_CMIN_MAXWIDTH)
+    width <<= 1;
+  uint64 *sketch = palloc0(sizeof(uint64) * MEOS_TOPK_CMIN_ROWS * width);
+  STboxTopkCand *cands = palloc(sizeof(STboxTopkCand) * k);
+  int ncands = 0, minpos = 0;
+  uint64 minest = 0;
+
+  int ninsts;
+  const TInstant **instants = temporal_instants(temp, &ninsts);
+  int coords[MAXDIMS];
+  for (int i = 0; i < ninsts; i++)
+  {
+    if ((i & 0xFFF) == 0 && meos_interrupt_check())
+    {
+      pfree(instants); pfree(sketch); pfree(cands); pfree(state);
+      return NULL;
+    }
+    memset(coords, 0, sizeof(coords));
+    tpointinst_get_coords_eps(instants[i], hasz, hast, state, coords, NULL);
+    /* Update the sketch: the estimate is the minimum of the row counters */
+    uint64 h1 = tile_topk_hash(
+      ((uint64) (uint32) coords[0] << 32) | (uint32) coords[1]);
+    uint64 h2 = tile_topk_hash(h1 ^
+      (((uint64) (uint32) coords[2] << 32) | (uint32) coords[3])) | 1;
+    uint64 est = 0;
+    for (int row = 0; row < MEOS_TOPK_CMIN_ROWS; row++)
+    {
+      uint64 *cell = &sketch[row * width +
+        (int) ((h1 + (uint64) row * h2) & (uint64) (width - 1))];
+      ++*cell;
+      if (row == 0 || *cell < est)
+        est = *cell;
+    }
+    /* The candidate list only changes when the estimate beats its minimum;
+     * an already tracked tile always does since its estimate just grew */
+    if (ncands == k && est <= minest)
+      continue;
+    int c = 0;
+    while (c < ncands && memcmp(cands[c].coords, coords, sizeof(coords)) != 0)
+      c++;
+    if (c < ncands)
+      cands[c].est = est;
+    else if (ncands < k)
+    {
+      memcpy(cands[ncands].coords, coords, sizeof(coords));
+      cands[ncands++].est = est;
+    }
+    else
+    {
+      /* Evict the candidate with the smallest estimate */
+      memcpy(cands[minpos].coords, coords, sizeof(coords));
+      cands[minpos].est = est;
+      c = minpos;
+    }
+    /* Refresh the cached minimum when its entry changed or the list filled */
+    if (ncands == k && (c == minpos || minest == 0))
+    {
+      minest = cands[0].est;
+      minpos = 0;
+      for (int j = 1; j < k; j++)
+        if (cands[j].est < minest)
+        {
+          minest = cands[j].est;
+          minpos = j;
+        }
+    }
+  }
+  pfree(instants);
+  pfree(sketch);
+
+  /* Sort the candidates and build the tiles of the result */
+  qsort(cands, (size_t) ncands, sizeof(STboxTopkCand), &stbox_topk_cand_cmp);
+  STBox *result = palloc(sizeof(STBox) * ncands);
+  uint64 *counts = tile_counts ? palloc(sizeof(uint64) * ncands) : NULL;
+  for (int i = 0; i < ncands; i++)
+  {
+    double x = state->box.xmin + cands[i].coords[0] * state->xsize;
+    double y = state->box.ymin + cands[i].coords[1] * state->ysize;
+    double z = 0;
+    TimestampTz t = 0;
+    int dim = 2;
+    if (hasz)
+      z = state->box.zmin + cands[i].coords[dim++] * state->zsize;
+    if (hast)
+      t = DatumGetTimestampTz(state->box.period.lower) +
+        cands[i].coords[dim++] * state->tunits;
+    stbox_tile_set(x, y, z, t, state->xsize, state->ysize, state->zsize,
+      state->tunits, hasz, hast, state->box.srid, &result[i]);
+    if (counts)
+      counts[i] = cands[i].est;
+  }
+  pfree(cands);
+  pfree(state);
+  *count = ncands;
+  if (tile_counts)
+    *tile_counts = counts;
+  return result;
+}
 #endif /* MEOS */
 
 /*****************************************************************************/
@@ -0,0 +1,777 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Parallel loader that assembles timestamped point observations into
+ * temporal point sequences and writes them to a temporal store file.
+ *
+ * The program is the productized version of the `03_meos_assemble_ais.c`
+ * example program. The input is a CSV file with a header line and one
+ * observation per line in the format
+ * @code
+ * id,timestamp,longitude,latitude
+ * @endcode
+ * where `id` is the integer identifier of the moving object. The
+ * observations are sharded by object identifier across worker threads, so
+ * that each thread parses and assembles complete objects independently. The
+ * observations of an object may appear in any order and duplicated
+ * timestamps are ignored. The resulting sequences are written with
+ * `temporal_store_write`, from where they can be memory mapped back with
+ * `temporal_store_open` without parsing.
+ *
+ * The input is read in large chunks with several reads kept in flight, so
+ * that sharding the current chunk overlaps reading the next ones. On Linux,
+ * when the program is built with liburing (macro `HAVE_LIBURING`), the reads
+ * are submitted through io_uring with registered buffers; on other platforms
+ * a prefetch thread issues the same reads with `pread`, preserving the
+ * overlap everywhere.
+ *
+ * The program can be built with the `meos_load` CMake target, which is
+ * enabled with `-DMEOS_TOOLS=ON`, or by hand as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o meos_load meos_load.c
+ *   -L/usr/local/lib -lmeos -lpthread
+ * @endcode
+ * and run as follows
+ * @code
+ * meos_load [-t threads] [-s] input.csv output.store
+ * @endcode
+ * where `-t` sets the number of worker threads (by default the number of
+ * processors) and `-s` assembles the sequences with step instead of linear
+ * interpolation.
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+/* Include the MEOS API header */
+#include <meos.h>
+
+/* Maximum length in characters of an observation line */
+#define MAX_LEN_LINE 1024
+/* Initial capacity of the growable arrays */
+#define LOAD_INITIAL_CAPACITY 64
+/* Maximum load factor of the object tables before growing */
+#define LOAD_MAX_FILL 0.7
+/* Size in bytes of a read chunk */
+#define LOAD_CHUNK_SIZE (4 * 1024 * 1024)
+/* Number of chunk buffers, and thus of reads kept in flight */
+#define LOAD_NUM_CHUNKS 4
+
+/**
+ * @brief Raw observation lines assigned to one worker thread
+ */
+typedef struct
+{
+  char **lines;      /**< Raw observation lines */
+  int count;         /**< Number of lines */
+  int capacity;      /**< Capacity of the array */
+} LoadShard;
+
+/**
+ * @brief Observations of one moving object
+ */
+typedef struct
+{
+  int64_t id;          /**< Object identifier, 0 marks an empty slot */
+  TInstant **instants; /**< Observations parsed so far */
+  int count;           /**< Number of observations */
+  int capacity;        /**< Capacity of the array */
+} LoadObject;
+
+/**
+ * @brief Open-addressing table of the objects of one shard, keyed by the
+ * object identifier
+ */
+typedef struct
+{
+  LoadObject *objects; /**< Slots of the table */
+  int capacity;        /**< Capacity of the table, a power of two */
+  int count;           /**< Number of occupied slots */
+} LoadTable;
+
+/**
+ * @brief Arguments and results of one worker thread
+ */
+typedef struct
+{
+  LoadShard *shard;      /**< Observation lines to process */
+  interpType interp;     /**< Interpolation of the assembled sequences */
+  TSequence **sequences; /**< Assembled sequences */
+  int seqcount;          /**< Number of assembled sequences */
+  int badlines;          /**< Number of lines that could not be parsed */
+  int duplicates;        /**< Number of duplicated timestamps dropped */
+} LoadTask;
+
+/**
+ * @brief Return the value of a monotonic clock in seconds
+ */
+static double
+load_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Scramble an object identifier so that consecutive identifiers do
+ * not land on consecutive shards and table slots
+ */
+static uint64_t
+load_hash(int64_t id)
+{
+  uint64_t h = (uint64_t) id;
+  h ^= h >> 33;
+  h *= UINT64_C(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * @brief One chunk buffer of the asynchronous reader
+ */
+typedef struct
+{
+  char *buf;       /**< Buffer of LOAD_CHUNK_SIZE bytes */
+  int target;      /**< Number of bytes to read into the buffer */
+  int filled;      /**< Number of bytes read so far */
+  bool done;       /**< True when the chunk has been fully read */
+} LoadChunk;
+
+/**
+ * @brief Asynchronous chunked reader of the input file
+ *
+ * The file is read in chunks of LOAD_CHUNK_SIZE bytes into a round-robin
+ * set of buffers with several reads in flight, so that the caller processes
+ * one chunk while the following ones are being read. With liburing the reads
+ * are submitted through io_uring with registered buffers and no extra
+ * thread; the portable fallback issues the same reads with pread from a
+ * prefetch thread. A buffer handed out by load_reader_next remains valid
+ * until the following call.
+ */
+typedef struct
+{
+  int fd;                            /**< Input file */
+  int64_t filesize;                  /**< Size of the input file */
+  int64_t nchunks;                   /**< Number of chunks in the file */
+  int64_t submitted;                 /**< Number of chunk reads started */
+  int64_t consumed;                  /**< Number of chunks handed out */
+  LoadChunk chunks[LOAD_NUM_CHUNKS]; /**< Chunk buffers, used round robin */
+#ifdef HAVE_LIBURING
+  struct io_uring ring;              /**< Submission/completion ring */
+  int inflight;                      /**< Number of reads in flight */
+#else
+  pthread_t thread;                  /**< Prefetch thread */
+  pthread_mutex_t mutex;             /**< Protects the chunk states */
+  pthread_cond_t cond;               /**< Signals completion and reuse */
+  int64_t released;                  /**< Number of chunk buffers released */
+  bool failed;                       /**< True after a read error */
+  bool closing;                      /**< Tells the thread to stop early */
+#endif
+} LoadReader;
+
+#ifdef HAVE_LIBURING
+
+/**
+ * @brief Submit a read for the remaining bytes of a chunk
+ */
+static bool
+load_chunk_submit(LoadReader *reader, int64_t chunkno)
+{
+  LoadChunk *chunk = &reader->chunks[chunkno % LOAD_NUM_CHUNKS];
+  struct io_uring_sqe *sqe = io_uring_get_sqe(&reader->ring);
+  if (! sqe)
+    return false;
+  io_uring_prep_read_fixed(sqe, reader->fd, chunk->buf + chunk->filled,
+    chunk->target - chunk->filled,
+    chunkno * (int64_t) LOAD_CHUNK_SIZE + chunk->filled,
+    (int) (chunkno % LOAD_NUM_CHUNKS));
+  io_uring_sqe_set_data(sqe, (void *) (uintptr_t) chunkno);
+  if (io_uring_submit(&reader->ring) != 1)
+    return false;
+  reader->inflight++;
+  return true;
+}
+
+/**
+ * @brief Start reading the next chunk of the file into its buffer
+ */
+static bool
+load_chunk_start(LoadReader *reader)
+{
+  int64_t chunkno = reader->submitted++;
+  LoadChunk *chunk = &reader->chunks[chunkno % LOAD_NUM_CHUNKS];
+  int64_t left = reader->filesize - chunkno * (int64_t) LOAD_CHUNK_SIZE;
+  chunk->target = left < LOAD_CHUNK_SIZE ? (int) left : LOAD_CHUNK_SIZE;
+  chunk->filled = 0;
+  chunk->done = false;
+  return load_chunk_submit(reader, chunkno);
+}
+
+/**
+ * @brief Reap one completion, resubmitting chunks completed by short reads
+ */
+static bool
+load_reader_reap(LoadReader *reader)
+{
+  struct io_uring_cqe *cqe;
+  if (io_uring_wait_cqe(&reader->ring, &cqe) < 0)
+    return false;
+  int64_t chunkno = (int64_t) (uintptr_t) io_uring_cqe_get_data(cqe);
+  int res = cqe->res;
+  io_uring_cqe_seen(&reader->ring, cqe);
+  reader->inflight--;
+  if (res < 0)
+    return false;
+  LoadChunk *chunk = &reader->chunks[chunkno % LOAD_NUM_CHUNKS];
+  chunk->filled += res;
+  if (res == 0 || chunk->filled == chunk->target)
+    chunk->done = true;
+  else if (! load_chunk_submit(reader, chunkno))
+    return false;
+  return true;
+}
+
+#else /* ! HAVE_LIBURING */
+
+/**
+ * @brief Prefetch thread that reads the chunks of the file in order,
+ * waiting for the parser to release a buffer before reusing it
+ */
+static void *
+load_reader_prefetch(void *arg)
+{
+  LoadReader *reader = (LoadReader *) arg;
+  for (int64_t chunkno = 0; chunkno < reader->nchunks; chunkno++)
+  {
+    LoadChunk *chunk = &reader->chunks[chunkno % LOAD_NUM_CHUNKS];
+    pthread_mutex_lock(&reader->mutex);
+    while (chunkno >= reader->released + LOAD_NUM_CHUNKS && ! reader->closing)
+      pthread_cond_wait(&reader->cond, &reader->mutex);
+    bool closing = reader->closing;
+    pthread_mutex_unlock(&reader->mutex);
+    if (closing)
+      break;
+    int64_t offset = chunkno * (int64_t) LOAD_CHUNK_SIZE;
+    int64_t left = reader->filesize - offset;
+    int target = left < LOAD_CHUNK_SIZE ? (int) left : LOAD_CHUNK_SIZE;
+    int filled = 0;
+    while (filled < target)
+    {
+      ssize_t n = pread(reader->fd, chunk->buf + filled, target - filled,
+        offset + filled);
+      if (n <= 0)
+        break;
+      filled += (int) n;
+    }
+    pthread_mutex_lock(&reader->mutex);
+    chunk->target = target;
+    chunk->filled = filled;
+    chunk->done = true;
+    if (filled < target)
+      reader->failed = true;
+    pthread_cond_broadcast(&reader->cond);
+    pthread_mutex_unlock(&reader->mutex);
+    if (filled < target)
+      break;
+  }
+  return NULL;
+}
+
+#endif /* HAVE_LIBURING */
+
+/**
+ * @brief Open the input file and start reading its first chunks
+ */
+static bool
+load_reader_open(LoadReader *reader, const char *path)
+{
+  memset(reader, 0, sizeof(LoadReader));
+  reader->fd = open(path, O_RDONLY);
+  if (reader->fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(reader->fd, &st) != 0)
+  {
+    close(reader->fd);
+    return false;
+  }
+  reader->filesize = st.st_size;
+  reader->nchunks = (reader->filesize + LOAD_CHUNK_SIZE - 1) /
+    LOAD_CHUNK_SIZE;
+  for (int i = 0; i < LOAD_NUM_CHUNKS; i++)
+    reader->chunks[i].buf = malloc(LOAD_CHUNK_SIZE);
+#ifdef HAVE_LIBURING
+  if (io_uring_queue_init(LOAD_NUM_CHUNKS * 2, &reader->ring, 0) < 0)
+  {
+    close(reader->fd);
+    return false;
+  }
+  struct iovec iov[LOAD_NUM_CHUNKS];
+  for (int i = 0; i < LOAD_NUM_CHUNKS; i++)
+  {
+    iov[i].iov_base = reader->chunks[i].buf;
+    iov[i].iov_len = LOAD_CHUNK_SIZE;
+  }
+  if (io_uring_register_buffers(&reader->ring, iov, LOAD_NUM_CHUNKS) < 0)
+  {
+    io_uring_queue_exit(&reader->ring);
+    close(reader->fd);
+    return false;
+  }
+  while (reader->submitted < reader->nchunks &&
+         reader->submitted < LOAD_NUM_CHUNKS)
+    if (! load_chunk_start(reader))
+      return false;
+#else
+  pthread_mutex_init(&reader->mutex, NULL);
+  pthread_cond_init(&reader->cond, NULL);
+  pthread_create(&reader->thread, NULL, &load_reader_prefetch, reader);
+#endif
+  return true;
+}
+
+/**
+ * @brief Hand out the next chunk of the file, releasing the buffer of the
+ * previous one for reuse
+ * @param[out] buffer Start of the chunk, valid until the next call
+ * @return Number of bytes in the chunk, 0 at the end of the file, and -1
+ * on a read error
+ */
+static int
+load_reader_next(LoadReader *reader, char **buffer)
+{
+#ifdef HAVE_LIBURING
+  /* The buffer of the previous chunk is free again: read ahead into it */
+  if (reader->consumed > 0 && reader->submitted < reader->nchunks)
+    if (! load_chunk_start(reader))
+      return -1;
+  if (reader->consumed >= reader->nchunks)
+    return 0;
+  LoadChunk *chunk = &reader->chunks[reader->consumed % LOAD_NUM_CHUNKS];
+  while (! chunk->done)
+    if (! load_reader_reap(reader))
+      return -1;
+  *buffer = chunk->buf;
+  reader->consumed++;
+  return chunk->filled;
+#else
+  pthread_mutex_lock(&reader->mutex);
+  /* The buffer of the previous chunk is free again */
+  if (reader->consumed > 0)
+  {
+    reader->chunks[(reader->consumed - 1) % LOAD_NUM_CHUNKS].done = false;
+    reader->released++;
+    pthread_cond_broadcast(&reader->cond);
+  }
+  if (reader->consumed >= reader->nchunks)
+  {
+    pthread_mutex_unlock(&reader->mutex);
+    return 0;
+  }
+  LoadChunk *chunk = &reader->chunks[reader->consumed % LOAD_NUM_CHUNKS];
+  while (! chunk->done)
+    pthread_cond_wait(&reader->cond, &reader->mutex);
+  bool failed = reader->failed;
+  pthread_mutex_unlock(&reader->mutex);
+  if (failed)
+    return -1;
+  *buffer = chunk->buf;
+  reader->consumed++;
+  return chunk->filled;
+#endif
+}
+
+/**
+ * @brief Close the reader, waiting for the reads still in flight
+ */
+static void
+load_reader_close(LoadReader *reader)
+{
+#ifdef HAVE_LIBURING
+  while (reader->inflight > 0)
+    if (! load_reader_reap(reader))
+      break;
+  io_uring_queue_exit(&reader->ring);
+#else
+  pthread_mutex_lock(&reader->mutex);
+  reader->closing = true;
+  reader->released = reader->nchunks;
+  pthread_cond_broadcast(&reader->cond);
+  pthread_mutex_unlock(&reader->mutex);
+  pthread_join(reader->thread, NULL);
+  pthread_mutex_destroy(&reader->mutex);
+  pthread_cond_destroy(&reader->cond);
+#endif
+  close(reader->fd);
+  for (int i = 0; i < LOAD_NUM_CHUNKS; i++)
+    free(reader->chunks[i].buf);
+}
+
+/**
+ * @brief Append an observation line to a shard
+ */
+static void
+shard_append(LoadShard *shard, const char *line)
+{
+  if (shard->count == shard->capacity)
+  {
+    shard->capacity = shard->capacity ? shard->capacity * 2 :
+      LOAD_INITIAL_CAPACITY;
+    shard->lines = realloc(shard->lines, sizeof(char *) * shard->capacity);
+  }
+  shard->lines[shard->count++] = strdup(line);
+}
+
+/**
+ * @brief Return the slot of an object in a table, growing the table when it
+ * is too full
+ */
+static LoadObject *
+table_find(LoadTable *table, int64_t id)
+{
+  if (table->count >= (int) (table->capacity * LOAD_MAX_FILL))
+  {
+    /* Rehash into a table twice as large */
+    int newcapacity = table->capacity ? table->capacity * 2 :
+      LOAD_INITIAL_CAPACITY;
+    LoadObject *newobjects = calloc(newcapacity, sizeof(LoadObject));
+    for (int i = 0; i < table->capacity; i++)
+    {
+      LoadObject *obj = &table->objects[i];
+      if (obj->id == 0)
+        continue;
+      uint64_t slot = load_hash(obj->id) & (newcapacity - 1);
+      while (newobjects[slot].id != 0)
+        slot = (slot + 1) & (newcapacity - 1);
+      newobjects[slot] = *obj;
+    }
+    free(table->objects);
+    table->objects = newobjects;
+    table->capacity = newcapacity;
+  }
+
+  uint64_t slot = load_hash(id) & (table->capacity - 1);
+  while (table->objects[slot].id != 0 && table->objects[slot].id != id)
+    slot = (slot + 1) & (table->capacity - 1);
+  LoadObject *obj = &table->objects[slot];
+  if (obj->id == 0)
+  {
+    obj->id = id;
+    table->count++;
+  }
+  return obj;
+}
+
+/**
+ * @brief Append an observation to an object
+ */
+static void
+object_append(LoadObject *obj, TInstant *inst)
+{
+  if (obj->count == obj->capacity)
+  {
+    obj->capacity = obj->capacity ? obj->capacity * 2 :
+      LOAD_INITIAL_CAPACITY;
+    obj->instants = realloc(obj->instants,
+      sizeof(TInstant *) * obj->capacity);
+  }
+  obj->instants[obj->count++] = inst;
+}
+
+/**
+ * @brief Comparator of two temporal instants with respect to their timestamp
+ */
+static int
+tinstant_cmp_timestamp(const void *left, const void *right)
+{
+  const TInstant *inst1 = *(const TInstant **) left;
+  const TInstant *inst2 = *(const TInstant **) right;
+  if (inst1->t < inst2->t)
+    return -1;
+  if (inst1->t > inst2->t)
+    return 1;
+  return 0;
+}
+
+/**
+ * @brief Parse the observation lines of a shard and assemble the sequences
+ * of its objects
+ */
+static void *
+load_worker(void *arg)
+{
+  LoadTask *task = (LoadTask *) arg;
+  LoadShard *shard = task->shard;
+  LoadTable table = {0};
+
+  /* Parse every line of the shard into an instant of its object */
+  for (int i = 0; i < shard->count; i++)
+  {
+    char *line = shard->lines[i];
+    long id;
+    char timestamp[MAX_LEN_LINE], instant[MAX_LEN_LINE];
+    double lon, lat;
+    if (sscanf(line, "%ld,%1023[^,],%lf,%lf", &id, timestamp,
+        &lon, &lat) != 4 || id == 0)
+    {
+      task->badlines++;
+      continue;
+    }
+    snprintf(instant, sizeof(instant), "SRID=4326;Point(%lf %lf)@%s",
+      lon, lat, timestamp);
+    TInstant *inst = (TInstant *) tgeompoint_in(instant);
+    if (! inst)
+    {
+      task->badlines++;
+      continue;
+    }
+    object_append(table_find(&table, id), inst);
+  }
+
+  /* Assemble the sequence of every object of the shard */
+  task->sequences = malloc(sizeof(TSequence *) * (table.count ?
+    table.count : 1));
+  task->seqcount = 0;
+  for (int i = 0; i < table.capacity; i++)
+  {
+    LoadObject *obj = &table.objects[i];
+    if (obj->id == 0)
+      continue;
+    qsort(obj->instants, obj->count, sizeof(TInstant *),
+      &tinstant_cmp_timestamp);
+    /* Drop the observations with duplicated timestamps */
+    int count = 0;
+    for (int j = 0; j < obj->count; j++)
+    {
+      if (count > 0 && obj->instants[j]->t == obj->instants[count - 1]->t)
+      {
+        free(obj->instants[j]);
+        task->duplicates++;
+        continue;
+      }
+      obj->instants[count++] = obj->instants[j];
+    }
+    task->sequences[task->seqcount++] = tsequence_make(
+      (const TInstant **) obj->instants, count, true, true, task->interp,
+      true);
+    for (int j = 0; j < count; j++)
+      free(obj->instants[j]);
+    free(obj->instants);
+  }
+  free(table.objects);
+  return NULL;
+}
+
+/* Main program */
+int main(int argc, char **argv)
+{
+  int nthreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  interpType interp = LINEAR;
+  int argno = 1;
+  while (argno < argc && argv[argno][0] == '-')
+  {
+    if (strcmp(argv[argno], "-t") == 0 && argno + 1 < argc)
+      nthreads = atoi(argv[++argno]);
+    else if (strcmp(argv[argno], "-s") == 0)
+      interp = STEP;
+    else
+    {
+      fprintf(stderr, "Unknown option '%s'\n", argv[argno]);
+      return 1;
+    }
+    argno++;
+  }
+  if (argno + 2 != argc)
+  {
+    fprintf(stderr,
+      "Usage: meos_load [-t threads] [-s] input.csv output.store\n");
+    return 1;
+  }
+  const char *inputpath = argv[argno];
+  const char *outputpath = argv[argno + 1];
+  if (nthreads < 1)
+    nthreads = 1;
+
+  /* Initialize MEOS */
+  meos_initialize("UTC", NULL);
+
+  /* Read the input file and shard the lines by object identifier; the
+   * asynchronous reader overlaps the sharding with the following reads */
+  double time_start = load_now();
+  LoadReader reader;
+  if (! load_reader_open(&reader, inputpath))
+  {
+    fprintf(stderr, "Error opening input file '%s'\n", inputpath);
+    meos_finalize();
+    return 1;
+  }
+  LoadShard *shards = calloc(nthreads, sizeof(LoadShard));
+  /* Lines split across two chunks are completed in this buffer */
+  char pending[MAX_LEN_LINE];
+  int pendlen = 0;
+  int nlines = 0;
+  bool header_seen = false, read_error = false;
+  char *chunk;
+  int chunklen;
+  while ((chunklen = load_reader_next(&reader, &chunk)) > 0)
+  {
+    int pos = 0;
+    while (pos < chunklen)
+    {
+      char *nl = memchr(chunk + pos, '\n', chunklen - pos);
+      if (! nl)
+        break;
+      *nl = '\0';
+      char *line = chunk + pos;
+      if (pendlen > 0)
+      {
+        /* Complete the line started at the end of the previous chunk */
+        int n = (int) (nl - line);
+        if (pendlen + n >= MAX_LEN_LINE)
+          n = MAX_LEN_LINE - 1 - pendlen;
+        memcpy(pending + pendlen, line, n);
+        pending[pendlen + n] = '\0';
+        line = pending;
+        pendlen = 0;
+      }
+      /* Skip the header line */
+      if (! header_seen)
+        header_seen = true;
+      else
+      {
+        int64_t id = strtoll(line, NULL, 10);
+        shard_append(&shards[load_hash(id) % nthreads], line);
+        nlines++;
+      }
+      pos = (int) (nl - chunk) + 1;
+    }
+    /* Keep the trailing partial line for the next chunk */
+    int rest = chunklen - pos;
+    if (rest > 0)
+    {
+      if (pendlen + rest >= MAX_LEN_LINE)
+        rest = MAX_LEN_LINE - 1 - pendlen;
+      memcpy(pending + pendlen, chunk + pos, rest);
+      pendlen += rest;
+    }
+  }
+  read_error = (chunklen < 0);
+  /* Last line of a file without trailing newline */
+  if (! read_error && pendlen > 0 && header_seen)
+  {
+    pending[pendlen] = '\0';
+    int64_t id = strtoll(pending, NULL, 10);
+    shard_append(&shards[load_hash(id) % nthreads], pending);
+    nlines++;
+  }
+  load_reader_close(&reader);
+  if (read_error || ! header_seen)
+  {
+    fprintf(stderr, read_error ? "Error reading input file '%s'\n" :
+      "Input file '%s' is empty\n", inputpath);
+    free(shards);
+    meos_finalize();
+    return 1;
+  }
+  double time_read = load_now();
+
+  /* Parse and assemble the shards in parallel */
+  pthread_t *threads = malloc(sizeof(pthread_t) * nthreads);
+  LoadTask *tasks = calloc(nthreads, sizeof(LoadTask));
+  for (int i = 0; i < nthreads; i++)
+  {
+    tasks[i].shard = &shards[i];
+    tasks[i].interp = interp;
+    pthread_create(&threads[i], NULL, &load_worker, &tasks[i]);
+  }
+  int nseqs = 0, badlines = 0, duplicates = 0;
+  for (int i = 0; i < nthreads; i++)
+  {
+    pthread_join(threads[i], NULL);
+    nseqs += tasks[i].seqcount;
+    badlines += tasks[i].badlines;
+    duplicates += tasks[i].duplicates;
+  }
+  double time_assemble = load_now();
+
+  /* Gather the sequences of all shards and write the temporal store */
+  const Temporal **temparr = malloc(sizeof(Temporal *) * (nseqs ? nseqs : 1));
+  int k = 0;
+  for (int i = 0; i < nthreads; i++)
+    for (int j = 0; j < tasks[i].seqcount; j++)
+      temparr[k++] = (const Temporal *) tasks[i].sequences[j];
+  int return_value = 0;
+  if (! temporal_store_write(outputpath, temparr, nseqs))
+  {
+    fprintf(stderr, "Error writing the temporal store '%s'\n", outputpath);
+    return_value = 1;
+  }
+  double time_write = load_now();
+
+  printf("%d observations read, %d could not be parsed, "
+    "%d duplicated timestamps dropped\n", nlines, badlines, duplicates);
+  printf("%d sequences assembled on %d threads and written to '%s'\n",
+    nseqs, nthreads, outputpath);
+  printf("Read %.3f s, assemble %.3f s (%.0f obs/s), write %.3f s\n",
+    time_read - time_start, time_assemble - time_read,
+    (time_assemble > time_read) ?
+      (double) nlines / (time_assemble - time_read) : 0.0,
+    time_write - time_assemble);
+
+  /* Clean up */
+  for (int i = 0; i < nthreads; i++)
+  {
+    for (int j = 0; j < tasks[i].seqcount; j++)
+      free(tasks[i].sequences[j]);
+    free(tasks[i].sequences);
+    for (int j = 0; j < shards[i].count; j++)
+      free(shards[i].lines[j]);
+    free(shards[i].lines);
+  }
+  free(temparr);
+  free(tasks);
+  free(threads);
+  free(shards);
+
+  /* Finalize MEOS */
+  meos_finalize();
+  return return_value;
+}
@@ -36,6 +36,7 @@
 
 /* PostgreSQL */
 #include <postgres.h>
+#include <fmgr.h>
 /* MEOS */
 #include <meos.h>
 #include "general/meos_catalog.h"
@@ -49,6 +50,7 @@ extern const char *oper_name(meosOper oper);
 extern meosOper name_oper(const char *name);
 extern Oid oper_oid(meosOper op, meosType lt, meosType rt);
 extern meosType oid_type(Oid typid);
+extern meosType oid_type_cached(FunctionCallInfo fcinfo, int argno);
 extern meosOper oid_oper(Oid operOid, meosType *ltype, meosType *rtype);
 
 /*****************************************************************************/
@@ -52,6 +52,8 @@
 #define STATISTIC_KIND_VALUE_LENGTH_HISTOGRAM   9
 #define STATISTIC_KIND_TIME_BOUNDS_HISTOGRAM   10
 #define STATISTIC_KIND_TIME_LENGTH_HISTOGRAM   11
+/* Histogram of the number of instants per value of a temporal column */
+#define STATISTIC_KIND_INSTANT_COUNT_HISTOGRAM 12
 
 /*****************************************************************************/
 
@@ -47,6 +47,7 @@ extern float8 span_sel_default(meosOper oper);
 extern float8 span_joinsel_default(meosOper oper);
 
 extern void span_const_to_span(Node *other, Span *span);
+extern void span_hist_shcache_init(void);
 
 extern double span_sel_hist(VariableStatData *vardata, const Span *constval,
   meosOper oper, bool value);
@@ -95,22 +95,6 @@ extern Datum float8_numeric(PG_FUNCTION_ARGS);
 #define GinContainedStrategy           3    /* for <@ ?@ */
 #define GinEqualStrategy               4    /* for =  @=*/
 
-/*****************************************************************************
- * Struct definitions for the unnest operation
- *****************************************************************************/
-
-/**
- * Structure to represent the state when unnesting a temporal type.
- */
-typedef struct
-{
-  bool done;
-  int i;
-  int count;
-  Temporal *temp;  /* Temporal value to unnest */
-  Datum *values;   /* Values obtained by getValues(temp) */
-} TempUnnestState;
-
 /*****************************************************************************
  * Struct definitions for GisT indexes copied from PostgreSQL
  *****************************************************************************/
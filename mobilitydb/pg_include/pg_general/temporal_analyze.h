@@ -107,6 +107,8 @@ typedef struct
  * Statistics information for temporal types
  *****************************************************************************/
 
+extern void temporal_count_compute_stats(VacAttrStats *stats,
+  int non_null_cnt, int *slot_idx, float8 *counts);
 extern Datum temporal_analyze(FunctionCallInfo fcinfo,
   void (*functemp)(VacAttrStats *, AnalyzeAttrFetchFunc, int, double));
 
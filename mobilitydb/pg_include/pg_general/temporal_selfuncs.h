@@ -81,6 +81,8 @@ extern double temporal_joinsel(PlannerInfo *root, Oid operid,
 extern double temporal_joinsel_ext(FunctionCallInfo fcinfo,
   TemporalFamily tempfamily);
 
+extern bool temporal_instants_avg(Oid relid, AttrNumber attnum, double *avg);
+
 /*****************************************************************************/
 
 #endif
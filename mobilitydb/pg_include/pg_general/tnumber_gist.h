@@ -82,6 +82,10 @@ extern Datum bbox_gist_picksplit_ext(FunctionCallInfo fcinfo, meosType bboxtype,
 extern bool tbox_index_consistent_leaf(const TBox *key, const TBox *query,
   StrategyNumber strategy);
 
+/* The following functions are also called by tnumber_brin.c */
+extern bool tnumber_gist_consistent(const TBox *key, const TBox *query,
+  StrategyNumber strategy);
+
 /*****************************************************************************/
 
 #endif
@@ -78,6 +78,13 @@ extern RangeType *range_make(Datum from, Datum to, bool lower_inc,
   extern MultirangeType *multirange_make(const SpanSet *ss);
 #endif /* POSTGRESQL_VERSION_NUMBER >= 140000 */
 
+/* Argument preparation functions */
+
+extern bool temporal_getarg_if_contains_timestamp(FunctionCallInfo fcinfo,
+  int argno1, int argno2, Temporal **temp);
+extern bool temporal_getarg_if_overlaps(FunctionCallInfo fcinfo, int argno1,
+  int argno2, Temporal **temp1, Temporal **temp2);
+
 /* Array functions */
 
 extern Datum *datumarr_extract(ArrayType *array, int *count);
@@ -42,11 +42,19 @@
 
 /*****************************************************************************/
 
+/* Initialization function defining the configuration parameters of the
+ * GiST penalty, called by _PG_init */
+extern void tpoint_gist_guc_init(void);
+
 /* The following functions are also called by tpoint_spgist.c */
 extern bool tpoint_index_recheck(StrategyNumber strategy);
 extern bool stbox_index_consistent_leaf(const STBox *key, const STBox *query,
   StrategyNumber strategy);
 
+/* The following functions are also called by tpoint_brin.c */
+extern bool stbox_gist_consistent(const STBox *key, const STBox *query,
+  StrategyNumber strategy);
+
 /*****************************************************************************/
 
 #endif
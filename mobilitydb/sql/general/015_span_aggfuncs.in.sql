@@ -279,6 +279,19 @@ CREATE FUNCTION span_union_transfn(internal, tstzspan)
   AS 'MODULE_PATHNAME', 'Span_union_transfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
+CREATE FUNCTION span_union_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Span_union_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION span_union_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Span_union_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION span_union_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Span_union_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION intspan_union_finalfn(internal)
   RETURNS intspanset
   AS 'MODULE_PATHNAME', 'Span_union_finalfn'
@@ -299,22 +312,46 @@ CREATE FUNCTION tstzspan_union_finalfn(internal)
 CREATE AGGREGATE span_union(intspan) (
   SFUNC = span_union_transfn,
   STYPE = internal,
-  FINALFUNC = intspan_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = span_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = intspan_union_finalfn,
+  SERIALFUNC = span_union_serialize,
+  DESERIALFUNC = span_union_deserialize,
+  PARALLEL = SAFE
 );
 CREATE AGGREGATE span_union(bigintspan) (
   SFUNC = span_union_transfn,
   STYPE = internal,
-  FINALFUNC = bigintspan_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = span_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = bigintspan_union_finalfn,
+  SERIALFUNC = span_union_serialize,
+  DESERIALFUNC = span_union_deserialize,
+  PARALLEL = SAFE
 );
 CREATE AGGREGATE span_union(floatspan) (
   SFUNC = span_union_transfn,
   STYPE = internal,
-  FINALFUNC = floatspan_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = span_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = floatspan_union_finalfn,
+  SERIALFUNC = span_union_serialize,
+  DESERIALFUNC = span_union_deserialize,
+  PARALLEL = SAFE
 );
 CREATE AGGREGATE span_union(tstzspan) (
   SFUNC = span_union_transfn,
   STYPE = internal,
-  FINALFUNC = tstzspan_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = span_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tstzspan_union_finalfn,
+  SERIALFUNC = span_union_serialize,
+  DESERIALFUNC = span_union_deserialize,
+  PARALLEL = SAFE
 );
 
 /*****************************************************************************/
@@ -339,22 +376,46 @@ CREATE FUNCTION spanset_union_transfn(internal, tstzspanset)
 CREATE AGGREGATE span_union(intspanset) (
   SFUNC = spanset_union_transfn,
   STYPE = internal,
-  FINALFUNC = intspan_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = span_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = intspan_union_finalfn,
+  SERIALFUNC = span_union_serialize,
+  DESERIALFUNC = span_union_deserialize,
+  PARALLEL = SAFE
 );
 CREATE AGGREGATE span_union(bigintspanset) (
   SFUNC = spanset_union_transfn,
   STYPE = internal,
-  FINALFUNC = bigintspan_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = span_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = bigintspan_union_finalfn,
+  SERIALFUNC = span_union_serialize,
+  DESERIALFUNC = span_union_deserialize,
+  PARALLEL = SAFE
 );
 CREATE AGGREGATE span_union(floatspanset) (
   SFUNC = spanset_union_transfn,
   STYPE = internal,
-  FINALFUNC = floatspan_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = span_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = floatspan_union_finalfn,
+  SERIALFUNC = span_union_serialize,
+  DESERIALFUNC = span_union_deserialize,
+  PARALLEL = SAFE
 );
 CREATE AGGREGATE span_union(tstzspanset) (
   SFUNC = spanset_union_transfn,
   STYPE = internal,
-  FINALFUNC = tstzspan_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = span_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tstzspan_union_finalfn,
+  SERIALFUNC = span_union_serialize,
+  DESERIALFUNC = span_union_deserialize,
+  PARALLEL = SAFE
 );
 
 /*****************************************************************************/
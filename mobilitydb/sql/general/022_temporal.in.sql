@@ -1588,6 +1588,12 @@ CREATE FUNCTION appendInstant(tfloat, tfloat)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Temporal_append_tinstant'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+-- The tolerance argument enables the dead-reckoning filter, which drops
+-- appended instants predictable within the tolerance from their neighbours
+CREATE FUNCTION appendInstant(tfloat, tfloat, tolerance float)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_append_tinstant'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION appendInstant(ttext, ttext)
   RETURNS ttext
   AS 'MODULE_PATHNAME', 'Temporal_append_tinstant'
@@ -1645,6 +1651,61 @@ CREATE FUNCTION merge(ttext[])
   AS 'MODULE_PATHNAME', 'Temporal_merge_array'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+-- Snapshot + delta access pattern: a stable base value plus a small delta
+-- value accumulating the recent updates, so that the hot write path only
+-- rewrites the delta. The functions are not strict since a null delta
+-- (respectively base) denotes a freshly compacted (respectively empty) pair.
+CREATE FUNCTION deltaAppend(tbool, tbool)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'Temporal_delta_append'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaAppend(tint, tint)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Temporal_delta_append'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaAppend(tfloat, tfloat)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_delta_append'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaAppend(ttext, ttext)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'Temporal_delta_append'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE FUNCTION deltaMerge(tbool, tbool)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'Temporal_delta_merge'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaMerge(tint, tint)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Temporal_delta_merge'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaMerge(tfloat, tfloat)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_delta_merge'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaMerge(ttext, ttext)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'Temporal_delta_merge'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE FUNCTION deltaCompact(tbool, tbool)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'Temporal_delta_compact'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaCompact(tint, tint)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Temporal_delta_compact'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaCompact(tfloat, tfloat)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_delta_compact'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaCompact(ttext, ttext)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'Temporal_delta_compact'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 /*****************************************************************************
  * Restriction functions
  *****************************************************************************/
@@ -2084,6 +2145,12 @@ CREATE FUNCTION stops(tfloat, maxdist float DEFAULT 0.0,
   AS 'MODULE_PATHNAME', 'Temporal_stops'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION moves(tfloat, maxdist float DEFAULT 0.0,
+    minduration interval DEFAULT '0 minutes')
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_moves'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************
  * Local Aggregate Functions
  *****************************************************************************/
@@ -2106,6 +2173,15 @@ CREATE FUNCTION twAvg(tfloat)
   AS 'MODULE_PATHNAME', 'Tnumber_twavg'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION twAvgApprox(tint, fraction float,
+    OUT value float, OUT error float)
+  AS 'MODULE_PATHNAME', 'Tnumber_twavg_approx'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION twAvgApprox(tfloat, fraction float,
+    OUT value float, OUT error float)
+  AS 'MODULE_PATHNAME', 'Tnumber_twavg_approx'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************
  * Selectivity functions for operators
  *****************************************************************************/
@@ -2120,6 +2196,13 @@ CREATE FUNCTION temporal_joinsel(internal, oid, internal, smallint, internal)
   AS 'MODULE_PATHNAME', 'Temporal_joinsel'
   LANGUAGE C IMMUTABLE STRICT;
 
+-- Given a table and a temporal column, returns the average number of
+-- instants per value computed from the column statistics
+CREATE FUNCTION _mobdb_temporal_instants_avg(tbl regclass, col text)
+  RETURNS float
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /******************************************************************************
  * Comparison functions and B-tree indexing
  ******************************************************************************/
@@ -2449,21 +2532,42 @@ CREATE FUNCTION temporal_hash(ttext)
   AS 'MODULE_PATHNAME', 'Temporal_hash'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION temporal_hash_extended(tbool, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_hash_extended(tint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_hash_extended(tfloat, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_hash_extended(ttext, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR CLASS tbool_hash_ops
   DEFAULT FOR TYPE tbool USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tbool);
+    FUNCTION    1   temporal_hash(tbool),
+    FUNCTION    2   temporal_hash_extended(tbool, bigint);
 CREATE OPERATOR CLASS tint_hash_ops
   DEFAULT FOR TYPE tint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tint);
+    FUNCTION    1   temporal_hash(tint),
+    FUNCTION    2   temporal_hash_extended(tint, bigint);
 CREATE OPERATOR CLASS tfloat_hash_ops
   DEFAULT FOR TYPE tfloat USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tfloat);
+    FUNCTION    1   temporal_hash(tfloat),
+    FUNCTION    2   temporal_hash_extended(tfloat, bigint);
 CREATE OPERATOR CLASS ttext_hash_ops
   DEFAULT FOR TYPE ttext USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(ttext);
+    FUNCTION    1   temporal_hash(ttext),
+    FUNCTION    2   temporal_hash_extended(ttext, bigint);
 
 /******************************************************************************/
@@ -0,0 +1,355 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * temporal_valueops.sql
+ * Value set operators for temporal integers and temporal texts.
+ */
+
+/*****************************************************************************
+ * Overlaps
+ *****************************************************************************/
+
+CREATE FUNCTION overlaps_value(intset, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Overlaps_value_set_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION overlaps_value(textset, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Overlaps_value_set_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR @@ (
+  PROCEDURE = overlaps_value,
+  LEFTARG = intset, RIGHTARG = tint,
+  COMMUTATOR = @@
+);
+CREATE OPERATOR @@ (
+  PROCEDURE = overlaps_value,
+  LEFTARG = textset, RIGHTARG = ttext,
+  COMMUTATOR = @@
+);
+
+CREATE FUNCTION overlaps_value(tint, intset)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Overlaps_value_temporal_set'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION overlaps_value(tint, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Overlaps_value_temporal_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION overlaps_value(ttext, textset)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Overlaps_value_temporal_set'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION overlaps_value(ttext, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Overlaps_value_temporal_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR @@ (
+  PROCEDURE = overlaps_value,
+  LEFTARG = tint, RIGHTARG = intset,
+  COMMUTATOR = @@
+);
+CREATE OPERATOR @@ (
+  PROCEDURE = overlaps_value,
+  LEFTARG = tint, RIGHTARG = tint,
+  COMMUTATOR = @@
+);
+CREATE OPERATOR @@ (
+  PROCEDURE = overlaps_value,
+  LEFTARG = ttext, RIGHTARG = textset,
+  COMMUTATOR = @@
+);
+CREATE OPERATOR @@ (
+  PROCEDURE = overlaps_value,
+  LEFTARG = ttext, RIGHTARG = ttext,
+  COMMUTATOR = @@
+);
+
+/*****************************************************************************
+ * Contains
+ *****************************************************************************/
+
+CREATE FUNCTION contains_value(intset, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contains_value_set_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contains_value(textset, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contains_value_set_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR @? (
+  PROCEDURE = contains_value,
+  LEFTARG = intset, RIGHTARG = tint,
+  COMMUTATOR = ?@
+);
+CREATE OPERATOR @? (
+  PROCEDURE = contains_value,
+  LEFTARG = textset, RIGHTARG = ttext,
+  COMMUTATOR = ?@
+);
+
+CREATE FUNCTION contains_value(tint, integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contains_value_temporal_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contains_value(tint, intset)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contains_value_temporal_set'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contains_value(tint, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contains_value_temporal_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contains_value(ttext, text)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contains_value_temporal_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contains_value(ttext, textset)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contains_value_temporal_set'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contains_value(ttext, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contains_value_temporal_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR @? (
+  PROCEDURE = contains_value,
+  LEFTARG = tint, RIGHTARG = integer,
+  COMMUTATOR = ?@
+);
+CREATE OPERATOR @? (
+  PROCEDURE = contains_value,
+  LEFTARG = tint, RIGHTARG = intset,
+  COMMUTATOR = ?@
+);
+CREATE OPERATOR @? (
+  PROCEDURE = contains_value,
+  LEFTARG = tint, RIGHTARG = tint,
+  COMMUTATOR = ?@
+);
+CREATE OPERATOR @? (
+  PROCEDURE = contains_value,
+  LEFTARG = ttext, RIGHTARG = text,
+  COMMUTATOR = ?@
+);
+CREATE OPERATOR @? (
+  PROCEDURE = contains_value,
+  LEFTARG = ttext, RIGHTARG = textset,
+  COMMUTATOR = ?@
+);
+CREATE OPERATOR @? (
+  PROCEDURE = contains_value,
+  LEFTARG = ttext, RIGHTARG = ttext,
+  COMMUTATOR = ?@
+);
+
+/*****************************************************************************
+ * Contained
+ *****************************************************************************/
+
+CREATE FUNCTION contained_value(integer, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contained_value_value_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contained_value(intset, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contained_value_set_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contained_value(text, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contained_value_value_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contained_value(textset, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contained_value_set_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR ?@ (
+  PROCEDURE = contained_value,
+  LEFTARG = integer, RIGHTARG = tint,
+  COMMUTATOR = @?
+);
+CREATE OPERATOR ?@ (
+  PROCEDURE = contained_value,
+  LEFTARG = intset, RIGHTARG = tint,
+  COMMUTATOR = @?
+);
+CREATE OPERATOR ?@ (
+  PROCEDURE = contained_value,
+  LEFTARG = text, RIGHTARG = ttext,
+  COMMUTATOR = @?
+);
+CREATE OPERATOR ?@ (
+  PROCEDURE = contained_value,
+  LEFTARG = textset, RIGHTARG = ttext,
+  COMMUTATOR = @?
+);
+
+CREATE FUNCTION contained_value(tint, intset)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contained_value_temporal_set'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contained_value(tint, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contained_value_temporal_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contained_value(ttext, textset)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contained_value_temporal_set'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION contained_value(ttext, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Contained_value_temporal_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR ?@ (
+  PROCEDURE = contained_value,
+  LEFTARG = tint, RIGHTARG = intset,
+  COMMUTATOR = @?
+);
+CREATE OPERATOR ?@ (
+  PROCEDURE = contained_value,
+  LEFTARG = tint, RIGHTARG = tint,
+  COMMUTATOR = @?
+);
+CREATE OPERATOR ?@ (
+  PROCEDURE = contained_value,
+  LEFTARG = ttext, RIGHTARG = textset,
+  COMMUTATOR = @?
+);
+CREATE OPERATOR ?@ (
+  PROCEDURE = contained_value,
+  LEFTARG = ttext, RIGHTARG = ttext,
+  COMMUTATOR = @?
+);
+
+/*****************************************************************************
+ * Same
+ *****************************************************************************/
+
+CREATE FUNCTION same_value(integer, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_value_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION same_value(intset, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_set_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION same_value(text, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_value_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION same_value(textset, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_set_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = integer, RIGHTARG = tint,
+  COMMUTATOR = @=
+);
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = intset, RIGHTARG = tint,
+  COMMUTATOR = @=
+);
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = text, RIGHTARG = ttext,
+  COMMUTATOR = @=
+);
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = textset, RIGHTARG = ttext,
+  COMMUTATOR = @=
+);
+
+CREATE FUNCTION same_value(tint, integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_temporal_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION same_value(tint, intset)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_temporal_set'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION same_value(tint, tint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_temporal_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION same_value(ttext, text)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_temporal_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION same_value(ttext, textset)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_temporal_set'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION same_value(ttext, ttext)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Same_value_temporal_temporal'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = tint, RIGHTARG = integer,
+  COMMUTATOR = @=
+);
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = tint, RIGHTARG = intset,
+  COMMUTATOR = @=
+);
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = tint, RIGHTARG = tint,
+  COMMUTATOR = @=
+);
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = ttext, RIGHTARG = text,
+  COMMUTATOR = @=
+);
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = ttext, RIGHTARG = textset,
+  COMMUTATOR = @=
+);
+CREATE OPERATOR @= (
+  PROCEDURE = same_value,
+  LEFTARG = ttext, RIGHTARG = ttext,
+  COMMUTATOR = @=
+);
+
+/*****************************************************************************/
@@ -0,0 +1,123 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/*
+ * temporal_gin.sql
+ * GIN index on the value set of temporal integers and temporal texts
+ */
+
+/******************************************************************************/
+
+CREATE FUNCTION tint_gin_extract_value(integer, internal)
+RETURNS internal
+AS 'MODULE_PATHNAME', 'Temporal_gin_extract_value'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tint_gin_extract_query(integer, internal, int2, internal, internal, internal, internal)
+RETURNS internal
+AS 'MODULE_PATHNAME', 'Temporal_gin_extract_query'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tint_gin_triconsistent(internal, int2, integer, int4, internal, internal, internal)
+RETURNS char
+AS 'MODULE_PATHNAME', 'Set_gin_triconsistent'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION ttext_gin_extract_value(text, internal)
+RETURNS internal
+AS 'MODULE_PATHNAME', 'Temporal_gin_extract_value'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION ttext_gin_extract_query(text, internal, int2, internal, internal, internal, internal)
+RETURNS internal
+AS 'MODULE_PATHNAME', 'Temporal_gin_extract_query'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION ttext_gin_triconsistent(internal, int2, text, int4, internal, internal, internal)
+RETURNS char
+AS 'MODULE_PATHNAME', 'Set_gin_triconsistent'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tint_gin_ops
+  DEFAULT FOR TYPE tint USING gin AS
+  STORAGE integer,
+  -- overlap set
+  OPERATOR  10    @@ (tint, intset),
+  -- overlap tint
+  OPERATOR  11    @@ (tint, tint),
+  -- contains value
+  OPERATOR  20    @? (tint, integer),
+  -- contains set
+  OPERATOR  21    @? (tint, intset),
+  -- contains tint
+  OPERATOR  22    @? (tint, tint),
+  -- contained set
+  OPERATOR  30    ?@ (tint, intset),
+  -- contained tint
+  OPERATOR  31    ?@ (tint, tint),
+  -- equal set
+  OPERATOR  40    @= (tint, intset),
+  -- equal tint
+  OPERATOR  41    @= (tint, tint),
+  -- functions
+  FUNCTION   2    tint_gin_extract_value(integer, internal),
+  FUNCTION   3    tint_gin_extract_query(integer, internal, int2, internal, internal, internal, internal),
+  FUNCTION   6    tint_gin_triconsistent(internal, int2, integer, int4, internal, internal, internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS ttext_gin_ops
+  DEFAULT FOR TYPE ttext USING gin AS
+  STORAGE text,
+  -- overlap set
+  OPERATOR  10    @@ (ttext, textset),
+  -- overlap ttext
+  OPERATOR  11    @@ (ttext, ttext),
+  -- contains value
+  OPERATOR  20    @? (ttext, text),
+  -- contains set
+  OPERATOR  21    @? (ttext, textset),
+  -- contains ttext
+  OPERATOR  22    @? (ttext, ttext),
+  -- contained set
+  OPERATOR  30    ?@ (ttext, textset),
+  -- contained ttext
+  OPERATOR  31    ?@ (ttext, ttext),
+  -- equal set
+  OPERATOR  40    @= (ttext, textset),
+  -- equal ttext
+  OPERATOR  41    @= (ttext, ttext),
+  -- functions
+  FUNCTION   2    ttext_gin_extract_value(text, internal),
+  FUNCTION   3    ttext_gin_extract_query(text, internal, int2, internal, internal, internal, internal),
+  FUNCTION   6    ttext_gin_triconsistent(internal, int2, text, int4, internal, internal, internal);
+
+/******************************************************************************/
@@ -0,0 +1,62 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/*
+ * temporal_stats.sql
+ * Performance counters of the entry points of MobilityDB. The counters
+ * are collected when the configuration parameter mobilitydb.track_stats
+ * is enabled and expose where the time of a workload goes without
+ * attaching a profiler.
+ */
+
+/******************************************************************************/
+
+CREATE FUNCTION mobilitydb_stats(
+    OUT lifting_calls bigint,
+    OUT restrict_calls bigint,
+    OUT sync_calls bigint,
+    OUT wkb_in_calls bigint,
+    OUT wkb_in_bytes bigint,
+    OUT wkb_out_calls bigint,
+    OUT wkb_out_bytes bigint,
+    OUT cache_hits bigint,
+    OUT cache_misses bigint)
+  RETURNS record
+  AS 'MODULE_PATHNAME', 'Mobilitydb_stats'
+  LANGUAGE C STRICT PARALLEL SAFE;
+
+CREATE FUNCTION mobilitydb_stats_reset()
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Mobilitydb_stats_reset'
+  LANGUAGE C STRICT PARALLEL SAFE;
+
+CREATE VIEW mobilitydb_stats AS
+  SELECT * FROM mobilitydb_stats();
+
+/******************************************************************************/
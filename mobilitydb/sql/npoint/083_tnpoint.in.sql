@@ -502,6 +502,26 @@ CREATE FUNCTION minusValues(tnpoint, npointset)
   AS 'MODULE_PATHNAME', 'Temporal_minus_values'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION atRoute(tnpoint, bigint)
+  RETURNS tnpoint
+  AS 'MODULE_PATHNAME', 'Tnpoint_at_route'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION minusRoute(tnpoint, bigint)
+  RETURNS tnpoint
+  AS 'MODULE_PATHNAME', 'Tnpoint_minus_route'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION atRoutes(tnpoint, bigintset)
+  RETURNS tnpoint
+  AS 'MODULE_PATHNAME', 'Tnpoint_at_routes'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION minusRoutes(tnpoint, bigintset)
+  RETURNS tnpoint
+  AS 'MODULE_PATHNAME', 'Tnpoint_minus_routes'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION atTime(tnpoint, timestamptz)
   RETURNS tnpoint
   AS 'MODULE_PATHNAME', 'Temporal_at_timestamp'
@@ -689,9 +709,15 @@ CREATE FUNCTION temporal_hash(tnpoint)
   AS 'MODULE_PATHNAME', 'Temporal_hash'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION temporal_hash_extended(tnpoint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR CLASS tnpoint_hash_ops
   DEFAULT FOR TYPE tnpoint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tnpoint);
+    FUNCTION    1   temporal_hash(tnpoint),
+    FUNCTION    2   temporal_hash_extended(tnpoint, bigint);
 
 /******************************************************************************/
@@ -293,6 +293,16 @@ CREATE FUNCTION appendInstant(tgeogpoint, tgeogpoint)
   RETURNS tgeogpoint
   AS 'MODULE_PATHNAME', 'Temporal_append_tinstant'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+-- The tolerance argument enables the dead-reckoning filter, which drops
+-- appended instants predictable within the tolerance from their neighbours
+CREATE FUNCTION appendInstant(tgeompoint, tgeompoint, tolerance float)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_append_tinstant'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION appendInstant(tgeogpoint, tgeogpoint, tolerance float)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_append_tinstant'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION appendSequence(tgeompoint, tgeompoint)
   RETURNS tgeompoint
@@ -322,6 +332,35 @@ CREATE FUNCTION merge(tgeogpoint[])
 AS 'MODULE_PATHNAME', 'Temporal_merge_array'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+-- Snapshot + delta access pattern, see 022_temporal.in.sql
+-- The functions are not strict
+CREATE FUNCTION deltaAppend(tgeompoint, tgeompoint)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_delta_append'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaAppend(tgeogpoint, tgeogpoint)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_delta_append'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE FUNCTION deltaMerge(tgeompoint, tgeompoint)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_delta_merge'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaMerge(tgeogpoint, tgeogpoint)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_delta_merge'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE FUNCTION deltaCompact(tgeompoint, tgeompoint)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_delta_compact'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION deltaCompact(tgeogpoint, tgeogpoint)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_delta_compact'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 /******************************************************************************
  * Accessor Functions
  ******************************************************************************/
@@ -646,6 +685,10 @@ CREATE FUNCTION tpoint_supportfn(internal)
   AS 'MODULE_PATHNAME', 'Tpoint_supportfn'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+-- The support function also simplifies no-op calls at plan time, e.g.,
+-- expanding a box by a zero distance
+ALTER FUNCTION expandSpace(stbox, float) SUPPORT tpoint_supportfn;
+
 /*****************************************************************************
  * Ever/Always Comparison Functions
  *****************************************************************************/
@@ -936,6 +979,17 @@ CREATE FUNCTION stops(tgeogpoint, maxdist float DEFAULT 0.0,
   AS 'MODULE_PATHNAME', 'Temporal_stops'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION moves(tgeompoint, maxdist float DEFAULT 0.0,
+    minduration interval DEFAULT '0 minutes')
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_moves'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION moves(tgeogpoint, maxdist float DEFAULT 0.0,
+    minduration interval DEFAULT '0 minutes')
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_moves'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 
 /******************************************************************************
  * Multidimensional tiling
@@ -1128,14 +1182,25 @@ CREATE FUNCTION temporal_hash(tgeogpoint)
   AS 'MODULE_PATHNAME', 'Temporal_hash'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION temporal_hash_extended(tgeompoint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_hash_extended(tgeogpoint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR CLASS tgeompoint_hash_ops
   DEFAULT FOR TYPE tgeompoint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tgeompoint);
+    FUNCTION    1   temporal_hash(tgeompoint),
+    FUNCTION    2   temporal_hash_extended(tgeompoint, bigint);
 CREATE OPERATOR CLASS tgeogpoint_hash_ops
   DEFAULT FOR TYPE tgeogpoint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tgeogpoint);
+    FUNCTION    1   temporal_hash(tgeogpoint),
+    FUNCTION    2   temporal_hash_extended(tgeogpoint, bigint);
 
 /******************************************************************************/
 
@@ -80,6 +80,7 @@ CREATE FUNCTION setSRID(tgeogpoint, integer)
 CREATE FUNCTION transform(tgeompoint, integer)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_transform'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 -- Gauss Kruger transformation
@@ -200,6 +201,11 @@ CREATE FUNCTION twcentroid(tgeompoint)
   AS 'MODULE_PATHNAME', 'Tpoint_twcentroid'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION twcentroidApprox(tgeompoint, fraction float,
+    OUT point geometry, OUT error float)
+  AS 'MODULE_PATHNAME', 'Tpoint_twcentroid_approx'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION direction(tgeompoint)
   RETURNS float
   AS 'MODULE_PATHNAME', 'Tpoint_direction'
@@ -310,6 +316,15 @@ CREATE FUNCTION atStbox(tgeogpoint, stbox)
   AS 'MODULE_PATHNAME', 'Tpoint_at_stbox'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION atStbox(tgeompoint[], stbox)
+  RETURNS SETOF tgeompoint
+  AS 'MODULE_PATHNAME', 'Tpoint_arr_at_stbox'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION atStbox(tgeogpoint[], stbox)
+  RETURNS SETOF tgeogpoint
+  AS 'MODULE_PATHNAME', 'Tpoint_arr_at_stbox'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION minusStbox(tgeompoint, stbox)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_minus_stbox'
@@ -188,6 +188,19 @@ CREATE FUNCTION nearestApproachDistance(tgeogpoint, tgeogpoint)
   AS 'MODULE_PATHNAME', 'NAD_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+-- Batch versions returning the distances of the pairs of elements of the
+-- array that overlap on the time dimension, the positions are 1-based
+CREATE FUNCTION nearestApproachDistance(tgeompoint[],
+    OUT first integer, OUT second integer, OUT distance float)
+  RETURNS SETOF record
+  AS 'MODULE_PATHNAME', 'NAD_tpoint_arr'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION nearestApproachDistance(tgeogpoint[],
+    OUT first integer, OUT second integer, OUT distance float)
+  RETURNS SETOF record
+  AS 'MODULE_PATHNAME', 'NAD_tpoint_arr'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR |=| (
   LEFTARG = geometry, RIGHTARG = tgeompoint,
   PROCEDURE = nearestApproachDistance,
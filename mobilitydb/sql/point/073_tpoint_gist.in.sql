@@ -56,6 +56,16 @@ CREATE FUNCTION stbox_gist_distance(internal, stbox, smallint, oid, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'Stbox_gist_distance'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox_gist_fetch(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Stbox_gist_fetch'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+CREATE FUNCTION stbox_gist_sortsupport(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Stbox_gist_sortsupport'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
 
 CREATE OPERATOR CLASS stbox_rtree_ops
   DEFAULT FOR TYPE stbox USING gist AS
@@ -142,7 +152,12 @@ CREATE OPERATOR CLASS stbox_rtree_ops
   FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  stbox_gist_picksplit(internal, internal),
   FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
-  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
+  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal),
+  FUNCTION  9  stbox_gist_fetch(internal)
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  , FUNCTION  11  stbox_gist_sortsupport(internal)
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  ;
 
 /******************************************************************************/
 
@@ -244,7 +259,11 @@ CREATE OPERATOR CLASS tgeompoint_rtree_ops
   FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  stbox_gist_picksplit(internal, internal),
   FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
-  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
+  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal)
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  , FUNCTION  11  stbox_gist_sortsupport(internal)
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  ;
 
 CREATE OPERATOR CLASS tgeogpoint_rtree_ops
   DEFAULT FOR TYPE tgeogpoint USING gist AS
@@ -295,6 +314,120 @@ CREATE OPERATOR CLASS tgeogpoint_rtree_ops
   FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  stbox_gist_picksplit(internal, internal),
   FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
-  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
+  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal)
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  , FUNCTION  11  stbox_gist_sortsupport(internal)
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  ;
+
+/******************************************************************************/
+
+/******************************************************************************
+ * Alternative operator class for temporal geography points storing bounding
+ * boxes in geocentric (unit-sphere) coordinates, which stay tight when the
+ * point crosses the ±180° meridian or approaches a pole
+ ******************************************************************************/
+
+CREATE FUNCTION gist_tgeogpoint_geocentric_consistent(internal, tgeogpoint, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Stbox_gist_geocentric_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeogpoint_gist_geocentric_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tgeogpoint_gist_geocentric_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS tgeogpoint_geocentric_ops
+  FOR TYPE tgeogpoint USING gist AS
+  STORAGE stbox,
+  -- overlaps
+  OPERATOR  3    && (tgeogpoint, tstzspan),
+  OPERATOR  3    && (tgeogpoint, stbox),
+  OPERATOR  3    && (tgeogpoint, tgeogpoint),
+    -- same
+  OPERATOR  6    ~= (tgeogpoint, tstzspan),
+  OPERATOR  6    ~= (tgeogpoint, stbox),
+  OPERATOR  6    ~= (tgeogpoint, tgeogpoint),
+  -- contains
+  OPERATOR  7    @> (tgeogpoint, tstzspan),
+  OPERATOR  7    @> (tgeogpoint, stbox),
+  OPERATOR  7    @> (tgeogpoint, tgeogpoint),
+  -- contained by
+  OPERATOR  8    <@ (tgeogpoint, tstzspan),
+  OPERATOR  8    <@ (tgeogpoint, stbox),
+  OPERATOR  8    <@ (tgeogpoint, tgeogpoint),
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeogpoint, tstzspan),
+  OPERATOR  28    &<# (tgeogpoint, stbox),
+  OPERATOR  28    &<# (tgeogpoint, tgeogpoint),
+  -- strictly before
+  OPERATOR  29    <<# (tgeogpoint, tstzspan),
+  OPERATOR  29    <<# (tgeogpoint, stbox),
+  OPERATOR  29    <<# (tgeogpoint, tgeogpoint),
+  -- strictly after
+  OPERATOR  30    #>> (tgeogpoint, tstzspan),
+  OPERATOR  30    #>> (tgeogpoint, stbox),
+  OPERATOR  30    #>> (tgeogpoint, tgeogpoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeogpoint, tstzspan),
+  OPERATOR  31    #&> (tgeogpoint, stbox),
+  OPERATOR  31    #&> (tgeogpoint, tgeogpoint),
+  -- functions
+  FUNCTION  1  gist_tgeogpoint_geocentric_consistent(internal, tgeogpoint, smallint, oid, internal),
+  FUNCTION  2  stbox_gist_union(internal, internal),
+  FUNCTION  3  tgeogpoint_gist_geocentric_compress(internal),
+  FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
+  FUNCTION  6  stbox_gist_picksplit(internal, internal),
+  FUNCTION  7  stbox_gist_same(stbox, stbox, internal);
+
+/******************************************************************************/
+
+/******************************************************************************
+ * Maintenance statistics of the stbox-keyed GiST indexes. The counters are
+ * collected per backend, so they must be read on the connection that
+ * performed the index maintenance work, typically a dedicated loader
+ * session; growing average penalties and split overlap ratios indicate
+ * degrading indexes on which a REINDEX can be scheduled.
+ ******************************************************************************/
+
+CREATE FUNCTION tpoint_gist_stats(
+    OUT inserts bigint,
+    OUT penalty_calls bigint,
+    OUT penalty_avg float8,
+    OUT penalty_max float8,
+    OUT zero_penalties bigint,
+    OUT splits bigint,
+    OUT split_overlap_avg float8,
+    OUT split_overlap_max float8)
+  RETURNS record
+  AS 'MODULE_PATHNAME', 'Tpoint_gist_stats'
+  LANGUAGE C STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tpoint_gist_stats_reset()
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Tpoint_gist_stats_reset'
+  LANGUAGE C STRICT PARALLEL SAFE;
+
+CREATE VIEW tpoint_gist_stats AS
+  SELECT * FROM tpoint_gist_stats();
+
+/******************************************************************************/
+
+/******************************************************************************
+ * Space-time code for physical clustering
+ ******************************************************************************/
+
+CREATE FUNCTION spaceTimeCode(stbox)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Stbox_space_time_code'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION spaceTimeCode(tgeompoint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Tpoint_space_time_code'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION spaceTimeCode(tgeogpoint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Tpoint_space_time_code'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /******************************************************************************/
@@ -130,6 +130,15 @@ RETURNS tgeompoint
 AS 'MODULE_PATHNAME', 'Temporal_simplify_dp'
 LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION maxPointsSimplify(tfloat, integer, boolean DEFAULT TRUE)
+RETURNS tfloat
+AS 'MODULE_PATHNAME', 'Temporal_simplify_count'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION maxPointsSimplify(tgeompoint, integer, boolean DEFAULT TRUE)
+RETURNS tgeompoint
+AS 'MODULE_PATHNAME', 'Temporal_simplify_count'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE TYPE geom_times AS (
   geom geometry,
   times bigint[]
@@ -142,4 +151,11 @@ RETURNS geom_times
 AS 'MODULE_PATHNAME','Tpoint_AsMVTGeom'
 LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION asMVT(tpoint tgeompoint, bounds stbox,
+  extent int4 DEFAULT 4096, buffer int4 DEFAULT 256, clip bool DEFAULT TRUE,
+  name text DEFAULT 'default')
+RETURNS bytea
+AS 'MODULE_PATHNAME','Tpoint_as_mvt'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
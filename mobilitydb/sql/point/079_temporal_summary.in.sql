@@ -0,0 +1,80 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/*
+ * temporal_summary.sql
+ * Incremental maintenance of bounding box summaries with bounded staleness.
+ * A row trigger queues the bounding box of every inserted temporal point and
+ * a background worker periodically folds the queue into the summary table.
+ */
+
+/*
+ * The queue is unlogged on purpose: it only buffers boxes between two
+ * flushes and its content can be rebuilt from the monitored tables
+ */
+CREATE UNLOGGED TABLE mobilitydb_summary_queue (
+  tbl regclass NOT NULL,
+  key bigint NOT NULL,
+  box stbox NOT NULL
+);
+
+CREATE TABLE mobilitydb_summary (
+  tbl regclass NOT NULL,
+  key bigint NOT NULL,
+  box stbox NOT NULL,
+  PRIMARY KEY (tbl, key)
+);
+
+CREATE FUNCTION temporal_summary_queue_trigger()
+  RETURNS trigger
+  AS 'MODULE_PATHNAME', 'Temporal_summary_queue_trigger'
+  LANGUAGE C;
+
+CREATE FUNCTION mobilitydb_summary_flush()
+  RETURNS bigint
+  AS $$
+    WITH queued AS (
+      DELETE FROM @extschema@.mobilitydb_summary_queue
+      RETURNING tbl, key, box ),
+    boxes AS (
+      SELECT tbl, key, extent(box) AS box FROM queued GROUP BY tbl, key ),
+    merged AS (
+      INSERT INTO @extschema@.mobilitydb_summary AS s (tbl, key, box)
+      SELECT tbl, key, box FROM boxes
+      ON CONFLICT (tbl, key) DO UPDATE SET box = s.box + EXCLUDED.box
+      RETURNING 1 )
+    SELECT count(*) FROM merged;
+  $$ LANGUAGE SQL;
+
+CREATE FUNCTION mobilitydb_summary_start_worker()
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_summary_start_worker'
+  LANGUAGE C;
+
+/******************************************************************************/
@@ -333,6 +333,41 @@ oid_type(Oid typid)
   return T_UNKNOWN;
 }
 
+/**
+ * @brief Fetch the type number of an argument of the function being called,
+ * caching the resolved types in fn_extra across the calls of a query
+ *
+ * The argument types of a given FmgrInfo are fixed for the duration of the
+ * query, so the expression tree walk of get_fn_expr_argtype and the scan of
+ * the type Oid array are paid only on the first call, the way PostGIS caches
+ * its SRID lookups. The cache takes over fn_extra and thus cannot be used in
+ * set-returning functions, which keep their FuncCallContext there.
+ * @arg[in] fcinfo Call information
+ * @arg[in] argno Argument number
+ */
+meosType
+oid_type_cached(FunctionCallInfo fcinfo, int argno)
+{
+  FmgrInfo *flinfo = fcinfo->flinfo;
+  if (flinfo)
+  {
+    int16 *cache = (int16 *) flinfo->fn_extra;
+    if (! cache)
+    {
+      cache = MemoryContextAlloc(flinfo->fn_mcxt,
+        sizeof(int16) * FUNC_MAX_ARGS);
+      memset(cache, -1, sizeof(int16) * FUNC_MAX_ARGS);
+      flinfo->fn_extra = cache;
+    }
+    if (cache[argno] >= 0)
+      return (meosType) cache[argno];
+    meosType result = oid_type(get_fn_expr_argtype(flinfo, argno));
+    cache[argno] = (int16) result;
+    return result;
+  }
+  return oid_type(get_fn_expr_argtype(flinfo, argno));
+}
+
 /*****************************************************************************/
 
 /**
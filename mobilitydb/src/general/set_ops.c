@@ -58,7 +58,7 @@ Contains_set_value(PG_FUNCTION_ARGS)
 {
   Set *s = PG_GETARG_SET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = contains_set_value(s, d, basetype);
   PG_FREE_IF_COPY(s, 0);
   PG_RETURN_BOOL(result);
@@ -99,7 +99,7 @@ Contained_value_set(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Set *s = PG_GETARG_SET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = contained_value_set(d, basetype, s);
   PG_FREE_IF_COPY(s, 1);
   PG_RETURN_BOOL(result);
@@ -162,7 +162,7 @@ Left_value_set(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Set *s = PG_GETARG_SET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = left_value_set(d, basetype, s);
   PG_FREE_IF_COPY(s, 1);
   PG_RETURN_BOOL(result);
@@ -181,7 +181,7 @@ Left_set_value(PG_FUNCTION_ARGS)
 {
   Set *s = PG_GETARG_SET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = left_set_value(s, d, basetype);
   PG_FREE_IF_COPY(s, 0);
   PG_RETURN_BOOL(result);
@@ -222,7 +222,7 @@ Right_value_set(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Set *s = PG_GETARG_SET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = right_value_set(d, basetype, s);
   PG_FREE_IF_COPY(s, 1);
   PG_RETURN_BOOL(result);
@@ -241,7 +241,7 @@ Right_set_value(PG_FUNCTION_ARGS)
 {
   Set *s = PG_GETARG_SET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = right_set_value(s, d, basetype);
   PG_FREE_IF_COPY(s, 0);
   PG_RETURN_BOOL(result);
@@ -282,7 +282,7 @@ Overleft_value_set(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Set *s = PG_GETARG_SET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = overleft_value_set(d, basetype, s);
   PG_FREE_IF_COPY(s, 1);
   PG_RETURN_BOOL(result);
@@ -301,7 +301,7 @@ Overleft_set_value(PG_FUNCTION_ARGS)
 {
   Set *s = PG_GETARG_SET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = overleft_set_value(s, d, basetype);
   PG_FREE_IF_COPY(s, 0);
   PG_RETURN_BOOL(result);
@@ -342,7 +342,7 @@ Overright_value_set(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Set *s = PG_GETARG_SET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = overright_value_set(d, basetype, s);
   PG_FREE_IF_COPY(s, 1);
   PG_RETURN_BOOL(result);
@@ -361,7 +361,7 @@ Overright_set_value(PG_FUNCTION_ARGS)
 {
   Set *s = PG_GETARG_SET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = overright_set_value(s, d, basetype);
   PG_FREE_IF_COPY(s, 0);
   PG_RETURN_BOOL(result);
@@ -403,7 +403,7 @@ Union_value_set(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Set *s = PG_GETARG_SET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   Set *result = union_set_value(s, d, basetype);
   PG_FREE_IF_COPY(s, 1);
   PG_RETURN_POINTER(result);
@@ -424,7 +424,7 @@ Union_set_value(PG_FUNCTION_ARGS)
 {
   Set *s = PG_GETARG_SET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   Set *result = union_set_value(s, d, basetype);
   PG_FREE_IF_COPY(s, 0);
   PG_RETURN_POINTER(result);
@@ -467,7 +467,7 @@ Intersection_value_set(PG_FUNCTION_ARGS)
   Datum d = PG_GETARG_DATUM(0);
   Set *s = PG_GETARG_SET_P(1);
   Datum result;
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool found = intersection_set_value(s, d, basetype, &result);
   PG_FREE_IF_COPY(s, 1);
   if (! found)
@@ -488,7 +488,7 @@ Intersection_set_value(PG_FUNCTION_ARGS)
 {
   Set *s = PG_GETARG_SET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   Datum result;
   bool found = intersection_set_value(s, d, basetype, &result);
   PG_FREE_IF_COPY(s, 0);
@@ -536,7 +536,7 @@ Minus_value_set(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Set *s = PG_GETARG_SET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   Datum result;
   bool found = minus_value_set(d, basetype, s, &result);
   PG_FREE_IF_COPY(s, 1);
@@ -560,7 +560,7 @@ Minus_set_value(PG_FUNCTION_ARGS)
 {
   Set *s = PG_GETARG_SET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   Set *result = minus_set_value(s, d, basetype);
   PG_FREE_IF_COPY(s, 0);
   if (! result)
@@ -606,7 +606,7 @@ Distance_value_set(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Set *s = PG_GETARG_SET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   Span s1;
   set_set_span(s, &s1);
   double result = distance_span_value(&s1, d, basetype);
@@ -627,7 +627,7 @@ Distance_set_value(PG_FUNCTION_ARGS)
 {
   Set *s = PG_GETARG_SET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   Span s1;
   set_set_span(s, &s1);
   double result = distance_span_value(&s1, d, basetype);
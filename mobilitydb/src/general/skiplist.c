@@ -97,12 +97,12 @@ aggstate_write(SkipList *state, StringInfo buf)
   int i;
   void **values = skiplist_values(state);
   pq_sendint32(buf, (uint32) state->length);
+  /* Use a single SPI session for writing all the values of the state
+   * instead of opening and closing one per value */
+  SPI_connect();
   for (i = 0; i < state->length; i ++)
-  {
-    SPI_connect();
     temporal_write((Temporal *) values[i], buf);
-    SPI_finish();
-  }
+  SPI_finish();
   pq_sendint64(buf, state->extrasize);
   if (state->extra)
     pq_sendbytes(buf, state->extra, (int) state->extrasize);
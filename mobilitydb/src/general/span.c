@@ -189,7 +189,7 @@ Datum
 Value_to_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   Span *result = value_to_span(d, basetype);
   PG_RETURN_POINTER(result);
 }
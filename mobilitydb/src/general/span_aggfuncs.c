@@ -37,6 +37,7 @@
 /* PostgreSQL */
 #include <postgres.h>
 #include <fmgr.h>
+#include <libpq/pqformat.h>
 #include <utils/array.h>
 /* MEOS */
 #include <meos.h>
@@ -104,7 +105,7 @@ Spanbase_extent_transfn(PG_FUNCTION_ARGS)
   if (PG_ARGISNULL(1))
     PG_RETURN_POINTER(s);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   s = spanbase_extent_transfn(s, d, basetype);
   PG_RETURN_POINTER(s);
 }
@@ -219,6 +220,94 @@ Spanset_union_transfn(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(state);
 }
 
+PGDLLEXPORT Datum Span_union_combinefn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_union_combinefn);
+/*
+ * @brief Combine function for aggregating spans
+ *
+ * Appends the spans gathered by one worker's transition state to the
+ * other state so that the finalfn can sort and combine them as usual.
+ */
+Datum
+Span_union_combinefn(PG_FUNCTION_ARGS)
+{
+  MemoryContext aggContext;
+  if (! AggCheckCallContext(fcinfo, &aggContext))
+    elog(ERROR, "Span_union_combinefn called in non-aggregate context");
+
+  ArrayBuildState *state1 = PG_ARGISNULL(0) ? NULL :
+    (ArrayBuildState *) PG_GETARG_POINTER(0);
+  ArrayBuildState *state2 = PG_ARGISNULL(1) ? NULL :
+    (ArrayBuildState *) PG_GETARG_POINTER(1);
+  if (! state2)
+  {
+    if (! state1)
+      PG_RETURN_NULL();
+    PG_RETURN_POINTER(state1);
+  }
+  if (! state1)
+    state1 = initArrayResult(state2->element_type, aggContext, false);
+  for (int i = 0; i < state2->nelems; i++)
+    accumArrayResult(state1, state2->dvalues[i], false,
+      state2->element_type, aggContext);
+  PG_RETURN_POINTER(state1);
+}
+
+PGDLLEXPORT Datum Span_union_serialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_union_serialize);
+/*
+ * @brief Serialize the transition state of a span union aggregate
+ *
+ * The state is written as the span type Oid followed by the gathered spans,
+ * which have a fixed size.
+ */
+Datum
+Span_union_serialize(PG_FUNCTION_ARGS)
+{
+  ArrayBuildState *state = (ArrayBuildState *) PG_GETARG_POINTER(0);
+  StringInfoData buf;
+  pq_begintypsend(&buf);
+  pq_sendint32(&buf, (uint32) state->element_type);
+  pq_sendint32(&buf, (uint32) state->nelems);
+  for (int i = 0; i < state->nelems; i++)
+    pq_sendbytes(&buf, (char *) DatumGetSpanP(state->dvalues[i]),
+      sizeof(Span));
+  PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+PGDLLEXPORT Datum Span_union_deserialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_union_deserialize);
+/*
+ * @brief Deserialize the transition state of a span union aggregate
+ */
+Datum
+Span_union_deserialize(PG_FUNCTION_ARGS)
+{
+  MemoryContext aggContext;
+  if (! AggCheckCallContext(fcinfo, &aggContext))
+    elog(ERROR, "Span_union_deserialize called in non-aggregate context");
+
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  StringInfoData buf =
+  {
+    .data = VARDATA(data),
+    .len = VARSIZE(data) - VARHDRSZ,
+    .maxlen = VARSIZE(data) - VARHDRSZ,
+    .cursor = 0
+  };
+  Oid spanoid = (Oid) pq_getmsgint(&buf, 4);
+  int count = (int) pq_getmsgint(&buf, 4);
+  ArrayBuildState *state = initArrayResult(spanoid, aggContext, false);
+  for (int i = 0; i < count; i++)
+  {
+    Span s;
+    memcpy(&s, pq_getmsgbytes(&buf, sizeof(Span)), sizeof(Span));
+    accumArrayResult(state, SpanPGetDatum(&s), false, spanoid, aggContext);
+  }
+  pq_getmsgend(&buf);
+  PG_RETURN_POINTER(state);
+}
+
 PGDLLEXPORT Datum Span_union_finalfn(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Span_union_finalfn);
 /*
@@ -79,6 +79,165 @@ float8_qsort_cmp(const void *a1, const void *a2)
     return 1;
 }
 
+/*****************************************************************************/
+
+/**
+ * @brief Map the value of a span bound onto a 64-bit unsigned integer that
+ * sorts in the same order, or return false when the base type has no such
+ * mapping.
+ *
+ * Signed integers and timestamps only need their sign bit flipped. The bit
+ * pattern of an IEEE 754 double sorts correctly for positive values; for
+ * negative values the order is reversed, so flipping the sign bit of
+ * positive values and all bits of negative values yields a total order.
+ */
+static bool
+span_bound_radix_key(Datum val, meosType basetype, uint64 *key)
+{
+  switch (basetype)
+  {
+    case T_INT4:
+      *key = ((uint64) (int64) DatumGetInt32(val)) ^
+        UINT64CONST(0x8000000000000000);
+      return true;
+    case T_INT8:
+      *key = ((uint64) DatumGetInt64(val)) ^ UINT64CONST(0x8000000000000000);
+      return true;
+    case T_TIMESTAMPTZ:
+      *key = ((uint64) DatumGetTimestampTz(val)) ^
+        UINT64CONST(0x8000000000000000);
+      return true;
+    case T_FLOAT8:
+    {
+      double d = DatumGetFloat8(val);
+      uint64 bits;
+      memcpy(&bits, &d, sizeof(bits));
+      *key = (bits & UINT64CONST(0x8000000000000000)) ?
+        ~bits : (bits | UINT64CONST(0x8000000000000000));
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+/** Sort item of the radix sort: a 64-bit key and the original position */
+typedef struct
+{
+  uint64 key;  /**< Monotonic key of the element */
+  int pos;     /**< Position of the element in the input array */
+} RadixSortItem;
+
+/**
+ * @brief Sort an array of items in ascending order of their keys with a
+ * least-significant-digit radix sort.
+ *
+ * The sort is stable and performs one counting pass per key byte, skipping
+ * the bytes on which all keys agree, which for timestamp columns removes
+ * most of the passes. The result may end up in either buffer and thus the
+ * buffer holding it is returned.
+ * @param[in,out] a Array of items to be sorted
+ * @param[in,out] b Scratch buffer of the same length
+ * @param[in] count Number of items
+ */
+static RadixSortItem *
+analyze_radix_sort(RadixSortItem *a, RadixSortItem *b, int count)
+{
+  for (int shift = 0; shift < 64; shift += 8)
+  {
+    int counts[256] = { 0 };
+    for (int i = 0; i < count; i++)
+      counts[(a[i].key >> shift) & 0xFF]++;
+    /* Skip the pass when all keys have the same byte */
+    if (counts[(a[0].key >> shift) & 0xFF] == count)
+      continue;
+    int start = 0;
+    for (int j = 0; j < 256; j++)
+    {
+      int c = counts[j];
+      counts[j] = start;
+      start += c;
+    }
+    for (int i = 0; i < count; i++)
+      b[counts[(a[i].key >> shift) & 0xFF]++] = a[i];
+    RadixSortItem *tmp = a;
+    a = b;
+    b = tmp;
+  }
+  return a;
+}
+
+/**
+ * @brief Sort an array of span bounds collected by the analyze functions in
+ * ascending order.
+ *
+ * The bounds of a sample all have the same base type and are all lower
+ * (respectively all upper) bounds, so for base types with a monotonic 64-bit
+ * key the per-element comparisons through #span_bound_cmp are replaced by a
+ * radix sort of the keys. Ties on equal values are broken as in
+ * #span_bound_cmp by seeding the stable radix passes with the bounds grouped
+ * by inclusiveness. Other base types fall back to qsort.
+ */
+static void
+span_bound_sort(SpanBound *bounds, int count)
+{
+  uint64 key;
+  if (count < 2)
+    return;
+  if (! span_bound_radix_key(bounds[0].val, bounds[0].basetype, &key))
+  {
+    qsort(bounds, (size_t) count, sizeof(SpanBound), span_bound_qsort_cmp);
+    return;
+  }
+  RadixSortItem *items = palloc(sizeof(RadixSortItem) * count);
+  RadixSortItem *scratch = palloc(sizeof(RadixSortItem) * count);
+  /* For equal values an inclusive lower bound sorts before an exclusive one
+   * and conversely for upper bounds */
+  int n = 0;
+  for (int rank = 0; rank <= 1; rank++)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      int bound_rank = (bounds[i].lower == bounds[i].inclusive) ? 0 : 1;
+      if (bound_rank != rank)
+        continue;
+      span_bound_radix_key(bounds[i].val, bounds[i].basetype, &items[n].key);
+      items[n++].pos = i;
+    }
+  }
+  RadixSortItem *sorted = analyze_radix_sort(items, scratch, count);
+  SpanBound *copy = palloc(sizeof(SpanBound) * count);
+  for (int i = 0; i < count; i++)
+    copy[i] = bounds[sorted[i].pos];
+  memcpy(bounds, copy, sizeof(SpanBound) * count);
+  pfree(items); pfree(scratch); pfree(copy);
+}
+
+/**
+ * @brief Sort an array of span lengths in ascending order with the radix
+ * sort used for the span bounds
+ */
+static void
+span_length_sort(float8 *lengths, int count)
+{
+  if (count < 2)
+    return;
+  RadixSortItem *items = palloc(sizeof(RadixSortItem) * count);
+  RadixSortItem *scratch = palloc(sizeof(RadixSortItem) * count);
+  for (int i = 0; i < count; i++)
+  {
+    span_bound_radix_key(Float8GetDatum(lengths[i]), T_FLOAT8,
+      &items[i].key);
+    items[i].pos = i;
+  }
+  RadixSortItem *sorted = analyze_radix_sort(items, scratch, count);
+  float8 *copy = palloc(sizeof(float8) * count);
+  for (int i = 0; i < count; i++)
+    copy[i] = lengths[sorted[i].pos];
+  memcpy(lengths, copy, sizeof(float8) * count);
+  pfree(items); pfree(scratch); pfree(copy);
+}
+
 /**
  * @brief Compute statistics for time type columns and for the time dimension of
  * all temporal types whose subtype is not instant
@@ -110,10 +269,8 @@ span_compute_stats_generic(VacAttrStats *stats, int non_null_cnt, int *slot_idx,
     /* Generate a bounds histogram slot entry */
 
     /* Sort bound values */
-    qsort(lowers, (size_t) non_null_cnt, sizeof(SpanBound),
-      span_bound_qsort_cmp);
-    qsort(uppers, (size_t) non_null_cnt, sizeof(SpanBound),
-      span_bound_qsort_cmp);
+    span_bound_sort(lowers, non_null_cnt);
+    span_bound_sort(uppers, non_null_cnt);
 
     num_hist = non_null_cnt;
     if (num_hist > num_bins)
@@ -169,7 +326,7 @@ span_compute_stats_generic(VacAttrStats *stats, int non_null_cnt, int *slot_idx,
     /*
      * Ascending sort of span lengths for further filling of histogram
      */
-    qsort(lengths, (size_t) non_null_cnt, sizeof(float8), float8_qsort_cmp);
+    span_length_sort(lengths, non_null_cnt);
 
     num_hist = non_null_cnt;
     if (num_hist > num_bins)
@@ -63,7 +63,7 @@ Contains_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   PG_RETURN_BOOL(contains_span_value(s, d, basetype));
 }
 
@@ -100,7 +100,7 @@ Contained_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   PG_RETURN_BOOL(contained_value_span(d, basetype, s));
 }
 
@@ -157,7 +157,7 @@ Adjacent_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   PG_RETURN_BOOL(adjacent_span_value(s, d, basetype));
 }
 
@@ -174,7 +174,7 @@ Adjacent_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   PG_RETURN_BOOL(adjacent_span_value(s, d, basetype));
 }
 
@@ -211,7 +211,7 @@ Left_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   PG_RETURN_BOOL(left_value_span(d, basetype, s));
 }
 
@@ -228,7 +228,7 @@ Left_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   PG_RETURN_BOOL(left_span_value(s, d, basetype));
 }
 
@@ -265,7 +265,7 @@ Right_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   PG_RETURN_BOOL(right_value_span(d, basetype, s));
 }
 
@@ -282,7 +282,7 @@ Right_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   PG_RETURN_BOOL(right_span_value(s, d, basetype));
 }
 
@@ -319,7 +319,7 @@ Overleft_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   PG_RETURN_BOOL(overleft_value_span(d, basetype, s));
 }
 
@@ -336,7 +336,7 @@ Overleft_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   PG_RETURN_BOOL(overleft_span_value(s, d, basetype));
 }
 
@@ -373,7 +373,7 @@ Overright_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   PG_RETURN_BOOL(overright_value_span(d, basetype, s));
 }
 
@@ -390,7 +390,7 @@ Overright_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   PG_RETURN_BOOL(overright_span_value(s, d, basetype));
 }
 
@@ -427,7 +427,7 @@ Union_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   SpanSet *result = union_span_value(s, d, basetype);
   PG_RETURN_POINTER(result);
 }
@@ -445,7 +445,7 @@ Union_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   SpanSet *result = union_span_value(s, d, basetype);
   PG_RETURN_POINTER(result);
 }
@@ -483,7 +483,7 @@ Intersection_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   Datum result;
   bool found = intersection_span_value(s, d, basetype, &result);
   if (! found)
@@ -504,7 +504,7 @@ Intersection_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   Datum result;
   bool found = intersection_span_value(s, d, basetype, &result);
   if (! found)
@@ -548,7 +548,7 @@ Minus_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   Datum result;
   bool found = minus_value_span(d, basetype, s, &result);
   if (! found)
@@ -569,7 +569,7 @@ Minus_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   SpanSet *result = minus_span_value(s, d, basetype);
   if (! result)
     PG_RETURN_NULL();
@@ -613,7 +613,7 @@ Distance_value_value(PG_FUNCTION_ARGS)
 {
   Datum d1 = PG_GETARG_DATUM(0);
   Datum d2 = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   double result = distance_value_value(d1, d2, basetype);
   PG_RETURN_FLOAT8(result);
 }
@@ -631,7 +631,7 @@ Distance_value_span(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   double result = distance_span_value(s, d, basetype);
   PG_RETURN_FLOAT8(result);
 }
@@ -649,7 +649,7 @@ Distance_span_value(PG_FUNCTION_ARGS)
 {
   Span *s = PG_GETARG_SPAN_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   double result = distance_span_value(s, d, basetype);
   PG_RETURN_FLOAT8(result);
 }
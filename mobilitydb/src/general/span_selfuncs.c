@@ -42,9 +42,16 @@
 #include <math.h>
 /* PostgreSQL */
 #include <access/htup_details.h>
+#include <miscadmin.h>
 #include "utils/syscache.h"
 #include <utils/lsyscache.h>
 #include <catalog/pg_statistic.h>
+#include <storage/ipc.h>
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
+#include <utils/guc.h>
+#include <utils/hsearch.h>
+#include <utils/inval.h>
 #include <utils/timestamp.h>
 #include <math.h>
 /* MEOS */
@@ -604,28 +611,19 @@ span_sel_contains(SpanBound *const_lower, SpanBound *const_upper,
 /*****************************************************************************/
 
 /**
- * @brief Calculate span operator selectivity using histograms of span bounds.
- * @note Used by the selectivity functions and the debugging functions.
+ * @brief Calculate span operator selectivity using deserialized histograms
+ * of span bounds and, for the containment operators, a histogram of span
+ * lengths.
+ * @note Used both on histograms freshly deserialized from the statistics
+ * slots and on parsed copies taken from the shared histogram cache.
  */
 static double
-span_sel_hist1(AttStatsSlot *hslot, AttStatsSlot *lslot, const Span *constval,
+span_sel_hist_bounds(SpanBound *hist_lower, SpanBound *hist_upper, int nhist,
+  Datum *length_values, int length_nvalues, const Span *constval,
   meosOper oper)
 {
-  SpanBound *hist_lower, *hist_upper;
   SpanBound const_lower, const_upper;
   double selec;
-  int nhist, i;
-
-  /*
-   * Convert histogram of spans into histograms of its lower and upper
-   * bounds.
-   */
-  nhist = hslot->nvalues;
-  hist_lower = palloc(sizeof(SpanBound) * nhist);
-  hist_upper = palloc(sizeof(SpanBound) * nhist);
-  for (i = 0; i < nhist; i++)
-      span_deserialize(DatumGetSpanP(hslot->values[i]),
-        &hist_lower[i], &hist_upper[i]);
 
   /* Extract the bounds of the constant value. */
   span_deserialize(constval, &const_lower, &const_upper);
@@ -675,10 +673,10 @@ span_sel_hist1(AttStatsSlot *hslot, AttStatsSlot *lslot, const Span *constval,
       hist_upper, nhist);
   else if (oper == CONTAINS_OP)
     selec = span_sel_contains(&const_lower, &const_upper, hist_lower,
-      nhist, lslot->values, lslot->nvalues);
+      nhist, length_values, length_nvalues);
   else if (oper == CONTAINED_OP)
     selec = span_sel_contained(&const_lower, &const_upper, hist_lower,
-      nhist, lslot->values, lslot->nvalues);
+      nhist, length_values, length_nvalues);
   else if (oper == ADJACENT_OP)
     // TODO Analyze whether a similar approach as PostgreSQL selectivity
     // estimation for equality can be used. There, they estimate 1/n if
@@ -690,23 +688,412 @@ span_sel_hist1(AttStatsSlot *hslot, AttStatsSlot *lslot, const Span *constval,
     selec = -1.0;  /* keep compiler quiet */
   }
 
+  return selec;
+}
+
+/**
+ * @brief Calculate span operator selectivity using histograms of span bounds.
+ * @note Used by the selectivity functions and the debugging functions.
+ */
+static double
+span_sel_hist1(AttStatsSlot *hslot, AttStatsSlot *lslot, const Span *constval,
+  meosOper oper)
+{
+  SpanBound *hist_lower, *hist_upper;
+  double selec;
+  int nhist, i;
+
+  /*
+   * Convert histogram of spans into histograms of its lower and upper
+   * bounds.
+   */
+  nhist = hslot->nvalues;
+  hist_lower = palloc(sizeof(SpanBound) * nhist);
+  hist_upper = palloc(sizeof(SpanBound) * nhist);
+  for (i = 0; i < nhist; i++)
+      span_deserialize(DatumGetSpanP(hslot->values[i]),
+        &hist_lower[i], &hist_upper[i]);
+
+  /* The length slot is only fetched for the containment operators */
+  bool contains = (oper == CONTAINS_OP || oper == CONTAINED_OP);
+  selec = span_sel_hist_bounds(hist_lower, hist_upper, nhist,
+    contains ? lslot->values : NULL, contains ? lslot->nvalues : 0,
+    constval, oper);
+
   pfree(hist_lower); pfree(hist_upper);
 
   return selec;
 }
 
+/*****************************************************************************
+ * Shared histogram cache
+ *
+ * The parsing of the statistics slots above is repeated on every planning
+ * cycle: the histogram of spans is fetched from pg_statistic and every span
+ * is deserialized into its bounds. The backend-local memo cache further
+ * below removes this cost only within a session, which is of no help when a
+ * connection pool hands every short-lived query to a different backend.
+ * This cache keeps the parsed bound and length histograms in shared memory,
+ * keyed by the relation, attribute, histogram kind, and the xmin of the
+ * pg_statistic tuple they were built from. The xmin changes whenever ANALYZE
+ * stores new statistics, so a new version is simply built under a new key
+ * and the superseded entry ages out of the cache.
+ *
+ * The cache is available only when the extension is loaded through
+ * shared_preload_libraries and is controlled by the following configuration
+ * parameters
+ * - mobilitydb.shared_statistics enables the cache (disabled by default)
+ * - mobilitydb.shared_statistics_entries fixes the number of cache slots
+ *****************************************************************************/
+
+/**
+ * Maximum number of histogram bounds stored in a cache entry, covering the
+ * default statistics target; larger histograms are parsed per planning
+ * cycle as before
+ */
+#define SPANHIST_MAX_BINS 101
+
+/**
+ * Structure to represent the key of the shared histogram cache
+ */
+typedef struct SpanHistCacheKey
+{
+  Oid relid;           /**< Relation of the statistics tuple */
+  int16 attnum;        /**< Attribute of the statistics tuple */
+  int16 value;         /**< True for value histograms, false for time ones */
+  TransactionId xmin;  /**< Version stamp of the pg_statistic tuple */
+} SpanHistCacheKey;
+
+/**
+ * Structure to represent an entry of the shared histogram cache. An entry
+ * with fewer than two bounds records that the statistics tuple holds no
+ * usable histogram, which spares the slot fetch of subsequent cycles.
+ */
+typedef struct SpanHistCacheEntry
+{
+  SpanHistCacheKey key;  /**< Hash key (must be the first field) */
+  uint32 usage;          /**< Usage counter driving the eviction */
+  int nhist;             /**< Number of bounds of the histogram */
+  int nlength;           /**< Number of values of the length histogram */
+  SpanBound hist_lower[SPANHIST_MAX_BINS]; /**< Lower bounds */
+  SpanBound hist_upper[SPANHIST_MAX_BINS]; /**< Upper bounds */
+  double lengths[SPANHIST_MAX_BINS];       /**< Length histogram values */
+} SpanHistCacheEntry;
+
+/* Configuration parameters */
+static bool _spanhist_enabled = false;
+static int _spanhist_entries = 128;
+
+/* Shared hash table holding the parsed histograms */
+static HTAB *_spanhist_hash = NULL;
+/* Lock protecting the shared hash table */
+static LWLock *_spanhist_lock = NULL;
+
+/* Saved hook values, the hooks are chained */
+#if POSTGRESQL_VERSION_NUMBER >= 150000
+static shmem_request_hook_type prev_shmem_request_hook = NULL;
+#endif /* POSTGRESQL_VERSION_NUMBER >= 150000 */
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+
+/**
+ * @brief Request the shared memory needed by the cache
+ */
+static void
+span_hist_shmem_request(void)
+{
+#if POSTGRESQL_VERSION_NUMBER >= 150000
+  if (prev_shmem_request_hook)
+    prev_shmem_request_hook();
+#endif /* POSTGRESQL_VERSION_NUMBER >= 150000 */
+  RequestAddinShmemSpace(hash_estimate_size(_spanhist_entries,
+    sizeof(SpanHistCacheEntry)));
+  RequestNamedLWLockTranche("mobilitydb_spanhist", 1);
+}
+
+/**
+ * @brief Initialize the shared hash table at postmaster startup
+ */
+static void
+span_hist_shmem_startup(void)
+{
+  if (prev_shmem_startup_hook)
+    prev_shmem_startup_hook();
+
+  HASHCTL info;
+  memset(&info, 0, sizeof(info));
+  info.keysize = sizeof(SpanHistCacheKey);
+  info.entrysize = sizeof(SpanHistCacheEntry);
+  LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+  _spanhist_hash = ShmemInitHash("MobilityDB shared histogram cache",
+    _spanhist_entries, _spanhist_entries, &info, HASH_ELEM | HASH_BLOBS);
+  _spanhist_lock = &(GetNamedLWLockTranche("mobilitydb_spanhist"))->lock;
+  LWLockRelease(AddinShmemInitLock);
+}
+
+/**
+ * @brief Register the configuration parameters and the shared memory hooks
+ * of the cache, called from the initialization of the extension
+ */
+void
+span_hist_shcache_init(void)
+{
+  DefineCustomBoolVariable("mobilitydb.shared_statistics",
+    "Cache parsed span histograms in shared memory",
+    NULL, &_spanhist_enabled, false, PGC_SUSET, 0, NULL, NULL, NULL);
+  DefineCustomIntVariable("mobilitydb.shared_statistics_entries",
+    "Number of entries of the shared cache of parsed span histograms",
+    NULL, &_spanhist_entries, 128, 8, 8192, PGC_POSTMASTER, 0,
+    NULL, NULL, NULL);
+
+  /* The shared hash table can only be created when the extension is loaded
+   * through shared_preload_libraries */
+  if (! process_shared_preload_libraries_in_progress)
+    return;
+
+#if POSTGRESQL_VERSION_NUMBER >= 150000
+  prev_shmem_request_hook = shmem_request_hook;
+  shmem_request_hook = span_hist_shmem_request;
+#else
+  span_hist_shmem_request();
+#endif /* POSTGRESQL_VERSION_NUMBER >= 150000 */
+  prev_shmem_startup_hook = shmem_startup_hook;
+  shmem_startup_hook = span_hist_shmem_startup;
+}
+
+/**
+ * @brief Return true if the cache is operational and fill the cache key of
+ * the statistics tuple of the variable
+ */
+static bool
+span_hist_cache_key(const VariableStatData *vardata, bool value,
+  SpanHistCacheKey *key)
+{
+  if (! _spanhist_enabled || _spanhist_hash == NULL ||
+      ! HeapTupleIsValid(vardata->statsTuple))
+    return false;
+  Form_pg_statistic stats =
+    (Form_pg_statistic) GETSTRUCT(vardata->statsTuple);
+  /* The key is hashed as a sequence of bytes and thus the padding of the
+   * structure must be zeroed */
+  memset(key, 0, sizeof(SpanHistCacheKey));
+  key->relid = stats->starelid;
+  key->attnum = stats->staattnum;
+  key->value = (int16) value;
+  key->xmin = HeapTupleHeaderGetXmin(vardata->statsTuple->t_data);
+  return true;
+}
+
+/**
+ * @brief Return in the output parameters palloc'd copies of the parsed
+ * histograms of a cache entry
+ * @return False when the histograms are not in the cache
+ */
+static bool
+span_hist_cache_lookup(const SpanHistCacheKey *key, SpanBound **hist_lower,
+  SpanBound **hist_upper, int *nhist, Datum **length_values, int *nlength)
+{
+  LWLockAcquire(_spanhist_lock, LW_SHARED);
+  SpanHistCacheEntry *entry = hash_search(_spanhist_hash, key, HASH_FIND,
+    NULL);
+  if (entry == NULL)
+  {
+    LWLockRelease(_spanhist_lock);
+    return false;
+  }
+  /* The counter only drives the eviction, a torn increment under the
+   * shared lock is harmless */
+  entry->usage++;
+  *nhist = entry->nhist;
+  *nlength = entry->nlength;
+  *hist_lower = NULL; *hist_upper = NULL; *length_values = NULL;
+  if (entry->nhist > 0)
+  {
+    *hist_lower = palloc(sizeof(SpanBound) * entry->nhist);
+    *hist_upper = palloc(sizeof(SpanBound) * entry->nhist);
+    memcpy(*hist_lower, entry->hist_lower, sizeof(SpanBound) * entry->nhist);
+    memcpy(*hist_upper, entry->hist_upper, sizeof(SpanBound) * entry->nhist);
+  }
+  if (entry->nlength > 0)
+  {
+    *length_values = palloc(sizeof(Datum) * entry->nlength);
+    for (int i = 0; i < entry->nlength; i++)
+      (*length_values)[i] = Float8GetDatum(entry->lengths[i]);
+  }
+  LWLockRelease(_spanhist_lock);
+  return true;
+}
+
+/**
+ * @brief Evict the least-used entry of the shared hash table
+ * @note The caller must hold the cache lock in exclusive mode
+ */
+static void
+span_hist_cache_evict(void)
+{
+  HASH_SEQ_STATUS status;
+  SpanHistCacheEntry *entry, *victim = NULL;
+  hash_seq_init(&status, _spanhist_hash);
+  while ((entry = hash_seq_search(&status)) != NULL)
+  {
+    if (victim == NULL || entry->usage < victim->usage)
+      victim = entry;
+    /* Age the counters so that past popularity fades away */
+    entry->usage /= 2;
+  }
+  if (victim != NULL)
+    hash_search(_spanhist_hash, &victim->key, HASH_REMOVE, NULL);
+}
+
+/**
+ * @brief Parse the histograms of a statistics tuple and store them in the
+ * shared cache, returning palloc'd copies in the output parameters
+ * @return False when the histograms do not fit in a cache entry, in which
+ * case the caller falls back to the uncached path
+ */
+static bool
+span_hist_cache_build(const VariableStatData *vardata, bool value,
+  const SpanHistCacheKey *key, SpanBound **hist_lower, SpanBound **hist_upper,
+  int *nhist, Datum **length_values, int *nlength)
+{
+  AttStatsSlot hslot, lslot;
+  *hist_lower = NULL; *hist_upper = NULL; *length_values = NULL;
+  *nhist = *nlength = 0;
+
+  int stats_kind = value ?
+    STATISTIC_KIND_VALUE_BOUNDS_HISTOGRAM :
+    STATISTIC_KIND_TIME_BOUNDS_HISTOGRAM;
+  if (get_attstatsslot(&hslot, vardata->statsTuple, stats_kind, InvalidOid,
+        ATTSTATSSLOT_VALUES))
+  {
+    /* Histograms larger than a cache entry or whose base type is passed by
+     * reference cannot be stored in shared memory */
+    if (hslot.nvalues > SPANHIST_MAX_BINS ||
+        (hslot.nvalues > 0 &&
+         ! basetype_byvalue(DatumGetSpanP(hslot.values[0])->basetype)))
+    {
+      free_attstatsslot(&hslot);
+      return false;
+    }
+    *nhist = hslot.nvalues;
+    if (*nhist > 0)
+    {
+      *hist_lower = palloc(sizeof(SpanBound) * *nhist);
+      *hist_upper = palloc(sizeof(SpanBound) * *nhist);
+      for (int i = 0; i < *nhist; i++)
+        span_deserialize(DatumGetSpanP(hslot.values[i]),
+          &(*hist_lower)[i], &(*hist_upper)[i]);
+    }
+    free_attstatsslot(&hslot);
+  }
+
+  /* The length histogram is stored along so that the entry serves the
+   * containment operators as well */
+  stats_kind = value ?
+    STATISTIC_KIND_VALUE_LENGTH_HISTOGRAM :
+    STATISTIC_KIND_TIME_LENGTH_HISTOGRAM;
+  if (get_attstatsslot(&lslot, vardata->statsTuple, stats_kind, InvalidOid,
+        ATTSTATSSLOT_VALUES))
+  {
+    if (lslot.nvalues > SPANHIST_MAX_BINS)
+    {
+      free_attstatsslot(&lslot);
+      if (*hist_lower)
+      {
+        pfree(*hist_lower); pfree(*hist_upper);
+      }
+      return false;
+    }
+    *nlength = lslot.nvalues;
+    if (*nlength > 0)
+    {
+      *length_values = palloc(sizeof(Datum) * *nlength);
+      memcpy(*length_values, lslot.values, sizeof(Datum) * *nlength);
+    }
+    free_attstatsslot(&lslot);
+  }
+
+  LWLockAcquire(_spanhist_lock, LW_EXCLUSIVE);
+  bool found;
+  if (hash_get_num_entries(_spanhist_hash) >= _spanhist_entries)
+    span_hist_cache_evict();
+  SpanHistCacheEntry *entry = hash_search(_spanhist_hash, key,
+    HASH_ENTER_NULL, &found);
+  /* Another backend may have built the entry first or the table is full */
+  if (entry != NULL && ! found)
+  {
+    entry->usage = 1;
+    entry->nhist = *nhist;
+    entry->nlength = *nlength;
+    if (*nhist > 0)
+    {
+      memcpy(entry->hist_lower, *hist_lower, sizeof(SpanBound) * *nhist);
+      memcpy(entry->hist_upper, *hist_upper, sizeof(SpanBound) * *nhist);
+    }
+    for (int i = 0; i < *nlength; i++)
+      entry->lengths[i] = DatumGetFloat8((*length_values)[i]);
+  }
+  LWLockRelease(_spanhist_lock);
+  return true;
+}
+
+/**
+ * @brief Calculate span operator selectivity using the parsed histograms of
+ * the shared cache
+ * @return False when the cache cannot serve the estimate, in which case the
+ * caller falls back to the uncached path
+ */
+static bool
+span_hist_cache_sel(const VariableStatData *vardata, const Span *constval,
+  meosOper oper, bool value, double *selec)
+{
+  SpanHistCacheKey key;
+  if (! span_hist_cache_key(vardata, value, &key))
+    return false;
+
+  SpanBound *hist_lower, *hist_upper;
+  Datum *length_values;
+  int nhist, nlength;
+  if (! span_hist_cache_lookup(&key, &hist_lower, &hist_upper, &nhist,
+        &length_values, &nlength) &&
+      ! span_hist_cache_build(vardata, value, &key, &hist_lower, &hist_upper,
+        &nhist, &length_values, &nlength))
+    return false;
+
+  /* As in the uncached path, a missing or dummy histogram yields no
+   * estimate, likewise for the length histogram of the containment
+   * operators */
+  if (nhist < 2 ||
+      ((oper == CONTAINS_OP || oper == CONTAINED_OP) && nlength < 2))
+    *selec = -1.0;
+  else
+    *selec = span_sel_hist_bounds(hist_lower, hist_upper, nhist,
+      length_values, nlength, constval, oper);
+
+  if (hist_lower)
+  {
+    pfree(hist_lower); pfree(hist_upper);
+  }
+  if (length_values)
+    pfree(length_values);
+  return true;
+}
+
 /**
  * @brief Calculate span operator selectivity using histograms of span bounds.
  *
  * This estimate is for the portion of values that are not NULL.
  */
-double
-span_sel_hist(VariableStatData *vardata, const Span *constval, meosOper oper,
-  bool value)
+static double
+span_sel_hist_internal(VariableStatData *vardata, const Span *constval,
+  meosOper oper, bool value)
 {
   AttStatsSlot hslot, lslot;
   double selec;
 
+  /* Serve the estimate from the parsed histograms of the shared cache */
+  if (span_hist_cache_sel(vardata, constval, oper, value, &selec))
+    return selec;
+
   memset(&hslot, 0, sizeof(hslot));
 
   int stats_kind = value ?
@@ -758,6 +1145,135 @@ span_sel_hist(VariableStatData *vardata, const Span *constval, meosOper oper,
   return selec;
 }
 
+/*****************************************************************************
+ * Selectivity memo cache
+ *
+ * Workloads that plan many short parameterized queries estimate the same
+ * predicates over and over, re-reading pg_statistic and re-running the
+ * histogram walk on every planning cycle. The results are memoized in a
+ * backend-local hash table keyed by the relation, attribute, operator, and
+ * constant span of the estimate. The cache is flushed when the statistics
+ * of pg_statistic or the relation cache are invalidated.
+ *****************************************************************************/
+
+/**
+ * Structure to represent the key of the selectivity memo cache
+ */
+typedef struct SpanSelCacheKey
+{
+  Oid relid;       /**< Relation of the statistics tuple */
+  int16 attnum;    /**< Attribute of the statistics tuple */
+  int16 oper;      /**< Operator of the estimate */
+  int32 value;     /**< True for value histograms, false for time ones */
+  Span span;       /**< Constant span of the estimate */
+} SpanSelCacheKey;
+
+/**
+ * Structure to represent an entry of the selectivity memo cache
+ */
+typedef struct SpanSelCacheEntry
+{
+  SpanSelCacheKey key;  /**< Hash key (must be the first field) */
+  double selec;         /**< Memoized selectivity estimate */
+} SpanSelCacheEntry;
+
+static HTAB *spansel_cache = NULL;
+
+/**
+ * @brief Remove from the cache the entries of the given relation, or all
+ * entries when the whole relation cache is invalidated
+ */
+static void
+spansel_cache_relcache_callback(Datum arg __attribute__((unused)), Oid relid)
+{
+  HASH_SEQ_STATUS status;
+  SpanSelCacheEntry *entry;
+  hash_seq_init(&status, spansel_cache);
+  while ((entry = (SpanSelCacheEntry *) hash_seq_search(&status)) != NULL)
+  {
+    if (relid == InvalidOid || entry->key.relid == relid)
+      hash_search(spansel_cache, &entry->key, HASH_REMOVE, NULL);
+  }
+  return;
+}
+
+/**
+ * @brief Flush the cache when pg_statistic is updated, e.g., by ANALYZE
+ */
+static void
+spansel_cache_syscache_callback(Datum arg __attribute__((unused)),
+  int cacheid __attribute__((unused)),
+  uint32 hashvalue __attribute__((unused)))
+{
+  spansel_cache_relcache_callback((Datum) 0, InvalidOid);
+  return;
+}
+
+/**
+ * @brief Create the selectivity memo cache and register its invalidation
+ * callbacks
+ */
+static void
+spansel_cache_init(void)
+{
+  HASHCTL ctl;
+  memset(&ctl, 0, sizeof(ctl));
+  ctl.keysize = sizeof(SpanSelCacheKey);
+  ctl.entrysize = sizeof(SpanSelCacheEntry);
+  spansel_cache = hash_create("MobilityDB selectivity cache", 256, &ctl,
+    HASH_ELEM | HASH_BLOBS);
+  CacheRegisterRelcacheCallback(spansel_cache_relcache_callback, (Datum) 0);
+  CacheRegisterSyscacheCallback(STATRELATTINH,
+    spansel_cache_syscache_callback, (Datum) 0);
+  return;
+}
+
+/**
+ * @brief Calculate span operator selectivity using histograms of span bounds,
+ * memoizing the estimate for repeated planning of the same predicate
+ *
+ * This estimate is for the portion of values that are not NULL.
+ */
+double
+span_sel_hist(VariableStatData *vardata, const Span *constval, meosOper oper,
+  bool value)
+{
+  /* Without a statistics tuple there is no histogram walk to memoize */
+  if (! HeapTupleIsValid(vardata->statsTuple))
+    return span_sel_hist_internal(vardata, constval, oper, value);
+
+  Form_pg_statistic stats =
+    (Form_pg_statistic) GETSTRUCT(vardata->statsTuple);
+  SpanSelCacheKey key;
+  /* The key is hashed as a sequence of bytes and thus the padding of the
+   * structure and of the span must be zeroed */
+  memset(&key, 0, sizeof(key));
+  key.relid = stats->starelid;
+  key.attnum = stats->staattnum;
+  key.oper = (int16) oper;
+  key.value = (int32) value;
+  key.span.spantype = constval->spantype;
+  key.span.basetype = constval->basetype;
+  key.span.lower_inc = constval->lower_inc;
+  key.span.upper_inc = constval->upper_inc;
+  key.span.lower = constval->lower;
+  key.span.upper = constval->upper;
+
+  if (! spansel_cache)
+    spansel_cache_init();
+  bool found;
+  SpanSelCacheEntry *entry = (SpanSelCacheEntry *) hash_search(spansel_cache,
+    &key, HASH_FIND, &found);
+  if (found)
+    return entry->selec;
+
+  double selec = span_sel_hist_internal(vardata, constval, oper, value);
+  entry = (SpanSelCacheEntry *) hash_search(spansel_cache, &key, HASH_ENTER,
+    &found);
+  entry->selec = selec;
+  return selec;
+}
+
 /*****************************************************************************/
 
 /**
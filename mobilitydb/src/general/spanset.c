@@ -190,7 +190,7 @@ Datum
 Value_to_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   SpanSet *result = value_to_spanset(d, basetype);
   PG_RETURN_POINTER(result);
 }
@@ -112,7 +112,7 @@ Contains_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = contains_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 0);
   PG_RETURN_BOOL(result);
@@ -190,7 +190,7 @@ Contained_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = contained_value_spanset(d, basetype, ss);
   PG_FREE_IF_COPY(ss, 1);
   PG_RETURN_BOOL(result);
@@ -327,7 +327,7 @@ Adjacent_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = adjacent_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 1);
   PG_RETURN_BOOL(result);
@@ -346,7 +346,7 @@ Adjacent_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = adjacent_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 0);
   PG_RETURN_BOOL(result);
@@ -424,7 +424,7 @@ Left_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = left_value_spanset(d, basetype, ss);
   PG_FREE_IF_COPY(ss, 1);
   PG_RETURN_BOOL(result);
@@ -461,7 +461,7 @@ Left_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = left_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 0);
   PG_RETURN_BOOL(result);
@@ -521,7 +521,7 @@ Right_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = right_value_spanset(d, basetype, ss);
   PG_FREE_IF_COPY(ss, 1);
   PG_RETURN_BOOL(result);
@@ -558,7 +558,7 @@ Right_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = right_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 0);
   PG_RETURN_BOOL(result);
@@ -618,7 +618,7 @@ Overleft_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = overleft_value_spanset(d, basetype, ss);
   PG_FREE_IF_COPY(ss, 1);
   PG_RETURN_BOOL(result);
@@ -637,7 +637,7 @@ Overleft_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = overleft_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 0);
   PG_RETURN_BOOL(result);
@@ -715,7 +715,7 @@ Overright_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool result = overright_value_spanset(d, basetype, ss);
   PG_FREE_IF_COPY(ss, 1);
   PG_RETURN_BOOL(result);
@@ -734,7 +734,7 @@ Overright_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool result = overright_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 0);
   PG_RETURN_BOOL(result);
@@ -812,7 +812,7 @@ Union_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   SpanSet *result = union_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 1);
   PG_RETURN_POINTER(result);
@@ -849,7 +849,7 @@ Union_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   SpanSet *result = union_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 0);
   PG_RETURN_POINTER(result);
@@ -909,7 +909,7 @@ Intersection_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   Datum result;
   bool found = intersection_spanset_value(ss, d, basetype, &result);
   PG_FREE_IF_COPY(ss, 1);
@@ -951,7 +951,7 @@ Intersection_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   Datum result;
   bool found = intersection_spanset_value(ss, d, basetype, &result);
   PG_FREE_IF_COPY(ss, 0);
@@ -1019,7 +1019,7 @@ Minus_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   Datum result;
   bool found = minus_value_spanset(d, basetype, ss, &result);
   PG_FREE_IF_COPY(ss, 1);
@@ -1061,7 +1061,7 @@ Minus_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   SpanSet *result = minus_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 0);
   if (! result)
@@ -1127,7 +1127,7 @@ Distance_value_spanset(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   SpanSet *ss = PG_GETARG_SPANSET_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   double result = distance_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 1);
   PG_RETURN_FLOAT8(result);
@@ -1165,7 +1165,7 @@ Distance_spanset_value(PG_FUNCTION_ARGS)
 {
   SpanSet *ss = PG_GETARG_SPANSET_P(0);
   Datum d = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   double result = distance_spanset_value(ss, d, basetype);
   PG_FREE_IF_COPY(ss, 0);
   PG_RETURN_FLOAT8(result);
@@ -40,6 +40,8 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/temporaltypes.h"
+/* MobilityDB */
+#include "pg_general/type_util.h"
 
 /*****************************************************************************
  * Temporal and
@@ -92,8 +94,10 @@ PG_FUNCTION_INFO_V1(Tand_tbool_tbool);
 Datum
 Tand_tbool_tbool(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   Temporal *result = boolop_tbool_tbool(temp1, temp2, &datum_and);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
@@ -153,8 +157,10 @@ PG_FUNCTION_INFO_V1(Tor_tbool_tbool);
 Datum
 Tor_tbool_tbool(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   Temporal *result = boolop_tbool_tbool(temp1, temp2, &datum_or);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
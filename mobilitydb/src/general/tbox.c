@@ -167,7 +167,7 @@ Number_timestamp_to_tbox(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   TBox *result = number_timestamp_to_tbox(d, basetype, t);
   PG_RETURN_POINTER(result);
 }
@@ -184,7 +184,7 @@ Number_period_to_tbox(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
   Span *p = PG_GETARG_SPAN_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   TBox *result = number_period_to_tbox(d, basetype, p);
   PG_RETURN_POINTER(result);
 }
@@ -236,7 +236,7 @@ Datum
 Number_to_tbox(PG_FUNCTION_ARGS)
 {
   Datum d = PG_GETARG_DATUM(0);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   TBox *result = palloc(sizeof(TBox));
   number_set_tbox(d, basetype, result);
   PG_RETURN_POINTER(result);
@@ -573,7 +573,7 @@ Tbox_shift_value(PG_FUNCTION_ARGS)
 {
   TBox *box = PG_GETARG_TBOX_P(0);
   Datum shift = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   ensure_same_span_basetype(&box->span, basetype);
   TBox *result = tbox_shift_scale_value(box, shift, 0, true, false);
   PG_RETURN_POINTER(result);
@@ -607,7 +607,7 @@ Tbox_scale_value(PG_FUNCTION_ARGS)
 {
   TBox *box = PG_GETARG_TBOX_P(0);
   Datum width = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   ensure_same_span_basetype(&box->span, basetype);
   TBox *result = tbox_shift_scale_value(box, 0, width, false, true);
   PG_RETURN_POINTER(result);
@@ -642,8 +642,8 @@ Tbox_shift_scale_value(PG_FUNCTION_ARGS)
   TBox *box = PG_GETARG_TBOX_P(0);
   Datum shift = PG_GETARG_DATUM(1);
   Datum width = PG_GETARG_DATUM(2);
-  meosType basetype1 = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
-  meosType basetype2 = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 2));
+  meosType basetype1 = oid_type_cached(fcinfo, 1);
+  meosType basetype2 = oid_type_cached(fcinfo, 2);
   ensure_same_span_basetype(&box->span, basetype1);
   ensure_same_span_basetype(&box->span, basetype2);
   TBox *result = tbox_shift_scale_value(box, shift, width, true, true);
@@ -36,6 +36,7 @@
 
 /* C */
 #include <assert.h>
+#include <float.h>
 /* PostgreSQL */
 #if POSTGRESQL_VERSION_NUMBER >= 130000
   #include <access/heaptoast.h>
@@ -45,6 +46,11 @@
 #endif
 #include <libpq/pqformat.h>
 #include <funcapi.h>
+#include <miscadmin.h>
+#include <access/htup_details.h>
+#include <nodes/execnodes.h>
+#include <utils/guc.h>
+#include <utils/tuplestore.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -56,9 +62,13 @@
 /* MobilityDB */
 #include "pg_general/doxygen_mobilitydb_api.h"
 #include "pg_general/meos_catalog.h"
+#include "pg_general/span_selfuncs.h"
+#include "pg_general/temporal_shcache.h"
+#include "pg_general/temporal_summary.h"
 #include "pg_general/tinstant.h"
 #include "pg_general/tsequence.h"
 #include "pg_general/type_util.h"
+#include "pg_point/tpoint_gist.h"
 #include "pg_point/tpoint_spatialfuncs.h"
 
 /* To avoid including fmgrprotos.h */
@@ -74,6 +84,32 @@ PG_MODULE_MAGIC;
  * Initialization function
  *****************************************************************************/
 
+/* Value of the mobilitydb.track_stats configuration parameter */
+static bool _track_stats = false;
+
+/**
+ * @brief Propagate the mobilitydb.track_stats configuration parameter to
+ * the performance counters of MEOS
+ */
+static void
+track_stats_assign(bool newval, void *extra __attribute__((unused)))
+{
+  meos_stats_enable(newval);
+}
+
+/**
+ * @brief Interrupt callback polled by the long MEOS operations
+ *
+ * A pending query cancellation makes CHECK_FOR_INTERRUPTS raise the error
+ * itself, so the callback never requests an interruption from MEOS
+ */
+static bool
+mobilitydb_interrupt_callback(void *arg __attribute__((unused)))
+{
+  CHECK_FOR_INTERRUPTS();
+  return false;
+}
+
 /**
  * @brief Initialize the MobilityDB extension
  */
@@ -82,6 +118,15 @@ _PG_init(void)
 {
   /* elog(WARNING, "This is MobilityDB."); */
   temporalgeom_init();
+  tpoint_gist_guc_init();
+  temporal_shcache_init();
+  span_hist_shcache_init();
+  temporal_summary_guc_init();
+  meos_initialize_interrupt_callback(&mobilitydb_interrupt_callback, NULL);
+  DefineCustomBoolVariable("mobilitydb.track_stats",
+    "Collect performance counters on the entry points of MobilityDB",
+    NULL, &_track_stats, false, PGC_SUSET, 0, NULL, track_stats_assign,
+    NULL);
 }
 
 /*****************************************************************************
@@ -342,6 +387,196 @@ temporal_bbox_slice(Datum tempdatum, void *box)
   return;
 }
 
+/**
+ * @brief Peek into a temporal datum to find the time span. If the datum
+ * needs to be detoasted, extract only the header and not the full object.
+ */
+void
+temporal_period_slice(Datum tempdatum, Span *p)
+{
+  Temporal *temp = NULL;
+  if (PG_DATUM_NEEDS_DETOAST((struct varlena *) tempdatum))
+    temp = (Temporal *) PG_DETOAST_DATUM_SLICE(tempdatum, 0,
+      temporal_max_header_size());
+  else
+    temp = (Temporal *) tempdatum;
+  temporal_set_period(temp, p);
+  PG_FREE_IF_COPY_P(temp, DatumGetPointer(tempdatum));
+  return;
+}
+
+/**
+ * @brief Peek into a temporal number datum to find the value span. If the
+ * datum needs to be detoasted, extract only the header and not the full
+ * object.
+ */
+void
+tnumber_span_slice(Datum tempdatum, Span *s)
+{
+  Temporal *temp = NULL;
+  if (PG_DATUM_NEEDS_DETOAST((struct varlena *) tempdatum))
+    temp = (Temporal *) PG_DETOAST_DATUM_SLICE(tempdatum, 0,
+      temporal_max_header_size());
+  else
+    temp = (Temporal *) tempdatum;
+  tnumber_set_span(temp, s);
+  PG_FREE_IF_COPY_P(temp, DatumGetPointer(tempdatum));
+  return;
+}
+
+/**
+ * @brief Peek into a temporal datum to find the number of instants. If the
+ * datum needs to be detoasted, extract only the header and not the full
+ * object.
+ */
+int
+temporal_count_slice(Datum tempdatum)
+{
+  Temporal *temp = NULL;
+  if (PG_DATUM_NEEDS_DETOAST((struct varlena *) tempdatum))
+    temp = (Temporal *) PG_DETOAST_DATUM_SLICE(tempdatum, 0,
+      temporal_max_header_size());
+  else
+    temp = (Temporal *) tempdatum;
+  int result;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    result = 1;
+  else if (temp->subtype == TSEQUENCE)
+    result = ((TSequence *) temp)->count;
+  else /* temp->subtype == TSEQUENCESET */
+    result = ((TSequenceSet *) temp)->totalcount;
+  PG_FREE_IF_COPY_P(temp, DatumGetPointer(tempdatum));
+  return result;
+}
+
+/* Number of bytes fetched for an instant whose size is not yet known. The
+ * guess covers all temporal instants of the alphanumeric types as well as
+ * temporal point instants with their precomputed bounding box */
+#define TEMPORAL_INSTANT_SLICE_SIZE 128
+
+/**
+ * @brief Detoast a slice of a temporal datum given by an offset into the
+ * temporal value and a number of bytes
+ * @note TOAST slices are addressed on the bytes that follow the varlena
+ * header, while the offsets computed from the temporal structs include it,
+ * so the requested offset is shifted back by the header size. The requested
+ * bytes start at `VARDATA` of the result, which is always a fresh copy
+ */
+static struct varlena *
+temporal_fetch_slice(Datum tempdatum, size_t offset, size_t len)
+{
+  assert(offset >= VARHDRSZ);
+  return (struct varlena *) PG_DETOAST_DATUM_SLICE(tempdatum,
+    offset - VARHDRSZ, len);
+}
+
+/**
+ * @brief Read one entry of an offsets array stored at a given position of a
+ * temporal datum
+ */
+static size_t
+temporal_offset_slice(Datum tempdatum, size_t offset)
+{
+  struct varlena *sl = temporal_fetch_slice(tempdatum, offset,
+    sizeof(size_t));
+  size_t result;
+  memcpy(&result, VARDATA(sl), sizeof(size_t));
+  pfree(sl);
+  return result;
+}
+
+/**
+ * @brief Read the instant stored at a given position of a temporal datum
+ */
+static TInstant *
+tinstant_fetch_slice(Datum tempdatum, size_t offset)
+{
+  struct varlena *sl = temporal_fetch_slice(tempdatum, offset,
+    TEMPORAL_INSTANT_SLICE_SIZE);
+  /* The instant records its actual size; refetch if the guess fell short,
+   * e.g., for geometries with additional dimensions */
+  TInstant instbuf;
+  memcpy(&instbuf, VARDATA(sl), sizeof(TInstant));
+  size_t size = VARSIZE(&instbuf);
+  if (size > VARSIZE(sl) - VARHDRSZ)
+  {
+    pfree(sl);
+    sl = temporal_fetch_slice(tempdatum, offset, size);
+  }
+  TInstant *result = palloc(size);
+  memcpy(result, VARDATA(sl), size);
+  pfree(sl);
+  return result;
+}
+
+/**
+ * @brief Peek into a temporal datum to extract its first or last instant.
+ * If the datum needs to be detoasted, compute the position of the instant
+ * from the header fields and extract only the slices of the value leading
+ * to it instead of the full object.
+ * @note With compressed TOAST storage a slice still decompresses the value
+ * up to the last requested byte, but it avoids fetching, decompressing, and
+ * copying the remainder, which dominates for long sequences.
+ */
+TInstant *
+temporal_instant_slice(Datum tempdatum, bool last)
+{
+  /* Read the header to obtain the subtype and the size fields */
+  Temporal *temp = (Temporal *) PG_DETOAST_DATUM_SLICE(tempdatum, 0,
+    temporal_max_header_size());
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+  {
+    /* The value is a single instant and thus cannot be sliced */
+    pfree(temp);
+    return (TInstant *) PG_DETOAST_DATUM(tempdatum);
+  }
+
+  /* Position of the sequence holding the instant and its size fields */
+  size_t seqpos;
+  int count, maxcount;
+  int16 bboxsize;
+  if (temp->subtype == TSEQUENCE)
+  {
+    TSequence *seq = (TSequence *) temp;
+    seqpos = 0;
+    count = seq->count;
+    maxcount = seq->maxcount;
+    bboxsize = seq->bboxsize;
+  }
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    TSequenceSet *ss = (TSequenceSet *) temp;
+    size_t datapos = offsetof(TSequenceSet, period) + ss->bboxsize +
+      sizeof(size_t) * ss->maxcount;
+    size_t off = 0;
+    if (last && ss->count > 1)
+      off = temporal_offset_slice(tempdatum, offsetof(TSequenceSet, period) +
+        ss->bboxsize + sizeof(size_t) * (ss->count - 1));
+    seqpos = datapos + off;
+    /* Read the fixed-size header of the composing sequence */
+    struct varlena *sl = temporal_fetch_slice(tempdatum, seqpos,
+      sizeof(TSequence));
+    TSequence seqbuf;
+    memcpy(&seqbuf, VARDATA(sl), sizeof(TSequence));
+    pfree(sl);
+    count = seqbuf.count;
+    maxcount = seqbuf.maxcount;
+    bboxsize = seqbuf.bboxsize;
+  }
+  pfree(temp);
+
+  size_t datapos = seqpos + offsetof(TSequence, period) + bboxsize +
+    sizeof(size_t) * maxcount;
+  /* The first instant is stored at the start of the data area */
+  size_t off = 0;
+  if (last && count > 1)
+    off = temporal_offset_slice(tempdatum, seqpos +
+      offsetof(TSequence, period) + bboxsize + sizeof(size_t) * (count - 1));
+  return tinstant_fetch_slice(tempdatum, datapos + off);
+}
+
 /*****************************************************************************
  * Version functions
  *****************************************************************************/
@@ -377,6 +612,53 @@ Mobilitydb_full_version(PG_FUNCTION_ARGS __attribute__((unused)))
   PG_RETURN_TEXT_P(result);
 }
 
+/*****************************************************************************
+ * Performance statistics functions
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Mobilitydb_stats(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Mobilitydb_stats);
+/**
+ * @ingroup mobilitydb_temporal_accessor
+ * @brief Performance counters of the entry points of MobilityDB
+ * @sqlfunc mobilitydb_stats()
+ */
+Datum
+Mobilitydb_stats(PG_FUNCTION_ARGS)
+{
+  TupleDesc tupdesc;
+  if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    elog(ERROR, "return type must be a row type");
+  MeosStats stats = meos_stats();
+  Datum values[9];
+  bool nulls[9] = { false };
+  values[0] = Int64GetDatum(stats.lifting_calls);
+  values[1] = Int64GetDatum(stats.restrict_calls);
+  values[2] = Int64GetDatum(stats.sync_calls);
+  values[3] = Int64GetDatum(stats.wkb_in_calls);
+  values[4] = Int64GetDatum(stats.wkb_in_bytes);
+  values[5] = Int64GetDatum(stats.wkb_out_calls);
+  values[6] = Int64GetDatum(stats.wkb_out_bytes);
+  values[7] = Int64GetDatum(stats.cache_hits);
+  values[8] = Int64GetDatum(stats.cache_misses);
+  HeapTuple tuple = heap_form_tuple(tupdesc, values, nulls);
+  PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+PGDLLEXPORT Datum Mobilitydb_stats_reset(PG_FUNCTION_ARGS __attribute__((unused)));
+PG_FUNCTION_INFO_V1(Mobilitydb_stats_reset);
+/**
+ * @ingroup mobilitydb_temporal_accessor
+ * @brief Reset the performance counters of MobilityDB
+ * @sqlfunc mobilitydb_stats_reset()
+ */
+Datum
+Mobilitydb_stats_reset(PG_FUNCTION_ARGS __attribute__((unused)))
+{
+  meos_stats_reset();
+  PG_RETURN_VOID();
+}
+
 /*****************************************************************************
  * Send and receive functions
  * The send and receive functions are needed for temporal aggregation
@@ -417,10 +699,25 @@ tinstant_write(const TInstant *inst, StringInfo buf)
 {
   meosType basetype = temptype_basetype(inst->temptype);
   bytea *bt = call_send(T_TIMESTAMPTZ, TimestampTzGetDatum(inst->t));
-  bytea *bv = call_send(basetype, tinstant_value(inst));
   pq_sendbytes(buf, VARDATA(bt), VARSIZE(bt) - VARHDRSZ);
-  pq_sendint32(buf, VARSIZE(bv) - VARHDRSZ);
-  pq_sendbytes(buf, VARDATA(bv), VARSIZE(bv) - VARHDRSZ);
+  if (basetype == T_DOUBLE2 || basetype == T_DOUBLE3 || basetype == T_DOUBLE4)
+  {
+    /* The doubleN accumulators of the temporal aggregates are written
+     * directly since their send functions output the raw struct bytes; this
+     * avoids one intermediate bytea per instant when the parallel workers
+     * serialize their aggregate state */
+    int size = (basetype == T_DOUBLE2) ? (int) sizeof(double2) :
+      (basetype == T_DOUBLE3) ? (int) sizeof(double3) :
+      (int) sizeof(double4);
+    pq_sendint32(buf, size);
+    pq_sendbytes(buf, DatumGetPointer(tinstant_value(inst)), size);
+  }
+  else
+  {
+    bytea *bv = call_send(basetype, tinstant_value(inst));
+    pq_sendint32(buf, VARSIZE(bv) - VARHDRSZ);
+    pq_sendbytes(buf, VARDATA(bv), VARSIZE(bv) - VARHDRSZ);
+  }
 }
 
 /*****************************************************************************/
@@ -998,6 +1295,15 @@ PG_FUNCTION_INFO_V1(Temporal_start_value);
 Datum
 Temporal_start_value(PG_FUNCTION_ARGS)
 {
+  Datum tempdatum = PG_GETARG_DATUM(0);
+  if (PG_DATUM_NEEDS_DETOAST((struct varlena *) tempdatum))
+  {
+    /* Extract only the first instant instead of detoasting the full value */
+    TInstant *inst = temporal_instant_slice(tempdatum, false);
+    Datum result = tinstant_value_copy(inst);
+    pfree(inst);
+    PG_RETURN_DATUM(result);
+  }
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   Datum result = temporal_start_value(temp);
   PG_FREE_IF_COPY(temp, 0);
@@ -1014,6 +1320,15 @@ PG_FUNCTION_INFO_V1(Temporal_end_value);
 Datum
 Temporal_end_value(PG_FUNCTION_ARGS)
 {
+  Datum tempdatum = PG_GETARG_DATUM(0);
+  if (PG_DATUM_NEEDS_DETOAST((struct varlena *) tempdatum))
+  {
+    /* Extract only the last instant instead of detoasting the full value */
+    TInstant *inst = temporal_instant_slice(tempdatum, true);
+    Datum result = tinstant_value_copy(inst);
+    pfree(inst);
+    PG_RETURN_DATUM(result);
+  }
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   Datum result = temporal_end_value(temp);
   PG_FREE_IF_COPY(temp, 0);
@@ -1217,11 +1532,24 @@ Datum
 Temporal_sequences(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
-  int count;
-  TSequence **sequences = temporal_sequences(temp, &count);
-  ArrayType *result = temporalarr_to_array((const Temporal **) sequences,
-    count);
-  pfree_array((void **) sequences, count);
+  ArrayType *result;
+  if (temp->subtype == TSEQUENCESET)
+  {
+    /* Build the array straight from the in-place component sequences
+     * instead of copying each of them beforehand */
+    const TSequence **sequences =
+      tsequenceset_sequences_p((TSequenceSet *) temp);
+    result = temporalarr_to_array((const Temporal **) sequences,
+      ((TSequenceSet *) temp)->count);
+    pfree(sequences);
+  }
+  else
+  {
+    int count;
+    TSequence **sequences = temporal_sequences(temp, &count);
+    result = temporalarr_to_array((const Temporal **) sequences, count);
+    pfree_array((void **) sequences, count);
+  }
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_ARRAYTYPE_P(result);
 }
@@ -1271,6 +1599,10 @@ PG_FUNCTION_INFO_V1(Temporal_start_instant);
 Datum
 Temporal_start_instant(PG_FUNCTION_ARGS)
 {
+  Datum tempdatum = PG_GETARG_DATUM(0);
+  if (PG_DATUM_NEEDS_DETOAST((struct varlena *) tempdatum))
+    /* Extract only the first instant instead of detoasting the full value */
+    PG_RETURN_POINTER(temporal_instant_slice(tempdatum, false));
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   TInstant *result = tinstant_copy(temporal_start_instant(temp));
   PG_FREE_IF_COPY(temp, 0);
@@ -1287,6 +1619,10 @@ PG_FUNCTION_INFO_V1(Temporal_end_instant);
 Datum
 Temporal_end_instant(PG_FUNCTION_ARGS)
 {
+  Datum tempdatum = PG_GETARG_DATUM(0);
+  if (PG_DATUM_NEEDS_DETOAST((struct varlena *) tempdatum))
+    /* Extract only the last instant instead of detoasting the full value */
+    PG_RETURN_POINTER(temporal_instant_slice(tempdatum, true));
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   TInstant *result = tinstant_copy(temporal_end_instant(temp));
   PG_FREE_IF_COPY(temp, 0);
@@ -1359,10 +1695,10 @@ PG_FUNCTION_INFO_V1(Temporal_start_timestamp);
 Datum
 Temporal_start_timestamp(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
-  TimestampTz result = temporal_start_timestamp(temp);
-  PG_FREE_IF_COPY(temp, 0);
-  PG_RETURN_TIMESTAMPTZ(result);
+  /* The bounding period records the first timestamp: peek only the header */
+  Span p;
+  temporal_period_slice(PG_GETARG_DATUM(0), &p);
+  PG_RETURN_TIMESTAMPTZ(DatumGetTimestampTz(p.lower));
 }
 
 PGDLLEXPORT Datum Temporal_end_timestamp(PG_FUNCTION_ARGS);
@@ -1375,10 +1711,10 @@ PG_FUNCTION_INFO_V1(Temporal_end_timestamp);
 Datum
 Temporal_end_timestamp(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
-  TimestampTz result = temporal_end_timestamp(temp);
-  PG_FREE_IF_COPY(temp, 0);
-  PG_RETURN_TIMESTAMPTZ(result);
+  /* The bounding period records the last timestamp: peek only the header */
+  Span p;
+  temporal_period_slice(PG_GETARG_DATUM(0), &p);
+  PG_RETURN_TIMESTAMPTZ(DatumGetTimestampTz(p.upper));
 }
 
 PGDLLEXPORT Datum Temporal_timestamp_n(PG_FUNCTION_ARGS);
@@ -1423,111 +1759,62 @@ Temporal_timestamps(PG_FUNCTION_ARGS)
  * Unnest function
  *****************************************************************************/
 
-/**
- * @brief Create the initial state that persists across multiple calls of the
- * function
- * @param[in] temp Temporal value
- * @param[in] values Array of values appearing in the temporal value
- * @param[in] count Number of elements in the input array
- */
-TempUnnestState *
-temporal_unnest_state_make(const Temporal *temp, Datum *values, int count)
-{
-  TempUnnestState *state = palloc0(sizeof(TempUnnestState));
-  /* Fill in state */
-  state->done = false;
-  state->i = 0;
-  state->count = count;
-  state->values = values;
-  state->temp = temporal_copy(temp);
-  return state;
-}
-
-/**
- * @brief Increment the current state to the next unnest value
- * @param[in] state State to increment
- */
-void
-temporal_unnest_state_next(TempUnnestState *state)
-{
-  if (!state || state->done)
-    return;
-  /* Move to the next bucket */
-  state->i++;
-  if (state->i == state->count)
-    state->done = true;
-  return;
-}
-
 PGDLLEXPORT Datum Temporal_unnest(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Temporal_unnest);
 /**
  * @brief Generate a list of values and associated period sets.
+ * @note The result set is materialized in a tuplestore in a single pass over
+ * the temporal value, which detoasts the value once and avoids the function
+ * call and memory context switch that the value-per-call protocol pays for
+ * every row.
  */
 Datum
 Temporal_unnest(PG_FUNCTION_ARGS)
 {
-  FuncCallContext *funcctx;
-  TempUnnestState *state;
+  ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+  if (! rsinfo || ! IsA(rsinfo, ReturnSetInfo) ||
+      ! (rsinfo->allowedModes & SFRM_Materialize))
+    ereport(ERROR,
+      (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+       errmsg("set-valued function called in context that cannot accept a set")));
+
+  /* Create the tuplestore in the memory context that outlives the call */
+  MemoryContext oldcontext =
+    MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+  TupleDesc tupdesc;
+  get_call_result_type(fcinfo, NULL, &tupdesc);
+  tupdesc = CreateTupleDescCopy(tupdesc);
+  Tuplestorestate *tupstore = tuplestore_begin_heap(
+    (rsinfo->allowedModes & SFRM_Materialize_Random) != 0, false, work_mem);
+  rsinfo->returnMode = SFRM_Materialize;
+  rsinfo->setResult = tupstore;
+  rsinfo->setDesc = tupdesc;
+  MemoryContextSwitchTo(oldcontext);
+
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  ensure_nonlinear_interpolation(temp->flags);
+  int count;
+  Datum *values = temporal_values(temp, &count);
+  Datum tuple_arr[2]; /* used to construct the composite return values */
   bool isnull[2] = {0,0}; /* needed to say no value is null */
-  Datum tuple_arr[2]; /* used to construct the composite return value */
-  HeapTuple tuple;
-  Datum result; /* the actual composite return value */
-
-  /* If the function is being called for the first time */
-  if (SRF_IS_FIRSTCALL())
-  {
-    /* Initialize the FuncCallContext */
-    funcctx = SRF_FIRSTCALL_INIT();
-    /* Switch to memory context appropriate for multiple function calls */
-    MemoryContext oldcontext =
-      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
-    /* Get input parameters */
-    Temporal *temp = PG_GETARG_TEMPORAL_P(0);
-    ensure_nonlinear_interpolation(temp->flags);
-    /* Create function state */
-    int count;
-    Datum *values = temporal_values(temp, &count);
-    funcctx->user_fctx = temporal_unnest_state_make(temp, values, count);
-    /* Build a tuple description for the function output */
-    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
-    BlessTupleDesc(funcctx->tuple_desc);
-    MemoryContextSwitchTo(oldcontext);
-  }
-
-  /* Stuff done on every call of the function */
-  funcctx = SRF_PERCALL_SETUP();
-  /* Get state */
-  state = funcctx->user_fctx;
-  /* Stop when we've used up all buckets */
-  if (state->done)
+  for (int i = 0; i < count; i++)
   {
-    /* Switch to memory context appropriate for multiple function calls */
-    MemoryContext oldcontext =
-      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
-    // pfree(state->values);
-    // pfree(state->temp);
-    pfree(state);
-    MemoryContextSwitchTo(oldcontext);
-    SRF_RETURN_DONE(funcctx);
+    /* Get value */
+    tuple_arr[0] = values[i];
+    /* Get period set */
+    Temporal *rest = temporal_restrict_value(temp, values[i], REST_AT);
+    if (! rest)
+      elog(ERROR, "Unexpected error with temporal value %s",
+        temporal_out(temp, OUT_DEFAULT_DECIMAL_DIGITS));
+    SpanSet *time = temporal_time(rest);
+    pfree(rest);
+    tuple_arr[1] = PointerGetDatum(time);
+    tuplestore_putvalues(tupstore, tupdesc, tuple_arr, isnull);
+    pfree(time);
   }
-
-  /* Get value */
-  tuple_arr[0] = state->values[state->i];
-  /* Get period set */
-  Temporal *rest = temporal_restrict_value(state->temp,
-    state->values[state->i], REST_AT);
-  if (!rest)
-    elog(ERROR, "Unexpected error with temporal value %s",
-      temporal_out(state->temp, OUT_DEFAULT_DECIMAL_DIGITS));
-  tuple_arr[1] = PointerGetDatum(temporal_time(rest));
-  pfree(rest);
-  /* Advance state */
-  temporal_unnest_state_next(state);
-  /* Form tuple and return */
-  tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
-  result = HeapTupleGetDatum(tuple);
-  SRF_RETURN_NEXT(funcctx, result);
+  pfree(values);
+  PG_FREE_IF_COPY(temp, 0);
+  return (Datum) 0;
 }
 
 /*****************************************************************************
@@ -1848,7 +2135,7 @@ Tnumber_shift_value(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   Datum shift = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   ensure_same_temporal_basetype(temp, basetype);
   Temporal *result = tnumber_shift_scale_value(temp, shift, 0, true, false);
   PG_FREE_IF_COPY(temp, 0);
@@ -1867,7 +2154,7 @@ Tnumber_scale_value(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   Datum duration = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   ensure_same_temporal_basetype(temp, basetype);
   Temporal *result = tnumber_shift_scale_value(temp, 0, duration, false, true);
   PG_FREE_IF_COPY(temp, 0);
@@ -1887,9 +2174,9 @@ Tnumber_shift_scale_value(PG_FUNCTION_ARGS)
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   Datum shift = PG_GETARG_DATUM(1);
   Datum duration = PG_GETARG_DATUM(2);
-  meosType basetype1 = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype1 = oid_type_cached(fcinfo, 1);
   ensure_same_temporal_basetype(temp, basetype1);
-  meosType basetype2 = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 2));
+  meosType basetype2 = oid_type_cached(fcinfo, 2);
   ensure_same_temporal_basetype(temp, basetype2);
   Temporal *result = tnumber_shift_scale_value(temp, shift, duration, true, true);
   PG_FREE_IF_COPY(temp, 0);
@@ -1966,8 +2253,22 @@ Temporal_append_tinstant(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   TInstant *inst = PG_GETARG_TINSTANT_P(1);
-  Temporal *result = temporal_append_tinstant(temp, inst, 0.0, NULL, false);
-  PG_FREE_IF_COPY(temp, 0);
+  /* When the function is used as the transition function of an aggregate or
+   * a window function, the first argument is a transition value that we are
+   * allowed to scribble on, as done, e.g., by array_append. In that case we
+   * append with the expandable representation: the instant is written in
+   * place when there is spare room and the capacity of the value is doubled
+   * when it is full, so that building a value of n instants costs O(n)
+   * overall instead of the O(n^2) of one full copy per appended instant */
+  bool expand = AggCheckCallContext(fcinfo, NULL) != 0;
+  /* Take into account the tolerance of the dead-reckoning filter */
+  double tolerance = 0.0;
+  if (PG_NARGS() > 2 && ! PG_ARGISNULL(2))
+    tolerance = PG_GETARG_FLOAT8(2);
+  Temporal *result = temporal_append_tinstant(temp, inst, 0.0, NULL,
+    tolerance, expand);
+  if (! expand)
+    PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(inst, 1);
   PG_RETURN_POINTER(result);
 }
@@ -1984,8 +2285,11 @@ Temporal_append_tsequence(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   TSequence *seq = PG_GETARG_TSEQUENCE_P(1);
-  Temporal *result = temporal_append_tsequence(temp, seq, false);
-  PG_FREE_IF_COPY(temp, 0);
+  /* See the comment in Temporal_append_tinstant above */
+  bool expand = AggCheckCallContext(fcinfo, NULL) != 0;
+  Temporal *result = temporal_append_tsequence(temp, seq, expand);
+  if (! expand)
+    PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(seq, 1);
   PG_RETURN_POINTER(result);
 }
@@ -2032,6 +2336,110 @@ Temporal_merge_array(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Snapshot + delta access pattern
+ *
+ * Tables holding evolving values, for example the current trip of each
+ * vehicle, pay O(trip length) per position report when a single column is
+ * updated with appendInstant: every UPDATE detoasts and rewrites the whole
+ * growing value. The functions below support splitting such a column into a
+ * stable base value (the snapshot) and a small delta value accumulating the
+ * recent reports, so that the hot write path only rewrites the delta:
+ *
+ *   UPDATE vehicles SET trip_delta = deltaAppend(trip_delta, report);
+ *   SELECT deltaMerge(trip_base, trip_delta) FROM vehicles;  -- read
+ *   UPDATE vehicles SET trip_base = deltaCompact(trip_base, trip_delta),
+ *     trip_delta = NULL;                          -- periodic compaction
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Temporal_delta_append(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_delta_append);
+/**
+ * @ingroup mobilitydb_temporal_transf
+ * @brief Append an instant to the delta value of a snapshot + delta pair,
+ * starting a new delta value when the current one is null
+ * @sqlfunc deltaAppend()
+ */
+Datum
+Temporal_delta_append(PG_FUNCTION_ARGS)
+{
+  if (PG_ARGISNULL(1))
+  {
+    if (PG_ARGISNULL(0))
+      PG_RETURN_NULL();
+    PG_RETURN_POINTER(PG_GETARG_TEMPORAL_P(0));
+  }
+  TInstant *inst = PG_GETARG_TINSTANT_P(1);
+  if (PG_ARGISNULL(0))
+  {
+    /* Start a new delta value from the instant, as a sequence so that the
+     * subsequent appends can use the expandable representation */
+    interpType interp = MEOS_FLAGS_GET_CONTINUOUS(inst->flags) ?
+      LINEAR : STEP;
+    Temporal *result = (Temporal *) tinstant_to_tsequence(inst, interp);
+    PG_FREE_IF_COPY(inst, 1);
+    PG_RETURN_POINTER(result);
+  }
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  /* See the comment in Temporal_append_tinstant above */
+  bool expand = AggCheckCallContext(fcinfo, NULL) != 0;
+  Temporal *result = temporal_append_tinstant(temp, inst, 0.0, NULL, 0.0,
+    expand);
+  if (! expand)
+    PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(inst, 1);
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Temporal_delta_merge(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_delta_merge);
+/**
+ * @ingroup mobilitydb_temporal_transf
+ * @brief Merge the base and the delta values of a snapshot + delta pair
+ * @sqlfunc deltaMerge()
+ */
+Datum
+Temporal_delta_merge(PG_FUNCTION_ARGS)
+{
+  Temporal *base = PG_ARGISNULL(0) ? NULL : PG_GETARG_TEMPORAL_P(0);
+  Temporal *delta = PG_ARGISNULL(1) ? NULL : PG_GETARG_TEMPORAL_P(1);
+  Temporal *result = temporal_delta_merge(base, delta);
+  if (base)
+    PG_FREE_IF_COPY(base, 0);
+  if (delta)
+    PG_FREE_IF_COPY(delta, 1);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Temporal_delta_compact(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_delta_compact);
+/**
+ * @ingroup mobilitydb_temporal_transf
+ * @brief Merge the base and the delta values of a snapshot + delta pair
+ * into a new compact snapshot
+ * @sqlfunc deltaCompact()
+ */
+Datum
+Temporal_delta_compact(PG_FUNCTION_ARGS)
+{
+  Temporal *base = PG_ARGISNULL(0) ? NULL : PG_GETARG_TEMPORAL_P(0);
+  Temporal *delta = PG_ARGISNULL(1) ? NULL : PG_GETARG_TEMPORAL_P(1);
+  Temporal *merged = temporal_delta_merge(base, delta);
+  if (base)
+    PG_FREE_IF_COPY(base, 0);
+  if (delta)
+    PG_FREE_IF_COPY(delta, 1);
+  if (! merged)
+    PG_RETURN_NULL();
+  /* Strip the slack that the delta value may carry from the expandable
+   * representation so that the stored snapshot is as compact as possible */
+  Temporal *result = temporal_compact(merged);
+  pfree(merged);
+  PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************
  * Restriction Functions
  *****************************************************************************/
@@ -2044,7 +2452,7 @@ temporal_restrict_value_ext(FunctionCallInfo fcinfo, bool atfunc)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   Datum value = PG_GETARG_ANYDATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   Temporal *result = temporal_restrict_value(temp, value, atfunc);
   PG_FREE_IF_COPY(temp, 0);
   DATUM_FREE_IF_COPY(value, basetype, 1);
@@ -2337,7 +2745,13 @@ Tnumber_minus_tbox(PG_FUNCTION_ARGS)
 static Datum
 temporal_restrict_timestamp_ext(FunctionCallInfo fcinfo, bool atfunc)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp;
+  /* The result is null when the period of the value does not contain the
+   * timestamp */
+  if (atfunc && ! temporal_getarg_if_contains_timestamp(fcinfo, 0, 1, &temp))
+    PG_RETURN_NULL();
+  if (! atfunc)
+    temp = PG_GETARG_TEMPORAL_P(0);
   TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
   Temporal *result = temporal_restrict_timestamp(temp, t, atfunc);
   PG_FREE_IF_COPY(temp, 0);
@@ -2384,7 +2798,12 @@ PG_FUNCTION_INFO_V1(Temporal_value_at_timestamp);
 Datum
 Temporal_value_at_timestamp(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  /* The result is null when the period of the value does not contain the
+   * timestamp, which for fleet snapshot queries skips the detoasting of the
+   * bulk of the trips */
+  Temporal *temp;
+  if (! temporal_getarg_if_contains_timestamp(fcinfo, 0, 1, &temp))
+    PG_RETURN_NULL();
   TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
   Datum result;
   bool found = temporal_value_at_timestamp(temp, t, true, &result);
@@ -2669,6 +3088,30 @@ Temporal_stops(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+PGDLLEXPORT Datum Temporal_moves(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_moves);
+/**
+ * @ingroup mobilitydb_temporal_transf
+ * @brief Return the restriction of the temporal value to the periods where
+ * it is not stopped
+ * @sqlfunc moves()
+ */
+Datum
+Temporal_moves(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  double maxdist = PG_GETARG_FLOAT8(1);
+  Interval *minduration = PG_GETARG_INTERVAL_P(2);
+  /* Store fcinfo into a global variable */
+  /* Needed for the distance function for temporal geographic points */
+  store_fcinfo(fcinfo);
+  Temporal *result = temporal_moves(temp, maxdist, minduration);
+  PG_FREE_IF_COPY(temp, 0);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************
  * Local aggregate functions
  *****************************************************************************/
@@ -2705,6 +3148,42 @@ Tnumber_twavg(PG_FUNCTION_ARGS)
   PG_RETURN_FLOAT8(result);
 }
 
+PGDLLEXPORT Datum Tnumber_twavg_approx(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_twavg_approx);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return an approximation of the time-weighted average of a temporal
+ * number computed on a sample of its sequences, together with a 95% error
+ * bound
+ * @sqlfunc twAvgApprox()
+ */
+Datum
+Tnumber_twavg_approx(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  double fraction = PG_GETARG_FLOAT8(1);
+  double error;
+  double value = tnumber_twavg_approx(temp, fraction, &error);
+  PG_FREE_IF_COPY(temp, 0);
+  if (value == DBL_MAX)
+    PG_RETURN_NULL();
+
+  /* Build a tuple description for the function output */
+  TupleDesc resultTupleDesc;
+  get_call_result_type(fcinfo, NULL, &resultTupleDesc);
+  BlessTupleDesc(resultTupleDesc);
+
+  /* Construct the result */
+  bool result_is_null[2] = {0,0}; /* needed to say no value is null */
+  Datum result_values[2]; /* used to construct the composite return value */
+  result_values[0] = Float8GetDatum(value);
+  result_values[1] = Float8GetDatum(error);
+  /* Form tuple and return */
+  HeapTuple resultTuple = heap_form_tuple(resultTupleDesc, result_values,
+    result_is_null);
+  PG_RETURN_DATUM(HeapTupleGetDatum(resultTuple));
+}
+
 /*****************************************************************************
  * Functions for defining B-tree index
  *****************************************************************************/
@@ -2875,4 +3354,21 @@ Temporal_hash(PG_FUNCTION_ARGS)
   PG_RETURN_UINT32(result);
 }
 
+PGDLLEXPORT Datum Temporal_hash_extended(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_hash_extended);
+/**
+ * @ingroup mobilitydb_temporal_accessor
+ * @brief Return the 64-bit hash value of a temporal value using a seed
+ * @sqlfunc hash_extended()
+ */
+Datum
+Temporal_hash_extended(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  uint64 seed = PG_GETARG_INT64(1);
+  uint64 result = temporal_hash_extended(temp, seed);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_UINT64(result);
+}
+
 /*****************************************************************************/
@@ -181,12 +181,21 @@ Datum
 Temporal_extent_transfn(PG_FUNCTION_ARGS)
 {
   Span *p = PG_ARGISNULL(0) ? NULL : PG_GETARG_SPAN_P(0);
-  Temporal *temp = PG_ARGISNULL(1) ? NULL : PG_GETARG_TEMPORAL_P(1);
-  Span *result = temporal_extent_transfn(p, temp);
-  PG_FREE_IF_COPY(temp, 1);
-  if (! result)
+  /* Can't do anything with null inputs */
+  if (! p && PG_ARGISNULL(1))
     PG_RETURN_NULL();
-  PG_RETURN_POINTER(result);
+  /* Null temporal, return the state */
+  if (PG_ARGISNULL(1))
+    PG_RETURN_POINTER(p);
+  /* Read only the time span from the header of the temporal value instead
+   * of detoasting it completely */
+  Span s;
+  temporal_period_slice(PG_GETARG_DATUM(1), &s);
+  /* Null state, return the time span of the temporal */
+  if (! p)
+    PG_RETURN_POINTER(span_copy(&s));
+  span_expand(&s, p);
+  PG_RETURN_POINTER(p);
 }
 
 /*****************************************************************************/
@@ -201,12 +210,25 @@ Datum
 Tnumber_extent_transfn(PG_FUNCTION_ARGS)
 {
   TBox *box = PG_ARGISNULL(0) ? NULL : PG_GETARG_TBOX_P(0);
-  Temporal *temp = PG_ARGISNULL(1) ? NULL : PG_GETARG_TEMPORAL_P(1);
-  TBox *result = tnumber_extent_transfn(box, temp);
-  PG_FREE_IF_COPY(temp, 1);
-  if (! result)
+  /* Can't do anything with null inputs */
+  if (! box && PG_ARGISNULL(1))
     PG_RETURN_NULL();
-  PG_RETURN_POINTER(result);
+  /* Null temporal, return the state */
+  if (PG_ARGISNULL(1))
+    PG_RETURN_POINTER(box);
+  /* Read only the bounding box from the header of the temporal value
+   * instead of detoasting it completely */
+  TBox b;
+  temporal_bbox_slice(PG_GETARG_DATUM(1), &b);
+  /* Null state, return the bounding box of the temporal */
+  if (! box)
+  {
+    TBox *result = palloc(sizeof(TBox));
+    memcpy(result, &b, sizeof(TBox));
+    PG_RETURN_POINTER(result);
+  }
+  tbox_expand(&b, box);
+  PG_RETURN_POINTER(box);
 }
 
 /*****************************************************************************
@@ -551,7 +573,7 @@ temporal_app_tinst_transfn(Temporal *state, const TInstant *inst,
     return result;
   }
 
-  return temporal_append_tinstant(state, inst, maxdist, maxt, true);
+  return temporal_append_tinstant(state, inst, maxdist, maxt, 0.0, true);
 }
 
 /*****************************************************************************/
@@ -56,10 +56,16 @@
  *     - `staop` contains the "<" operator of the time dimension.
  *     - `stavalues` stores the length of the histogram of periods for the time dimension.
  *     - `numvalues` contains the number of buckets in the histogram.
+ * - Slot 5
+ *     - `stakind` contains the type of statistics which is `STATISTIC_KIND_INSTANT_COUNT_HISTOGRAM`.
+ *     - `staop` contains the "<" operator for float8 values.
+ *     - `stavalues` stores the histogram of the number of instants per value.
+ *     - `numvalues` contains the number of buckets in the histogram.
  *
  * In the case of temporal types having a Period as bounding box, that is,
  * tbool and ttext, no statistics are collected for the value dimension and
- * the statistics for the temporal part are stored in slots 1 and 2.
+ * the statistics for the temporal part are stored in slots 1 and 2, and the
+ * instant count histogram in slot 3.
  */
 
 #include "pg_general/temporal_analyze.h"
@@ -74,6 +80,7 @@
   #include <access/tuptoaster.h>
 #else
   #include <access/heaptoast.h>
+  #include <access/detoast.h>
 #endif
 #include <catalog/pg_collation_d.h>
 #include <catalog/pg_operator_d.h>
@@ -112,6 +119,82 @@ TemporalAnalyzeExtraData *temporal_extra_data;
  * Generic statistics functions for alphanumeric temporal types.
  *****************************************************************************/
 
+/**
+ * @brief Compute a histogram of the number of instants per value and store
+ * it in the next statistics slot
+ * @param[in] stats Structure storing statistics information
+ * @param[in] non_null_cnt Number of rows that are not null
+ * @param[in] slot_idx Index of the slot where the statistics collected are stored
+ * @param[in] counts Array with the number of instants of the sample values
+ */
+void
+temporal_count_compute_stats(VacAttrStats *stats, int non_null_cnt,
+  int *slot_idx, float8 *counts)
+{
+  int num_hist, num_bins = stats->attr->attstattarget;
+  Datum *count_hist_values;
+
+  /* Must copy the target values into anl_context */
+  MemoryContext old_cxt = MemoryContextSwitchTo(stats->anl_context);
+
+  /* Generate an instant count histogram slot entry if there are at least
+   * two values */
+  if (non_null_cnt >= 2)
+  {
+    /* Ascending sort of the instant counts for filling the histogram */
+    qsort(counts, (size_t) non_null_cnt, sizeof(float8), float8_qsort_cmp);
+
+    num_hist = non_null_cnt;
+    if (num_hist > num_bins)
+      num_hist = num_bins + 1;
+
+    count_hist_values = palloc(num_hist * sizeof(Datum));
+
+    /*
+     * The object of this loop is to copy the first and last counts[]
+     * entries along with evenly-spaced values in between. As in function
+     * span_compute_stats_generic, the integral and fractional parts of the
+     * position are tracked separately to avoid integer overflow when the
+     * stats target is more than a couple thousand.
+     */
+    int delta = (non_null_cnt - 1) / (num_hist - 1);
+    int deltafrac = (non_null_cnt - 1) % (num_hist - 1);
+    int pos = 0, posfrac = 0;
+
+    for (int i = 0; i < num_hist; i++)
+    {
+      count_hist_values[i] = Float8GetDatum(counts[pos]);
+      pos += delta;
+      posfrac += deltafrac;
+      if (posfrac >= (num_hist - 1))
+      {
+        /* fractional part exceeds 1, carry to integer part */
+        pos++;
+        posfrac -= (num_hist - 1);
+      }
+    }
+  }
+  else
+  {
+    /* Store an empty array to mean "no histogram", see the explanation
+     * in function span_compute_stats_generic */
+    count_hist_values = palloc(0);
+    num_hist = 0;
+  }
+  stats->stakind[*slot_idx] = STATISTIC_KIND_INSTANT_COUNT_HISTOGRAM;
+  stats->staop[*slot_idx] = Float8LessOperator;
+  stats->stavalues[*slot_idx] = count_hist_values;
+  stats->numvalues[*slot_idx] = num_hist;
+  stats->statypid[*slot_idx] = FLOAT8OID;
+  stats->statyplen[*slot_idx] = sizeof(float8);
+  stats->statypbyval[*slot_idx] = true;
+  stats->statypalign[*slot_idx] = 'd';
+  (*slot_idx)++;
+
+  MemoryContextSwitchTo(old_cxt);
+  return;
+}
+
 /**
  * @brief Compute statistics for alphanumeric temporal columns
  * @param[in] stats Structure storing statistics information
@@ -145,6 +228,7 @@ temporal_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   time_lowers = palloc(sizeof(SpanBound) * samplerows);
   time_uppers = palloc(sizeof(SpanBound) * samplerows);
   time_lengths = palloc(sizeof(float8) * samplerows);
+  float8 *inst_counts = palloc(sizeof(float8) * samplerows);
 
   /* Loop over the temporal values. */
   for (int i = 0; i < samplerows; i++)
@@ -161,17 +245,22 @@ temporal_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       continue;
     }
 
-    total_width += VARSIZE(value);
+    /* Get the size of the value without materializing it when toasted */
+    total_width += PG_DATUM_NEEDS_DETOAST((struct varlena *) value) ?
+      (double) toast_raw_datum_size(value) : (double) VARSIZE(value);
 
-    /* Get temporal value */
-    Temporal *temp = DatumGetTemporalP(value);
+    /* The bounds and lengths below are all derived from the bounding box,
+     * so only the header of the value is detoasted and the instants are
+     * never materialized */
+    Span period;
 
     /* Remember bounds and length for further usage in histograms */
     if (tnumber)
     {
-      Span *span = tnumber_to_span(temp);
+      TBox box;
+      temporal_bbox_slice(value, &box);
       SpanBound span_lower, span_upper;
-      span_deserialize(span, &span_lower, &span_upper);
+      span_deserialize(&box.span, &span_lower, &span_upper);
       value_lowers[non_null_cnt] = span_lower;
       value_uppers[non_null_cnt] = span_upper;
 
@@ -181,15 +270,17 @@ temporal_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       else if (temporal_extra_data->value_typid == FLOAT8OID)
         value_lengths[non_null_cnt] = DatumGetFloat8(span_upper.val) -
           DatumGetFloat8(span_lower.val);
+      memcpy(&period, &box.period, sizeof(Span));
     }
-    Span period;
-    temporal_set_period(temp, &period);
+    else
+      temporal_period_slice(value, &period);
     SpanBound period_lower, period_upper;
     span_deserialize((Span *) &period, &period_lower, &period_upper);
     time_lowers[non_null_cnt] = period_lower;
     time_uppers[non_null_cnt] = period_upper;
     time_lengths[non_null_cnt] = distance_value_value(period_upper.val,
       period_lower.val, T_TIMESTAMPTZ);
+    inst_counts[non_null_cnt] = (float8) temporal_count_slice(value);
 
     /* Increment non null count */
     non_null_cnt++;
@@ -216,6 +307,9 @@ temporal_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     /* The last argument determines the slot for number/time statistics */
     span_compute_stats_generic(stats, non_null_cnt, &slot_idx, time_lowers,
       time_uppers, time_lengths, false);
+
+    /* Compute the histogram of the number of instants per value */
+    temporal_count_compute_stats(stats, non_null_cnt, &slot_idx, inst_counts);
   }
   else if (null_cnt > 0)
   {
@@ -231,6 +325,7 @@ temporal_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     pfree(value_lowers); pfree(value_uppers); pfree(value_lengths);
   }
   pfree(time_lowers); pfree(time_uppers); pfree(time_lengths);
+  pfree(inst_counts);
   return;
 }
 
@@ -49,10 +49,12 @@
 #include <postgres.h>
 #include <utils/palloc.h>
 #include <fmgr.h>
+#include <utils/float.h>
 #include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/type_util.h"
 #include "point/tpoint_boxops.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
@@ -87,11 +89,10 @@ boxop_period_temporal_ext(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
   Span *p = PG_GETARG_SPAN_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Datum tempdatum = PG_GETARG_DATUM(1);
   Span p1;
-  temporal_set_period(temp, &p1);
+  temporal_period_slice(tempdatum, &p1);
   bool result = func(p, &p1);
-  PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
 }
 
@@ -104,12 +105,11 @@ Datum
 boxop_temporal_period_ext(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Datum tempdatum = PG_GETARG_DATUM(0);
   Span *p = PG_GETARG_SPAN_P(1);
   Span p1;
-  temporal_set_period(temp, &p1);
+  temporal_period_slice(tempdatum, &p1);
   bool result = func(&p1, p);
-  PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_BOOL(result);
 }
 
@@ -122,17 +122,175 @@ Datum
 boxop_temporal_temporal_ext(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  Datum tempdatum1 = PG_GETARG_DATUM(0);
+  Datum tempdatum2 = PG_GETARG_DATUM(1);
   Span p1, p2;
-  temporal_set_period(temp1, &p1);
-  temporal_set_period(temp2, &p2);
+  temporal_period_slice(tempdatum1, &p1);
+  temporal_period_slice(tempdatum2, &p2);
   bool result = func(&p1, &p2);
-  PG_FREE_IF_COPY(temp1, 0);
-  PG_FREE_IF_COPY(temp2, 1);
   PG_RETURN_BOOL(result);
 }
 
+/*****************************************************************************
+ * Bounding box operators dispatched at compile time
+ *
+ * The generic functions above resolve the span comparison through a function
+ * pointer on every call. The span-based operators below are instead
+ * expressed over an operator enumeration and evaluated by a static inline
+ * function: every SQL entry point passes a constant operator, so the
+ * compiler specializes each of them into straight-line code with the bound
+ * comparisons inlined. These tests are the most executed code under
+ * filter-heavy scans, where the indirection and the per-bound type dispatch
+ * were measurable. The box-based operators keep the generic path, since
+ * their cost is dominated by the dimension logic of the box functions.
+ *****************************************************************************/
+
+/**
+ * @brief Bounding box operators with compile-time dispatch
+ */
+typedef enum
+{
+  BBOX_CONTAINS,
+  BBOX_CONTAINED,
+  BBOX_OVERLAPS,
+  BBOX_SAME,
+  BBOX_ADJACENT,
+} bboxOper;
+
+/**
+ * @brief Compare two span bound values with a direct machine comparison for
+ * the hot base types, as in the specialized comparisons of span_ops.c
+ */
+static inline int
+bbox_datum_cmp(Datum l, Datum r, meosType type)
+{
+  switch (type)
+  {
+    case T_INT4:
+    {
+      int32 i1 = DatumGetInt32(l), i2 = DatumGetInt32(r);
+      return (i1 < i2) ? -1 : ((i1 > i2) ? 1 : 0);
+    }
+    case T_INT8:
+    case T_TIMESTAMPTZ:
+    {
+      int64 i1 = DatumGetInt64(l), i2 = DatumGetInt64(r);
+      return (i1 < i2) ? -1 : ((i1 > i2) ? 1 : 0);
+    }
+    case T_FLOAT8:
+      return float8_cmp_internal(DatumGetFloat8(l), DatumGetFloat8(r));
+    default:
+      return datum_cmp(l, r, type);
+  }
+}
+
+/**
+ * @brief Evaluate a bounding box operator on two spans, mirroring the
+ * semantics of the corresponding span functions in span_ops.c
+ */
+static inline bool
+bbox_span_span(bboxOper oper, const Span *s1, const Span *s2)
+{
+  int c1, c2;
+  switch (oper)
+  {
+    case BBOX_CONTAINED:
+      /* Contained is contains with the arguments swapped */
+      return bbox_span_span(BBOX_CONTAINS, s2, s1);
+    case BBOX_CONTAINS:
+      c1 = bbox_datum_cmp(s1->lower, s2->lower, s1->basetype);
+      c2 = bbox_datum_cmp(s1->upper, s2->upper, s1->basetype);
+      return (c1 < 0 || (c1 == 0 && (s1->lower_inc || ! s2->lower_inc))) &&
+        (c2 > 0 || (c2 == 0 && (s1->upper_inc || ! s2->upper_inc)));
+    case BBOX_OVERLAPS:
+      c1 = bbox_datum_cmp(s1->lower, s2->upper, s1->basetype);
+      c2 = bbox_datum_cmp(s2->lower, s1->upper, s1->basetype);
+      return (c1 < 0 || (c1 == 0 && s1->lower_inc && s2->upper_inc)) &&
+        (c2 < 0 || (c2 == 0 && s2->lower_inc && s1->upper_inc));
+    case BBOX_SAME:
+      /* As in span_eq, the bounds are compared on their binary image */
+      return s1->lower == s2->lower && s1->upper == s2->upper &&
+        s1->lower_inc == s2->lower_inc && s1->upper_inc == s2->upper_inc;
+    default: /* BBOX_ADJACENT */
+      return
+        (bbox_datum_cmp(s1->upper, s2->lower, s1->basetype) == 0 &&
+          s1->upper_inc != s2->lower_inc) ||
+        (bbox_datum_cmp(s2->upper, s1->lower, s1->basetype) == 0 &&
+          s2->upper_inc != s1->lower_inc);
+  }
+}
+
+/**
+ * @brief Bounding box operator for a period and a temporal value
+ * (compile-time dispatch)
+ */
+static inline Datum
+boxop_period_temporal_oper(FunctionCallInfo fcinfo, bboxOper oper)
+{
+  Span *p = PG_GETARG_SPAN_P(0);
+  Datum tempdatum = PG_GETARG_DATUM(1);
+  Span p1;
+  temporal_period_slice(tempdatum, &p1);
+  PG_RETURN_BOOL(bbox_span_span(oper, p, &p1));
+}
+
+/**
+ * @brief Bounding box operator for a temporal value and a period
+ * (compile-time dispatch)
+ */
+static inline Datum
+boxop_temporal_period_oper(FunctionCallInfo fcinfo, bboxOper oper)
+{
+  Datum tempdatum = PG_GETARG_DATUM(0);
+  Span *p = PG_GETARG_SPAN_P(1);
+  Span p1;
+  temporal_period_slice(tempdatum, &p1);
+  PG_RETURN_BOOL(bbox_span_span(oper, &p1, p));
+}
+
+/**
+ * @brief Bounding box operator for two temporal values
+ * (compile-time dispatch)
+ */
+static inline Datum
+boxop_temporal_temporal_oper(FunctionCallInfo fcinfo, bboxOper oper)
+{
+  Datum tempdatum1 = PG_GETARG_DATUM(0);
+  Datum tempdatum2 = PG_GETARG_DATUM(1);
+  Span p1, p2;
+  temporal_period_slice(tempdatum1, &p1);
+  temporal_period_slice(tempdatum2, &p2);
+  PG_RETURN_BOOL(bbox_span_span(oper, &p1, &p2));
+}
+
+/**
+ * @brief Bounding box operator for a span and a temporal number
+ * (compile-time dispatch)
+ */
+static inline Datum
+boxop_numspan_tnumber_oper(FunctionCallInfo fcinfo, bboxOper oper)
+{
+  Span *s = PG_GETARG_SPAN_P(0);
+  Datum tempdatum = PG_GETARG_DATUM(1);
+  Span s1;
+  tnumber_span_slice(tempdatum, &s1);
+  PG_RETURN_BOOL(bbox_span_span(oper, s, &s1));
+}
+
+/**
+ * @brief Bounding box operator for a temporal number and a span
+ * (compile-time dispatch)
+ */
+static inline Datum
+boxop_tnumber_numspan_oper(FunctionCallInfo fcinfo, bboxOper oper)
+{
+  Datum tempdatum = PG_GETARG_DATUM(0);
+  Span *s = PG_GETARG_SPAN_P(1);
+  Span s1;
+  tnumber_span_slice(tempdatum, &s1);
+  PG_RETURN_BOOL(bbox_span_span(oper, &s1, s));
+}
+
 /*****************************************************************************
  * Bounding box operators for temporal types
  *****************************************************************************/
@@ -148,7 +306,7 @@ PG_FUNCTION_INFO_V1(Contains_period_temporal);
 Datum
 Contains_period_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_period_temporal_ext(fcinfo, &contains_span_span);
+  return boxop_period_temporal_oper(fcinfo, BBOX_CONTAINS);
 }
 
 PGDLLEXPORT Datum Contains_temporal_period(PG_FUNCTION_ARGS);
@@ -162,7 +320,7 @@ PG_FUNCTION_INFO_V1(Contains_temporal_period);
 Datum
 Contains_temporal_period(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_period_ext(fcinfo, &contains_span_span);
+  return boxop_temporal_period_oper(fcinfo, BBOX_CONTAINS);
 }
 
 PGDLLEXPORT Datum Contains_temporal_temporal(PG_FUNCTION_ARGS);
@@ -177,7 +335,7 @@ PG_FUNCTION_INFO_V1(Contains_temporal_temporal);
 Datum
 Contains_temporal_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_temporal_ext(fcinfo, &contains_span_span);
+  return boxop_temporal_temporal_oper(fcinfo, BBOX_CONTAINS);
 }
 
 /*****************************************************************************/
@@ -194,7 +352,7 @@ PG_FUNCTION_INFO_V1(Contained_period_temporal);
 Datum
 Contained_period_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_period_temporal_ext(fcinfo, &contained_span_span);
+  return boxop_period_temporal_oper(fcinfo, BBOX_CONTAINED);
 }
 
 PGDLLEXPORT Datum Contained_temporal_period(PG_FUNCTION_ARGS);
@@ -209,7 +367,7 @@ PG_FUNCTION_INFO_V1(Contained_temporal_period);
 Datum
 Contained_temporal_period(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_period_ext(fcinfo, &contained_span_span);
+  return boxop_temporal_period_oper(fcinfo, BBOX_CONTAINED);
 }
 
 PGDLLEXPORT Datum Contained_temporal_temporal(PG_FUNCTION_ARGS);
@@ -224,7 +382,7 @@ PG_FUNCTION_INFO_V1(Contained_temporal_temporal);
 Datum
 Contained_temporal_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_temporal_ext(fcinfo, &contained_span_span);
+  return boxop_temporal_temporal_oper(fcinfo, BBOX_CONTAINED);
 }
 
 /*****************************************************************************/
@@ -241,7 +399,7 @@ PG_FUNCTION_INFO_V1(Overlaps_period_temporal);
 Datum
 Overlaps_period_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_period_temporal_ext(fcinfo, &overlaps_span_span);
+  return boxop_period_temporal_oper(fcinfo, BBOX_OVERLAPS);
 }
 
 PGDLLEXPORT Datum Overlaps_temporal_period(PG_FUNCTION_ARGS);
@@ -256,7 +414,7 @@ PG_FUNCTION_INFO_V1(Overlaps_temporal_period);
 Datum
 Overlaps_temporal_period(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_period_ext(fcinfo, &overlaps_span_span);
+  return boxop_temporal_period_oper(fcinfo, BBOX_OVERLAPS);
 }
 
 PGDLLEXPORT Datum Overlaps_temporal_temporal(PG_FUNCTION_ARGS);
@@ -270,7 +428,7 @@ PG_FUNCTION_INFO_V1(Overlaps_temporal_temporal);
 Datum
 Overlaps_temporal_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_temporal_ext(fcinfo, &overlaps_span_span);
+  return boxop_temporal_temporal_oper(fcinfo, BBOX_OVERLAPS);
 }
 
 /*****************************************************************************/
@@ -287,7 +445,7 @@ PG_FUNCTION_INFO_V1(Same_period_temporal);
 Datum
 Same_period_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_period_temporal_ext(fcinfo, &span_eq);
+  return boxop_period_temporal_oper(fcinfo, BBOX_SAME);
 }
 
 PGDLLEXPORT Datum Same_temporal_period(PG_FUNCTION_ARGS);
@@ -302,7 +460,7 @@ PG_FUNCTION_INFO_V1(Same_temporal_period);
 Datum
 Same_temporal_period(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_period_ext(fcinfo, &span_eq);
+  return boxop_temporal_period_oper(fcinfo, BBOX_SAME);
 }
 
 PGDLLEXPORT Datum Same_temporal_temporal(PG_FUNCTION_ARGS);
@@ -316,7 +474,7 @@ PG_FUNCTION_INFO_V1(Same_temporal_temporal);
 Datum
 Same_temporal_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_temporal_ext(fcinfo, &span_eq);
+  return boxop_temporal_temporal_oper(fcinfo, BBOX_SAME);
 }
 
 /*****************************************************************************/
@@ -333,7 +491,7 @@ PG_FUNCTION_INFO_V1(Adjacent_period_temporal);
 Datum
 Adjacent_period_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_period_temporal_ext(fcinfo, &adjacent_span_span);
+  return boxop_period_temporal_oper(fcinfo, BBOX_ADJACENT);
 }
 
 PGDLLEXPORT Datum Adjacent_temporal_period(PG_FUNCTION_ARGS);
@@ -348,7 +506,7 @@ PG_FUNCTION_INFO_V1(Adjacent_temporal_period);
 Datum
 Adjacent_temporal_period(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_period_ext(fcinfo, &adjacent_span_span);
+  return boxop_temporal_period_oper(fcinfo, BBOX_ADJACENT);
 }
 
 PGDLLEXPORT Datum Adjacent_temporal_temporal(PG_FUNCTION_ARGS);
@@ -362,7 +520,7 @@ PG_FUNCTION_INFO_V1(Adjacent_temporal_temporal);
 Datum
 Adjacent_temporal_temporal(PG_FUNCTION_ARGS)
 {
-  return boxop_temporal_temporal_ext(fcinfo, &adjacent_span_span);
+  return boxop_temporal_temporal_oper(fcinfo, BBOX_ADJACENT);
 }
 
 /*****************************************************************************
@@ -379,11 +537,10 @@ boxop_numspan_tnumber_ext(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
   Span *s = PG_GETARG_SPAN_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Datum tempdatum = PG_GETARG_DATUM(1);
   Span s1;
-  tnumber_set_span(temp, &s1);
+  tnumber_span_slice(tempdatum, &s1);
   bool result = func(s, &s1);
-  PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
 }
 
@@ -396,12 +553,11 @@ Datum
 boxop_tnumber_numspan_ext(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Datum tempdatum = PG_GETARG_DATUM(0);
   Span *s = PG_GETARG_SPAN_P(1);
   Span s1;
-  tnumber_set_span(temp, &s1);
+  tnumber_span_slice(tempdatum, &s1);
   bool result = func(&s1, s);
-  PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_BOOL(result);
 }
 
@@ -415,11 +571,10 @@ boxop_tbox_tnumber_ext(FunctionCallInfo fcinfo,
   bool (*func)(const TBox *, const TBox *))
 {
   TBox *box = PG_GETARG_TBOX_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Datum tempdatum = PG_GETARG_DATUM(1);
   TBox box1;
-  temporal_set_bbox(temp, &box1);
+  temporal_bbox_slice(tempdatum, &box1);
   bool result = func(box, &box1);
-  PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
 }
 
@@ -432,12 +587,11 @@ Datum
 boxop_tnumber_tbox_ext(FunctionCallInfo fcinfo,
   bool (*func)(const TBox *, const TBox *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Datum tempdatum = PG_GETARG_DATUM(0);
   TBox *box = PG_GETARG_TBOX_P(1);
   TBox box1;
-  temporal_set_bbox(temp, &box1);
+  temporal_bbox_slice(tempdatum, &box1);
   bool result = func(&box1, box);
-  PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_BOOL(result);
 }
 
@@ -450,14 +604,12 @@ Datum
 boxop_tnumber_tnumber_ext(FunctionCallInfo fcinfo,
   bool (*func)(const TBox *, const TBox *))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  Datum tempdatum1 = PG_GETARG_DATUM(0);
+  Datum tempdatum2 = PG_GETARG_DATUM(1);
   TBox box1, box2;
-  temporal_set_bbox(temp1, &box1);
-  temporal_set_bbox(temp2, &box2);
+  temporal_bbox_slice(tempdatum1, &box1);
+  temporal_bbox_slice(tempdatum2, &box2);
   bool result = func(&box1, &box2);
-  PG_FREE_IF_COPY(temp1, 0);
-  PG_FREE_IF_COPY(temp2, 1);
   PG_RETURN_BOOL(result);
 }
 
@@ -476,7 +628,7 @@ PG_FUNCTION_INFO_V1(Contains_numspan_tnumber);
 Datum
 Contains_numspan_tnumber(PG_FUNCTION_ARGS)
 {
-  return boxop_numspan_tnumber_ext(fcinfo, &contains_span_span);
+  return boxop_numspan_tnumber_oper(fcinfo, BBOX_CONTAINS);
 }
 
 PGDLLEXPORT Datum Contains_tnumber_numspan(PG_FUNCTION_ARGS);
@@ -490,7 +642,7 @@ PG_FUNCTION_INFO_V1(Contains_tnumber_numspan);
 Datum
 Contains_tnumber_numspan(PG_FUNCTION_ARGS)
 {
-  return boxop_tnumber_numspan_ext(fcinfo, &contains_span_span);
+  return boxop_tnumber_numspan_oper(fcinfo, BBOX_CONTAINS);
 }
 
 PGDLLEXPORT Datum Contains_tbox_tnumber(PG_FUNCTION_ARGS);
@@ -552,7 +704,7 @@ PG_FUNCTION_INFO_V1(Contained_numspan_tnumber);
 Datum
 Contained_numspan_tnumber(PG_FUNCTION_ARGS)
 {
-  return boxop_numspan_tnumber_ext(fcinfo, &contained_span_span);
+  return boxop_numspan_tnumber_oper(fcinfo, BBOX_CONTAINED);
 }
 
 PGDLLEXPORT Datum Contained_tnumber_numspan(PG_FUNCTION_ARGS);
@@ -567,7 +719,7 @@ PG_FUNCTION_INFO_V1(Contained_tnumber_numspan);
 Datum
 Contained_tnumber_numspan(PG_FUNCTION_ARGS)
 {
-  return boxop_tnumber_numspan_ext(fcinfo, &contained_span_span);
+  return boxop_tnumber_numspan_oper(fcinfo, BBOX_CONTAINED);
 }
 
 PGDLLEXPORT Datum Contained_tbox_tnumber(PG_FUNCTION_ARGS);
@@ -629,7 +781,7 @@ PG_FUNCTION_INFO_V1(Overlaps_numspan_tnumber);
 Datum
 Overlaps_numspan_tnumber(PG_FUNCTION_ARGS)
 {
-  return boxop_numspan_tnumber_ext(fcinfo, &overlaps_span_span);
+  return boxop_numspan_tnumber_oper(fcinfo, BBOX_OVERLAPS);
 }
 
 PGDLLEXPORT Datum Overlaps_tnumber_numspan(PG_FUNCTION_ARGS);
@@ -644,7 +796,7 @@ PG_FUNCTION_INFO_V1(Overlaps_tnumber_numspan);
 Datum
 Overlaps_tnumber_numspan(PG_FUNCTION_ARGS)
 {
-  return boxop_tnumber_numspan_ext(fcinfo, &overlaps_span_span);
+  return boxop_tnumber_numspan_oper(fcinfo, BBOX_OVERLAPS);
 }
 
 PGDLLEXPORT Datum Overlaps_tbox_tnumber(PG_FUNCTION_ARGS);
@@ -705,7 +857,7 @@ PG_FUNCTION_INFO_V1(Same_numspan_tnumber);
 Datum
 Same_numspan_tnumber(PG_FUNCTION_ARGS)
 {
-  return boxop_numspan_tnumber_ext(fcinfo, &span_eq);
+  return boxop_numspan_tnumber_oper(fcinfo, BBOX_SAME);
 }
 
 PGDLLEXPORT Datum Same_tnumber_numspan(PG_FUNCTION_ARGS);
@@ -720,7 +872,7 @@ PG_FUNCTION_INFO_V1(Same_tnumber_numspan);
 Datum
 Same_tnumber_numspan(PG_FUNCTION_ARGS)
 {
-  return boxop_tnumber_numspan_ext(fcinfo, &span_eq);
+  return boxop_tnumber_numspan_oper(fcinfo, BBOX_SAME);
 }
 
 PGDLLEXPORT Datum Same_tbox_tnumber(PG_FUNCTION_ARGS);
@@ -781,7 +933,7 @@ PG_FUNCTION_INFO_V1(Adjacent_numspan_tnumber);
 Datum
 Adjacent_numspan_tnumber(PG_FUNCTION_ARGS)
 {
-  return boxop_numspan_tnumber_ext(fcinfo, &adjacent_span_span);
+  return boxop_numspan_tnumber_oper(fcinfo, BBOX_ADJACENT);
 }
 
 PGDLLEXPORT Datum Adjacent_tnumber_numspan(PG_FUNCTION_ARGS);
@@ -796,7 +948,7 @@ PG_FUNCTION_INFO_V1(Adjacent_tnumber_numspan);
 Datum
 Adjacent_tnumber_numspan(PG_FUNCTION_ARGS)
 {
-  return boxop_tnumber_numspan_ext(fcinfo, &adjacent_span_span);
+  return boxop_tnumber_numspan_oper(fcinfo, BBOX_ADJACENT);
 }
 
 PGDLLEXPORT Datum Adjacent_tbox_tnumber(PG_FUNCTION_ARGS);
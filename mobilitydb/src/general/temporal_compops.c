@@ -41,6 +41,7 @@
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
 #include "pg_general/temporal.h"
+#include "pg_general/type_util.h"
 
 /*****************************************************************************
  * Generic functions
@@ -58,7 +59,7 @@ tcomp_base_temporal_ext(FunctionCallInfo fcinfo,
     PG_RETURN_NULL();
   Datum value = PG_GETARG_ANYDATUM(0);
   Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   bool restr = false;
   Datum atvalue = (Datum) NULL;
   if (PG_NARGS() > 2 && ! PG_ARGISNULL(2))
@@ -93,7 +94,7 @@ tcomp_temporal_base_ext(FunctionCallInfo fcinfo,
     PG_RETURN_NULL();
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   Datum value = PG_GETARG_ANYDATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   bool restr = false;
   Datum atvalue = (Datum) NULL;
   if (PG_NARGS() > 2 && ! PG_ARGISNULL(2))
@@ -126,8 +127,10 @@ tcomp_temporal_temporal_ext(FunctionCallInfo fcinfo,
 {
   if (PG_ARGISNULL(0) || PG_ARGISNULL(1))
     PG_RETURN_NULL();
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   bool restr = false;
   Datum atvalue = (Datum) NULL;
   if (PG_NARGS() > 2 && ! PG_ARGISNULL(2))
@@ -0,0 +1,157 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief GIN index for the value set of temporal integers and temporal texts.
+ */
+
+/* PostgreSQL */
+#include "postgres.h"
+#include "access/gin.h"
+#include "access/stratnum.h"
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/set.h"
+#include "general/temporal.h"
+#include "general/type_util.h"
+/* MobilityDB */
+#include "pg_general/temporal.h"
+
+/*****************************************************************************
+ * Operator strategy numbers used in the GIN set and temporal opclasses
+ *****************************************************************************/
+
+#define GinOverlapStrategyTemporalSet            10    /* for @@ */
+#define GinOverlapStrategyTemporalTemporal       11    /* for @@ */
+#define GinContainsStrategyTemporalValue         20    /* for @? */
+#define GinContainsStrategyTemporalSet           21    /* for @? */
+#define GinContainsStrategyTemporalTemporal      22    /* for @? */
+#define GinContainedStrategyTemporalSet          30    /* for ?@ */
+#define GinContainedStrategyTemporalTemporal     31    /* for ?@ */
+#define GinEqualStrategyTemporalSet              40    /* for @=*/
+#define GinEqualStrategyTemporalTemporal         41    /* for @=*/
+
+/*****************************************************************************/
+
+/**
+ * @brief Extract the distinct base values of a temporal value as an array of
+ * Datums copied in the current memory context
+ */
+static Datum *
+temporal_gin_keys(const Temporal *temp, int32 *nkeys)
+{
+  int count;
+  Datum *elems = temporal_values(temp, &count);
+  /* The datums of base types passed by reference point into the temporal
+   * value, which may be freed afterwards, and thus they must be copied */
+  meosType basetype = temptype_basetype(temp->temptype);
+  if (! basetype_byvalue(basetype))
+    for (int i = 0; i < count; i++)
+      elems[i] = datum_copy(elems[i], basetype);
+  *nkeys = count;
+  return elems;
+}
+
+PGDLLEXPORT Datum Temporal_gin_extract_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_gin_extract_value);
+/**
+ * @brief extractValue support function
+ */
+Datum
+Temporal_gin_extract_value(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  int32 *nkeys = (int32 *) PG_GETARG_POINTER(1);
+  bool **nullFlags = (bool **) PG_GETARG_POINTER(2);
+  Datum *elems = temporal_gin_keys(temp, nkeys);
+  *nullFlags = NULL;
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_POINTER(elems);
+}
+
+PGDLLEXPORT Datum Temporal_gin_extract_query(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_gin_extract_query);
+/**
+ * @brief extractQuery support function
+ */
+Datum
+Temporal_gin_extract_query(PG_FUNCTION_ARGS)
+{
+  int32 *nkeys = (int32 *) PG_GETARG_POINTER(1);
+  StrategyNumber strategy = PG_GETARG_UINT16(2);
+  bool **nullFlags = (bool **) PG_GETARG_POINTER(5);
+  int32 *searchMode = (int32 *) PG_GETARG_POINTER(6);
+  Temporal *temp;
+  Datum *elems = NULL; /* make compiler quiet */
+  Set *s;
+  *nullFlags = NULL;
+  *searchMode = GIN_SEARCH_MODE_DEFAULT;
+
+  switch (strategy)
+  {
+    case GinContainsStrategyTemporalValue:
+      elems = palloc(sizeof(Datum));
+      elems[0] = PG_GETARG_DATUM(0);
+      *nkeys = 1;
+      break;
+    case GinOverlapStrategyTemporalSet:
+    case GinContainsStrategyTemporalSet:
+    case GinContainedStrategyTemporalSet:
+    case GinEqualStrategyTemporalSet:
+      s = PG_GETARG_SET_P(0);
+      elems = set_values(s);
+      /* Copy the datums of base types passed by reference, which point into
+       * the set value that may be freed below */
+      if (! basetype_byvalue(s->basetype))
+        for (int i = 0; i < s->count; i++)
+          elems[i] = datum_copy(elems[i], s->basetype);
+      *nkeys = s->count;
+      *searchMode = GIN_SEARCH_MODE_DEFAULT;
+      PG_FREE_IF_COPY(s, 0);
+      break;
+    case GinOverlapStrategyTemporalTemporal:
+    case GinContainsStrategyTemporalTemporal:
+    case GinContainedStrategyTemporalTemporal:
+    case GinEqualStrategyTemporalTemporal:
+      temp = PG_GETARG_TEMPORAL_P(0);
+      elems = temporal_gin_keys(temp, nkeys);
+      *searchMode = GIN_SEARCH_MODE_DEFAULT;
+      PG_FREE_IF_COPY(temp, 0);
+      break;
+    default:
+      elog(ERROR, "Temporal_gin_extract_query: unknown strategy number: %d",
+         strategy);
+  }
+
+  PG_RETURN_POINTER(elems);
+}
+
+/*****************************************************************************/
@@ -69,6 +69,7 @@
 #include "general/spanset.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
+#include "pg_general/span_analyze.h"
 #include "pg_general/span_selfuncs.h"
 #include "pg_general/temporal_analyze.h"
 #include "pg_general/temporal_selfuncs.h"
@@ -1111,4 +1112,83 @@ Tpoint_joinsel(PG_FUNCTION_ARGS)
   return Float8GetDatum(temporal_joinsel_ext(fcinfo, TPOINTTYPE));
 }
 
+/*****************************************************************************
+ * Average number of instants per value
+ *****************************************************************************/
+
+/**
+ * @brief Return the average number of instants per value of a temporal
+ * column from the instant count histogram collected by the analyze function
+ * @param[in] relid Oid of the table
+ * @param[in] attnum Number of the column
+ * @param[out] avg Average number of instants per value
+ * @result True if the statistics have been collected for the column
+ */
+bool
+temporal_instants_avg(Oid relid, AttrNumber attnum, double *avg)
+{
+  HeapTuple stats_tuple = SearchSysCache3(STATRELATTINH,
+    ObjectIdGetDatum(relid), Int16GetDatum(attnum), BoolGetDatum(false));
+  if (! stats_tuple)
+    return false;
+  AttStatsSlot hslot;
+  if (! get_attstatsslot(&hslot, stats_tuple,
+      STATISTIC_KIND_INSTANT_COUNT_HISTOGRAM, InvalidOid,
+      ATTSTATSSLOT_VALUES))
+  {
+    ReleaseSysCache(stats_tuple);
+    return false;
+  }
+  /* Check that it's a histogram, not just a dummy entry */
+  if (hslot.nvalues < 2)
+  {
+    free_attstatsslot(&hslot);
+    ReleaseSysCache(stats_tuple);
+    return false;
+  }
+  /* The histogram bins are equi-frequent and thus the average is
+   * approximated by the trapezoid rule on the bin bounds, that is, all
+   * bounds have equal weight but the two extreme ones have half weight */
+  double sum = 0.0;
+  for (int i = 0; i < hslot.nvalues; i++)
+  {
+    double value = DatumGetFloat8(hslot.values[i]);
+    sum += (i == 0 || i == hslot.nvalues - 1) ? value / 2.0 : value;
+  }
+  *avg = sum / (hslot.nvalues - 1);
+  free_attstatsslot(&hslot);
+  ReleaseSysCache(stats_tuple);
+  return true;
+}
+
+PGDLLEXPORT Datum _mobdb_temporal_instants_avg(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(_mobdb_temporal_instants_avg);
+/**
+ * @brief Utility function to read the average number of instants per value
+ * computed from the statistics of a given table/column.
+ * Used for debugging the selectivity code.
+ */
+Datum
+_mobdb_temporal_instants_avg(PG_FUNCTION_ARGS)
+{
+  Oid table_oid = PG_GETARG_OID(0);
+  text *att_text = PG_GETARG_TEXT_P(1);
+
+  /* Test input parameters */
+  char *table_name = get_rel_name(table_oid);
+  if (table_name == NULL)
+    ereport(ERROR, (errcode(ERRCODE_UNDEFINED_TABLE),
+      errmsg("Oid %u does not refer to a table", table_oid)));
+  const char *att_name = text_to_cstring(att_text);
+  /* Get the attribute number */
+  AttrNumber att_num = get_attnum(table_oid, att_name);
+  if (! att_num)
+    elog(ERROR, "attribute \"%s\" does not exist", att_name);
+
+  double avg;
+  if (! temporal_instants_avg(table_oid, att_num, &avg))
+    elog(ERROR, "stats for \"%s\" do not exist", table_name);
+  PG_RETURN_FLOAT8((float8) avg);
+}
+
 /*****************************************************************************/
@@ -0,0 +1,396 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Shared-memory cache for large temporal values referenced by
+ * multiple backends.
+ *
+ * Workloads that evaluate many moving objects against the same large
+ * reference value, e.g., a geofence set or a reference trajectory, make
+ * every backend detoast and keep its own private copy of that value. This
+ * module keeps a single copy of such values in dynamic shared memory so
+ * that concurrent backends share the detoasted bytes instead of holding
+ * one copy each.
+ *
+ * Cached values are keyed by the TOAST pointer of the stored datum, that
+ * is, by the pair (TOAST relation, TOAST value identifier). A TOAST value
+ * is immutable, an update of the owning tuple allocates a new value
+ * identifier, so a cached copy can never become stale. Each cached value
+ * lives in its own DSM segment, the shared hash table only stores the
+ * segment handle. The cache is available only when the extension is loaded
+ * through shared_preload_libraries and is controlled by the following
+ * configuration parameters
+ * - mobilitydb.shared_cache enables the cache (disabled by default)
+ * - mobilitydb.shared_cache_entries fixes the number of cache slots
+ * - mobilitydb.shared_cache_min_size is the minimum detoasted size, in
+ *   kilobytes, for a value to be cached
+ */
+
+#include "pg_general/temporal_shcache.h"
+
+/* C */
+#include <assert.h>
+/* PostgreSQL */
+#include <miscadmin.h>
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  #include <access/detoast.h>
+#else
+  #include <access/tuptoaster.h>
+#endif
+#include <storage/dsm.h>
+#include <storage/ipc.h>
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
+#include <utils/guc.h>
+#include <utils/hsearch.h>
+#include <utils/memutils.h>
+/* MobilityDB */
+#include "pg_general/temporal.h"
+
+/*****************************************************************************
+ * Definitions
+ *****************************************************************************/
+
+/**
+ * @brief Key of a cached value: the TOAST pointer of the stored datum
+ */
+typedef struct
+{
+  Oid relid;       /**< TOAST relation holding the value */
+  Oid valueid;     /**< TOAST value identifier */
+} ShCacheKey;
+
+/**
+ * @brief Entry of the shared hash table
+ */
+typedef struct
+{
+  ShCacheKey key;    /**< Hash key */
+  dsm_handle handle; /**< DSM segment holding the detoasted value */
+  Size size;         /**< Size in bytes of the value */
+  uint32 usage;      /**< Usage counter driving the eviction */
+} ShCacheEntry;
+
+/**
+ * @brief Backend-local entry remembering an attached DSM segment so that
+ * repeated fetches of the same value do not attach again
+ */
+typedef struct
+{
+  ShCacheKey key;      /**< Hash key */
+  const Temporal *temp; /**< Address of the value in the attached segment */
+} ShCacheLocalEntry;
+
+/* Configuration parameters */
+static bool _shcache_enabled = false;
+static int _shcache_entries = 64;
+static int _shcache_min_size = 1024; /* kB */
+
+/* Shared hash table mapping TOAST pointers to DSM segments */
+static HTAB *_shcache_hash = NULL;
+/* Lock protecting the shared hash table */
+static LWLock *_shcache_lock = NULL;
+/* Backend-local cache of attached segments */
+static HTAB *_shcache_local = NULL;
+
+/* Saved hook values, the hooks are chained */
+#if POSTGRESQL_VERSION_NUMBER >= 150000
+static shmem_request_hook_type prev_shmem_request_hook = NULL;
+#endif /* POSTGRESQL_VERSION_NUMBER >= 150000 */
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+
+/*****************************************************************************
+ * Shared memory management
+ *****************************************************************************/
+
+/**
+ * @brief Request the shared memory needed by the cache
+ */
+static void
+temporal_shcache_shmem_request(void)
+{
+#if POSTGRESQL_VERSION_NUMBER >= 150000
+  if (prev_shmem_request_hook)
+    prev_shmem_request_hook();
+#endif /* POSTGRESQL_VERSION_NUMBER >= 150000 */
+  RequestAddinShmemSpace(hash_estimate_size(_shcache_entries,
+    sizeof(ShCacheEntry)));
+  RequestNamedLWLockTranche("mobilitydb_shcache", 1);
+}
+
+/**
+ * @brief Initialize the shared hash table at postmaster startup
+ */
+static void
+temporal_shcache_shmem_startup(void)
+{
+  if (prev_shmem_startup_hook)
+    prev_shmem_startup_hook();
+
+  HASHCTL info;
+  memset(&info, 0, sizeof(info));
+  info.keysize = sizeof(ShCacheKey);
+  info.entrysize = sizeof(ShCacheEntry);
+  LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+  _shcache_hash = ShmemInitHash("MobilityDB shared temporal cache",
+    _shcache_entries, _shcache_entries, &info, HASH_ELEM | HASH_BLOBS);
+  _shcache_lock = &(GetNamedLWLockTranche("mobilitydb_shcache"))->lock;
+  LWLockRelease(AddinShmemInitLock);
+}
+
+/**
+ * @brief Register the configuration parameters and the shared memory hooks
+ * of the cache, called from the initialization of the extension
+ */
+void
+temporal_shcache_init(void)
+{
+  DefineCustomBoolVariable("mobilitydb.shared_cache",
+    "Cache large temporal values in shared memory",
+    NULL, &_shcache_enabled, false, PGC_SUSET, 0, NULL, NULL, NULL);
+  DefineCustomIntVariable("mobilitydb.shared_cache_entries",
+    "Number of entries of the shared cache of temporal values",
+    NULL, &_shcache_entries, 64, 8, 8192, PGC_POSTMASTER, 0,
+    NULL, NULL, NULL);
+  DefineCustomIntVariable("mobilitydb.shared_cache_min_size",
+    "Minimum size in kilobytes for a temporal value to be cached in shared memory",
+    NULL, &_shcache_min_size, 1024, 0, INT_MAX, PGC_SUSET, GUC_UNIT_KB,
+    NULL, NULL, NULL);
+
+  /* The shared hash table can only be created when the extension is loaded
+   * through shared_preload_libraries */
+  if (! process_shared_preload_libraries_in_progress)
+    return;
+
+#if POSTGRESQL_VERSION_NUMBER >= 150000
+  prev_shmem_request_hook = shmem_request_hook;
+  shmem_request_hook = temporal_shcache_shmem_request;
+#else
+  temporal_shcache_shmem_request();
+#endif /* POSTGRESQL_VERSION_NUMBER >= 150000 */
+  prev_shmem_startup_hook = shmem_startup_hook;
+  shmem_startup_hook = temporal_shcache_shmem_startup;
+}
+
+/*****************************************************************************
+ * Cache operations
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the cache is operational and the datum is a
+ * candidate for it, that is, a pointer to an on-disk TOAST value
+ * @param[out] key Key of the datum in the cache
+ */
+static bool
+shcache_candidate(Datum tempdatum, ShCacheKey *key)
+{
+  struct varlena *attr = (struct varlena *) DatumGetPointer(tempdatum);
+  if (! _shcache_enabled || _shcache_hash == NULL ||
+      ! VARATT_IS_EXTERNAL_ONDISK(attr))
+    return false;
+  struct varatt_external toast_pointer;
+  VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+  memset(key, 0, sizeof(ShCacheKey));
+  key->relid = toast_pointer.va_toastrelid;
+  key->valueid = toast_pointer.va_valueid;
+  return true;
+}
+
+/**
+ * @brief Attach the DSM segment of a cache entry and remember the mapping
+ * in the backend-local cache
+ * @return The address of the value or NULL if the segment is gone
+ */
+static const Temporal *
+shcache_attach(const ShCacheKey *key, dsm_handle handle)
+{
+  dsm_segment *seg = dsm_attach(handle);
+  if (seg == NULL)
+    return NULL;
+  /* Keep the mapping for the rest of the session */
+  dsm_pin_mapping(seg);
+  const Temporal *temp = (const Temporal *) dsm_segment_address(seg);
+  if (_shcache_local == NULL)
+  {
+    HASHCTL info;
+    memset(&info, 0, sizeof(info));
+    info.keysize = sizeof(ShCacheKey);
+    info.entrysize = sizeof(ShCacheLocalEntry);
+    info.hcxt = TopMemoryContext;
+    _shcache_local = hash_create("MobilityDB shared temporal cache mappings",
+      16, &info, HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+  }
+  ShCacheLocalEntry *localentry = hash_search(_shcache_local, key, HASH_ENTER,
+    NULL);
+  localentry->temp = temp;
+  return temp;
+}
+
+/**
+ * @brief Evict the least-used entry of the shared hash table
+ * @note The caller must hold the cache lock in exclusive mode. The DSM
+ * segment is unpinned, it is destroyed when the last backend mapping it
+ * detaches, so borrowed pointers returned before the eviction stay valid.
+ */
+static void
+shcache_evict(void)
+{
+  HASH_SEQ_STATUS status;
+  ShCacheEntry *entry, *victim = NULL;
+  hash_seq_init(&status, _shcache_hash);
+  while ((entry = hash_seq_search(&status)) != NULL)
+  {
+    if (victim == NULL || entry->usage < victim->usage)
+      victim = entry;
+    /* Age the counters so that past popularity fades away */
+    entry->usage /= 2;
+  }
+  if (victim == NULL)
+    return;
+  dsm_handle handle = victim->handle;
+  hash_search(_shcache_hash, &victim->key, HASH_REMOVE, NULL);
+  dsm_unpin_segment(handle);
+}
+
+/**
+ * @brief Store a detoasted temporal value in the cache
+ */
+static void
+shcache_store(const ShCacheKey *key, const Temporal *temp)
+{
+  Size size = VARSIZE(temp);
+  dsm_segment *seg = dsm_create(size, 0);
+  memcpy(dsm_segment_address(seg), temp, size);
+  /* Keep the segment alive after this backend detaches */
+  dsm_pin_segment(seg);
+  dsm_handle handle = dsm_segment_handle(seg);
+
+  LWLockAcquire(_shcache_lock, LW_EXCLUSIVE);
+  bool found;
+  if (hash_get_num_entries(_shcache_hash) >= _shcache_entries)
+    shcache_evict();
+  ShCacheEntry *entry = hash_search(_shcache_hash, key, HASH_ENTER_NULL,
+    &found);
+  if (entry != NULL && ! found)
+  {
+    entry->handle = handle;
+    entry->size = size;
+    entry->usage = 1;
+  }
+  LWLockRelease(_shcache_lock);
+
+  /* Another backend cached the value first or the table is full */
+  if (entry == NULL || found)
+    dsm_unpin_segment(handle);
+  dsm_detach(seg);
+}
+
+/**
+ * @brief Return a borrowed pointer to the shared copy of a temporal datum
+ * or NULL if the value is not in the cache
+ *
+ * The result points into a DSM segment mapped for the rest of the session,
+ * it must be treated as read only and must not be freed.
+ */
+const Temporal *
+temporal_shcache_fetch(Datum tempdatum)
+{
+  ShCacheKey key;
+  if (! shcache_candidate(tempdatum, &key))
+    return NULL;
+
+  /* A mapping from a previous fetch settles the lookup locally */
+  if (_shcache_local != NULL)
+  {
+    ShCacheLocalEntry *localentry = hash_search(_shcache_local, &key,
+      HASH_FIND, NULL);
+    if (localentry != NULL)
+      return localentry->temp;
+  }
+
+  LWLockAcquire(_shcache_lock, LW_EXCLUSIVE);
+  ShCacheEntry *entry = hash_search(_shcache_hash, &key, HASH_FIND, NULL);
+  dsm_handle handle = DSM_HANDLE_INVALID;
+  if (entry != NULL)
+  {
+    entry->usage++;
+    handle = entry->handle;
+  }
+  LWLockRelease(_shcache_lock);
+  if (handle == DSM_HANDLE_INVALID)
+    return NULL;
+  return shcache_attach(&key, handle);
+}
+
+/**
+ * @brief Detoast a temporal datum through the cache
+ *
+ * On a cache hit the bytes are copied from shared memory, which avoids
+ * reading and decompressing the TOAST value. On a miss the value is
+ * detoasted as usual and, when large enough, stored in the cache for the
+ * benefit of subsequent calls in any backend. Callers that can live with a
+ * borrowed read-only pointer should call #temporal_shcache_fetch instead to
+ * also avoid the private copy.
+ * @return A palloc'd value that the caller must free
+ */
+Temporal *
+temporal_shcache_detoast(Datum tempdatum)
+{
+  ShCacheKey key;
+  if (! shcache_candidate(tempdatum, &key))
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+    return (Temporal *) detoast_attr((struct varlena *) DatumGetPointer(
+      tempdatum));
+#else
+    return (Temporal *) heap_tuple_untoast_attr((struct varlena *)
+      DatumGetPointer(tempdatum));
+#endif
+
+  const Temporal *shared = temporal_shcache_fetch(tempdatum);
+  if (shared != NULL)
+  {
+    Temporal *result = palloc(VARSIZE(shared));
+    memcpy(result, shared, VARSIZE(shared));
+    return result;
+  }
+
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  Temporal *result = (Temporal *) detoast_attr((struct varlena *)
+    DatumGetPointer(tempdatum));
+#else
+  Temporal *result = (Temporal *) heap_tuple_untoast_attr((struct varlena *)
+    DatumGetPointer(tempdatum));
+#endif
+  if (VARSIZE(result) >= (Size) _shcache_min_size * 1024)
+    shcache_store(&key, result);
+  return result;
+}
+
+/*****************************************************************************/
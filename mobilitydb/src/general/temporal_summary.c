@@ -0,0 +1,373 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Incremental maintenance of bounding box summaries with bounded
+ * staleness.
+ *
+ * Applications often keep a summary table with the spatiotemporal extent of
+ * the trips of each moving object, e.g., one row per vehicle. Maintaining
+ * such a table with a row trigger that unions the extent on every insert
+ * turns each ingest row into a read-modify-write of the summary row, which
+ * serializes concurrent writers on hot keys and noticeably lowers ingest
+ * throughput.
+ *
+ * This module decouples the maintenance in two halves. A row trigger,
+ * attached by the user to the monitored table, only computes the bounding
+ * box of the inserted temporal value and appends it to an unlogged queue
+ * table, a cheap uncontended insert. A background worker periodically folds
+ * the queued boxes into the summary table in a single statement, so the
+ * per-row trigger cost is replaced by an amortized batch update. The summary
+ * lags behind the monitored table by at most the flush period, which is
+ * controlled by the following configuration parameter
+ * - mobilitydb.summary_naptime is the time in seconds the background worker
+ *   sleeps between two flushes of the queue, that is, the staleness bound
+ *   of the summary table
+ */
+
+#include "pg_general/temporal_summary.h"
+
+/* PostgreSQL */
+#include <access/xact.h>
+#include <catalog/pg_type.h>
+#include <commands/trigger.h>
+#include <executor/spi.h>
+#include <fmgr.h>
+#include <miscadmin.h>
+#include <pgstat.h>
+#include <postmaster/bgworker.h>
+#include <storage/ipc.h>
+#include <storage/latch.h>
+#include <storage/proc.h>
+#include <utils/builtins.h>
+#include <utils/guc.h>
+#include <utils/lsyscache.h>
+#include <utils/snapmgr.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+/* MobilityDB */
+#include "pg_general/meos_catalog.h"
+
+/*****************************************************************************
+ * Configuration parameters
+ *****************************************************************************/
+
+/**
+ * @brief Seconds the background worker sleeps between two flushes of the
+ * summary queue, configurable with the mobilitydb.summary_naptime parameter
+ */
+static int _summary_naptime = 10;
+
+/**
+ * @brief Register the configuration parameters of the summary maintenance,
+ * called from the initialization of the extension
+ */
+void
+temporal_summary_guc_init(void)
+{
+  DefineCustomIntVariable("mobilitydb.summary_naptime",
+    "Seconds between two flushes of the bounding box summary queue",
+    "Upper bound on the staleness of the summary table maintained by the "
+    "background worker started with mobilitydb_summary_start_worker()",
+    &_summary_naptime, 10, 1, 3600, PGC_SIGHUP, GUC_UNIT_S,
+    NULL, NULL, NULL);
+}
+
+/*****************************************************************************
+ * Queueing trigger
+ *****************************************************************************/
+
+/**
+ * @brief Return the quoted name of the schema in which the extension is
+ * installed, obtained from the namespace of the calling C function
+ */
+static const char *
+summary_schema_name(FunctionCallInfo fcinfo)
+{
+  char *nspname = get_namespace_name(
+    get_func_namespace(fcinfo->flinfo->fn_oid));
+  return quote_identifier(nspname);
+}
+
+PG_FUNCTION_INFO_V1(Temporal_summary_queue_trigger);
+/**
+ * @brief Row trigger that appends the bounding box of the inserted temporal
+ * value to the summary queue
+ *
+ * The trigger takes two arguments, the name of the key column identifying
+ * the moving object, which must be of an integer type, and the name of the
+ * temporal point column to be summarized. It must be attached AFTER INSERT
+ * OR UPDATE FOR EACH ROW on the monitored table. The trigger does not touch
+ * the summary table, it only queues the box of the new row, the queued boxes
+ * are folded into the summary by the background worker.
+ */
+Datum
+Temporal_summary_queue_trigger(PG_FUNCTION_ARGS)
+{
+  static SPIPlanPtr plan = NULL;
+
+  if (! CALLED_AS_TRIGGER(fcinfo))
+    elog(ERROR, "Temporal_summary_queue_trigger: not called by trigger manager");
+
+  TriggerData *trigdata = (TriggerData *) fcinfo->context;
+  Trigger *trigger = trigdata->tg_trigger;
+  if (! TRIGGER_FIRED_AFTER(trigdata->tg_event) ||
+      ! TRIGGER_FIRED_FOR_ROW(trigdata->tg_event))
+    elog(ERROR, "Temporal_summary_queue_trigger: must be fired AFTER ... FOR EACH ROW");
+  if (trigger->tgnargs != 2)
+    elog(ERROR, "Temporal_summary_queue_trigger: expected two arguments, "
+      "the key column and the temporal column");
+
+  /* The new row, both for INSERT and for UPDATE */
+  HeapTuple tuple = TRIGGER_FIRED_BY_UPDATE(trigdata->tg_event) ?
+    trigdata->tg_newtuple : trigdata->tg_trigtuple;
+  TupleDesc tupdesc = trigdata->tg_relation->rd_att;
+
+  int keyattno = SPI_fnumber(tupdesc, trigger->tgargs[0]);
+  int tempattno = SPI_fnumber(tupdesc, trigger->tgargs[1]);
+  if (keyattno == SPI_ERROR_NOATTRIBUTE)
+    elog(ERROR, "Temporal_summary_queue_trigger: unknown key column \"%s\"",
+      trigger->tgargs[0]);
+  if (tempattno == SPI_ERROR_NOATTRIBUTE)
+    elog(ERROR, "Temporal_summary_queue_trigger: unknown temporal column \"%s\"",
+      trigger->tgargs[1]);
+
+  bool isnull;
+  Datum tempdatum = heap_getattr(tuple, tempattno, tupdesc, &isnull);
+  /* Nothing to queue for a row without a temporal value */
+  if (isnull)
+    return PointerGetDatum(tuple);
+
+  Datum keydatum = heap_getattr(tuple, keyattno, tupdesc, &isnull);
+  if (isnull)
+    elog(ERROR, "Temporal_summary_queue_trigger: the key column cannot be null");
+  int64 key = 0;
+  switch (TupleDescAttr(tupdesc, keyattno - 1)->atttypid)
+  {
+    case INT2OID:
+      key = DatumGetInt16(keydatum);
+      break;
+    case INT4OID:
+      key = DatumGetInt32(keydatum);
+      break;
+    case INT8OID:
+      key = DatumGetInt64(keydatum);
+      break;
+    default:
+      elog(ERROR, "Temporal_summary_queue_trigger: the key column must be of "
+        "an integer type");
+  }
+
+  Temporal *temp = (Temporal *) PG_DETOAST_DATUM(tempdatum);
+  if (! tgeo_type(temp->temptype))
+    elog(ERROR, "Temporal_summary_queue_trigger: the temporal column must be "
+      "a temporal point");
+  STBox *box = palloc0(sizeof(STBox));
+  temporal_set_bbox(temp, box);
+
+  if (SPI_connect() != SPI_OK_CONNECT)
+    elog(ERROR, "Temporal_summary_queue_trigger: could not connect to SPI");
+
+  /* The insert statement is the same for all monitored tables, prepare it
+   * once per backend */
+  if (! plan)
+  {
+    char sql[256];
+    Oid argtypes[3];
+    argtypes[0] = REGCLASSOID;
+    argtypes[1] = INT8OID;
+    argtypes[2] = type_oid(T_STBOX);
+    snprintf(sql, sizeof(sql),
+      "INSERT INTO %s.mobilitydb_summary_queue VALUES ($1, $2, $3)",
+      summary_schema_name(fcinfo));
+    SPIPlanPtr newplan = SPI_prepare(sql, 3, argtypes);
+    if (! newplan || SPI_keepplan(newplan) != 0)
+      elog(ERROR, "Temporal_summary_queue_trigger: could not prepare the "
+        "queue insert");
+    plan = newplan;
+  }
+
+  Datum values[3];
+  values[0] = ObjectIdGetDatum(RelationGetRelid(trigdata->tg_relation));
+  values[1] = Int64GetDatum(key);
+  values[2] = PointerGetDatum(box);
+  if (SPI_execute_plan(plan, values, NULL, false, 0) != SPI_OK_INSERT)
+    elog(ERROR, "Temporal_summary_queue_trigger: could not queue the "
+      "bounding box");
+
+  SPI_finish();
+  pfree(box);
+  if ((Pointer) temp != DatumGetPointer(tempdatum))
+    pfree(temp);
+  return PointerGetDatum(tuple);
+}
+
+/*****************************************************************************
+ * Background worker
+ *****************************************************************************/
+
+static volatile sig_atomic_t summary_worker_shutdown = false;
+
+/**
+ * @brief Signal handler for SIGTERM, ask the worker to exit after the
+ * current flush
+ */
+static void
+summary_worker_sigterm(SIGNAL_ARGS)
+{
+  int save_errno = errno;
+  summary_worker_shutdown = true;
+  if (MyProc)
+    SetLatch(&MyProc->procLatch);
+  errno = save_errno;
+}
+
+/**
+ * @brief Execute a query in its own transaction and return the first column
+ * of the first row as a string allocated in the caller's memory context, or
+ * NULL when the query returns no row
+ */
+static char *
+summary_worker_query(const char *sql)
+{
+  char *result = NULL;
+  MemoryContext oldcontext = CurrentMemoryContext;
+
+  StartTransactionCommand();
+  SPI_connect();
+  PushActiveSnapshot(GetTransactionSnapshot());
+  if (SPI_execute(sql, false, 1) < 0)
+    elog(ERROR, "summary worker: could not execute: %s", sql);
+  if (SPI_processed > 0)
+  {
+    char *value = SPI_getvalue(SPI_tuptable->vals[0],
+      SPI_tuptable->tupdesc, 1);
+    if (value)
+    {
+      MemoryContext spicontext = MemoryContextSwitchTo(oldcontext);
+      result = pstrdup(value);
+      MemoryContextSwitchTo(spicontext);
+    }
+  }
+  PopActiveSnapshot();
+  SPI_finish();
+  CommitTransactionCommand();
+  return result;
+}
+
+PGDLLEXPORT void temporal_summary_worker_main(Datum arg);
+
+/**
+ * @brief Main function of the background worker, flush the summary queue
+ * every mobilitydb.summary_naptime seconds until shutdown
+ */
+void
+temporal_summary_worker_main(Datum arg)
+{
+  pqsignal(SIGTERM, summary_worker_sigterm);
+  BackgroundWorkerUnblockSignals();
+  BackgroundWorkerInitializeConnectionByOid(DatumGetObjectId(arg),
+    InvalidOid, 0);
+
+  /* Find the schema of the extension to qualify the flush function, the
+   * worker does not inherit the search path of the launching backend */
+  char *nspname = summary_worker_query(
+    "SELECT n.nspname FROM pg_catalog.pg_extension e "
+    "JOIN pg_catalog.pg_namespace n ON n.oid = e.extnamespace "
+    "WHERE e.extname = 'mobilitydb'");
+  if (! nspname)
+  {
+    ereport(LOG, (errmsg("summary worker: extension mobilitydb not "
+      "installed in database %u, exiting", DatumGetObjectId(arg))));
+    proc_exit(0);
+  }
+  char sql[256];
+  snprintf(sql, sizeof(sql), "SELECT %s.mobilitydb_summary_flush()",
+    quote_identifier(nspname));
+
+  ereport(LOG, (errmsg("summary worker started for database %u",
+    DatumGetObjectId(arg))));
+
+  while (! summary_worker_shutdown)
+  {
+    int rc = WaitLatch(MyLatch, WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH,
+      _summary_naptime * 1000L, PG_WAIT_EXTENSION);
+    ResetLatch(MyLatch);
+    if (rc & WL_POSTMASTER_DEATH)
+      proc_exit(1);
+    if (summary_worker_shutdown)
+      break;
+    char *flushed = summary_worker_query(sql);
+    if (flushed)
+      pfree(flushed);
+  }
+
+  ereport(LOG, (errmsg("summary worker shutting down")));
+  proc_exit(0);
+}
+
+PG_FUNCTION_INFO_V1(Temporal_summary_start_worker);
+/**
+ * @brief Start the background worker that flushes the summary queue of the
+ * current database
+ */
+Datum
+Temporal_summary_start_worker(PG_FUNCTION_ARGS)
+{
+  BackgroundWorker worker;
+  BackgroundWorkerHandle *handle;
+  pid_t pid;
+
+  memset(&worker, 0, sizeof(worker));
+  worker.bgw_flags = BGWORKER_SHMEM_ACCESS |
+    BGWORKER_BACKEND_DATABASE_CONNECTION;
+  worker.bgw_start_time = BgWorkerStart_RecoveryFinished;
+  worker.bgw_restart_time = BGW_NEVER_RESTART;
+  snprintf(worker.bgw_library_name, BGW_MAXLEN, "%s",
+    MOBILITYDB_LIBRARY_NAME);
+  snprintf(worker.bgw_function_name, BGW_MAXLEN,
+    "temporal_summary_worker_main");
+  snprintf(worker.bgw_name, BGW_MAXLEN, "mobilitydb summary worker");
+  snprintf(worker.bgw_type, BGW_MAXLEN, "mobilitydb summary worker");
+  worker.bgw_main_arg = ObjectIdGetDatum(MyDatabaseId);
+  worker.bgw_notify_pid = MyProcPid;
+
+  if (! RegisterDynamicBackgroundWorker(&worker, &handle))
+    ereport(ERROR, (errcode(ERRCODE_CONFIGURATION_LIMIT_EXCEEDED),
+      errmsg("could not register the summary background worker"),
+      errhint("Consider increasing max_worker_processes.")));
+  if (WaitForBackgroundWorkerStartup(handle, &pid) != BGWH_STARTED)
+    ereport(ERROR, (errmsg("could not start the summary background worker")));
+
+  PG_RETURN_BOOL(true);
+}
+
+/*****************************************************************************/
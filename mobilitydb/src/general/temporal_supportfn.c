@@ -55,6 +55,8 @@
 #include <utils/lsyscache.h>
 #include <utils/numeric.h>
 #include <utils/syscache.h>
+/* PostGIS */
+#include <liblwgeom.h>
 /* MEOS */
 #include <meos.h>
 #include "general/meos_catalog.h"
@@ -297,6 +299,48 @@ makeBboxExpr(Node *arg, Oid argoid, Oid retoid, Oid callingfunc)
 
 /*****************************************************************************/
 
+/**
+ * @brief Simplify transform(arg, srid) into its argument when the argument
+ * is already known at plan time to be in the target SRID
+ *
+ * PostgreSQL folds immutable calls over constant arguments by itself, so the
+ * interesting case is a column restricted to an SRID through its typmod:
+ * removing the no-op call saves one coordinate transformation per row, e.g.,
+ * in geofence queries where the fence and the data share the SRID.
+ */
+static Node *
+temporal_simplify_transform(FuncExpr *expr)
+{
+  Node *arg = (Node *) linitial(expr->args);
+  Node *sridarg = (Node *) lsecond(expr->args);
+  if (! IsA(sridarg, Const) || ((Const *) sridarg)->constisnull)
+    return NULL;
+  int32 srid = DatumGetInt32(((Const *) sridarg)->constvalue);
+  int32 typmod = exprTypmod(arg);
+  if (srid > 0 && typmod >= 0 && TYPMOD_GET_SRID(typmod) == srid)
+    return arg;
+  return NULL;
+}
+
+/**
+ * @brief Simplify expandSpace(box, 0) into its argument, which arises when
+ * the expansion distance is computed by the application and may be zero
+ */
+static Node *
+temporal_simplify_expandspace(FuncExpr *expr)
+{
+  Node *arg = (Node *) linitial(expr->args);
+  Node *distarg = (Node *) lsecond(expr->args);
+  if (! IsA(distarg, Const) || ((Const *) distarg)->constisnull)
+    return NULL;
+  /* The call is the identity only when the argument is itself a box */
+  if (oid_type(exprType(arg)) != T_STBOX)
+    return NULL;
+  if (DatumGetFloat8(((Const *) distarg)->constvalue) != 0.0)
+    return NULL;
+  return arg;
+}
+
 /**
  * @brief Transform the constant into a bounding box
  */
@@ -341,6 +385,21 @@ temporal_supportfn_ext(FunctionCallInfo fcinfo, TemporalFamily tempfamily)
     || tempfamily == TNPOINTTYPE
 #endif /* NPOINT */
     );
+  /* Fold constant subexpressions at plan time. The simplifications remove
+   * calls that are provably no-ops, so repeated executions of prepared
+   * statements stop paying for them on every row */
+  if (IsA(rawreq, SupportRequestSimplify))
+  {
+    SupportRequestSimplify *req = (SupportRequestSimplify *) rawreq;
+    const char *fn_name = get_func_name(req->fcall->funcid);
+    Node *simplified = NULL;
+    if (strcmp(fn_name, "transform") == 0)
+      simplified = temporal_simplify_transform(req->fcall);
+    else if (strcmp(fn_name, "expandspace") == 0)
+      simplified = temporal_simplify_expandspace(req->fcall);
+    PG_RETURN_POINTER(simplified);
+  }
+
   if (IsA(rawreq, SupportRequestSelectivity))
   {
     SupportRequestSelectivity *req = (SupportRequestSelectivity *) rawreq;
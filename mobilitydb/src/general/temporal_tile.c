@@ -500,11 +500,71 @@ PG_FUNCTION_INFO_V1(Temporal_time_split);
 /**
  * @ingroup mobilitydb_temporal_analytics_tile
  * @brief Split a temporal value into fragments with respect to period buckets.
+ * @note Contrary to the value split functions, the fragments are produced
+ * one bucket at a time instead of being materialized upfront, so the memory
+ * needed is bounded by the size of a bucket regardless of the grid
+ * resolution
  */
 Datum
 Temporal_time_split(PG_FUNCTION_ARGS)
 {
-  return Temporal_value_time_split_ext(fcinfo, false, true);
+  FuncCallContext *funcctx;
+  TimeSplitState *state;
+  bool isnull[2] = {0,0}; /* needed to say no value is null */
+  Datum tuple_arr[2]; /* used to construct the composite return value */
+  HeapTuple tuple;
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+    /* Get input parameters */
+    Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+    Interval *duration = PG_GETARG_INTERVAL_P(1);
+    TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(2);
+    ensure_valid_duration(duration);
+
+    /* Create function state */
+    funcctx->user_fctx = time_split_state_make(temp, duration, torigin);
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Produce the fragment of the next non-empty bucket; the state and the
+   * fragment must survive until the tuple is formed and are thus allocated
+   * in the multi-call memory context */
+  MemoryContext oldcontext =
+    MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+  TimestampTz time = 0;
+  Temporal *frag = time_split_state_next(state, &time);
+  MemoryContextSwitchTo(oldcontext);
+  /* Stop when we've output all the fragments */
+  if (! frag)
+  {
+    time_split_state_free(state);
+    SRF_RETURN_DONE(funcctx);
+  }
+
+  /* Store timestamp and split */
+  tuple_arr[0] = TimestampTzGetDatum(time);
+  tuple_arr[1] = PointerGetDatum(frag);
+  /* Form tuple and return */
+  tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  Datum result = HeapTupleGetDatum(tuple);
+  /* The tuple holds a copy of the fragment */
+  pfree(frag);
+  SRF_RETURN_NEXT(funcctx, result);
 }
 
 PGDLLEXPORT Datum Tnumber_value_split(PG_FUNCTION_ARGS);
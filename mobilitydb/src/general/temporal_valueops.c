@@ -0,0 +1,562 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Value set operators for temporal alphanumeric types.
+ *
+ * These operators test the set of distinct base values taken by a temporal
+ * integer or a temporal text. The following operators are defined:
+ *    overlaps, contains, contained, same
+ */
+
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/set.h"
+#include "general/temporal.h"
+#include "general/type_util.h"
+/* MobilityDB */
+#include "pg_general/meos_catalog.h"
+#include "pg_general/temporal.h"
+#include "pg_general/type_util.h"
+
+/*****************************************************************************
+ * Generic value set functions
+ *****************************************************************************/
+
+/**
+ * @brief Return the set of distinct base values taken by a temporal value
+ */
+Set *
+temporal_valueset(const Temporal *temp)
+{
+  int count;
+  Datum *values = temporal_values(temp, &count);
+  return set_make_free(values, count, temptype_basetype(temp->temptype),
+    ORDERED);
+}
+
+/**
+ * @brief Return true if the temporal value and the base value satisfy the
+ * function
+ */
+bool
+contains_value_temporal_value(const Temporal *temp, Datum value,
+  bool invert __attribute__((unused)))
+{
+  Set *values = temporal_valueset(temp);
+  bool result = contains_set_value(values, value,
+    temptype_basetype(temp->temptype));
+  pfree(values);
+  return result;
+}
+
+/**
+ * @brief Return true if the temporal value and the base value satisfy the
+ * function
+ */
+bool
+contained_value_temporal_value(const Temporal *temp, Datum value,
+  bool invert __attribute__((unused)))
+{
+  return contains_value_temporal_value(temp, value, INVERT);
+}
+
+/**
+ * @brief Return true if the temporal value and the base value satisfy the
+ * function
+ */
+bool
+same_value_temporal_value(const Temporal *temp, Datum value,
+  bool invert __attribute__((unused)))
+{
+  Set *values = temporal_valueset(temp);
+  bool result = (values->count == 1) &&
+    datum_eq(SET_VAL_N(values, 0), value, temptype_basetype(temp->temptype));
+  pfree(values);
+  return result;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Return true if the temporal value and the set satisfy the function
+ */
+bool
+overlaps_value_temporal_set(const Temporal *temp, const Set *s,
+  bool invert __attribute__((unused)))
+{
+  Set *values = temporal_valueset(temp);
+  bool result = overlaps_set_set(values, s);
+  pfree(values);
+  return result;
+}
+
+/**
+ * @brief Return true if the temporal value and the set satisfy the function
+ */
+bool
+contains_value_temporal_set(const Temporal *temp, const Set *s,
+  bool invert)
+{
+  Set *values = temporal_valueset(temp);
+  bool result = invert ?
+    contains_set_set(s, values) : contains_set_set(values, s);
+  pfree(values);
+  return result;
+}
+
+/**
+ * @brief Return true if the temporal value and the set satisfy the function
+ */
+bool
+contained_value_temporal_set(const Temporal *temp, const Set *s,
+  bool invert)
+{
+  return contains_value_temporal_set(temp, s, ! invert);
+}
+
+/**
+ * @brief Return true if the temporal value and the set satisfy the function
+ */
+bool
+same_value_temporal_set(const Temporal *temp, const Set *s,
+  bool invert __attribute__((unused)))
+{
+  Set *values = temporal_valueset(temp);
+  bool result = set_eq(values, s);
+  pfree(values);
+  return result;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Return true if the two temporal values satisfy the function
+ */
+bool
+overlaps_value_temporal_temporal(const Temporal *temp1, const Temporal *temp2)
+{
+  Set *values1 = temporal_valueset(temp1);
+  Set *values2 = temporal_valueset(temp2);
+  bool result = overlaps_set_set(values1, values2);
+  pfree(values1); pfree(values2);
+  return result;
+}
+
+/**
+ * @brief Return true if the two temporal values satisfy the function
+ */
+bool
+contains_value_temporal_temporal(const Temporal *temp1, const Temporal *temp2)
+{
+  Set *values1 = temporal_valueset(temp1);
+  Set *values2 = temporal_valueset(temp2);
+  bool result = contains_set_set(values1, values2);
+  pfree(values1); pfree(values2);
+  return result;
+}
+
+/**
+ * @brief Return true if the two temporal values satisfy the function
+ */
+bool
+contained_value_temporal_temporal(const Temporal *temp1, const Temporal *temp2)
+{
+  Set *values1 = temporal_valueset(temp1);
+  Set *values2 = temporal_valueset(temp2);
+  bool result = contains_set_set(values2, values1);
+  pfree(values1); pfree(values2);
+  return result;
+}
+
+/**
+ * @brief Return true if the two temporal values satisfy the function
+ */
+bool
+same_value_temporal_temporal(const Temporal *temp1, const Temporal *temp2)
+{
+  Set *values1 = temporal_valueset(temp1);
+  Set *values2 = temporal_valueset(temp2);
+  bool result = set_eq(values1, values2);
+  pfree(values1); pfree(values2);
+  return result;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Generic value function for a base value and a temporal value
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Function
+ */
+Datum
+valueop_base_temporal_ext(FunctionCallInfo fcinfo,
+  bool (*func)(const Temporal *, Datum, bool))
+{
+  Datum value = PG_GETARG_ANYDATUM(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  meosType basetype = oid_type_cached(fcinfo, 0);
+  bool result = func(temp, value, INVERT);
+  DATUM_FREE_IF_COPY(value, basetype, 0);
+  PG_FREE_IF_COPY(temp, 1);
+  PG_RETURN_BOOL(result);
+}
+
+/**
+ * @brief Generic value function for a temporal value and a base value
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Function
+ */
+Datum
+valueop_temporal_base_ext(FunctionCallInfo fcinfo,
+  bool (*func)(const Temporal *, Datum, bool))
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Datum value = PG_GETARG_ANYDATUM(1);
+  meosType basetype = oid_type_cached(fcinfo, 1);
+  bool result = func(temp, value, INVERT_NO);
+  PG_FREE_IF_COPY(temp, 0);
+  DATUM_FREE_IF_COPY(value, basetype, 1);
+  PG_RETURN_BOOL(result);
+}
+
+/**
+ * @brief Generic value function for a set and a temporal value
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Function
+ */
+Datum
+valueop_set_temporal_ext(FunctionCallInfo fcinfo,
+  bool (*func)(const Temporal *, const Set *, bool))
+{
+  Set *s = PG_GETARG_SET_P(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  bool result = func(temp, s, INVERT);
+  PG_FREE_IF_COPY(s, 0);
+  PG_FREE_IF_COPY(temp, 1);
+  PG_RETURN_BOOL(result);
+}
+
+/**
+ * @brief Generic value function for a temporal value and a set
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Function
+ */
+Datum
+valueop_temporal_set_ext(FunctionCallInfo fcinfo,
+  bool (*func)(const Temporal *, const Set *, bool))
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Set *s = PG_GETARG_SET_P(1);
+  bool result = func(temp, s, INVERT_NO);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(s, 1);
+  PG_RETURN_BOOL(result);
+}
+
+/**
+ * @brief Generic value function for two temporal values
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Function
+ */
+Datum
+valueop_temporal_temporal_ext(FunctionCallInfo fcinfo,
+  bool (*func)(const Temporal *, const Temporal *))
+{
+  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  bool result = func(temp1, temp2);
+  PG_FREE_IF_COPY(temp1, 0);
+  PG_FREE_IF_COPY(temp2, 1);
+  PG_RETURN_BOOL(result);
+}
+
+/*****************************************************************************
+ * Overlaps
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Overlaps_value_set_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Overlaps_value_set_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the set overlaps the value set of the temporal value
+ * @sqlfunc overlaps_value()
+ * @sqlop @@
+ */
+Datum
+Overlaps_value_set_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_set_temporal_ext(fcinfo, &overlaps_value_temporal_set);
+}
+
+PGDLLEXPORT Datum Overlaps_value_temporal_set(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Overlaps_value_temporal_set);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value set of the temporal value overlaps the set
+ * @sqlfunc overlaps_value()
+ * @sqlop @@
+ */
+Datum
+Overlaps_value_temporal_set(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_set_ext(fcinfo, &overlaps_value_temporal_set);
+}
+
+PGDLLEXPORT Datum Overlaps_value_temporal_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Overlaps_value_temporal_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value sets of the two temporal values overlap
+ * @sqlfunc overlaps_value()
+ * @sqlop @@
+ */
+Datum
+Overlaps_value_temporal_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_temporal_ext(fcinfo,
+    &overlaps_value_temporal_temporal);
+}
+
+/*****************************************************************************
+ * Contains
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Contains_value_set_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Contains_value_set_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the set contains the value set of the temporal value
+ * @sqlfunc contains_value()
+ * @sqlop @?
+ */
+Datum
+Contains_value_set_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_set_temporal_ext(fcinfo, &contains_value_temporal_set);
+}
+
+PGDLLEXPORT Datum Contains_value_temporal_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Contains_value_temporal_value);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the temporal value ever takes the base value
+ * @sqlfunc contains_value()
+ * @sqlop @?
+ */
+Datum
+Contains_value_temporal_value(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_base_ext(fcinfo, &contains_value_temporal_value);
+}
+
+PGDLLEXPORT Datum Contains_value_temporal_set(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Contains_value_temporal_set);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value set of the temporal value contains the set
+ * @sqlfunc contains_value()
+ * @sqlop @?
+ */
+Datum
+Contains_value_temporal_set(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_set_ext(fcinfo, &contains_value_temporal_set);
+}
+
+PGDLLEXPORT Datum Contains_value_temporal_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Contains_value_temporal_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value set of the first temporal value contains
+ * the one of the second temporal value
+ * @sqlfunc contains_value()
+ * @sqlop @?
+ */
+Datum
+Contains_value_temporal_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_temporal_ext(fcinfo,
+    &contains_value_temporal_temporal);
+}
+
+/*****************************************************************************
+ * Contained
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Contained_value_value_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Contained_value_value_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the base value is contained in the value set of the
+ * temporal value
+ * @sqlfunc contained_value()
+ * @sqlop ?@
+ */
+Datum
+Contained_value_value_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_base_temporal_ext(fcinfo, &contained_value_temporal_value);
+}
+
+PGDLLEXPORT Datum Contained_value_set_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Contained_value_set_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the set is contained in the value set of the temporal
+ * value
+ * @sqlfunc contained_value()
+ * @sqlop ?@
+ */
+Datum
+Contained_value_set_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_set_temporal_ext(fcinfo, &contained_value_temporal_set);
+}
+
+PGDLLEXPORT Datum Contained_value_temporal_set(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Contained_value_temporal_set);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value set of the temporal value is contained in
+ * the set
+ * @sqlfunc contained_value()
+ * @sqlop ?@
+ */
+Datum
+Contained_value_temporal_set(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_set_ext(fcinfo, &contained_value_temporal_set);
+}
+
+PGDLLEXPORT Datum Contained_value_temporal_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Contained_value_temporal_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value set of the first temporal value is
+ * contained in the one of the second temporal value
+ * @sqlfunc contained_value()
+ * @sqlop ?@
+ */
+Datum
+Contained_value_temporal_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_temporal_ext(fcinfo,
+    &contained_value_temporal_temporal);
+}
+
+/*****************************************************************************
+ * Same
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Same_value_value_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Same_value_value_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value set of the temporal value is equal to the
+ * base value
+ * @sqlfunc same_value()
+ * @sqlop @=
+ */
+Datum
+Same_value_value_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_base_temporal_ext(fcinfo, &same_value_temporal_value);
+}
+
+PGDLLEXPORT Datum Same_value_set_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Same_value_set_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value set of the temporal value is equal to the
+ * set
+ * @sqlfunc same_value()
+ * @sqlop @=
+ */
+Datum
+Same_value_set_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_set_temporal_ext(fcinfo, &same_value_temporal_set);
+}
+
+PGDLLEXPORT Datum Same_value_temporal_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Same_value_temporal_value);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value set of the temporal value is equal to the
+ * base value
+ * @sqlfunc same_value()
+ * @sqlop @=
+ */
+Datum
+Same_value_temporal_value(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_base_ext(fcinfo, &same_value_temporal_value);
+}
+
+PGDLLEXPORT Datum Same_value_temporal_set(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Same_value_temporal_set);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value set of the temporal value is equal to the
+ * set
+ * @sqlfunc same_value()
+ * @sqlop @=
+ */
+Datum
+Same_value_temporal_set(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_set_ext(fcinfo, &same_value_temporal_set);
+}
+
+PGDLLEXPORT Datum Same_value_temporal_temporal(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Same_value_temporal_temporal);
+/**
+ * @ingroup mobilitydb_temporal_value
+ * @brief Return true if the value sets of the two temporal values are equal
+ * @sqlfunc same_value()
+ * @sqlop @=
+ */
+Datum
+Same_value_temporal_temporal(PG_FUNCTION_ARGS)
+{
+  return valueop_temporal_temporal_ext(fcinfo, &same_value_temporal_temporal);
+}
+
+/*****************************************************************************/
@@ -282,6 +282,17 @@ tinstant_transform_wcount(const TInstant *inst, const Interval *interval,
 /**
  * @brief Transform the temporal number discrete sequence value by the time
  * interval
+ *
+ * Extending every instant separately produces pairwise-overlapping unit
+ * sequences whose subsequent aggregation costs O(window x rate). Since the
+ * count transition is invertible, the function instead sweeps the arrival
+ * and expiry events of the windows once and emits ready-made,
+ * non-overlapping step sequences holding the rolling counts, which the
+ * aggregation then splices in linear time. A step sequence cannot represent
+ * a value change immediately after an inclusive timestamp, hence a sequence
+ * is closed at each expiry and the next one starts at the same timestamp
+ * with an exclusive lower bound.
+ *
  * @param[in] seq Temporal value
  * @param[in] interval Interval
  * @param[out] result Array on which the pointers of the newly constructed
@@ -291,12 +302,59 @@ static int
 tdiscseq_transform_wcount(const TSequence *seq, const Interval *interval,
   TSequence **result)
 {
-  for (int i = 0; i < seq->count; i++)
+  int n = seq->count;
+  /* Expiry timestamps, in the same increasing order as the instants */
+  TimestampTz *expiry = palloc(sizeof(TimestampTz) * n);
+  for (int i = 0; i < n; i++)
+    expiry[i] = pg_timestamp_pl_interval(TSEQUENCE_INST_N(seq, i)->t,
+      interval);
+
+  TInstant **instants = palloc(sizeof(TInstant *) * (n + 2));
+  int i = 0,           /* Next arrival event */
+      j = 0,           /* Next expiry event */
+      count = 0,       /* Rolling count */
+      ninsts = 0, nseqs = 0;
+  bool lower_inc = true;
+  while (j < n)
   {
-    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
-    tinstant_transform_wcount(inst, interval, &result[i]);
+    /* Get the timestamp of the next event; an arrival and an expiry may
+     * coincide, but two arrivals (or two expiries) cannot */
+    bool arrival = (i < n) && (TSEQUENCE_INST_N(seq, i)->t <= expiry[j]);
+    TimestampTz t = arrival ? TSEQUENCE_INST_N(seq, i)->t : expiry[j];
+    bool expire = (expiry[j] == t);
+    if (arrival)
+    {
+      if (ninsts == 0)
+        /* The first window of the run starts at its arrival */
+        lower_inc = true;
+      count++;
+      i++;
+      instants[ninsts++] = tinstant_make(Int32GetDatum(count), T_TINT, t);
+    }
+    if (expire)
+    {
+      /* The expiring window still covers t: close the current sequence at t
+       * with the count before the expiry takes effect */
+      j++;
+      if (! arrival)
+        instants[ninsts++] = tinstant_make(Int32GetDatum(count), T_TINT, t);
+      result[nseqs++] = tsequence_make((const TInstant **) instants, ninsts,
+        lower_inc, true, STEP, NORMALIZE_NO);
+      for (int k = 0; k < ninsts; k++)
+        pfree(instants[k]);
+      ninsts = 0;
+      count--;
+      if (count > 0)
+      {
+        /* The remaining windows continue immediately after t */
+        lower_inc = false;
+        instants[ninsts++] = tinstant_make(Int32GetDatum(count), T_TINT, t);
+      }
+    }
   }
-  return seq->count;
+  pfree(instants);
+  pfree(expiry);
+  return nseqs;
 }
 
 /**
@@ -0,0 +1,181 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief BRIN inclusion index for temporal numbers.
+ *
+ * The index summarizes every block range by the union of the temporal boxes
+ * of the rows it contains, so a scan restricted by value and/or time skips
+ * the block ranges whose summary box cannot satisfy the operator. This is
+ * attractive for naturally ordered (e.g., append-only) tables, where the
+ * summaries stay tight and the index is orders of magnitude smaller than a
+ * GiST index over the same column.
+ *
+ * The consistent function applies the same possibility tests as the
+ * internal pages of the GiST index, since a summary box is the union of the
+ * boxes of the rows of the block range exactly as an internal key is the
+ * union of the keys below it.
+ */
+
+/* C */
+#include <assert.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <access/brin_internal.h>
+#include <access/skey.h>
+#include <access/stratnum.h>
+#include <utils/typcache.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/tbox.h"
+#include "general/temporal.h"
+/* MobilityDB */
+#include "pg_general/meos_catalog.h"
+#include "pg_general/tnumber_gist.h"
+
+/*****************************************************************************/
+
+PGDLLEXPORT Datum Tbox_brin_opcinfo(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_opcinfo);
+/**
+ * @brief BRIN opcinfo function for temporal numbers
+ *
+ * The summary of a block range is a single temporal box.
+ */
+Datum
+Tbox_brin_opcinfo(PG_FUNCTION_ARGS)
+{
+  BrinOpcInfo *result = palloc0(MAXALIGN(SizeofBrinOpcInfo(1)));
+  result->oi_nstored = 1;
+  result->oi_regular_nulls = true;
+  result->oi_opaque = NULL;
+  result->oi_typcache[0] = lookup_type_cache(type_oid(T_TBOX), 0);
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Tnumber_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_brin_add_value);
+/**
+ * @brief BRIN add value function for temporal numbers
+ *
+ * Expand the summary box of the block range with the bounding box of the
+ * new temporal value.
+ */
+Datum
+Tnumber_brin_add_value(PG_FUNCTION_ARGS)
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  Datum newval = PG_GETARG_DATUM(2);
+  TBox box;
+  /* Read the bounding box from the start of the (possibly toasted) value */
+  temporal_bbox_slice(newval, &box);
+  if (column->bv_allnulls)
+  {
+    /* First non-null value of the block range */
+    column->bv_values[0] = PointerGetDatum(tbox_copy(&box));
+    column->bv_allnulls = false;
+    PG_RETURN_BOOL(true);
+  }
+  TBox *summary = DatumGetTboxP(column->bv_values[0]);
+  TBox previous = *summary;
+  tbox_expand(&box, summary);
+  PG_RETURN_BOOL(memcmp(&previous, summary, sizeof(TBox)) != 0);
+}
+
+/**
+ * @brief Transform the argument of a scan key into a temporal box
+ */
+static bool
+tnumber_brin_get_tbox(const ScanKey key, TBox *result)
+{
+  meosType type = oid_type(key->sk_subtype);
+  if (tnumber_spantype(type))
+    numspan_set_tbox(DatumGetSpanP(key->sk_argument), result);
+  else if (type == T_TSTZSPAN)
+    period_set_tbox(DatumGetSpanP(key->sk_argument), result);
+  else if (type == T_TBOX)
+    memcpy(result, DatumGetTboxP(key->sk_argument), sizeof(TBox));
+  else if (tnumber_type(type))
+    temporal_bbox_slice(key->sk_argument, result);
+  else
+    elog(ERROR, "Unsupported type for indexing: %d", type);
+  return true;
+}
+
+PGDLLEXPORT Datum Tbox_brin_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_consistent);
+/**
+ * @brief BRIN consistent function for temporal numbers
+ *
+ * Return true if the block range may contain a row satisfying the scan key,
+ * that is, unless the operator is false for every box included in the
+ * summary box.
+ */
+Datum
+Tbox_brin_consistent(PG_FUNCTION_ARGS)
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  ScanKey key = (ScanKey) PG_GETARG_POINTER(2);
+  if (column->bv_allnulls)
+    PG_RETURN_BOOL(false);
+  TBox *summary = DatumGetTboxP(column->bv_values[0]);
+  TBox query;
+  if (! tnumber_brin_get_tbox(key, &query))
+    PG_RETURN_BOOL(false);
+  /* A summary box is the union of the boxes of the rows of the block range,
+   * exactly as a GiST internal key is the union of the keys below it */
+  PG_RETURN_BOOL(tnumber_gist_consistent(summary, &query, key->sk_strategy));
+}
+
+PGDLLEXPORT Datum Tbox_brin_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_union);
+/**
+ * @brief BRIN union function for temporal numbers
+ *
+ * Expand the first summary box with the second one.
+ */
+Datum
+Tbox_brin_union(PG_FUNCTION_ARGS)
+{
+  BrinValues *col_a = (BrinValues *) PG_GETARG_POINTER(1);
+  BrinValues *col_b = (BrinValues *) PG_GETARG_POINTER(2);
+  TBox *box_b = DatumGetTboxP(col_b->bv_values[0]);
+  if (col_a->bv_allnulls)
+  {
+    col_a->bv_values[0] = PointerGetDatum(tbox_copy(box_b));
+    col_a->bv_allnulls = false;
+    PG_RETURN_BOOL(true);
+  }
+  tbox_expand(box_b, DatumGetTboxP(col_a->bv_values[0]));
+  PG_RETURN_BOOL(true);
+}
+
+/*****************************************************************************/
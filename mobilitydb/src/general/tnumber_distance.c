@@ -48,6 +48,7 @@
 #include "general/lifting.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
+#include "pg_general/type_util.h"
 
 /*****************************************************************************
  * Temporal distance
@@ -106,8 +107,10 @@ PG_FUNCTION_INFO_V1(Distance_tnumber_tnumber);
 Datum
 Distance_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   Temporal *result = distance_tnumber_tnumber(temp1, temp2);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
@@ -226,8 +229,10 @@ PG_FUNCTION_INFO_V1(NAD_tnumber_tnumber);
 Datum
 NAD_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   Temporal *dist = distance_tnumber_tnumber(temp1, temp2);
   if (dist == NULL)
   {
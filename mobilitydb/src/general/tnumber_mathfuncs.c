@@ -67,7 +67,7 @@ arithop_number_tnumber_ext(FunctionCallInfo fcinfo, TArithmetic oper,
 {
   Datum value = PG_GETARG_DATUM(0);
   Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType basetype = oid_type_cached(fcinfo, 0);
   Temporal *result = arithop_tnumber_number(temp, value, basetype, oper,
     func, INVERT);
   PG_FREE_IF_COPY(temp, 1);
@@ -86,7 +86,7 @@ arithop_tnumber_number_ext(FunctionCallInfo fcinfo, TArithmetic oper,
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   Datum value = PG_GETARG_DATUM(1);
-  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  meosType basetype = oid_type_cached(fcinfo, 1);
   Temporal *result = arithop_tnumber_number(temp, value, basetype, oper,
     func, INVERT_NO);
   PG_FREE_IF_COPY(temp, 0);
@@ -106,8 +106,10 @@ arithop_tnumber_tnumber_ext(FunctionCallInfo fcinfo, TArithmetic oper,
   bool (*tpfunc)(const TInstant *, const TInstant *, const TInstant *,
     const TInstant *, Datum *, TimestampTz *))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   Temporal *result = arithop_tnumber_tnumber(temp1, temp2, oper, func, tpfunc);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
@@ -40,6 +40,8 @@
 #include "general/temporal.h"
 #include "general/ttext_textfuncs.h"
 #include "general/type_util.h"
+/* MobilityDB */
+#include "pg_general/type_util.h"
 
 /*****************************************************************************
  * Text concatenation
@@ -92,8 +94,10 @@ PG_FUNCTION_INFO_V1(Textcat_ttext_ttext);
 Datum
 Textcat_ttext_ttext(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   Temporal *result = textfunc_ttext_ttext(temp1, temp2, &datum_textcat);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
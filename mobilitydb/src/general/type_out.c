@@ -307,7 +307,7 @@ Set_as_wkb(PG_FUNCTION_ARGS)
 {
   /* Ensure that the value is detoasted if necessary */
   Set *s = PG_GETARG_SET_P(0);
-  meosType settype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType settype = oid_type_cached(fcinfo, 0);
   bytea *result = datum_as_wkb_ext(fcinfo, PointerGetDatum(s), settype,
     true);
   PG_FREE_IF_COPY(s, 0);
@@ -326,7 +326,7 @@ Set_as_hexwkb(PG_FUNCTION_ARGS)
 {
   /* Ensure that the value is detoasted if necessary */
   Set *s = PG_GETARG_SET_P(0);
-  meosType settype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 0));
+  meosType settype = oid_type_cached(fcinfo, 0);
   text *result = datum_as_hexwkb_ext(fcinfo, PointerGetDatum(s), settype);
   PG_FREE_IF_COPY(s, 0);
   PG_RETURN_TEXT_P(result);
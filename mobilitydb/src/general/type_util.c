@@ -174,6 +174,71 @@ call_function3(PGFunction func, Datum arg1, Datum arg2, Datum arg3)
   return result;
 }
 
+/*****************************************************************************
+ * Argument preparation functions
+ *****************************************************************************/
+
+/**
+ * @brief Detoast two temporal arguments when their bounding periods overlap
+ *
+ * The periods are read from header slices of the arguments, so that pairs
+ * failing the test -- the common case in join workloads -- do not pay the
+ * detoasting of the full values. The function can only be used by the
+ * functions that return a null result when the arguments do not overlap on
+ * the time dimension, since the argument validity checks performed by the
+ * wrapped function are skipped in that case.
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] argno1,argno2 Number of the temporal arguments
+ * @param[out] temp1,temp2 Detoasted arguments, set when the function
+ * returns true
+ * @return True when the bounding periods of the arguments overlap
+ */
+bool
+temporal_getarg_if_overlaps(FunctionCallInfo fcinfo, int argno1, int argno2,
+  Temporal **temp1, Temporal **temp2)
+{
+  Datum tempdatum1 = PG_GETARG_DATUM(argno1);
+  Datum tempdatum2 = PG_GETARG_DATUM(argno2);
+  Span p1, p2;
+  temporal_period_slice(tempdatum1, &p1);
+  temporal_period_slice(tempdatum2, &p2);
+  if (! overlaps_span_span(&p1, &p2))
+    return false;
+  *temp1 = DatumGetTemporalP(tempdatum1);
+  *temp2 = DatumGetTemporalP(tempdatum2);
+  return true;
+}
+
+/**
+ * @brief Detoast a temporal argument when its bounding period contains a
+ * timestamp argument
+ *
+ * The period is read from a header slice of the argument, so that values
+ * not covering the timestamp -- the bulk of a fleet in snapshot queries
+ * asking where every vehicle was at one instant -- do not pay the
+ * detoasting of the full value. The function can only be used by the
+ * functions that return a null result when the timestamp falls outside the
+ * time dimension of the temporal argument.
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] argno1 Number of the temporal argument
+ * @param[in] argno2 Number of the timestamp argument
+ * @param[out] temp Detoasted argument, set when the function returns true
+ * @return True when the bounding period contains the timestamp
+ */
+bool
+temporal_getarg_if_contains_timestamp(FunctionCallInfo fcinfo, int argno1,
+  int argno2, Temporal **temp)
+{
+  Datum tempdatum = PG_GETARG_DATUM(argno1);
+  TimestampTz t = PG_GETARG_TIMESTAMPTZ(argno2);
+  Span p;
+  temporal_period_slice(tempdatum, &p);
+  if (! contains_span_value(&p, TimestampTzGetDatum(t), T_TIMESTAMPTZ))
+    return false;
+  *temp = DatumGetTemporalP(tempdatum);
+  return true;
+}
+
 /*****************************************************************************
  * Array functions
  *****************************************************************************/
@@ -39,6 +39,7 @@
 /* MEOS */
 #include <meos.h>
 #include "general/lifting.h"
+#include "general/set.h"
 #include "general/type_parser.h"
 #include "general/type_util.h"
 #include "npoint/tnpoint_static.h"
@@ -252,4 +253,93 @@ Tnpoint_routes(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Restriction functions
+ *****************************************************************************/
+
+/**
+ * @brief Restrict a temporal network point to (the complement of) a route
+ */
+static Datum
+tnpoint_restrict_route_ext(FunctionCallInfo fcinfo, bool atfunc)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  int64 rid = PG_GETARG_INT64(1);
+  Temporal *result = tnpoint_restrict_route(temp, rid, atfunc);
+  PG_FREE_IF_COPY(temp, 0);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Tnpoint_at_route(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnpoint_at_route);
+/**
+ * @ingroup mobilitydb_temporal_restrict
+ * @brief Restrict a temporal network point to a route
+ * @sqlfunc atRoute()
+ */
+Datum
+Tnpoint_at_route(PG_FUNCTION_ARGS)
+{
+  return tnpoint_restrict_route_ext(fcinfo, REST_AT);
+}
+
+PGDLLEXPORT Datum Tnpoint_minus_route(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnpoint_minus_route);
+/**
+ * @ingroup mobilitydb_temporal_restrict
+ * @brief Restrict a temporal network point to the complement of a route
+ * @sqlfunc minusRoute()
+ */
+Datum
+Tnpoint_minus_route(PG_FUNCTION_ARGS)
+{
+  return tnpoint_restrict_route_ext(fcinfo, REST_MINUS);
+}
+
+/**
+ * @brief Restrict a temporal network point to (the complement of) a set of
+ * routes
+ */
+static Datum
+tnpoint_restrict_routes_ext(FunctionCallInfo fcinfo, bool atfunc)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Set *s = PG_GETARG_SET_P(1);
+  Temporal *result = tnpoint_restrict_routes(temp, s, atfunc);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(s, 1);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Tnpoint_at_routes(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnpoint_at_routes);
+/**
+ * @ingroup mobilitydb_temporal_restrict
+ * @brief Restrict a temporal network point to a set of routes
+ * @sqlfunc atRoutes()
+ */
+Datum
+Tnpoint_at_routes(PG_FUNCTION_ARGS)
+{
+  return tnpoint_restrict_routes_ext(fcinfo, REST_AT);
+}
+
+PGDLLEXPORT Datum Tnpoint_minus_routes(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnpoint_minus_routes);
+/**
+ * @ingroup mobilitydb_temporal_restrict
+ * @brief Restrict a temporal network point to the complement of a set of
+ * routes
+ * @sqlfunc minusRoutes()
+ */
+Datum
+Tnpoint_minus_routes(PG_FUNCTION_ARGS)
+{
+  return tnpoint_restrict_routes_ext(fcinfo, REST_MINUS);
+}
+
 /*****************************************************************************/
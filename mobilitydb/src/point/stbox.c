@@ -184,7 +184,7 @@ stbox_constructor_ext(FunctionCallInfo fcinfo, bool hasx, bool hasz,
   }
   if (hast)
   {
-    meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, i));
+    meosType basetype = oid_type_cached(fcinfo, i);
     if (basetype == T_TSTZSPAN)
       period = PG_GETARG_SPAN_P(i++);
     else /* basetype == T_TIMESTAMPTZ */
@@ -65,11 +65,25 @@ Datum
 Tpoint_extent_transfn(PG_FUNCTION_ARGS)
 {
   STBox *box = PG_ARGISNULL(0) ? NULL : PG_GETARG_STBOX_P(0);
-  Temporal *temp = PG_ARGISNULL(1) ? NULL : PG_GETARG_TEMPORAL_P(1);
-  STBox *result = tpoint_extent_transfn(box, temp);
-  if (! result)
+  /* Can't do anything with null inputs */
+  if (! box && PG_ARGISNULL(1))
     PG_RETURN_NULL();
-  PG_RETURN_POINTER(result);
+  /* Null temporal, return the state */
+  if (PG_ARGISNULL(1))
+    PG_RETURN_POINTER(box);
+  /* Read only the bounding box from the header of the temporal value
+   * instead of detoasting it completely */
+  STBox b;
+  temporal_bbox_slice(PG_GETARG_DATUM(1), &b);
+  /* Null state, return the bounding box of the temporal */
+  if (! box)
+    PG_RETURN_POINTER(stbox_copy(&b));
+  /* Ensure validity of the arguments */
+  ensure_same_srid(stbox_srid(&b), stbox_srid(box));
+  ensure_same_dimensionality(b.flags, box->flags);
+  ensure_same_geodetic(b.flags, box->flags);
+  stbox_expand(&b, box);
+  PG_RETURN_POINTER(box);
 }
 
 /*****************************************************************************
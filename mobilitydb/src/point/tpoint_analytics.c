@@ -135,4 +135,25 @@ Temporal_simplify_dp(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+PGDLLEXPORT Datum Temporal_simplify_count(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_simplify_count);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Simplify the temporal sequence (set) float or point to a target
+ * number of instants with a top-down greedy refinement of the
+ * Douglas-Peucker line simplification algorithm.
+ */
+Datum
+Temporal_simplify_count(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  int count = PG_GETARG_INT32(1);
+  bool syncdist = true;
+  if (PG_NARGS() > 2 && ! PG_ARGISNULL(2))
+    syncdist = PG_GETARG_BOOL(2);
+  Temporal *result = temporal_simplify_count(temp, count, syncdist);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************/
@@ -49,7 +49,9 @@
  *     - `stanumbers` stores the ND histogram of occurrence of features.
  *
  * For the time dimension, the statistics collected in Slots 3 and 4 depend on
- * the subtype. Please refer to file temporal_analyze.c for more information.
+ * the subtype. In addition, Slot 5 stores a histogram of the number of
+ * instants per value. Please refer to file temporal_analyze.c for more
+ * information.
  */
 
 #include "pg_point/tpoint_analyze.h"
@@ -61,6 +63,12 @@
 /* PostgreSQL */
 #include <postgres.h>
 #include <access/htup_details.h>
+#if POSTGRESQL_VERSION_NUMBER < 130000
+  #include <access/tuptoaster.h>
+#else
+  #include <access/heaptoast.h>
+  #include <access/detoast.h>
+#endif
 #include <executor/spi.h>
 #include <utils/lsyscache.h>
 /* MEOS */
@@ -72,6 +80,7 @@
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
 #include "pg_general/span_analyze.h"
+#include "pg_general/temporal.h"
 #include "pg_general/temporal_analyze.h"
 
 /*****************************************************************************
@@ -610,12 +619,9 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     }
     else /* tspatial_type(type) */
     {
-      /* Get bounding box from temporal point */
-      Temporal *temp = DatumGetTemporalP(datum);
-      temporal_set_bbox(temp, &box);
-      /* Free up memory if our temporal point was copied */
-      if (VARATT_IS_EXTENDED(temp))
-        pfree(temp);
+      /* Get the bounding box by peeking into the header of the temporal
+       * point, which avoids detoasting its instants */
+      temporal_bbox_slice(datum, &box);
     }
 
     /* Convert a spatiotemporal box into a PostGIS gbox */
@@ -1044,6 +1050,7 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   SpanBound *time_lowers = palloc(sizeof(SpanBound) * sample_rows);
   SpanBound *time_uppers = palloc(sizeof(SpanBound) * sample_rows);
   float8 *time_lengths = palloc(sizeof(float8) * sample_rows);
+  float8 *inst_counts = palloc(sizeof(float8) * sample_rows);
 
   /*
    * First scan for obtaining the number of nulls and not nulls, the total
@@ -1061,15 +1068,14 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       continue;
     }
 
-    /* Get temporal point */
-    Temporal *temp = DatumGetTemporalP(value);
-
     /* How many bytes does this sample use? */
-    total_width += VARSIZE(temp);
+    total_width += PG_DATUM_NEEDS_DETOAST((struct varlena *) value) ?
+      (double) toast_raw_datum_size(value) : (double) VARSIZE(value);
 
-    /* Get period from temporal point */
+    /* Get the period by peeking into the header of the temporal point,
+     * which avoids detoasting its instants */
     Span period;
-    temporal_set_period(temp, &period);
+    temporal_period_slice(value, &period);
 
     /* Remember time bounds and length for further usage in histograms */
     SpanBound period_lower, period_upper;
@@ -1078,14 +1084,11 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     time_uppers[notnull_cnt] = period_upper;
     time_lengths[notnull_cnt] = distance_value_value(period_upper.val,
       period_lower.val, T_TIMESTAMPTZ);
+    inst_counts[notnull_cnt] = (float8) temporal_count_slice(value);
 
     /* Increment our "good feature" count */
     notnull_cnt++;
 
-    /* Free up memory if our sample temporal point was copied */
-    if (VARATT_IS_EXTENDED(temp))
-      pfree(temp);
-
     /* Give backend a chance of interrupting us */
     vacuum_delay_point();
   }
@@ -1110,6 +1113,9 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     /* Last argument is false to compute statistics for time dimension */
     span_compute_stats_generic(stats, notnull_cnt, &slot_idx, time_lowers,
       time_uppers, time_lengths, false);
+
+    /* Compute the histogram of the number of instants per value */
+    temporal_count_compute_stats(stats, notnull_cnt, &slot_idx, inst_counts);
   }
   else if (null_cnt > 0)
   {
@@ -1123,6 +1129,7 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   pfree(time_lowers);
   pfree(time_uppers);
   pfree(time_lengths);
+  pfree(inst_counts);
   return;
 }
 
@@ -99,11 +99,10 @@ boxop_stbox_tpoint_ext(FunctionCallInfo fcinfo,
   bool (*func)(const STBox *, const STBox *))
 {
   STBox *box = PG_GETARG_STBOX_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Datum tempdatum = PG_GETARG_DATUM(1);
   STBox box1;
-  temporal_set_bbox(temp, &box1);
+  temporal_bbox_slice(tempdatum, &box1);
   bool result = func(box, &box1);
-  PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
 }
 
@@ -116,12 +115,11 @@ Datum
 boxop_tpoint_stbox_ext(FunctionCallInfo fcinfo,
   bool (*func)(const STBox *, const STBox *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Datum tempdatum = PG_GETARG_DATUM(0);
   STBox *box = PG_GETARG_STBOX_P(1);
   STBox box1;
-  temporal_set_bbox(temp, &box1);
+  temporal_bbox_slice(tempdatum, &box1);
   bool result = func(&box1, box);
-  PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_BOOL(result);
 }
 
@@ -134,14 +132,12 @@ Datum
 boxop_tpoint_tpoint_ext(FunctionCallInfo fcinfo,
   bool (*func)(const STBox *, const STBox *))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  Datum tempdatum1 = PG_GETARG_DATUM(0);
+  Datum tempdatum2 = PG_GETARG_DATUM(1);
   STBox box1, box2;
-  temporal_set_bbox(temp1, &box1);
-  temporal_set_bbox(temp2, &box2);
+  temporal_bbox_slice(tempdatum1, &box1);
+  temporal_bbox_slice(tempdatum2, &box2);
   bool result = func(&box1, &box2);
-  PG_FREE_IF_COPY(temp1, 0);
-  PG_FREE_IF_COPY(temp2, 1);
   PG_RETURN_BOOL(result);
 }
 
@@ -0,0 +1,179 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2023, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief BRIN inclusion index for temporal points.
+ *
+ * The index summarizes every block range by the union of the spatiotemporal
+ * boxes of the rows it contains, so a scan restricted by region and/or time
+ * skips the block ranges whose summary box cannot satisfy the operator.
+ * This is attractive for naturally ordered (e.g., append-only) trajectory
+ * tables, where the summaries stay tight and the index is orders of
+ * magnitude smaller than a GiST index over the same column.
+ *
+ * The consistent function applies the same possibility tests as the
+ * internal pages of the GiST index, since a summary box is the union of the
+ * boxes of the rows of the block range exactly as an internal key is the
+ * union of the keys below it.
+ */
+
+/* C */
+#include <assert.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <access/brin_internal.h>
+#include <access/skey.h>
+#include <access/stratnum.h>
+#include <utils/typcache.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+#include "point/stbox.h"
+/* MobilityDB */
+#include "pg_general/meos_catalog.h"
+#include "pg_point/tpoint_gist.h"
+
+/*****************************************************************************/
+
+PGDLLEXPORT Datum Stbox_brin_opcinfo(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_opcinfo);
+/**
+ * @brief BRIN opcinfo function for temporal points
+ *
+ * The summary of a block range is a single spatiotemporal box.
+ */
+Datum
+Stbox_brin_opcinfo(PG_FUNCTION_ARGS)
+{
+  BrinOpcInfo *result = palloc0(MAXALIGN(SizeofBrinOpcInfo(1)));
+  result->oi_nstored = 1;
+  result->oi_regular_nulls = true;
+  result->oi_opaque = NULL;
+  result->oi_typcache[0] = lookup_type_cache(type_oid(T_STBOX), 0);
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Tpoint_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_brin_add_value);
+/**
+ * @brief BRIN add value function for temporal points
+ *
+ * Expand the summary box of the block range with the bounding box of the
+ * new temporal point.
+ */
+Datum
+Tpoint_brin_add_value(PG_FUNCTION_ARGS)
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  Datum newval = PG_GETARG_DATUM(2);
+  STBox box;
+  /* Read the bounding box from the start of the (possibly toasted) value */
+  temporal_bbox_slice(newval, &box);
+  if (column->bv_allnulls)
+  {
+    /* First non-null value of the block range */
+    column->bv_values[0] = PointerGetDatum(stbox_copy(&box));
+    column->bv_allnulls = false;
+    PG_RETURN_BOOL(true);
+  }
+  STBox *summary = DatumGetSTboxP(column->bv_values[0]);
+  STBox previous = *summary;
+  stbox_expand(&box, summary);
+  PG_RETURN_BOOL(memcmp(&previous, summary, sizeof(STBox)) != 0);
+}
+
+/**
+ * @brief Transform the argument of a scan key into a spatiotemporal box
+ */
+static bool
+tpoint_brin_get_stbox(const ScanKey key, STBox *result)
+{
+  meosType type = oid_type(key->sk_subtype);
+  if (type == T_TSTZSPAN)
+    period_set_stbox(DatumGetSpanP(key->sk_argument), result);
+  else if (type == T_STBOX)
+    memcpy(result, DatumGetSTboxP(key->sk_argument), sizeof(STBox));
+  else if (tspatial_type(type))
+    temporal_bbox_slice(key->sk_argument, result);
+  else
+    elog(ERROR, "Unsupported type for indexing: %d", type);
+  return true;
+}
+
+PGDLLEXPORT Datum Stbox_brin_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_consistent);
+/**
+ * @brief BRIN consistent function for temporal points
+ *
+ * Return true if the block range may contain a row satisfying the scan key,
+ * that is, unless the operator is false for every box included in the
+ * summary box.
+ */
+Datum
+Stbox_brin_consistent(PG_FUNCTION_ARGS)
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  ScanKey key = (ScanKey) PG_GETARG_POINTER(2);
+  if (column->bv_allnulls)
+    PG_RETURN_BOOL(false);
+  STBox *summary = DatumGetSTboxP(column->bv_values[0]);
+  STBox query;
+  if (! tpoint_brin_get_stbox(key, &query))
+    PG_RETURN_BOOL(false);
+  /* A summary box is the union of the boxes of the rows of the block range,
+   * exactly as a GiST internal key is the union of the keys below it */
+  PG_RETURN_BOOL(stbox_gist_consistent(summary, &query, key->sk_strategy));
+}
+
+PGDLLEXPORT Datum Stbox_brin_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_union);
+/**
+ * @brief BRIN union function for temporal points
+ *
+ * Expand the first summary box with the second one.
+ */
+Datum
+Stbox_brin_union(PG_FUNCTION_ARGS)
+{
+  BrinValues *col_a = (BrinValues *) PG_GETARG_POINTER(1);
+  BrinValues *col_b = (BrinValues *) PG_GETARG_POINTER(2);
+  STBox *box_b = DatumGetSTboxP(col_b->bv_values[0]);
+  if (col_a->bv_allnulls)
+  {
+    col_a->bv_values[0] = PointerGetDatum(stbox_copy(box_b));
+    col_a->bv_allnulls = false;
+    PG_RETURN_BOOL(true);
+  }
+  stbox_expand(box_b, DatumGetSTboxP(col_a->bv_values[0]));
+  PG_RETURN_BOOL(true);
+}
+
+/*****************************************************************************/
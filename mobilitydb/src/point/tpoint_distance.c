@@ -39,6 +39,8 @@
 #include <float.h>
 #include <math.h>
 /* PostgreSQL */
+#include <funcapi.h>
+#include <access/htup_details.h>
 #include <utils/timestamp.h>
 #include <utils/float.h>
 /* PostGIS */
@@ -56,6 +58,7 @@
 #include "point/tpoint.h"
 #include "point/tpoint_spatialfuncs.h"
 /* MobilityDB */
+#include "pg_general/type_util.h"
 #include "pg_point/postgis.h"
 #include "pg_point/tpoint_spatialfuncs.h"
 
@@ -122,8 +125,10 @@ PG_FUNCTION_INFO_V1(Distance_tpoint_tpoint);
 Datum
 Distance_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   /* Store fcinfo into a global variable */
   store_fcinfo(fcinfo);
   Temporal *result = distance_tpoint_tpoint(temp1, temp2);
@@ -194,8 +199,10 @@ PG_FUNCTION_INFO_V1(NAI_tpoint_tpoint);
 Datum
 NAI_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   /* Store fcinfo into a global variable */
   store_fcinfo(fcinfo);
   TInstant *result = nai_tpoint_tpoint(temp1, temp2);
@@ -381,8 +388,10 @@ PG_FUNCTION_INFO_V1(NAD_tpoint_tpoint);
 Datum
 NAD_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   /* Store fcinfo into a global variable */
   store_fcinfo(fcinfo);
   double result = nad_tpoint_tpoint(temp1, temp2);
@@ -393,6 +402,125 @@ NAD_tpoint_tpoint(PG_FUNCTION_ARGS)
   PG_RETURN_FLOAT8(result);
 }
 
+/** State of the set-returning function NAD_tpoint_arr */
+typedef struct NadTpointArrState
+{
+  int *first;      /**< First element of the candidate pairs (1-based) */
+  int *second;     /**< Second element of the candidate pairs (1-based) */
+  double *dist;    /**< Nearest approach distance of the candidate pairs */
+  int count;       /**< Number of candidate pairs */
+  int next;        /**< Position of the next pair to return */
+} NadTpointArrState;
+
+/**
+ * @brief Comparator sorting the positions of the array elements by the start
+ * timestamp of their bounding period, used for the plane sweep
+ */
+static int
+nad_tpoint_arr_cmp(const void *a, const void *b, void *arg)
+{
+  const STBox *boxes = (const STBox *) arg;
+  TimestampTz t1 = DatumGetTimestampTz(boxes[*(const int *) a].period.lower);
+  TimestampTz t2 = DatumGetTimestampTz(boxes[*(const int *) b].period.lower);
+  if (t1 < t2)
+    return -1;
+  if (t1 > t2)
+    return 1;
+  return 0;
+}
+
+PGDLLEXPORT Datum NAD_tpoint_arr(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(NAD_tpoint_arr);
+/**
+ * @ingroup mobilitydb_temporal_dist
+ * @brief Return the nearest approach distance between every pair of
+ * temporal points of an array that overlap on the time dimension
+ *
+ * Each element of the array is detoasted only once and the pairs are
+ * prefiltered with a plane sweep on the bounding periods, so conflict
+ * detection over n trips avoids both the per-pair detoasting of a self-join
+ * and the quadratic number of synchronizations. Pairs without temporal
+ * overlap produce no row; the positions returned are 1-based as in the
+ * input array.
+ * @sqlfunc nearestApproachDistance()
+ */
+Datum
+NAD_tpoint_arr(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  NadTpointArrState *state;
+  if (SRF_IS_FIRSTCALL())
+  {
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+    /* Store fcinfo into a global variable */
+    store_fcinfo(fcinfo);
+    int count;
+    Temporal **temparr = temporalarr_extract(array, &count);
+    /* Compute the bounding boxes and sort the positions by start timestamp */
+    STBox *boxes = palloc(sizeof(STBox) * count);
+    int *order = palloc(sizeof(int) * count);
+    for (int i = 0; i < count; i++)
+    {
+      temporal_set_bbox(temparr[i], &boxes[i]);
+      order[i] = i;
+    }
+    qsort_arg(order, count, sizeof(int), &nad_tpoint_arr_cmp, boxes);
+    state = palloc0(sizeof(NadTpointArrState));
+    int maxpairs = Max(count, 16);
+    state->first = palloc(sizeof(int) * maxpairs);
+    state->second = palloc(sizeof(int) * maxpairs);
+    state->dist = palloc(sizeof(double) * maxpairs);
+    /* Sweep: a pair can overlap on time only while the start timestamp of
+     * the second element does not exceed the end timestamp of the first */
+    for (int i = 0; i < count; i++)
+    {
+      TimestampTz upper1 =
+        DatumGetTimestampTz(boxes[order[i]].period.upper);
+      for (int j = i + 1; j < count; j++)
+      {
+        if (DatumGetTimestampTz(boxes[order[j]].period.lower) > upper1)
+          break;
+        double d = nad_tpoint_tpoint(temparr[order[i]], temparr[order[j]]);
+        /* A negative distance means that the pair has no temporal overlap */
+        if (d < 0)
+          continue;
+        if (state->count == maxpairs)
+        {
+          maxpairs *= 2;
+          state->first = repalloc(state->first, sizeof(int) * maxpairs);
+          state->second = repalloc(state->second, sizeof(int) * maxpairs);
+          state->dist = repalloc(state->dist, sizeof(double) * maxpairs);
+        }
+        state->first[state->count] = Min(order[i], order[j]) + 1;
+        state->second[state->count] = Max(order[i], order[j]) + 1;
+        state->dist[state->count++] = d;
+      }
+    }
+    pfree(temparr); pfree(boxes); pfree(order);
+    funcctx->user_fctx = state;
+    /* Build the tuple description for the result rows */
+    TupleDesc tupdesc;
+    get_call_result_type(fcinfo, NULL, &tupdesc);
+    funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+  funcctx = SRF_PERCALL_SETUP();
+  state = (NadTpointArrState *) funcctx->user_fctx;
+  if (state->next >= state->count)
+    SRF_RETURN_DONE(funcctx);
+  Datum values[3];
+  bool isnull[3] = { false, false, false };
+  values[0] = Int32GetDatum(state->first[state->next]);
+  values[1] = Int32GetDatum(state->second[state->next]);
+  values[2] = Float8GetDatum(state->dist[state->next]);
+  state->next++;
+  HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+  SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+}
+
 /*****************************************************************************
  * ShortestLine
  *****************************************************************************/
@@ -452,8 +580,10 @@ PG_FUNCTION_INFO_V1(Shortestline_tpoint_tpoint);
 Datum
 Shortestline_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   /* Store fcinfo into a global variable */
   store_fcinfo(fcinfo);
   GSERIALIZED *result;
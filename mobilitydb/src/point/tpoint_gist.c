@@ -39,9 +39,14 @@
 #include <float.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <funcapi.h>
 #include <access/gist.h>
 #include <utils/float.h>
+#include <utils/guc.h>
 #include <utils/timestamp.h>
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  #include <utils/sortsupport.h>
+#endif
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -53,6 +58,39 @@
 #include "pg_general/time_gist.h"
 #include "pg_general/tnumber_gist.h"
 
+/*****************************************************************************
+ * GiST maintenance statistics
+ *****************************************************************************/
+
+/**
+ * @brief Maintenance statistics of the stbox-keyed GiST support functions
+ *
+ * The counters accumulate over the inserts, penalty evaluations, and page
+ * splits performed by the current backend and quantify the degradation of
+ * the index without dumping its pages: growing average penalties and split
+ * overlap ratios indicate increasingly overlapping subtrees, which is the
+ * measured signal on which a REINDEX can be scheduled. The counters are
+ * per backend, so they must be read on the connection that performed the
+ * maintenance work, typically a dedicated loader session.
+ */
+typedef struct
+{
+  int64 inserts;            /**< Leaf entries compressed, i.e., inserts */
+  int64 penalty_calls;      /**< Penalty evaluations */
+  double penalty_sum;       /**< Sum of the penalty values */
+  double penalty_max;       /**< Largest penalty value */
+  int64 zero_penalties;     /**< Insertions that enlarged no key */
+  int64 splits;             /**< Page splits */
+  double split_overlap_sum; /**< Sum of the overlap ratios of the splits */
+  double split_overlap_max; /**< Largest overlap ratio of a split */
+} TPointGistStats;
+
+static TPointGistStats _tpoint_gist_stats = { 0 };
+
+/* Forward reference, defined below with the penalty machinery */
+static double stbox_size_spatial(const STBox *box);
+static double stbox_size_time(const STBox *box);
+
 /*****************************************************************************
  * GiST consistent methods
  *****************************************************************************/
@@ -162,7 +200,7 @@ stbox_index_consistent_leaf(const STBox *key, const STBox *query,
  * @param[in] query Value being looked up in the index
  * @param[in] strategy Operator of the operator class being applied
  */
-static bool
+bool
 stbox_gist_consistent(const STBox *key, const STBox *query,
   StrategyNumber strategy)
 {
@@ -268,9 +306,25 @@ tpoint_index_recheck(StrategyNumber strategy)
   }
 }
 
+/** Cache for the transformed query of the consistent and distance methods */
+typedef struct TPointGistQueryCache
+{
+  Oid valueid;     /**< TOAST value identifier of the query datum */
+  Oid toastrelid;  /**< TOAST table containing the query datum */
+  STBox box;       /**< Bounding box of the query */
+} TPointGistQueryCache;
+
 /**
  * @brief Transform the query argument into a box initializing the dimensions
  * that must not be taken into account by the operators to infinity.
+ *
+ * The consistent and distance methods are called for every index entry
+ * visited by a scan. For toasted temporal queries the box sliced from the
+ * header is cached in fn_extra keyed on the TOAST value identity, which
+ * uniquely names the stored value: a rescan of a parameterized scan may
+ * present a different query at the same address, so the cache cannot be
+ * keyed on the datum pointer. In-memory queries read the box straight from
+ * their header, which costs no I/O.
  */
 static bool
 tpoint_gist_get_stbox(FunctionCallInfo fcinfo, STBox *result, meosType type)
@@ -292,7 +346,30 @@ tpoint_gist_get_stbox(FunctionCallInfo fcinfo, STBox *result, meosType type)
     if (PG_ARGISNULL(1))
       return false;
     Datum tempdatum = PG_GETARG_DATUM(1);
-    temporal_bbox_slice(tempdatum, result);
+    struct varlena *attr = (struct varlena *) DatumGetPointer(tempdatum);
+    if (VARATT_IS_EXTERNAL_ONDISK(attr))
+    {
+      struct varatt_external toast_pointer;
+      VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+      TPointGistQueryCache *cache = fcinfo->flinfo->fn_extra;
+      if (cache == NULL)
+      {
+        cache = MemoryContextAllocZero(fcinfo->flinfo->fn_mcxt,
+          sizeof(TPointGistQueryCache));
+        fcinfo->flinfo->fn_extra = cache;
+      }
+      if (cache->valueid != toast_pointer.va_valueid ||
+          cache->toastrelid != toast_pointer.va_toastrelid)
+      {
+        /* First call of the scan or rescan with a different query */
+        temporal_bbox_slice(tempdatum, &cache->box);
+        cache->valueid = toast_pointer.va_valueid;
+        cache->toastrelid = toast_pointer.va_toastrelid;
+      }
+      memcpy(result, &cache->box, sizeof(STBox));
+    }
+    else
+      temporal_bbox_slice(tempdatum, result);
   }
   else
     elog(ERROR, "Unsupported type for indexing: %d", type);
@@ -394,6 +471,7 @@ Tpoint_gist_compress(PG_FUNCTION_ARGS)
     GISTENTRY *retval = palloc(sizeof(GISTENTRY));
     STBox *box = palloc(sizeof(STBox));
     temporal_bbox_slice(entry->key, box);
+    _tpoint_gist_stats.inserts++;
     gistentryinit(*retval, PointerGetDatum(box), entry->rel, entry->page,
       entry->offset, false);
     PG_RETURN_POINTER(retval);
@@ -401,6 +479,85 @@ Tpoint_gist_compress(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(entry);
 }
 
+/*****************************************************************************
+ * Geocentric GiST methods for temporal geography points
+ *
+ * The alternative tgeogpoint operator class defined on these methods stores
+ * bounding boxes in geocentric (unit-sphere XYZ) coordinates, which stay
+ * tight when a point crosses the ±180° meridian or approaches a pole, while
+ * the raw longitude/latitude boxes of the default operator class blow up to
+ * cover (almost) the whole planet. Since a geocentric box supports the same
+ * min/max arithmetic as a regular one, the union, penalty, picksplit, and
+ * same support functions are shared with the default operator class; only
+ * the compress and consistent methods differ.
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tgeogpoint_gist_geocentric_compress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tgeogpoint_gist_geocentric_compress);
+/**
+ * @brief GiST geocentric compress method for temporal geography points
+ * @note Contrary to the default compress method, the box cannot be sliced
+ * from the header of the datum since the precomputed box keeps raw
+ * longitude/latitude coordinates: the full value must be detoasted
+ */
+Datum
+Tgeogpoint_gist_geocentric_compress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  if (entry->leafkey)
+  {
+    GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+    STBox *box = palloc(sizeof(STBox));
+    Temporal *temp = (Temporal *) PG_DETOAST_DATUM(entry->key);
+    tpoint_set_geocentric_stbox(temp, box);
+    _tpoint_gist_stats.inserts++;
+    if ((Pointer) temp != DatumGetPointer(entry->key))
+      pfree(temp);
+    gistentryinit(*retval, PointerGetDatum(box), entry->rel, entry->page,
+      entry->offset, false);
+    PG_RETURN_POINTER(retval);
+  }
+  PG_RETURN_POINTER(entry);
+}
+
+PGDLLEXPORT Datum Stbox_gist_geocentric_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_gist_geocentric_consistent);
+/**
+ * @brief GiST geocentric consistent method for temporal geography points
+ *
+ * The query box is transformed into the geocentric coordinates of the index
+ * keys; the comparison logic itself is coordinate agnostic and thus shared
+ * with the default operator class.
+ */
+Datum
+Stbox_gist_geocentric_consistent(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+  Oid typid = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4), result;
+  STBox *key = DatumGetSTboxP(entry->key), query, geoquery;
+
+  /* The geocentric keys are lossy for all strategies: the altitude is
+   * collapsed and the boxes of linear segments cover great-circle arcs */
+  *recheck = true;
+
+  if (key == NULL)
+    PG_RETURN_BOOL(false);
+
+  /* Transform the query into a geocentric box */
+  if (! tpoint_gist_get_stbox(fcinfo, &query, oid_type(typid)))
+    PG_RETURN_BOOL(false);
+  stbox_set_geocentric(&query, &geoquery);
+
+  if (GIST_LEAF(entry))
+    result = stbox_index_consistent_leaf(key, &geoquery, strategy);
+  else
+    result = stbox_gist_consistent(key, &geoquery, strategy);
+
+  PG_RETURN_BOOL(result);
+}
+
 /*****************************************************************************
  * GiST penalty method
  *****************************************************************************/
@@ -414,6 +571,7 @@ static void
 stbox_union_rt(const STBox *a, const STBox *b, STBox *new)
 {
   memset(new, 0, sizeof(STBox));
+  new->flags = a->flags;
   new->xmin = FLOAT8_MIN(a->xmin, b->xmin);
   new->xmax = FLOAT8_MAX(a->xmax, b->xmax);
   new->ymin = FLOAT8_MIN(a->ymin, b->ymin);
@@ -430,16 +588,73 @@ stbox_union_rt(const STBox *a, const STBox *b, STBox *new)
 }
 
 /**
- * @brief Return the size of a spatiotemporal box for penalty-calculation
- * purposes. The result can be +Infinity, but not NaN.
+ * @brief Weights balancing the spatial against the temporal enlargement in
+ * the penalty of the GiST index for temporal points, configurable with the
+ * mobilitydb.gist_spatial_weight and mobilitydb.gist_temporal_weight
+ * parameters
+ */
+static double _gist_spatial_weight = 1.0;
+static double _gist_temporal_weight = 1.0;
+
+/**
+ * @brief Register the configuration parameters of the GiST penalty for
+ * temporal points, called from the initialization of the extension
+ */
+void
+tpoint_gist_guc_init(void)
+{
+  DefineCustomRealVariable("mobilitydb.gist_spatial_weight",
+    "Weight of the spatial enlargement in the GiST penalty for temporal points",
+    NULL, &_gist_spatial_weight, 1.0, 0.0, DBL_MAX, PGC_USERSET, 0,
+    NULL, NULL, NULL);
+  DefineCustomRealVariable("mobilitydb.gist_temporal_weight",
+    "Weight of the temporal enlargement in the GiST penalty for temporal points",
+    NULL, &_gist_temporal_weight, 1.0, 0.0, DBL_MAX, PGC_USERSET, 0,
+    NULL, NULL, NULL);
+}
+
+/**
+ * @brief Return the overlap ratio of the two halves of a page split
+ *
+ * The ratio averages, over the dimensions present, the fraction of the
+ * union of the two group keys that both groups cover: 0 for disjoint
+ * halves, 1 when one half covers the other completely.
  */
 static double
-stbox_size(const STBox *box)
+stbox_split_overlap(const STBox *left, const STBox *right)
 {
-  double result_size = 1;
-  bool  hasx = MEOS_FLAGS_GET_X(box->flags),
-        hasz = MEOS_FLAGS_GET_Z(box->flags),
-        hast = MEOS_FLAGS_GET_T(box->flags);
+  STBox inter, unionbox;
+  if (! inter_stbox_stbox(left, right, &inter))
+    return 0.0;
+  stbox_union_rt(left, right, &unionbox);
+  double result = 0.0;
+  int dims = 0;
+  if (MEOS_FLAGS_GET_X(left->flags))
+  {
+    double size_union = stbox_size_spatial(&unionbox);
+    if (size_union > 0.0 && ! isinf(size_union))
+      result += stbox_size_spatial(&inter) / size_union;
+    dims++;
+  }
+  if (MEOS_FLAGS_GET_T(left->flags))
+  {
+    double dur_union = stbox_size_time(&unionbox);
+    if (dur_union > 0.0)
+      result += stbox_size_time(&inter) / dur_union;
+    dims++;
+  }
+  return dims ? result / dims : 0.0;
+}
+
+/**
+ * @brief Return the spatial size (area, or volume for 3D boxes) of a
+ * spatiotemporal box for penalty-calculation purposes. The result can be
+ * +Infinity, but not NaN.
+ */
+static double
+stbox_size_spatial(const STBox *box)
+{
+  bool hasz = MEOS_FLAGS_GET_Z(box->flags);
   /*
    * Check for zero-width cases.  Note that we define the size of a zero-
    * by-infinity box as zero.  It's important to special-case this somehow,
@@ -447,10 +662,8 @@ stbox_size(const STBox *box)
    *
    * The less-than cases should not happen, but if they do, say "zero".
    */
-  if ((hasx && (FLOAT8_LE(box->xmax, box->xmin)
-                || FLOAT8_LE(box->ymax, box->ymin)
-                || (hasz && FLOAT8_LE(box->zmax, box->zmin))))
-      || (hast && datum_le(box->period.upper, box->period.lower, T_TIMESTAMPTZ)))
+  if (FLOAT8_LE(box->xmax, box->xmin) || FLOAT8_LE(box->ymax, box->ymin) ||
+      (hasz && FLOAT8_LE(box->zmax, box->zmin)))
     return 0.0;
 
   /*
@@ -458,28 +671,58 @@ stbox_size(const STBox *box)
    * and a non-NaN is infinite.  Note the previous check eliminated the
    * possibility that the low fields are NaNs.
    */
-  if (hasx && (isnan(box->xmax) || isnan(box->ymax) || (hasz && isnan(box->zmax))))
+  if (isnan(box->xmax) || isnan(box->ymax) || (hasz && isnan(box->zmax)))
     return get_float8_infinity();
 
-  /*
-   * Compute the box size
-   */
-  if (hasx)
-  {
-    result_size *= (box->xmax - box->xmin) * (box->ymax - box->ymin);
-    if (hasz)
-      result_size *= (box->xmax - box->xmin) * (box->ymax - box->ymin);
-  }
-  if (hast)
-    /* Expressed in seconds */
-    result_size *= (DatumGetTimestampTz(box->period.upper) -
-      DatumGetTimestampTz(box->period.lower)) / USECS_PER_SEC;
-  return result_size;
+  double result = (box->xmax - box->xmin) * (box->ymax - box->ymin);
+  if (hasz)
+    result *= (box->zmax - box->zmin);
+  return result;
+}
+
+/**
+ * @brief Return the sum of the spatial extents of a spatiotemporal box,
+ * used to discriminate between degenerate (zero-area) boxes
+ */
+static double
+stbox_edge_spatial(const STBox *box)
+{
+  double result = (box->xmax - box->xmin) + (box->ymax - box->ymin);
+  if (MEOS_FLAGS_GET_Z(box->flags))
+    result += (box->zmax - box->zmin);
+  return isnan(result) ? get_float8_infinity() : result;
+}
+
+/**
+ * @brief Return the duration of a spatiotemporal box in seconds for
+ * penalty-calculation purposes
+ */
+static double
+stbox_size_time(const STBox *box)
+{
+  if (datum_le(box->period.upper, box->period.lower, T_TIMESTAMPTZ))
+    return 0.0;
+  return (double) (DatumGetTimestampTz(box->period.upper) -
+    DatumGetTimestampTz(box->period.lower)) / USECS_PER_SEC;
 }
 
 /**
  * @brief Return the amount by which the union of the two boxes is larger than
- * the original STBox's volume.  The result can be +Infinity, but not NaN.
+ * the original box.  The result can be +Infinity, but not NaN.
+ *
+ * The spatial and the temporal enlargements are assessed separately and
+ * combined as a weighted sum of relative enlargements.  The classical
+ * volume-times-duration metric degenerates for the long thin boxes that
+ * trips typically produce: a zero extent in any single dimension zeroes the
+ * whole product and the penalty can no longer discriminate between subtrees,
+ * which results in pathological overlap.  Relative enlargements are
+ * scale-free, so the spatial and the temporal contributions can be combined
+ * although they are expressed in incommensurable units; when the spatial
+ * area of the union is zero the sum of the spatial extents is used instead.
+ * The weights can be adapted to a workload with the
+ * mobilitydb.gist_spatial_weight and mobilitydb.gist_temporal_weight
+ * parameters; the picksplit method inherits the weights when distributing
+ * the common entries by minimizing the penalty.
  */
 double
 stbox_penalty(void *bbox1, void *bbox2)
@@ -488,7 +731,35 @@ stbox_penalty(void *bbox1, void *bbox2)
   const STBox *new = (STBox *) bbox2;
   STBox unionbox;
   stbox_union_rt(original, new, &unionbox);
-  return stbox_size(&unionbox) - stbox_size(original);
+  double result = 0.0;
+  if (MEOS_FLAGS_GET_X(original->flags))
+  {
+    double size_union = stbox_size_spatial(&unionbox);
+    if (isinf(size_union))
+    {
+      if (! isinf(stbox_size_spatial(original)))
+        return get_float8_infinity();
+    }
+    else if (size_union > 0.0)
+      result += _gist_spatial_weight *
+        (size_union - stbox_size_spatial(original)) / size_union;
+    else
+    {
+      /* Degenerate (zero-area) boxes: discriminate on the extents */
+      double edge_union = stbox_edge_spatial(&unionbox);
+      if (edge_union > 0.0)
+        result += _gist_spatial_weight *
+          (edge_union - stbox_edge_spatial(original)) / edge_union;
+    }
+  }
+  if (MEOS_FLAGS_GET_T(original->flags))
+  {
+    double dur_union = stbox_size_time(&unionbox);
+    if (dur_union > 0.0)
+      result += _gist_temporal_weight *
+        (dur_union - stbox_size_time(original)) / dur_union;
+  }
+  return result;
 }
 
 PGDLLEXPORT Datum Stbox_gist_penalty(PG_FUNCTION_ARGS);
@@ -506,6 +777,12 @@ Stbox_gist_penalty(PG_FUNCTION_ARGS)
   void *origstbox = (STBox *) DatumGetPointer(origentry->key);
   void *newbox = (STBox *) DatumGetPointer(newentry->key);
   *result = (float) stbox_penalty(origstbox, newbox);
+  _tpoint_gist_stats.penalty_calls++;
+  _tpoint_gist_stats.penalty_sum += *result;
+  if (*result > _tpoint_gist_stats.penalty_max)
+    _tpoint_gist_stats.penalty_max = *result;
+  if (*result == 0.0)
+    _tpoint_gist_stats.zero_penalties++;
   PG_RETURN_POINTER(result);
 }
 
@@ -542,7 +819,17 @@ PG_FUNCTION_INFO_V1(Stbox_gist_picksplit);
 Datum
 Stbox_gist_picksplit(PG_FUNCTION_ARGS)
 {
-  return bbox_gist_picksplit_ext(fcinfo, T_STBOX, &stbox_adjust, &stbox_penalty);
+  Datum result = bbox_gist_picksplit_ext(fcinfo, T_STBOX, &stbox_adjust,
+    &stbox_penalty);
+  /* Account for the split and the overlap of the two resulting group keys */
+  GIST_SPLITVEC *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
+  double overlap = stbox_split_overlap(DatumGetSTboxP(v->spl_ldatum),
+    DatumGetSTboxP(v->spl_rdatum));
+  _tpoint_gist_stats.splits++;
+  _tpoint_gist_stats.split_overlap_sum += overlap;
+  if (overlap > _tpoint_gist_stats.split_overlap_max)
+    _tpoint_gist_stats.split_overlap_max = overlap;
+  return result;
 }
 /*****************************************************************************
  * GiST same method
@@ -584,6 +871,16 @@ PG_FUNCTION_INFO_V1(Stbox_gist_distance);
 /**
  * @brief GiST support function. Take in a query and an entry and return the
  * "distance" between them.
+ *
+ * The executor performs distance browsing with this function: visited
+ * entries are kept in a pairing heap ordered by the returned value and a
+ * subtree is only descended when its page becomes the minimum of the heap,
+ * so an ORDER BY ... LIMIT k scan stops after the k nearest leaves have
+ * been rechecked. For that pruning to be effective this function must
+ * return a cheap lower bound of the exact distance: the box-level nearest
+ * approach distance for internal pages, and the same bound with recheck
+ * set for leaves so that the executor reorders them by the exact distance
+ * of the |=| operator.
 */
 Datum
 Stbox_gist_distance(PG_FUNCTION_ARGS)
@@ -613,4 +910,255 @@ Stbox_gist_distance(PG_FUNCTION_ARGS)
   PG_RETURN_FLOAT8(distance);
 }
 
+/*****************************************************************************
+ * GiST fetch method
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Stbox_gist_fetch(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_gist_fetch);
+/**
+ * @brief GiST fetch method for spatiotemporal boxes.
+ *
+ * The opclass for spatiotemporal boxes has no compress method: the leaf key
+ * is the indexed box itself and can be returned as is. Declaring the method
+ * enables index-only scans on stbox columns and on expression indexes such
+ * as stbox(trip), so that queries needing only the bounding boxes, e.g.,
+ * counting matches or coarse coverage statistics, skip the heap entirely.
+ */
+Datum
+Stbox_gist_fetch(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  PG_RETURN_POINTER(entry);
+}
+
+/*****************************************************************************
+ * GiST sortsupport method
+ *****************************************************************************/
+
+/**
+ * @brief Map a double onto an unsigned integer that sorts in the same order
+ * as the double.
+ *
+ * The bit pattern of an IEEE 754 double sorts correctly for positive values;
+ * for negative values the order is reversed. Flipping the sign bit of
+ * positive values and all bits of negative values yields a total order on
+ * the unsigned representation. Only the 32 most significant bits are kept
+ * since they suffice for interleaving.
+ */
+static uint32
+stbox_zorder_component(double d)
+{
+  uint64 u;
+  memcpy(&u, &d, sizeof(uint64));
+  if (u & ((uint64) 1 << 63))
+    u = ~u;
+  else
+    u |= ((uint64) 1 << 63);
+  return (uint32) (u >> 32);
+}
+
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+
+/**
+ * @brief Spread the 32 bits of the argument over the even bits of the result
+ */
+static uint64
+stbox_zorder_spread(uint32 v)
+{
+  uint64 x = v;
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x << 2)) & 0x3333333333333333ULL;
+  x = (x | (x << 1)) & 0x5555555555555555ULL;
+  return x;
+}
+
+/**
+ * @brief Compute the Z-order (Morton) code of the centroid of a
+ * spatiotemporal box.
+ *
+ * The X and Y coordinates of the centroid are interleaved bit by bit so that
+ * boxes close in space get close Z-order codes. The Z and time dimensions
+ * are ignored: the code is only used to cluster the input of a sorted index
+ * build and an imperfect clustering merely yields a slightly less efficient
+ * index, as for the PostGIS sortsupport for geometries.
+ */
+static uint64
+stbox_zorder(const STBox *box)
+{
+  uint32 x, y;
+
+  if (! MEOS_FLAGS_GET_X(box->flags))
+    return 0;
+  x = stbox_zorder_component((box->xmin + box->xmax) / 2.0);
+  y = stbox_zorder_component((box->ymin + box->ymax) / 2.0);
+  return stbox_zorder_spread(x) | (stbox_zorder_spread(y) << 1);
+}
+
+/**
+ * @brief Comparator for sorted GiST index builds on spatiotemporal boxes
+ */
+static int
+stbox_zorder_cmp(Datum a, Datum b, SortSupport ssup __attribute__((unused)))
+{
+  uint64 z1 = stbox_zorder(DatumGetSTboxP(a));
+  uint64 z2 = stbox_zorder(DatumGetSTboxP(b));
+  if (z1 < z2)
+    return -1;
+  if (z1 > z2)
+    return 1;
+  return 0;
+}
+
+PGDLLEXPORT Datum Stbox_gist_sortsupport(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_gist_sortsupport);
+/**
+ * @brief GiST sortsupport method for temporal points.
+ *
+ * Enables sorted (bulk) index builds on PostgreSQL 14 and higher by ordering
+ * the index entries along a Z-order curve over the centroids of their
+ * spatiotemporal boxes.
+ */
+Datum
+Stbox_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+  ssup->comparator = stbox_zorder_cmp;
+  ssup->ssup_extra = NULL;
+  PG_RETURN_VOID();
+}
+
+#endif /* POSTGRESQL_VERSION_NUMBER >= 140000 */
+
+/*****************************************************************************
+ * GiST maintenance statistics functions
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tpoint_gist_stats(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_gist_stats);
+/**
+ * @ingroup mobilitydb_temporal_accessor
+ * @brief Maintenance statistics of the stbox-keyed GiST indexes collected by
+ * the current backend
+ * @sqlfunc tpoint_gist_stats()
+ */
+Datum
+Tpoint_gist_stats(PG_FUNCTION_ARGS)
+{
+  TupleDesc tupdesc;
+  if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    elog(ERROR, "return type must be a row type");
+  TPointGistStats *stats = &_tpoint_gist_stats;
+  Datum values[8];
+  bool nulls[8] = { false };
+  values[0] = Int64GetDatum(stats->inserts);
+  values[1] = Int64GetDatum(stats->penalty_calls);
+  values[2] = Float8GetDatum(stats->penalty_calls ?
+    stats->penalty_sum / (double) stats->penalty_calls : 0.0);
+  values[3] = Float8GetDatum(stats->penalty_max);
+  values[4] = Int64GetDatum(stats->zero_penalties);
+  values[5] = Int64GetDatum(stats->splits);
+  values[6] = Float8GetDatum(stats->splits ?
+    stats->split_overlap_sum / (double) stats->splits : 0.0);
+  values[7] = Float8GetDatum(stats->split_overlap_max);
+  HeapTuple tuple = heap_form_tuple(tupdesc, values, nulls);
+  PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+PGDLLEXPORT Datum Tpoint_gist_stats_reset(PG_FUNCTION_ARGS __attribute__((unused)));
+PG_FUNCTION_INFO_V1(Tpoint_gist_stats_reset);
+/**
+ * @ingroup mobilitydb_temporal_accessor
+ * @brief Reset the maintenance statistics of the stbox-keyed GiST indexes
+ * @sqlfunc tpoint_gist_stats_reset()
+ */
+Datum
+Tpoint_gist_stats_reset(PG_FUNCTION_ARGS __attribute__((unused)))
+{
+  memset(&_tpoint_gist_stats, 0, sizeof(TPointGistStats));
+  PG_RETURN_VOID();
+}
+
+/*****************************************************************************
+ * Space-time code for physical clustering
+ *****************************************************************************/
+
+/**
+ * @brief Spread the 21 least significant bits of the argument over every
+ * third bit of the result
+ */
+static uint64
+stbox_spacetime_spread(uint32 v)
+{
+  uint64 x = v & 0x1FFFFFULL;
+  x = (x | (x << 32)) & 0x001F00000000FFFFULL;
+  x = (x | (x << 16)) & 0x001F0000FF0000FFULL;
+  x = (x | (x << 8)) & 0x100F00F00F00F00FULL;
+  x = (x | (x << 4)) & 0x10C30C30C30C30C3ULL;
+  x = (x | (x << 2)) & 0x1249249249249249ULL;
+  return x;
+}
+
+/**
+ * @brief Compute the space-time code of a spatiotemporal box.
+ *
+ * The code interleaves bit by bit the X and Y coordinates of the spatial
+ * centroid and the middle instant of the period, 21 bits each, yielding a
+ * 63-bit Morton code where values close in space and time get close codes.
+ * Missing dimensions contribute zero bits.
+ */
+static int64
+stbox_spacetime_code(const STBox *box)
+{
+  uint32 x = 0, y = 0, t = 0;
+  if (MEOS_FLAGS_GET_X(box->flags))
+  {
+    x = stbox_zorder_component((box->xmin + box->xmax) / 2.0) >> 11;
+    y = stbox_zorder_component((box->ymin + box->ymax) / 2.0) >> 11;
+  }
+  if (MEOS_FLAGS_GET_T(box->flags))
+  {
+    TimestampTz lower = DatumGetTimestampTz(box->period.lower);
+    TimestampTz upper = DatumGetTimestampTz(box->period.upper);
+    /* Flip the sign bit so that the int64 sorts as unsigned */
+    uint64 mid = (uint64) (lower / 2 + upper / 2) ^ ((uint64) 1 << 63);
+    t = (uint32) (mid >> 43);
+  }
+  return (int64) (stbox_spacetime_spread(x) |
+    (stbox_spacetime_spread(y) << 1) | (stbox_spacetime_spread(t) << 2));
+}
+
+PGDLLEXPORT Datum Stbox_space_time_code(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_space_time_code);
+/**
+ * @brief Return the space-time code of a spatiotemporal box
+ */
+Datum
+Stbox_space_time_code(PG_FUNCTION_ARGS)
+{
+  STBox *box = PG_GETARG_STBOX_P(0);
+  PG_RETURN_INT64(stbox_spacetime_code(box));
+}
+
+PGDLLEXPORT Datum Tpoint_space_time_code(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_space_time_code);
+/**
+ * @brief Return the space-time code of a temporal point.
+ *
+ * The code is a bigint that orders temporal points along a space-filling
+ * curve over their spatiotemporal boxes so that a B-tree index on the code
+ * physically co-locates spatiotemporally close values with CLUSTER and
+ * ORDER BY. Only the header of the value is read from TOAST.
+ */
+Datum
+Tpoint_space_time_code(PG_FUNCTION_ARGS)
+{
+  Datum tempdatum = PG_GETARG_DATUM(0);
+  STBox box;
+  temporal_bbox_slice(tempdatum, &box);
+  PG_RETURN_INT64(stbox_spacetime_code(&box));
+}
+
 /*****************************************************************************/
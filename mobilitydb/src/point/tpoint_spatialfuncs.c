@@ -597,6 +597,38 @@ Tpoint_AsMVTGeom(PG_FUNCTION_ARGS)
   PG_RETURN_DATUM(result);
 }
 
+PGDLLEXPORT Datum Tpoint_as_mvt(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_as_mvt);
+/**
+ * @ingroup mobilitydb_temporal_spatial_transf
+ * @brief Encode a temporal point as a complete Mapbox Vector Tile
+ */
+Datum
+Tpoint_as_mvt(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  STBox *bounds = PG_GETARG_STBOX_P(1);
+  int32_t extent = PG_GETARG_INT32(2);
+  int32_t buffer = PG_GETARG_INT32(3);
+  bool clip_geom = PG_GETARG_BOOL(4);
+  text *name = PG_GETARG_TEXT_P(5);
+
+  char *namestr = text2cstring(name);
+  size_t size;
+  uint8_t *bytes = tpoint_as_mvt(temp, bounds, extent, buffer, clip_geom,
+    namestr, &size);
+  pfree(namestr);
+  PG_FREE_IF_COPY(temp, 0);
+  if (! bytes)
+    PG_RETURN_NULL();
+
+  bytea *result = palloc(size + VARHDRSZ);
+  SET_VARSIZE(result, size + VARHDRSZ);
+  memcpy(VARDATA(result), bytes, size);
+  pfree(bytes);
+  PG_RETURN_BYTEA_P(result);
+}
+
 /*****************************************************************************
  * Functions for extracting coordinates
  *****************************************************************************/
@@ -775,6 +807,42 @@ Tpoint_twcentroid(PG_FUNCTION_ARGS)
   PG_RETURN_DATUM(result);
 }
 
+PGDLLEXPORT Datum Tpoint_twcentroid_approx(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_twcentroid_approx);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return an approximation of the time-weighed centroid of a temporal
+ * geometry point computed on a sample of its sequences, together with a 95%
+ * error bound
+ * @sqlfunc twCentroidApprox()
+ */
+Datum
+Tpoint_twcentroid_approx(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  double fraction = PG_GETARG_FLOAT8(1);
+  double error;
+  GSERIALIZED *point = tpoint_twcentroid_approx(temp, fraction, &error);
+  PG_FREE_IF_COPY(temp, 0);
+  if (! point)
+    PG_RETURN_NULL();
+
+  /* Build a tuple description for the function output */
+  TupleDesc resultTupleDesc;
+  get_call_result_type(fcinfo, NULL, &resultTupleDesc);
+  BlessTupleDesc(resultTupleDesc);
+
+  /* Construct the result */
+  bool result_is_null[2] = {0,0}; /* needed to say no value is null */
+  Datum result_values[2]; /* used to construct the composite return value */
+  result_values[0] = PointerGetDatum(point);
+  result_values[1] = Float8GetDatum(error);
+  /* Form tuple and return */
+  HeapTuple resultTuple = heap_form_tuple(resultTupleDesc, result_values,
+    result_is_null);
+  PG_RETURN_DATUM(HeapTupleGetDatum(resultTuple));
+}
+
 /*****************************************************************************
  * Temporal azimuth
  *****************************************************************************/
@@ -1086,4 +1154,69 @@ Tpoint_minus_stbox(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/** State of the set-returning function Tpoint_arr_at_stbox */
+typedef struct TpointArrAtStboxState
+{
+  Temporal **result;  /**< Non-empty restrictions of the values of the array */
+  int count;          /**< Number of elements in the result array */
+  int next;           /**< Position of the next result to return */
+} TpointArrAtStboxState;
+
+PGDLLEXPORT Datum Tpoint_arr_at_stbox(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_arr_at_stbox);
+/**
+ * @ingroup mobilitydb_temporal_restrict
+ * @brief Restrict an array of temporal points to a spatiotemporal box,
+ * returning the non-empty restrictions
+ *
+ * The array is deconstructed and the box fetched only once, and the values
+ * are prefiltered with a bounding box test, so clipping many trips against
+ * the same box avoids the per-call overhead of the unary atStbox. Values
+ * whose restriction is empty produce no row.
+ * @sqlfunc atStbox()
+ */
+Datum
+Tpoint_arr_at_stbox(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  TpointArrAtStboxState *state;
+  if (SRF_IS_FIRSTCALL())
+  {
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+    STBox *box = PG_GETARG_STBOX_P(1);
+    int count;
+    Temporal **temparr = temporalarr_extract(array, &count);
+    state = palloc0(sizeof(TpointArrAtStboxState));
+    state->result = palloc(sizeof(Temporal *) * count);
+    bool hasx = MEOS_FLAGS_GET_X(box->flags);
+    STBox box1;
+    for (int i = 0; i < count; i++)
+    {
+      /* Bounding box prefilter: non-overlapping values have an empty
+       * restriction */
+      if (hasx)
+      {
+        temporal_set_bbox(temparr[i], &box1);
+        if (! overlaps_stbox_stbox(&box1, box))
+          continue;
+      }
+      Temporal *rest = tpoint_restrict_stbox(temparr[i], box, BORDER_INC,
+        REST_AT);
+      if (rest)
+        state->result[state->count++] = rest;
+    }
+    pfree(temparr);
+    funcctx->user_fctx = state;
+    MemoryContextSwitchTo(oldcontext);
+  }
+  funcctx = SRF_PERCALL_SETUP();
+  state = (TpointArrAtStboxState *) funcctx->user_fctx;
+  if (state->next >= state->count)
+    SRF_RETURN_DONE(funcctx);
+  SRF_RETURN_NEXT(funcctx, PointerGetDatum(state->result[state->next++]));
+}
+
 /*****************************************************************************/
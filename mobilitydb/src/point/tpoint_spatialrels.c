@@ -57,6 +57,7 @@
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_tempspatialrels.h"
 /* MobilityDB */
+#include "pg_general/type_util.h"
 #include "pg_point/postgis.h"
 #include "pg_point/tpoint_spatialfuncs.h"
 
@@ -88,8 +89,10 @@ static Datum
 espatialrel_tpoint_tpoint_ext(FunctionCallInfo fcinfo,
   Datum (*func1)(Datum, Datum), Datum (*func2)(Datum, Datum))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   /* Store fcinfo into a global variable */
   store_fcinfo(fcinfo);
   int result = MEOS_FLAGS_GET_GEODETIC(temp1->flags) ?
@@ -367,8 +370,10 @@ PG_FUNCTION_INFO_V1(Edwithin_tpoint_tpoint);
 Datum
 Edwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   double dist = PG_GETARG_FLOAT8(2);
   /* Store fcinfo into a global variable */
   store_fcinfo(fcinfo);
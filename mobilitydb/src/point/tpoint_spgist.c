@@ -1032,14 +1032,69 @@ Stbox_quadtree_picksplit(PG_FUNCTION_ARGS)
    * Assign ranges to corresponding nodes according to quadrants relative to
    * the "centroid" range
    */
+  int *counts = palloc0(sizeof(int) * out->nNodes);
   for (i = 0; i < in->nTuples; i++)
   {
     box = DatumGetSTboxP(in->datums[i]);
     uint8 quadrant = getOctant8D(centroid, box);
     out->leafTupleDatums[i] = STboxPGetDatum(box);
     out->mapTuplesToNodes[i] = quadrant;
+    counts[quadrant]++;
   }
 
+  /*
+   * On skewed data (e.g., urban GPS traces clustered around a hot spot) the
+   * median centroid may still drop the bulk of the entries into a single
+   * quadrant, which degenerates index descent. In that case retry with a
+   * centroid built from the interquartile midpoints of the collected
+   * coordinate statistics and keep whichever assignment is more balanced.
+   */
+  int maxcount = 0;
+  for (i = 0; i < out->nNodes; i++)
+    if (counts[i] > maxcount)
+      maxcount = counts[i];
+  if (maxcount > in->nTuples / 2 && in->nTuples > 2)
+  {
+    int q1 = in->nTuples / 4, q3 = (in->nTuples * 3) / 4;
+    STBox *centroid2 = palloc0(sizeof(STBox));
+    memcpy(centroid2, centroid, sizeof(STBox));
+    centroid2->xmin = (lowXs[q1] + lowXs[q3]) / 2.0;
+    centroid2->xmax = (highXs[q1] + highXs[q3]) / 2.0;
+    centroid2->ymin = (lowYs[q1] + lowYs[q3]) / 2.0;
+    centroid2->ymax = (highYs[q1] + highYs[q3]) / 2.0;
+    if (hasz)
+    {
+      centroid2->zmin = (lowZs[q1] + lowZs[q3]) / 2.0;
+      centroid2->zmax = (highZs[q1] + highZs[q3]) / 2.0;
+    }
+    centroid2->period.lower = TimestampTzGetDatum(
+      lowTs[q1] + (lowTs[q3] - lowTs[q1]) / 2);
+    centroid2->period.upper = TimestampTzGetDatum(
+      highTs[q1] + (highTs[q3] - highTs[q1]) / 2);
+    int *map2 = palloc(sizeof(int) * in->nTuples);
+    int *counts2 = palloc0(sizeof(int) * out->nNodes);
+    for (i = 0; i < in->nTuples; i++)
+    {
+      box = DatumGetSTboxP(in->datums[i]);
+      map2[i] = getOctant8D(centroid2, box);
+      counts2[map2[i]]++;
+    }
+    int maxcount2 = 0;
+    for (i = 0; i < out->nNodes; i++)
+      if (counts2[i] > maxcount2)
+        maxcount2 = counts2[i];
+    if (maxcount2 < maxcount)
+    {
+      out->prefixDatum = STboxPGetDatum(centroid2);
+      memcpy(out->mapTuplesToNodes, map2, sizeof(int) * in->nTuples);
+      pfree(centroid);
+    }
+    else
+      pfree(centroid2);
+    pfree(map2); pfree(counts2);
+  }
+  pfree(counts);
+
   pfree(lowXs); pfree(highXs);
   pfree(lowYs); pfree(highYs);
   if (hasz)
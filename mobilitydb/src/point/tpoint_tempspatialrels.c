@@ -61,6 +61,7 @@
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_spatialrels.h"
 /* MobilityDB */
+#include "pg_general/type_util.h"
 #include "pg_point/postgis.h"
 #include "pg_point/tpoint_spatialfuncs.h"
 
@@ -382,8 +383,10 @@ Tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
   if (PG_ARGISNULL(0) || PG_ARGISNULL(1) || PG_ARGISNULL(2))
     PG_RETURN_NULL();
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  /* The result is null when the temporal values do not overlap on time */
+  Temporal *temp1, *temp2;
+  if (! temporal_getarg_if_overlaps(fcinfo, 0, 1, &temp1, &temp2))
+    PG_RETURN_NULL();
   double dist = PG_GETARG_FLOAT8(2);
   bool restr = false;
   bool atvalue = false;
@@ -387,7 +387,7 @@ Tpoint_space_time_split_ext(FunctionCallInfo fcinfo, bool timesplit)
       MemoryContext oldcontext =
         MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
       if (state->bm)
-         pfree(state->bm);
+         bitmatrix_free(state->bm);
       pfree(state);
       MemoryContextSwitchTo(oldcontext);
       SRF_RETURN_DONE(funcctx);
@@ -403,7 +403,7 @@ Tpoint_space_time_split_ext(FunctionCallInfo fcinfo, bool timesplit)
       /* Switch to memory context appropriate for multiple function calls */
       MemoryContext oldcontext =
         MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
-      if (state->bm) pfree(state->bm);
+      if (state->bm) bitmatrix_free(state->bm);
       pfree(state);
       MemoryContextSwitchTo(oldcontext);
       SRF_RETURN_DONE(funcctx);
@@ -0,0 +1,137 @@
+-------------------------------------------------------------------------------
+--
+-- This MobilityDB code is provided under The PostgreSQL License.
+-- Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+-- contributors
+--
+-- MobilityDB includes portions of PostGIS version 3 source code released
+-- under the GNU General Public License (GPLv2 or later).
+-- Copyright (c) 2001-2023, PostGIS contributors
+--
+-- Permission to use, copy, modify, and distribute this software and its
+-- documentation for any purpose, without fee, and without a written
+-- agreement is hereby granted, provided that the above copyright notice and
+-- this paragraph and the following two paragraphs appear in all copies.
+--
+-- IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+-- DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+-- LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+-- EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+-- OF SUCH DAMAGE.
+--
+-- UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+-- INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+-- AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+-- AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+-- PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+--
+-------------------------------------------------------------------------------
+
+
+-------------------------------------------------------------------------------
+-- File temporal_gin.c
+-- Tests of the GIN index on the value set of temporal types.
+-------------------------------------------------------------------------------
+
+DROP INDEX IF EXISTS tbl_tint_big_gin_idx;
+DROP INDEX IF EXISTS tbl_ttext_big_gin_idx;
+
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS test_ginops;
+CREATE TABLE test_ginops(
+  op CHAR(3),
+  leftarg TEXT,
+  rightarg TEXT,
+  no_idx BIGINT,
+  gin_idx BIGINT
+);
+
+-------------------------------------------------------------------------------
+
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '@@', 'tint', 'intset', COUNT(*) FROM tbl_tint_big WHERE temp @@ intset '{5, 15}';
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '@@', 'ttext', 'textset', COUNT(*) FROM tbl_ttext_big WHERE temp @@ textset '{"AAA", "BBB"}';
+
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '@?', 'tint', 'int', COUNT(*) FROM tbl_tint_big WHERE temp @? 5;
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '@?', 'ttext', 'text', COUNT(*) FROM tbl_ttext_big WHERE temp @? text 'AAA';
+
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '@?', 'tint', 'intset', COUNT(*) FROM tbl_tint_big WHERE temp @? intset '{5, 15}';
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '@?', 'ttext', 'textset', COUNT(*) FROM tbl_ttext_big WHERE temp @? textset '{"AAA", "BBB"}';
+
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '?@', 'tint', 'intset', COUNT(*) FROM tbl_tint_big WHERE temp ?@ intset '{1, 2, 3, 4, 5}';
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '?@', 'ttext', 'textset', COUNT(*) FROM tbl_ttext_big WHERE temp ?@ textset '{"AAA", "BBB", "CCC"}';
+
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '@=', 'tint', 'intset', COUNT(*) FROM tbl_tint_big WHERE temp @= intset '{5}';
+INSERT INTO test_ginops(op, leftarg, rightarg, no_idx)
+SELECT '@=', 'ttext', 'textset', COUNT(*) FROM tbl_ttext_big WHERE temp @= textset '{"AAA"}';
+
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tint_big_gin_idx ON tbl_tint_big USING GIN(temp);
+CREATE INDEX tbl_ttext_big_gin_idx ON tbl_ttext_big USING GIN(temp);
+
+-- Ensure that the queries below exercise the index support functions
+SET enable_seqscan = off;
+
+-------------------------------------------------------------------------------
+
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @@ intset '{5, 15}' )
+WHERE op = '@@' AND leftarg = 'tint' AND rightarg = 'intset';
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp @@ textset '{"AAA", "BBB"}' )
+WHERE op = '@@' AND leftarg = 'ttext' AND rightarg = 'textset';
+
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @? 5 )
+WHERE op = '@?' AND leftarg = 'tint' AND rightarg = 'int';
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp @? text 'AAA' )
+WHERE op = '@?' AND leftarg = 'ttext' AND rightarg = 'text';
+
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @? intset '{5, 15}' )
+WHERE op = '@?' AND leftarg = 'tint' AND rightarg = 'intset';
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp @? textset '{"AAA", "BBB"}' )
+WHERE op = '@?' AND leftarg = 'ttext' AND rightarg = 'textset';
+
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp ?@ intset '{1, 2, 3, 4, 5}' )
+WHERE op = '?@' AND leftarg = 'tint' AND rightarg = 'intset';
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp ?@ textset '{"AAA", "BBB", "CCC"}' )
+WHERE op = '?@' AND leftarg = 'ttext' AND rightarg = 'textset';
+
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @= intset '{5}' )
+WHERE op = '@=' AND leftarg = 'tint' AND rightarg = 'intset';
+UPDATE test_ginops
+SET gin_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp @= textset '{"AAA"}' )
+WHERE op = '@=' AND leftarg = 'ttext' AND rightarg = 'textset';
+
+-------------------------------------------------------------------------------
+
+SET enable_seqscan = on;
+
+DROP INDEX tbl_tint_big_gin_idx;
+DROP INDEX tbl_ttext_big_gin_idx;
+
+-------------------------------------------------------------------------------
+
+SELECT * FROM test_ginops
+WHERE no_idx <> gin_idx OR no_idx IS NULL OR gin_idx IS NULL
+ORDER BY op, leftarg, rightarg;
+
+DROP TABLE test_ginops;
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,207 @@
+-------------------------------------------------------------------------------
+--
+-- This MobilityDB code is provided under The PostgreSQL License.
+-- Copyright (c) 2016-2023, Université libre de Bruxelles and MobilityDB
+-- contributors
+--
+-- MobilityDB includes portions of PostGIS version 3 source code released
+-- under the GNU General Public License (GPLv2 or later).
+-- Copyright (c) 2001-2023, PostGIS contributors
+--
+-- Permission to use, copy, modify, and distribute this software and its
+-- documentation for any purpose, without fee, and without a written
+-- agreement is hereby granted, provided that the above copyright notice and
+-- this paragraph and the following two paragraphs appear in all copies.
+--
+-- IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+-- DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+-- LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+-- EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+-- OF SUCH DAMAGE.
+--
+-- UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+-- INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+-- AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+-- AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+-- PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+--
+-------------------------------------------------------------------------------
+
+
+-------------------------------------------------------------------------------
+-- File tpoint_brin.c
+-- Tests of the BRIN inclusion index on temporal points.
+-------------------------------------------------------------------------------
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_brin_idx;
+DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_brin_idx;
+
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS test_brinops;
+CREATE TABLE test_brinops(
+  op CHAR(3),
+  leftarg TEXT,
+  rightarg TEXT,
+  no_idx BIGINT,
+  brin_idx BIGINT
+);
+
+-------------------------------------------------------------------------------
+
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp << stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&<', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp &< stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&>', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp &> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '>>', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp >> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<|', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <<| stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '|>>', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp |>> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<</', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <</ stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '/>>', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp />> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '@>', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp @> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'tgeompoint', 'stbox', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <@ stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])';
+
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tgeompoint', 'tstzspan', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<#', 'tgeompoint', 'tstzspan', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&<#', 'tgeompoint', 'tstzspan', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#>>', 'tgeompoint', 'tstzspan', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#&>', 'tgeompoint', 'tstzspan', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]';
+
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tgeompoint', 'tgeompoint', COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && tgeompoint '[Point(1 1 1)@2001-06-01, Point(10 10 10)@2001-07-01]';
+
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tgeogpoint', 'tstzspan', COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '@>', 'tgeogpoint', 'tstzspan', COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp @> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'tgeogpoint', 'tstzspan', COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp <@ tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '-|-', 'tgeogpoint', 'tstzspan', COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp -|- tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<#', 'tgeogpoint', 'tstzspan', COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#>>', 'tgeogpoint', 'tstzspan', COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]';
+
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tgeogpoint', 'tgeogpoint', COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp && tgeogpoint '[Point(1 1 1)@2001-06-01, Point(10 10 10)@2001-07-01]';
+
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tgeompoint3D_big_brin_idx ON tbl_tgeompoint3D_big USING BRIN(temp);
+CREATE INDEX tbl_tgeogpoint3D_big_brin_idx ON tbl_tgeogpoint3D_big USING BRIN(temp);
+
+-- Ensure that the queries below exercise the index support functions
+SET enable_seqscan = off;
+
+-------------------------------------------------------------------------------
+
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp << stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '<<' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp &< stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '&<' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '&&' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp &> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '&>' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp >> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '>>' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <<| stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '<<|' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp |>> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '|>>' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <</ stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '<</' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp />> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '/>>' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp @> stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '@>' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <@ stbox 'STBOX ZT(((0,0,0),(50,50,50)),[2001-01-01,2001-02-01])' )
+WHERE op = '<@' AND leftarg = 'tgeompoint' AND rightarg = 'stbox';
+
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tgeompoint' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tgeompoint' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tgeompoint' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tgeompoint' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'tgeompoint' AND rightarg = 'tstzspan';
+
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && tgeompoint '[Point(1 1 1)@2001-06-01, Point(10 10 10)@2001-07-01]' )
+WHERE op = '&&' AND leftarg = 'tgeompoint' AND rightarg = 'tgeompoint';
+
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tgeogpoint' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp @> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '@>' AND leftarg = 'tgeogpoint' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp <@ tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<@' AND leftarg = 'tgeogpoint' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp -|- tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '-|-' AND leftarg = 'tgeogpoint' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tgeogpoint' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tgeogpoint' AND rightarg = 'tstzspan';
+
+UPDATE test_brinops
+SET brin_idx = ( SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp && tgeogpoint '[Point(1 1 1)@2001-06-01, Point(10 10 10)@2001-07-01]' )
+WHERE op = '&&' AND leftarg = 'tgeogpoint' AND rightarg = 'tgeogpoint';
+
+-------------------------------------------------------------------------------
+
+SET enable_seqscan = on;
+
+DROP INDEX tbl_tgeompoint3D_big_brin_idx;
+DROP INDEX tbl_tgeogpoint3D_big_brin_idx;
+
+-------------------------------------------------------------------------------
+
+SELECT * FROM test_brinops
+WHERE no_idx <> brin_idx OR no_idx IS NULL OR brin_idx IS NULL
+ORDER BY op, leftarg, rightarg;
+
+DROP TABLE test_brinops;
+
+-------------------------------------------------------------------------------